@@ -17,6 +17,7 @@ Index of this file:
 //-----------------------------------------------------------------------------
 
 #include <stdio.h>
+#include <stdlib.h> // getenv, atoi
 #include "pilotlight.h"
 #include "pl_profile.h"
 #include "pl_log.h"
@@ -127,7 +128,9 @@ pl_app_load(plApiRegistryApiI* ptApiRegistry, plAppData* ptAppData)
     gptDevice = ptApiRegistry->first(PL_API_DEVICE);
     gptDebug  = ptApiRegistry->first(PL_API_DEBUG);
 
-    // create command queue
+    // create command queue, shader sources are only watched on request
+    const char* pcHotReload = getenv("PL_SHADER_HOT_RELOAD");
+    ptAppData->tGraphics.bShaderHotReload = pcHotReload != NULL && atoi(pcHotReload) != 0;
     gptGfx->initialize(&ptAppData->tGraphics);
 
     // new demo
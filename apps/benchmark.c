@@ -0,0 +1,969 @@
+/*
+   benchmark.c
+     - renders a fixed synthetic scene offscreen for a set number of frames,
+       reports frame time percentiles & dumps the last frame to a png
+     - run with "./pilot_light -a benchmark" (lavapipe works through xvfb-run)
+     - PL_BENCHMARK_FRAMES environment variable overrides the frame count
+     - also GPU culls a field of bounding spheres each frame (never drawn) and
+       compares the survivors against a CPU frustum test, PL_BENCHMARK_OCCLUSION=0
+       disables occlusion against the target's depth pyramid
+     - draws a small axes preview through the render graph each frame (transient
+       color & depth), the main pass gets its bindless index
+     - PL_BENCHMARK_ECS=1 also times ECS component lookups (has_entity &
+       get_component) at 1k/100k/1M entities and the batch transform kernels
+       (multiply, TRS & inverse) over 1M transforms for every backend the cpu
+       supports on load, then normal & tangent generation on a 10M triangle
+       mesh (wall clock, all workers) and object updates over 50k objects
+       (static & 1% moving, both transform layouts)
+*/
+
+/*
+Index of this file:
+// [SECTION] includes
+// [SECTION] defines
+// [SECTION] structs
+// [SECTION] global apis
+// [SECTION] helpers
+// [SECTION] pl_app_load
+// [SECTION] pl_app_shutdown
+// [SECTION] pl_app_resize
+// [SECTION] pl_app_update
+// [SECTION] unity build
+*/
+
+//-----------------------------------------------------------------------------
+// [SECTION] includes
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h> // qsort, getenv, atoi
+#include <time.h>   // clock, timespec_get
+#include "pilotlight.h"
+#include "pl_profile.h"
+#include "pl_log.h"
+#include "pl_ds.h"
+#include "pl_os.h"
+#include "pl_memory.h"
+#define PL_MATH_INCLUDE_FUNCTIONS
+#include "pl_math.h"
+#include "pl_ui.h"
+
+// extensions
+#include "pl_image_ext.h"
+#include "pl_graphics_ext.h"
+#include "pl_stats_ext.h"
+#include "pl_ecs_ext.h"
+
+// app specific
+#include "camera.h"
+
+//-----------------------------------------------------------------------------
+// [SECTION] defines
+//-----------------------------------------------------------------------------
+
+#ifndef PL_BENCHMARK_FRAMES
+    #define PL_BENCHMARK_FRAMES 600 // measured frames
+#endif
+
+#ifndef PL_BENCHMARK_WARMUP_FRAMES
+    #define PL_BENCHMARK_WARMUP_FRAMES 30 // pipeline creation & buffer growth settle here
+#endif
+
+#ifndef PL_BENCHMARK_WIDTH
+    #define PL_BENCHMARK_WIDTH 1280
+#endif
+
+#ifndef PL_BENCHMARK_HEIGHT
+    #define PL_BENCHMARK_HEIGHT 720
+#endif
+
+#ifndef PL_BENCHMARK_SAMPLES
+    #define PL_BENCHMARK_SAMPLES 4
+#endif
+
+#ifndef PL_BENCHMARK_GRID
+    #define PL_BENCHMARK_GRID 48 // boxes per side of the synthetic scene
+#endif
+
+#ifndef PL_BENCHMARK_CULL_OBJECTS
+    #define PL_BENCHMARK_CULL_OBJECTS 100000 // bounding spheres tested by the GPU culling pass
+#endif
+
+#ifndef PL_BENCHMARK_ECS_LOOKUPS
+    #define PL_BENCHMARK_ECS_LOOKUPS 10000000 // random lookups per entity count
+#endif
+
+#ifndef PL_BENCHMARK_TRANSFORMS
+    #define PL_BENCHMARK_TRANSFORMS 1000000 // matrices per transform kernel call
+#endif
+
+#ifndef PL_BENCHMARK_MESH_TRIANGLES
+    #define PL_BENCHMARK_MESH_TRIANGLES 10000000 // normal & tangent generation
+#endif
+
+#ifndef PL_BENCHMARK_OBJECTS
+    #define PL_BENCHMARK_OBJECTS 50000 // object update system, 1 in 10 has a parent
+#endif
+
+#ifndef PL_BENCHMARK_PREVIEW_SIZE
+    #define PL_BENCHMARK_PREVIEW_SIZE 256 // render graph preview pass
+#endif
+
+#ifndef PL_BENCHMARK_OUTPUT
+    #define PL_BENCHMARK_OUTPUT "benchmark.png"
+#endif
+
+//-----------------------------------------------------------------------------
+// [SECTION] structs
+//-----------------------------------------------------------------------------
+
+typedef struct plAppData_t
+{
+    plDrawList   drawlist;
+    plDrawLayer* fgDrawLayer;
+    plFontAtlas  fontAtlas;
+
+    plGraphics tGraphics;
+
+    // scene
+    plCamera     tCamera;
+    plDrawList3D t3DDrawList;
+    uint32_t     uRenderTarget;
+    plMat4       tMVP;
+
+    // render graph preview
+    plDrawList3D tPreviewDrawList;
+    uint32_t     uPreviewSlot; // bindless index of the preview output, 0 until declared
+
+    // culling
+    plComponentLibrary tCullLibrary; // one object per culled draw, instances drawn by the cull area
+    plMesh      tCullMesh;      // shared by every culled draw
+    plDraw*     sbtCullDraws;
+    plDrawArea  tCullArea;
+    uint32_t    uCullReference; // CPU frustum survivors (scene & camera are static)
+    bool        bOcclusion;
+    double*     pdCullInputDraws;
+    double*     pdCullVisibleDraws;
+    double      dCullVisibleSum;
+    uint32_t    uCullSamples;
+    uint32_t    uCullVariant;      // positions only, compiled on the variant worker
+    uint32_t    uCullVariantFrame; // first frame it was ready, UINT32_MAX until then
+
+    // measurements
+    uint32_t uFrameCount;   // frames to measure
+    uint32_t uFrame;        // frames rendered so far (including warmup)
+    float*   sbfFrameTimes; // seconds
+    uint32_t uReadback;     // last frame, PL_RENDER_TARGET_NONE until requested
+    bool     bReported;
+} plAppData;
+
+//-----------------------------------------------------------------------------
+// [SECTION] global apis
+//-----------------------------------------------------------------------------
+
+const plApiRegistryApiI*  gptApiRegistry  = NULL;
+const plDataRegistryApiI* gptDataRegistry = NULL;
+const plGraphicsI*        gptGfx          = NULL;
+const plImageApiI*        gptImage        = NULL;
+const plOsServicesApiI*   gptOs           = NULL;
+const plDeviceI*          gptDevice       = NULL;
+const plStatsApiI*        gptStats        = NULL;
+const plEcsI*             gptEcs          = NULL;
+const plTransformI*       gptTransform    = NULL;
+
+//-----------------------------------------------------------------------------
+// [SECTION] helpers
+//-----------------------------------------------------------------------------
+
+static int
+pl__compare_floats(const void* pA, const void* pB)
+{
+    const float fA = *(const float*)pA;
+    const float fB = *(const float*)pB;
+    return (fA > fB) - (fA < fB);
+}
+
+static float
+pl__percentile(const float* afSorted, uint32_t uCount, float fPercentile)
+{
+    // nearest rank
+    uint32_t uRank = (uint32_t)ceilf(fPercentile / 100.0f * (float)uCount);
+    uRank = pl_maxu(1, pl_minu(uRank, uCount));
+    return afSorted[uRank - 1];
+}
+
+static void
+pl__build_scene(plAppData* ptAppData)
+{
+    // animated by frame index instead of time so every run (and the dumped
+    // image) is identical
+    const float fPhase = (float)ptAppData->uFrame * 0.02f;
+    const float fSpacing = 1.5f;
+    const float fOffset = -0.5f * fSpacing * (float)(PL_BENCHMARK_GRID - 1);
+
+    for(uint32_t i = 0; i < PL_BENCHMARK_GRID; i++)
+    {
+        for(uint32_t j = 0; j < PL_BENCHMARK_GRID; j++)
+        {
+            const float fX = fOffset + fSpacing * (float)i;
+            const float fZ = fOffset + fSpacing * (float)j;
+            const float fY = 0.5f * sinf(fPhase + 0.3f * (float)i) * cosf(fPhase + 0.2f * (float)j);
+            const plVec4 tColor = {(float)i / (float)PL_BENCHMARK_GRID, (float)j / (float)PL_BENCHMARK_GRID, 0.5f + 0.5f * sinf(fPhase), 1.0f};
+
+            gptGfx->add_3d_triangle_filled(&ptAppData->t3DDrawList,
+                (plVec3){fX - 0.5f, fY, fZ - 0.5f}, (plVec3){fX + 0.5f, fY, fZ - 0.5f}, (plVec3){fX, fY + 1.0f, fZ}, tColor);
+            gptGfx->add_3d_triangle_filled(&ptAppData->t3DDrawList,
+                (plVec3){fX + 0.5f, fY, fZ + 0.5f}, (plVec3){fX - 0.5f, fY, fZ + 0.5f}, (plVec3){fX, fY + 1.0f, fZ}, tColor);
+            gptGfx->add_3d_centered_box(&ptAppData->t3DDrawList, (plVec3){fX, fY + 0.5f, fZ}, 1.0f, 1.0f, 1.0f, tColor, 0.01f);
+        }
+    }
+}
+
+static void
+pl__execute_preview_pass(plGraphics* ptGraphics, void* pUserData)
+{
+    (void)ptGraphics;
+    plAppData* ptAppData = pUserData;
+    const plMat4 tIdentity = pl_identity_mat4();
+    gptGfx->add_3d_transform(&ptAppData->tPreviewDrawList, &tIdentity, 10.0f, 0.2f);
+    gptGfx->submit_3d_drawlist(&ptAppData->tPreviewDrawList, (float)PL_BENCHMARK_PREVIEW_SIZE, (float)PL_BENCHMARK_PREVIEW_SIZE, &ptAppData->tMVP, PL_PIPELINE_FLAG_DEPTH_TEST | PL_PIPELINE_FLAG_DEPTH_WRITE);
+}
+
+static void
+pl__declare_preview_graph(plAppData* ptAppData)
+{
+    // transients, the depth buffer's contents are never stored
+    const plRenderGraphTextureDesc tColorDesc = {
+        .pcName        = "preview color",
+        .tFormat       = PL_FORMAT_R8G8B8A8_UNORM,
+        .uWidth        = PL_BENCHMARK_PREVIEW_SIZE,
+        .uHeight       = PL_BENCHMARK_PREVIEW_SIZE,
+        .bSampledAfter = true
+    };
+    const plRenderGraphTextureDesc tDepthDesc = {
+        .pcName  = "preview depth",
+        .tFormat = PL_FORMAT_D32_FLOAT,
+        .uWidth  = PL_BENCHMARK_PREVIEW_SIZE,
+        .uHeight = PL_BENCHMARK_PREVIEW_SIZE
+    };
+    const uint32_t uColor = gptGfx->add_graph_texture(&ptAppData->tGraphics, &tColorDesc);
+    const uint32_t uDepth = gptGfx->add_graph_texture(&ptAppData->tGraphics, &tDepthDesc);
+
+    const plRenderGraphPassDesc tPassDesc = {
+        .pcName            = "preview",
+        .uColorOutputCount = 1,
+        .auColorOutputs    = {uColor},
+        .uDepthOutput      = uDepth,
+        .bClear            = true,
+        .afClearColor      = {0.0f, 0.0f, 0.0f, 1.0f},
+        .fClearDepth       = 1.0f,
+        .execute           = pl__execute_preview_pass,
+        .pUserData         = ptAppData
+    };
+    gptGfx->add_graph_pass(&ptAppData->tGraphics, &tPassDesc);
+
+    ptAppData->uPreviewSlot = gptGfx->get_graph_texture_bindless_index(&ptAppData->tGraphics, uColor);
+}
+
+static void
+pl__build_cull_scene(plAppData* ptAppData)
+{
+    // single unit cube with smoothed normals, shared by every object
+    static const plVec3 atVertices[] = {
+        {-0.5f, -0.5f, -0.5f}, { 0.5f, -0.5f, -0.5f}, { 0.5f,  0.5f, -0.5f}, {-0.5f,  0.5f, -0.5f},
+        {-0.5f, -0.5f,  0.5f}, { 0.5f, -0.5f,  0.5f}, { 0.5f,  0.5f,  0.5f}, {-0.5f,  0.5f,  0.5f}
+    };
+    static const uint32_t auIndices[] = {
+        0, 1, 2, 0, 2, 3,   4, 6, 5, 4, 7, 6,   0, 4, 5, 0, 5, 1,
+        3, 2, 6, 3, 6, 7,   0, 3, 7, 0, 7, 4,   1, 5, 6, 1, 6, 2
+    };
+    plComponentLibrary* ptLibrary = &ptAppData->tCullLibrary;
+    gptEcs->init_component_library(gptApiRegistry, ptLibrary);
+    const plEntity tCubeEntity = gptEcs->create_mesh(ptLibrary, "cull cube");
+    plMeshComponent* ptCube = gptEcs->get_component(&ptLibrary->tMeshComponentManager, tCubeEntity);
+    pl_sb_resize(ptCube->sbtVertexPositions, 8);
+    pl_sb_resize(ptCube->sbuIndices, 36);
+    memcpy(ptCube->sbtVertexPositions, atVertices, sizeof(atVertices));
+    memcpy(ptCube->sbuIndices, auIndices, sizeof(auIndices));
+    gptEcs->calculate_normals(ptCube, 1);
+    gptEcs->pack_vertices(ptCube, 1);
+    gptEcs->upload_meshes(ptCube, 1, &ptAppData->tGraphics.tDevice);
+    ptAppData->tCullMesh = ptCube->tMesh;
+
+    // compiled in the background, draws use the fallback until ready
+    plGraphicsState tCullState = {0};
+    tCullState.ulVertexStreamMask  = ptAppData->tCullMesh.ulVertexStreamMask;
+    tCullState.ulDepthMode         = PL_DEPTH_MODE_LESS;
+    tCullState.ulDepthWriteEnabled = 1;
+    tCullState.ulCullMode          = PL_CULL_MODE_BACK;
+    tCullState.ulBlendMode         = PL_BLEND_MODE_NONE;
+    tCullState.ulStencilMode       = PL_STENCIL_MODE_ALWAYS;
+    ptAppData->uCullVariant = gptGfx->request_shader_variant(&ptAppData->tGraphics, tCullState);
+    ptAppData->uCullVariantFrame = UINT32_MAX;
+
+    // deterministic field around (and far beyond) the visible grid
+    const plMat4 tMVP = pl_mul_mat4(&ptAppData->tCamera.tProjMat, &ptAppData->tCamera.tViewMat);
+    const plMat4* ptM = &tMVP;
+    plVec4 atPlanes[6] = {
+        {ptM->col[0].w + ptM->col[0].x, ptM->col[1].w + ptM->col[1].x, ptM->col[2].w + ptM->col[2].x, ptM->col[3].w + ptM->col[3].x},
+        {ptM->col[0].w - ptM->col[0].x, ptM->col[1].w - ptM->col[1].x, ptM->col[2].w - ptM->col[2].x, ptM->col[3].w - ptM->col[3].x},
+        {ptM->col[0].w + ptM->col[0].y, ptM->col[1].w + ptM->col[1].y, ptM->col[2].w + ptM->col[2].y, ptM->col[3].w + ptM->col[3].y},
+        {ptM->col[0].w - ptM->col[0].y, ptM->col[1].w - ptM->col[1].y, ptM->col[2].w - ptM->col[2].y, ptM->col[3].w - ptM->col[3].y},
+        {ptM->col[0].z, ptM->col[1].z, ptM->col[2].z, ptM->col[3].z},
+        {ptM->col[0].w - ptM->col[0].z, ptM->col[1].w - ptM->col[1].z, ptM->col[2].w - ptM->col[2].z, ptM->col[3].w - ptM->col[3].z}
+    };
+    for(uint32_t i = 0; i < 6; i++)
+    {
+        const float fInvLength = 1.0f / sqrtf(atPlanes[i].x * atPlanes[i].x + atPlanes[i].y * atPlanes[i].y + atPlanes[i].z * atPlanes[i].z);
+        atPlanes[i] = (plVec4){atPlanes[i].x * fInvLength, atPlanes[i].y * fInvLength, atPlanes[i].z * fInvLength, atPlanes[i].w * fInvLength};
+    }
+
+    uint32_t uSeed = 0x12345678;
+    pl_sb_resize(ptAppData->sbtCullDraws, PL_BENCHMARK_CULL_OBJECTS);
+    for(uint32_t i = 0; i < PL_BENCHMARK_CULL_OBJECTS; i++)
+    {
+        float afRandom[3];
+        for(uint32_t j = 0; j < 3; j++)
+        {
+            uSeed = uSeed * 1664525u + 1013904223u;
+            afRandom[j] = (float)(uSeed >> 8) / (float)(1u << 24);
+        }
+        const plVec4 tSphere = {400.0f * afRandom[0] - 200.0f, 8.0f * afRandom[1] - 2.0f, 400.0f * afRandom[2] - 200.0f, 0.87f};
+
+        // root transforms, the object system reads tFinalTransform
+        const plEntity tObject = gptEcs->create_entity(ptLibrary);
+        plTransformComponent* ptTransform = gptEcs->create_component(&ptLibrary->tTransformComponentManager, tObject);
+        ptTransform->tTranslation = tSphere.xyz;
+        ptTransform->tFinalTransform = pl_mat4_translate_vec3(tSphere.xyz);
+        plObjectComponent* ptObject = gptEcs->create_component(&ptLibrary->tObjectComponentManager, tObject);
+        ptObject->tMesh = tCubeEntity;
+        ptObject->tTransform = tObject;
+
+        ptAppData->sbtCullDraws[i] = (plDraw){
+            .ptMesh          = &ptAppData->tCullMesh,
+            .uInstanceIndex  = (uint32_t)gptEcs->get_index(&ptLibrary->tObjectComponentManager, tObject),
+            .tBoundingSphere = tSphere,
+            .uShaderVariant  = ptAppData->uCullVariant
+        };
+
+        bool bVisible = true;
+        for(uint32_t j = 0; j < 6; j++)
+        {
+            if(pl_dot_vec3(atPlanes[j].xyz, tSphere.xyz) + atPlanes[j].w < -tSphere.w)
+                bVisible = false;
+        }
+        if(bVisible)
+            ptAppData->uCullReference++;
+    }
+    ptAppData->tCullArea.uDrawCount = PL_BENCHMARK_CULL_OBJECTS;
+    ptAppData->tCullArea.ptViewProjection = &ptAppData->tMVP;
+}
+
+static void
+pl__benchmark_ecs_lookups(void)
+{
+    static const uint32_t auEntityCounts[] = {1000, 100000, 1000000};
+
+    printf("ecs lookups: %u random ids per size, half without the component\n", PL_BENCHMARK_ECS_LOOKUPS);
+    printf("  %10s %16s %16s\n", "entities", "has_entity ns", "get_component ns");
+
+    for(uint32_t i = 0; i < sizeof(auEntityCounts) / sizeof(auEntityCounts[0]); i++)
+    {
+        const uint32_t uEntityCount = auEntityCounts[i];
+
+        plComponentLibrary tLibrary = {0};
+        gptEcs->init_component_library(gptApiRegistry, &tLibrary);
+        plComponentManager* ptManager = &tLibrary.tHierarchyComponentManager;
+
+        // every other entity gets a component so has_entity sees hits & misses
+        for(uint32_t j = 0; j < uEntityCount * 2; j++)
+        {
+            const plEntity tEntity = gptEcs->create_entity(&tLibrary);
+            if(j % 2 == 0)
+                gptEcs->create_component(ptManager, tEntity);
+        }
+
+        // same id sequence for both passes
+        uint64_t ulSink = 0;
+        uint32_t uSeed = 0x12345678;
+        clock_t tStart = clock();
+        for(uint32_t j = 0; j < PL_BENCHMARK_ECS_LOOKUPS; j++)
+        {
+            uSeed = uSeed * 1664525u + 1013904223u;
+            const plEntity tEntity = 1 + (uSeed >> 8) % (uEntityCount * 2);
+            ulSink += gptEcs->has_entity(ptManager, tEntity);
+        }
+        const double dHasSeconds = (double)(clock() - tStart) / (double)CLOCKS_PER_SEC;
+
+        uSeed = 0x12345678;
+        tStart = clock();
+        for(uint32_t j = 0; j < PL_BENCHMARK_ECS_LOOKUPS; j++)
+        {
+            uSeed = uSeed * 1664525u + 1013904223u;
+            const plEntity tEntity = 1 + (((uSeed >> 8) % uEntityCount) * 2); // hits only
+            const plHierarchyComponent* ptComponent = gptEcs->get_component(ptManager, tEntity);
+            ulSink += ptComponent->tParent;
+        }
+        const double dGetSeconds = (double)(clock() - tStart) / (double)CLOCKS_PER_SEC;
+
+        printf("  %10u %16.2f %16.2f%s\n", uEntityCount,
+            1.0e9 * dHasSeconds / (double)PL_BENCHMARK_ECS_LOOKUPS,
+            1.0e9 * dGetSeconds / (double)PL_BENCHMARK_ECS_LOOKUPS,
+            ulSink == 0 ? " (no hits?)" : "");
+
+        gptEcs->cleanup_systems(gptApiRegistry, &tLibrary);
+    }
+}
+
+static double
+pl__wall_seconds(void)
+{
+    // clock() adds up every worker's cpu time
+    struct timespec tTime;
+    timespec_get(&tTime, TIME_UTC);
+    return (double)tTime.tv_sec + 1.0e-9 * (double)tTime.tv_nsec;
+}
+
+static float
+pl__max_error_mat4(const plMat4* atA, const plMat4* atB, uint32_t uCount)
+{
+    float fMaxError = 0.0f;
+    for(uint32_t i = 0; i < uCount; i++)
+    {
+        for(uint32_t j = 0; j < 16; j++)
+            fMaxError = pl_maxf(fMaxError, fabsf(atA[i].d[j] - atB[i].d[j]));
+    }
+    return fMaxError;
+}
+
+static void
+pl__benchmark_transform_kernels(void)
+{
+    const uint32_t uCount = PL_BENCHMARK_TRANSFORMS;
+    const uint32_t uCheckCount = pl_minu(uCount, 4096); // compared against the scalar backend
+
+    plMat4* atA            = PL_ALLOC(sizeof(plMat4) * uCount);
+    plMat4* atB            = PL_ALLOC(sizeof(plMat4) * uCount);
+    plMat4* atOut          = PL_ALLOC(sizeof(plMat4) * uCount);
+    plVec3* atScales       = PL_ALLOC(sizeof(plVec3) * uCount);
+    plVec4* atRotations    = PL_ALLOC(sizeof(plVec4) * uCount);
+    plVec3* atTranslations = PL_ALLOC(sizeof(plVec3) * uCount);
+    plMat4* atReference    = PL_ALLOC(sizeof(plMat4) * uCheckCount * 3); // mul, trs, inverse
+
+    // random transforms, so every matrix is invertible
+    uint32_t uSeed = 0x9e3779b9;
+    for(uint32_t i = 0; i < uCount; i++)
+    {
+        float afRandom[10];
+        for(uint32_t j = 0; j < 10; j++)
+        {
+            uSeed = uSeed * 1664525u + 1013904223u;
+            afRandom[j] = (float)(uSeed >> 8) / (float)(1 << 24);
+        }
+        atScales[i]       = (plVec3){0.5f + afRandom[0], 0.5f + afRandom[1], 0.5f + afRandom[2]};
+        atRotations[i]    = pl_norm_vec4((plVec4){afRandom[3] - 0.5f, afRandom[4] - 0.5f, afRandom[5] - 0.5f, afRandom[6]});
+        atTranslations[i] = (plVec3){100.0f * afRandom[7], 100.0f * afRandom[8], 100.0f * afRandom[9]};
+    }
+    gptTransform->compose_trs(atScales, atRotations, atTranslations, atA, uCount);
+    for(uint32_t i = 0; i < uCount; i++)
+        atB[i] = pl_mat4_translate_vec3(atTranslations[uCount - 1 - i]);
+    memset(atOut, 0, sizeof(plMat4) * uCount); // first backend shouldn't pay for the page faults
+
+    printf("transform kernels: %u transforms, max error vs scalar over the first %u\n", uCount, uCheckCount);
+    printf("  %8s %10s %10s %14s %10s\n", "backend", "mul ns", "trs ns", "inverse ns", "max error");
+
+    const plTransformBackend tDefaultBackend = gptTransform->get_backend();
+    for(plTransformBackend tBackend = PL_TRANSFORM_BACKEND_SCALAR; tBackend < PL_TRANSFORM_BACKEND_COUNT; tBackend++)
+    {
+        if(!gptTransform->set_backend(tBackend))
+            continue;
+
+        float fMaxError = 0.0f;
+        clock_t tStart = clock();
+        gptTransform->mul_mat4(atA, atB, atOut, uCount);
+        const double dMulSeconds = (double)(clock() - tStart) / (double)CLOCKS_PER_SEC;
+        if(tBackend == PL_TRANSFORM_BACKEND_SCALAR)
+            memcpy(&atReference[0], atOut, sizeof(plMat4) * uCheckCount);
+        fMaxError = pl_maxf(fMaxError, pl__max_error_mat4(&atReference[0], atOut, uCheckCount));
+
+        tStart = clock();
+        gptTransform->compose_trs(atScales, atRotations, atTranslations, atOut, uCount);
+        const double dTrsSeconds = (double)(clock() - tStart) / (double)CLOCKS_PER_SEC;
+        if(tBackend == PL_TRANSFORM_BACKEND_SCALAR)
+            memcpy(&atReference[uCheckCount], atOut, sizeof(plMat4) * uCheckCount);
+        fMaxError = pl_maxf(fMaxError, pl__max_error_mat4(&atReference[uCheckCount], atOut, uCheckCount));
+
+        tStart = clock();
+        gptTransform->invert_mat4(atA, atOut, uCount);
+        const double dInverseSeconds = (double)(clock() - tStart) / (double)CLOCKS_PER_SEC;
+        if(tBackend == PL_TRANSFORM_BACKEND_SCALAR)
+            memcpy(&atReference[uCheckCount * 2], atOut, sizeof(plMat4) * uCheckCount);
+        fMaxError = pl_maxf(fMaxError, pl__max_error_mat4(&atReference[uCheckCount * 2], atOut, uCheckCount));
+
+        printf("  %8s %10.2f %10.2f %14.2f %10.2e\n", gptTransform->get_backend_name(tBackend),
+            1.0e9 * dMulSeconds / (double)uCount,
+            1.0e9 * dTrsSeconds / (double)uCount,
+            1.0e9 * dInverseSeconds / (double)uCount,
+            fMaxError);
+    }
+    gptTransform->set_backend(tDefaultBackend);
+
+    PL_FREE(atA);
+    PL_FREE(atB);
+    PL_FREE(atOut);
+    PL_FREE(atScales);
+    PL_FREE(atRotations);
+    PL_FREE(atTranslations);
+    PL_FREE(atReference);
+}
+
+static void
+pl__benchmark_object_updates(void)
+{
+    static const plTransformLayout atLayouts[] = {PL_TRANSFORM_LAYOUT_AOS, PL_TRANSFORM_LAYOUT_SOA};
+    static const char* apcLayouts[] = {"aos", "soa"};
+    const uint32_t uFrames = 100;
+    const uint32_t uMoving = PL_BENCHMARK_OBJECTS / 100;
+
+    printf("object updates: %u objects, hierarchy + object systems, ms per frame\n", PL_BENCHMARK_OBJECTS);
+    printf("  %8s %12s %12s %12s\n", "layout", "first", "static", "1% moving");
+
+    for(uint32_t i = 0; i < sizeof(atLayouts) / sizeof(atLayouts[0]); i++)
+    {
+        plComponentLibrary tLibrary = {0};
+        gptEcs->init_component_library(gptApiRegistry, &tLibrary);
+        gptEcs->set_transform_layout(&tLibrary, atLayouts[i]);
+        plComponentManager* ptTransformManager = &tLibrary.tTransformComponentManager;
+
+        const plEntity tParent = gptEcs->create_transform(&tLibrary, "parent");
+        plEntity* sbtObjects = NULL;
+        pl_sb_resize(sbtObjects, PL_BENCHMARK_OBJECTS);
+        for(uint32_t j = 0; j < PL_BENCHMARK_OBJECTS; j++)
+        {
+            sbtObjects[j] = gptEcs->create_object(&tLibrary, "object");
+            if(j % 10 == 0)
+                gptEcs->attach_component(&tLibrary, sbtObjects[j], tParent);
+        }
+
+        double dStart = pl__wall_seconds();
+        gptEcs->run_hierarchy_update_system(&tLibrary);
+        gptEcs->run_object_update_system(&tLibrary);
+        const double dFirstSeconds = pl__wall_seconds() - dStart;
+
+        dStart = pl__wall_seconds();
+        for(uint32_t uFrame = 0; uFrame < uFrames; uFrame++)
+        {
+            gptEcs->run_hierarchy_update_system(&tLibrary);
+            gptEcs->run_object_update_system(&tLibrary);
+        }
+        const double dStaticSeconds = pl__wall_seconds() - dStart;
+
+        // standalone objects, worlds written directly & stamped
+        dStart = pl__wall_seconds();
+        for(uint32_t uFrame = 0; uFrame < uFrames; uFrame++)
+        {
+            for(uint32_t j = 0; j < uMoving; j++)
+            {
+                const plEntity tEntity = sbtObjects[(j * 10 + 1 + uFrame) % PL_BENCHMARK_OBJECTS];
+                if(gptEcs->has_entity(&tLibrary.tHierarchyComponentManager, tEntity))
+                    continue;
+                plTransformColumns tColumns = {0};
+                plMat4* ptWorld = gptEcs->get_transform_columns(&tLibrary, &tColumns) ?
+                    &tColumns.atWorlds[gptEcs->get_index(ptTransformManager, tEntity)] :
+                    &((plTransformComponent*)gptEcs->get_component(ptTransformManager, tEntity))->tFinalTransform;
+                ptWorld->col[3].x = (float)uFrame;
+                gptEcs->mark_changed(ptTransformManager, tEntity);
+            }
+            gptEcs->run_hierarchy_update_system(&tLibrary);
+            gptEcs->run_object_update_system(&tLibrary);
+        }
+        const double dMovingSeconds = pl__wall_seconds() - dStart;
+
+        printf("  %8s %12.3f %12.4f %12.3f\n", apcLayouts[i],
+            1.0e3 * dFirstSeconds, 1.0e3 * dStaticSeconds / (double)uFrames, 1.0e3 * dMovingSeconds / (double)uFrames);
+
+        pl_sb_free(sbtObjects);
+        gptEcs->cleanup_systems(gptApiRegistry, &tLibrary);
+    }
+}
+
+static void
+pl__benchmark_mesh_frames(void)
+{
+    // heightfield grid (2 triangles per cell) with uvs, like a large scan
+    const uint32_t uCells = (uint32_t)sqrtf((float)PL_BENCHMARK_MESH_TRIANGLES * 0.5f);
+    const uint32_t uSide = uCells + 1;
+
+    plMeshComponent tMesh = {0};
+    pl_sb_resize(tMesh.sbtVertexPositions, uSide * uSide);
+    pl_sb_resize(tMesh.sbtVertexTextureCoordinates0, uSide * uSide);
+    pl_sb_resize(tMesh.sbuIndices, uCells * uCells * 6);
+    for(uint32_t j = 0; j < uSide; j++)
+    {
+        for(uint32_t i = 0; i < uSide; i++)
+        {
+            const float fU = (float)i / (float)uCells;
+            const float fV = (float)j / (float)uCells;
+            tMesh.sbtVertexPositions[j * uSide + i] = (plVec3){fU, 0.05f * sinf(40.0f * fU) * cosf(30.0f * fV), fV};
+            tMesh.sbtVertexTextureCoordinates0[j * uSide + i] = (plVec2){fU, fV};
+        }
+    }
+    for(uint32_t j = 0; j < uCells; j++)
+    {
+        for(uint32_t i = 0; i < uCells; i++)
+        {
+            const uint32_t uCorner = j * uSide + i;
+            uint32_t* puIndices = &tMesh.sbuIndices[(j * uCells + i) * 6];
+            puIndices[0] = uCorner;
+            puIndices[1] = uCorner + uSide;
+            puIndices[2] = uCorner + uSide + 1;
+            puIndices[3] = uCorner;
+            puIndices[4] = uCorner + uSide + 1;
+            puIndices[5] = uCorner + 1;
+        }
+    }
+
+    printf("mesh frames: %u triangles, %u vertices\n", uCells * uCells * 2, uSide * uSide);
+    printf("  %8s %12s %12s %12s\n", "backend", "normals ms", "tangents ms", "both ms");
+
+    const plTransformBackend tDefaultBackend = gptTransform->get_backend();
+    for(plTransformBackend tBackend = PL_TRANSFORM_BACKEND_SCALAR; tBackend < PL_TRANSFORM_BACKEND_COUNT; tBackend++)
+    {
+        if(!gptTransform->set_backend(tBackend))
+            continue;
+
+        pl_sb_reset(tMesh.sbtVertexNormals);
+        pl_sb_reset(tMesh.sbtVertexTangents);
+        double dStart = pl__wall_seconds();
+        gptEcs->calculate_normals(&tMesh, 1);
+        const double dNormalSeconds = pl__wall_seconds() - dStart;
+
+        // tangents against the normals above
+        dStart = pl__wall_seconds();
+        gptEcs->calculate_tangents(&tMesh, 1);
+        const double dTangentSeconds = pl__wall_seconds() - dStart;
+
+        // tangents pulling in the missing normals
+        pl_sb_reset(tMesh.sbtVertexNormals);
+        pl_sb_reset(tMesh.sbtVertexTangents);
+        dStart = pl__wall_seconds();
+        gptEcs->calculate_tangents(&tMesh, 1);
+        const double dBothSeconds = pl__wall_seconds() - dStart;
+
+        printf("  %8s %12.1f %12.1f %12.1f\n", gptTransform->get_backend_name(tBackend),
+            1.0e3 * dNormalSeconds, 1.0e3 * dTangentSeconds, 1.0e3 * dBothSeconds);
+    }
+    gptTransform->set_backend(tDefaultBackend);
+
+    pl_sb_free(tMesh.sbtVertexPositions);
+    pl_sb_free(tMesh.sbtVertexTextureCoordinates0);
+    pl_sb_free(tMesh.sbtVertexNormals);
+    pl_sb_free(tMesh.sbtVertexTangents);
+    pl_sb_free(tMesh.sbuIndices);
+}
+
+static void
+pl__report(plAppData* ptAppData, const plReadback* ptReadback)
+{
+    const uint32_t uCount = pl_sb_size(ptAppData->sbfFrameTimes);
+    qsort(ptAppData->sbfFrameTimes, uCount, sizeof(float), pl__compare_floats);
+
+    double dTotal = 0.0;
+    for(uint32_t i = 0; i < uCount; i++)
+        dTotal += (double)ptAppData->sbfFrameTimes[i];
+
+    printf("benchmark: %u frames at %ux%u, %ux msaa\n", uCount, PL_BENCHMARK_WIDTH, PL_BENCHMARK_HEIGHT, PL_BENCHMARK_SAMPLES);
+    printf("  mean %8.3f ms\n", 1000.0 * dTotal / (double)uCount);
+    printf("  p50  %8.3f ms\n", 1000.0f * pl__percentile(ptAppData->sbfFrameTimes, uCount, 50.0f));
+    printf("  p95  %8.3f ms\n", 1000.0f * pl__percentile(ptAppData->sbfFrameTimes, uCount, 95.0f));
+    printf("  p99  %8.3f ms\n", 1000.0f * pl__percentile(ptAppData->sbfFrameTimes, uCount, 99.0f));
+    printf("  max  %8.3f ms\n", 1000.0f * ptAppData->sbfFrameTimes[uCount - 1]);
+
+    if(ptReadback == NULL)
+        printf("  no image (render targets unsupported)\n");
+    else if(gptImage->write_png(PL_BENCHMARK_OUTPUT, (int)ptReadback->uWidth, (int)ptReadback->uHeight, 4, ptReadback->pData, (int)ptReadback->uRowPitch))
+        printf("  wrote %s (frame %u)\n", PL_BENCHMARK_OUTPUT, (uint32_t)ptReadback->ulFrame);
+    else
+        printf("  failed to write %s\n", PL_BENCHMARK_OUTPUT);
+
+    printf("culling: %u objects, occlusion %s\n", PL_BENCHMARK_CULL_OBJECTS, ptAppData->bOcclusion ? "on" : "off");
+    printf("  cpu frustum visible %u\n", ptAppData->uCullReference);
+    if(ptAppData->uCullSamples > 0)
+        printf("  gpu visible (mean)  %.1f\n", ptAppData->dCullVisibleSum / (double)ptAppData->uCullSamples);
+    else
+        printf("  gpu visible         n/a (culling unsupported)\n");
+    if(ptAppData->uCullVariantFrame != UINT32_MAX)
+        printf("  shader variant ready at frame %u\n", ptAppData->uCullVariantFrame);
+    else
+        printf("  shader variant not ready\n");
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] pl_app_load
+//-----------------------------------------------------------------------------
+
+PL_EXPORT void*
+pl_app_load(plApiRegistryApiI* ptApiRegistry, plAppData* ptAppData)
+{
+    gptApiRegistry  = ptApiRegistry;
+    gptDataRegistry = ptApiRegistry->first(PL_API_DATA_REGISTRY);
+    pl_set_memory_context(gptDataRegistry->get_data(PL_CONTEXT_MEMORY));
+    pl_set_context(gptDataRegistry->get_data("ui"));
+
+    if(ptAppData) // reload
+    {
+        pl_set_log_context(gptDataRegistry->get_data("log"));
+        pl_set_profile_context(gptDataRegistry->get_data("profile"));
+
+        // reload global apis
+        gptGfx   = ptApiRegistry->first(PL_API_GRAPHICS);
+        gptImage = ptApiRegistry->first(PL_API_IMAGE);
+        gptOs    = ptApiRegistry->first(PL_API_OS_SERVICES);
+        gptDevice = ptApiRegistry->first(PL_API_DEVICE);
+        gptStats  = ptApiRegistry->first(PL_API_STATS);
+        gptEcs    = ptApiRegistry->first(PL_API_ECS);
+        gptTransform = ptApiRegistry->first(PL_API_TRANSFORM);
+
+        return ptAppData;
+    }
+
+    plProfileContext* ptProfileCtx = pl_create_profile_context();
+    plLogContext*     ptLogCtx     = pl_create_log_context();
+
+    // add some context to data registry
+    ptAppData = PL_ALLOC(sizeof(plAppData));
+    memset(ptAppData, 0, sizeof(plAppData));
+    gptDataRegistry->set_data("profile", ptProfileCtx);
+    gptDataRegistry->set_data("log", ptLogCtx);
+
+    // create log context
+    pl_add_log_channel("Default", PL_CHANNEL_TYPE_CONSOLE);
+
+    // load extensions
+    const plExtensionRegistryApiI* ptExtensionRegistry = ptApiRegistry->first(PL_API_EXTENSION_REGISTRY);
+    ptExtensionRegistry->load("pl_image_ext",    "pl_load_image_ext", "pl_unload_image_ext", false);
+    ptExtensionRegistry->load("pl_stats_ext",    "pl_load_stats_ext", "pl_unload_stats_ext", false);
+    ptExtensionRegistry->load("pl_graphics_ext", "pl_load_ext",       "pl_unload_ext",       false);
+    ptExtensionRegistry->load("pl_ecs_ext",      "pl_load_ecs_ext",   "pl_unload_ecs_ext",   false);
+
+    // load apis
+    gptGfx   = ptApiRegistry->first(PL_API_GRAPHICS);
+    gptImage = ptApiRegistry->first(PL_API_IMAGE);
+    gptOs    = ptApiRegistry->first(PL_API_OS_SERVICES);
+    gptDevice = ptApiRegistry->first(PL_API_DEVICE);
+    gptStats  = ptApiRegistry->first(PL_API_STATS);
+    gptEcs    = ptApiRegistry->first(PL_API_ECS);
+    gptTransform = ptApiRegistry->first(PL_API_TRANSFORM);
+
+    // cpu only & opt in, runs before the renderer exists
+    const char* pcEcs = getenv("PL_BENCHMARK_ECS");
+    if(pcEcs != NULL && atoi(pcEcs) != 0)
+    {
+        pl__benchmark_ecs_lookups();
+        pl__benchmark_transform_kernels();
+        pl__benchmark_mesh_frames();
+        pl__benchmark_object_updates();
+    }
+
+    // measure the renderer, not the display
+    ptAppData->tGraphics.tSwapchainDesc.tPresentMode = PL_PRESENT_MODE_IMMEDIATE;
+    gptGfx->initialize(&ptAppData->tGraphics);
+
+    // fixed size so results don't depend on the window
+    const plRenderTargetDesc tTargetDesc = {
+        .pcName        = "benchmark target",
+        .tFormat       = PL_FORMAT_R8G8B8A8_UNORM,
+        .uWidth        = PL_BENCHMARK_WIDTH,
+        .uHeight       = PL_BENCHMARK_HEIGHT,
+        .uSampleCount  = PL_BENCHMARK_SAMPLES,
+        .bDepth        = true,
+        .bDepthPyramid = true, // occluders for the culling pass
+        .afClearColor  = {0.1f, 0.1f, 0.1f, 1.0f},
+        .fClearDepth   = 1.0f
+    };
+    ptAppData->uRenderTarget = gptGfx->create_render_target(&ptAppData->tGraphics, &tTargetDesc);
+
+    ptAppData->tCamera = pl_camera_create((plVec3){0.0f, 30.0f, -50.0f}, PL_PI_3, (float)PL_BENCHMARK_WIDTH / (float)PL_BENCHMARK_HEIGHT, 0.01f, 400.0f);
+    pl_camera_set_pitch_yaw(&ptAppData->tCamera, -0.55f, 0.0f);
+    pl_camera_update(&ptAppData->tCamera);
+
+    const char* pcOcclusion = getenv("PL_BENCHMARK_OCCLUSION");
+    ptAppData->bOcclusion = pcOcclusion == NULL || atoi(pcOcclusion) != 0;
+    pl__build_cull_scene(ptAppData);
+    ptAppData->pdCullInputDraws   = gptStats->get_counter("culling input draws");
+    ptAppData->pdCullVisibleDraws = gptStats->get_counter("culling visible draws");
+
+    const char* pcFrameCount = getenv("PL_BENCHMARK_FRAMES");
+    ptAppData->uFrameCount = pcFrameCount ? (uint32_t)atoi(pcFrameCount) : PL_BENCHMARK_FRAMES;
+    ptAppData->uFrameCount = pl_maxu(ptAppData->uFrameCount, 1);
+    pl_sb_reserve(ptAppData->sbfFrameTimes, ptAppData->uFrameCount);
+
+    // create draw list & layers
+    pl_register_drawlist(&ptAppData->drawlist);
+    ptAppData->fgDrawLayer = pl_request_layer(&ptAppData->drawlist, "Foreground Layer");
+
+    // create font atlas
+    pl_add_default_font(&ptAppData->fontAtlas);
+    pl_build_font_atlas(&ptAppData->fontAtlas);
+    gptGfx->create_font_atlas(&ptAppData->fontAtlas);
+    pl_set_default_font(&ptAppData->fontAtlas.sbtFonts[0]);
+
+    // 3D drawlist
+    gptGfx->register_3d_drawlist(&ptAppData->tGraphics, &ptAppData->t3DDrawList);
+    gptGfx->register_3d_drawlist(&ptAppData->tGraphics, &ptAppData->tPreviewDrawList);
+
+    return ptAppData;
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] pl_app_shutdown
+//-----------------------------------------------------------------------------
+
+PL_EXPORT void
+pl_app_shutdown(plAppData* ptAppData)
+{
+    gptGfx->destroy_font_atlas(&ptAppData->fontAtlas);
+    pl_cleanup_font_atlas(&ptAppData->fontAtlas);
+
+    gptGfx->destroy_render_target(&ptAppData->tGraphics, ptAppData->uRenderTarget);
+    gptDevice->destroy_buffer(&ptAppData->tGraphics.tDevice, ptAppData->tCullMesh.uVertexBuffer);
+    gptDevice->destroy_buffer(&ptAppData->tGraphics.tDevice, ptAppData->tCullMesh.uIndexBuffer);
+    if(ptAppData->tCullMesh.uAttributeBuffer)
+        gptDevice->destroy_buffer(&ptAppData->tGraphics.tDevice, ptAppData->tCullMesh.uAttributeBuffer);
+    pl_sb_free(ptAppData->sbtCullDraws);
+    gptEcs->cleanup_systems(gptApiRegistry, &ptAppData->tCullLibrary);
+    gptGfx->cleanup(&ptAppData->tGraphics);
+    pl_sb_free(ptAppData->sbfFrameTimes);
+    pl_cleanup_profile_context();
+    pl_cleanup_log_context();
+    PL_FREE(ptAppData);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] pl_app_resize
+//-----------------------------------------------------------------------------
+
+PL_EXPORT void
+pl_app_resize(plAppData* ptAppData)
+{
+    gptGfx->resize(&ptAppData->tGraphics);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] pl_app_update
+//-----------------------------------------------------------------------------
+
+PL_EXPORT void
+pl_app_update(plAppData* ptAppData)
+{
+    if(!gptGfx->begin_frame(&ptAppData->tGraphics))
+        return;
+
+    pl_begin_profile_frame();
+
+    const uint32_t uLastFrame = PL_BENCHMARK_WARMUP_FRAMES + ptAppData->uFrameCount;
+    const bool bMeasuring = ptAppData->uFrame < uLastFrame;
+
+    // background compile latency, published between frames
+    if(ptAppData->uCullVariantFrame == UINT32_MAX && gptGfx->is_shader_variant_ready(&ptAppData->tGraphics, ptAppData->uCullVariant))
+        ptAppData->uCullVariantFrame = ptAppData->uFrame;
+
+    // delta time covers the whole previous frame, including any wait on the GPU
+    if(ptAppData->uFrame > PL_BENCHMARK_WARMUP_FRAMES && ptAppData->uFrame <= uLastFrame)
+    {
+        pl_sb_push(ptAppData->sbfFrameTimes, pl_get_io()->fDeltaTime);
+
+        // counters hold the last completed frame's culling results
+        if(*ptAppData->pdCullInputDraws > 0.0)
+        {
+            ptAppData->dCullVisibleSum += *ptAppData->pdCullVisibleDraws;
+            ptAppData->uCullSamples++;
+        }
+    }
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~offscreen~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    if(bMeasuring)
+    {
+        pl__build_scene(ptAppData);
+
+        ptAppData->tMVP = pl_mul_mat4(&ptAppData->tCamera.tProjMat, &ptAppData->tCamera.tViewMat);
+        const plMat4 tMVP = ptAppData->tMVP;
+
+        // static field, instances are only uploaded on the first frame
+        gptEcs->run_object_update_system(&ptAppData->tCullLibrary);
+        gptEcs->upload_object_instances(&ptAppData->tCullLibrary, &ptAppData->tGraphics.tDevice);
+        const plObjectSystemData* ptObjectData = ptAppData->tCullLibrary.tObjectComponentManager.pSystemData;
+        ptAppData->tCullArea.uInstanceBuffer = ptObjectData->uInstanceBuffer;
+
+        // tested against the pyramid built from last frame's target
+        const plCullDesc tCullDesc = {
+            .tViewProjection  = tMVP,
+            .uOcclusionTarget = ptAppData->bOcclusion ? ptAppData->uRenderTarget : PL_RENDER_TARGET_NONE
+        };
+        gptGfx->cull_areas(&ptAppData->tGraphics, &tCullDesc, 1, &ptAppData->tCullArea, ptAppData->sbtCullDraws);
+
+        gptGfx->begin_render_target(&ptAppData->tGraphics, ptAppData->uRenderTarget);
+        gptGfx->submit_3d_drawlist(&ptAppData->t3DDrawList, (float)PL_BENCHMARK_WIDTH, (float)PL_BENCHMARK_HEIGHT, &tMVP, PL_PIPELINE_FLAG_DEPTH_TEST | PL_PIPELINE_FLAG_DEPTH_WRITE);
+        gptGfx->end_render_target(&ptAppData->tGraphics);
+
+        // executed by begin_recording
+        pl__declare_preview_graph(ptAppData);
+
+        if(ptAppData->uFrame + 1 == uLastFrame)
+            ptAppData->uReadback = gptGfx->request_readback(&ptAppData->tGraphics, ptAppData->uRenderTarget);
+    }
+    ptAppData->uFrame++;
+
+    // results arrive a few frames later, keep presenting until then
+    plReadback tReadback = {0};
+    if(ptAppData->uReadback != PL_RENDER_TARGET_NONE && !ptAppData->bReported && gptGfx->get_readback(&ptAppData->tGraphics, ptAppData->uReadback, &tReadback))
+    {
+        pl__report(ptAppData, &tReadback);
+        gptGfx->release_readback(&ptAppData->tGraphics, ptAppData->uReadback);
+        ptAppData->bReported = true;
+        gptOs->request_exit();
+    }
+    else if(ptAppData->uRenderTarget == PL_RENDER_TARGET_NONE && !bMeasuring && !ptAppData->bReported)
+    {
+        // backends without render targets (metal) only report timings
+        pl__report(ptAppData, NULL);
+        ptAppData->bReported = true;
+        gptOs->request_exit();
+    }
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~main pass~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    gptGfx->begin_recording(&ptAppData->tGraphics);
+
+    pl_new_frame();
+
+    pl_set_next_window_pos((plVec2){0, 0}, PL_UI_COND_ONCE);
+    if(pl_begin_window("Benchmark", NULL, false))
+    {
+        const float pfRatios[] = {1.0f};
+        pl_layout_row(PL_UI_LAYOUT_ROW_TYPE_DYNAMIC, 0.0f, 1, pfRatios);
+        pl_text("frame %u / %u", ptAppData->uFrame, uLastFrame);
+        pl_text("graph preview slot %u", ptAppData->uPreviewSlot);
+        pl_end_window();
+    }
+
+    pl_render();
+
+    // survivors of this frame's cull_areas (variants only build against the main pass)
+    if(bMeasuring)
+        gptGfx->draw_areas(&ptAppData->tGraphics, 1, &ptAppData->tCullArea, ptAppData->sbtCullDraws);
+
+    gptGfx->draw_lists(&ptAppData->tGraphics, 1, &ptAppData->drawlist);
+    gptGfx->draw_lists(&ptAppData->tGraphics, 1, pl_get_draw_list(NULL));
+
+    gptGfx->end_recording(&ptAppData->tGraphics);
+    gptGfx->end_frame(&ptAppData->tGraphics);
+    pl_end_profile_frame();
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] unity build
+//-----------------------------------------------------------------------------
+
+#include "camera.c"
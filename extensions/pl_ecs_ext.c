@@ -5,10 +5,13 @@
 /*
 Index of this file:
 // [SECTION] includes
+// [SECTION] defines
+// [SECTION] internal structs
 // [SECTION] global data
 // [SECTION] internal api
 // [SECTION] public api implementations
 // [SECTION] internal api implementations
+// [SECTION] transform kernels
 // [SECTION] extension loading
 */
 
@@ -23,6 +26,273 @@ Index of this file:
 #include "pl_math.h"
 #include "pl_profile.h"
 #include "pl_log.h"
+#include "pl_os.h"
+#include <float.h>  // FLT_MAX
+#include <stdlib.h> // qsort
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define PL_ECS_SIMD_X86
+    #include <immintrin.h> // sse2 (baseline), avx2 & fma (runtime detected)
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h> // __cpuid
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define PL_ECS_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// [SECTION] defines
+//-----------------------------------------------------------------------------
+
+#ifndef PL_ECS_MAX_WORKERS
+    #define PL_ECS_MAX_WORKERS 64
+#endif
+
+#ifndef PL_ECS_TRANSFORM_BATCH
+    #define PL_ECS_TRANSFORM_BATCH 256 // matrices gathered per kernel call by the systems
+#endif
+
+#ifndef PL_ECS_STRING_BLOCK_SIZE
+    #define PL_ECS_STRING_BLOCK_SIZE 65536 // bytes per interned string block (longer strings get their own)
+#endif
+
+// avx2 kernels are compiled for avx2 regardless of the build flags & only
+// called after cpu detection (msvc needs no opt in)
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define PL_ECS_TARGET_AVX2
+#else
+    #define PL_ECS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+#if defined(_MSC_VER)
+    #define PL_ECS_THREAD_LOCAL __declspec(thread)
+#else
+    #define PL_ECS_THREAD_LOCAL __thread
+#endif
+
+#define PL_MESH_FIFO_CACHE_SIZE    16    // ACMR & overdraw clustering
+#define PL_MESH_FORSYTH_CACHE_SIZE 32    // vertex cache optimization scoring
+#define PL_MESH_OVERDRAW_THRESHOLD 1.05f // max ACMR increase allowed by overdraw reordering
+#define PL_MESH_LOD_MAX_ERROR      0.02f // per lod, relative to the mesh extent
+#define PL_MESH_FRAME_CHUNK_SIZE   16384 // min triangles (or vertices) per normal & tangent task
+#define PL_MESH_FRAME_MAX_CHUNKS   256   // per mesh & pass, bounds the [face chunk][vertex range] table
+
+//-----------------------------------------------------------------------------
+// [SECTION] internal structs
+//-----------------------------------------------------------------------------
+
+// tasks run on the pool's worker threads & must not allocate or log (neither
+// is thread safe), the calling thread is worker 0 (sets started from inside a
+// task run inline, as worker 0 of the nested set)
+typedef void (*plEcsTask)(void* pData, uint32_t uIndex, uint32_t uWorker);
+
+typedef struct _plEcsTaskSet
+{
+    plEcsTask ptTask;
+    void*     pData;
+    uint32_t  uCount;
+    uint32_t  uWorkerCount; // including the calling thread
+    uint32_t  uNextIndex;   // protected by the pool mutex
+    uint32_t  uJoinedCount; // pool threads that took a worker index
+} plEcsTaskSet;
+
+typedef struct _plEcsTaskPool
+{
+    plThread*            aptThreads[PL_ECS_MAX_WORKERS]; // [0] unused, the calling thread is worker 0
+    uint32_t             uThreadCount;    // including the calling thread, 0 until created
+    plMutex*             ptMutex;
+    plConditionVariable* ptWorkCondition; // set published or quitting
+    plConditionVariable* ptDoneCondition; // last busy thread left the set
+    plEcsTaskSet*        ptSet;           // NULL when idle
+    uint32_t             uGeneration;     // bumped per set, threads join each set once
+    uint32_t             uBusyCount;      // pool threads working on ptSet
+    bool                 bQuit;
+} plEcsTaskPool;
+
+typedef struct _plEcsQuery
+{
+    plComponentManager* aptInclude[PL_ECS_MAX_QUERY_COMPONENTS];
+    plComponentManager* aptExclude[PL_ECS_MAX_QUERY_COMPONENTS];
+    uint32_t            auIncludeVersions[PL_ECS_MAX_QUERY_COMPONENTS]; // layouts the matches were built against
+    uint32_t            auExcludeVersions[PL_ECS_MAX_QUERY_COMPONENTS];
+    uint32_t            uIncludeCount;
+    uint32_t            uExcludeCount;
+    bool                bBuilt;
+
+    // matches, in the dense order of the smallest include
+    plEntity* sbtEntities;
+    uint32_t* sbuIndices[PL_ECS_MAX_QUERY_COMPONENTS]; // per include
+} plEcsQuery;
+
+typedef struct _plEcsQueryJob
+{
+    plEcsQuery*       ptQuery;
+    plEcsQueryChunkFn pfChunk;
+    void*             pUserData;
+} plEcsQueryJob;
+
+typedef struct _plQuadric
+{
+    float fA00, fA11, fA22, fA01, fA02, fA12; // symmetric 3x3
+    float fB0, fB1, fB2;
+    float fC;
+    float fWeight; // total area
+} plQuadric;
+
+typedef struct _plEdgeCollapse
+{
+    uint32_t uFrom; // removed
+    uint32_t uTo;
+    float    fCost;
+} plEdgeCollapse;
+
+typedef struct _plMeshClusterKey
+{
+    float    fKey;
+    uint32_t uCluster;
+} plMeshClusterKey;
+
+// carved out of one block per worker, sized for the largest mesh
+typedef struct _plMeshOptimizeScratch
+{
+    uint32_t*         puHashTable; // weld & seam detection
+    uint32_t          uHashTableSize;
+    uint32_t*         puRemap;
+    uint32_t*         puTimestamps; // fifo cache simulation
+    uint32_t*         puAdjacencyCounts;
+    uint32_t*         puAdjacencyOffsets;
+    uint32_t*         puAdjacency; // live triangles around each vertex
+    int32_t*          piCachePositions;
+    float*            pfVertexScores;
+    float*            pfTriangleScores;
+    uint8_t*          puTriangleFlags;
+    uint8_t*          puVertexFlags;
+    uint32_t*         puIndices; // reordering destination
+    uint32_t*         puHardClusters;
+    uint32_t*         puClusters;
+    plMeshClusterKey* atClusterKeys;
+    uint8_t*          puStreamData; // largest vertex stream
+    plVec3*           atPositions;  // normalized for simplification
+    plQuadric*        atQuadrics;
+    plEdgeCollapse*   atCollapses;
+} plMeshOptimizeScratch;
+
+typedef struct _plMeshOptimizeResult
+{
+    uint32_t uVertexCount; // after welding & dropping unused vertices
+    uint32_t uLodIndexCount;
+    float    fAcmrBefore;
+    float    fAcmrAfter;
+} plMeshOptimizeResult;
+
+typedef struct _plMeshOptimizeJob
+{
+    plMeshComponent*      atMeshes;
+    plMeshOptimizeResult* atResults;
+    uint8_t**             apWorkerScratch;
+    uint32_t              uLodCount;
+} plMeshOptimizeJob;
+
+// normals & tangents: faces are processed in chunks, their corners bucketed by
+// vertex range, then each range accumulates only into vertices it owns
+typedef struct _plMeshFrameMesh
+{
+    plMeshComponent* ptMesh;
+    bool             bNormals; // streams being generated
+    bool             bTangents;
+    uint32_t         uFaceCount;
+    uint32_t         uFacesPerChunk;
+    uint32_t         uFaceChunkCount;
+    uint32_t         uRangeShift; // ranges are 1 << uRangeShift vertices
+    uint32_t         uRangeCount;
+    float*           afFaces;         // soa, see plMeshFaceStreams (normals only without tangents)
+    uint32_t*        auBucketOffsets; // [face chunk][vertex range], corner counts then write cursors
+    uint32_t*        auRangeOffsets;  // corners of range r are [auRangeOffsets[r], auRangeOffsets[r + 1])
+    uint32_t*        auCorners;       // index buffer positions, face order within a range
+} plMeshFrameMesh;
+
+typedef struct _plMeshFrameTask
+{
+    uint32_t uMesh;
+    uint32_t uChunk; // face chunk or vertex range
+} plMeshFrameTask;
+
+typedef struct _plMeshFrameJob
+{
+    plMeshFrameMesh* atMeshes;
+    plMeshFrameTask* sbtFaceTasks;
+    plMeshFrameTask* sbtRangeTasks;
+} plMeshFrameJob;
+
+// one per hierarchy component, parents always come before their children
+typedef struct _plHierarchyNode
+{
+    uint32_t uTransform;       // dense transform index of the child, UINT32_MAX if it has none
+    uint32_t uParentTransform; // dense transform index of the parent, UINT32_MAX acts as a root
+    uint32_t uParentSlot;      // parent's node, UINT32_MAX if the parent has no hierarchy component
+    bool     bDirty;           // recomputed this update, read by the children
+} plHierarchyNode;
+
+// soa face data written by the mesh face kernels
+typedef struct _plMeshFaceStreams
+{
+    const plVec3*   atPositions;
+    const plVec2*   atUVs;       // NULL skips the tangent frames
+    const uint32_t* auIndices;
+    float*          apfFaces[9]; // normal (area weighted), unit tangent (dP/du) & corner angles signed by the uv orientation, tangent & angles 0 for degenerate uvs
+} plMeshFaceStreams;
+
+typedef struct _plTransformKernels
+{
+    void (*mul_mat4)   (const plMat4* atA, const plMat4* atB, plMat4* atOut, uint32_t uCount);
+    void (*compose_trs)(const plVec3* atScales, const plVec4* atRotations, const plVec3* atTranslations, plMat4* atOut, uint32_t uCount);
+    void (*invert_mat4)(const plMat4* atMats, plMat4* atOut, uint32_t uCount);
+    void (*mesh_faces) (const plMeshFaceStreams* ptStreams, uint32_t uFirstFace, uint32_t uFaceCount); // avx2 uses sse (gathers measured slower)
+} plTransformKernels;
+
+typedef struct _plHierarchySystemData
+{
+    plHierarchyNode* sbtNodes;          // depth sorted
+    uint32_t         uLevelCount;       // sbuDepthOffsets[i] is the end of depth i's nodes
+    uint32_t         uHierarchyVersion; // layout versions the nodes were built against
+    uint32_t         uTransformVersion;
+    bool             bBuilt;
+
+    // rebuild scratch
+    uint32_t* sbuDepths;
+    uint32_t* sbuSlots;
+    uint32_t* sbuChain;
+    uint32_t* sbuDepthOffsets;
+
+    // dirty nodes of one depth, multiplied together
+    plMat4   atBatchParents[PL_ECS_TRANSFORM_BATCH];
+    plMat4   atBatchLocals[PL_ECS_TRANSFORM_BATCH];
+    uint32_t auBatchTargets[PL_ECS_TRANSFORM_BATCH];
+} plHierarchySystemData;
+
+typedef struct _plTagSystemData
+{
+    // interned strings (blocks never move, so handed out pointers stay valid)
+    char**       sbcBlocks;
+    char*        pcCurrentBlock;
+    size_t       szCurrentBlockUsed;
+    const char** sbcStrings;        // by string id, id 0 is ""
+    plHashMap    tStringIds;        // string hash -> string id, collisions rehash the key
+
+    // name index, by string id (entries go stale when the entity loses the name,
+    // get_entity rescans the tags only if others still share it)
+    plEntity*    sbtNamedEntities;
+    uint32_t*    sbuNameCounts;     // tags currently holding the id
+} plTagSystemData;
+
+enum _plMeshVertexFlags
+{
+    PL_MESH_VERTEX_FLAG_SEAM    = 1 << 0, // shares its position with another vertex
+    PL_MESH_VERTEX_FLAG_BORDER  = 1 << 1,
+    PL_MESH_VERTEX_FLAG_TOUCHED = 1 << 2, // collapsed this pass
+    PL_MESH_VERTEX_FLAG_LOCKED  = PL_MESH_VERTEX_FLAG_SEAM | PL_MESH_VERTEX_FLAG_BORDER
+};
 
 //-----------------------------------------------------------------------------
 // [SECTION] global data
@@ -30,17 +300,93 @@ Index of this file:
 
 static uint32_t uLogChannel = UINT32_MAX;
 
+static const plThreadsApiI* gptThreads = NULL; // optional, work runs on the calling thread without it
+static const plDeviceI*     gptDevice  = NULL; // optional, only needed by upload_object_instances & upload_meshes
+static const plDataRegistryApiI* gptDataRegistry = NULL;
+
+// created at load, reused by every parallel system
+static plEcsTaskPool gtTaskPool = {0};
+static PL_ECS_THREAD_LOCAL bool gbInsideTask = false; // pool threads & callers running a set
+
+// selected at load
+static plTransformBackend gtTransformBackend = PL_TRANSFORM_BACKEND_SCALAR;
+static plTransformKernels gtTransformKernels = {0};
+
 //-----------------------------------------------------------------------------
 // [SECTION] internal api
 //-----------------------------------------------------------------------------
 
 static void     pl_ecs_init_component_library(const plApiRegistryApiI* ptApiRegistry, plComponentLibrary* ptLibrary);
 static plEntity pl_ecs_create_entity         (plComponentLibrary* ptLibrary);
+static void     pl_ecs_destroy_entity        (plComponentLibrary* ptLibrary, plEntity tEntity);
+static bool     pl_ecs_is_entity_valid       (plComponentLibrary* ptLibrary, plEntity tEntity);
 static plEntity pl_ecs_get_entity            (plComponentLibrary* ptLibrary, const char* pcName);
 static size_t   pl_ecs_get_index             (plComponentManager* ptManager, plEntity tEntity);
 static void*    pl_ecs_get_component         (plComponentManager* ptManager, plEntity tEntity);
 static void*    pl_ecs_create_component      (plComponentManager* ptManager, plEntity tEntity);
+static void     pl_ecs_remove_component      (plComponentManager* ptManager, plEntity tEntity);
 static bool     pl_ecs_has_entity            (plComponentManager* ptManager, plEntity tEntity);
+static void     pl_ecs_mark_changed          (plComponentManager* ptManager, plEntity tEntity);
+
+// sparse sets
+static inline uint32_t* pl__get_sparse_slot (const plComponentManager* ptManager, plEntity tEntity);
+static void             pl__sparse_set_insert(plComponentManager* ptManager, plEntity tEntity);
+static void             pl__sparse_set_free  (plComponentManager* ptManager);
+static inline uint32_t  pl__resolve_index    (const plComponentManager* ptManager, plEntity tEntity, uint32_t* puCachedIndex);
+
+// change tracking
+static inline void pl__stamp_change          (plComponentManager* ptManager, uint32_t uIndex);
+static uint32_t    pl__sync_changes          (plComponentManager* ptManager);
+static void        pl__stamp_dirty_transforms(plComponentManager* ptManager);
+
+// type erased storage
+static void pl__init_component_manager(plComponentManager* ptManager, plComponentType tType, const plComponentDesc* ptDesc);
+static void pl__grow_components       (plComponentManager* ptManager);
+static void pl__free_component_manager(plComponentManager* ptManager);
+static void pl__construct_transform   (void* pComponent);
+static void pl__construct_light       (void* pComponent);
+static void pl__destruct_mesh         (void* pComponent);
+static void pl__free_mesh_data        (plMeshComponent* ptMesh);
+
+// component registration
+static plComponentType     pl_ecs_register_component(plComponentLibrary* ptLibrary, const plComponentDesc* ptDesc);
+static plComponentManager* pl_ecs_get_manager       (plComponentLibrary* ptLibrary, plComponentType tType);
+
+// names (pSystemData of the tag manager holds the string pool & name index)
+static uint32_t    pl_ecs_intern_string(plComponentLibrary* ptLibrary, const char* pcString);
+static const char* pl_ecs_get_string   (plComponentLibrary* ptLibrary, uint32_t uStringId);
+static void        pl_ecs_set_name     (plComponentLibrary* ptLibrary, plEntity tEntity, const char* pcName);
+static const char* pl_ecs_get_name     (plComponentLibrary* ptLibrary, plEntity tEntity);
+static uint32_t    pl__intern_string   (plTagSystemData* ptData, const char* pcString);
+static uint32_t    pl__find_string     (plTagSystemData* ptData, const char* pcString, uint64_t* pulKeyOut); // UINT32_MAX if not interned
+static void        pl__index_name      (plTagSystemData* ptData, plEntity tEntity, uint32_t uNameId);
+static void        pl__unindex_name    (plTagSystemData* ptData, uint32_t uNameId);
+static void        pl__free_tag_system (plComponentManager* ptManager);
+
+// hierarchy
+static void pl__build_hierarchy_nodes(plComponentLibrary* ptLibrary, plHierarchySystemData* ptData);
+static void pl__flush_hierarchy_batch(plHierarchySystemData* ptData, plComponentManager* ptTransformManager, uint32_t uCount);
+
+// transform storage, either layout (pSystemData of the transform manager holds the soa columns)
+static inline plMat4* pl__get_transform_local            (plComponentManager* ptManager, uint32_t uIndex);
+static inline plMat4* pl__get_transform_world            (plComponentManager* ptManager, uint32_t uIndex);
+static inline bool    pl__is_transform_dirty             (const plComponentManager* ptManager, uint32_t uIndex);
+static inline void    pl__set_transform_dirty            (plComponentManager* ptManager, uint32_t uIndex, bool bDirty);
+static void           pl__create_transform_columns_entry (plComponentManager* ptManager);
+static void           pl__remove_transform_columns_entry (plComponentManager* ptManager, uint32_t uIndex);
+static void           pl__free_transform_columns         (plComponentManager* ptManager);
+static void           pl_ecs_set_transform_layout        (plComponentLibrary* ptLibrary, plTransformLayout tLayout);
+static bool           pl_ecs_get_transform_columns       (plComponentLibrary* ptLibrary, plTransformColumns* ptColumnsOut);
+static void           pl_compose_transform_columns       (plTransformColumns* ptColumns);
+
+// transform kernels (public api wraps the selected backend)
+static bool               pl__set_transform_backend     (plTransformBackend tBackend);
+static plTransformBackend pl__get_transform_backend     (void);
+static const char*        pl__get_transform_backend_name(plTransformBackend tBackend);
+static void               pl__mul_mat4                  (const plMat4* atA, const plMat4* atB, plMat4* atOut, uint32_t uCount);
+static void               pl__compose_trs               (const plVec3* atScales, const plVec4* atRotations, const plVec3* atTranslations, plMat4* atOut, uint32_t uCount);
+static void               pl__invert_mat4               (const plMat4* atMats, plMat4* atOut, uint32_t uCount);
+static void               pl_compose_transforms         (plTransformComponent* atTransforms, uint32_t uComponentCount);
 
 static plVec4   pl_entity_to_color(plEntity tEntity);
 static plEntity pl_color_to_entity(const plVec4* ptColor);
@@ -65,10 +411,57 @@ static void pl_remove_mesh_outline(plComponentLibrary* ptLibrary, plEntity tEnti
 static void pl_ecs_cleanup_systems        (const plApiRegistryApiI* ptApiRegistry, plComponentLibrary* ptLibrary);
 static void pl_run_object_update_system   (plComponentLibrary* ptLibrary);
 static void pl_run_hierarchy_update_system(plComponentLibrary* ptLibrary);
+static void pl_upload_object_instances    (plComponentLibrary* ptLibrary, plDevice* ptDevice);
 
 // misc.
 static void pl_calculate_normals (plMeshComponent* atMeshes, uint32_t uComponentCount);
 static void pl_calculate_tangents(plMeshComponent* atMeshes, uint32_t uComponentCount);
+static void pl_calculate_bounds  (plMeshComponent* atMeshes, uint32_t uComponentCount);
+static void pl_pack_vertices     (plMeshComponent* atMeshes, uint32_t uComponentCount);
+static void pl_upload_meshes     (plMeshComponent* atMeshes, uint32_t uComponentCount, plDevice* ptDevice);
+static void pl_optimize_meshes   (plMeshComponent* atMeshes, uint32_t uComponentCount, uint32_t uLodCount);
+
+// queries
+static plEcsQuery* pl_ecs_create_query     (const plEcsQueryDesc* ptDesc);
+static void        pl_ecs_destroy_query    (plEcsQuery* ptQuery);
+static uint32_t    pl_ecs_update_query     (plEcsQuery* ptQuery);
+static void        pl_ecs_get_query_chunk  (plEcsQuery* ptQuery, uint32_t uChunk, plEcsQueryChunk* ptChunkOut);
+static void        pl_ecs_run_query        (plEcsQuery* ptQuery, plEcsQueryChunkFn pfChunk, void* pUserData, bool bParallel);
+static void        pl__run_query_chunk_task(void* pData, uint32_t uIndex, uint32_t uWorker);
+
+// tasks
+static void     pl__create_task_pool     (void);
+static void     pl__destroy_task_pool    (void);
+static uint32_t pl__get_task_worker_count(uint32_t uTaskCount);
+static void*    pl__task_worker          (void* pData);
+static void     pl__run_tasks            (plEcsTask ptTask, void* pData, uint32_t uTaskCount, uint32_t uWorkerCount);
+
+// mesh optimization (thread safe, scratch memory only)
+static uint32_t pl__get_vertex_streams      (plMeshComponent* ptMesh, uint8_t** apStreams, uint32_t* auStrides);
+static void     pl__resize_vertex_streams   (plMeshComponent* ptMesh, uint32_t uVertexCount);
+static size_t   pl__carve_mesh_scratch      (plMeshOptimizeScratch* ptScratch, uint8_t* puMemory, uint32_t uVertexCount, uint32_t uIndexCount);
+static void     pl__optimize_mesh_task      (void* pData, uint32_t uIndex, uint32_t uWorker);
+static float    pl__calculate_acmr          (const uint32_t* puIndices, uint32_t uIndexCount, uint32_t uVertexCount, uint32_t* puTimestamps);
+static uint32_t pl__weld_vertices           (uint32_t* puIndices, uint32_t uIndexCount, uint8_t** apStreams, const uint32_t* auStrides, uint32_t uStreamCount, uint32_t uVertexCount, plMeshOptimizeScratch* ptScratch);
+static void     pl__optimize_vertex_cache   (uint32_t* puIndices, uint32_t uIndexCount, uint32_t uVertexCount, plMeshOptimizeScratch* ptScratch);
+static void     pl__optimize_overdraw       (uint32_t* puIndices, uint32_t uIndexCount, const plVec3* atPositions, uint32_t uVertexCount, plMeshOptimizeScratch* ptScratch);
+static uint32_t pl__optimize_vertex_fetch   (uint32_t* puIndices, uint32_t uIndexCount, uint8_t** apStreams, const uint32_t* auStrides, uint32_t uStreamCount, uint32_t uVertexCount, plMeshOptimizeScratch* ptScratch);
+static void     pl__find_seam_vertices      (const plVec3* atPositions, uint32_t uVertexCount, plMeshOptimizeScratch* ptScratch);
+static uint32_t pl__simplify                (const uint32_t* puSource, uint32_t uIndexCount, uint32_t uTargetCount, float fMaxError, uint32_t uVertexCount, uint32_t* puDestination, float* pfErrorOut, plMeshOptimizeScratch* ptScratch);
+
+// normals & tangents (thread safe, job memory only)
+static void   pl__generate_vertex_frames(plMeshComponent* atMeshes, uint32_t uComponentCount, bool bNormals, bool bTangents);
+static void   pl__mesh_face_task        (void* pData, uint32_t uIndex, uint32_t uWorker);
+static void   pl__mesh_corner_task      (void* pData, uint32_t uIndex, uint32_t uWorker);
+static void   pl__mesh_vertex_task      (void* pData, uint32_t uIndex, uint32_t uWorker);
+static float  pl__acos_approx           (float fCos);
+static plVec3 pl__orthogonal_vec3       (plVec3 tNormal);
+
+// vertex quantization
+static plVec2   pl__encode_octahedral(plVec3 tNormal);
+static int16_t  pl__quantize_snorm16 (float fValue);
+static uint8_t  pl__quantize_unorm8  (float fValue);
+static uint16_t pl__float_to_half    (float fValue);
 
 // camera
 static void pl_camera_set_fov        (plCameraComponent* ptCamera, float fYFov);
@@ -90,11 +483,21 @@ pl_load_ecs_api(void)
     static const plEcsI tApi = {
         .init_component_library      = pl_ecs_init_component_library,
         .create_entity               = pl_ecs_create_entity,
+        .destroy_entity              = pl_ecs_destroy_entity,
+        .is_entity_valid             = pl_ecs_is_entity_valid,
         .get_entity                  = pl_ecs_get_entity,
         .get_index                   = pl_ecs_get_index,
         .get_component               = pl_ecs_get_component,
         .create_component            = pl_ecs_create_component,
+        .remove_component            = pl_ecs_remove_component,
         .has_entity                  = pl_ecs_has_entity,
+        .mark_changed                = pl_ecs_mark_changed,
+        .register_component          = pl_ecs_register_component,
+        .get_manager                 = pl_ecs_get_manager,
+        .intern_string               = pl_ecs_intern_string,
+        .get_string                  = pl_ecs_get_string,
+        .set_name                    = pl_ecs_set_name,
+        .get_name                    = pl_ecs_get_name,
         .create_mesh                 = pl_ecs_create_mesh,
         .create_material             = pl_ecs_create_material,
         .create_object               = pl_ecs_create_object,
@@ -109,7 +512,21 @@ pl_load_ecs_api(void)
         .run_object_update_system    = pl_run_object_update_system,
         .calculate_normals           = pl_calculate_normals,
         .calculate_tangents          = pl_calculate_tangents,
+        .calculate_bounds            = pl_calculate_bounds,
+        .pack_vertices               = pl_pack_vertices,
+        .upload_meshes               = pl_upload_meshes,
+        .optimize_meshes             = pl_optimize_meshes,
+        .set_transform_layout        = pl_ecs_set_transform_layout,
+        .get_transform_columns       = pl_ecs_get_transform_columns,
+        .compose_transforms          = pl_compose_transforms,
+        .compose_transform_columns   = pl_compose_transform_columns,
+        .create_query                = pl_ecs_create_query,
+        .destroy_query               = pl_ecs_destroy_query,
+        .update_query                = pl_ecs_update_query,
+        .get_query_chunk             = pl_ecs_get_query_chunk,
+        .run_query                   = pl_ecs_run_query,
         .run_hierarchy_update_system = pl_run_hierarchy_update_system,
+        .upload_object_instances     = pl_upload_object_instances,
         .entity_to_color             = pl_entity_to_color,
         .color_to_entity             = pl_color_to_entity
     };
@@ -132,6 +549,20 @@ pl_load_camera_api(void)
     return &tApi;    
 }
 
+const plTransformI*
+pl_load_transform_api(void)
+{
+    static const plTransformI tApi = {
+        .set_backend      = pl__set_transform_backend,
+        .get_backend      = pl__get_transform_backend,
+        .get_backend_name = pl__get_transform_backend_name,
+        .mul_mat4         = pl__mul_mat4,
+        .compose_trs      = pl__compose_trs,
+        .invert_mat4      = pl__invert_mat4
+    };
+    return &tApi;
+}
+
 //-----------------------------------------------------------------------------
 // [SECTION] internal api implementation
 //-----------------------------------------------------------------------------
@@ -150,34 +581,32 @@ static void
 pl_ecs_init_component_library(const plApiRegistryApiI* ptApiRegistry, plComponentLibrary* ptLibrary)
 {
 
-    ptLibrary->tNextEntity = 1;
-
-    // initialize component managers
-    ptLibrary->tTagComponentManager.tComponentType = PL_COMPONENT_TYPE_TAG;
-    ptLibrary->tTagComponentManager.szStride = sizeof(plTagComponent);
+    // index 0 is PL_INVALID_ENTITY_HANDLE & never handed out
+    pl_sb_push(ptLibrary->sbuEntityGenerations, 0);
 
-    ptLibrary->tTransformComponentManager.tComponentType = PL_COMPONENT_TYPE_TRANSFORM;
-    ptLibrary->tTransformComponentManager.szStride = sizeof(plTransformComponent);
+    // initialize component managers (built in types go through the same path as registered ones)
+    pl__init_component_manager(&ptLibrary->tTagComponentManager,       PL_COMPONENT_TYPE_TAG,       &(plComponentDesc){.pcName = "tag",       .szSize = sizeof(plTagComponent)});
+    pl__init_component_manager(&ptLibrary->tTransformComponentManager, PL_COMPONENT_TYPE_TRANSFORM, &(plComponentDesc){.pcName = "transform", .szSize = sizeof(plTransformComponent), .pfConstruct = pl__construct_transform});
+    pl__init_component_manager(&ptLibrary->tObjectComponentManager,    PL_COMPONENT_TYPE_OBJECT,    &(plComponentDesc){.pcName = "object",    .szSize = sizeof(plObjectComponent)});
+    pl__init_component_manager(&ptLibrary->tMaterialComponentManager,  PL_COMPONENT_TYPE_MATERIAL,  &(plComponentDesc){.pcName = "material",  .szSize = sizeof(plMaterialComponent)});
+    pl__init_component_manager(&ptLibrary->tMeshComponentManager,      PL_COMPONENT_TYPE_MESH,      &(plComponentDesc){.pcName = "mesh",      .szSize = sizeof(plMeshComponent), .pfDestruct = pl__destruct_mesh});
+    pl__init_component_manager(&ptLibrary->tCameraComponentManager,    PL_COMPONENT_TYPE_CAMERA,    &(plComponentDesc){.pcName = "camera",    .szSize = sizeof(plCameraComponent)});
+    pl__init_component_manager(&ptLibrary->tHierarchyComponentManager, PL_COMPONENT_TYPE_HIERARCHY, &(plComponentDesc){.pcName = "hierarchy", .szSize = sizeof(plHierarchyComponent)});
+    pl__init_component_manager(&ptLibrary->tLightComponentManager,     PL_COMPONENT_TYPE_LIGHT,     &(plComponentDesc){.pcName = "light",     .szSize = sizeof(plLightComponent), .pfConstruct = pl__construct_light});
 
-    ptLibrary->tObjectComponentManager.tComponentType = PL_COMPONENT_TYPE_OBJECT;
-    ptLibrary->tObjectComponentManager.szStride = sizeof(plObjectComponent);
     ptLibrary->tObjectComponentManager.pSystemData = PL_ALLOC(sizeof(plObjectSystemData));
     memset(ptLibrary->tObjectComponentManager.pSystemData, 0, sizeof(plObjectSystemData));
 
-    ptLibrary->tMaterialComponentManager.tComponentType = PL_COMPONENT_TYPE_MATERIAL;
-    ptLibrary->tMaterialComponentManager.szStride = sizeof(plMaterialComponent);
-
-    ptLibrary->tMeshComponentManager.tComponentType = PL_COMPONENT_TYPE_MESH;
-    ptLibrary->tMeshComponentManager.szStride = sizeof(plMeshComponent);
-    
-    ptLibrary->tCameraComponentManager.tComponentType = PL_COMPONENT_TYPE_CAMERA;
-    ptLibrary->tCameraComponentManager.szStride = sizeof(plCameraComponent);
-
-    ptLibrary->tHierarchyComponentManager.tComponentType = PL_COMPONENT_TYPE_HIERARCHY;
-    ptLibrary->tHierarchyComponentManager.szStride = sizeof(plHierarchyComponent);
+    ptLibrary->tHierarchyComponentManager.pSystemData = PL_ALLOC(sizeof(plHierarchySystemData));
+    memset(ptLibrary->tHierarchyComponentManager.pSystemData, 0, sizeof(plHierarchySystemData));
 
-    ptLibrary->tLightComponentManager.tComponentType = PL_COMPONENT_TYPE_LIGHT;
-    ptLibrary->tLightComponentManager.szStride = sizeof(plLightComponent);
+    // string id 0 is the empty string (zeroed tags), it is never indexed
+    plTagSystemData* ptTagSystemData = PL_ALLOC(sizeof(plTagSystemData));
+    memset(ptTagSystemData, 0, sizeof(plTagSystemData));
+    pl_sb_push(ptTagSystemData->sbcStrings, "");
+    pl_sb_push(ptTagSystemData->sbtNamedEntities, PL_INVALID_ENTITY_HANDLE);
+    pl_sb_push(ptTagSystemData->sbuNameCounts, 0);
+    ptLibrary->tTagComponentManager.pSystemData = ptTagSystemData;
 
     pl_log_info_to(uLogChannel, "initialized component library");
 
@@ -186,32 +615,162 @@ pl_ecs_init_component_library(const plApiRegistryApiI* ptApiRegistry, plComponen
 static plEntity
 pl_ecs_create_entity(plComponentLibrary* ptLibrary)
 {
-    plEntity tNewEntity = ptLibrary->tNextEntity++;
-    return tNewEntity;
+    uint32_t uIndex = 0;
+    if(pl_sb_size(ptLibrary->sbuFreeEntities) > 0)
+        uIndex = pl_sb_pop(ptLibrary->sbuFreeEntities);
+    else
+    {
+        uIndex = pl_sb_size(ptLibrary->sbuEntityGenerations);
+        pl_sb_push(ptLibrary->sbuEntityGenerations, 0);
+    }
+    return PL_ENTITY(uIndex, ptLibrary->sbuEntityGenerations[uIndex]);
+}
+
+static void
+pl_ecs_destroy_entity(plComponentLibrary* ptLibrary, plEntity tEntity)
+{
+    PL_ASSERT(pl_ecs_is_entity_valid(ptLibrary, tEntity) && "destroying a stale entity");
+
+    plComponentManager* atManagers[] = {
+        &ptLibrary->tTagComponentManager,
+        &ptLibrary->tTransformComponentManager,
+        &ptLibrary->tMeshComponentManager,
+        &ptLibrary->tMaterialComponentManager,
+        &ptLibrary->tObjectComponentManager,
+        &ptLibrary->tCameraComponentManager,
+        &ptLibrary->tHierarchyComponentManager,
+        &ptLibrary->tLightComponentManager
+    };
+    for(uint32_t i = 0; i < sizeof(atManagers) / sizeof(atManagers[0]); i++)
+    {
+        if(pl_ecs_has_entity(atManagers[i], tEntity))
+            pl_ecs_remove_component(atManagers[i], tEntity);
+    }
+    for(uint32_t i = 0; i < pl_sb_size(ptLibrary->sbtCustomManagers); i++)
+    {
+        if(pl_ecs_has_entity(ptLibrary->sbtCustomManagers[i], tEntity))
+            pl_ecs_remove_component(ptLibrary->sbtCustomManagers[i], tEntity);
+    }
+
+    // outstanding handles no longer match, the index is reused with the new generation
+    const uint32_t uIndex = PL_ENTITY_INDEX(tEntity);
+    ptLibrary->sbuEntityGenerations[uIndex]++;
+    pl_sb_push(ptLibrary->sbuFreeEntities, uIndex);
+}
+
+static bool
+pl_ecs_is_entity_valid(plComponentLibrary* ptLibrary, plEntity tEntity)
+{
+    const uint32_t uIndex = PL_ENTITY_INDEX(tEntity);
+    return uIndex != 0 && uIndex < pl_sb_size(ptLibrary->sbuEntityGenerations) && ptLibrary->sbuEntityGenerations[uIndex] == PL_ENTITY_GENERATION(tEntity);
 }
 
 static plEntity
 pl_ecs_get_entity(plComponentLibrary* ptLibrary, const char* pcName)
 {
-    plTagComponent* sbComponents = ptLibrary->tTagComponentManager.pComponents;
-    for(uint32_t i = 0; i < pl_sb_size(sbComponents); i++)
+    plComponentManager* ptManager = &ptLibrary->tTagComponentManager;
+    plTagSystemData* ptData = ptManager->pSystemData;
+
+    const uint32_t uNameId = pl__find_string(ptData, pcName, NULL);
+    if(uNameId == UINT32_MAX || uNameId == 0 || ptData->sbuNameCounts[uNameId] == 0)
+        return PL_INVALID_ENTITY_HANDLE;
+
+    // indexed entity still holds the name
+    const plEntity tEntity = ptData->sbtNamedEntities[uNameId];
+    if(pl_ecs_has_entity(ptManager, tEntity) && ((plTagComponent*)pl_ecs_get_component(ptManager, tEntity))->uNameId == uNameId)
+        return tEntity;
+
+    // it lost it but others share the name
+    const plTagComponent* atTags = ptManager->pComponents;
+    const uint32_t uTagCount = pl_sb_size(ptManager->sbtEntities);
+    for(uint32_t i = 0; i < uTagCount; i++)
     {
-        if(strcmp(sbComponents[i].acName, pcName) == 0)
+        if(atTags[i].uNameId == uNameId)
         {
-            return ptLibrary->tTagComponentManager.sbtEntities[i];
+            ptData->sbtNamedEntities[uNameId] = ptManager->sbtEntities[i];
+            return ptManager->sbtEntities[i];
         }
     }
-
+    PL_ASSERT(false && "name count out of sync with the tags");
     return PL_INVALID_ENTITY_HANDLE;
 }
 
+static plComponentType
+pl_ecs_register_component(plComponentLibrary* ptLibrary, const plComponentDesc* ptDesc)
+{
+    // heap allocated so manager pointers (queries, callers) survive later registrations
+    plComponentManager* ptManager = PL_ALLOC(sizeof(plComponentManager));
+    const plComponentType tType = PL_COMPONENT_TYPE_COUNT + (plComponentType)pl_sb_size(ptLibrary->sbtCustomManagers);
+    pl__init_component_manager(ptManager, tType, ptDesc);
+    pl_sb_push(ptLibrary->sbtCustomManagers, ptManager);
+    pl_log_info_to_f(uLogChannel, "registered component '%s' (type %d, stride %u)", ptDesc->pcName ? ptDesc->pcName : "unnamed", tType, (uint32_t)ptManager->szStride);
+    return tType;
+}
+
+static plComponentManager*
+pl_ecs_get_manager(plComponentLibrary* ptLibrary, plComponentType tType)
+{
+    switch(tType)
+    {
+        case PL_COMPONENT_TYPE_TAG:       return &ptLibrary->tTagComponentManager;
+        case PL_COMPONENT_TYPE_TRANSFORM: return &ptLibrary->tTransformComponentManager;
+        case PL_COMPONENT_TYPE_MESH:      return &ptLibrary->tMeshComponentManager;
+        case PL_COMPONENT_TYPE_MATERIAL:  return &ptLibrary->tMaterialComponentManager;
+        case PL_COMPONENT_TYPE_CAMERA:    return &ptLibrary->tCameraComponentManager;
+        case PL_COMPONENT_TYPE_OBJECT:    return &ptLibrary->tObjectComponentManager;
+        case PL_COMPONENT_TYPE_HIERARCHY: return &ptLibrary->tHierarchyComponentManager;
+        case PL_COMPONENT_TYPE_LIGHT:     return &ptLibrary->tLightComponentManager;
+        default: break;
+    }
+    PL_ASSERT(tType >= PL_COMPONENT_TYPE_COUNT && (uint32_t)(tType - PL_COMPONENT_TYPE_COUNT) < pl_sb_size(ptLibrary->sbtCustomManagers) && "unknown component type");
+    return ptLibrary->sbtCustomManagers[tType - PL_COMPONENT_TYPE_COUNT];
+}
+
+static uint32_t
+pl_ecs_intern_string(plComponentLibrary* ptLibrary, const char* pcString)
+{
+    return pl__intern_string(ptLibrary->tTagComponentManager.pSystemData, pcString);
+}
+
+static const char*
+pl_ecs_get_string(plComponentLibrary* ptLibrary, uint32_t uStringId)
+{
+    plTagSystemData* ptData = ptLibrary->tTagComponentManager.pSystemData;
+    PL_ASSERT(uStringId < pl_sb_size(ptData->sbcStrings) && "unknown string id");
+    return ptData->sbcStrings[uStringId];
+}
+
+static void
+pl_ecs_set_name(plComponentLibrary* ptLibrary, plEntity tEntity, const char* pcName)
+{
+    plComponentManager* ptManager = &ptLibrary->tTagComponentManager;
+    plTagSystemData* ptData = ptManager->pSystemData;
+
+    plTagComponent* ptTag = pl_ecs_has_entity(ptManager, tEntity) ? pl_ecs_get_component(ptManager, tEntity) : pl_ecs_create_component(ptManager, tEntity);
+    const uint32_t uNameId = pl__intern_string(ptData, pcName);
+    if(ptTag->uNameId == uNameId)
+        return;
+    pl__unindex_name(ptData, ptTag->uNameId);
+    pl__index_name(ptData, tEntity, uNameId);
+    ptTag->uNameId = uNameId;
+}
+
+static const char*
+pl_ecs_get_name(plComponentLibrary* ptLibrary, plEntity tEntity)
+{
+    plComponentManager* ptManager = &ptLibrary->tTagComponentManager;
+    if(!pl_ecs_has_entity(ptManager, tEntity))
+        return NULL;
+    const plTagComponent* ptTag = pl_ecs_get_component(ptManager, tEntity);
+    return ((plTagSystemData*)ptManager->pSystemData)->sbcStrings[ptTag->uNameId];
+}
+
 static size_t
 pl_ecs_get_index(plComponentManager* ptManager, plEntity tEntity)
 { 
     PL_ASSERT(tEntity != PL_INVALID_ENTITY_HANDLE);
-    size_t szIndex = pl_hm_lookup(&ptManager->tHashMap, (uint64_t)tEntity);
-    PL_ASSERT(szIndex != UINT64_MAX);
-    return szIndex;
+    PL_ASSERT(pl_ecs_has_entity(ptManager, tEntity) && "entity does not have this component (or is stale)");
+    return (size_t)*pl__get_sparse_slot(ptManager, tEntity);
 }
 
 static void*
@@ -219,6 +778,7 @@ pl_ecs_get_component(plComponentManager* ptManager, plEntity tEntity)
 {
     PL_ASSERT(tEntity != PL_INVALID_ENTITY_HANDLE);
     size_t szIndex = pl_ecs_get_index(ptManager, tEntity);
+    PL_ASSERT(ptManager->pComponents && "no component records (soa transform layout), use get_transform_columns");
     unsigned char* pucData = ptManager->pComponents;
     return &pucData[szIndex * ptManager->szStride];
 }
@@ -228,104 +788,462 @@ pl_ecs_create_component(plComponentManager* ptManager, plEntity tEntity)
 {
     PL_ASSERT(tEntity != PL_INVALID_ENTITY_HANDLE);
 
-    switch (ptManager->tComponentType)
-    {
-    case PL_COMPONENT_TYPE_TAG:
+    // soa transforms have no record to hand out
+    if(ptManager->tComponentType == PL_COMPONENT_TYPE_TRANSFORM && ptManager->pSystemData)
     {
-        plTagComponent* sbComponents = ptManager->pComponents;
-        pl_sb_push(sbComponents, (plTagComponent){0});
-        ptManager->pComponents = sbComponents;
-        pl_hm_insert(&ptManager->tHashMap, (uint64_t)tEntity, pl_sb_size(ptManager->sbtEntities));
-        pl_sb_push(ptManager->sbtEntities, tEntity);
-        return &pl_sb_back(sbComponents);
+        pl__create_transform_columns_entry(ptManager);
+        pl__sparse_set_insert(ptManager, tEntity);
+        return NULL;
     }
 
-    case PL_COMPONENT_TYPE_MESH:
+    const uint32_t uIndex = pl_sb_size(ptManager->sbtEntities);
+    if(uIndex == ptManager->uCapacity)
+        pl__grow_components(ptManager);
+    unsigned char* pucComponent = (unsigned char*)ptManager->pComponents + uIndex * ptManager->szStride;
+    if(ptManager->pfConstruct)
+        ptManager->pfConstruct(pucComponent);
+    else
+        memset(pucComponent, 0, ptManager->szStride);
+    pl__sparse_set_insert(ptManager, tEntity);
+    return pucComponent;
+}
+
+static bool
+pl_ecs_has_entity(plComponentManager* ptManager, plEntity tEntity)
+{
+    PL_ASSERT(tEntity != PL_INVALID_ENTITY_HANDLE);
+    const uint32_t* puSlot = pl__get_sparse_slot(ptManager, tEntity);
+
+    // the dense side holds full handles, so stale generations miss here
+    return puSlot && *puSlot != UINT32_MAX && ptManager->sbtEntities[*puSlot] == tEntity;
+}
+
+static void
+pl_ecs_remove_component(plComponentManager* ptManager, plEntity tEntity)
+{
+    PL_ASSERT(pl_ecs_has_entity(ptManager, tEntity) && "entity does not have this component (or is stale)");
+
+    uint32_t* puSlot = pl__get_sparse_slot(ptManager, tEntity);
+    const uint32_t uIndex = *puSlot;
+    const plEntity tLastEntity = pl_sb_back(ptManager->sbtEntities);
+
+    // last component moves into the hole so storage stays dense (order is not kept)
+    *pl__get_sparse_slot(ptManager, tLastEntity) = uIndex;
+    *puSlot = UINT32_MAX;
+    pl_sb_del_swap(ptManager->sbtEntities, uIndex);
+    pl_sb_del_swap(ptManager->sbuChangeVersions, uIndex);
+    ptManager->uLayoutVersion++;
+
+    if(ptManager->tComponentType == PL_COMPONENT_TYPE_TRANSFORM && ptManager->pSystemData)
     {
-        plMeshComponent* sbComponents = ptManager->pComponents;
-        pl_sb_push(sbComponents, (plMeshComponent){0});
-        ptManager->pComponents = sbComponents;
-        pl_hm_insert(&ptManager->tHashMap, (uint64_t)tEntity, pl_sb_size(ptManager->sbtEntities));
-        pl_sb_push(ptManager->sbtEntities, tEntity);
-        return &pl_sb_back(sbComponents);
+        pl__remove_transform_columns_entry(ptManager, uIndex);
+        return;
     }
 
-    case PL_COMPONENT_TYPE_TRANSFORM:
+    unsigned char* pucComponents = ptManager->pComponents;
+    const uint32_t uLast = pl_sb_size(ptManager->sbtEntities); // entity already swapped out
+    if(ptManager->tComponentType == PL_COMPONENT_TYPE_TAG && ptManager->pSystemData)
+        pl__unindex_name(ptManager->pSystemData, ((plTagComponent*)&pucComponents[uIndex * ptManager->szStride])->uNameId);
+    if(ptManager->pfDestruct)
+        ptManager->pfDestruct(&pucComponents[uIndex * ptManager->szStride]);
+    if(uIndex != uLast)
+        memcpy(&pucComponents[uIndex * ptManager->szStride], &pucComponents[uLast * ptManager->szStride], ptManager->szStride);
+}
+
+static inline uint32_t*
+pl__get_sparse_slot(const plComponentManager* ptManager, plEntity tEntity)
+{
+    const uint32_t uEntityIndex = PL_ENTITY_INDEX(tEntity);
+    const uint32_t uPage = uEntityIndex / PL_ECS_SPARSE_PAGE_SIZE;
+    if(uPage >= pl_sb_size(ptManager->sbuSparsePages) || ptManager->sbuSparsePages[uPage] == NULL)
+        return NULL;
+    return &ptManager->sbuSparsePages[uPage][uEntityIndex & (PL_ECS_SPARSE_PAGE_SIZE - 1)];
+}
+
+static void
+pl__sparse_set_insert(plComponentManager* ptManager, plEntity tEntity)
+{
+    // pages are only allocated for ranges of indices that actually own a component
+    const uint32_t uEntityIndex = PL_ENTITY_INDEX(tEntity);
+    const uint32_t uPage = uEntityIndex / PL_ECS_SPARSE_PAGE_SIZE;
+    while(pl_sb_size(ptManager->sbuSparsePages) <= uPage)
+        pl_sb_push(ptManager->sbuSparsePages, NULL);
+    if(ptManager->sbuSparsePages[uPage] == NULL)
     {
-        plTransformComponent* sbComponents = ptManager->pComponents;
-        pl_sb_push(sbComponents, ((plTransformComponent){.tWorld = pl_identity_mat4(), .tFinalTransform = pl_identity_mat4()}));
-        ptManager->pComponents = sbComponents;
-        pl_hm_insert(&ptManager->tHashMap, (uint64_t)tEntity, pl_sb_size(ptManager->sbtEntities));
-        pl_sb_push(ptManager->sbtEntities, tEntity);
-        return &pl_sb_back(sbComponents);
+        ptManager->sbuSparsePages[uPage] = PL_ALLOC(sizeof(uint32_t) * PL_ECS_SPARSE_PAGE_SIZE);
+        memset(ptManager->sbuSparsePages[uPage], 0xff, sizeof(uint32_t) * PL_ECS_SPARSE_PAGE_SIZE);
     }
 
-    case PL_COMPONENT_TYPE_MATERIAL:
+    uint32_t* puSlot = &ptManager->sbuSparsePages[uPage][uEntityIndex & (PL_ECS_SPARSE_PAGE_SIZE - 1)];
+    PL_ASSERT(*puSlot == UINT32_MAX && "entity already has this component");
+    *puSlot = pl_sb_size(ptManager->sbtEntities);
+    pl_sb_push(ptManager->sbtEntities, tEntity);
+    pl_sb_push(ptManager->sbuChangeVersions, ptManager->uChangeVersion);
+    ptManager->uLastChange = ptManager->uChangeVersion;
+    ptManager->uLayoutVersion++;
+}
+
+static uint32_t
+pl__intern_string(plTagSystemData* ptData, const char* pcString)
+{
+    if(pcString == NULL || pcString[0] == 0)
+        return 0;
+
+    uint64_t ulKey = 0;
+    const uint32_t uExistingId = pl__find_string(ptData, pcString, &ulKey);
+    if(uExistingId != UINT32_MAX)
+        return uExistingId;
+
+    // copy into the current block, long strings get a block of their own
+    const size_t szLength = strlen(pcString) + 1;
+    char* pcCopy = NULL;
+    if(szLength > PL_ECS_STRING_BLOCK_SIZE / 4)
     {
-        plMaterialComponent* sbComponents = ptManager->pComponents;
-        pl_sb_push(sbComponents, (plMaterialComponent){0});
-        ptManager->pComponents = sbComponents;
-        pl_hm_insert(&ptManager->tHashMap, (uint64_t)tEntity, pl_sb_size(ptManager->sbtEntities));
-        pl_sb_push(ptManager->sbtEntities, tEntity);
-        return &pl_sb_back(sbComponents);
+        pcCopy = PL_ALLOC(szLength);
+        pl_sb_push(ptData->sbcBlocks, pcCopy);
     }
-
-    case PL_COMPONENT_TYPE_OBJECT:
+    else
     {
-        plObjectComponent* sbComponents = ptManager->pComponents;
-        pl_sb_push(sbComponents, (plObjectComponent){0});
-        ptManager->pComponents = sbComponents;
-        pl_hm_insert(&ptManager->tHashMap, (uint64_t)tEntity, pl_sb_size(ptManager->sbtEntities));
-        pl_sb_push(ptManager->sbtEntities, tEntity);
-        return &pl_sb_back(sbComponents);
+        if(ptData->pcCurrentBlock == NULL || ptData->szCurrentBlockUsed + szLength > PL_ECS_STRING_BLOCK_SIZE)
+        {
+            ptData->pcCurrentBlock = PL_ALLOC(PL_ECS_STRING_BLOCK_SIZE);
+            ptData->szCurrentBlockUsed = 0;
+            pl_sb_push(ptData->sbcBlocks, ptData->pcCurrentBlock);
+        }
+        pcCopy = &ptData->pcCurrentBlock[ptData->szCurrentBlockUsed];
+        ptData->szCurrentBlockUsed += szLength;
     }
+    memcpy(pcCopy, pcString, szLength);
+
+    const uint32_t uStringId = pl_sb_size(ptData->sbcStrings);
+    pl_sb_push(ptData->sbcStrings, pcCopy);
+    pl_sb_push(ptData->sbtNamedEntities, PL_INVALID_ENTITY_HANDLE);
+    pl_sb_push(ptData->sbuNameCounts, 0);
+    pl_hm_insert(&ptData->tStringIds, ulKey, uStringId);
+    return uStringId;
+}
 
-    case PL_COMPONENT_TYPE_CAMERA:
+static uint32_t
+pl__find_string(plTagSystemData* ptData, const char* pcString, uint64_t* pulKeyOut)
+{
+    // keys taken by other strings are rehashed until the string or a free key
+    // turns up, interning inserts at that free key
+    uint64_t ulKey = pl_hm_hash_str(pcString);
+    while(pl_hm_has_key(&ptData->tStringIds, ulKey))
     {
-        plCameraComponent* sbComponents = ptManager->pComponents;
-        pl_sb_push(sbComponents, (plCameraComponent){0});
-        ptManager->pComponents = sbComponents;
-        pl_hm_insert(&ptManager->tHashMap, (uint64_t)tEntity, pl_sb_size(ptManager->sbtEntities));
-        pl_sb_push(ptManager->sbtEntities, tEntity);
-        return &pl_sb_back(sbComponents);
+        const uint32_t uStringId = (uint32_t)pl_hm_lookup(&ptData->tStringIds, ulKey);
+        if(strcmp(ptData->sbcStrings[uStringId], pcString) == 0)
+            return uStringId;
+        ulKey = pl_hm_hash(&ulKey, sizeof(uint64_t), ulKey);
     }
+    if(pulKeyOut)
+        *pulKeyOut = ulKey;
+    return UINT32_MAX;
+}
+
+static void
+pl__index_name(plTagSystemData* ptData, plEntity tEntity, uint32_t uNameId)
+{
+    if(uNameId == 0)
+        return;
+    if(ptData->sbuNameCounts[uNameId]++ == 0)
+        ptData->sbtNamedEntities[uNameId] = tEntity;
+}
+
+static void
+pl__unindex_name(plTagSystemData* ptData, uint32_t uNameId)
+{
+    if(uNameId == 0)
+        return;
+    PL_ASSERT(ptData->sbuNameCounts[uNameId] > 0);
+
+    // a stale entry is left for get_entity to replace while others share the name
+    if(--ptData->sbuNameCounts[uNameId] == 0)
+        ptData->sbtNamedEntities[uNameId] = PL_INVALID_ENTITY_HANDLE;
+}
+
+static void
+pl__free_tag_system(plComponentManager* ptManager)
+{
+    plTagSystemData* ptData = ptManager->pSystemData;
+    if(ptData == NULL)
+        return;
+    for(uint32_t i = 0; i < pl_sb_size(ptData->sbcBlocks); i++)
+        PL_FREE(ptData->sbcBlocks[i]);
+    pl_sb_free(ptData->sbcBlocks);
+    pl_sb_free(ptData->sbcStrings);
+    pl_sb_free(ptData->sbtNamedEntities);
+    pl_sb_free(ptData->sbuNameCounts);
+    pl_hm_free(&ptData->tStringIds);
+    PL_FREE(ptData);
+    ptManager->pSystemData = NULL;
+}
 
-    case PL_COMPONENT_TYPE_HIERARCHY:
+static void
+pl__sparse_set_free(plComponentManager* ptManager)
+{
+    for(uint32_t i = 0; i < pl_sb_size(ptManager->sbuSparsePages); i++)
     {
-        plHierarchyComponent* sbComponents = ptManager->pComponents;
-        pl_sb_push(sbComponents, (plHierarchyComponent){0});
-        ptManager->pComponents = sbComponents;
-        pl_hm_insert(&ptManager->tHashMap, (uint64_t)tEntity, pl_sb_size(ptManager->sbtEntities));
-        pl_sb_push(ptManager->sbtEntities, tEntity);
-        return &pl_sb_back(sbComponents);
+        if(ptManager->sbuSparsePages[i])
+            PL_FREE(ptManager->sbuSparsePages[i]);
     }
+    pl_sb_free(ptManager->sbuSparsePages);
+}
+
+static inline uint32_t
+pl__resolve_index(const plComponentManager* ptManager, plEntity tEntity, uint32_t* puCachedIndex)
+{
+    // the cached slot still holds the entity unless the reference or the layout changed
+    if(*puCachedIndex < pl_sb_size(ptManager->sbtEntities) && ptManager->sbtEntities[*puCachedIndex] == tEntity)
+        return *puCachedIndex;
+    *puCachedIndex = pl_ecs_has_entity((plComponentManager*)ptManager, tEntity) ? *pl__get_sparse_slot(ptManager, tEntity) : UINT32_MAX;
+    return *puCachedIndex;
+}
+
+static void
+pl_ecs_mark_changed(plComponentManager* ptManager, plEntity tEntity)
+{
+    PL_ASSERT(pl_ecs_has_entity(ptManager, tEntity) && "entity does not have this component (or is stale)");
+    pl__stamp_change(ptManager, *pl__get_sparse_slot(ptManager, tEntity));
+}
+
+static inline void
+pl__stamp_change(plComponentManager* ptManager, uint32_t uIndex)
+{
+    ptManager->sbuChangeVersions[uIndex] = ptManager->uChangeVersion;
+    ptManager->uLastChange = ptManager->uChangeVersion;
+}
 
-    case PL_COMPONENT_TYPE_LIGHT:
+static uint32_t
+pl__sync_changes(plComponentManager* ptManager)
+{
+    // returns the newest version the caller has now seen, the open version
+    // only closes if something was stamped with it (once per sync at most,
+    // so the counter doesn't grow with the number of changes)
+    if(ptManager->uLastChange == ptManager->uChangeVersion)
+        ptManager->uChangeVersion++;
+    return ptManager->uChangeVersion - 1;
+}
+
+static void
+pl__stamp_dirty_transforms(plComponentManager* ptManager)
+{
+    // transforms outside any hierarchy keep their flag until here, soa skips clean words
+    const uint32_t uCount = pl_sb_size(ptManager->sbtEntities);
+    plTransformColumns* ptColumns = ptManager->pSystemData;
+    if(ptColumns)
     {
-        plLightComponent* sbComponents = ptManager->pComponents;
-        pl_sb_push(sbComponents, ((plLightComponent){.tColor = {1.0f, 1.0f, 1.0f}}));
-        ptManager->pComponents = sbComponents;
-        pl_hm_insert(&ptManager->tHashMap, (uint64_t)tEntity, pl_sb_size(ptManager->sbtEntities));
-        pl_sb_push(ptManager->sbtEntities, tEntity);
-        return &pl_sb_back(sbComponents);
+        for(uint32_t uWord = 0; uWord < (uCount + 63) / 64; uWord++)
+        {
+            uint64_t uBits = ptColumns->auDirtyBits[uWord];
+            ptColumns->auDirtyBits[uWord] = 0;
+            for(uint32_t uBit = 0; uBits; uBit++, uBits >>= 1)
+            {
+                if(uBits & 1)
+                    pl__stamp_change(ptManager, uWord * 64 + uBit);
+            }
+        }
+        return;
     }
 
+    plTransformComponent* sbtTransforms = ptManager->pComponents;
+    for(uint32_t i = 0; i < uCount; i++)
+    {
+        if(sbtTransforms[i].bDirty)
+        {
+            sbtTransforms[i].bDirty = false;
+            pl__stamp_change(ptManager, i);
+        }
     }
+}
 
-    return NULL;
+static void
+pl__init_component_manager(plComponentManager* ptManager, plComponentType tType, const plComponentDesc* ptDesc)
+{
+    PL_ASSERT(ptDesc->szSize > 0 && "components need a size");
+
+    // by default the size is the stride (sizeof is a multiple of the alignment),
+    // the storage itself always starts at least PL_ECS_COMPONENT_ALIGNMENT aligned
+    size_t szAlignment = ptDesc->szAlignment;
+    if(szAlignment == 0)
+        szAlignment = ptDesc->szSize & (~ptDesc->szSize + 1);
+    PL_ASSERT((szAlignment & (szAlignment - 1)) == 0 && "component alignment must be a power of 2");
+
+    memset(ptManager, 0, sizeof(plComponentManager));
+    ptManager->uChangeVersion = 1; // systems start out having seen version 0
+    ptManager->tComponentType = tType;
+    ptManager->pcName         = ptDesc->pcName;
+    ptManager->szStride       = (ptDesc->szSize + szAlignment - 1) & ~(szAlignment - 1);
+    ptManager->szAlignment    = szAlignment > PL_ECS_COMPONENT_ALIGNMENT ? szAlignment : PL_ECS_COMPONENT_ALIGNMENT;
+    ptManager->pfConstruct    = ptDesc->pfConstruct;
+    ptManager->pfDestruct     = ptDesc->pfDestruct;
 }
 
-static bool
-pl_ecs_has_entity(plComponentManager* ptManager, plEntity tEntity)
+static void
+pl__grow_components(plComponentManager* ptManager)
 {
-    PL_ASSERT(tEntity != PL_INVALID_ENTITY_HANDLE);
+    // components are relocated with memcpy, over allocated so the start can be aligned
+    const uint32_t uCount = pl_sb_size(ptManager->sbtEntities);
+    const uint32_t uNewCapacity = ptManager->uCapacity > 0 ? ptManager->uCapacity * 2 : 16;
+    unsigned char* pucNewAllocation = PL_ALLOC(uNewCapacity * ptManager->szStride + ptManager->szAlignment - 1);
+    void* pNewComponents = (void*)(((uintptr_t)pucNewAllocation + ptManager->szAlignment - 1) & ~(uintptr_t)(ptManager->szAlignment - 1));
+    if(uCount > 0)
+        memcpy(pNewComponents, ptManager->pComponents, uCount * ptManager->szStride);
+    if(ptManager->pAllocation)
+        PL_FREE(ptManager->pAllocation);
+    ptManager->pAllocation = pucNewAllocation;
+    ptManager->pComponents = pNewComponents;
+    ptManager->uCapacity   = uNewCapacity;
+}
 
-    for(uint32_t i = 0; i < pl_sb_size(ptManager->sbtEntities); i++)
+static void
+pl__free_component_manager(plComponentManager* ptManager)
+{
+    if(ptManager->pfDestruct)
     {
-        if(ptManager->sbtEntities[i] == tEntity)
-            return true;
+        unsigned char* pucComponents = ptManager->pComponents;
+        for(uint32_t i = 0; i < pl_sb_size(ptManager->sbtEntities) && pucComponents; i++)
+            ptManager->pfDestruct(&pucComponents[i * ptManager->szStride]);
     }
-    return false;
+    if(ptManager->pAllocation)
+        PL_FREE(ptManager->pAllocation);
+    ptManager->pAllocation = NULL;
+    ptManager->pComponents = NULL;
+    ptManager->uCapacity = 0;
+    pl_sb_free(ptManager->sbtEntities);
+    pl_sb_free(ptManager->sbuChangeVersions);
+    pl__sparse_set_free(ptManager);
+}
+
+static void
+pl__construct_transform(void* pComponent)
+{
+    *(plTransformComponent*)pComponent = (plTransformComponent){
+        .tScale          = {1.0f, 1.0f, 1.0f},
+        .tRotation       = {0.0f, 0.0f, 0.0f, 1.0f},
+        .tWorld          = pl_identity_mat4(),
+        .tFinalTransform = pl_identity_mat4(),
+        .bDirty          = true
+    };
+}
+
+static void
+pl__construct_light(void* pComponent)
+{
+    *(plLightComponent*)pComponent = (plLightComponent){
+        .tColor = {1.0f, 1.0f, 1.0f}
+    };
+}
+
+static void
+pl__destruct_mesh(void* pComponent)
+{
+    pl__free_mesh_data(pComponent);
+}
+
+static inline plMat4*
+pl__get_transform_local(plComponentManager* ptManager, uint32_t uIndex)
+{
+    plTransformColumns* ptColumns = ptManager->pSystemData;
+    if(ptColumns)
+        return &ptColumns->atLocals[uIndex];
+    return &((plTransformComponent*)ptManager->pComponents)[uIndex].tWorld;
+}
+
+static inline plMat4*
+pl__get_transform_world(plComponentManager* ptManager, uint32_t uIndex)
+{
+    plTransformColumns* ptColumns = ptManager->pSystemData;
+    if(ptColumns)
+        return &ptColumns->atWorlds[uIndex];
+    return &((plTransformComponent*)ptManager->pComponents)[uIndex].tFinalTransform;
+}
+
+static inline bool
+pl__is_transform_dirty(const plComponentManager* ptManager, uint32_t uIndex)
+{
+    const plTransformColumns* ptColumns = ptManager->pSystemData;
+    if(ptColumns)
+        return PL_TRANSFORM_IS_DIRTY(ptColumns, uIndex);
+    return ((const plTransformComponent*)ptManager->pComponents)[uIndex].bDirty;
+}
+
+static inline void
+pl__set_transform_dirty(plComponentManager* ptManager, uint32_t uIndex, bool bDirty)
+{
+    plTransformColumns* ptColumns = ptManager->pSystemData;
+    if(ptColumns == NULL)
+        ((plTransformComponent*)ptManager->pComponents)[uIndex].bDirty = bDirty;
+    else if(bDirty)
+        PL_TRANSFORM_SET_DIRTY(ptColumns, uIndex);
+    else
+        ptColumns->auDirtyBits[uIndex >> 6] &= ~((uint64_t)1 << (uIndex & 63));
+}
+
+static void
+pl__create_transform_columns_entry(plComponentManager* ptManager)
+{
+    plTransformColumns* ptColumns = ptManager->pSystemData;
+    const uint32_t uIndex = ptColumns->uCount++;
+    pl_sb_push(ptColumns->atScales, ((plVec3){1.0f, 1.0f, 1.0f}));
+    pl_sb_push(ptColumns->atRotations, ((plVec4){0.0f, 0.0f, 0.0f, 1.0f}));
+    pl_sb_push(ptColumns->atTranslations, ((plVec3){0}));
+    pl_sb_push(ptColumns->atLocals, pl_identity_mat4());
+    pl_sb_push(ptColumns->atWorlds, pl_identity_mat4());
+    if(uIndex % 64 == 0)
+        pl_sb_push(ptColumns->auDirtyBits, 0);
+    PL_TRANSFORM_SET_DIRTY(ptColumns, uIndex);
+}
+
+static void
+pl__remove_transform_columns_entry(plComponentManager* ptManager, uint32_t uIndex)
+{
+    // last transform's dirty bit follows it into the hole
+    plTransformColumns* ptColumns = ptManager->pSystemData;
+    const uint32_t uLast = --ptColumns->uCount;
+    pl__set_transform_dirty(ptManager, uIndex, PL_TRANSFORM_IS_DIRTY(ptColumns, uLast));
+    pl__set_transform_dirty(ptManager, uLast, false);
+    pl_sb_del_swap(ptColumns->atScales, uIndex);
+    pl_sb_del_swap(ptColumns->atRotations, uIndex);
+    pl_sb_del_swap(ptColumns->atTranslations, uIndex);
+    pl_sb_del_swap(ptColumns->atLocals, uIndex);
+    pl_sb_del_swap(ptColumns->atWorlds, uIndex);
+    pl_sb_resize(ptColumns->auDirtyBits, (ptColumns->uCount + 63) / 64);
+}
+
+static void
+pl__free_transform_columns(plComponentManager* ptManager)
+{
+    plTransformColumns* ptColumns = ptManager->pSystemData;
+    if(ptColumns == NULL)
+        return;
+    pl_sb_free(ptColumns->atScales);
+    pl_sb_free(ptColumns->atRotations);
+    pl_sb_free(ptColumns->atTranslations);
+    pl_sb_free(ptColumns->atLocals);
+    pl_sb_free(ptColumns->atWorlds);
+    pl_sb_free(ptColumns->auDirtyBits);
+    PL_FREE(ptColumns);
+    ptManager->pSystemData = NULL;
+}
+
+static void
+pl__free_mesh_data(plMeshComponent* ptMesh)
+{
+    pl_sb_free(ptMesh->sbtVertexPositions);
+    pl_sb_free(ptMesh->sbtVertexNormals);
+    pl_sb_free(ptMesh->sbtVertexTangents);
+    pl_sb_free(ptMesh->sbtVertexColors0);
+    pl_sb_free(ptMesh->sbtVertexColors1);
+    pl_sb_free(ptMesh->sbtVertexWeights0);
+    pl_sb_free(ptMesh->sbtVertexWeights1);
+    pl_sb_free(ptMesh->sbtVertexJoints0);
+    pl_sb_free(ptMesh->sbtVertexJoints1);
+    pl_sb_free(ptMesh->sbtVertexTextureCoordinates0);
+    pl_sb_free(ptMesh->sbtVertexTextureCoordinates1);
+    pl_sb_free(ptMesh->sbuIndices);
+    pl_sb_free(ptMesh->sbucVertexAttributes);
+    pl_sb_free(ptMesh->sbuLodIndices);
 }
 
 static plVec4
@@ -351,19 +1269,18 @@ pl_ecs_create_mesh(plComponentLibrary* ptLibrary, const char* pcName)
 {
     plEntity tNewEntity = pl_ecs_create_entity(ptLibrary);
 
-    plTagComponent* ptTag = pl_ecs_create_component(&ptLibrary->tTagComponentManager, tNewEntity);
     if(pcName)
     {
         pl_log_debug_to_f(uLogChannel, "created mesh '%s'", pcName);
-        strncpy(ptTag->acName, pcName, PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, pcName);
     }
     else
     {
         pl_log_debug_to(uLogChannel, "created unnamed mesh");
-        strncpy(ptTag->acName, "unnamed", PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, "unnamed");
     }
 
-    plMeshComponent* ptMesh = pl_ecs_create_component(&ptLibrary->tMeshComponentManager, tNewEntity);
+    pl_ecs_create_component(&ptLibrary->tMeshComponentManager, tNewEntity);
     return tNewEntity;
 }
 
@@ -373,16 +1290,15 @@ pl_ecs_create_outline_material(plComponentLibrary* ptLibrary, const char* pcName
 
     plEntity tNewEntity = pl_ecs_create_entity(ptLibrary);
 
-    plTagComponent* ptTag = pl_ecs_create_component(&ptLibrary->tTagComponentManager, tNewEntity);
     if(pcName)
     {
         pl_log_debug_to_f(uLogChannel, "created outline material '%s'", pcName);
-        strncpy(ptTag->acName, pcName, PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, pcName);
     }
     else
     {
         pl_log_debug_to(uLogChannel, "created unnamed outline material");
-        strncpy(ptTag->acName, "unnamed", PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, "unnamed");
     }
 
     plMaterialComponent* ptMaterial = pl_ecs_create_component(&ptLibrary->tMaterialComponentManager, tNewEntity);
@@ -412,16 +1328,15 @@ pl_ecs_create_material(plComponentLibrary* ptLibrary, const char* pcName)
 {
     plEntity tNewEntity = pl_ecs_create_entity(ptLibrary);
 
-    plTagComponent* ptTag = pl_ecs_create_component(&ptLibrary->tTagComponentManager, tNewEntity);
     if(pcName)
     {
         pl_log_debug_to_f(uLogChannel, "created material '%s'", pcName);
-        strncpy(ptTag->acName, pcName, PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, pcName);
     }
     else
     {
         pl_log_debug_to(uLogChannel, "created unnamed material");
-        strncpy(ptTag->acName, "unnamed", PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, "unnamed");
     }
 
     plMaterialComponent* ptMaterial = pl_ecs_create_component(&ptLibrary->tMaterialComponentManager, tNewEntity);
@@ -493,214 +1408,799 @@ pl_ecs_cleanup_systems(const plApiRegistryApiI* ptApiRegistry, plComponentLibrar
 {
 
     plObjectSystemData* ptObjectSystemData = ptLibrary->tObjectComponentManager.pSystemData;
-
-    for(uint32_t i = 0; i < pl_sb_size(ptObjectSystemData->sbtMeshes); i++)
-    {
-        pl_sb_free(ptObjectSystemData->sbtMeshes[i]->sbtVertexPositions);
-        pl_sb_free(ptObjectSystemData->sbtMeshes[i]->sbtVertexNormals);
-        pl_sb_free(ptObjectSystemData->sbtMeshes[i]->sbtVertexTangents);
-        pl_sb_free(ptObjectSystemData->sbtMeshes[i]->sbtVertexColors0);
-        pl_sb_free(ptObjectSystemData->sbtMeshes[i]->sbtVertexColors1);
-        pl_sb_free(ptObjectSystemData->sbtMeshes[i]->sbtVertexWeights0);
-        pl_sb_free(ptObjectSystemData->sbtMeshes[i]->sbtVertexWeights1);
-        pl_sb_free(ptObjectSystemData->sbtMeshes[i]->sbtVertexJoints0);
-        pl_sb_free(ptObjectSystemData->sbtMeshes[i]->sbtVertexJoints1);
-        pl_sb_free(ptObjectSystemData->sbtMeshes[i]->sbtVertexTextureCoordinates0);
-        pl_sb_free(ptObjectSystemData->sbtMeshes[i]->sbtVertexTextureCoordinates1);
-        pl_sb_free(ptObjectSystemData->sbtMeshes[i]->sbuIndices);
-    }
+    if(ptObjectSystemData->uInstanceCapacity > 0 && gptDevice && gptDevice->destroy_buffer)
+        gptDevice->destroy_buffer(ptObjectSystemData->ptDevice, ptObjectSystemData->uInstanceBuffer);
     pl_sb_free(ptObjectSystemData->sbtMeshes);
+    pl_sb_free(ptObjectSystemData->sbuMeshIndices);
+    pl_sb_free(ptObjectSystemData->sbuTransformIndices);
+    pl_sb_free(ptObjectSystemData->sbtInstanceEntities);
+    pl_sb_free(ptObjectSystemData->sbtInstances);
+    pl_sb_free(ptObjectSystemData->sbuDirtyInstances);
+    pl_sb_free(ptObjectSystemData->sbtUploadRanges);
     PL_FREE(ptObjectSystemData);
     ptLibrary->tObjectComponentManager.pSystemData = NULL;
 
-    plMeshComponent* ptMeshComponents = ptLibrary->tMeshComponentManager.pComponents;
-
-    // components
-    pl_sb_free(ptLibrary->tTagComponentManager.pComponents);
-    pl_sb_free(ptLibrary->tTransformComponentManager.pComponents);
-    pl_sb_free(ptLibrary->tMeshComponentManager.pComponents);
-    pl_sb_free(ptLibrary->tMaterialComponentManager.pComponents);
-    pl_sb_free(ptLibrary->tObjectComponentManager.pComponents);
-    pl_sb_free(ptLibrary->tCameraComponentManager.pComponents);
-    pl_sb_free(ptLibrary->tHierarchyComponentManager.pComponents);
-    pl_sb_free(ptLibrary->tLightComponentManager.pComponents);
-
-    // entities
-    pl_sb_free(ptLibrary->tTagComponentManager.sbtEntities);
-    pl_sb_free(ptLibrary->tTransformComponentManager.sbtEntities);
-    pl_sb_free(ptLibrary->tMeshComponentManager.sbtEntities);
-    pl_sb_free(ptLibrary->tMaterialComponentManager.sbtEntities);
-    pl_sb_free(ptLibrary->tObjectComponentManager.sbtEntities);
-    pl_sb_free(ptLibrary->tCameraComponentManager.sbtEntities);
-    pl_sb_free(ptLibrary->tHierarchyComponentManager.sbtEntities);
-    pl_sb_free(ptLibrary->tLightComponentManager.sbtEntities);
-
-    // hashmaps
-    pl_hm_free(&ptLibrary->tTagComponentManager.tHashMap);
-    pl_hm_free(&ptLibrary->tTransformComponentManager.tHashMap);
-    pl_hm_free(&ptLibrary->tMeshComponentManager.tHashMap);
-    pl_hm_free(&ptLibrary->tMaterialComponentManager.tHashMap);
-    pl_hm_free(&ptLibrary->tObjectComponentManager.tHashMap);
-    pl_hm_free(&ptLibrary->tCameraComponentManager.tHashMap);
-    pl_hm_free(&ptLibrary->tHierarchyComponentManager.tHashMap);
-    pl_hm_free(&ptLibrary->tLightComponentManager.tHashMap);
+    plHierarchySystemData* ptHierarchySystemData = ptLibrary->tHierarchyComponentManager.pSystemData;
+    pl_sb_free(ptHierarchySystemData->sbtNodes);
+    pl_sb_free(ptHierarchySystemData->sbuDepths);
+    pl_sb_free(ptHierarchySystemData->sbuSlots);
+    pl_sb_free(ptHierarchySystemData->sbuChain);
+    pl_sb_free(ptHierarchySystemData->sbuDepthOffsets);
+    PL_FREE(ptHierarchySystemData);
+    ptLibrary->tHierarchyComponentManager.pSystemData = NULL;
+
+    pl__free_transform_columns(&ptLibrary->tTransformComponentManager);
+    pl__free_tag_system(&ptLibrary->tTagComponentManager);
+
+    // destructors run here, so meshes free the data they own (objects may share a mesh)
+    pl__free_component_manager(&ptLibrary->tTagComponentManager);
+    pl__free_component_manager(&ptLibrary->tTransformComponentManager);
+    pl__free_component_manager(&ptLibrary->tMeshComponentManager);
+    pl__free_component_manager(&ptLibrary->tMaterialComponentManager);
+    pl__free_component_manager(&ptLibrary->tObjectComponentManager);
+    pl__free_component_manager(&ptLibrary->tCameraComponentManager);
+    pl__free_component_manager(&ptLibrary->tHierarchyComponentManager);
+    pl__free_component_manager(&ptLibrary->tLightComponentManager);
+    for(uint32_t i = 0; i < pl_sb_size(ptLibrary->sbtCustomManagers); i++)
+    {
+        pl__free_component_manager(ptLibrary->sbtCustomManagers[i]);
+        PL_FREE(ptLibrary->sbtCustomManagers[i]);
+    }
+    pl_sb_free(ptLibrary->sbtCustomManagers);
+
+    // entity handles
+    pl_sb_free(ptLibrary->sbuEntityGenerations);
+    pl_sb_free(ptLibrary->sbuFreeEntities);
 }
 
 static void
 pl_run_object_update_system(plComponentLibrary* ptLibrary)
 {
     pl_begin_profile_sample(__FUNCTION__);
-    plObjectComponent* sbtComponents = ptLibrary->tObjectComponentManager.pComponents;
-    plObjectSystemData* ptObjectSystemData = ptLibrary->tObjectComponentManager.pSystemData;
-    pl_sb_reset(ptObjectSystemData->sbtMeshes);
-
-    for(uint32_t i = 0; i < pl_sb_size(sbtComponents); i++)
+    plComponentManager* ptObjectManager    = &ptLibrary->tObjectComponentManager;
+    plComponentManager* ptMeshManager      = &ptLibrary->tMeshComponentManager;
+    plComponentManager* ptTransformManager = &ptLibrary->tTransformComponentManager;
+    plObjectSystemData* ptData = ptObjectManager->pSystemData;
+
+    pl__stamp_dirty_transforms(ptTransformManager);
+
+    // nothing added, removed or stamped since the last update -> every
+    // instance is current (static scenes stop here)
+    const bool bLayoutChanged =
+        ptData->uObjectLayoutVersion    != ptObjectManager->uLayoutVersion ||
+        ptData->uMeshLayoutVersion      != ptMeshManager->uLayoutVersion ||
+        ptData->uTransformLayoutVersion != ptTransformManager->uLayoutVersion;
+    const uint32_t uObjectSeen    = ptData->uObjectChangeVersion;
+    const uint32_t uMeshSeen      = ptData->uMeshChangeVersion;
+    const uint32_t uTransformSeen = ptData->uTransformChangeVersion;
+    if(!bLayoutChanged && ptObjectManager->uLastChange <= uObjectSeen && ptMeshManager->uLastChange <= uMeshSeen && ptTransformManager->uLastChange <= uTransformSeen)
     {
-        plMeshComponent* ptMeshComponent = pl_ecs_get_component(&ptLibrary->tMeshComponentManager, sbtComponents[i].tMesh);
-        plTransformComponent* ptTransform = pl_ecs_get_component(&ptLibrary->tTransformComponentManager, sbtComponents[i].tTransform);
-        ptMeshComponent->tInfo.tModel = ptTransform->tFinalTransform;
-        pl_sb_push(ptObjectSystemData->sbtMeshes, ptMeshComponent);
+        pl_end_profile_sample();
+        return;
     }
-    pl_end_profile_sample();
-}
 
-static void
-pl_calculate_normals(plMeshComponent* atMeshes, uint32_t uComponentCount)
-{
-    pl_begin_profile_sample(__FUNCTION__);
-
-    for(uint32_t uMeshIndex = 0; uMeshIndex < uComponentCount; uMeshIndex++)
+    const uint32_t uObjectCount = pl_sb_size(ptObjectManager->sbtEntities);
+    const uint32_t uCachedCount = pl_sb_size(ptData->sbuMeshIndices);
+    const uint32_t uCachedWords = pl_sb_size(ptData->sbuDirtyInstances);
+    pl_sb_resize(ptData->sbuMeshIndices, uObjectCount);
+    pl_sb_resize(ptData->sbuTransformIndices, uObjectCount);
+    pl_sb_resize(ptData->sbtInstanceEntities, uObjectCount);
+    pl_sb_resize(ptData->sbtInstances, uObjectCount);
+    pl_sb_resize(ptData->sbuDirtyInstances, (uObjectCount + 63) / 64);
+    for(uint32_t i = uCachedCount; i < uObjectCount; i++)
     {
-        plMeshComponent* ptMesh = &atMeshes[uMeshIndex];
+        ptData->sbuMeshIndices[i] = UINT32_MAX;
+        ptData->sbuTransformIndices[i] = UINT32_MAX;
+        ptData->sbtInstanceEntities[i] = PL_INVALID_ENTITY_HANDLE;
+    }
+    for(uint32_t i = uCachedWords; i < pl_sb_size(ptData->sbuDirtyInstances); i++)
+        ptData->sbuDirtyInstances[i] = 0;
+
+    // joins go through the indices resolved last update, sparse lookups only
+    // happen for objects that are new, moved or were repointed
+    const plObjectComponent* sbtObjects = ptObjectManager->pComponents;
+    plMeshComponent* sbtMeshComponents = ptMeshManager->pComponents;
+    bool bRebuildMeshes = bLayoutChanged;
+    for(uint32_t i = 0; i < uObjectCount; i++)
+    {
+        const uint32_t uOldMesh      = ptData->sbuMeshIndices[i];
+        const uint32_t uOldTransform = ptData->sbuTransformIndices[i];
+        const uint32_t uMesh      = pl__resolve_index(ptMeshManager, sbtObjects[i].tMesh, &ptData->sbuMeshIndices[i]);
+        const uint32_t uTransform = pl__resolve_index(ptTransformManager, sbtObjects[i].tTransform, &ptData->sbuTransformIndices[i]);
+
+        // slot holds another object or the object joins different components
+        const bool bMoved = uMesh != uOldMesh || uTransform != uOldTransform || ptData->sbtInstanceEntities[i] != ptObjectManager->sbtEntities[i];
+        if(bMoved)
+        {
+            ptData->sbtInstanceEntities[i] = ptObjectManager->sbtEntities[i];
+            bRebuildMeshes = true;
+        }
 
-        if(pl_sb_size(ptMesh->sbtVertexNormals) == 0)
+        // mesh or transform destroyed out from under the object, a zeroed
+        // instance keeps the stale one from being drawn
+        if(uMesh == UINT32_MAX || uTransform == UINT32_MAX)
         {
-            pl_sb_resize(ptMesh->sbtVertexNormals, pl_sb_size(ptMesh->sbtVertexPositions));
-            for(uint32_t i = 0; i < pl_sb_size(ptMesh->sbuIndices) - 2; i += 3)
+            if(bMoved)
             {
-                const uint32_t uIndex0 = ptMesh->sbuIndices[i + 0];
-                const uint32_t uIndex1 = ptMesh->sbuIndices[i + 1];
-                const uint32_t uIndex2 = ptMesh->sbuIndices[i + 2];
+                memset(&ptData->sbtInstances[i], 0, sizeof(plObjectInfo));
+                ptData->sbuDirtyInstances[i >> 6] |= (uint64_t)1 << (i & 63);
+                ptData->bDirty = true;
+            }
+            continue;
+        }
 
-                const plVec3 tP0 = ptMesh->sbtVertexPositions[uIndex0];
-                const plVec3 tP1 = ptMesh->sbtVertexPositions[uIndex1];
-                const plVec3 tP2 = ptMesh->sbtVertexPositions[uIndex2];
+        if(!bMoved &&
+            ptObjectManager->sbuChangeVersions[i] <= uObjectSeen &&
+            ptMeshManager->sbuChangeVersions[uMesh] <= uMeshSeen &&
+            ptTransformManager->sbuChangeVersions[uTransform] <= uTransformSeen)
+            continue;
 
-                const plVec3 tEdge1 = pl_sub_vec3(tP1, tP0);
-                const plVec3 tEdge2 = pl_sub_vec3(tP2, tP0);
+        plMeshComponent* ptMeshComponent = &sbtMeshComponents[uMesh];
+        ptMeshComponent->tInfo.tModel = *pl__get_transform_world(ptTransformManager, uTransform);
 
-                const plVec3 tNorm = pl_cross_vec3(tEdge1, tEdge2);
+        // world bounds for culling, radius grows with the largest axis scale
+        const plMat4* ptModel = &ptMeshComponent->tInfo.tModel;
+        const plVec4 tCenter = pl_mul_mat4_vec4(ptModel, (plVec4){ptMeshComponent->tBoundingSphere.x, ptMeshComponent->tBoundingSphere.y, ptMeshComponent->tBoundingSphere.z, 1.0f});
+        const float fScaleSqr = pl_maxf(pl_dot_vec3(ptModel->col[0].xyz, ptModel->col[0].xyz), pl_maxf(pl_dot_vec3(ptModel->col[1].xyz, ptModel->col[1].xyz), pl_dot_vec3(ptModel->col[2].xyz, ptModel->col[2].xyz)));
+        ptMeshComponent->tWorldBoundingSphere = (plVec4){tCenter.x, tCenter.y, tCenter.z, ptMeshComponent->tBoundingSphere.w * sqrtf(fScaleSqr)};
 
-                ptMesh->sbtVertexNormals[uIndex0] = tNorm;
-                ptMesh->sbtVertexNormals[uIndex1] = tNorm;
-                ptMesh->sbtVertexNormals[uIndex2] = tNorm;
-            }
+        ptData->sbtInstances[i] = ptMeshComponent->tInfo;
+        ptData->sbuDirtyInstances[i >> 6] |= (uint64_t)1 << (i & 63);
+        ptData->bDirty = true;
+    }
+
+    // mesh pointers only move with the mesh manager's layout
+    if(bRebuildMeshes)
+    {
+        pl_sb_reset(ptData->sbtMeshes);
+        for(uint32_t i = 0; i < uObjectCount; i++)
+        {
+            if(ptData->sbuMeshIndices[i] != UINT32_MAX && ptData->sbuTransformIndices[i] != UINT32_MAX)
+                pl_sb_push(ptData->sbtMeshes, &sbtMeshComponents[ptData->sbuMeshIndices[i]]);
         }
     }
+
+    ptData->uObjectLayoutVersion    = ptObjectManager->uLayoutVersion;
+    ptData->uMeshLayoutVersion      = ptMeshManager->uLayoutVersion;
+    ptData->uTransformLayoutVersion = ptTransformManager->uLayoutVersion;
+    ptData->uObjectChangeVersion    = pl__sync_changes(ptObjectManager);
+    ptData->uMeshChangeVersion      = pl__sync_changes(ptMeshManager);
+    ptData->uTransformChangeVersion = pl__sync_changes(ptTransformManager);
     pl_end_profile_sample();
 }
 
 static void
-pl_calculate_tangents(plMeshComponent* atMeshes, uint32_t uComponentCount)
+pl_upload_object_instances(plComponentLibrary* ptLibrary, plDevice* ptDevice)
 {
-    pl_begin_profile_sample(__FUNCTION__);
+    // backends without storage buffers (metal) keep instances on the cpu
+    if(gptDevice == NULL || gptDevice->create_storage_buffer == NULL || gptDevice->update_buffer == NULL || gptDevice->destroy_buffer == NULL)
+    {
+        static bool bWarned = false;
+        if(!bWarned)
+            pl_log_warn_to_f(uLogChannel, "upload_object_instances: device has no storage buffer support, instances stay on the cpu");
+        bWarned = true;
+        return;
+    }
 
-    for(uint32_t uMeshIndex = 0; uMeshIndex < uComponentCount; uMeshIndex++)
+    pl_begin_profile_sample(__FUNCTION__);
+    plObjectSystemData* ptData = ptLibrary->tObjectComponentManager.pSystemData;
+    PL_ASSERT((ptData->ptDevice == NULL || ptData->ptDevice == ptDevice) && "instances already live on another device");
+    const uint32_t uCount = pl_sb_size(ptData->sbtInstances);
+    if(!ptData->bDirty || uCount == 0)
     {
-        plMeshComponent* ptMesh = &atMeshes[uMeshIndex];
+        pl_end_profile_sample();
+        return;
+    }
 
-        if(pl_sb_size(ptMesh->sbtVertexTangents) == 0 && pl_sb_size(ptMesh->sbtVertexTextureCoordinates0) > 0)
+    pl_sb_reset(ptData->sbtUploadRanges);
+    if(uCount > ptData->uInstanceCapacity)
+    {
+        // grown buffers start out with every instance (the old one is
+        // released once in flight frames are done with it)
+        if(ptData->uInstanceCapacity > 0)
+            gptDevice->destroy_buffer(ptDevice, ptData->uInstanceBuffer);
+        uint32_t uCapacity = ptData->uInstanceCapacity > 0 ? ptData->uInstanceCapacity : 1024;
+        while(uCapacity < uCount)
+            uCapacity *= 2;
+        ptData->uInstanceBuffer   = gptDevice->create_storage_buffer(ptDevice, uCapacity * sizeof(plObjectInfo), NULL, "object instances");
+        ptData->uInstanceCapacity = uCapacity;
+        ptData->ptDevice          = ptDevice;
+        pl_sb_push(ptData->sbtUploadRanges, ((plBufferRange){.szOffset = 0, .szSize = uCount * sizeof(plObjectInfo)}));
+    }
+    else
+    {
+        // runs of dirty instances, short clean gaps are uploaded along with them
+        uint32_t uRunStart = UINT32_MAX;
+        uint32_t uRunEnd = 0;
+        for(uint32_t uWord = 0; uWord < pl_sb_size(ptData->sbuDirtyInstances); uWord++)
         {
-            pl_sb_resize(ptMesh->sbtVertexTangents, pl_sb_size(ptMesh->sbtVertexPositions));
-            for(uint32_t i = 0; i < pl_sb_size(ptMesh->sbuIndices) - 2; i += 3)
+            uint64_t uBits = ptData->sbuDirtyInstances[uWord];
+            for(uint32_t uBit = 0; uBits; uBit++, uBits >>= 1)
             {
-                const uint32_t uIndex0 = ptMesh->sbuIndices[i + 0];
-                const uint32_t uIndex1 = ptMesh->sbuIndices[i + 1];
-                const uint32_t uIndex2 = ptMesh->sbuIndices[i + 2];
-
-                const plVec3 tP0 = ptMesh->sbtVertexPositions[uIndex0];
-                const plVec3 tP1 = ptMesh->sbtVertexPositions[uIndex1];
-                const plVec3 tP2 = ptMesh->sbtVertexPositions[uIndex2];
+                const uint32_t uInstance = uWord * 64 + uBit;
+                if(!(uBits & 1) || uInstance >= uCount)
+                    continue;
+                if(uRunStart != UINT32_MAX && uInstance - uRunEnd <= PL_ECS_INSTANCE_UPLOAD_GAP)
+                {
+                    uRunEnd = uInstance + 1;
+                    continue;
+                }
+                if(uRunStart != UINT32_MAX)
+                    pl_sb_push(ptData->sbtUploadRanges, ((plBufferRange){.szOffset = uRunStart * sizeof(plObjectInfo), .szSize = (uRunEnd - uRunStart) * sizeof(plObjectInfo)}));
+                uRunStart = uInstance;
+                uRunEnd = uInstance + 1;
+            }
+        }
+        if(uRunStart != UINT32_MAX)
+            pl_sb_push(ptData->sbtUploadRanges, ((plBufferRange){.szOffset = uRunStart * sizeof(plObjectInfo), .szSize = (uRunEnd - uRunStart) * sizeof(plObjectInfo)}));
+    }
+
+    gptDevice->update_buffer(ptDevice, ptData->uInstanceBuffer, ptData->sbtInstances, ptData->sbtUploadRanges, pl_sb_size(ptData->sbtUploadRanges));
+    memset(ptData->sbuDirtyInstances, 0, pl_sb_size(ptData->sbuDirtyInstances) * sizeof(uint64_t));
+    ptData->bDirty = false;
+    pl_end_profile_sample();
+}
+
+static void
+pl_calculate_normals(plMeshComponent* atMeshes, uint32_t uComponentCount)
+{
+    pl_begin_profile_sample(__FUNCTION__);
+    pl__generate_vertex_frames(atMeshes, uComponentCount, true, false);
+    pl_end_profile_sample();
+}
+
+static void
+pl_calculate_tangents(plMeshComponent* atMeshes, uint32_t uComponentCount)
+{
+    pl_begin_profile_sample(__FUNCTION__);
+    pl__generate_vertex_frames(atMeshes, uComponentCount, false, true);
+    pl_end_profile_sample();
+}
+
+static void
+pl_calculate_bounds(plMeshComponent* atMeshes, uint32_t uComponentCount)
+{
+    pl_begin_profile_sample(__FUNCTION__);
+
+    for(uint32_t uMeshIndex = 0; uMeshIndex < uComponentCount; uMeshIndex++)
+    {
+        plMeshComponent* ptMesh = &atMeshes[uMeshIndex];
+        const uint32_t uVertexCount = pl_sb_size(ptMesh->sbtVertexPositions);
+
+        // empty meshes are never culled (radius 0)
+        if(uVertexCount == 0)
+        {
+            ptMesh->tAABBMin = (plVec3){0};
+            ptMesh->tAABBMax = (plVec3){0};
+            ptMesh->tBoundingSphere = (plVec4){0};
+            continue;
+        }
+
+        ptMesh->tAABBMin = ptMesh->sbtVertexPositions[0];
+        ptMesh->tAABBMax = ptMesh->sbtVertexPositions[0];
+        for(uint32_t i = 1; i < uVertexCount; i++)
+        {
+            const plVec3 tP = ptMesh->sbtVertexPositions[i];
+            ptMesh->tAABBMin = (plVec3){pl_minf(ptMesh->tAABBMin.x, tP.x), pl_minf(ptMesh->tAABBMin.y, tP.y), pl_minf(ptMesh->tAABBMin.z, tP.z)};
+            ptMesh->tAABBMax = (plVec3){pl_maxf(ptMesh->tAABBMax.x, tP.x), pl_maxf(ptMesh->tAABBMax.y, tP.y), pl_maxf(ptMesh->tAABBMax.z, tP.z)};
+        }
+
+        // centered on the box, tighter than the box's own bounding sphere
+        const plVec3 tCenter = pl_mul_vec3_scalarf(pl_add_vec3(ptMesh->tAABBMin, ptMesh->tAABBMax), 0.5f);
+        float fRadiusSqr = 0.0f;
+        for(uint32_t i = 0; i < uVertexCount; i++)
+        {
+            const plVec3 tOffset = pl_sub_vec3(ptMesh->sbtVertexPositions[i], tCenter);
+            fRadiusSqr = pl_maxf(fRadiusSqr, pl_dot_vec3(tOffset, tOffset));
+        }
+        ptMesh->tBoundingSphere = (plVec4){tCenter.x, tCenter.y, tCenter.z, sqrtf(fRadiusSqr)};
+    }
+    pl_end_profile_sample();
+}
+
+static void
+pl_pack_vertices(plMeshComponent* atMeshes, uint32_t uComponentCount)
+{
+    pl_begin_profile_sample(__FUNCTION__);
+
+    for(uint32_t uMeshIndex = 0; uMeshIndex < uComponentCount; uMeshIndex++)
+    {
+        plMeshComponent* ptMesh = &atMeshes[uMeshIndex];
+        const uint32_t uVertexCount = pl_sb_size(ptMesh->sbtVertexPositions);
+
+        // layout follows the streams that are present (see [SECTION] vertex layout of pl_graphics.inl)
+        const uint32_t auStreamCounts[PL_MESH_FORMAT_STREAM_COUNT] = {
+            uVertexCount,
+            pl_sb_size(ptMesh->sbtVertexNormals),
+            pl_sb_size(ptMesh->sbtVertexTangents),
+            pl_sb_size(ptMesh->sbtVertexTextureCoordinates0),
+            pl_sb_size(ptMesh->sbtVertexTextureCoordinates1),
+            pl_sb_size(ptMesh->sbtVertexColors0),
+            pl_sb_size(ptMesh->sbtVertexColors1),
+            pl_sb_size(ptMesh->sbtVertexJoints0),
+            pl_sb_size(ptMesh->sbtVertexJoints1),
+            pl_sb_size(ptMesh->sbtVertexWeights0),
+            pl_sb_size(ptMesh->sbtVertexWeights1)
+        };
+        uint64_t ulMask = PL_MESH_FORMAT_FLAG_HAS_POSITION;
+        for(uint32_t i = 1; i < PL_MESH_FORMAT_STREAM_COUNT; i++)
+        {
+            if(auStreamCounts[i] == 0)
+                continue;
+            PL_ASSERT(auStreamCounts[i] == uVertexCount && "every vertex stream needs one value per position");
+            ulMask |= 1ull << i;
+        }
+
+        // u8 joints unless an index doesn't fit
+        const plVec4* atJointStreams[2] = { ptMesh->sbtVertexJoints0, ptMesh->sbtVertexJoints1 };
+        for(uint32_t uStream = 0; uStream < 2 && !(ulMask & PL_MESH_FORMAT_FLAG_JOINTS_16); uStream++)
+        {
+            for(uint32_t i = 0; i < pl_sb_size(atJointStreams[uStream]); i++)
+            {
+                const plVec4 tJoints = atJointStreams[uStream][i];
+                if(pl_maxf(pl_maxf(tJoints.x, tJoints.y), pl_maxf(tJoints.z, tJoints.w)) > 255.0f)
+                {
+                    ulMask |= PL_MESH_FORMAT_FLAG_JOINTS_16;
+                    break;
+                }
+            }
+        }
+
+        uint32_t auOffsets[PL_MESH_FORMAT_STREAM_COUNT] = {0};
+        for(uint32_t i = 1; i < PL_MESH_FORMAT_STREAM_COUNT; i++)
+            auOffsets[i] = pl_get_vertex_attribute_offset(ulMask, 1 << i);
+        const uint32_t uStride = pl_get_vertex_attribute_stride(ulMask);
+
+        ptMesh->tMesh.ulVertexStreamMask = ulMask;
+        ptMesh->tMesh.uVertexCount = uVertexCount;
+        pl_sb_resize(ptMesh->sbucVertexAttributes, uStride * uVertexCount);
+
+        for(uint32_t i = 0; i < uVertexCount; i++)
+        {
+            uint8_t* puVertex = &ptMesh->sbucVertexAttributes[i * uStride];
+
+            if(ulMask & PL_MESH_FORMAT_FLAG_HAS_NORMAL)
+            {
+                const plVec2 tOct = pl__encode_octahedral(ptMesh->sbtVertexNormals[i]);
+                const int16_t aiNormal[2] = { pl__quantize_snorm16(tOct.x), pl__quantize_snorm16(tOct.y) };
+                memcpy(&puVertex[auOffsets[1]], aiNormal, sizeof(aiNormal));
+            }
+
+            if(ulMask & PL_MESH_FORMAT_FLAG_HAS_TANGENT)
+            {
+                // handedness is the sign of y, y itself is remapped to [0.5, 1] so it is never 0
+                const plVec4 tTangent = ptMesh->sbtVertexTangents[i];
+                const plVec2 tOct = pl__encode_octahedral(tTangent.xyz);
+                const float fY = (tOct.y * 0.25f + 0.75f) * (tTangent.w < 0.0f ? -1.0f : 1.0f);
+                const int16_t aiTangent[2] = { pl__quantize_snorm16(tOct.x), pl__quantize_snorm16(fY) };
+                memcpy(&puVertex[auOffsets[2]], aiTangent, sizeof(aiTangent));
+            }
+
+            const plVec2* atTexCoords[2] = { ptMesh->sbtVertexTextureCoordinates0, ptMesh->sbtVertexTextureCoordinates1 };
+            for(uint32_t uSet = 0; uSet < 2; uSet++)
+            {
+                if(!(ulMask & (PL_MESH_FORMAT_FLAG_HAS_TEXCOORD_0 << uSet)))
+                    continue;
+                const uint16_t auTexCoord[2] = { pl__float_to_half(atTexCoords[uSet][i].x), pl__float_to_half(atTexCoords[uSet][i].y) };
+                memcpy(&puVertex[auOffsets[3 + uSet]], auTexCoord, sizeof(auTexCoord));
+            }
+
+            const plVec4* atColors[2] = { ptMesh->sbtVertexColors0, ptMesh->sbtVertexColors1 };
+            for(uint32_t uSet = 0; uSet < 2; uSet++)
+            {
+                if(!(ulMask & (PL_MESH_FORMAT_FLAG_HAS_COLOR_0 << uSet)))
+                    continue;
+                const plVec4 tColor = atColors[uSet][i];
+                const uint8_t auColor[4] = { pl__quantize_unorm8(tColor.x), pl__quantize_unorm8(tColor.y), pl__quantize_unorm8(tColor.z), pl__quantize_unorm8(tColor.w) };
+                memcpy(&puVertex[auOffsets[5 + uSet]], auColor, sizeof(auColor));
+            }
+
+            for(uint32_t uSet = 0; uSet < 2; uSet++)
+            {
+                if(!(ulMask & (PL_MESH_FORMAT_FLAG_HAS_JOINTS_0 << uSet)))
+                    continue;
+                const plVec4 tJoints = atJointStreams[uSet][i];
+                if(ulMask & PL_MESH_FORMAT_FLAG_JOINTS_16)
+                {
+                    const uint16_t auJoints[4] = { (uint16_t)tJoints.x, (uint16_t)tJoints.y, (uint16_t)tJoints.z, (uint16_t)tJoints.w };
+                    memcpy(&puVertex[auOffsets[7 + uSet]], auJoints, sizeof(auJoints));
+                }
+                else
+                {
+                    const uint8_t auJoints[4] = { (uint8_t)tJoints.x, (uint8_t)tJoints.y, (uint8_t)tJoints.z, (uint8_t)tJoints.w };
+                    memcpy(&puVertex[auOffsets[7 + uSet]], auJoints, sizeof(auJoints));
+                }
+            }
+
+            const plVec4* atWeights[2] = { ptMesh->sbtVertexWeights0, ptMesh->sbtVertexWeights1 };
+            for(uint32_t uSet = 0; uSet < 2; uSet++)
+            {
+                if(!(ulMask & (PL_MESH_FORMAT_FLAG_HAS_WEIGHTS_0 << uSet)))
+                    continue;
+
+                // weights are normalized first (sources aren't always), then the
+                // rounding error goes to the largest so the sum stays exactly 255
+                float afWeights[4] = { atWeights[uSet][i].x, atWeights[uSet][i].y, atWeights[uSet][i].z, atWeights[uSet][i].w };
+                float fSum = 0.0f;
+                for(uint32_t k = 0; k < 4; k++)
+                {
+                    afWeights[k] = afWeights[k] > 0.0f ? afWeights[k] : 0.0f;
+                    fSum += afWeights[k];
+                }
+                uint8_t auWeights[4] = {0};
+                int iTotal = 0;
+                uint32_t uLargest = 0;
+                for(uint32_t k = 0; k < 4 && fSum > 0.0f; k++)
+                {
+                    auWeights[k] = pl__quantize_unorm8(afWeights[k] / fSum);
+                    iTotal += auWeights[k];
+                    if(afWeights[k] > afWeights[uLargest])
+                        uLargest = k;
+                }
+                if(iTotal > 0)
+                {
+                    const int iLargest = (int)auWeights[uLargest] + 255 - iTotal;
+                    auWeights[uLargest] = (uint8_t)(iLargest < 0 ? 0 : (iLargest > 255 ? 255 : iLargest));
+                }
+                memcpy(&puVertex[auOffsets[9 + uSet]], auWeights, sizeof(auWeights));
+            }
+        }
+    }
+    pl_end_profile_sample();
+}
+
+static void
+pl_upload_meshes(plMeshComponent* atMeshes, uint32_t uComponentCount, plDevice* ptDevice)
+{
+    if(gptDevice == NULL || gptDevice->create_vertex_buffer == NULL || gptDevice->create_index_buffer == NULL)
+    {
+        static bool bWarned = false;
+        if(!bWarned)
+            pl_log_warn_to_f(uLogChannel, "upload_meshes: PL_API_DEVICE not loaded, meshes stay on the cpu");
+        bWarned = true;
+        return;
+    }
+
+    pl_begin_profile_sample(__FUNCTION__);
+    for(uint32_t uMeshIndex = 0; uMeshIndex < uComponentCount; uMeshIndex++)
+    {
+        plMeshComponent* ptMesh = &atMeshes[uMeshIndex];
+        const uint32_t uVertexCount = pl_sb_size(ptMesh->sbtVertexPositions);
+        const uint32_t uIndexCount = pl_sb_size(ptMesh->sbuIndices);
+        if(uVertexCount == 0 || uIndexCount == 0)
+            continue;
+
+        // unpacked meshes only have positions
+        const uint64_t ulMask = ptMesh->sbucVertexAttributes ? ptMesh->tMesh.ulVertexStreamMask : PL_MESH_FORMAT_FLAG_HAS_POSITION;
+        const uint32_t uStride = pl_get_vertex_attribute_stride(ulMask);
+        PL_ASSERT(pl_sb_size(ptMesh->sbucVertexAttributes) == uStride * uVertexCount && "mesh changed since pack_vertices");
+
+        ptMesh->tMesh.ulVertexStreamMask = ulMask;
+        ptMesh->tMesh.uVertexBuffer = gptDevice->create_vertex_buffer(ptDevice, uVertexCount * sizeof(plVec3), sizeof(plVec3), ptMesh->sbtVertexPositions, "mesh positions");
+        ptMesh->tMesh.uAttributeBuffer = uStride > 0 ? gptDevice->create_vertex_buffer(ptDevice, uVertexCount * uStride, uStride, ptMesh->sbucVertexAttributes, "mesh attributes") : 0;
+        ptMesh->tMesh.uIndexBuffer = gptDevice->create_index_buffer(ptDevice, uIndexCount * sizeof(uint32_t), ptMesh->sbuIndices, "mesh indices");
+        ptMesh->tMesh.uVertexOffset = 0;
+        ptMesh->tMesh.uVertexCount = uVertexCount;
+        ptMesh->tMesh.uIndexOffset = 0;
+        ptMesh->tMesh.uIndexCount = uIndexCount;
+    }
+    pl_end_profile_sample();
+}
+
+static void
+pl_optimize_meshes(plMeshComponent* atMeshes, uint32_t uComponentCount, uint32_t uLodCount)
+{
+    pl_begin_profile_sample(__FUNCTION__);
 
-                const plVec2 tTex0 = ptMesh->sbtVertexTextureCoordinates0[uIndex0];
-                const plVec2 tTex1 = ptMesh->sbtVertexTextureCoordinates0[uIndex1];
-                const plVec2 tTex2 = ptMesh->sbtVertexTextureCoordinates0[uIndex2];
+    if(uLodCount > PL_MAX_MESH_LODS)
+        uLodCount = PL_MAX_MESH_LODS;
 
-                const plVec3 tEdge1 = pl_sub_vec3(tP1, tP0);
-                const plVec3 tEdge2 = pl_sub_vec3(tP2, tP0);
+    // workers can't allocate, so every output is sized for the worst case up front
+    uint32_t uMaxVertexCount = 0;
+    uint32_t uMaxIndexCount = 0;
+    for(uint32_t i = 0; i < uComponentCount; i++)
+    {
+        plMeshComponent* ptMesh = &atMeshes[i];
+        PL_ASSERT(pl_sb_size(ptMesh->sbuIndices) % 3 == 0 && "meshes must be triangle lists");
+        uMaxVertexCount = pl_maxu(uMaxVertexCount, pl_sb_size(ptMesh->sbtVertexPositions));
+        uMaxIndexCount = pl_maxu(uMaxIndexCount, pl_sb_size(ptMesh->sbuIndices));
+        pl_sb_resize(ptMesh->sbuLodIndices, pl_sb_size(ptMesh->sbuIndices) * uLodCount);
+        ptMesh->uLodCount = 0;
+    }
 
-                const float fDeltaU1 = tTex1.x - tTex0.x;
-                const float fDeltaV1 = tTex1.y - tTex0.y;
-                const float fDeltaU2 = tTex2.x - tTex0.x;
-                const float fDeltaV2 = tTex2.y - tTex0.y;
+    const uint32_t uWorkerCount = pl__get_task_worker_count(uComponentCount);
+    const size_t szScratchSize = pl__carve_mesh_scratch(NULL, NULL, uMaxVertexCount, uMaxIndexCount);
+    uint8_t* apWorkerScratch[PL_ECS_MAX_WORKERS] = {0};
+    for(uint32_t i = 0; i < uWorkerCount; i++)
+        apWorkerScratch[i] = PL_ALLOC(szScratchSize);
+
+    plMeshOptimizeJob tJob = {
+        .atMeshes        = atMeshes,
+        .atResults       = PL_ALLOC(sizeof(plMeshOptimizeResult) * uComponentCount),
+        .apWorkerScratch = apWorkerScratch,
+        .uLodCount       = uLodCount
+    };
+    memset(tJob.atResults, 0, sizeof(plMeshOptimizeResult) * uComponentCount);
+    pl__run_tasks(pl__optimize_mesh_task, &tJob, uComponentCount, uWorkerCount);
 
-                const float fDividend = (fDeltaU1 * fDeltaV2 - fDeltaU2 * fDeltaV1);
-                const float fC = 1.0f / fDividend;
+    for(uint32_t i = 0; i < uComponentCount; i++)
+    {
+        plMeshComponent* ptMesh = &atMeshes[i];
+        const plMeshOptimizeResult* ptResult = &tJob.atResults[i];
+        const uint32_t uOriginalVertexCount = pl_sb_size(ptMesh->sbtVertexPositions);
+        pl__resize_vertex_streams(ptMesh, ptResult->uVertexCount);
+        pl_sb_resize(ptMesh->sbuLodIndices, ptResult->uLodIndexCount);
+        ptMesh->tMesh.uVertexCount = ptResult->uVertexCount;
+        ptMesh->tMesh.uIndexCount = pl_sb_size(ptMesh->sbuIndices);
+        pl_log_info_to_f(uLogChannel, "mesh %u: %u -> %u vertices, ACMR %0.3f -> %0.3f, %u lods",
+            i, uOriginalVertexCount, ptResult->uVertexCount, ptResult->fAcmrBefore, ptResult->fAcmrAfter, ptMesh->uLodCount);
+    }
 
-                const float fSx = fDeltaU1;
-                const float fSy = fDeltaU2;
-                const float fTx = fDeltaV1;
-                const float fTy = fDeltaV2;
-                const float fHandedness = ((fTx * fSy - fTy * fSx) < 0.0f) ? -1.0f : 1.0f;
+    for(uint32_t i = 0; i < uWorkerCount; i++)
+        PL_FREE(apWorkerScratch[i]);
+    PL_FREE(tJob.atResults);
+    pl_end_profile_sample();
+}
 
-                const plVec3 tTangent = 
-                    pl_norm_vec3((plVec3){
-                        fC * (fDeltaV2 * tEdge1.x - fDeltaV1 * tEdge2.x),
-                        fC * (fDeltaV2 * tEdge1.y - fDeltaV1 * tEdge2.y),
-                        fC * (fDeltaV2 * tEdge1.z - fDeltaV1 * tEdge2.z)
-                });
+static void
+pl_compose_transforms(plTransformComponent* atTransforms, uint32_t uComponentCount)
+{
+    pl_begin_profile_sample(__FUNCTION__);
 
-                ptMesh->sbtVertexTangents[uIndex0] = (plVec4){tTangent.x, tTangent.y, tTangent.z, fHandedness};
-                ptMesh->sbtVertexTangents[uIndex1] = (plVec4){tTangent.x, tTangent.y, tTangent.z, fHandedness};
-                ptMesh->sbtVertexTangents[uIndex2] = (plVec4){tTangent.x, tTangent.y, tTangent.z, fHandedness};
-            } 
+    // gathered into streams so the kernel can load whole lanes
+    plVec3 atScales[PL_ECS_TRANSFORM_BATCH];
+    plVec4 atRotations[PL_ECS_TRANSFORM_BATCH];
+    plVec3 atTranslations[PL_ECS_TRANSFORM_BATCH];
+    plMat4 atWorlds[PL_ECS_TRANSFORM_BATCH];
+    for(uint32_t uStart = 0; uStart < uComponentCount; uStart += PL_ECS_TRANSFORM_BATCH)
+    {
+        const uint32_t uCount = pl_minu(uComponentCount - uStart, PL_ECS_TRANSFORM_BATCH);
+        for(uint32_t i = 0; i < uCount; i++)
+        {
+            atScales[i]       = atTransforms[uStart + i].tScale;
+            atRotations[i]    = atTransforms[uStart + i].tRotation;
+            atTranslations[i] = atTransforms[uStart + i].tTranslation;
+        }
+        gtTransformKernels.compose_trs(atScales, atRotations, atTranslations, atWorlds, uCount);
+        for(uint32_t i = 0; i < uCount; i++)
+        {
+            atTransforms[uStart + i].tWorld = atWorlds[i];
+            atTransforms[uStart + i].bDirty = true;
         }
     }
     pl_end_profile_sample();
 }
 
+static void
+pl_compose_transform_columns(plTransformColumns* ptColumns)
+{
+    pl_begin_profile_sample(__FUNCTION__);
+
+    // streams are already laid out for the kernel
+    const uint32_t uCount = ptColumns->uCount;
+    gtTransformKernels.compose_trs(ptColumns->atScales, ptColumns->atRotations, ptColumns->atTranslations, ptColumns->atLocals, uCount);
+
+    // bits past the last transform stay clear
+    if(uCount / 64 > 0)
+        memset(ptColumns->auDirtyBits, 0xff, sizeof(uint64_t) * (uCount / 64));
+    if(uCount % 64 > 0)
+        ptColumns->auDirtyBits[uCount / 64] = ((uint64_t)1 << (uCount % 64)) - 1;
+    pl_end_profile_sample();
+}
+
+static void
+pl_ecs_set_transform_layout(plComponentLibrary* ptLibrary, plTransformLayout tLayout)
+{
+    plComponentManager* ptManager = &ptLibrary->tTransformComponentManager;
+    PL_ASSERT(pl_sb_size(ptManager->sbtEntities) == 0 && "transform layout can only change while there are no transforms");
+
+    if(tLayout == PL_TRANSFORM_LAYOUT_SOA && ptManager->pSystemData == NULL)
+    {
+        ptManager->pSystemData = PL_ALLOC(sizeof(plTransformColumns));
+        memset(ptManager->pSystemData, 0, sizeof(plTransformColumns));
+    }
+    else if(tLayout == PL_TRANSFORM_LAYOUT_AOS)
+        pl__free_transform_columns(ptManager);
+}
+
+static bool
+pl_ecs_get_transform_columns(plComponentLibrary* ptLibrary, plTransformColumns* ptColumnsOut)
+{
+    const plTransformColumns* ptColumns = ptLibrary->tTransformComponentManager.pSystemData;
+    if(ptColumns == NULL)
+        return false;
+    *ptColumnsOut = *ptColumns;
+    return true;
+}
+
 static void
 pl_run_hierarchy_update_system(plComponentLibrary* ptLibrary)
 {
     pl_begin_profile_sample(__FUNCTION__);
-    plHierarchyComponent* sbtComponents = ptLibrary->tHierarchyComponentManager.pComponents;
+    plHierarchySystemData* ptData = ptLibrary->tHierarchyComponentManager.pSystemData;
+
+    // dense indices cached in the nodes are only valid for these layouts
+    const bool bRebuild = !ptData->bBuilt ||
+        ptData->uHierarchyVersion != ptLibrary->tHierarchyComponentManager.uLayoutVersion ||
+        ptData->uTransformVersion != ptLibrary->tTransformComponentManager.uLayoutVersion;
+    if(bRebuild)
+        pl__build_hierarchy_nodes(ptLibrary, ptData);
+
+    // one depth at a time, parents are final before any of their children are
+    // visited so the dirty nodes of a depth can be multiplied as a batch
+    plComponentManager* ptTransformManager = &ptLibrary->tTransformComponentManager;
+    plHierarchyNode* sbtNodes = ptData->sbtNodes;
+    const uint32_t uNodeCount = pl_sb_size(sbtNodes);
+    uint32_t uLevelStart = 0;
+    for(uint32_t uLevel = 0; uLevel < ptData->uLevelCount; uLevel++)
+    {
+        const uint32_t uLevelEnd = ptData->sbuDepthOffsets[uLevel];
+        uint32_t uBatchCount = 0;
+        for(uint32_t i = uLevelStart; i < uLevelEnd; i++)
+        {
+            plHierarchyNode* ptNode = &sbtNodes[i];
+            if(ptNode->uTransform == UINT32_MAX)
+            {
+                ptNode->bDirty = false;
+                continue;
+            }
+            const bool bChildDirty = pl__is_transform_dirty(ptTransformManager, ptNode->uTransform);
+
+            // detached or parent destroyed, child acts as a root
+            if(ptNode->uParentTransform == UINT32_MAX)
+            {
+                ptNode->bDirty = bRebuild || bChildDirty;
+                if(ptNode->bDirty)
+                    *pl__get_transform_world(ptTransformManager, ptNode->uTransform) = *pl__get_transform_local(ptTransformManager, ptNode->uTransform);
+                continue;
+            }
+
+            const bool bParentDirty = ptNode->uParentSlot == UINT32_MAX ? pl__is_transform_dirty(ptTransformManager, ptNode->uParentTransform) : sbtNodes[ptNode->uParentSlot].bDirty;
+            ptNode->bDirty = bRebuild || bParentDirty || bChildDirty;
+            if(!ptNode->bDirty)
+                continue;
+
+            ptData->atBatchParents[uBatchCount] = *pl__get_transform_world(ptTransformManager, ptNode->uParentTransform);
+            ptData->atBatchLocals[uBatchCount]  = *pl__get_transform_local(ptTransformManager, ptNode->uTransform);
+            ptData->auBatchTargets[uBatchCount] = ptNode->uTransform;
+            if(++uBatchCount == PL_ECS_TRANSFORM_BATCH)
+            {
+                pl__flush_hierarchy_batch(ptData, ptTransformManager, uBatchCount);
+                uBatchCount = 0;
+            }
+        }
+        pl__flush_hierarchy_batch(ptData, ptTransformManager, uBatchCount);
+        uLevelStart = uLevelEnd;
+    }
 
-    for(uint32_t i = 0; i < pl_sb_size(sbtComponents); i++)
+    // separate pass, every child of a root has to see the root's flag first,
+    // written worlds are stamped for the object system
+    for(uint32_t i = 0; i < uNodeCount; i++)
     {
-        plHierarchyComponent* ptHierarchyComponent = &sbtComponents[i];
-        plEntity tChildEntity = ptLibrary->tHierarchyComponentManager.sbtEntities[i];
-        plTransformComponent* ptParentTransform = pl_ecs_get_component(&ptLibrary->tTransformComponentManager, ptHierarchyComponent->tParent);
-        plTransformComponent* ptChildTransform = pl_ecs_get_component(&ptLibrary->tTransformComponentManager, tChildEntity);
-        ptChildTransform->tFinalTransform = pl_mul_mat4(&ptParentTransform->tFinalTransform, &ptChildTransform->tWorld);
+        const plHierarchyNode* ptNode = &sbtNodes[i];
+        if(ptNode->uTransform != UINT32_MAX)
+        {
+            if(ptNode->bDirty)
+                pl__stamp_change(ptTransformManager, ptNode->uTransform);
+            pl__set_transform_dirty(ptTransformManager, ptNode->uTransform, false);
+        }
+        if(ptNode->uParentSlot == UINT32_MAX && ptNode->uParentTransform != UINT32_MAX && pl__is_transform_dirty(ptTransformManager, ptNode->uParentTransform))
+        {
+            pl__stamp_change(ptTransformManager, ptNode->uParentTransform);
+            pl__set_transform_dirty(ptTransformManager, ptNode->uParentTransform, false);
+        }
     }
 
     pl_end_profile_sample();
 }
 
+static void
+pl__build_hierarchy_nodes(plComponentLibrary* ptLibrary, plHierarchySystemData* ptData)
+{
+    plComponentManager* ptHierarchyManager = &ptLibrary->tHierarchyComponentManager;
+    plComponentManager* ptTransformManager = &ptLibrary->tTransformComponentManager;
+    const plHierarchyComponent* sbtComponents = ptHierarchyManager->pComponents;
+    const uint32_t uCount = pl_sb_size(ptHierarchyManager->sbtEntities);
+
+    // depth of every node (parent without a hierarchy component = depth 0),
+    // unknown chains are walked up once & filled in on the way back
+    pl_sb_resize(ptData->sbuDepths, uCount);
+    if(uCount > 0)
+        memset(ptData->sbuDepths, 0xff, sizeof(uint32_t) * uCount);
+    uint32_t uMaxDepth = 0;
+    for(uint32_t i = 0; i < uCount; i++)
+    {
+        pl_sb_reset(ptData->sbuChain);
+        uint32_t uCurrent = i;
+        uint32_t uDepth = 0;
+        while(ptData->sbuDepths[uCurrent] == UINT32_MAX)
+        {
+            // a chain longer than the node count loops & uCurrent is on the
+            // cycle, cut it there & walk again
+            if(pl_sb_size(ptData->sbuChain) == uCount)
+            {
+                plHierarchyComponent* ptCycleNode = &((plHierarchyComponent*)ptHierarchyManager->pComponents)[uCurrent];
+                pl_log_error_to_f(uLogChannel, "cycle in hierarchy, detached entity %u from its parent", PL_ENTITY_INDEX(ptHierarchyManager->sbtEntities[uCurrent]));
+                ptCycleNode->tParent = PL_INVALID_ENTITY_HANDLE;
+                pl__stamp_change(ptHierarchyManager, uCurrent);
+                pl_sb_reset(ptData->sbuChain);
+                uCurrent = i;
+                continue;
+            }
+            pl_sb_push(ptData->sbuChain, uCurrent);
+            const plEntity tParent = sbtComponents[uCurrent].tParent;
+            if(tParent == PL_INVALID_ENTITY_HANDLE || !pl_ecs_has_entity(ptHierarchyManager, tParent))
+                break;
+            uCurrent = (uint32_t)pl_ecs_get_index(ptHierarchyManager, tParent);
+        }
+        if(ptData->sbuDepths[uCurrent] != UINT32_MAX)
+            uDepth = ptData->sbuDepths[uCurrent] + 1;
+        for(uint32_t j = pl_sb_size(ptData->sbuChain); j > 0; j--)
+            ptData->sbuDepths[ptData->sbuChain[j - 1]] = uDepth++;
+        uMaxDepth = pl_maxu(uMaxDepth, ptData->sbuDepths[i]);
+    }
+
+    // counting sort by depth, nodes keep their relative order within a depth
+    pl_sb_resize(ptData->sbuDepthOffsets, uMaxDepth + 2);
+    memset(ptData->sbuDepthOffsets, 0, sizeof(uint32_t) * (uMaxDepth + 2));
+    for(uint32_t i = 0; i < uCount; i++)
+        ptData->sbuDepthOffsets[ptData->sbuDepths[i] + 1]++;
+    for(uint32_t i = 1; i < uMaxDepth + 2; i++)
+        ptData->sbuDepthOffsets[i] += ptData->sbuDepthOffsets[i - 1];
+    pl_sb_resize(ptData->sbuSlots, uCount);
+    for(uint32_t i = 0; i < uCount; i++)
+        ptData->sbuSlots[i] = ptData->sbuDepthOffsets[ptData->sbuDepths[i]]++;
+    ptData->uLevelCount = uCount > 0 ? uMaxDepth + 1 : 0; // offsets now hold the end of each depth
+
+    pl_sb_resize(ptData->sbtNodes, uCount);
+    for(uint32_t i = 0; i < uCount; i++)
+    {
+        const plEntity tChild = ptHierarchyManager->sbtEntities[i];
+        const plEntity tParent = sbtComponents[i].tParent;
+        const bool bHasParent = tParent != PL_INVALID_ENTITY_HANDLE;
+        ptData->sbtNodes[ptData->sbuSlots[i]] = (plHierarchyNode){
+            .uTransform       = pl_ecs_has_entity(ptTransformManager, tChild) ? (uint32_t)pl_ecs_get_index(ptTransformManager, tChild) : UINT32_MAX,
+            .uParentTransform = bHasParent && pl_ecs_has_entity(ptTransformManager, tParent) ? (uint32_t)pl_ecs_get_index(ptTransformManager, tParent) : UINT32_MAX,
+            .uParentSlot      = bHasParent && pl_ecs_has_entity(ptHierarchyManager, tParent) ? ptData->sbuSlots[pl_ecs_get_index(ptHierarchyManager, tParent)] : UINT32_MAX
+        };
+    }
+
+    ptData->uHierarchyVersion = ptHierarchyManager->uLayoutVersion;
+    ptData->uTransformVersion = ptTransformManager->uLayoutVersion;
+    ptData->bBuilt = true;
+}
+
+static void
+pl__flush_hierarchy_batch(plHierarchySystemData* ptData, plComponentManager* ptTransformManager, uint32_t uCount)
+{
+    if(uCount == 0)
+        return;
+    gtTransformKernels.mul_mat4(ptData->atBatchParents, ptData->atBatchLocals, ptData->atBatchLocals, uCount);
+    for(uint32_t i = 0; i < uCount; i++)
+        *pl__get_transform_world(ptTransformManager, ptData->auBatchTargets[i]) = ptData->atBatchLocals[i];
+}
+
 
 static plEntity
 pl_ecs_create_object(plComponentLibrary* ptLibrary, const char* pcName)
 {
     plEntity tNewEntity = pl_ecs_create_entity(ptLibrary);
 
-    plTagComponent* ptTag = pl_ecs_create_component(&ptLibrary->tTagComponentManager, tNewEntity);
     if(pcName)
     {
         pl_log_debug_to_f(uLogChannel, "created object '%s'", pcName);
-        strncpy(ptTag->acName, pcName, PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, pcName);
     }
     else
     {
         pl_log_debug_to(uLogChannel, "created unnamed object");
-        strncpy(ptTag->acName, "unnamed", PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, "unnamed");
     }
 
     plObjectComponent* ptObject = pl_ecs_create_component(&ptLibrary->tObjectComponentManager, tNewEntity);
     memset(ptObject, 0, sizeof(plObjectComponent));
 
-    plTransformComponent* ptTransform = pl_ecs_create_component(&ptLibrary->tTransformComponentManager, tNewEntity);
-    memset(ptTransform, 0, sizeof(plTransformComponent));
-    ptTransform->tWorld = pl_identity_mat4();
+    pl_ecs_create_component(&ptLibrary->tTransformComponentManager, tNewEntity);
 
     plMeshComponent* ptMesh = pl_ecs_create_component(&ptLibrary->tMeshComponentManager, tNewEntity);
     memset(ptMesh, 0, sizeof(plMeshComponent));
@@ -716,21 +2216,18 @@ pl_ecs_create_transform(plComponentLibrary* ptLibrary, const char* pcName)
 {
     plEntity tNewEntity = pl_ecs_create_entity(ptLibrary);
 
-    plTagComponent* ptTag = pl_ecs_create_component(&ptLibrary->tTagComponentManager, tNewEntity);
     if(pcName)
     {
         pl_log_debug_to_f(uLogChannel, "created transform '%s'", pcName);
-        strncpy(ptTag->acName, pcName, PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, pcName);
     }
     else
     {
         pl_log_debug_to(uLogChannel, "created unnamed transform");
-        strncpy(ptTag->acName, "unnamed", PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, "unnamed");
     }
 
-    plTransformComponent* ptTransform = pl_ecs_create_component(&ptLibrary->tTransformComponentManager, tNewEntity);
-    memset(ptTransform, 0, sizeof(plTransformComponent));
-    ptTransform->tWorld = pl_identity_mat4();
+    pl_ecs_create_component(&ptLibrary->tTransformComponentManager, tNewEntity); // identity & dirty
 
     return tNewEntity;  
 }
@@ -740,16 +2237,15 @@ pl_ecs_create_camera(plComponentLibrary* ptLibrary, const char* pcName, plVec3 t
 {
     plEntity tNewEntity = pl_ecs_create_entity(ptLibrary);
 
-    plTagComponent* ptTag = pl_ecs_create_component(&ptLibrary->tTagComponentManager, tNewEntity);
     if(pcName)
     {
         pl_log_debug_to_f(uLogChannel, "created camera '%s'", pcName);
-        strncpy(ptTag->acName, pcName, PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, pcName);
     }
     else
     {
         pl_log_debug_to(uLogChannel, "created unnamed camera");
-        strncpy(ptTag->acName, "unnamed", PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, "unnamed");
     }
 
     const plCameraComponent tCamera = {
@@ -773,16 +2269,15 @@ pl_ecs_create_light(plComponentLibrary* ptLibrary, const char* pcName, plVec3 tP
 {
     plEntity tNewEntity = pl_ecs_create_entity(ptLibrary);
 
-    plTagComponent* ptTag = pl_ecs_create_component(&ptLibrary->tTagComponentManager, tNewEntity);
     if(pcName)
     {
         pl_log_debug_to_f(uLogChannel, "created light '%s'", pcName);
-        strncpy(ptTag->acName, pcName, PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, pcName);
     }
     else
     {
         pl_log_debug_to(uLogChannel, "created unnamed light");
-        strncpy(ptTag->acName, "unnamed", PL_MAX_NAME_LENGTH);
+        pl_ecs_set_name(ptLibrary, tNewEntity, "unnamed");
     }
 
     plLightComponent* ptLight = pl_ecs_create_component(&ptLibrary->tLightComponentManager, tNewEntity);
@@ -808,6 +2303,7 @@ pl_ecs_attach_component(plComponentLibrary* ptLibrary, plEntity tEntity, plEntit
         ptHierarchyComponent = pl_ecs_create_component(&ptLibrary->tHierarchyComponentManager, tEntity);
     }
     ptHierarchyComponent->tParent = tParent;
+    ptLibrary->tHierarchyComponentManager.uLayoutVersion++;
 }
 
 static void
@@ -825,6 +2321,7 @@ pl_ecs_deattach_component(plComponentLibrary* ptLibrary, plEntity tEntity)
         ptHierarchyComponent = pl_ecs_create_component(&ptLibrary->tHierarchyComponentManager, tEntity);
     }
     ptHierarchyComponent->tParent = PL_INVALID_ENTITY_HANDLE;
+    ptLibrary->tHierarchyComponentManager.uLayoutVersion++;
 }
 
 static void
@@ -896,8 +2393,9 @@ pl_camera_update(plCameraComponent* ptCamera)
     const plMat4 tTranslate = pl_mat4_translate_vec3((plVec3){ptCamera->tPos.x, ptCamera->tPos.y, ptCamera->tPos.z});
 
     // rotations: rotY * rotX * rotZ
-    plMat4 tRotations = pl_mul_mat4t(&tXRotMat, &tZRotMat);
-    tRotations        = pl_mul_mat4t(&tYRotMat, &tRotations);
+    plMat4 tRotations;
+    gtTransformKernels.mul_mat4(&tXRotMat, &tZRotMat, &tRotations, 1);
+    gtTransformKernels.mul_mat4(&tYRotMat, &tRotations, &tRotations, 1);
 
     // update camera vectors
     ptCamera->_tRightVec   = pl_norm_vec4(pl_mul_mat4_vec4(&tRotations, tOriginalRightVec)).xyz;
@@ -905,14 +2403,14 @@ pl_camera_update(plCameraComponent* ptCamera)
     ptCamera->_tForwardVec = pl_norm_vec4(pl_mul_mat4_vec4(&tRotations, tOriginalForwardVec)).xyz;
 
     // update camera transform: translate * rotate
-    ptCamera->tTransformMat = pl_mul_mat4t(&tTranslate, &tRotations);
+    gtTransformKernels.mul_mat4(&tTranslate, &tRotations, &ptCamera->tTransformMat, 1);
 
     // update camera view matrix
-    ptCamera->tViewMat   = pl_mat4t_invert(&ptCamera->tTransformMat);
+    gtTransformKernels.invert_mat4(&ptCamera->tTransformMat, &ptCamera->tViewMat, 1);
 
     // flip x & y so camera looks down +z and remains right handed (+x to the right)
     const plMat4 tFlipXY = pl_mat4_scale_xyz(-1.0f, -1.0f, 1.0f);
-    ptCamera->tViewMat   = pl_mul_mat4t(&tFlipXY, &ptCamera->tViewMat);
+    gtTransformKernels.mul_mat4(&tFlipXY, &ptCamera->tViewMat, &ptCamera->tViewMat, 1);
 
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~update projection~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
     const float fInvtanHalfFovy = 1.0f / tanf(ptCamera->fFieldOfView / 2.0f);
@@ -926,45 +2424,2185 @@ pl_camera_update(plCameraComponent* ptCamera)
     pl_end_profile_sample(); 
 }
 
-//-----------------------------------------------------------------------------
-// [SECTION] extension loading
-//-----------------------------------------------------------------------------
+static plVec2
+pl__encode_octahedral(plVec3 tNormal)
+{
+    // project onto the octahedron, then fold the lower hemisphere over the diagonals
+    const float fL1 = fabsf(tNormal.x) + fabsf(tNormal.y) + fabsf(tNormal.z);
+    if(fL1 == 0.0f)
+        return (plVec2){0};
+    const float fX = tNormal.x / fL1;
+    const float fY = tNormal.y / fL1;
+    if(tNormal.z >= 0.0f)
+        return (plVec2){fX, fY};
+    return (plVec2){
+        (1.0f - fabsf(fY)) * (fX >= 0.0f ? 1.0f : -1.0f),
+        (1.0f - fabsf(fX)) * (fY >= 0.0f ? 1.0f : -1.0f)
+    };
+}
 
-PL_EXPORT void
-pl_load_ecs_ext(plApiRegistryApiI* ptApiRegistry, bool bReload)
+static int16_t
+pl__quantize_snorm16(float fValue)
+{
+    return (int16_t)roundf(pl_clampf(-1.0f, fValue, 1.0f) * 32767.0f);
+}
+
+static uint8_t
+pl__quantize_unorm8(float fValue)
 {
-    const plDataRegistryApiI* ptDataRegistry = ptApiRegistry->first(PL_API_DATA_REGISTRY);
-    pl_set_memory_context(ptDataRegistry->get_data(PL_CONTEXT_MEMORY));
-    pl_set_profile_context(ptDataRegistry->get_data("profile"));
-    pl_set_log_context(ptDataRegistry->get_data("log"));
+    return (uint8_t)roundf(pl_clampf(0.0f, fValue, 1.0f) * 255.0f);
+}
 
-    if(bReload)
+static uint16_t
+pl__float_to_half(float fValue)
+{
+    // round to nearest even, out of range values become infinity
+    union { float f; uint32_t u; } tBits = { .f = fValue };
+    const uint32_t uSign = (tBits.u >> 16) & 0x8000;
+    const uint32_t uFloatExponent = (tBits.u >> 23) & 0xFF;
+    const int32_t  iExponent = (int32_t)uFloatExponent - 127 + 15;
+    uint32_t       uMantissa = tBits.u & 0x007FFFFF;
+
+    if(uFloatExponent == 0xFF) // infinity & nan
+        return (uint16_t)(uSign | 0x7C00 | (uMantissa ? 0x200 : 0));
+    if(iExponent >= 31)
+        return (uint16_t)(uSign | 0x7C00);
+
+    uint32_t uShift = 13;
+    uint32_t uHalf = (uint32_t)iExponent << 10;
+    if(iExponent <= 0) // subnormal
     {
-        ptApiRegistry->replace(ptApiRegistry->first(PL_API_ECS), pl_load_ecs_api());
-        ptApiRegistry->replace(ptApiRegistry->first(PL_API_CAMERA), pl_load_camera_api());
+        if(iExponent < -10)
+            return (uint16_t)uSign;
+        uMantissa |= 0x00800000;
+        uShift = (uint32_t)(14 - iExponent);
+        uHalf = 0;
+    }
+    uHalf |= uMantissa >> uShift;
+    const uint32_t uRemainder = uMantissa & ((1u << uShift) - 1);
+    const uint32_t uHalfway = 1u << (uShift - 1);
+    if(uRemainder > uHalfway || (uRemainder == uHalfway && (uHalf & 1)))
+        uHalf++; // can carry into the exponent, which is still correct
+    return (uint16_t)(uSign | uHalf);
+}
 
-        // find log channel
-        uint32_t uChannelCount = 0;
-        plLogChannel* ptChannels = pl_get_log_channels(&uChannelCount);
-        for(uint32_t i = 0; i < uChannelCount; i++)
+static plEcsQuery*
+pl_ecs_create_query(const plEcsQueryDesc* ptDesc)
+{
+    plEcsQuery* ptQuery = PL_ALLOC(sizeof(plEcsQuery));
+    memset(ptQuery, 0, sizeof(plEcsQuery));
+    while(ptDesc->aptInclude[ptQuery->uIncludeCount])
+    {
+        PL_ASSERT(ptQuery->uIncludeCount < PL_ECS_MAX_QUERY_COMPONENTS && "too many included components");
+        ptQuery->aptInclude[ptQuery->uIncludeCount] = ptDesc->aptInclude[ptQuery->uIncludeCount];
+        ptQuery->uIncludeCount++;
+    }
+    while(ptDesc->aptExclude[ptQuery->uExcludeCount])
+    {
+        PL_ASSERT(ptQuery->uExcludeCount < PL_ECS_MAX_QUERY_COMPONENTS && "too many excluded components");
+        ptQuery->aptExclude[ptQuery->uExcludeCount] = ptDesc->aptExclude[ptQuery->uExcludeCount];
+        ptQuery->uExcludeCount++;
+    }
+    PL_ASSERT(ptQuery->uIncludeCount > 0 && "queries need at least one included component");
+    return ptQuery;
+}
+
+static void
+pl_ecs_destroy_query(plEcsQuery* ptQuery)
+{
+    pl_sb_free(ptQuery->sbtEntities);
+    for(uint32_t i = 0; i < ptQuery->uIncludeCount; i++)
+        pl_sb_free(ptQuery->sbuIndices[i]);
+    PL_FREE(ptQuery);
+}
+
+static uint32_t
+pl_ecs_update_query(plEcsQuery* ptQuery)
+{
+    // cached matches stay valid until a queried manager adds/removes components
+    bool bStale = !ptQuery->bBuilt;
+    for(uint32_t i = 0; i < ptQuery->uIncludeCount; i++)
+        bStale = bStale || ptQuery->auIncludeVersions[i] != ptQuery->aptInclude[i]->uLayoutVersion;
+    for(uint32_t i = 0; i < ptQuery->uExcludeCount; i++)
+        bStale = bStale || ptQuery->auExcludeVersions[i] != ptQuery->aptExclude[i]->uLayoutVersion;
+
+    if(bStale)
+    {
+        pl_begin_profile_sample(__FUNCTION__);
+
+        // drive from the smallest set, everything else is an O(1) sparse probe
+        uint32_t uDriver = 0;
+        for(uint32_t i = 1; i < ptQuery->uIncludeCount; i++)
         {
-            if(strcmp(ptChannels[i].pcName, "ECS") == 0)
-            {
-                uLogChannel = i;
-                break;
-            }
+            if(pl_sb_size(ptQuery->aptInclude[i]->sbtEntities) < pl_sb_size(ptQuery->aptInclude[uDriver]->sbtEntities))
+                uDriver = i;
         }
+
+        pl_sb_reset(ptQuery->sbtEntities);
+        for(uint32_t i = 0; i < ptQuery->uIncludeCount; i++)
+            pl_sb_reset(ptQuery->sbuIndices[i]);
+
+        const plComponentManager* ptDriver = ptQuery->aptInclude[uDriver];
+        const uint32_t uCandidateCount = pl_sb_size(ptDriver->sbtEntities);
+        for(uint32_t uCandidate = 0; uCandidate < uCandidateCount; uCandidate++)
+        {
+            const plEntity tEntity = ptDriver->sbtEntities[uCandidate];
+            bool bMatch = true;
+            for(uint32_t i = 0; i < ptQuery->uIncludeCount && bMatch; i++)
+                bMatch = i == uDriver || pl_ecs_has_entity(ptQuery->aptInclude[i], tEntity);
+            for(uint32_t i = 0; i < ptQuery->uExcludeCount && bMatch; i++)
+                bMatch = !pl_ecs_has_entity(ptQuery->aptExclude[i], tEntity);
+            if(!bMatch)
+                continue;
+
+            pl_sb_push(ptQuery->sbtEntities, tEntity);
+            for(uint32_t i = 0; i < ptQuery->uIncludeCount; i++)
+                pl_sb_push(ptQuery->sbuIndices[i], i == uDriver ? uCandidate : *pl__get_sparse_slot(ptQuery->aptInclude[i], tEntity));
+        }
+
+        for(uint32_t i = 0; i < ptQuery->uIncludeCount; i++)
+            ptQuery->auIncludeVersions[i] = ptQuery->aptInclude[i]->uLayoutVersion;
+        for(uint32_t i = 0; i < ptQuery->uExcludeCount; i++)
+            ptQuery->auExcludeVersions[i] = ptQuery->aptExclude[i]->uLayoutVersion;
+        ptQuery->bBuilt = true;
+        pl_end_profile_sample();
     }
-    else
+    return (pl_sb_size(ptQuery->sbtEntities) + PL_ECS_QUERY_CHUNK_SIZE - 1) / PL_ECS_QUERY_CHUNK_SIZE;
+}
+
+static void
+pl_ecs_get_query_chunk(plEcsQuery* ptQuery, uint32_t uChunk, plEcsQueryChunk* ptChunkOut)
+{
+    PL_ASSERT(ptQuery->bBuilt && "update_query first");
+    const uint32_t uFirst = uChunk * PL_ECS_QUERY_CHUNK_SIZE;
+    PL_ASSERT(uFirst < pl_sb_size(ptQuery->sbtEntities) && "chunk out of range");
+
+    memset(ptChunkOut, 0, sizeof(plEcsQueryChunk));
+    ptChunkOut->uFirst = uFirst;
+    ptChunkOut->uCount = pl_minu(pl_sb_size(ptQuery->sbtEntities) - uFirst, PL_ECS_QUERY_CHUNK_SIZE);
+    ptChunkOut->atEntities = &ptQuery->sbtEntities[uFirst];
+    for(uint32_t i = 0; i < ptQuery->uIncludeCount; i++)
     {
-        ptApiRegistry->add(PL_API_ECS, pl_load_ecs_api());
-        ptApiRegistry->add(PL_API_CAMERA, pl_load_camera_api());
-        uLogChannel = pl_add_log_channel("ECS", PL_CHANNEL_TYPE_CYCLIC_BUFFER);
+        ptChunkOut->apuIndices[i] = &ptQuery->sbuIndices[i][uFirst];
+        ptChunkOut->apComponents[i] = ptQuery->aptInclude[i]->pComponents;
     }
 }
 
-PL_EXPORT void
-pl_unload_ecs_ext(plApiRegistryApiI* ptApiRegistry)
+static void
+pl_ecs_run_query(plEcsQuery* ptQuery, plEcsQueryChunkFn pfChunk, void* pUserData, bool bParallel)
 {
-    
+    const uint32_t uChunkCount = pl_ecs_update_query(ptQuery);
+    plEcsQueryJob tJob = {
+        .ptQuery   = ptQuery,
+        .pfChunk   = pfChunk,
+        .pUserData = pUserData
+    };
+    pl__run_tasks(pl__run_query_chunk_task, &tJob, uChunkCount, bParallel ? pl__get_task_worker_count(uChunkCount) : 1);
+}
+
+static void
+pl__run_query_chunk_task(void* pData, uint32_t uIndex, uint32_t uWorker)
+{
+    plEcsQueryJob* ptJob = pData;
+    plEcsQueryChunk tChunk;
+    pl_ecs_get_query_chunk(ptJob->ptQuery, uIndex, &tChunk);
+    ptJob->pfChunk(&tChunk, ptJob->pUserData, uWorker);
+}
+
+static void
+pl__create_task_pool(void)
+{
+    plEcsTaskPool* ptPool = &gtTaskPool;
+    if(gptThreads == NULL || ptPool->uThreadCount > 0)
+        return;
+
+    ptPool->ptMutex         = gptThreads->create_mutex();
+    ptPool->ptWorkCondition = gptThreads->create_condition_variable();
+    ptPool->ptDoneCondition = gptThreads->create_condition_variable();
+    ptPool->bQuit           = false;
+
+    // threads that fail to start just leave the pool smaller
+    const uint32_t uMaxThreads = pl_minu(gptThreads->get_hardware_thread_count(), PL_ECS_MAX_WORKERS);
+    ptPool->uThreadCount = 1;
+    for(uint32_t i = 1; i < uMaxThreads; i++)
+    {
+        plThread* ptThread = gptThreads->create_thread(pl__task_worker, ptPool);
+        if(ptThread)
+            ptPool->aptThreads[ptPool->uThreadCount++] = ptThread;
+    }
+}
+
+static void
+pl__destroy_task_pool(void)
+{
+    plEcsTaskPool* ptPool = &gtTaskPool;
+    if(ptPool->uThreadCount == 0)
+        return;
+
+    gptThreads->lock_mutex(ptPool->ptMutex);
+    ptPool->bQuit = true;
+    gptThreads->wake_all_condition_variable(ptPool->ptWorkCondition);
+    gptThreads->unlock_mutex(ptPool->ptMutex);
+
+    for(uint32_t i = 1; i < ptPool->uThreadCount; i++)
+        gptThreads->join_thread(ptPool->aptThreads[i]);
+
+    gptThreads->destroy_condition_variable(ptPool->ptWorkCondition);
+    gptThreads->destroy_condition_variable(ptPool->ptDoneCondition);
+    gptThreads->destroy_mutex(ptPool->ptMutex);
+    memset(ptPool, 0, sizeof(plEcsTaskPool));
+}
+
+static uint32_t
+pl__get_task_worker_count(uint32_t uTaskCount)
+{
+    if(gtTaskPool.uThreadCount < 2 || uTaskCount < 2)
+        return 1;
+    return pl_minu(gtTaskPool.uThreadCount, uTaskCount);
+}
+
+static void*
+pl__task_worker(void* pData)
+{
+    plEcsTaskPool* ptPool = pData;
+    uint32_t uLastGeneration = 0;
+    gbInsideTask = true;
+
+    gptThreads->lock_mutex(ptPool->ptMutex);
+    while(!ptPool->bQuit)
+    {
+        // sleep until a set arrives that still has room for another worker
+        plEcsTaskSet* ptSet = ptPool->ptSet;
+        if(ptSet == NULL || ptPool->uGeneration == uLastGeneration || ptSet->uJoinedCount + 1 >= ptSet->uWorkerCount)
+        {
+            gptThreads->wait_condition_variable(ptPool->ptWorkCondition, ptPool->ptMutex);
+            continue;
+        }
+        uLastGeneration = ptPool->uGeneration;
+        const uint32_t uWorker = ++ptSet->uJoinedCount;
+        ptPool->uBusyCount++;
+
+        while(ptSet->uNextIndex < ptSet->uCount)
+        {
+            const uint32_t uIndex = ptSet->uNextIndex++;
+            gptThreads->unlock_mutex(ptPool->ptMutex);
+            ptSet->ptTask(ptSet->pData, uIndex, uWorker);
+            gptThreads->lock_mutex(ptPool->ptMutex);
+        }
+
+        if(--ptPool->uBusyCount == 0)
+            gptThreads->wake_all_condition_variable(ptPool->ptDoneCondition);
+    }
+    gptThreads->unlock_mutex(ptPool->ptMutex);
+    return NULL;
+}
+
+static void
+pl__run_tasks(plEcsTask ptTask, void* pData, uint32_t uTaskCount, uint32_t uWorkerCount)
+{
+    plEcsTaskPool* ptPool = &gtTaskPool;
+
+    // a set started from inside a task runs inline (the pool would wait on
+    // the very thread that started it), as does one started while another
+    // thread's set is running
+    bool bSerial = uWorkerCount <= 1 || ptPool->uThreadCount < 2 || gbInsideTask;
+    if(!bSerial)
+    {
+        gptThreads->lock_mutex(ptPool->ptMutex);
+        bSerial = ptPool->ptSet != NULL;
+        if(bSerial)
+            gptThreads->unlock_mutex(ptPool->ptMutex);
+    }
+
+    if(bSerial)
+    {
+        for(uint32_t i = 0; i < uTaskCount; i++)
+            ptTask(pData, i, 0);
+        return;
+    }
+
+    plEcsTaskSet tSet = {
+        .ptTask       = ptTask,
+        .pData        = pData,
+        .uCount       = uTaskCount,
+        .uWorkerCount = pl_minu(uWorkerCount, ptPool->uThreadCount)
+    };
+    ptPool->ptSet = &tSet;
+    ptPool->uGeneration++;
+    gptThreads->wake_all_condition_variable(ptPool->ptWorkCondition);
+
+    gbInsideTask = true;
+    while(tSet.uNextIndex < tSet.uCount)
+    {
+        const uint32_t uIndex = tSet.uNextIndex++;
+        gptThreads->unlock_mutex(ptPool->ptMutex);
+        ptTask(pData, uIndex, 0);
+        gptThreads->lock_mutex(ptPool->ptMutex);
+    }
+    gbInsideTask = false;
+
+    // no more joins, then wait out tasks still running elsewhere
+    ptPool->ptSet = NULL;
+    while(ptPool->uBusyCount > 0)
+        gptThreads->wait_condition_variable(ptPool->ptDoneCondition, ptPool->ptMutex);
+    gptThreads->unlock_mutex(ptPool->ptMutex);
+}
+
+static void
+pl__generate_vertex_frames(plMeshComponent* atMeshes, uint32_t uComponentCount, bool bNormals, bool bTangents)
+{
+    if(uComponentCount == 0)
+        return;
+
+    // a single worker walks every corner in order (same sums as the bucketed path,
+    // where corners of a range stay in order), so counting & scattering are skipped
+    const bool bSerial = pl__get_task_worker_count(UINT32_MAX) == 1;
+
+    // workers can't allocate, so streams & scratch are sized up front
+    plMeshFrameJob tJob = {
+        .atMeshes = PL_ALLOC(sizeof(plMeshFrameMesh) * uComponentCount)
+    };
+    memset(tJob.atMeshes, 0, sizeof(plMeshFrameMesh) * uComponentCount);
+    for(uint32_t i = 0; i < uComponentCount; i++)
+    {
+        plMeshComponent* ptMesh = &atMeshes[i];
+        plMeshFrameMesh* ptFrame = &tJob.atMeshes[i];
+        const uint32_t uVertexCount = pl_sb_size(ptMesh->sbtVertexPositions);
+        const uint32_t uIndexCount = pl_sb_size(ptMesh->sbuIndices);
+        PL_ASSERT(uIndexCount % 3 == 0 && "meshes must be triangle lists");
+
+        // tangents are built in the plane of the vertex normals, so missing normals come along
+        const bool bMeshTangents = bTangents && pl_sb_size(ptMesh->sbtVertexTangents) == 0 && pl_sb_size(ptMesh->sbtVertexTextureCoordinates0) > 0;
+        const bool bMeshNormals = pl_sb_size(ptMesh->sbtVertexNormals) == 0 && (bNormals || bMeshTangents);
+        if(uVertexCount == 0 || uIndexCount < 3 || !(bMeshNormals || bMeshTangents))
+            continue;
+
+        ptFrame->ptMesh            = ptMesh;
+        ptFrame->bNormals          = bMeshNormals;
+        ptFrame->bTangents         = bMeshTangents;
+        ptFrame->uFaceCount        = uIndexCount / 3;
+        ptFrame->uFacesPerChunk    = pl_maxu(PL_MESH_FRAME_CHUNK_SIZE, (ptFrame->uFaceCount + PL_MESH_FRAME_MAX_CHUNKS - 1) / PL_MESH_FRAME_MAX_CHUNKS);
+        ptFrame->uFaceChunkCount   = (ptFrame->uFaceCount + ptFrame->uFacesPerChunk - 1) / ptFrame->uFacesPerChunk;
+        ptFrame->uRangeShift       = 0;
+        while((1u << ptFrame->uRangeShift) < PL_MESH_FRAME_CHUNK_SIZE || (uVertexCount >> ptFrame->uRangeShift) >= (bSerial ? 1u : PL_MESH_FRAME_MAX_CHUNKS))
+            ptFrame->uRangeShift++;
+        ptFrame->uRangeCount       = ((uVertexCount - 1) >> ptFrame->uRangeShift) + 1;
+
+        const size_t szBucketSize = sizeof(uint32_t) * ptFrame->uFaceChunkCount * ptFrame->uRangeCount;
+        ptFrame->afFaces         = PL_ALLOC(sizeof(float) * ptFrame->uFaceCount * (bMeshTangents ? 9 : 3));
+        ptFrame->auBucketOffsets = PL_ALLOC(szBucketSize);
+        ptFrame->auRangeOffsets  = PL_ALLOC(sizeof(uint32_t) * (ptFrame->uRangeCount + 1));
+        ptFrame->auCorners       = ptFrame->uRangeCount > 1 ? PL_ALLOC(sizeof(uint32_t) * uIndexCount) : NULL; // NULL: corners in order
+        memset(ptFrame->auBucketOffsets, 0, szBucketSize);
+
+        if(bMeshNormals)
+            pl_sb_resize(ptMesh->sbtVertexNormals, uVertexCount);
+        if(bMeshTangents)
+            pl_sb_resize(ptMesh->sbtVertexTangents, uVertexCount);
+
+        for(uint32_t j = 0; j < ptFrame->uFaceChunkCount; j++)
+            pl_sb_push(tJob.sbtFaceTasks, ((plMeshFrameTask){i, j}));
+        for(uint32_t j = 0; j < ptFrame->uRangeCount; j++)
+            pl_sb_push(tJob.sbtRangeTasks, ((plMeshFrameTask){i, j}));
+    }
+
+    const uint32_t uFaceTaskCount = pl_sb_size(tJob.sbtFaceTasks);
+    const uint32_t uRangeTaskCount = pl_sb_size(tJob.sbtRangeTasks);
+    pl__run_tasks(pl__mesh_face_task, &tJob, uFaceTaskCount, pl__get_task_worker_count(uFaceTaskCount));
+
+    // corners grouped by range, then by face chunk, so sums never depend on the worker count
+    for(uint32_t i = 0; i < uComponentCount; i++)
+    {
+        plMeshFrameMesh* ptFrame = &tJob.atMeshes[i];
+        uint32_t uOffset = 0;
+        for(uint32_t uRange = 0; uRange < ptFrame->uRangeCount; uRange++)
+        {
+            ptFrame->auRangeOffsets[uRange] = uOffset;
+            for(uint32_t uChunk = 0; uChunk < ptFrame->uFaceChunkCount; uChunk++)
+            {
+                uint32_t* puBucket = &ptFrame->auBucketOffsets[uChunk * ptFrame->uRangeCount + uRange];
+                const uint32_t uCount = *puBucket;
+                *puBucket = uOffset;
+                uOffset += uCount;
+            }
+        }
+        if(ptFrame->ptMesh)
+            ptFrame->auRangeOffsets[ptFrame->uRangeCount] = uOffset;
+    }
+
+    pl__run_tasks(pl__mesh_corner_task, &tJob, uFaceTaskCount, pl__get_task_worker_count(uFaceTaskCount));
+    pl__run_tasks(pl__mesh_vertex_task, &tJob, uRangeTaskCount, pl__get_task_worker_count(uRangeTaskCount));
+
+    for(uint32_t i = 0; i < uComponentCount; i++)
+    {
+        plMeshFrameMesh* ptFrame = &tJob.atMeshes[i];
+        if(ptFrame->ptMesh == NULL)
+            continue;
+        PL_FREE(ptFrame->afFaces);
+        PL_FREE(ptFrame->auBucketOffsets);
+        PL_FREE(ptFrame->auRangeOffsets);
+        PL_FREE(ptFrame->auCorners);
+    }
+    PL_FREE(tJob.atMeshes);
+    pl_sb_free(tJob.sbtFaceTasks);
+    pl_sb_free(tJob.sbtRangeTasks);
+}
+
+static void
+pl__mesh_face_task(void* pData, uint32_t uIndex, uint32_t uWorker)
+{
+    (void)uWorker;
+    plMeshFrameJob* ptJob = pData;
+    const plMeshFrameTask tTask = ptJob->sbtFaceTasks[uIndex];
+    plMeshFrameMesh* ptFrame = &ptJob->atMeshes[tTask.uMesh];
+    const plMeshComponent* ptMesh = ptFrame->ptMesh;
+    const uint32_t uFirstFace = tTask.uChunk * ptFrame->uFacesPerChunk;
+    const uint32_t uFaceCount = pl_minu(ptFrame->uFacesPerChunk, ptFrame->uFaceCount - uFirstFace);
+
+    plMeshFaceStreams tStreams = {
+        .atPositions = ptMesh->sbtVertexPositions,
+        .atUVs       = ptFrame->bTangents ? ptMesh->sbtVertexTextureCoordinates0 : NULL,
+        .auIndices   = ptMesh->sbuIndices
+    };
+    for(uint32_t i = 0; i < (ptFrame->bTangents ? 9u : 3u); i++)
+        tStreams.apfFaces[i] = &ptFrame->afFaces[(size_t)i * ptFrame->uFaceCount];
+    gtTransformKernels.mesh_faces(&tStreams, uFirstFace, uFaceCount);
+
+    // corners per vertex range, placed by pl__mesh_corner_task once the offsets are known
+    uint32_t* auCounts = &ptFrame->auBucketOffsets[tTask.uChunk * ptFrame->uRangeCount];
+    if(ptFrame->auCorners == NULL)
+    {
+        auCounts[0] = uFaceCount * 3;
+        return;
+    }
+    for(uint32_t i = uFirstFace * 3; i < (uFirstFace + uFaceCount) * 3; i++)
+        auCounts[ptMesh->sbuIndices[i] >> ptFrame->uRangeShift]++;
+}
+
+static void
+pl__mesh_corner_task(void* pData, uint32_t uIndex, uint32_t uWorker)
+{
+    (void)uWorker;
+    plMeshFrameJob* ptJob = pData;
+    const plMeshFrameTask tTask = ptJob->sbtFaceTasks[uIndex];
+    plMeshFrameMesh* ptFrame = &ptJob->atMeshes[tTask.uMesh];
+    const uint32_t* auIndices = ptFrame->ptMesh->sbuIndices;
+    const uint32_t uFirstFace = tTask.uChunk * ptFrame->uFacesPerChunk;
+    const uint32_t uFaceCount = pl_minu(ptFrame->uFacesPerChunk, ptFrame->uFaceCount - uFirstFace);
+
+    if(ptFrame->auCorners == NULL)
+        return;
+
+    uint32_t* auCursors = &ptFrame->auBucketOffsets[tTask.uChunk * ptFrame->uRangeCount];
+    for(uint32_t i = uFirstFace * 3; i < (uFirstFace + uFaceCount) * 3; i++)
+        ptFrame->auCorners[auCursors[auIndices[i] >> ptFrame->uRangeShift]++] = i;
+}
+
+static void
+pl__mesh_vertex_task(void* pData, uint32_t uIndex, uint32_t uWorker)
+{
+    (void)uWorker;
+    plMeshFrameJob* ptJob = pData;
+    const plMeshFrameTask tTask = ptJob->sbtRangeTasks[uIndex];
+    const plMeshFrameMesh* ptFrame = &ptJob->atMeshes[tTask.uMesh];
+    plMeshComponent* ptMesh = ptFrame->ptMesh;
+    const uint32_t* auIndices = ptMesh->sbuIndices;
+    const uint32_t uFirstVertex = tTask.uChunk << ptFrame->uRangeShift;
+    const uint32_t uLastVertex = pl_minu(uFirstVertex + (1u << ptFrame->uRangeShift), pl_sb_size(ptMesh->sbtVertexPositions));
+    const uint32_t uFirstCorner = ptFrame->auRangeOffsets[tTask.uChunk];
+    const uint32_t uLastCorner = ptFrame->auRangeOffsets[tTask.uChunk + 1];
+    const float* afFaces = ptFrame->afFaces;
+    const size_t szFaceCount = ptFrame->uFaceCount;
+    plVec3* atNormals = ptMesh->sbtVertexNormals;
+
+    // area weighted (the face normals are twice the area long)
+    if(ptFrame->bNormals)
+    {
+        for(uint32_t i = uFirstVertex; i < uLastVertex; i++)
+            atNormals[i] = (plVec3){0};
+        for(uint32_t i = uFirstCorner; i < uLastCorner; i++)
+        {
+            const uint32_t uCorner = ptFrame->auCorners ? ptFrame->auCorners[i] : i;
+            const uint32_t uFace = uCorner / 3;
+            plVec3* ptNormal = &atNormals[auIndices[uCorner]];
+            ptNormal->x += afFaces[uFace];
+            ptNormal->y += afFaces[szFaceCount + uFace];
+            ptNormal->z += afFaces[szFaceCount * 2 + uFace];
+        }
+        for(uint32_t i = uFirstVertex; i < uLastVertex; i++)
+        {
+            const float fLength = pl_length_vec3(atNormals[i]);
+            atNormals[i] = fLength > 0.0f ? pl_mul_vec3_scalarf(atNormals[i], 1.0f / fLength) : (plVec3){0.0f, 0.0f, 1.0f};
+        }
+    }
+
+    if(!ptFrame->bTangents)
+        return;
+
+    // mikktspace: face tangents projected into each vertex normal's plane, weighted by
+    // the corner angle, degenerate uv faces left out, handedness from the uv winding
+    // (weighted majority where mikktspace would split the vertex)
+    plVec4* atTangents = ptMesh->sbtVertexTangents;
+    for(uint32_t i = uFirstVertex; i < uLastVertex; i++)
+        atTangents[i] = (plVec4){0};
+    for(uint32_t i = uFirstCorner; i < uLastCorner; i++)
+    {
+        const uint32_t uCorner = ptFrame->auCorners ? ptFrame->auCorners[i] : i;
+        const uint32_t uFace = uCorner / 3;
+        const float fSignedAngle = afFaces[szFaceCount * (6 + uCorner - uFace * 3) + uFace];
+        if(fSignedAngle == 0.0f)
+            continue;
+
+        // given normals may not be unit length, generated ones are
+        const uint32_t uVertex = auIndices[uCorner];
+        const plVec3 tS = {afFaces[szFaceCount * 3 + uFace], afFaces[szFaceCount * 4 + uFace], afFaces[szFaceCount * 5 + uFace]};
+        const plVec3 tN = atNormals[uVertex];
+        const float fNormalLength2 = ptFrame->bNormals ? 1.0f : pl_dot_vec3(tN, tN);
+        const float fProjection = fNormalLength2 > 0.0f ? pl_dot_vec3(tN, tS) / fNormalLength2 : 0.0f;
+        const plVec3 tTangent = pl_sub_vec3(tS, pl_mul_vec3_scalarf(tN, fProjection));
+        const float fTangentLength2 = pl_dot_vec3(tTangent, tTangent);
+        if(fTangentLength2 <= 0.0f)
+            continue;
+        const float fWeight = fabsf(fSignedAngle) / sqrtf(fTangentLength2);
+
+        plVec4* ptTangent = &atTangents[uVertex];
+        ptTangent->x += tTangent.x * fWeight;
+        ptTangent->y += tTangent.y * fWeight;
+        ptTangent->z += tTangent.z * fWeight;
+        ptTangent->w += fSignedAngle;
+    }
+    for(uint32_t i = uFirstVertex; i < uLastVertex; i++)
+    {
+        const plVec3 tSum = {atTangents[i].x, atTangents[i].y, atTangents[i].z};
+        const float fLength = pl_length_vec3(tSum);
+        const plVec3 tTangent = fLength > 0.0f ? pl_mul_vec3_scalarf(tSum, 1.0f / fLength) : pl__orthogonal_vec3(atNormals[i]);
+        atTangents[i] = (plVec4){tTangent.x, tTangent.y, tTangent.z, atTangents[i].w < 0.0f ? -1.0f : 1.0f};
+    }
+}
+
+static float
+pl__acos_approx(float fCos)
+{
+    // abramowitz & stegun 4.4.45 (error below 7e-5 radians), plenty for corner weights
+    const float fX = fabsf(pl_clampf(-1.0f, fCos, 1.0f));
+    const float fAngle = sqrtf(1.0f - fX) * (1.5707288f + fX * (-0.2121144f + fX * (0.0742610f - 0.0187293f * fX)));
+    return fCos < 0.0f ? PL_PI - fAngle : fAngle;
+}
+
+static plVec3
+pl__orthogonal_vec3(plVec3 tNormal)
+{
+    // any unit vector in the normal's plane (vertices without usable uvs)
+    const plVec3 tAxis = fabsf(tNormal.x) < 0.9f ? (plVec3){1.0f, 0.0f, 0.0f} : (plVec3){0.0f, 1.0f, 0.0f};
+    const plVec3 tTangent = pl_cross_vec3(tNormal, tAxis);
+    const float fLength = pl_length_vec3(tTangent);
+    return fLength > 0.0f ? pl_mul_vec3_scalarf(tTangent, 1.0f / fLength) : tAxis;
+}
+
+static uint32_t
+pl__get_vertex_streams(plMeshComponent* ptMesh, uint8_t** apStreams, uint32_t* auStrides)
+{
+    uint8_t* apAllStreams[PL_MESH_FORMAT_STREAM_COUNT] = {
+        (uint8_t*)ptMesh->sbtVertexPositions,
+        (uint8_t*)ptMesh->sbtVertexNormals,
+        (uint8_t*)ptMesh->sbtVertexTangents,
+        (uint8_t*)ptMesh->sbtVertexTextureCoordinates0,
+        (uint8_t*)ptMesh->sbtVertexTextureCoordinates1,
+        (uint8_t*)ptMesh->sbtVertexColors0,
+        (uint8_t*)ptMesh->sbtVertexColors1,
+        (uint8_t*)ptMesh->sbtVertexJoints0,
+        (uint8_t*)ptMesh->sbtVertexJoints1,
+        (uint8_t*)ptMesh->sbtVertexWeights0,
+        (uint8_t*)ptMesh->sbtVertexWeights1
+    };
+    static const uint32_t auAllStrides[PL_MESH_FORMAT_STREAM_COUNT] = {
+        sizeof(plVec3), sizeof(plVec3), sizeof(plVec4), sizeof(plVec2), sizeof(plVec2),
+        sizeof(plVec4), sizeof(plVec4), sizeof(plVec4), sizeof(plVec4), sizeof(plVec4), sizeof(plVec4)
+    };
+
+    // positions are always first
+    uint32_t uStreamCount = 0;
+    for(uint32_t i = 0; i < PL_MESH_FORMAT_STREAM_COUNT; i++)
+    {
+        if(apAllStreams[i] == NULL)
+            continue;
+        PL_ASSERT(pl_sb_size(apAllStreams[i]) == pl_sb_size(ptMesh->sbtVertexPositions) && "every vertex stream needs one value per position");
+        apStreams[uStreamCount] = apAllStreams[i];
+        auStrides[uStreamCount] = auAllStrides[i];
+        uStreamCount++;
+    }
+    return uStreamCount;
+}
+
+static void
+pl__resize_vertex_streams(plMeshComponent* ptMesh, uint32_t uVertexCount)
+{
+    pl_sb_resize(ptMesh->sbtVertexPositions, uVertexCount);
+    if(ptMesh->sbtVertexNormals)             pl_sb_resize(ptMesh->sbtVertexNormals, uVertexCount);
+    if(ptMesh->sbtVertexTangents)            pl_sb_resize(ptMesh->sbtVertexTangents, uVertexCount);
+    if(ptMesh->sbtVertexTextureCoordinates0) pl_sb_resize(ptMesh->sbtVertexTextureCoordinates0, uVertexCount);
+    if(ptMesh->sbtVertexTextureCoordinates1) pl_sb_resize(ptMesh->sbtVertexTextureCoordinates1, uVertexCount);
+    if(ptMesh->sbtVertexColors0)             pl_sb_resize(ptMesh->sbtVertexColors0, uVertexCount);
+    if(ptMesh->sbtVertexColors1)             pl_sb_resize(ptMesh->sbtVertexColors1, uVertexCount);
+    if(ptMesh->sbtVertexJoints0)             pl_sb_resize(ptMesh->sbtVertexJoints0, uVertexCount);
+    if(ptMesh->sbtVertexJoints1)             pl_sb_resize(ptMesh->sbtVertexJoints1, uVertexCount);
+    if(ptMesh->sbtVertexWeights0)            pl_sb_resize(ptMesh->sbtVertexWeights0, uVertexCount);
+    if(ptMesh->sbtVertexWeights1)            pl_sb_resize(ptMesh->sbtVertexWeights1, uVertexCount);
+}
+
+static void*
+pl__carve(uint8_t* puMemory, size_t* pszOffset, size_t szSize)
+{
+    void* pResult = puMemory ? puMemory + *pszOffset : NULL;
+    *pszOffset += (szSize + 15) & ~(size_t)15;
+    return pResult;
+}
+
+static size_t
+pl__carve_mesh_scratch(plMeshOptimizeScratch* ptScratch, uint8_t* puMemory, uint32_t uVertexCount, uint32_t uIndexCount)
+{
+    // puMemory == NULL only measures, the size only grows with the counts
+    plMeshOptimizeScratch tScratch = {0};
+    if(ptScratch == NULL)
+        ptScratch = &tScratch;
+
+    const uint32_t uTriangleCount = uIndexCount / 3;
+    uint32_t uHashTableSize = 16;
+    while(uHashTableSize < uVertexCount * 2)
+        uHashTableSize *= 2;
+
+    size_t szOffset = 0;
+    ptScratch->uHashTableSize     = uHashTableSize;
+    ptScratch->puHashTable        = pl__carve(puMemory, &szOffset, sizeof(uint32_t) * uHashTableSize);
+    ptScratch->puRemap            = pl__carve(puMemory, &szOffset, sizeof(uint32_t) * uVertexCount);
+    ptScratch->puTimestamps       = pl__carve(puMemory, &szOffset, sizeof(uint32_t) * uVertexCount);
+    ptScratch->puAdjacencyCounts  = pl__carve(puMemory, &szOffset, sizeof(uint32_t) * uVertexCount);
+    ptScratch->puAdjacencyOffsets = pl__carve(puMemory, &szOffset, sizeof(uint32_t) * (uVertexCount + 1));
+    ptScratch->puAdjacency        = pl__carve(puMemory, &szOffset, sizeof(uint32_t) * uIndexCount);
+    ptScratch->piCachePositions   = pl__carve(puMemory, &szOffset, sizeof(int32_t) * uVertexCount);
+    ptScratch->pfVertexScores     = pl__carve(puMemory, &szOffset, sizeof(float) * uVertexCount);
+    ptScratch->pfTriangleScores   = pl__carve(puMemory, &szOffset, sizeof(float) * uTriangleCount);
+    ptScratch->puTriangleFlags    = pl__carve(puMemory, &szOffset, sizeof(uint8_t) * uTriangleCount);
+    ptScratch->puVertexFlags      = pl__carve(puMemory, &szOffset, sizeof(uint8_t) * uVertexCount);
+    ptScratch->puIndices          = pl__carve(puMemory, &szOffset, sizeof(uint32_t) * uIndexCount);
+    ptScratch->puHardClusters     = pl__carve(puMemory, &szOffset, sizeof(uint32_t) * (uTriangleCount + 1));
+    ptScratch->puClusters         = pl__carve(puMemory, &szOffset, sizeof(uint32_t) * (uTriangleCount + 1));
+    ptScratch->atClusterKeys      = pl__carve(puMemory, &szOffset, sizeof(plMeshClusterKey) * uTriangleCount);
+    ptScratch->puStreamData       = pl__carve(puMemory, &szOffset, sizeof(plVec4) * uVertexCount);
+    ptScratch->atPositions        = pl__carve(puMemory, &szOffset, sizeof(plVec3) * uVertexCount);
+    ptScratch->atQuadrics         = pl__carve(puMemory, &szOffset, sizeof(plQuadric) * uVertexCount);
+    ptScratch->atCollapses        = pl__carve(puMemory, &szOffset, sizeof(plEdgeCollapse) * uIndexCount);
+    return szOffset;
+}
+
+static void
+pl__optimize_mesh_task(void* pData, uint32_t uIndex, uint32_t uWorker)
+{
+    plMeshOptimizeJob*    ptJob = pData;
+    plMeshComponent*      ptMesh = &ptJob->atMeshes[uIndex];
+    plMeshOptimizeResult* ptResult = &ptJob->atResults[uIndex];
+
+    const uint32_t uIndexCount = pl_sb_size(ptMesh->sbuIndices);
+    uint32_t uVertexCount = pl_sb_size(ptMesh->sbtVertexPositions);
+    ptResult->uVertexCount = uVertexCount;
+    if(uVertexCount == 0 || uIndexCount < 3)
+        return;
+
+    plMeshOptimizeScratch tScratch = {0};
+    pl__carve_mesh_scratch(&tScratch, ptJob->apWorkerScratch[uWorker], uVertexCount, uIndexCount);
+
+    uint8_t* apStreams[PL_MESH_FORMAT_STREAM_COUNT] = {0};
+    uint32_t auStrides[PL_MESH_FORMAT_STREAM_COUNT] = {0};
+    const uint32_t uStreamCount = pl__get_vertex_streams(ptMesh, apStreams, auStrides);
+
+    ptResult->fAcmrBefore = pl__calculate_acmr(ptMesh->sbuIndices, uIndexCount, uVertexCount, tScratch.puTimestamps);
+
+    uVertexCount = pl__weld_vertices(ptMesh->sbuIndices, uIndexCount, apStreams, auStrides, uStreamCount, uVertexCount, &tScratch);
+    pl__optimize_vertex_cache(ptMesh->sbuIndices, uIndexCount, uVertexCount, &tScratch);
+    pl__optimize_overdraw(ptMesh->sbuIndices, uIndexCount, ptMesh->sbtVertexPositions, uVertexCount, &tScratch);
+    uVertexCount = pl__optimize_vertex_fetch(ptMesh->sbuIndices, uIndexCount, apStreams, auStrides, uStreamCount, uVertexCount, &tScratch);
+
+    ptResult->fAcmrAfter = pl__calculate_acmr(ptMesh->sbuIndices, uIndexCount, uVertexCount, tScratch.puTimestamps);
+    ptResult->uVertexCount = uVertexCount;
+
+    if(ptJob->uLodCount == 0)
+        return;
+
+    // simplification works on positions normalized to the unit cube
+    plVec3 tMin = ptMesh->sbtVertexPositions[0];
+    plVec3 tMax = ptMesh->sbtVertexPositions[0];
+    for(uint32_t i = 1; i < uVertexCount; i++)
+    {
+        const plVec3 tP = ptMesh->sbtVertexPositions[i];
+        tMin = (plVec3){pl_minf(tMin.x, tP.x), pl_minf(tMin.y, tP.y), pl_minf(tMin.z, tP.z)};
+        tMax = (plVec3){pl_maxf(tMax.x, tP.x), pl_maxf(tMax.y, tP.y), pl_maxf(tMax.z, tP.z)};
+    }
+    float fExtent = pl_maxf(tMax.x - tMin.x, pl_maxf(tMax.y - tMin.y, tMax.z - tMin.z));
+    if(fExtent <= 0.0f)
+        fExtent = 1.0f;
+    for(uint32_t i = 0; i < uVertexCount; i++)
+        tScratch.atPositions[i] = pl_mul_vec3_scalarf(pl_sub_vec3(ptMesh->sbtVertexPositions[i], tMin), 1.0f / fExtent);
+    pl__find_seam_vertices(tScratch.atPositions, uVertexCount, &tScratch);
+
+    const uint32_t* puSource = ptMesh->sbuIndices;
+    uint32_t uSourceCount = uIndexCount;
+    uint32_t uLodOffset = 0;
+    float fError = 0.0f;
+    for(uint32_t uLod = 0; uLod < ptJob->uLodCount; uLod++)
+    {
+        uint32_t* puDestination = &ptMesh->sbuLodIndices[uLodOffset];
+        const uint32_t uTargetCount = (uSourceCount / 6) * 3;
+        float fLodError = 0.0f;
+        const uint32_t uLodCount = pl__simplify(puSource, uSourceCount, uTargetCount, PL_MESH_LOD_MAX_ERROR, uVertexCount, puDestination, &fLodError, &tScratch);
+
+        // stuck on locked vertices or the error limit, further lods would be the same
+        if(uLodCount == 0 || uLodCount > uSourceCount - uSourceCount / 20)
+            break;
+
+        pl__optimize_vertex_cache(puDestination, uLodCount, uVertexCount, &tScratch);
+        fError += sqrtf(fLodError) * fExtent;
+        ptMesh->atLods[uLod] = (plMeshLod){
+            .uIndexOffset = uLodOffset,
+            .uIndexCount  = uLodCount,
+            .fError       = fError
+        };
+        ptMesh->uLodCount++;
+        uLodOffset += uLodCount;
+        puSource = puDestination;
+        uSourceCount = uLodCount;
+    }
+    ptResult->uLodIndexCount = uLodOffset;
+}
+
+static uint32_t
+pl__simulate_fifo_cache(const uint32_t* puTriangle, uint32_t* puTimestamps, uint32_t* puTimestamp)
+{
+    // a vertex is cached if it missed within the last PL_MESH_FIFO_CACHE_SIZE misses
+    uint32_t uMisses = 0;
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        if(*puTimestamp - puTimestamps[puTriangle[i]] > PL_MESH_FIFO_CACHE_SIZE)
+        {
+            puTimestamps[puTriangle[i]] = (*puTimestamp)++;
+            uMisses++;
+        }
+    }
+    return uMisses;
+}
+
+static float
+pl__calculate_acmr(const uint32_t* puIndices, uint32_t uIndexCount, uint32_t uVertexCount, uint32_t* puTimestamps)
+{
+    memset(puTimestamps, 0, sizeof(uint32_t) * uVertexCount);
+    uint32_t uTimestamp = PL_MESH_FIFO_CACHE_SIZE + 1;
+    uint32_t uMisses = 0;
+    for(uint32_t i = 0; i < uIndexCount; i += 3)
+        uMisses += pl__simulate_fifo_cache(&puIndices[i], puTimestamps, &uTimestamp);
+    return uIndexCount > 0 ? (float)uMisses / (float)(uIndexCount / 3) : 0.0f;
+}
+
+static uint32_t
+pl__weld_vertices(uint32_t* puIndices, uint32_t uIndexCount, uint8_t** apStreams, const uint32_t* auStrides, uint32_t uStreamCount, uint32_t uVertexCount, plMeshOptimizeScratch* ptScratch)
+{
+    // vertices are equal if every stream is bitwise equal, the first of each
+    // kind keeps its relative order so streams can be compacted in place
+    const uint32_t uHashMask = ptScratch->uHashTableSize - 1;
+    memset(ptScratch->puHashTable, 0xFF, sizeof(uint32_t) * ptScratch->uHashTableSize);
+
+    uint32_t uUniqueCount = 0;
+    for(uint32_t i = 0; i < uVertexCount; i++)
+    {
+        uint64_t ulHash = 0;
+        for(uint32_t j = 0; j < uStreamCount; j++)
+            ulHash = pl_hm_hash(&apStreams[j][i * auStrides[j]], auStrides[j], ulHash);
+
+        uint32_t uSlot = (uint32_t)ulHash & uHashMask;
+        while(ptScratch->puHashTable[uSlot] != UINT32_MAX)
+        {
+            const uint32_t uOther = ptScratch->puHashTable[uSlot];
+            bool bEqual = true;
+            for(uint32_t j = 0; j < uStreamCount && bEqual; j++)
+                bEqual = memcmp(&apStreams[j][i * auStrides[j]], &apStreams[j][uOther * auStrides[j]], auStrides[j]) == 0;
+            if(bEqual)
+                break;
+            uSlot = (uSlot + 1) & uHashMask;
+        }
+
+        if(ptScratch->puHashTable[uSlot] == UINT32_MAX)
+        {
+            ptScratch->puHashTable[uSlot] = i;
+            ptScratch->puRemap[i] = uUniqueCount++;
+        }
+        else
+            ptScratch->puRemap[i] = ptScratch->puRemap[ptScratch->puHashTable[uSlot]];
+    }
+
+    uint32_t uWritten = 0;
+    for(uint32_t i = 0; i < uVertexCount; i++)
+    {
+        if(ptScratch->puRemap[i] != uWritten)
+            continue;
+        for(uint32_t j = 0; j < uStreamCount; j++)
+            memmove(&apStreams[j][uWritten * auStrides[j]], &apStreams[j][i * auStrides[j]], auStrides[j]);
+        uWritten++;
+    }
+
+    for(uint32_t i = 0; i < uIndexCount; i++)
+        puIndices[i] = ptScratch->puRemap[puIndices[i]];
+    return uUniqueCount;
+}
+
+static void
+pl__build_triangle_adjacency(const uint32_t* puIndices, uint32_t uIndexCount, uint32_t uVertexCount, plMeshOptimizeScratch* ptScratch)
+{
+    // counts end up as the number of triangles around each vertex
+    uint32_t* puCounts = ptScratch->puAdjacencyCounts;
+    uint32_t* puOffsets = ptScratch->puAdjacencyOffsets;
+    memset(puCounts, 0, sizeof(uint32_t) * uVertexCount);
+    for(uint32_t i = 0; i < uIndexCount; i++)
+        puCounts[puIndices[i]]++;
+
+    puOffsets[0] = 0;
+    for(uint32_t i = 0; i < uVertexCount; i++)
+        puOffsets[i + 1] = puOffsets[i] + puCounts[i];
+
+    memset(puCounts, 0, sizeof(uint32_t) * uVertexCount);
+    for(uint32_t i = 0; i < uIndexCount; i++)
+    {
+        const uint32_t uVertex = puIndices[i];
+        ptScratch->puAdjacency[puOffsets[uVertex] + puCounts[uVertex]++] = i / 3;
+    }
+}
+
+static float
+pl__vertex_cache_score(int32_t iCachePosition, uint32_t uLiveTriangles)
+{
+    // Forsyth, "Linear-Speed Vertex Cache Optimisation"
+    if(uLiveTriangles == 0)
+        return -1.0f;
+
+    float fScore = 0.0f;
+    if(iCachePosition >= 0)
+    {
+        if(iCachePosition < 3) // used by the last triangle, no preference between them
+            fScore = 0.75f;
+        else
+            fScore = powf(1.0f - (float)(iCachePosition - 3) / (float)(PL_MESH_FORSYTH_CACHE_SIZE - 3), 1.5f);
+    }
+
+    // favor vertices with few triangles left, so they stop being needed
+    return fScore + 2.0f / sqrtf((float)uLiveTriangles);
+}
+
+static void
+pl__optimize_vertex_cache(uint32_t* puIndices, uint32_t uIndexCount, uint32_t uVertexCount, plMeshOptimizeScratch* ptScratch)
+{
+    const uint32_t uTriangleCount = uIndexCount / 3;
+    if(uTriangleCount == 0)
+        return;
+
+    pl__build_triangle_adjacency(puIndices, uIndexCount, uVertexCount, ptScratch);
+    uint32_t* puLiveCounts = ptScratch->puAdjacencyCounts;
+    const uint32_t* puOffsets = ptScratch->puAdjacencyOffsets;
+    uint32_t* puAdjacency = ptScratch->puAdjacency;
+
+    for(uint32_t i = 0; i < uVertexCount; i++)
+    {
+        ptScratch->piCachePositions[i] = -1;
+        ptScratch->pfVertexScores[i] = pl__vertex_cache_score(-1, puLiveCounts[i]);
+    }
+
+    uint32_t uBestTriangle = 0;
+    for(uint32_t i = 0; i < uTriangleCount; i++)
+    {
+        const uint32_t* puTriangle = &puIndices[i * 3];
+        ptScratch->pfTriangleScores[i] = ptScratch->pfVertexScores[puTriangle[0]] + ptScratch->pfVertexScores[puTriangle[1]] + ptScratch->pfVertexScores[puTriangle[2]];
+        ptScratch->puTriangleFlags[i] = 0;
+        if(ptScratch->pfTriangleScores[i] > ptScratch->pfTriangleScores[uBestTriangle])
+            uBestTriangle = i;
+    }
+
+    uint32_t auCache[PL_MESH_FORSYTH_CACHE_SIZE + 3] = {0};
+    uint32_t uCacheCount = 0;
+    uint32_t uCursor = 0;
+    for(uint32_t uEmitted = 0; uEmitted < uTriangleCount; uEmitted++)
+    {
+        // dead end, restart from the first triangle left
+        if(uBestTriangle == UINT32_MAX)
+        {
+            while(ptScratch->puTriangleFlags[uCursor])
+                uCursor++;
+            uBestTriangle = uCursor;
+        }
+
+        const uint32_t* puTriangle = &puIndices[uBestTriangle * 3];
+        memcpy(&ptScratch->puIndices[uEmitted * 3], puTriangle, sizeof(uint32_t) * 3);
+        ptScratch->puTriangleFlags[uBestTriangle] = 1;
+
+        // the emitted triangle goes to the front of the cache
+        uint32_t auNewCache[PL_MESH_FORSYTH_CACHE_SIZE + 3] = {0};
+        uint32_t uNewCacheCount = 0;
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            const uint32_t uVertex = puTriangle[i];
+            auNewCache[uNewCacheCount++] = uVertex;
+
+            // drop it from the vertex's live triangles
+            const uint32_t uStart = puOffsets[uVertex];
+            for(uint32_t j = uStart; j < uStart + puLiveCounts[uVertex]; j++)
+            {
+                if(puAdjacency[j] == uBestTriangle)
+                {
+                    puAdjacency[j] = puAdjacency[uStart + puLiveCounts[uVertex] - 1];
+                    puLiveCounts[uVertex]--;
+                    break;
+                }
+            }
+        }
+        for(uint32_t i = 0; i < uCacheCount; i++)
+        {
+            const uint32_t uVertex = auCache[i];
+            if(uVertex != puTriangle[0] && uVertex != puTriangle[1] && uVertex != puTriangle[2])
+                auNewCache[uNewCacheCount++] = uVertex;
+        }
+
+        // rescore everything that moved or fell out & pick the next triangle among their neighbors
+        uBestTriangle = UINT32_MAX;
+        float fBestScore = -FLT_MAX;
+        for(uint32_t i = 0; i < uNewCacheCount; i++)
+        {
+            const uint32_t uVertex = auNewCache[i];
+            ptScratch->piCachePositions[uVertex] = i < PL_MESH_FORSYTH_CACHE_SIZE ? (int32_t)i : -1;
+            const float fScore = pl__vertex_cache_score(ptScratch->piCachePositions[uVertex], puLiveCounts[uVertex]);
+            const float fDelta = fScore - ptScratch->pfVertexScores[uVertex];
+            ptScratch->pfVertexScores[uVertex] = fScore;
+            for(uint32_t j = puOffsets[uVertex]; j < puOffsets[uVertex] + puLiveCounts[uVertex]; j++)
+            {
+                const uint32_t uTriangle = puAdjacency[j];
+                ptScratch->pfTriangleScores[uTriangle] += fDelta;
+                if(ptScratch->pfTriangleScores[uTriangle] > fBestScore)
+                {
+                    fBestScore = ptScratch->pfTriangleScores[uTriangle];
+                    uBestTriangle = uTriangle;
+                }
+            }
+        }
+        uCacheCount = pl_minu(uNewCacheCount, PL_MESH_FORSYTH_CACHE_SIZE);
+        memcpy(auCache, auNewCache, sizeof(uint32_t) * uCacheCount);
+    }
+    memcpy(puIndices, ptScratch->puIndices, sizeof(uint32_t) * uIndexCount);
+}
+
+static int
+pl__compare_cluster_keys(const void* pA, const void* pB)
+{
+    // outward facing clusters first, stable for equal keys
+    const plMeshClusterKey* ptA = pA;
+    const plMeshClusterKey* ptB = pB;
+    if(ptA->fKey != ptB->fKey)
+        return ptA->fKey > ptB->fKey ? -1 : 1;
+    return ptA->uCluster < ptB->uCluster ? -1 : (ptA->uCluster > ptB->uCluster);
+}
+
+static void
+pl__optimize_overdraw(uint32_t* puIndices, uint32_t uIndexCount, const plVec3* atPositions, uint32_t uVertexCount, plMeshOptimizeScratch* ptScratch)
+{
+    // Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced
+    // Overdraw": split the cache optimized order into clusters, then draw the
+    // clusters facing away from the mesh center first, giving up at most
+    // PL_MESH_OVERDRAW_THRESHOLD of the ACMR
+    const uint32_t uTriangleCount = uIndexCount / 3;
+    if(uTriangleCount == 0)
+        return;
+
+    uint32_t* puTimestamps = ptScratch->puTimestamps;
+    memset(puTimestamps, 0, sizeof(uint32_t) * uVertexCount);
+    uint32_t uTimestamp = PL_MESH_FIFO_CACHE_SIZE + 1;
+
+    // hard boundaries, where the cache optimizer restarted
+    uint32_t uHardClusterCount = 0;
+    for(uint32_t i = 0; i < uTriangleCount; i++)
+    {
+        if(pl__simulate_fifo_cache(&puIndices[i * 3], puTimestamps, &uTimestamp) == 3 || i == 0)
+            ptScratch->puHardClusters[uHardClusterCount++] = i;
+    }
+    ptScratch->puHardClusters[uHardClusterCount] = uTriangleCount;
+
+    // soft boundaries, wherever a cluster prefix is already close to the cluster's ACMR
+    uint32_t uClusterCount = 0;
+    for(uint32_t uHard = 0; uHard < uHardClusterCount; uHard++)
+    {
+        const uint32_t uStart = ptScratch->puHardClusters[uHard];
+        const uint32_t uEnd = ptScratch->puHardClusters[uHard + 1];
+
+        uTimestamp += PL_MESH_FIFO_CACHE_SIZE + 1;
+        uint32_t uClusterMisses = 0;
+        for(uint32_t i = uStart; i < uEnd; i++)
+            uClusterMisses += pl__simulate_fifo_cache(&puIndices[i * 3], puTimestamps, &uTimestamp);
+        const float fThreshold = PL_MESH_OVERDRAW_THRESHOLD * (float)uClusterMisses / (float)(uEnd - uStart);
+
+        ptScratch->puClusters[uClusterCount++] = uStart;
+        uTimestamp += PL_MESH_FIFO_CACHE_SIZE + 1;
+        uint32_t uRunningMisses = 0;
+        uint32_t uRunningTriangles = 0;
+        for(uint32_t i = uStart; i < uEnd; i++)
+        {
+            uRunningMisses += pl__simulate_fifo_cache(&puIndices[i * 3], puTimestamps, &uTimestamp);
+            uRunningTriangles++;
+            if((float)uRunningMisses / (float)uRunningTriangles <= fThreshold)
+            {
+                ptScratch->puClusters[uClusterCount++] = i + 1;
+                uTimestamp += PL_MESH_FIFO_CACHE_SIZE + 1;
+                uRunningMisses = 0;
+                uRunningTriangles = 0;
+            }
+        }
+
+        // the last triangle may have started an empty cluster
+        if(ptScratch->puClusters[uClusterCount - 1] == uEnd)
+            uClusterCount--;
+    }
+    ptScratch->puClusters[uClusterCount] = uTriangleCount;
+
+    plVec3 tMeshCenter = {0};
+    for(uint32_t i = 0; i < uVertexCount; i++)
+        tMeshCenter = pl_add_vec3(tMeshCenter, atPositions[i]);
+    tMeshCenter = pl_mul_vec3_scalarf(tMeshCenter, 1.0f / (float)uVertexCount);
+
+    for(uint32_t uCluster = 0; uCluster < uClusterCount; uCluster++)
+    {
+        plVec3 tCenter = {0};
+        plVec3 tNormal = {0};
+        float fArea = 0.0f;
+        for(uint32_t i = ptScratch->puClusters[uCluster]; i < ptScratch->puClusters[uCluster + 1]; i++)
+        {
+            const plVec3 tP0 = atPositions[puIndices[i * 3 + 0]];
+            const plVec3 tP1 = atPositions[puIndices[i * 3 + 1]];
+            const plVec3 tP2 = atPositions[puIndices[i * 3 + 2]];
+            const plVec3 tCross = pl_cross_vec3(pl_sub_vec3(tP1, tP0), pl_sub_vec3(tP2, tP0));
+            const float fTriangleArea = pl_length_vec3(tCross);
+            tCenter = pl_add_vec3(tCenter, pl_mul_vec3_scalarf(pl_add_vec3(tP0, pl_add_vec3(tP1, tP2)), fTriangleArea / 3.0f));
+            tNormal = pl_add_vec3(tNormal, tCross);
+            fArea += fTriangleArea;
+        }
+        const float fNormalLength = pl_length_vec3(tNormal);
+        float fKey = 0.0f;
+        if(fArea > 0.0f && fNormalLength > 0.0f)
+            fKey = pl_dot_vec3(pl_sub_vec3(pl_mul_vec3_scalarf(tCenter, 1.0f / fArea), tMeshCenter), pl_mul_vec3_scalarf(tNormal, 1.0f / fNormalLength));
+        ptScratch->atClusterKeys[uCluster] = (plMeshClusterKey){ .fKey = fKey, .uCluster = uCluster };
+    }
+    qsort(ptScratch->atClusterKeys, uClusterCount, sizeof(plMeshClusterKey), pl__compare_cluster_keys);
+
+    uint32_t uWritten = 0;
+    for(uint32_t i = 0; i < uClusterCount; i++)
+    {
+        const uint32_t uCluster = ptScratch->atClusterKeys[i].uCluster;
+        const uint32_t uStart = ptScratch->puClusters[uCluster];
+        const uint32_t uCount = (ptScratch->puClusters[uCluster + 1] - uStart) * 3;
+        memcpy(&ptScratch->puIndices[uWritten], &puIndices[uStart * 3], sizeof(uint32_t) * uCount);
+        uWritten += uCount;
+    }
+    memcpy(puIndices, ptScratch->puIndices, sizeof(uint32_t) * uIndexCount);
+}
+
+static uint32_t
+pl__optimize_vertex_fetch(uint32_t* puIndices, uint32_t uIndexCount, uint8_t** apStreams, const uint32_t* auStrides, uint32_t uStreamCount, uint32_t uVertexCount, plMeshOptimizeScratch* ptScratch)
+{
+    // vertices in order of first use, unused vertices are dropped
+    uint32_t* puRemap = ptScratch->puRemap;
+    memset(puRemap, 0xFF, sizeof(uint32_t) * uVertexCount);
+    uint32_t uNextVertex = 0;
+    for(uint32_t i = 0; i < uIndexCount; i++)
+    {
+        const uint32_t uVertex = puIndices[i];
+        if(puRemap[uVertex] == UINT32_MAX)
+            puRemap[uVertex] = uNextVertex++;
+        puIndices[i] = puRemap[uVertex];
+    }
+
+    for(uint32_t j = 0; j < uStreamCount; j++)
+    {
+        for(uint32_t i = 0; i < uVertexCount; i++)
+        {
+            if(puRemap[i] != UINT32_MAX)
+                memcpy(&ptScratch->puStreamData[puRemap[i] * auStrides[j]], &apStreams[j][i * auStrides[j]], auStrides[j]);
+        }
+        memcpy(apStreams[j], ptScratch->puStreamData, uNextVertex * auStrides[j]);
+    }
+    return uNextVertex;
+}
+
+static void
+pl__find_seam_vertices(const plVec3* atPositions, uint32_t uVertexCount, plMeshOptimizeScratch* ptScratch)
+{
+    // vertices split for attributes (uv seams, hard edges) stay put during simplification
+    const uint32_t uHashMask = ptScratch->uHashTableSize - 1;
+    memset(ptScratch->puHashTable, 0xFF, sizeof(uint32_t) * ptScratch->uHashTableSize);
+    memset(ptScratch->puVertexFlags, 0, sizeof(uint8_t) * uVertexCount);
+
+    for(uint32_t i = 0; i < uVertexCount; i++)
+    {
+        uint32_t uSlot = (uint32_t)pl_hm_hash(&atPositions[i], sizeof(plVec3), 0) & uHashMask;
+        while(ptScratch->puHashTable[uSlot] != UINT32_MAX)
+        {
+            const uint32_t uOther = ptScratch->puHashTable[uSlot];
+            if(memcmp(&atPositions[i], &atPositions[uOther], sizeof(plVec3)) == 0)
+            {
+                ptScratch->puVertexFlags[i] |= PL_MESH_VERTEX_FLAG_SEAM;
+                ptScratch->puVertexFlags[uOther] |= PL_MESH_VERTEX_FLAG_SEAM;
+                break;
+            }
+            uSlot = (uSlot + 1) & uHashMask;
+        }
+        if(ptScratch->puHashTable[uSlot] == UINT32_MAX)
+            ptScratch->puHashTable[uSlot] = i;
+    }
+}
+
+static void
+pl__add_quadric(plQuadric* ptQuadric, const plQuadric* ptOther)
+{
+    ptQuadric->fA00 += ptOther->fA00;
+    ptQuadric->fA11 += ptOther->fA11;
+    ptQuadric->fA22 += ptOther->fA22;
+    ptQuadric->fA01 += ptOther->fA01;
+    ptQuadric->fA02 += ptOther->fA02;
+    ptQuadric->fA12 += ptOther->fA12;
+    ptQuadric->fB0 += ptOther->fB0;
+    ptQuadric->fB1 += ptOther->fB1;
+    ptQuadric->fB2 += ptOther->fB2;
+    ptQuadric->fC += ptOther->fC;
+    ptQuadric->fWeight += ptOther->fWeight;
+}
+
+static float
+pl__evaluate_quadric(const plQuadric* ptQuadric, plVec3 tP)
+{
+    // squared distance to the accumulated planes, averaged by area
+    const float fRx = ptQuadric->fA00 * tP.x + ptQuadric->fA01 * tP.y + ptQuadric->fA02 * tP.z;
+    const float fRy = ptQuadric->fA01 * tP.x + ptQuadric->fA11 * tP.y + ptQuadric->fA12 * tP.z;
+    const float fRz = ptQuadric->fA02 * tP.x + ptQuadric->fA12 * tP.y + ptQuadric->fA22 * tP.z;
+    const float fError = tP.x * fRx + tP.y * fRy + tP.z * fRz + 2.0f * (ptQuadric->fB0 * tP.x + ptQuadric->fB1 * tP.y + ptQuadric->fB2 * tP.z) + ptQuadric->fC;
+    return ptQuadric->fWeight > 0.0f ? fabsf(fError) / ptQuadric->fWeight : 0.0f;
+}
+
+static int
+pl__compare_edge_collapses(const void* pA, const void* pB)
+{
+    const plEdgeCollapse* ptA = pA;
+    const plEdgeCollapse* ptB = pB;
+    return ptA->fCost < ptB->fCost ? -1 : (ptA->fCost > ptB->fCost);
+}
+
+static uint32_t
+pl__simplify(const uint32_t* puSource, uint32_t uIndexCount, uint32_t uTargetCount, float fMaxError, uint32_t uVertexCount, uint32_t* puDestination, float* pfErrorOut, plMeshOptimizeScratch* ptScratch)
+{
+    // Garland & Heckbert, "Surface Simplification Using Quadric Error Metrics",
+    // collapsing onto existing vertices only so every lod shares the vertex buffer
+    const plVec3* atPositions = ptScratch->atPositions;
+    plQuadric*    atQuadrics = ptScratch->atQuadrics;
+    uint8_t*      puFlags = ptScratch->puVertexFlags;
+    uint32_t*     puRemap = ptScratch->puRemap;
+    const float   fMaxCost = fMaxError * fMaxError;
+
+    memcpy(puDestination, puSource, sizeof(uint32_t) * uIndexCount);
+    memset(atQuadrics, 0, sizeof(plQuadric) * uVertexCount);
+    for(uint32_t i = 0; i < uIndexCount; i += 3)
+    {
+        const plVec3 tP0 = atPositions[puSource[i + 0]];
+        const plVec3 tCross = pl_cross_vec3(pl_sub_vec3(atPositions[puSource[i + 1]], tP0), pl_sub_vec3(atPositions[puSource[i + 2]], tP0));
+        const float fLength = pl_length_vec3(tCross);
+        if(fLength <= 0.0f)
+            continue;
+        const plVec3 tN = pl_mul_vec3_scalarf(tCross, 1.0f / fLength);
+        const float fD = -pl_dot_vec3(tN, tP0);
+        const float fArea = fLength * 0.5f;
+        const plQuadric tPlane = {
+            .fA00 = fArea * tN.x * tN.x, .fA11 = fArea * tN.y * tN.y, .fA22 = fArea * tN.z * tN.z,
+            .fA01 = fArea * tN.x * tN.y, .fA02 = fArea * tN.x * tN.z, .fA12 = fArea * tN.y * tN.z,
+            .fB0  = fArea * tN.x * fD,   .fB1  = fArea * tN.y * fD,   .fB2  = fArea * tN.z * fD,
+            .fC   = fArea * fD * fD,
+            .fWeight = fArea
+        };
+        for(uint32_t j = 0; j < 3; j++)
+            pl__add_quadric(&atQuadrics[puSource[i + j]], &tPlane);
+    }
+
+    uint32_t uCount = uIndexCount;
+    float fError = 0.0f;
+    for(uint32_t uPass = 0; uPass < 64 && uCount > uTargetCount; uPass++)
+    {
+        pl__build_triangle_adjacency(puDestination, uCount, uVertexCount, ptScratch);
+        const uint32_t* puAdjacencyCounts = ptScratch->puAdjacencyCounts;
+        const uint32_t* puOffsets = ptScratch->puAdjacencyOffsets;
+        const uint32_t* puAdjacency = ptScratch->puAdjacency;
+
+        // border vertices have no quadric for the missing side, so they stay put
+        for(uint32_t i = 0; i < uVertexCount; i++)
+            puFlags[i] &= PL_MESH_VERTEX_FLAG_SEAM;
+        for(uint32_t i = 0; i < uCount; i++)
+        {
+            const uint32_t uA = puDestination[i];
+            const uint32_t uB = puDestination[(i % 3) == 2 ? i - 2 : i + 1];
+            bool bOpposite = false;
+            for(uint32_t j = puOffsets[uB]; j < puOffsets[uB] + puAdjacencyCounts[uB] && !bOpposite; j++)
+            {
+                const uint32_t* puTriangle = &puDestination[puAdjacency[j] * 3];
+                for(uint32_t k = 0; k < 3; k++)
+                {
+                    if(puTriangle[k] == uB && puTriangle[(k + 1) % 3] == uA)
+                        bOpposite = true;
+                }
+            }
+            if(!bOpposite)
+            {
+                puFlags[uA] |= PL_MESH_VERTEX_FLAG_BORDER;
+                puFlags[uB] |= PL_MESH_VERTEX_FLAG_BORDER;
+            }
+        }
+
+        // each edge once, collapsing the cheaper way
+        uint32_t uCollapseCount = 0;
+        for(uint32_t i = 0; i < uCount; i++)
+        {
+            const uint32_t uA = puDestination[i];
+            const uint32_t uB = puDestination[(i % 3) == 2 ? i - 2 : i + 1];
+            if(uA > uB)
+                continue;
+            const float fCostA = (puFlags[uA] & PL_MESH_VERTEX_FLAG_LOCKED) ? FLT_MAX : pl__evaluate_quadric(&atQuadrics[uA], atPositions[uB]);
+            const float fCostB = (puFlags[uB] & PL_MESH_VERTEX_FLAG_LOCKED) ? FLT_MAX : pl__evaluate_quadric(&atQuadrics[uB], atPositions[uA]);
+            if(fCostA == FLT_MAX && fCostB == FLT_MAX)
+                continue;
+            ptScratch->atCollapses[uCollapseCount++] = fCostA <= fCostB ?
+                (plEdgeCollapse){ .uFrom = uA, .uTo = uB, .fCost = fCostA } :
+                (plEdgeCollapse){ .uFrom = uB, .uTo = uA, .fCost = fCostB };
+        }
+        qsort(ptScratch->atCollapses, uCollapseCount, sizeof(plEdgeCollapse), pl__compare_edge_collapses);
+
+        for(uint32_t i = 0; i < uVertexCount; i++)
+            puRemap[i] = i;
+
+        const uint32_t uTriangleBudget = (uCount - uTargetCount) / 3;
+        uint32_t uRemovedTriangles = 0;
+        uint32_t uCollapsed = 0;
+        for(uint32_t i = 0; i < uCollapseCount && uRemovedTriangles < uTriangleBudget; i++)
+        {
+            const plEdgeCollapse* ptCollapse = &ptScratch->atCollapses[i];
+            if(ptCollapse->fCost > fMaxCost)
+                break;
+            if((puFlags[ptCollapse->uFrom] | puFlags[ptCollapse->uTo]) & PL_MESH_VERTEX_FLAG_TOUCHED)
+                continue;
+
+            // reject collapses that flip a remaining triangle
+            bool bValid = true;
+            uint32_t uSharedTriangles = 0;
+            for(uint32_t j = puOffsets[ptCollapse->uFrom]; j < puOffsets[ptCollapse->uFrom] + puAdjacencyCounts[ptCollapse->uFrom] && bValid; j++)
+            {
+                const uint32_t* puTriangle = &puDestination[puAdjacency[j] * 3];
+                if(puTriangle[0] == ptCollapse->uTo || puTriangle[1] == ptCollapse->uTo || puTriangle[2] == ptCollapse->uTo)
+                {
+                    uSharedTriangles++;
+                    continue;
+                }
+                plVec3 atOld[3] = {0};
+                plVec3 atNew[3] = {0};
+                for(uint32_t k = 0; k < 3; k++)
+                {
+                    atOld[k] = atPositions[puTriangle[k]];
+                    atNew[k] = puTriangle[k] == ptCollapse->uFrom ? atPositions[ptCollapse->uTo] : atOld[k];
+                }
+                const plVec3 tOldNormal = pl_cross_vec3(pl_sub_vec3(atOld[1], atOld[0]), pl_sub_vec3(atOld[2], atOld[0]));
+                const plVec3 tNewNormal = pl_cross_vec3(pl_sub_vec3(atNew[1], atNew[0]), pl_sub_vec3(atNew[2], atNew[0]));
+                bValid = pl_dot_vec3(tOldNormal, tNewNormal) > 0.0f;
+            }
+            if(!bValid)
+                continue;
+
+            puRemap[ptCollapse->uFrom] = ptCollapse->uTo;
+            pl__add_quadric(&atQuadrics[ptCollapse->uTo], &atQuadrics[ptCollapse->uFrom]);
+            puFlags[ptCollapse->uFrom] |= PL_MESH_VERTEX_FLAG_TOUCHED;
+            puFlags[ptCollapse->uTo] |= PL_MESH_VERTEX_FLAG_TOUCHED;
+            fError = pl_maxf(fError, ptCollapse->fCost);
+            uRemovedTriangles += uSharedTriangles;
+            uCollapsed++;
+        }
+        if(uCollapsed == 0)
+            break;
+
+        // touched vertices never collapse twice in a pass, so one remap level is enough
+        uint32_t uWritten = 0;
+        for(uint32_t i = 0; i < uCount; i += 3)
+        {
+            const uint32_t uA = puRemap[puDestination[i + 0]];
+            const uint32_t uB = puRemap[puDestination[i + 1]];
+            const uint32_t uC = puRemap[puDestination[i + 2]];
+            if(uA == uB || uB == uC || uA == uC)
+                continue;
+            puDestination[uWritten++] = uA;
+            puDestination[uWritten++] = uB;
+            puDestination[uWritten++] = uC;
+        }
+        uCount = uWritten;
+    }
+
+    *pfErrorOut = fError;
+    return uCount;
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] transform kernels
+//-----------------------------------------------------------------------------
+
+// Kernels are written once per instruction set. Inverse & trs work on 4 (8 for
+// avx2) matrices at a time transposed into lanes, so the math below is plain
+// lane-wise arithmetic shared by every backend (a are the 16 inputs with
+// column c at [c * 4], b the unscaled adjugate). Tails fall back to scalar.
+
+#define PL__INVERT_4X4(T, ADD, SUB, MUL, a, b, tDet) \
+    { \
+        const T s0 = SUB(MUL(a[0], a[5]), MUL(a[4], a[1])); \
+        const T s1 = SUB(MUL(a[0], a[6]), MUL(a[4], a[2])); \
+        const T s2 = SUB(MUL(a[0], a[7]), MUL(a[4], a[3])); \
+        const T s3 = SUB(MUL(a[1], a[6]), MUL(a[5], a[2])); \
+        const T s4 = SUB(MUL(a[1], a[7]), MUL(a[5], a[3])); \
+        const T s5 = SUB(MUL(a[2], a[7]), MUL(a[6], a[3])); \
+        const T c5 = SUB(MUL(a[10], a[15]), MUL(a[14], a[11])); \
+        const T c4 = SUB(MUL(a[9], a[15]), MUL(a[13], a[11])); \
+        const T c3 = SUB(MUL(a[9], a[14]), MUL(a[13], a[10])); \
+        const T c2 = SUB(MUL(a[8], a[15]), MUL(a[12], a[11])); \
+        const T c1 = SUB(MUL(a[8], a[14]), MUL(a[12], a[10])); \
+        const T c0 = SUB(MUL(a[8], a[13]), MUL(a[12], a[9])); \
+        tDet = ADD(ADD(SUB(ADD(SUB(MUL(s0, c5), MUL(s1, c4)), MUL(s2, c3)), MUL(s4, c1)), MUL(s3, c2)), MUL(s5, c0)); \
+        b[0]  = ADD(SUB(MUL(a[5], c5), MUL(a[6], c4)), MUL(a[7], c3)); \
+        b[1]  = SUB(SUB(MUL(a[2], c4), MUL(a[1], c5)), MUL(a[3], c3)); \
+        b[2]  = ADD(SUB(MUL(a[13], s5), MUL(a[14], s4)), MUL(a[15], s3)); \
+        b[3]  = SUB(SUB(MUL(a[10], s4), MUL(a[9], s5)), MUL(a[11], s3)); \
+        b[4]  = SUB(SUB(MUL(a[6], c2), MUL(a[4], c5)), MUL(a[7], c1)); \
+        b[5]  = ADD(SUB(MUL(a[0], c5), MUL(a[2], c2)), MUL(a[3], c1)); \
+        b[6]  = SUB(SUB(MUL(a[14], s2), MUL(a[12], s5)), MUL(a[15], s1)); \
+        b[7]  = ADD(SUB(MUL(a[8], s5), MUL(a[10], s2)), MUL(a[11], s1)); \
+        b[8]  = ADD(SUB(MUL(a[4], c4), MUL(a[5], c2)), MUL(a[7], c0)); \
+        b[9]  = SUB(SUB(MUL(a[1], c2), MUL(a[0], c4)), MUL(a[3], c0)); \
+        b[10] = ADD(SUB(MUL(a[12], s4), MUL(a[13], s2)), MUL(a[15], s0)); \
+        b[11] = SUB(SUB(MUL(a[9], s2), MUL(a[8], s4)), MUL(a[11], s0)); \
+        b[12] = SUB(SUB(MUL(a[5], c1), MUL(a[4], c3)), MUL(a[6], c0)); \
+        b[13] = ADD(SUB(MUL(a[0], c3), MUL(a[1], c1)), MUL(a[2], c0)); \
+        b[14] = SUB(SUB(MUL(a[13], s1), MUL(a[12], s3)), MUL(a[14], s0)); \
+        b[15] = ADD(SUB(MUL(a[8], s3), MUL(a[9], s1)), MUL(a[10], s0)); \
+    }
+
+// r holds the upper 3x3 (column c at [c * 3]) of T * R * S
+#define PL__COMPOSE_TRS(T, ADD, SUB, MUL, qx, qy, qz, qw, sx, sy, sz, tOne, tTwo, r) \
+    { \
+        const T xx = MUL(qx, qx); \
+        const T yy = MUL(qy, qy); \
+        const T zz = MUL(qz, qz); \
+        const T xy = MUL(qx, qy); \
+        const T xz = MUL(qx, qz); \
+        const T yz = MUL(qy, qz); \
+        const T xw = MUL(qx, qw); \
+        const T yw = MUL(qy, qw); \
+        const T zw = MUL(qz, qw); \
+        r[0] = MUL(SUB(tOne, MUL(tTwo, ADD(yy, zz))), sx); \
+        r[1] = MUL(MUL(tTwo, ADD(xy, zw)), sx); \
+        r[2] = MUL(MUL(tTwo, SUB(xz, yw)), sx); \
+        r[3] = MUL(MUL(tTwo, SUB(xy, zw)), sy); \
+        r[4] = MUL(SUB(tOne, MUL(tTwo, ADD(xx, zz))), sy); \
+        r[5] = MUL(MUL(tTwo, ADD(yz, xw)), sy); \
+        r[6] = MUL(MUL(tTwo, ADD(xz, yw)), sz); \
+        r[7] = MUL(MUL(tTwo, SUB(yz, xw)), sz); \
+        r[8] = MUL(SUB(tOne, MUL(tTwo, ADD(xx, yy))), sz); \
+    }
+
+// area weighted face normal (r[0-2]) & mikktspace tangent (r[3-5], before normalization &
+// the orientation flip), a holds p0, p1, p2 (xyz), u holds uv0, uv1, uv2
+#define PL__MESH_FACE_FRAME(T, ADD, SUB, MUL, a, u, r, tArea) \
+    { \
+        const T d1x = SUB(a[3], a[0]); const T d1y = SUB(a[4], a[1]); const T d1z = SUB(a[5], a[2]); \
+        const T d2x = SUB(a[6], a[0]); const T d2y = SUB(a[7], a[1]); const T d2z = SUB(a[8], a[2]); \
+        r[0] = SUB(MUL(d1y, d2z), MUL(d1z, d2y)); \
+        r[1] = SUB(MUL(d1z, d2x), MUL(d1x, d2z)); \
+        r[2] = SUB(MUL(d1x, d2y), MUL(d1y, d2x)); \
+        const T t21x = SUB(u[2], u[0]); const T t21y = SUB(u[3], u[1]); \
+        const T t31x = SUB(u[4], u[0]); const T t31y = SUB(u[5], u[1]); \
+        tArea = SUB(MUL(t21x, t31y), MUL(t21y, t31x)); \
+        r[3] = SUB(MUL(t31y, d1x), MUL(t21y, d2x)); \
+        r[4] = SUB(MUL(t31y, d1y), MUL(t21y, d2y)); \
+        r[5] = SUB(MUL(t31y, d1z), MUL(t21y, d2z)); \
+    }
+
+// per corner dot product of the two edges leaving it (c) & their squared lengths
+// multiplied (l), so cos = c / sqrt(l), a holds p0, p1, p2 (xyz)
+#define PL__MESH_CORNER_DOTS(T, ADD, SUB, MUL, a, c, l) \
+    { \
+        const T e01x = SUB(a[3], a[0]); const T e01y = SUB(a[4], a[1]); const T e01z = SUB(a[5], a[2]); \
+        const T e02x = SUB(a[6], a[0]); const T e02y = SUB(a[7], a[1]); const T e02z = SUB(a[8], a[2]); \
+        const T e12x = SUB(a[6], a[3]); const T e12y = SUB(a[7], a[4]); const T e12z = SUB(a[8], a[5]); \
+        const T e10x = SUB(a[0], a[3]); const T e10y = SUB(a[1], a[4]); const T e10z = SUB(a[2], a[5]); \
+        const T l01 = ADD(ADD(MUL(e01x, e01x), MUL(e01y, e01y)), MUL(e01z, e01z)); \
+        const T l02 = ADD(ADD(MUL(e02x, e02x), MUL(e02y, e02y)), MUL(e02z, e02z)); \
+        const T l12 = ADD(ADD(MUL(e12x, e12x), MUL(e12y, e12y)), MUL(e12z, e12z)); \
+        c[0] = ADD(ADD(MUL(e01x, e02x), MUL(e01y, e02y)), MUL(e01z, e02z)); \
+        c[1] = ADD(ADD(MUL(e10x, e12x), MUL(e10y, e12y)), MUL(e10z, e12z)); \
+        c[2] = ADD(ADD(MUL(e02x, e12x), MUL(e02y, e12y)), MUL(e02z, e12z)); \
+        l[0] = MUL(l01, l02); \
+        l[1] = MUL(l01, l12); \
+        l[2] = MUL(l02, l12); \
+    }
+
+#define PL__ADDF(a, b) ((a) + (b))
+#define PL__SUBF(a, b) ((a) - (b))
+#define PL__MULF(a, b) ((a) * (b))
+
+static void
+pl__mul_mat4_scalar(const plMat4* atA, const plMat4* atB, plMat4* atOut, uint32_t uCount)
+{
+    for(uint32_t i = 0; i < uCount; i++)
+    {
+        plMat4 tResult;
+        for(uint32_t j = 0; j < 4; j++)
+        {
+            for(uint32_t k = 0; k < 4; k++)
+            {
+                tResult.col[j].d[k] =
+                    atA[i].col[0].d[k] * atB[i].col[j].d[0] +
+                    atA[i].col[1].d[k] * atB[i].col[j].d[1] +
+                    atA[i].col[2].d[k] * atB[i].col[j].d[2] +
+                    atA[i].col[3].d[k] * atB[i].col[j].d[3];
+            }
+        }
+        atOut[i] = tResult;
+    }
+}
+
+static void
+pl__compose_trs_scalar(const plVec3* atScales, const plVec4* atRotations, const plVec3* atTranslations, plMat4* atOut, uint32_t uCount)
+{
+    for(uint32_t i = 0; i < uCount; i++)
+    {
+        const plVec4 tQ = atRotations[i];
+        const plVec3 tS = atScales[i];
+        float afR[9];
+        PL__COMPOSE_TRS(float, PL__ADDF, PL__SUBF, PL__MULF, tQ.x, tQ.y, tQ.z, tQ.w, tS.x, tS.y, tS.z, 1.0f, 2.0f, afR);
+        atOut[i] = (plMat4){.col = {
+            {.x = afR[0], .y = afR[1], .z = afR[2], .w = 0.0f},
+            {.x = afR[3], .y = afR[4], .z = afR[5], .w = 0.0f},
+            {.x = afR[6], .y = afR[7], .z = afR[8], .w = 0.0f},
+            {.x = atTranslations[i].x, .y = atTranslations[i].y, .z = atTranslations[i].z, .w = 1.0f}
+        }};
+    }
+}
+
+static void
+pl__invert_mat4_scalar(const plMat4* atMats, plMat4* atOut, uint32_t uCount)
+{
+    for(uint32_t i = 0; i < uCount; i++)
+    {
+        const float* a = atMats[i].d;
+        float b[16];
+        float fDet = 0.0f;
+        PL__INVERT_4X4(float, PL__ADDF, PL__SUBF, PL__MULF, a, b, fDet);
+        const float fInvDet = 1.0f / fDet;
+        for(uint32_t j = 0; j < 16; j++)
+            atOut[i].d[j] = b[j] * fInvDet;
+    }
+}
+
+static void
+pl__mesh_faces_scalar(const plMeshFaceStreams* ptStreams, uint32_t uFirstFace, uint32_t uFaceCount)
+{
+    const bool bTangents = ptStreams->atUVs != NULL;
+    for(uint32_t f = uFirstFace; f < uFirstFace + uFaceCount; f++)
+    {
+        float a[9];
+        float u[6] = {0};
+        for(uint32_t c = 0; c < 3; c++)
+        {
+            const uint32_t uVertex = ptStreams->auIndices[f * 3 + c];
+            a[c * 3 + 0] = ptStreams->atPositions[uVertex].x;
+            a[c * 3 + 1] = ptStreams->atPositions[uVertex].y;
+            a[c * 3 + 2] = ptStreams->atPositions[uVertex].z;
+            if(bTangents)
+            {
+                u[c * 2 + 0] = ptStreams->atUVs[uVertex].x;
+                u[c * 2 + 1] = ptStreams->atUVs[uVertex].y;
+            }
+        }
+        float r[6];
+        float fArea;
+        PL__MESH_FACE_FRAME(float, PL__ADDF, PL__SUBF, PL__MULF, a, u, r, fArea);
+        for(uint32_t i = 0; i < 3; i++)
+            ptStreams->apfFaces[i][f] = r[i];
+        if(!bTangents)
+            continue;
+
+        // mirrored uvs flip the direction back to dP/du
+        const float fLength = sqrtf(r[3] * r[3] + r[4] * r[4] + r[5] * r[5]);
+        const float fSign = fArea < 0.0f ? -1.0f : 1.0f;
+        const float fOrientation = fabsf(fArea) > FLT_MIN && fLength > 0.0f ? fSign : 0.0f;
+        for(uint32_t i = 3; i < 6; i++)
+            ptStreams->apfFaces[i][f] = fOrientation != 0.0f ? r[i] * fSign / fLength : 0.0f;
+
+        float c[3];
+        float l[3];
+        PL__MESH_CORNER_DOTS(float, PL__ADDF, PL__SUBF, PL__MULF, a, c, l);
+        for(uint32_t i = 0; i < 3; i++)
+            ptStreams->apfFaces[6 + i][f] = fOrientation != 0.0f && l[i] > 0.0f ? fOrientation * pl__acos_approx(c[i] / sqrtf(l[i])) : 0.0f;
+    }
+}
+
+#ifdef PL_ECS_SIMD_X86
+
+static bool
+pl__cpu_supports_avx2(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int aiInfo[4];
+    __cpuid(aiInfo, 1);
+    const bool bFma     = (aiInfo[2] & (1 << 12)) != 0;
+    const bool bOsxsave = (aiInfo[2] & (1 << 27)) != 0;
+    if(!bFma || !bOsxsave || (_xgetbv(0) & 0x6) != 0x6) // os saves ymm state
+        return false;
+    __cpuidex(aiInfo, 7, 0);
+    return (aiInfo[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+// lane i of atOut[c * 4 + r] = column c, row r of atMats[i]
+static inline void
+pl__load_mat4_lanes_sse(const plMat4* atMats, __m128* atOut)
+{
+    for(uint32_t c = 0; c < 4; c++)
+    {
+        __m128 t0 = _mm_loadu_ps(&atMats[0].d[c * 4]);
+        __m128 t1 = _mm_loadu_ps(&atMats[1].d[c * 4]);
+        __m128 t2 = _mm_loadu_ps(&atMats[2].d[c * 4]);
+        __m128 t3 = _mm_loadu_ps(&atMats[3].d[c * 4]);
+        _MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+        atOut[c * 4 + 0] = t0;
+        atOut[c * 4 + 1] = t1;
+        atOut[c * 4 + 2] = t2;
+        atOut[c * 4 + 3] = t3;
+    }
+}
+
+static inline void
+pl__store_mat4_lanes_sse(const __m128* atLanes, plMat4* atOut)
+{
+    for(uint32_t c = 0; c < 4; c++)
+    {
+        __m128 t0 = atLanes[c * 4 + 0];
+        __m128 t1 = atLanes[c * 4 + 1];
+        __m128 t2 = atLanes[c * 4 + 2];
+        __m128 t3 = atLanes[c * 4 + 3];
+        _MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+        _mm_storeu_ps(&atOut[0].d[c * 4], t0);
+        _mm_storeu_ps(&atOut[1].d[c * 4], t1);
+        _mm_storeu_ps(&atOut[2].d[c * 4], t2);
+        _mm_storeu_ps(&atOut[3].d[c * 4], t3);
+    }
+}
+
+// 3 lane vectors (+ w) of a trs result back into columns of 4 matrices
+static inline void
+pl__store_trs_column_sse(__m128 tX, __m128 tY, __m128 tZ, __m128 tW, plMat4* atOut, uint32_t uColumn)
+{
+    _MM_TRANSPOSE4_PS(tX, tY, tZ, tW);
+    _mm_storeu_ps(&atOut[0].d[uColumn * 4], tX);
+    _mm_storeu_ps(&atOut[1].d[uColumn * 4], tY);
+    _mm_storeu_ps(&atOut[2].d[uColumn * 4], tZ);
+    _mm_storeu_ps(&atOut[3].d[uColumn * 4], tW);
+}
+
+static void
+pl__mul_mat4_sse(const plMat4* atA, const plMat4* atB, plMat4* atOut, uint32_t uCount)
+{
+    for(uint32_t i = 0; i < uCount; i++)
+    {
+        const __m128 tA0 = _mm_loadu_ps(&atA[i].d[0]);
+        const __m128 tA1 = _mm_loadu_ps(&atA[i].d[4]);
+        const __m128 tA2 = _mm_loadu_ps(&atA[i].d[8]);
+        const __m128 tA3 = _mm_loadu_ps(&atA[i].d[12]);
+        __m128 atResult[4];
+        for(uint32_t j = 0; j < 4; j++)
+        {
+            const __m128 tB = _mm_loadu_ps(&atB[i].d[j * 4]);
+            __m128 tColumn = _mm_mul_ps(tA0, _mm_shuffle_ps(tB, tB, _MM_SHUFFLE(0, 0, 0, 0)));
+            tColumn = _mm_add_ps(tColumn, _mm_mul_ps(tA1, _mm_shuffle_ps(tB, tB, _MM_SHUFFLE(1, 1, 1, 1))));
+            tColumn = _mm_add_ps(tColumn, _mm_mul_ps(tA2, _mm_shuffle_ps(tB, tB, _MM_SHUFFLE(2, 2, 2, 2))));
+            tColumn = _mm_add_ps(tColumn, _mm_mul_ps(tA3, _mm_shuffle_ps(tB, tB, _MM_SHUFFLE(3, 3, 3, 3))));
+            atResult[j] = tColumn;
+        }
+        for(uint32_t j = 0; j < 4; j++)
+            _mm_storeu_ps(&atOut[i].d[j * 4], atResult[j]);
+    }
+}
+
+static void
+pl__compose_trs_sse(const plVec3* atScales, const plVec4* atRotations, const plVec3* atTranslations, plMat4* atOut, uint32_t uCount)
+{
+    const uint32_t uLaneCount = uCount & ~3u;
+    const __m128 tOne  = _mm_set1_ps(1.0f);
+    const __m128 tTwo  = _mm_set1_ps(2.0f);
+    const __m128 tZero = _mm_setzero_ps();
+    for(uint32_t i = 0; i < uLaneCount; i += 4)
+    {
+        __m128 tQX = _mm_loadu_ps(&atRotations[i + 0].x);
+        __m128 tQY = _mm_loadu_ps(&atRotations[i + 1].x);
+        __m128 tQZ = _mm_loadu_ps(&atRotations[i + 2].x);
+        __m128 tQW = _mm_loadu_ps(&atRotations[i + 3].x);
+        _MM_TRANSPOSE4_PS(tQX, tQY, tQZ, tQW);
+        const __m128 tSX = _mm_setr_ps(atScales[i].x, atScales[i + 1].x, atScales[i + 2].x, atScales[i + 3].x);
+        const __m128 tSY = _mm_setr_ps(atScales[i].y, atScales[i + 1].y, atScales[i + 2].y, atScales[i + 3].y);
+        const __m128 tSZ = _mm_setr_ps(atScales[i].z, atScales[i + 1].z, atScales[i + 2].z, atScales[i + 3].z);
+
+        __m128 atR[9];
+        PL__COMPOSE_TRS(__m128, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, tQX, tQY, tQZ, tQW, tSX, tSY, tSZ, tOne, tTwo, atR);
+        pl__store_trs_column_sse(atR[0], atR[1], atR[2], tZero, &atOut[i], 0);
+        pl__store_trs_column_sse(atR[3], atR[4], atR[5], tZero, &atOut[i], 1);
+        pl__store_trs_column_sse(atR[6], atR[7], atR[8], tZero, &atOut[i], 2);
+        for(uint32_t j = 0; j < 4; j++)
+            atOut[i + j].col[3] = (plVec4){.x = atTranslations[i + j].x, .y = atTranslations[i + j].y, .z = atTranslations[i + j].z, .w = 1.0f};
+    }
+    pl__compose_trs_scalar(&atScales[uLaneCount], &atRotations[uLaneCount], &atTranslations[uLaneCount], &atOut[uLaneCount], uCount - uLaneCount);
+}
+
+static void
+pl__invert_mat4_sse(const plMat4* atMats, plMat4* atOut, uint32_t uCount)
+{
+    const uint32_t uLaneCount = uCount & ~3u;
+    const __m128 tOne = _mm_set1_ps(1.0f);
+    for(uint32_t i = 0; i < uLaneCount; i += 4)
+    {
+        __m128 a[16];
+        __m128 b[16];
+        __m128 tDet;
+        pl__load_mat4_lanes_sse(&atMats[i], a);
+        PL__INVERT_4X4(__m128, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, a, b, tDet);
+        const __m128 tInvDet = _mm_div_ps(tOne, tDet);
+        for(uint32_t j = 0; j < 16; j++)
+            b[j] = _mm_mul_ps(b[j], tInvDet);
+        pl__store_mat4_lanes_sse(b, &atOut[i]);
+    }
+    pl__invert_mat4_scalar(&atMats[uLaneCount], &atOut[uLaneCount], uCount - uLaneCount);
+}
+
+// pl__acos_approx over 4 lanes
+static inline __m128
+pl__acos_approx_sse(__m128 tCos)
+{
+    const __m128 tX = _mm_min_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), tCos), _mm_set1_ps(1.0f));
+    __m128 tPoly = _mm_add_ps(_mm_mul_ps(tX, _mm_set1_ps(-0.0187293f)), _mm_set1_ps(0.0742610f));
+    tPoly = _mm_add_ps(_mm_mul_ps(tX, tPoly), _mm_set1_ps(-0.2121144f));
+    tPoly = _mm_add_ps(_mm_mul_ps(tX, tPoly), _mm_set1_ps(1.5707288f));
+    const __m128 tAngle = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), tX)), tPoly);
+    const __m128 tNegative = _mm_cmplt_ps(tCos, _mm_setzero_ps());
+    return _mm_or_ps(_mm_and_ps(tNegative, _mm_sub_ps(_mm_set1_ps(PL_PI), tAngle)), _mm_andnot_ps(tNegative, tAngle));
+}
+
+static void
+pl__mesh_faces_sse(const plMeshFaceStreams* ptStreams, uint32_t uFirstFace, uint32_t uFaceCount)
+{
+    const bool bTangents = ptStreams->atUVs != NULL;
+    const uint32_t uLaneCount = uFaceCount & ~3u;
+    const __m128 tSignMask = _mm_set1_ps(-0.0f);
+    const __m128 tOne      = _mm_set1_ps(1.0f);
+    const __m128 tMinArea  = _mm_set1_ps(FLT_MIN);
+    const __m128 tZero     = _mm_setzero_ps();
+    for(uint32_t f = uFirstFace; f < uFirstFace + uLaneCount; f += 4)
+    {
+        const uint32_t* auIndices = &ptStreams->auIndices[f * 3];
+        __m128 a[9];
+        __m128 u[6];
+        for(uint32_t c = 0; c < 3; c++)
+        {
+            const plVec3* pt0 = &ptStreams->atPositions[auIndices[c]];
+            const plVec3* pt1 = &ptStreams->atPositions[auIndices[3 + c]];
+            const plVec3* pt2 = &ptStreams->atPositions[auIndices[6 + c]];
+            const plVec3* pt3 = &ptStreams->atPositions[auIndices[9 + c]];
+            a[c * 3 + 0] = _mm_setr_ps(pt0->x, pt1->x, pt2->x, pt3->x);
+            a[c * 3 + 1] = _mm_setr_ps(pt0->y, pt1->y, pt2->y, pt3->y);
+            a[c * 3 + 2] = _mm_setr_ps(pt0->z, pt1->z, pt2->z, pt3->z);
+            u[c * 2 + 0] = tZero;
+            u[c * 2 + 1] = tZero;
+            if(bTangents)
+            {
+                const plVec2* ptUV0 = &ptStreams->atUVs[auIndices[c]];
+                const plVec2* ptUV1 = &ptStreams->atUVs[auIndices[3 + c]];
+                const plVec2* ptUV2 = &ptStreams->atUVs[auIndices[6 + c]];
+                const plVec2* ptUV3 = &ptStreams->atUVs[auIndices[9 + c]];
+                u[c * 2 + 0] = _mm_setr_ps(ptUV0->x, ptUV1->x, ptUV2->x, ptUV3->x);
+                u[c * 2 + 1] = _mm_setr_ps(ptUV0->y, ptUV1->y, ptUV2->y, ptUV3->y);
+            }
+        }
+        __m128 r[6];
+        __m128 tArea;
+        PL__MESH_FACE_FRAME(__m128, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, a, u, r, tArea);
+        for(uint32_t i = 0; i < 3; i++)
+            _mm_storeu_ps(&ptStreams->apfFaces[i][f], r[i]);
+        if(!bTangents)
+            continue;
+
+        const __m128 tLength2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r[3], r[3]), _mm_mul_ps(r[4], r[4])), _mm_mul_ps(r[5], r[5]));
+        const __m128 tValid = _mm_and_ps(_mm_cmpgt_ps(_mm_andnot_ps(tSignMask, tArea), tMinArea), _mm_cmpgt_ps(tLength2, tZero));
+        const __m128 tSign = _mm_or_ps(_mm_and_ps(tArea, tSignMask), tOne);
+        const __m128 tScale = _mm_and_ps(tValid, _mm_div_ps(tSign, _mm_sqrt_ps(tLength2)));
+        for(uint32_t i = 3; i < 6; i++)
+            _mm_storeu_ps(&ptStreams->apfFaces[i][f], _mm_mul_ps(r[i], tScale));
+
+        __m128 c[3];
+        __m128 l[3];
+        PL__MESH_CORNER_DOTS(__m128, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, a, c, l);
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            const __m128 tCornerValid = _mm_and_ps(tValid, _mm_cmpgt_ps(l[i], tZero));
+            const __m128 tAngle = pl__acos_approx_sse(_mm_div_ps(c[i], _mm_sqrt_ps(l[i])));
+            _mm_storeu_ps(&ptStreams->apfFaces[6 + i][f], _mm_and_ps(tCornerValid, _mm_xor_ps(tAngle, _mm_and_ps(tArea, tSignMask))));
+        }
+    }
+    pl__mesh_faces_scalar(ptStreams, uFirstFace + uLaneCount, uFaceCount - uLaneCount);
+}
+
+// avx2 lanes are two sse lane sets (matrices 0-3 low, 4-7 high)
+static PL_ECS_TARGET_AVX2 void
+pl__load_mat4_lanes_avx2(const plMat4* atMats, __m256* atOut)
+{
+    __m128 atLow[16];
+    __m128 atHigh[16];
+    pl__load_mat4_lanes_sse(&atMats[0], atLow);
+    pl__load_mat4_lanes_sse(&atMats[4], atHigh);
+    for(uint32_t j = 0; j < 16; j++)
+        atOut[j] = _mm256_insertf128_ps(_mm256_castps128_ps256(atLow[j]), atHigh[j], 1);
+}
+
+static PL_ECS_TARGET_AVX2 void
+pl__store_mat4_lanes_avx2(const __m256* atLanes, plMat4* atOut)
+{
+    __m128 atLow[16];
+    __m128 atHigh[16];
+    for(uint32_t j = 0; j < 16; j++)
+    {
+        atLow[j]  = _mm256_castps256_ps128(atLanes[j]);
+        atHigh[j] = _mm256_extractf128_ps(atLanes[j], 1);
+    }
+    pl__store_mat4_lanes_sse(atLow, &atOut[0]);
+    pl__store_mat4_lanes_sse(atHigh, &atOut[4]);
+}
+
+static PL_ECS_TARGET_AVX2 void
+pl__mul_mat4_avx2(const plMat4* atA, const plMat4* atB, plMat4* atOut, uint32_t uCount)
+{
+    // two result columns per register, a's columns repeated in both halves
+    for(uint32_t i = 0; i < uCount; i++)
+    {
+        const __m256 tA0 = _mm256_broadcast_ps((const __m128*)&atA[i].d[0]);
+        const __m256 tA1 = _mm256_broadcast_ps((const __m128*)&atA[i].d[4]);
+        const __m256 tA2 = _mm256_broadcast_ps((const __m128*)&atA[i].d[8]);
+        const __m256 tA3 = _mm256_broadcast_ps((const __m128*)&atA[i].d[12]);
+        const __m256 tB01 = _mm256_loadu_ps(&atB[i].d[0]);
+        const __m256 tB23 = _mm256_loadu_ps(&atB[i].d[8]);
+
+        __m256 tC01 = _mm256_mul_ps(tA0, _mm256_permute_ps(tB01, 0x00));
+        tC01 = _mm256_fmadd_ps(tA1, _mm256_permute_ps(tB01, 0x55), tC01);
+        tC01 = _mm256_fmadd_ps(tA2, _mm256_permute_ps(tB01, 0xaa), tC01);
+        tC01 = _mm256_fmadd_ps(tA3, _mm256_permute_ps(tB01, 0xff), tC01);
+
+        __m256 tC23 = _mm256_mul_ps(tA0, _mm256_permute_ps(tB23, 0x00));
+        tC23 = _mm256_fmadd_ps(tA1, _mm256_permute_ps(tB23, 0x55), tC23);
+        tC23 = _mm256_fmadd_ps(tA2, _mm256_permute_ps(tB23, 0xaa), tC23);
+        tC23 = _mm256_fmadd_ps(tA3, _mm256_permute_ps(tB23, 0xff), tC23);
+
+        _mm256_storeu_ps(&atOut[i].d[0], tC01);
+        _mm256_storeu_ps(&atOut[i].d[8], tC23);
+    }
+}
+
+static PL_ECS_TARGET_AVX2 void
+pl__compose_trs_avx2(const plVec3* atScales, const plVec4* atRotations, const plVec3* atTranslations, plMat4* atOut, uint32_t uCount)
+{
+    const uint32_t uLaneCount = uCount & ~7u;
+    const __m256 tOne = _mm256_set1_ps(1.0f);
+    const __m256 tTwo = _mm256_set1_ps(2.0f);
+    const __m128 tZero = _mm_setzero_ps();
+    for(uint32_t i = 0; i < uLaneCount; i += 8)
+    {
+        __m128 atQ[8];
+        for(uint32_t j = 0; j < 8; j++)
+            atQ[j] = _mm_loadu_ps(&atRotations[i + j].x);
+        _MM_TRANSPOSE4_PS(atQ[0], atQ[1], atQ[2], atQ[3]);
+        _MM_TRANSPOSE4_PS(atQ[4], atQ[5], atQ[6], atQ[7]);
+        const __m256 tQX = _mm256_insertf128_ps(_mm256_castps128_ps256(atQ[0]), atQ[4], 1);
+        const __m256 tQY = _mm256_insertf128_ps(_mm256_castps128_ps256(atQ[1]), atQ[5], 1);
+        const __m256 tQZ = _mm256_insertf128_ps(_mm256_castps128_ps256(atQ[2]), atQ[6], 1);
+        const __m256 tQW = _mm256_insertf128_ps(_mm256_castps128_ps256(atQ[3]), atQ[7], 1);
+        const plVec3* atS = &atScales[i];
+        const __m256 tSX = _mm256_setr_ps(atS[0].x, atS[1].x, atS[2].x, atS[3].x, atS[4].x, atS[5].x, atS[6].x, atS[7].x);
+        const __m256 tSY = _mm256_setr_ps(atS[0].y, atS[1].y, atS[2].y, atS[3].y, atS[4].y, atS[5].y, atS[6].y, atS[7].y);
+        const __m256 tSZ = _mm256_setr_ps(atS[0].z, atS[1].z, atS[2].z, atS[3].z, atS[4].z, atS[5].z, atS[6].z, atS[7].z);
+
+        __m256 atR[9];
+        PL__COMPOSE_TRS(__m256, _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, tQX, tQY, tQZ, tQW, tSX, tSY, tSZ, tOne, tTwo, atR);
+        for(uint32_t c = 0; c < 3; c++)
+        {
+            pl__store_trs_column_sse(_mm256_castps256_ps128(atR[c * 3]), _mm256_castps256_ps128(atR[c * 3 + 1]), _mm256_castps256_ps128(atR[c * 3 + 2]), tZero, &atOut[i], c);
+            pl__store_trs_column_sse(_mm256_extractf128_ps(atR[c * 3], 1), _mm256_extractf128_ps(atR[c * 3 + 1], 1), _mm256_extractf128_ps(atR[c * 3 + 2], 1), tZero, &atOut[i + 4], c);
+        }
+        for(uint32_t j = 0; j < 8; j++)
+            atOut[i + j].col[3] = (plVec4){.x = atTranslations[i + j].x, .y = atTranslations[i + j].y, .z = atTranslations[i + j].z, .w = 1.0f};
+    }
+    pl__compose_trs_sse(&atScales[uLaneCount], &atRotations[uLaneCount], &atTranslations[uLaneCount], &atOut[uLaneCount], uCount - uLaneCount);
+}
+
+static PL_ECS_TARGET_AVX2 void
+pl__invert_mat4_avx2(const plMat4* atMats, plMat4* atOut, uint32_t uCount)
+{
+    const uint32_t uLaneCount = uCount & ~7u;
+    const __m256 tOne = _mm256_set1_ps(1.0f);
+    for(uint32_t i = 0; i < uLaneCount; i += 8)
+    {
+        __m256 a[16];
+        __m256 b[16];
+        __m256 tDet;
+        pl__load_mat4_lanes_avx2(&atMats[i], a);
+        PL__INVERT_4X4(__m256, _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, a, b, tDet);
+        const __m256 tInvDet = _mm256_div_ps(tOne, tDet);
+        for(uint32_t j = 0; j < 16; j++)
+            b[j] = _mm256_mul_ps(b[j], tInvDet);
+        pl__store_mat4_lanes_avx2(b, &atOut[i]);
+    }
+    pl__invert_mat4_sse(&atMats[uLaneCount], &atOut[uLaneCount], uCount - uLaneCount);
+}
+
+
+#endif // PL_ECS_SIMD_X86
+
+#ifdef PL_ECS_SIMD_NEON
+
+static inline void
+pl__transpose4_neon(float32x4_t* ptR0, float32x4_t* ptR1, float32x4_t* ptR2, float32x4_t* ptR3)
+{
+    const float32x4x2_t t01 = vtrnq_f32(*ptR0, *ptR1);
+    const float32x4x2_t t23 = vtrnq_f32(*ptR2, *ptR3);
+    *ptR0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    *ptR1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    *ptR2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    *ptR3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+static void
+pl__mul_mat4_neon(const plMat4* atA, const plMat4* atB, plMat4* atOut, uint32_t uCount)
+{
+    for(uint32_t i = 0; i < uCount; i++)
+    {
+        const float32x4_t tA0 = vld1q_f32(&atA[i].d[0]);
+        const float32x4_t tA1 = vld1q_f32(&atA[i].d[4]);
+        const float32x4_t tA2 = vld1q_f32(&atA[i].d[8]);
+        const float32x4_t tA3 = vld1q_f32(&atA[i].d[12]);
+        float32x4_t atResult[4];
+        for(uint32_t j = 0; j < 4; j++)
+        {
+            const float32x4_t tB = vld1q_f32(&atB[i].d[j * 4]);
+            float32x4_t tColumn = vmulq_laneq_f32(tA0, tB, 0);
+            tColumn = vfmaq_laneq_f32(tColumn, tA1, tB, 1);
+            tColumn = vfmaq_laneq_f32(tColumn, tA2, tB, 2);
+            tColumn = vfmaq_laneq_f32(tColumn, tA3, tB, 3);
+            atResult[j] = tColumn;
+        }
+        for(uint32_t j = 0; j < 4; j++)
+            vst1q_f32(&atOut[i].d[j * 4], atResult[j]);
+    }
+}
+
+static void
+pl__compose_trs_neon(const plVec3* atScales, const plVec4* atRotations, const plVec3* atTranslations, plMat4* atOut, uint32_t uCount)
+{
+    const uint32_t uLaneCount = uCount & ~3u;
+    const float32x4_t tOne  = vdupq_n_f32(1.0f);
+    const float32x4_t tTwo  = vdupq_n_f32(2.0f);
+    for(uint32_t i = 0; i < uLaneCount; i += 4)
+    {
+        float32x4_t tQX = vld1q_f32(&atRotations[i + 0].x);
+        float32x4_t tQY = vld1q_f32(&atRotations[i + 1].x);
+        float32x4_t tQZ = vld1q_f32(&atRotations[i + 2].x);
+        float32x4_t tQW = vld1q_f32(&atRotations[i + 3].x);
+        pl__transpose4_neon(&tQX, &tQY, &tQZ, &tQW);
+        const float afSX[4] = {atScales[i].x, atScales[i + 1].x, atScales[i + 2].x, atScales[i + 3].x};
+        const float afSY[4] = {atScales[i].y, atScales[i + 1].y, atScales[i + 2].y, atScales[i + 3].y};
+        const float afSZ[4] = {atScales[i].z, atScales[i + 1].z, atScales[i + 2].z, atScales[i + 3].z};
+        const float32x4_t tSX = vld1q_f32(afSX);
+        const float32x4_t tSY = vld1q_f32(afSY);
+        const float32x4_t tSZ = vld1q_f32(afSZ);
+
+        float32x4_t atR[9];
+        PL__COMPOSE_TRS(float32x4_t, vaddq_f32, vsubq_f32, vmulq_f32, tQX, tQY, tQZ, tQW, tSX, tSY, tSZ, tOne, tTwo, atR);
+        for(uint32_t c = 0; c < 3; c++)
+        {
+            float32x4_t tX = atR[c * 3];
+            float32x4_t tY = atR[c * 3 + 1];
+            float32x4_t tZ = atR[c * 3 + 2];
+            float32x4_t tW = vdupq_n_f32(0.0f);
+            pl__transpose4_neon(&tX, &tY, &tZ, &tW);
+            vst1q_f32(&atOut[i + 0].d[c * 4], tX);
+            vst1q_f32(&atOut[i + 1].d[c * 4], tY);
+            vst1q_f32(&atOut[i + 2].d[c * 4], tZ);
+            vst1q_f32(&atOut[i + 3].d[c * 4], tW);
+        }
+        for(uint32_t j = 0; j < 4; j++)
+            atOut[i + j].col[3] = (plVec4){.x = atTranslations[i + j].x, .y = atTranslations[i + j].y, .z = atTranslations[i + j].z, .w = 1.0f};
+    }
+    pl__compose_trs_scalar(&atScales[uLaneCount], &atRotations[uLaneCount], &atTranslations[uLaneCount], &atOut[uLaneCount], uCount - uLaneCount);
+}
+
+static void
+pl__invert_mat4_neon(const plMat4* atMats, plMat4* atOut, uint32_t uCount)
+{
+    const uint32_t uLaneCount = uCount & ~3u;
+    for(uint32_t i = 0; i < uLaneCount; i += 4)
+    {
+        float32x4_t a[16];
+        float32x4_t b[16];
+        float32x4_t tDet;
+        for(uint32_t c = 0; c < 4; c++)
+        {
+            for(uint32_t j = 0; j < 4; j++)
+                a[c * 4 + j] = vld1q_f32(&atMats[i + j].d[c * 4]);
+            pl__transpose4_neon(&a[c * 4], &a[c * 4 + 1], &a[c * 4 + 2], &a[c * 4 + 3]);
+        }
+        PL__INVERT_4X4(float32x4_t, vaddq_f32, vsubq_f32, vmulq_f32, a, b, tDet);
+        const float32x4_t tInvDet = vdivq_f32(vdupq_n_f32(1.0f), tDet);
+        for(uint32_t c = 0; c < 4; c++)
+        {
+            for(uint32_t j = 0; j < 4; j++)
+                b[c * 4 + j] = vmulq_f32(b[c * 4 + j], tInvDet);
+            pl__transpose4_neon(&b[c * 4], &b[c * 4 + 1], &b[c * 4 + 2], &b[c * 4 + 3]);
+            for(uint32_t j = 0; j < 4; j++)
+                vst1q_f32(&atOut[i + j].d[c * 4], b[c * 4 + j]);
+        }
+    }
+    pl__invert_mat4_scalar(&atMats[uLaneCount], &atOut[uLaneCount], uCount - uLaneCount);
+}
+
+static inline float32x4_t
+pl__set_lanes_neon(float f0, float f1, float f2, float f3)
+{
+    const float afLanes[4] = {f0, f1, f2, f3};
+    return vld1q_f32(afLanes);
+}
+
+// pl__acos_approx over 4 lanes
+static inline float32x4_t
+pl__acos_approx_neon(float32x4_t tCos)
+{
+    const float32x4_t tX = vminq_f32(vabsq_f32(tCos), vdupq_n_f32(1.0f));
+    float32x4_t tPoly = vfmaq_f32(vdupq_n_f32(0.0742610f), tX, vdupq_n_f32(-0.0187293f));
+    tPoly = vfmaq_f32(vdupq_n_f32(-0.2121144f), tX, tPoly);
+    tPoly = vfmaq_f32(vdupq_n_f32(1.5707288f), tX, tPoly);
+    const float32x4_t tAngle = vmulq_f32(vsqrtq_f32(vsubq_f32(vdupq_n_f32(1.0f), tX)), tPoly);
+    return vbslq_f32(vcltq_f32(tCos, vdupq_n_f32(0.0f)), vsubq_f32(vdupq_n_f32(PL_PI), tAngle), tAngle);
+}
+
+static void
+pl__mesh_faces_neon(const plMeshFaceStreams* ptStreams, uint32_t uFirstFace, uint32_t uFaceCount)
+{
+    const bool bTangents = ptStreams->atUVs != NULL;
+    const uint32_t uLaneCount = uFaceCount & ~3u;
+    const float32x4_t tOne      = vdupq_n_f32(1.0f);
+    const float32x4_t tMinusOne = vdupq_n_f32(-1.0f);
+    const float32x4_t tMinArea  = vdupq_n_f32(FLT_MIN);
+    const float32x4_t tZero     = vdupq_n_f32(0.0f);
+    for(uint32_t f = uFirstFace; f < uFirstFace + uLaneCount; f += 4)
+    {
+        const uint32_t* auIndices = &ptStreams->auIndices[f * 3];
+        float32x4_t a[9];
+        float32x4_t u[6];
+        for(uint32_t c = 0; c < 3; c++)
+        {
+            const plVec3* pt0 = &ptStreams->atPositions[auIndices[c]];
+            const plVec3* pt1 = &ptStreams->atPositions[auIndices[3 + c]];
+            const plVec3* pt2 = &ptStreams->atPositions[auIndices[6 + c]];
+            const plVec3* pt3 = &ptStreams->atPositions[auIndices[9 + c]];
+            a[c * 3 + 0] = pl__set_lanes_neon(pt0->x, pt1->x, pt2->x, pt3->x);
+            a[c * 3 + 1] = pl__set_lanes_neon(pt0->y, pt1->y, pt2->y, pt3->y);
+            a[c * 3 + 2] = pl__set_lanes_neon(pt0->z, pt1->z, pt2->z, pt3->z);
+            u[c * 2 + 0] = tZero;
+            u[c * 2 + 1] = tZero;
+            if(bTangents)
+            {
+                const plVec2* ptUV0 = &ptStreams->atUVs[auIndices[c]];
+                const plVec2* ptUV1 = &ptStreams->atUVs[auIndices[3 + c]];
+                const plVec2* ptUV2 = &ptStreams->atUVs[auIndices[6 + c]];
+                const plVec2* ptUV3 = &ptStreams->atUVs[auIndices[9 + c]];
+                u[c * 2 + 0] = pl__set_lanes_neon(ptUV0->x, ptUV1->x, ptUV2->x, ptUV3->x);
+                u[c * 2 + 1] = pl__set_lanes_neon(ptUV0->y, ptUV1->y, ptUV2->y, ptUV3->y);
+            }
+        }
+        float32x4_t r[6];
+        float32x4_t tArea;
+        PL__MESH_FACE_FRAME(float32x4_t, vaddq_f32, vsubq_f32, vmulq_f32, a, u, r, tArea);
+        for(uint32_t i = 0; i < 3; i++)
+            vst1q_f32(&ptStreams->apfFaces[i][f], r[i]);
+        if(!bTangents)
+            continue;
+
+        const float32x4_t tLength2 = vfmaq_f32(vfmaq_f32(vmulq_f32(r[3], r[3]), r[4], r[4]), r[5], r[5]);
+        const uint32x4_t tValid = vandq_u32(vcagtq_f32(tArea, tMinArea), vcgtq_f32(tLength2, tZero));
+        const float32x4_t tSign = vbslq_f32(vcltq_f32(tArea, tZero), tMinusOne, tOne);
+        const float32x4_t tScale = vbslq_f32(tValid, vdivq_f32(tSign, vsqrtq_f32(tLength2)), tZero);
+        for(uint32_t i = 3; i < 6; i++)
+            vst1q_f32(&ptStreams->apfFaces[i][f], vmulq_f32(r[i], tScale));
+
+        float32x4_t c[3];
+        float32x4_t l[3];
+        PL__MESH_CORNER_DOTS(float32x4_t, vaddq_f32, vsubq_f32, vmulq_f32, a, c, l);
+        for(uint32_t i = 0; i < 3; i++)
+        {
+            const uint32x4_t tCornerValid = vandq_u32(tValid, vcgtq_f32(l[i], tZero));
+            const float32x4_t tAngle = pl__acos_approx_neon(vdivq_f32(c[i], vsqrtq_f32(l[i])));
+            vst1q_f32(&ptStreams->apfFaces[6 + i][f], vbslq_f32(tCornerValid, vmulq_f32(tSign, tAngle), tZero));
+        }
+    }
+    pl__mesh_faces_scalar(ptStreams, uFirstFace + uLaneCount, uFaceCount - uLaneCount);
+}
+
+#endif // PL_ECS_SIMD_NEON
+
+static bool
+pl__set_transform_backend(plTransformBackend tBackend)
+{
+    if(tBackend == PL_TRANSFORM_BACKEND_AUTO)
+    {
+        static const plTransformBackend atPreferred[] = {
+            PL_TRANSFORM_BACKEND_AVX2,
+            PL_TRANSFORM_BACKEND_NEON,
+            PL_TRANSFORM_BACKEND_SSE,
+            PL_TRANSFORM_BACKEND_SCALAR
+        };
+        for(uint32_t i = 0; i < sizeof(atPreferred) / sizeof(atPreferred[0]); i++)
+        {
+            if(pl__set_transform_backend(atPreferred[i]))
+                return true;
+        }
+        return false;
+    }
+
+    switch(tBackend)
+    {
+        case PL_TRANSFORM_BACKEND_SCALAR:
+            gtTransformKernels = (plTransformKernels){pl__mul_mat4_scalar, pl__compose_trs_scalar, pl__invert_mat4_scalar, pl__mesh_faces_scalar};
+            break;
+    #ifdef PL_ECS_SIMD_X86
+        case PL_TRANSFORM_BACKEND_SSE:
+            gtTransformKernels = (plTransformKernels){pl__mul_mat4_sse, pl__compose_trs_sse, pl__invert_mat4_sse, pl__mesh_faces_sse};
+            break;
+        case PL_TRANSFORM_BACKEND_AVX2:
+            if(!pl__cpu_supports_avx2())
+                return false;
+            gtTransformKernels = (plTransformKernels){pl__mul_mat4_avx2, pl__compose_trs_avx2, pl__invert_mat4_avx2, pl__mesh_faces_sse};
+            break;
+    #endif
+    #ifdef PL_ECS_SIMD_NEON
+        case PL_TRANSFORM_BACKEND_NEON:
+            gtTransformKernels = (plTransformKernels){pl__mul_mat4_neon, pl__compose_trs_neon, pl__invert_mat4_neon, pl__mesh_faces_neon};
+            break;
+    #endif
+        default:
+            return false;
+    }
+    gtTransformBackend = tBackend;
+
+    // statics start over in a reloaded library, the registry keeps the choice
+    if(gptDataRegistry)
+        gptDataRegistry->set_data("transform backend", (void*)(uintptr_t)(tBackend + 1));
+    return true;
+}
+
+static plTransformBackend
+pl__get_transform_backend(void)
+{
+    return gtTransformBackend;
+}
+
+static const char*
+pl__get_transform_backend_name(plTransformBackend tBackend)
+{
+    static const char* apcNames[PL_TRANSFORM_BACKEND_COUNT] = {"auto", "scalar", "sse", "avx2", "neon"};
+    if(tBackend < 0 || tBackend >= PL_TRANSFORM_BACKEND_COUNT)
+        return "unknown";
+    return apcNames[tBackend];
+}
+
+static void
+pl__mul_mat4(const plMat4* atA, const plMat4* atB, plMat4* atOut, uint32_t uCount)
+{
+    gtTransformKernels.mul_mat4(atA, atB, atOut, uCount);
+}
+
+static void
+pl__compose_trs(const plVec3* atScales, const plVec4* atRotations, const plVec3* atTranslations, plMat4* atOut, uint32_t uCount)
+{
+    gtTransformKernels.compose_trs(atScales, atRotations, atTranslations, atOut, uCount);
+}
+
+static void
+pl__invert_mat4(const plMat4* atMats, plMat4* atOut, uint32_t uCount)
+{
+    gtTransformKernels.invert_mat4(atMats, atOut, uCount);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] extension loading
+//-----------------------------------------------------------------------------
+
+PL_EXPORT void
+pl_load_ecs_ext(plApiRegistryApiI* ptApiRegistry, bool bReload)
+{
+    gptDataRegistry = ptApiRegistry->first(PL_API_DATA_REGISTRY);
+    pl_set_memory_context(gptDataRegistry->get_data(PL_CONTEXT_MEMORY));
+    pl_set_profile_context(gptDataRegistry->get_data("profile"));
+    pl_set_log_context(gptDataRegistry->get_data("log"));
+    gptThreads = ptApiRegistry->first(PL_API_THREADS);
+    gptDevice = ptApiRegistry->first(PL_API_DEVICE);
+    pl__create_task_pool();
+
+    // a reload keeps whatever backend was set before it (auto if none)
+    const uintptr_t uSavedBackend = bReload ? (uintptr_t)gptDataRegistry->get_data("transform backend") : 0;
+    if(uSavedBackend == 0 || !pl__set_transform_backend((plTransformBackend)(uSavedBackend - 1)))
+        pl__set_transform_backend(PL_TRANSFORM_BACKEND_AUTO);
+
+    if(bReload)
+    {
+        ptApiRegistry->replace(ptApiRegistry->first(PL_API_ECS), pl_load_ecs_api());
+        ptApiRegistry->replace(ptApiRegistry->first(PL_API_CAMERA), pl_load_camera_api());
+        ptApiRegistry->replace(ptApiRegistry->first(PL_API_TRANSFORM), pl_load_transform_api());
+
+        // find log channel
+        uint32_t uChannelCount = 0;
+        plLogChannel* ptChannels = pl_get_log_channels(&uChannelCount);
+        for(uint32_t i = 0; i < uChannelCount; i++)
+        {
+            if(strcmp(ptChannels[i].pcName, "ECS") == 0)
+            {
+                uLogChannel = i;
+                break;
+            }
+        }
+    }
+    else
+    {
+        ptApiRegistry->add(PL_API_ECS, pl_load_ecs_api());
+        ptApiRegistry->add(PL_API_CAMERA, pl_load_camera_api());
+        ptApiRegistry->add(PL_API_TRANSFORM, pl_load_transform_api());
+        uLogChannel = pl_add_log_channel("ECS", PL_CHANNEL_TYPE_CYCLIC_BUFFER);
+        pl_log_info_to_f(uLogChannel, "transform kernels: %s", pl__get_transform_backend_name(gtTransformBackend));
+    }
+}
+
+PL_EXPORT void
+pl_unload_ecs_ext(plApiRegistryApiI* ptApiRegistry)
+{
+    // threads can't outlive the library's code
+    pl__destroy_task_pool();
 }
\ No newline at end of file
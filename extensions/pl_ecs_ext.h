@@ -32,6 +32,9 @@ typedef struct _plEcsI plEcsI;
 #define PL_API_CAMERA "PL_API_CAMERA"
 typedef struct _plCameraI plCameraI;
 
+#define PL_API_TRANSFORM "PL_API_TRANSFORM"
+typedef struct _plTransformI plTransformI;
+
 //-----------------------------------------------------------------------------
 // [SECTION] defines
 //-----------------------------------------------------------------------------
@@ -44,12 +47,51 @@ typedef struct _plCameraI plCameraI;
     #define PL_INVALID_ENTITY_HANDLE 0
 #endif
 
+#ifndef PL_MAX_MESH_LODS
+    #define PL_MAX_MESH_LODS 8
+#endif
+
+// entity handles: low 32 bits index, high 32 bits generation (bumped on destroy)
+#define PL_ENTITY_INDEX(tEntity)       ((uint32_t)(tEntity))
+#define PL_ENTITY_GENERATION(tEntity)  ((uint32_t)((uint64_t)(tEntity) >> 32))
+#define PL_ENTITY(uIndex, uGeneration) (((uint64_t)(uGeneration) << 32) | (uint64_t)(uIndex))
+
+#ifndef PL_ECS_SPARSE_PAGE_SIZE
+    #define PL_ECS_SPARSE_PAGE_SIZE 4096 // entities per sparse page (power of 2)
+#endif
+
+// dirty bits of plTransformColumns (soa transform layout), by dense index
+#define PL_TRANSFORM_IS_DIRTY(ptColumns, uIndex)  (((ptColumns)->auDirtyBits[(uIndex) >> 6] >> ((uIndex) & 63)) & 1)
+#define PL_TRANSFORM_SET_DIRTY(ptColumns, uIndex) ((ptColumns)->auDirtyBits[(uIndex) >> 6] |= (uint64_t)1 << ((uIndex) & 63))
+
+#ifndef PL_ECS_COMPONENT_ALIGNMENT
+    #define PL_ECS_COMPONENT_ALIGNMENT 16 // minimum alignment of component storage
+#endif
+
+// typed access to type erased component storage
+#define PL_ECS_COMPONENTS(ptManager, T)           ((T*)(ptManager)->pComponents)
+#define PL_ECS_COMPONENT_AT(ptManager, uIndex, T) ((T*)((unsigned char*)(ptManager)->pComponents + (size_t)(uIndex) * (ptManager)->szStride))
+#define PL_ECS_COMPONENT_COUNT(ptManager)         pl_sb_size((ptManager)->sbtEntities)
+#define PL_ECS_GET_COMPONENT(ptEcs, ptManager, tEntity, T) ((T*)(ptEcs)->get_component((ptManager), (tEntity)))
+
+#ifndef PL_ECS_MAX_QUERY_COMPONENTS
+    #define PL_ECS_MAX_QUERY_COMPONENTS 8 // per include/exclude list
+#endif
+
+#ifndef PL_ECS_QUERY_CHUNK_SIZE
+    #define PL_ECS_QUERY_CHUNK_SIZE 1024 // matches per chunk
+#endif
+
+#ifndef PL_ECS_INSTANCE_UPLOAD_GAP
+    #define PL_ECS_INSTANCE_UPLOAD_GAP 4 // clean instances between dirty ones still uploaded to save a copy region
+#endif
+
 //-----------------------------------------------------------------------------
 // [SECTION] includes
 //-----------------------------------------------------------------------------
 
 #include <stdint.h> // uint*_t
-#include "pl_graphics.inl"
+#include "pl_graphics_ext.h" // plMesh
 #include "pl_math.h"
 #include "pl_ds.h"
 
@@ -60,7 +102,13 @@ typedef struct _plCameraI plCameraI;
 // basic types
 typedef struct _plComponentLibrary plComponentLibrary;
 typedef struct _plComponentManager plComponentManager;
+typedef struct _plComponentDesc    plComponentDesc;
 typedef struct _plObjectInfo    plObjectInfo;
+typedef struct _plMeshLod       plMeshLod;
+typedef struct _plTransformColumns plTransformColumns;
+typedef struct _plEcsQueryDesc     plEcsQueryDesc;
+typedef struct _plEcsQueryChunk    plEcsQueryChunk;
+typedef struct _plEcsQuery         plEcsQuery; // opaque
 
 // ecs components
 typedef struct _plTagComponent       plTagComponent;
@@ -78,17 +126,25 @@ typedef struct _plObjectSystemData plObjectSystemData;
 // enums
 typedef int      plShaderType;
 typedef int      plComponentType;
+typedef int      plTransformBackend;
+typedef int      plTransformLayout;
 typedef uint64_t plEntity;
 
 // external
 typedef struct _plApiRegistryApiI plApiRegistryApiI;
 
+// callbacks
+typedef void (*plEcsQueryChunkFn)     (const plEcsQueryChunk* ptChunk, void* pUserData, uint32_t uWorker);
+typedef void (*plComponentConstructor)(void* pComponent);
+typedef void (*plComponentDestructor) (void* pComponent);
+
 //-----------------------------------------------------------------------------
 // [SECTION] public api
 //-----------------------------------------------------------------------------
 
-const plEcsI*    pl_load_ecs_api   (void);
-const plCameraI* pl_load_camera_api(void);
+const plEcsI*       pl_load_ecs_api      (void);
+const plCameraI*    pl_load_camera_api   (void);
+const plTransformI* pl_load_transform_api(void);
 
 //-----------------------------------------------------------------------------
 // [SECTION] public api structs
@@ -98,13 +154,27 @@ typedef struct _plEcsI
 {
     void     (*init_component_library)(const plApiRegistryApiI* ptApiRegistry, plComponentLibrary* ptLibrary);
     plEntity (*create_entity)         (plComponentLibrary* ptLibrary);
-    plEntity (*get_entity)            (plComponentLibrary* ptLibrary, const char* pcName);
+    void     (*destroy_entity)        (plComponentLibrary* ptLibrary, plEntity tEntity); // removes all components, handle becomes stale
+    bool     (*is_entity_valid)       (plComponentLibrary* ptLibrary, plEntity tEntity); // false for stale handles
+    plEntity (*get_entity)            (plComponentLibrary* ptLibrary, const char* pcName); // by tag name, O(1)
     size_t   (*get_index)             (plComponentManager* ptManager, plEntity tEntity);
     void*    (*get_component)         (plComponentManager* ptManager, plEntity tEntity);
     void*    (*create_component)      (plComponentManager* ptManager, plEntity tEntity);
+    void     (*remove_component)      (plComponentManager* ptManager, plEntity tEntity); // swaps in the last component (invalidates its pointers), mesh gpu buffers are left to the caller
     bool     (*has_entity)            (plComponentManager* ptManager, plEntity tEntity);
+    void     (*mark_changed)          (plComponentManager* ptManager, plEntity tEntity); // for change tracking systems (meshes after edits, objects after repointing, transforms written without setting bDirty)
+
+    // custom components (types from PL_COMPONENT_TYPE_COUNT up, per library)
+    plComponentType     (*register_component)(plComponentLibrary* ptLibrary, const plComponentDesc* ptDesc);
+    plComponentManager* (*get_manager)       (plComponentLibrary* ptLibrary, plComponentType tType); // built in types too
+
+    // names (tags hold interned string ids, strings live until cleanup_systems)
+    uint32_t    (*intern_string)(plComponentLibrary* ptLibrary, const char* pcString); // same id for equal strings, 0 for ""
+    const char* (*get_string)   (plComponentLibrary* ptLibrary, uint32_t uStringId);
+    void        (*set_name)     (plComponentLibrary* ptLibrary, plEntity tEntity, const char* pcName); // adds a tag if needed, keeps get_entity in sync
+    const char* (*get_name)     (plComponentLibrary* ptLibrary, plEntity tEntity); // NULL without a tag
 
-    // color encoding/decoding
+    // color encoding/decoding (entity index only, generation 0 on the way back)
     plVec4   (*entity_to_color)(plEntity tEntity);
     plEntity (*color_to_entity)(const plVec4* ptColor);
 
@@ -125,13 +195,32 @@ typedef struct _plEcsI
     void (*remove_mesh_outline)(plComponentLibrary* ptLibrary, plEntity tEntity);
 
     // meshes
-    void (*calculate_normals) (plMeshComponent* atMeshes, uint32_t uComponentCount);
-    void (*calculate_tangents)(plMeshComponent* atMeshes, uint32_t uComponentCount);
+    void (*calculate_normals) (plMeshComponent* atMeshes, uint32_t uComponentCount); // area weighted, meshes without normals only, split across workers
+    void (*calculate_tangents)(plMeshComponent* atMeshes, uint32_t uComponentCount); // mikktspace style (no vertex splits), needs uv0, generates missing normals
+    void (*calculate_bounds)  (plMeshComponent* atMeshes, uint32_t uComponentCount); // local aabb & bounding sphere
+    void (*pack_vertices)     (plMeshComponent* atMeshes, uint32_t uComponentCount); // quantized attribute stream & tMesh.ulVertexStreamMask (positions stay as is)
+    void (*upload_meshes)     (plMeshComponent* atMeshes, uint32_t uComponentCount, plDevice* ptDevice); // new position, attribute & index buffers for tMesh (after pack_vertices, lods aren't uploaded, caller destroys)
+    void (*optimize_meshes)   (plMeshComponent* atMeshes, uint32_t uComponentCount, uint32_t uLodCount); // weld, cache/overdraw/fetch order & lods (half the triangles each), run before packing
+
+    // transforms
+    void (*set_transform_layout)     (plComponentLibrary* ptLibrary, plTransformLayout tLayout); // before any transform is created
+    bool (*get_transform_columns)    (plComponentLibrary* ptLibrary, plTransformColumns* ptColumnsOut); // soa layout only, valid until a transform is added or removed
+    void (*compose_transforms)       (plTransformComponent* atTransforms, uint32_t uComponentCount); // tWorld from tTranslation/tRotation/tScale, marks them dirty
+    void (*compose_transform_columns)(plTransformColumns* ptColumns); // same for every transform of the soa layout (locals)
+
+    // queries (match lists are cached, rebuilt once a queried manager's layout changes,
+    // destroy them before the library they query)
+    plEcsQuery* (*create_query)   (const plEcsQueryDesc* ptDesc);
+    void        (*destroy_query)  (plEcsQuery* ptQuery);
+    uint32_t    (*update_query)   (plEcsQuery* ptQuery); // returns the chunk count
+    void        (*get_query_chunk)(plEcsQuery* ptQuery, uint32_t uChunk, plEcsQueryChunk* ptChunkOut); // after update_query
+    void        (*run_query)      (plEcsQuery* ptQuery, plEcsQueryChunkFn pfChunk, void* pUserData, bool bParallel); // updates first, parallel chunks run on worker threads (no allocating/logging)
 
     // systems
     void (*cleanup_systems)            (const plApiRegistryApiI* ptApiRegistry, plComponentLibrary* ptLibrary);
-    void (*run_object_update_system)   (plComponentLibrary* ptLibrary);
+    void (*run_object_update_system)   (plComponentLibrary* ptLibrary); // after run_hierarchy_update_system, only objects with a changed mesh or transform are rewritten
     void (*run_hierarchy_update_system)(plComponentLibrary* ptLibrary);
+    void (*upload_object_instances)    (plComponentLibrary* ptLibrary, plDevice* ptDevice); // instances written since the last upload -> uInstanceBuffer (warns & does nothing without PL_API_DEVICE storage buffers)
 
 } plEcsI;
 
@@ -147,11 +236,24 @@ typedef struct _plCameraI
     void (*update)         (plCameraComponent* ptCamera);
 } plCameraI;
 
+// batch kernels used by the transform systems, backend picked at load by cpu
+// feature detection (outputs may alias inputs)
+typedef struct _plTransformI
+{
+    bool               (*set_backend)     (plTransformBackend tBackend); // false if unsupported on this cpu
+    plTransformBackend (*get_backend)     (void);
+    const char*        (*get_backend_name)(plTransformBackend tBackend);
+
+    void (*mul_mat4)   (const plMat4* atA, const plMat4* atB, plMat4* atOut, uint32_t uCount); // atOut[i] = atA[i] * atB[i]
+    void (*compose_trs)(const plVec3* atScales, const plVec4* atRotations, const plVec3* atTranslations, plMat4* atOut, uint32_t uCount); // T * R * S, unit quaternions (xyzw)
+    void (*invert_mat4)(const plMat4* atMats, plMat4* atOut, uint32_t uCount); // general inverse, singular matrices give non finite results
+} plTransformI;
+
 //-----------------------------------------------------------------------------
 // [SECTION] structs
 //-----------------------------------------------------------------------------
 
-typedef struct _plObjectInfo
+typedef struct _plObjectInfo // same layout as plInstanceData
 {
     plMat4   tModel;
     uint32_t uMaterialIndex;
@@ -160,33 +262,115 @@ typedef struct _plObjectInfo
     int      _unused;
 } plObjectInfo;
 
+typedef struct _plMeshLod
+{
+    uint32_t uIndexOffset; // into plMeshComponent::sbuLodIndices
+    uint32_t uIndexCount;
+    float    fError;       // max distance from the full mesh (local units, upper bound)
+} plMeshLod;
+
+// soa transform layout, streams indexed by the transform manager's dense index
+// (get_component has no record to return for these transforms)
+typedef struct _plTransformColumns
+{
+    uint32_t  uCount;
+    plVec3*   atScales;
+    plVec4*   atRotations;
+    plVec3*   atTranslations;
+    plMat4*   atLocals;    // plTransformComponent::tWorld
+    plMat4*   atWorlds;    // plTransformComponent::tFinalTransform
+    uint64_t* auDirtyBits; // plTransformComponent::bDirty, see PL_TRANSFORM_IS_DIRTY
+} plTransformColumns;
+
+// NULL terminated, every include & no exclude
+typedef struct _plEcsQueryDesc
+{
+    plComponentManager* aptInclude[PL_ECS_MAX_QUERY_COMPONENTS + 1];
+    plComponentManager* aptExclude[PL_ECS_MAX_QUERY_COMPONENTS + 1];
+} plEcsQueryDesc;
+
+// contiguous run of matches, the j-th entity's component of aptInclude[i] is
+// at dense index apuIndices[i][j] of apComponents[i]
+typedef struct _plEcsQueryChunk
+{
+    uint32_t        uFirst; // match offset within the query
+    uint32_t        uCount;
+    const plEntity* atEntities;
+    const uint32_t* apuIndices[PL_ECS_MAX_QUERY_COMPONENTS];
+    void*           apComponents[PL_ECS_MAX_QUERY_COMPONENTS]; // manager's pComponents (NULL for soa transforms)
+} plEcsQueryChunk;
+
 typedef struct _plObjectSystemData
 {
-    bool              bDirty;
-    plMeshComponent** sbtMeshes;
+    bool              bDirty;              // instances written since the last upload_object_instances
+
+    // points into the mesh manager's storage: valid until its uLayoutVersion
+    // changes (creating or removing a mesh may move or reallocate components),
+    // run_object_update_system rebuilds it before then
+    plMeshComponent** sbtMeshes;           // also rebuilt when objects are added, removed or repointed
+    uint32_t*         sbuMeshIndices;      // per object, last resolved dense index (revalidated each update)
+    uint32_t*         sbuTransformIndices;
+    plEntity*         sbtInstanceEntities; // per object, the object its instance was written for
+    plObjectInfo*     sbtInstances;        // per object (dense index), cpu side of uInstanceBuffer
+    uint64_t*         sbuDirtyInstances;   // bits by object dense index, written since the last upload
+    plBufferRange*    sbtUploadRanges;     // scratch
+
+    // change & layout versions seen by the last update
+    uint32_t          uObjectChangeVersion;
+    uint32_t          uMeshChangeVersion;
+    uint32_t          uTransformChangeVersion;
+    uint32_t          uObjectLayoutVersion;
+    uint32_t          uMeshLayoutVersion;
+    uint32_t          uTransformLayoutVersion;
+
+    // gpu mirror of sbtInstances (storage buffer, valid once uInstanceCapacity > 0)
+    plDevice*         ptDevice;
+    uint32_t          uInstanceBuffer;     // for plDrawArea::uInstanceBuffer (changes when it grows), plDraw::uInstanceIndex is the object's dense index
+    uint32_t          uInstanceCapacity;
 } plObjectSystemData;
 
+typedef struct _plComponentDesc
+{
+    const char*            pcName;
+    size_t                 szSize;
+    size_t                 szAlignment; // power of 2, 0 keeps szSize as the stride
+    plComponentConstructor pfConstruct; // optional, components start zeroed without one
+    plComponentDestructor  pfDestruct;  // optional, on remove, destroy & cleanup_systems
+} plComponentDesc;
+
 typedef struct _plComponentManager
 {
-    plComponentType tComponentType;
-    plHashMap       tHashMap;
-    plEntity*       sbtEntities;
-    void*           pComponents;
-    size_t          szStride;
-    void*           pSystemData;
+    plComponentType        tComponentType;
+    const char*            pcName;
+    uint32_t**             sbuSparsePages; // entity index -> dense index, pages allocated on demand (UINT32_MAX = none)
+    uint32_t               uLayoutVersion; // bumped when components are added, removed or reparented (dense indices may have moved)
+    uint32_t               uChangeVersion; // stamp handed to changed components, advances once a system has seen it
+    uint32_t               uLastChange;    // newest stamp handed out (uChangeVersion or older)
+    uint32_t*              sbuChangeVersions; // per dense index, stamp of the last change (creation counts)
+    plEntity*              sbtEntities;
+    void*                  pComponents;    // dense, szStride apart (moved with memcpy when growing)
+    size_t                 szStride;
+    size_t                 szAlignment;    // of pComponents
+    uint32_t               uCapacity;
+    void*                  pAllocation;    // backing memory of pComponents
+    plComponentConstructor pfConstruct;
+    plComponentDestructor  pfDestruct;
+    void*                  pSystemData;
 } plComponentManager;
 
 typedef struct _plComponentLibrary
 {
-    size_t             tNextEntity;
-    plComponentManager tTagComponentManager;
-    plComponentManager tTransformComponentManager;
-    plComponentManager tMeshComponentManager;
-    plComponentManager tMaterialComponentManager;
-    plComponentManager tObjectComponentManager;
-    plComponentManager tCameraComponentManager;
-    plComponentManager tHierarchyComponentManager;
-    plComponentManager tLightComponentManager;
+    uint32_t*           sbuEntityGenerations; // by entity index, index 0 is reserved (PL_INVALID_ENTITY_HANDLE)
+    uint32_t*           sbuFreeEntities;      // destroyed indices waiting for reuse
+    plComponentManager  tTagComponentManager;
+    plComponentManager  tTransformComponentManager;
+    plComponentManager  tMeshComponentManager;
+    plComponentManager  tMaterialComponentManager;
+    plComponentManager  tObjectComponentManager;
+    plComponentManager  tCameraComponentManager;
+    plComponentManager  tHierarchyComponentManager;
+    plComponentManager  tLightComponentManager;
+    plComponentManager** sbtCustomManagers;    // by type - PL_COMPONENT_TYPE_COUNT
 } plComponentLibrary;
 
 //-----------------------------------------------------------------------------
@@ -212,7 +396,7 @@ typedef struct _plLightComponent
 
 typedef struct _plTagComponent
 {
-    char acName[PL_MAX_NAME_LENGTH];
+    uint32_t uNameId; // interned, change through set_name
 } plTagComponent;
 
 typedef struct _plTransformComponent
@@ -222,6 +406,7 @@ typedef struct _plTransformComponent
     plVec3 tTranslation;
     plMat4 tFinalTransform;
     plMat4 tWorld;
+    bool   bDirty; // set after changing tWorld (or tFinalTransform of a root), cleared by the hierarchy system
 } plTransformComponent;
 
 typedef struct _plMeshComponent
@@ -241,9 +426,17 @@ typedef struct _plMeshComponent
     plVec2*      sbtVertexTextureCoordinates0;
     plVec2*      sbtVertexTextureCoordinates1;
     uint32_t*    sbuIndices;
+    uint8_t*     sbucVertexAttributes; // set by pack_vertices, upload_meshes puts it in tMesh.uAttributeBuffer (sbtVertexPositions in tMesh.uVertexBuffer)
+    uint32_t*    sbuLodIndices;        // set by optimize_meshes, every lod back to back (same vertices as sbuIndices)
+    plMeshLod    atLods[PL_MAX_MESH_LODS];
+    uint32_t     uLodCount;
     plObjectInfo tInfo;
     uint64_t     uBindGroup2;
     uint32_t     uBufferOffset;
+    plVec3       tAABBMin;             // local space, set by calculate_bounds
+    plVec3       tAABBMax;
+    plVec4       tBoundingSphere;      // local space center (xyz) & radius (w), set by calculate_bounds
+    plVec4       tWorldBoundingSphere; // set by the object update system, used for culling
 } plMeshComponent;
 
 typedef struct _plMaterialComponent
@@ -304,7 +497,26 @@ enum _plComponentType
     PL_COMPONENT_TYPE_CAMERA,
     PL_COMPONENT_TYPE_OBJECT,
     PL_COMPONENT_TYPE_HIERARCHY,
-    PL_COMPONENT_TYPE_LIGHT
+    PL_COMPONENT_TYPE_LIGHT,
+
+    PL_COMPONENT_TYPE_COUNT // first registered type
+};
+
+enum _plTransformLayout
+{
+    PL_TRANSFORM_LAYOUT_AOS, // plTransformComponent records (default)
+    PL_TRANSFORM_LAYOUT_SOA  // plTransformColumns
+};
+
+enum _plTransformBackend
+{
+    PL_TRANSFORM_BACKEND_AUTO,   // best supported
+    PL_TRANSFORM_BACKEND_SCALAR,
+    PL_TRANSFORM_BACKEND_SSE,    // sse2, x64 baseline
+    PL_TRANSFORM_BACKEND_AVX2,   // avx2 + fma, detected at runtime
+    PL_TRANSFORM_BACKEND_NEON,   // arm64 baseline
+
+    PL_TRANSFORM_BACKEND_COUNT
 };
 
 enum _plShaderType
@@ -256,3 +256,269 @@ pl__add_3d_bezier_cubic(plDrawList3D* ptDrawlist, plVec3 tP0, plVec3 tP1, plVec3
     tVerticies[1] = tP3;
     pl__add_3d_line(ptDrawlist, tVerticies[0], tVerticies[1], tColor, fThickness);
 }
+
+static void
+pl__reset_render_graph(plRenderGraph* ptGraph)
+{
+    pl_sb_reset(ptGraph->sbtTextures);
+    pl_sb_reset(ptGraph->sbtPasses);
+}
+
+static uint32_t
+pl__add_graph_texture(plGraphics* ptGraphics, const plRenderGraphTextureDesc* ptDesc)
+{
+    const plRenderGraphTexture tTexture = {
+        .tDesc = *ptDesc
+    };
+    pl_sb_push(ptGraphics->tRenderGraph.sbtTextures, tTexture);
+    return pl_sb_size(ptGraphics->tRenderGraph.sbtTextures); // 1 based
+}
+
+static uint32_t
+pl__add_graph_pass(plGraphics* ptGraphics, const plRenderGraphPassDesc* ptDesc)
+{
+    PL_ASSERT(ptDesc->uColorOutputCount <= PL_MAX_RENDER_GRAPH_ATTACHMENTS);
+    PL_ASSERT(ptDesc->uInputCount <= PL_MAX_RENDER_GRAPH_INPUTS);
+    PL_ASSERT((ptDesc->uColorOutputCount > 0 || ptDesc->uDepthOutput != PL_RENDER_GRAPH_NONE) && "render graph pass has no outputs");
+
+    // handles are 1 based, textures must be added before the passes using them
+    for(uint32_t i = 0; i < ptDesc->uColorOutputCount; i++)
+        PL_ASSERT(ptDesc->auColorOutputs[i] != PL_RENDER_GRAPH_NONE && ptDesc->auColorOutputs[i] <= pl_sb_size(ptGraphics->tRenderGraph.sbtTextures) && "invalid render graph color output");
+    for(uint32_t i = 0; i < ptDesc->uInputCount; i++)
+        PL_ASSERT(ptDesc->auInputs[i] != PL_RENDER_GRAPH_NONE && ptDesc->auInputs[i] <= pl_sb_size(ptGraphics->tRenderGraph.sbtTextures) && "invalid render graph input");
+    PL_ASSERT(ptDesc->uDepthOutput <= pl_sb_size(ptGraphics->tRenderGraph.sbtTextures) && "invalid render graph depth output");
+
+    const plRenderGraphPass tPass = {
+        .tDesc = *ptDesc
+    };
+    pl_sb_push(ptGraphics->tRenderGraph.sbtPasses, tPass);
+    return pl_sb_size(ptGraphics->tRenderGraph.sbtPasses); // 1 based
+}
+
+static uint32_t
+pl__format_stride(plFormat tFormat)
+{
+    switch(tFormat)
+    {
+        case PL_FORMAT_R32G32B32_FLOAT:   return 12;
+        case PL_FORMAT_R32G32_FLOAT:      return 8;
+        case PL_FORMAT_D32_FLOAT_S8_UINT: return 8;
+        case PL_FORMAT_R8G8B8A8_UNORM:
+        case PL_FORMAT_R8G8B8A8_SRGB:
+        case PL_FORMAT_B8G8R8A8_SRGB:
+        case PL_FORMAT_B8G8R8A8_UNORM:
+        case PL_FORMAT_D32_FLOAT:
+        case PL_FORMAT_D24_UNORM_S8_UINT:
+        case PL_FORMAT_D16_UNORM_S8_UINT: return 4;
+    }
+    return 0;
+}
+
+static uint32_t
+pl__format_block_size(plFormat tFormat, uint32_t* puBlockWidth, uint32_t* puBlockHeight)
+{
+    // bytes per block, uncompressed formats are 1x1 blocks
+    *puBlockWidth = 4;
+    *puBlockHeight = 4;
+    switch(tFormat)
+    {
+        case PL_FORMAT_BC1_RGBA_UNORM:
+        case PL_FORMAT_BC1_RGBA_SRGB:  return 8;
+        case PL_FORMAT_BC3_UNORM:
+        case PL_FORMAT_BC3_SRGB:
+        case PL_FORMAT_BC7_UNORM:
+        case PL_FORMAT_BC7_SRGB:
+        case PL_FORMAT_ASTC_4x4_UNORM:
+        case PL_FORMAT_ASTC_4x4_SRGB:  return 16;
+    }
+    *puBlockWidth = 1;
+    *puBlockHeight = 1;
+    return pl__format_stride(tFormat);
+}
+
+static size_t
+pl__format_mip_size(plFormat tFormat, uint32_t uWidth, uint32_t uHeight, uint32_t uMip)
+{
+    // tightly packed, partial blocks round up
+    uint32_t uBlockWidth = 0;
+    uint32_t uBlockHeight = 0;
+    const uint32_t uBlockSize = pl__format_block_size(tFormat, &uBlockWidth, &uBlockHeight);
+    const uint32_t uMipWidth = uWidth >> uMip > 0 ? uWidth >> uMip : 1;
+    const uint32_t uMipHeight = uHeight >> uMip > 0 ? uHeight >> uMip : 1;
+    return (size_t)((uMipWidth + uBlockWidth - 1) / uBlockWidth) * ((uMipHeight + uBlockHeight - 1) / uBlockHeight) * uBlockSize;
+}
+
+static inline bool
+pl__graph_lifetimes_overlap(const plRenderGraphTexture* ptA, const plRenderGraphTexture* ptB)
+{
+    return !(ptA->_uLastPass < ptB->_uFirstPass || ptB->_uLastPass < ptA->_uFirstPass);
+}
+
+static void
+pl__compile_render_graph(plRenderGraph* ptGraph, uint32_t uDefaultWidth, uint32_t uDefaultHeight)
+{
+    const uint32_t uTextureCount = pl_sb_size(ptGraph->sbtTextures);
+    const uint32_t uPassCount = pl_sb_size(ptGraph->sbtPasses);
+
+    for(uint32_t i = 0; i < uTextureCount; i++)
+    {
+        plRenderGraphTexture* ptTexture = &ptGraph->sbtTextures[i];
+        if(ptTexture->tDesc.uWidth == 0)       ptTexture->tDesc.uWidth = uDefaultWidth;
+        if(ptTexture->tDesc.uHeight == 0)      ptTexture->tDesc.uHeight = uDefaultHeight;
+        if(ptTexture->tDesc.uSampleCount == 0) ptTexture->tDesc.uSampleCount = 1;
+        ptTexture->_bNeeded    = ptTexture->tDesc.bPersistent || ptTexture->tDesc.bSampledAfter;
+        ptTexture->_uFirstPass = UINT32_MAX;
+        ptTexture->_uLastPass  = 0;
+        ptTexture->_uAliasSlot = UINT32_MAX;
+    }
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~pass culling~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // passes are declared in submission order, so walking backwards sees every
+    // reader of a texture before its writers
+    for(uint32_t i = uPassCount; i > 0; i--)
+    {
+        plRenderGraphPass* ptPass = &ptGraph->sbtPasses[i - 1];
+
+        bool bLive = ptPass->tDesc.bNeverCull;
+        for(uint32_t j = 0; j < ptPass->tDesc.uColorOutputCount; j++)
+            bLive |= ptGraph->sbtTextures[ptPass->tDesc.auColorOutputs[j] - 1]._bNeeded;
+        if(ptPass->tDesc.uDepthOutput != PL_RENDER_GRAPH_NONE)
+            bLive |= ptGraph->sbtTextures[ptPass->tDesc.uDepthOutput - 1]._bNeeded;
+
+        ptPass->_bCulled = !bLive;
+        if(!bLive)
+            continue;
+
+        for(uint32_t j = 0; j < ptPass->tDesc.uInputCount; j++)
+            ptGraph->sbtTextures[ptPass->tDesc.auInputs[j] - 1]._bNeeded = true;
+
+        // loading an output reads whatever the previous writer left behind
+        if(!ptPass->tDesc.bClear)
+        {
+            for(uint32_t j = 0; j < ptPass->tDesc.uColorOutputCount; j++)
+                ptGraph->sbtTextures[ptPass->tDesc.auColorOutputs[j] - 1]._bNeeded = true;
+            if(ptPass->tDesc.uDepthOutput != PL_RENDER_GRAPH_NONE)
+                ptGraph->sbtTextures[ptPass->tDesc.uDepthOutput - 1]._bNeeded = true;
+        }
+    }
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~lifetimes~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    for(uint32_t i = 0; i < uPassCount; i++)
+    {
+        const plRenderGraphPass* ptPass = &ptGraph->sbtPasses[i];
+        if(ptPass->_bCulled)
+            continue;
+
+        uint32_t auTextures[PL_MAX_RENDER_GRAPH_ATTACHMENTS + 1 + PL_MAX_RENDER_GRAPH_INPUTS] = {0};
+        uint32_t uTextureUseCount = 0;
+        for(uint32_t j = 0; j < ptPass->tDesc.uColorOutputCount; j++)
+            auTextures[uTextureUseCount++] = ptPass->tDesc.auColorOutputs[j];
+        if(ptPass->tDesc.uDepthOutput != PL_RENDER_GRAPH_NONE)
+            auTextures[uTextureUseCount++] = ptPass->tDesc.uDepthOutput;
+        for(uint32_t j = 0; j < ptPass->tDesc.uInputCount; j++)
+            auTextures[uTextureUseCount++] = ptPass->tDesc.auInputs[j];
+
+        for(uint32_t j = 0; j < uTextureUseCount; j++)
+        {
+            plRenderGraphTexture* ptTexture = &ptGraph->sbtTextures[auTextures[j] - 1];
+            ptTexture->_uFirstPass = pl_minu(ptTexture->_uFirstPass, i);
+            ptTexture->_uLastPass  = pl_maxu(ptTexture->_uLastPass, i);
+        }
+    }
+
+    // read after the last pass, so contents are stored & no later texture
+    // takes over its memory
+    for(uint32_t i = 0; i < uTextureCount; i++)
+    {
+        plRenderGraphTexture* ptTexture = &ptGraph->sbtTextures[i];
+        if(ptTexture->tDesc.bSampledAfter && ptTexture->_uFirstPass != UINT32_MAX)
+            ptTexture->_uLastPass = uPassCount;
+    }
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~transient aliasing~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // greedy interval packing, largest textures first so each slot is sized by
+    // its first tenant
+    uint32_t* sbuTransients = NULL;
+    for(uint32_t i = 0; i < uTextureCount; i++)
+    {
+        const plRenderGraphTexture* ptTexture = &ptGraph->sbtTextures[i];
+        if(ptTexture->tDesc.bPersistent || ptTexture->_uFirstPass == UINT32_MAX)
+            continue;
+
+        const uint64_t ulSize = (uint64_t)ptTexture->tDesc.uWidth * ptTexture->tDesc.uHeight * ptTexture->tDesc.uSampleCount * pl__format_stride(ptTexture->tDesc.tFormat);
+        uint32_t uInsert = pl_sb_size(sbuTransients);
+        pl_sb_push(sbuTransients, i);
+        while(uInsert > 0)
+        {
+            const plRenderGraphTexture* ptPrev = &ptGraph->sbtTextures[sbuTransients[uInsert - 1]];
+            const uint64_t ulPrevSize = (uint64_t)ptPrev->tDesc.uWidth * ptPrev->tDesc.uHeight * ptPrev->tDesc.uSampleCount * pl__format_stride(ptPrev->tDesc.tFormat);
+            if(ulPrevSize >= ulSize)
+                break;
+            sbuTransients[uInsert] = sbuTransients[uInsert - 1];
+            sbuTransients[uInsert - 1] = i;
+            uInsert--;
+        }
+    }
+
+    ptGraph->_uAliasSlotCount = 0;
+    for(uint32_t i = 0; i < pl_sb_size(sbuTransients); i++)
+    {
+        plRenderGraphTexture* ptTexture = &ptGraph->sbtTextures[sbuTransients[i]];
+        for(uint32_t uSlot = 0; uSlot < ptGraph->_uAliasSlotCount && ptTexture->_uAliasSlot == UINT32_MAX; uSlot++)
+        {
+            bool bFree = true;
+            for(uint32_t j = 0; j < i; j++)
+            {
+                const plRenderGraphTexture* ptTenant = &ptGraph->sbtTextures[sbuTransients[j]];
+                if(ptTenant->_uAliasSlot == uSlot && pl__graph_lifetimes_overlap(ptTexture, ptTenant))
+                {
+                    bFree = false;
+                    break;
+                }
+            }
+            if(bFree)
+                ptTexture->_uAliasSlot = uSlot;
+        }
+        if(ptTexture->_uAliasSlot == UINT32_MAX)
+            ptTexture->_uAliasSlot = ptGraph->_uAliasSlotCount++;
+    }
+    pl_sb_free(sbuTransients);
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~hash~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    uint64_t ulHash = pl_hm_hash(&uTextureCount, sizeof(uint32_t), uPassCount);
+    for(uint32_t i = 0; i < uTextureCount; i++)
+    {
+        const plRenderGraphTexture* ptTexture = &ptGraph->sbtTextures[i];
+        const uint32_t auState[] = {
+            (uint32_t)ptTexture->tDesc.tFormat,
+            ptTexture->tDesc.uWidth,
+            ptTexture->tDesc.uHeight,
+            ptTexture->tDesc.uSampleCount,
+            (uint32_t)ptTexture->tDesc.bPersistent,
+            (uint32_t)ptTexture->tDesc.bSampledAfter,
+            ptTexture->_uFirstPass,
+            ptTexture->_uLastPass,
+            ptTexture->_uAliasSlot
+        };
+        ulHash = pl_hm_hash(auState, sizeof(auState), ulHash);
+    }
+    for(uint32_t i = 0; i < uPassCount; i++)
+    {
+        const plRenderGraphPass* ptPass = &ptGraph->sbtPasses[i];
+        const uint32_t auState[] = {
+            (uint32_t)ptPass->_bCulled,
+            (uint32_t)ptPass->tDesc.bClear,
+            ptPass->tDesc.uColorOutputCount,
+            ptPass->tDesc.uDepthOutput,
+            ptPass->tDesc.uInputCount
+        };
+        ulHash = pl_hm_hash(auState, sizeof(auState), ulHash);
+        ulHash = pl_hm_hash(ptPass->tDesc.auColorOutputs, sizeof(uint32_t) * ptPass->tDesc.uColorOutputCount, ulHash);
+        ulHash = pl_hm_hash(ptPass->tDesc.auInputs, sizeof(uint32_t) * ptPass->tDesc.uInputCount, ulHash);
+    }
+    ptGraph->_ulHash = ulHash;
+}
@@ -6,9 +6,12 @@
 Index of this file:
 // [SECTION] header mess
 // [SECTION] apis
+// [SECTION] defines
 // [SECTION] includes
+// [SECTION] forward declarations & basic types
 // [SECTION] public api structs
 // [SECTION] structs
+// [SECTION] enums
 */
 
 //-----------------------------------------------------------------------------
@@ -28,6 +31,26 @@ typedef struct _plGraphicsI plGraphicsI;
 #define PL_API_DEVICE "PL_API_DEVICE"
 typedef struct _plDeviceI plDeviceI;
 
+//-----------------------------------------------------------------------------
+// [SECTION] defines
+//-----------------------------------------------------------------------------
+
+#ifndef PL_MAX_RENDER_GRAPH_ATTACHMENTS
+    #define PL_MAX_RENDER_GRAPH_ATTACHMENTS 4 // color outputs per pass
+#endif
+
+#ifndef PL_MAX_RENDER_GRAPH_INPUTS
+    #define PL_MAX_RENDER_GRAPH_INPUTS 8 // sampled textures per pass
+#endif
+
+#ifndef PL_RENDER_GRAPH_NONE
+    #define PL_RENDER_GRAPH_NONE 0 // graph handles are 1 based
+#endif
+
+#ifndef PL_RENDER_TARGET_NONE
+    #define PL_RENDER_TARGET_NONE 0 // render target & readback handles are 1 based
+#endif
+
 //-----------------------------------------------------------------------------
 // [SECTION] includes
 //-----------------------------------------------------------------------------
@@ -36,6 +59,7 @@ typedef struct _plDeviceI plDeviceI;
 #include <stdint.h>
 #include <stdbool.h>
 #include "pl_math.h"
+#include "pl_graphics.inl"
 
 //-----------------------------------------------------------------------------
 // [SECTION] forward declarations & basic types
@@ -44,20 +68,45 @@ typedef struct _plDeviceI plDeviceI;
 // basic types
 typedef struct _plDevice        plDevice;
 typedef struct _plBuffer        plBuffer;
+typedef struct _plBufferRange   plBufferRange;
+typedef struct _plTexture       plTexture;
+typedef struct _plTextureDesc   plTextureDesc;
 typedef struct _plCommandBuffer plCommandBuffer;
 
 typedef struct _plGraphics      plGraphics;
 typedef struct _plDraw          plDraw;
 typedef struct _plDrawArea      plDrawArea;
 typedef struct _plMesh          plMesh;
+typedef struct _plMaterialData  plMaterialData;
+typedef struct _plInstanceData  plInstanceData;
+typedef struct _plSwapchainDesc plSwapchainDesc;
 
 // 3D drawing api
 typedef struct _plDrawList3D        plDrawList3D;
 typedef struct _plDrawVertex3DSolid plDrawVertex3DSolid; // single vertex (3D pos + uv + color)
 typedef struct _plDrawVertex3DLine  plDrawVertex3DLine; // single vertex (pos + uv + color)
 
+// render graph
+typedef struct _plRenderGraph            plRenderGraph;
+typedef struct _plRenderGraphTexture     plRenderGraphTexture;
+typedef struct _plRenderGraphTextureDesc plRenderGraphTextureDesc;
+typedef struct _plRenderGraphPass        plRenderGraphPass;
+typedef struct _plRenderGraphPassDesc    plRenderGraphPassDesc;
+typedef void (*plRenderGraphExecuteFunc)(plGraphics* ptGraphics, void* pUserData);
+
+// texture streaming
+typedef const void* (*plTextureStreamFunc)(void* pUserData, uint32_t uTextureIndex, uint32_t uMip, size_t* pszSizeOut); // NULL -> mip not loaded yet, asked again next frame
+
+// GPU culling
+typedef struct _plCullDesc plCullDesc;
+
+// offscreen rendering
+typedef struct _plRenderTargetDesc plRenderTargetDesc;
+typedef struct _plReadback         plReadback;
+
 // enums
 typedef int pl3DDrawFlags;
+typedef int plPresentMode; // -> enum _plPresentMode
 
 // external
 typedef struct _plDrawList plDrawList;
@@ -70,8 +119,31 @@ typedef struct _plFontAtlas plFontAtlas;
 typedef struct _plDeviceI
 {
     // commited resources
-    uint32_t (*create_index_buffer) (plDevice* ptDevice, size_t szSize, const void* pData, const char* pcName);
-    uint32_t (*create_vertex_buffer)(plDevice* ptDevice, size_t szSize, size_t szStride, const void* pData, const char* pcName);
+    uint32_t (*create_index_buffer)  (plDevice* ptDevice, size_t szSize, const void* pData, const char* pcName);
+    uint32_t (*create_vertex_buffer) (plDevice* ptDevice, size_t szSize, size_t szStride, const void* pData, const char* pcName);
+    uint32_t (*create_storage_buffer)(plDevice* ptDevice, size_t szSize, const void* pData, const char* pcName); // shader visible through the global descriptor set
+    void     (*update_buffer)        (plDevice* ptDevice, uint32_t uBufferIndex, const void* pMirror, const plBufferRange* atRanges, uint32_t uRangeCount); // storage buffers, pMirror has the buffer's layout, only the ranges are staged (visible to the next submitted frame)
+    void     (*destroy_buffer)       (plDevice* ptDevice, uint32_t uBufferIndex); // deferred until in flight frames finish, index may be reused
+
+    // textures (uploaded through the staging ring, visible to the next submitted frame)
+    //   - uncompressed formats: pData holds mip 0, remaining mips are generated on the GPU
+    //   - block compressed formats: pData holds every mip, tightly packed from largest to smallest
+    bool     (*is_format_supported)(plDevice* ptDevice, plFormat tFormat); // false -> pick another format (e.g. ASTC instead of BC)
+    uint32_t (*create_texture)     (plDevice* ptDevice, const plTextureDesc* ptDesc, const void* pData, size_t szSize); // pData may be NULL
+    void     (*update_texture)     (plDevice* ptDevice, uint32_t uTextureIndex, const void* pData, size_t szSize);      // same layout as create_texture
+    void     (*destroy_texture)    (plDevice* ptDevice, uint32_t uTextureIndex); // deferred until in flight frames finish, index may be reused
+
+    // texture streaming
+    //   - every mip comes from tStreamFunc (tightly packed), starting with the small tail mips
+    //   - residency follows requests made each frame, textures shrink least recently requested first once over budget
+    //   - the bindless index changes as mips stream in & out (0 until the tail is resident), query it every frame
+    uint32_t (*create_streamed_texture)   (plDevice* ptDevice, const plTextureDesc* ptDesc, plTextureStreamFunc tStreamFunc, void* pUserData);
+    void     (*request_texture_resolution)(plDevice* ptDevice, uint32_t uTextureIndex, uint32_t uPixels); // on screen extent in pixels (screen space feedback or estimated from distance)
+    void     (*set_texture_budget)        (plDevice* ptDevice, size_t szBytes); // 0 -> derived from the device's memory budget
+
+    // bindless
+    uint32_t (*get_bindless_index)        (plDevice* ptDevice, uint32_t uBufferIndex);  // slot in the global storage buffer array (0 -> default)
+    uint32_t (*get_texture_bindless_index)(plDevice* ptDevice, uint32_t uTextureIndex); // slot in the global texture array (0 -> default)
 } plDeviceI;
 
 typedef struct _plGraphicsI
@@ -86,8 +158,34 @@ typedef struct _plGraphicsI
     void (*begin_recording)(plGraphics* ptGraphics);
     void (*end_recording)  (plGraphics* ptGraphics);
 
+    // frame pacing (applied at the next begin_frame)
+    void (*set_frames_in_flight)(plGraphics* ptGraphics, uint32_t uFramesInFlight); // 1-4, more trades latency for throughput
+    void (*set_low_latency)     (plGraphics* ptGraphics, bool bLowLatency);         // wait for the GPU to drain before each frame
+    void (*set_swapchain)       (plGraphics* ptGraphics, const plSwapchainDesc* ptDesc);
+
+    // shaders
+    //   - recompiles changed GLSL sources & rebuilds only the pipelines using them, a failed compile keeps the old shader
+    //   - replaced pipelines are retired once in flight frames finish
+    //   - called by begin_frame a few times a second while plGraphics::bShaderHotReload is set
+    uint32_t (*reload_shaders)(plGraphics* ptGraphics); // returns number of shaders rebuilt
+
+    // shader variants (mesh shaders specialized for a vertex format & texture bindings)
+    //   - keyed on plGraphicsState (vertex streams, texture flags & fixed function state), requesting an existing state returns the same variant
+    //   - compiled on a worker thread, draws use a fallback (same vertex streams, default state & no textures) until ready
+    //   - fallbacks are compiled on first use of each vertex format
+    uint32_t (*request_shader_variant) (plGraphics* ptGraphics, plGraphicsState tState); // for plDraw::uShaderVariant
+    bool     (*is_shader_variant_ready)(plGraphics* ptGraphics, uint32_t uVariant);
+
     // drawing
-    void (*draw_areas)(plGraphics* ptGraphics, uint32_t uAreaCount, plDrawArea* atAreas, plDraw* atDraws);
+    void (*draw_areas)(plGraphics* ptGraphics, uint32_t uAreaCount, plDrawArea* atAreas, plDraw* atDraws); // culled areas draw indirectly
+
+    // GPU culling (recorded after begin_frame, outside of render targets & before begin_recording)
+    //   - tests plDraw::tBoundingSphere against the frustum & the previous frame's depth pyramid of a render target
+    //   - the pyramid is tested in the view of the cull_areas call that preceded the target's last pass (frustum only until there is one)
+    //   - survivors are compacted into indirect commands drawn by draw_areas this frame (same areas & draws)
+    //   - draws of an area must share vertex & index buffers, firstInstance is plDraw::uInstanceIndex
+    //   - survivors take their material from plInstanceData::uMaterialIndex (plDrawArea::uInstanceBuffer is required)
+    void (*cull_areas)(plGraphics* ptGraphics, const plCullDesc* ptDesc, uint32_t uAreaCount, plDrawArea* atAreas, const plDraw* atDraws);
 
     // 2D drawing api
     void (*draw_lists)(plGraphics* ptGraphics, uint32_t uListCount, plDrawList* atLists);
@@ -105,12 +203,120 @@ typedef struct _plGraphicsI
     void (*add_3d_centered_box)   (plDrawList3D* ptDrawlist, plVec3 tCenter, float fWidth, float fHeight, float fDepth, plVec4 tColor, float fThickness);
     void (*add_3d_bezier_quad)    (plDrawList3D* ptDrawlist, plVec3 tP0, plVec3 tP1, plVec3 tP2, plVec4 tColor, float fThickness, uint32_t uSegments);
     void (*add_3d_bezier_cubic)   (plDrawList3D* ptDrawlist, plVec3 tP0, plVec3 tP1, plVec3 tP2, plVec3 tP3, plVec4 tColor, float fThickness, uint32_t uSegments);
+
+    // render graph (declared each frame after begin_frame, executed by begin_recording before the main pass)
+    uint32_t (*add_graph_texture)              (plGraphics* ptGraphics, const plRenderGraphTextureDesc* ptDesc);
+    uint32_t (*add_graph_pass)                 (plGraphics* ptGraphics, const plRenderGraphPassDesc* ptDesc);
+    uint32_t (*get_graph_texture_bindless_index)(plGraphics* ptGraphics, uint32_t uTexture); // slot in the global texture array, call after the graph is declared (changes when the graph is rebuilt)
+
+    // offscreen render targets (recorded after begin_frame, before begin_recording)
+    uint32_t (*create_render_target)            (plGraphics* ptGraphics, const plRenderTargetDesc* ptDesc);
+    void     (*destroy_render_target)           (plGraphics* ptGraphics, uint32_t uRenderTarget); // deferred until in flight frames finish
+    void     (*begin_render_target)             (plGraphics* ptGraphics, uint32_t uRenderTarget); // clears it, 3D drawlists submitted before end_render_target draw into it
+    void     (*end_render_target)               (plGraphics* ptGraphics);
+    uint32_t (*get_render_target_bindless_index)(plGraphics* ptGraphics, uint32_t uRenderTarget); // slot in the global texture array
+
+    // readback (same recording window as render targets, results arrive frames later)
+    uint32_t (*request_readback)(plGraphics* ptGraphics, uint32_t uRenderTarget); // PL_RENDER_TARGET_NONE if the ring is full
+    bool     (*get_readback)    (plGraphics* ptGraphics, uint32_t uReadback, plReadback* ptReadbackOut); // false until the GPU finished the copy
+    void     (*release_readback)(plGraphics* ptGraphics, uint32_t uReadback); // returns the slot to the ring
 } plGraphicsI;
 
 //-----------------------------------------------------------------------------
 // [SECTION] structs
 //-----------------------------------------------------------------------------
 
+typedef struct _plRenderGraphTextureDesc
+{
+    const char* pcName;
+    plFormat    tFormat;
+    uint32_t    uWidth;        // 0 -> swapchain width
+    uint32_t    uHeight;       // 0 -> swapchain height
+    uint32_t    uSampleCount;  // 0 -> 1
+    bool        bPersistent;   // keeps contents between frames & is never aliased; passes writing it are never culled
+    bool        bSampledAfter; // read by the main pass through its bindless index; passes writing it are never culled & it is left shader readable
+} plRenderGraphTextureDesc;
+
+typedef struct _plRenderGraphPassDesc
+{
+    const char*              pcName;
+    uint32_t                 uColorOutputCount;
+    uint32_t                 auColorOutputs[PL_MAX_RENDER_GRAPH_ATTACHMENTS];
+    uint32_t                 uDepthOutput; // PL_RENDER_GRAPH_NONE if unused
+    uint32_t                 uInputCount;
+    uint32_t                 auInputs[PL_MAX_RENDER_GRAPH_INPUTS]; // textures sampled by this pass
+    bool                     bClear;       // otherwise outputs are loaded
+    float                    afClearColor[4];
+    float                    fClearDepth;
+    bool                     bNeverCull;   // keep even if nothing reads the outputs (side effects)
+    plRenderGraphExecuteFunc execute;
+    void*                    pUserData;
+} plRenderGraphPassDesc;
+
+typedef struct _plRenderGraphTexture
+{
+    plRenderGraphTextureDesc tDesc;
+
+    // [INTERNAL] filled in by compilation
+    bool     _bNeeded;
+    uint32_t _uFirstPass; // UINT32_MAX if unused
+    uint32_t _uLastPass;
+    uint32_t _uAliasSlot; // UINT32_MAX if not aliased
+} plRenderGraphTexture;
+
+typedef struct _plRenderGraphPass
+{
+    plRenderGraphPassDesc tDesc;
+
+    // [INTERNAL] filled in by compilation
+    bool _bCulled;
+} plRenderGraphPass;
+
+typedef struct _plRenderGraph
+{
+    plRenderGraphTexture* sbtTextures;
+    plRenderGraphPass*    sbtPasses;
+
+    // [INTERNAL] filled in by compilation
+    uint32_t _uAliasSlotCount;
+    uint64_t _ulHash; // backends only rebuild resources when this changes
+} plRenderGraph;
+
+typedef struct _plRenderTargetDesc
+{
+    const char* pcName;
+    plFormat    tFormat;
+    uint32_t    uWidth;
+    uint32_t    uHeight;
+    uint32_t    uSampleCount;  // 0 -> 1, multisampled targets are resolved at the end of the pass
+    bool        bDepth;        // depth buffer is transient (unless bDepthPyramid), never read back
+    bool        bDepthPyramid; // keeps depth & builds a max depth pyramid at end_render_target for occlusion culling (requires bDepth)
+    float       afClearColor[4];
+    float       fClearDepth;
+} plRenderTargetDesc;
+
+typedef struct _plCullDesc
+{
+    plMat4   tViewProjection;  // projection * view, depth 0 at the near plane
+    uint32_t uOcclusionTarget; // render target created with bDepthPyramid, PL_RENDER_TARGET_NONE -> frustum only
+} plCullDesc;
+
+typedef struct _plReadback
+{
+    const void* pData;     // tightly packed rows in the target's format, valid until released
+    plFormat    tFormat;
+    uint32_t    uWidth;
+    uint32_t    uHeight;
+    uint32_t    uRowPitch; // bytes
+    uint64_t    ulFrame;   // frame the copy was recorded in
+} plReadback;
+
+typedef struct _plSwapchainDesc
+{
+    plPresentMode tPresentMode; // falls back to PL_PRESENT_MODE_FIFO if unsupported
+    uint32_t      uImageCount;  // 0 -> surface minimum + 1, clamped to surface limits
+} plSwapchainDesc;
+
 typedef struct _plDrawVertex3DSolid
 {
     float    pos[3];
@@ -138,7 +344,8 @@ typedef struct _plDrawList3D
 
 typedef struct _plMesh
 {
-    uint32_t uVertexBuffer;
+    uint32_t uVertexBuffer;    // shader variants: float3 positions, variant 0: interleaved position & color
+    uint32_t uAttributeBuffer; // shader variants: packed attributes (see [SECTION] vertex layout of pl_graphics.inl), unused if the mask only has positions
     uint32_t uIndexBuffer;
     uint32_t uVertexOffset;
     uint32_t uVertexCount;
@@ -147,6 +354,19 @@ typedef struct _plMesh
     uint64_t ulVertexStreamMask; // PL_MESH_FORMAT_FLAG_*
 } plMesh;
 
+typedef struct _plMaterialData // plDrawArea::uMaterialBuffer entries read by shader variants
+{
+    plVec4   tColor;
+    uint32_t auTextures[4]; // bindless texture slots for PL_SHADER_TEXTURE_FLAG_BINDING_0-3 (sampled with texcoord 0)
+} plMaterialData;
+
+typedef struct _plInstanceData // plDrawArea::uInstanceBuffer entries read by shader variants (same layout as the ecs's plObjectInfo)
+{
+    plMat4   tModel;
+    uint32_t uMaterialIndex; // into plDrawArea::uMaterialBuffer, used by culled areas
+    uint32_t _auUnused[3];
+} plInstanceData;
+
 typedef struct _plDrawArea
 {
     // VkViewport   tViewport;
@@ -155,12 +375,22 @@ typedef struct _plDrawArea
     // uint32_t     uDynamicBufferOffset0;
     uint32_t     uDrawOffset;
     uint32_t     uDrawCount;
+    uint32_t     uMaterialBuffer; // storage buffer (buffer index) indexed by plDraw::uMaterialIndex
+    uint32_t     uInstanceBuffer; // storage buffer (buffer index) of plInstanceData indexed by plDraw::uInstanceIndex, shader variants draw with its tModel
+    const plMat4* ptViewProjection; // shader variants, NULL -> identity (positions already in clip space)
+
+    // [INTERNAL] set by cull_areas, only valid during the frame it was called in
+    uint64_t     _ulCullFrame;
+    uint32_t     _uCullRecord;
 } plDrawArea;
 
 typedef struct _plDraw
 {
     plMesh*      ptMesh;
-    // uint32_t     uShaderVariant;
+    uint32_t     uMaterialIndex; // pushed as constants, no per draw descriptor updates (culled areas use the instance's)
+    uint32_t     uInstanceIndex;
+    plVec4       tBoundingSphere; // world space center (xyz) & radius (w), only used by cull_areas (w <= 0 -> never culled)
+    uint32_t     uShaderVariant; // from request_shader_variant, 0 -> position & color pipeline (culled areas use the first draw's)
     // plBindGroup* aptBindGroups[2];
     // uint32_t     auDynamicBufferOffset[2];
 } plDraw;
@@ -170,6 +400,27 @@ typedef struct _plBuffer
     void* pBuffer;
 } plBuffer;
 
+typedef struct _plBufferRange
+{
+    size_t szOffset; // bytes, multiple of 4
+    size_t szSize;   // bytes, multiple of 4
+} plBufferRange;
+
+typedef struct _plTextureDesc
+{
+    const char* pcName;
+    plFormat    tFormat;
+    uint32_t    uWidth;
+    uint32_t    uHeight;
+    uint32_t    uMips; // 0 -> full chain down to 1x1
+} plTextureDesc;
+
+typedef struct _plTexture
+{
+    plTextureDesc tDesc;
+    void*         pTexture;
+} plTexture;
+
 typedef struct _plCommandBuffer
 {
     void* _pInternalData;
@@ -178,7 +429,8 @@ typedef struct _plCommandBuffer
 typedef struct _plDevice
 {
 
-    plBuffer* sbtBuffers;
+    plBuffer*  sbtBuffers;
+    plTexture* sbtTextures;
 
     void* _pInternalData;
 } plDevice;
@@ -187,6 +439,17 @@ typedef struct _plGraphics
 {
     plDevice tDevice;
     plDrawList3D** sbt3DDrawlists;
+    plRenderGraph tRenderGraph;
+
+    // frame pacing & presentation, may be set before initialize (0 -> 2 frames in flight)
+    uint32_t        uFramesInFlight;
+    bool            bLowLatency;
+    plSwapchainDesc tSwapchainDesc;
+
+    // shaders, may be set before initialize
+    bool        bShaderHotReload;  // watch GLSL sources & rebuild pipelines that use changed ones
+    const char* pcShaderDirectory; // GLSL sources, NULL -> "../shaders/glsl/" (relative to the working directory)
+
     void* _pInternalData;
 } plGraphics;
 
@@ -194,6 +457,14 @@ typedef struct _plGraphics
 // [SECTION] enums
 //-----------------------------------------------------------------------------
 
+enum _plPresentMode
+{
+    PL_PRESENT_MODE_FIFO,         // vsync, default
+    PL_PRESENT_MODE_FIFO_RELAXED, // vsync, tears when a frame is late
+    PL_PRESENT_MODE_MAILBOX,      // no tearing, newest frame replaces the queued one
+    PL_PRESENT_MODE_IMMEDIATE     // no vsync, tears
+};
+
 enum _pl3DDrawFlags
 {
     PL_PIPELINE_FLAG_NONE          = 0,
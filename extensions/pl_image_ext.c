@@ -5,6 +5,7 @@
 /*
 Index of this file:
 // [SECTION] includes
+// [SECTION] internal api
 // [SECTION] public api implementation
 // [SECTION] extension loading
 // [SECTION] unity build
@@ -17,6 +18,17 @@ Index of this file:
 #include "pilotlight.h"
 #include "pl_image_ext.h"
 #include "stb_image.h"
+#include "stb_image_write.h"
+
+//-----------------------------------------------------------------------------
+// [SECTION] internal api
+//-----------------------------------------------------------------------------
+
+static bool
+pl__write_png(char const* pcFilename, int iWidth, int iHeight, int iChannels, const void* pData, int iStrideInBytes)
+{
+    return stbi_write_png(pcFilename, iWidth, iHeight, iChannels, pData, iStrideInBytes) != 0;
+}
 
 //-----------------------------------------------------------------------------
 // [SECTION] public api implementation
@@ -26,8 +38,9 @@ const plImageApiI*
 pl_load_image_api(void)
 {
     static const plImageApiI tApi = {
-        .load = stbi_load,
-        .free = stbi_image_free
+        .load      = stbi_load,
+        .free      = stbi_image_free,
+        .write_png = pl__write_png
     };
     return &tApi;
 }
@@ -62,4 +75,11 @@ pl_unload_image_ext(plApiRegistryApiI* ptApiRegistry)
 #define STBI_FREE(x) PL_FREE(x)
 #define STBI_REALLOC(x, y) PL_REALLOC(x, y)
 #include "stb_image.h"
-#undef STB_IMAGE_IMPLEMENTATION
\ No newline at end of file
+#undef STB_IMAGE_IMPLEMENTATION
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#define STBIW_MALLOC(x) PL_ALLOC(x)
+#define STBIW_FREE(x) PL_FREE(x)
+#define STBIW_REALLOC(x, y) PL_REALLOC(x, y)
+#include "stb_image_write.h"
+#undef STB_IMAGE_WRITE_IMPLEMENTATION
\ No newline at end of file
@@ -6,6 +6,7 @@
 Index of this file:
 // [SECTION] header mess
 // [SECTION] apis
+// [SECTION] includes
 // [SECTION] public api
 // [SECTION] public api structs
 */
@@ -24,6 +25,12 @@ Index of this file:
 #define PL_API_IMAGE "PL_API_IMAGE"
 typedef struct _plImageApiI plImageApiI;
 
+//-----------------------------------------------------------------------------
+// [SECTION] includes
+//-----------------------------------------------------------------------------
+
+#include <stdbool.h>
+
 //-----------------------------------------------------------------------------
 // [SECTION] public api
 //-----------------------------------------------------------------------------
@@ -36,8 +43,9 @@ const plImageApiI* pl_load_image_api(void);
 
 typedef struct _plImageApiI
 {
-    unsigned char* (*load)(char const* pcFilename, int* piX, int* piY, int* piChannels, int iDesiredChannels);
-    void           (*free)(void* pRetValueFromLoad);
+    unsigned char* (*load)     (char const* pcFilename, int* piX, int* piY, int* piChannels, int iDesiredChannels);
+    void           (*free)     (void* pRetValueFromLoad);
+    bool           (*write_png)(char const* pcFilename, int iWidth, int iHeight, int iChannels, const void* pData, int iStrideInBytes);
 } plImageApiI;
 
 #endif // PL_IMAGE_EXT_H
\ No newline at end of file
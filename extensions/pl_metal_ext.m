@@ -5,10 +5,12 @@
 /*
 Index of this file:
 // [SECTION] includes
+// [SECTION] defines
 // [SECTION] global data
 // [SECTION] internal structs & types
 // [SECTION] internal api
 // [SECTION] public api implementation
+// [SECTION] unsupported api
 // [SECTION] extension loading
 // [SECTION] unity build
 */
@@ -29,6 +31,19 @@ Index of this file:
 #import <Metal/Metal.h>
 #import <QuartzCore/CAMetalLayer.h>
 
+//-----------------------------------------------------------------------------
+// [SECTION] defines
+//-----------------------------------------------------------------------------
+
+// apis the metal backend doesn't implement yet warn on first use & do nothing
+#define PL_METAL_UNSUPPORTED() \
+    static bool bWarned = false; \
+    if(!bWarned) \
+    { \
+        NSLog(@"Warning: %s is not supported by the metal backend", __func__); \
+        bWarned = true; \
+    }
+
 //-----------------------------------------------------------------------------
 // [SECTION] global data
 //-----------------------------------------------------------------------------
@@ -581,7 +596,7 @@ pl_draw_areas(plGraphics* ptGraphics, uint32_t uAreaCount, plDrawArea* atAreas,
 
         for(uint32_t j = 0; j < ptArea->uDrawCount; j++)
         {
-            plDraw* ptDraw = &atDraws[ptArea->uDrawOffset];
+            plDraw* ptDraw = &atDraws[ptArea->uDrawOffset + j];
 
             if(uCurrentVertexBuffer != ptDraw->ptMesh->uVertexBuffer)
             {
@@ -709,6 +724,223 @@ pl__submit_3d_drawlist(plDrawList3D* ptDrawlist, float fWidth, float fHeight, co
     }];
 }
 
+//-----------------------------------------------------------------------------
+// [SECTION] unsupported api
+//-----------------------------------------------------------------------------
+
+static uint32_t
+pl_create_storage_buffer(plDevice* ptDevice, size_t szSize, const void* pData, const char* pcName)
+{
+    // shared storage, only missing the global descriptor set
+    plDeviceMetal* ptMetalDevice = (plDeviceMetal*)ptDevice->_pInternalData;
+    id<MTLBuffer> tStorageBuffer = [ptMetalDevice->tDevice newBufferWithLength:szSize options:MTLResourceStorageModeShared];
+    if(pData)
+        memcpy(tStorageBuffer.contents, pData, szSize);
+    else
+        memset(tStorageBuffer.contents, 0, szSize);
+
+    const uint32_t uBufferIndex = pl_sb_size(ptDevice->sbtBuffers);
+
+    plBuffer tBuffer = {
+        .pBuffer = tStorageBuffer
+    };
+    pl_sb_push(ptDevice->sbtBuffers, tBuffer);
+
+    return uBufferIndex;
+}
+
+static void
+pl_update_buffer(plDevice* ptDevice, uint32_t uBufferIndex, const void* pMirror, const plBufferRange* atRanges, uint32_t uRangeCount)
+{
+    // shared storage, written directly
+    id<MTLBuffer> tBuffer = (__bridge id<MTLBuffer>)ptDevice->sbtBuffers[uBufferIndex].pBuffer;
+    for(uint32_t i = 0; i < uRangeCount; i++)
+        memcpy(&((char*)tBuffer.contents)[atRanges[i].szOffset], &((const char*)pMirror)[atRanges[i].szOffset], atRanges[i].szSize);
+}
+
+static void
+pl_destroy_buffer(plDevice* ptDevice, uint32_t uBufferIndex)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
+static bool
+pl_is_format_supported(plDevice* ptDevice, plFormat tFormat)
+{
+    PL_METAL_UNSUPPORTED();
+    return false;
+}
+
+static uint32_t
+pl_create_texture(plDevice* ptDevice, const plTextureDesc* ptDesc, const void* pData, size_t szSize)
+{
+    PL_METAL_UNSUPPORTED();
+    return 0;
+}
+
+static void
+pl_update_texture(plDevice* ptDevice, uint32_t uTextureIndex, const void* pData, size_t szSize)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
+static void
+pl_destroy_texture(plDevice* ptDevice, uint32_t uTextureIndex)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
+static uint32_t
+pl_create_streamed_texture(plDevice* ptDevice, const plTextureDesc* ptDesc, plTextureStreamFunc tStreamFunc, void* pUserData)
+{
+    PL_METAL_UNSUPPORTED();
+    return 0;
+}
+
+static void
+pl_request_texture_resolution(plDevice* ptDevice, uint32_t uTextureIndex, uint32_t uPixels)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
+static void
+pl_set_texture_budget(plDevice* ptDevice, size_t szBytes)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
+static uint32_t
+pl_get_bindless_index(plDevice* ptDevice, uint32_t uBufferIndex)
+{
+    PL_METAL_UNSUPPORTED();
+    return 0;
+}
+
+static uint32_t
+pl_get_texture_bindless_index(plDevice* ptDevice, uint32_t uTextureIndex)
+{
+    PL_METAL_UNSUPPORTED();
+    return 0;
+}
+
+static void
+pl_set_frames_in_flight(plGraphics* ptGraphics, uint32_t uFramesInFlight)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
+static void
+pl_set_low_latency(plGraphics* ptGraphics, bool bLowLatency)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
+static void
+pl_set_swapchain(plGraphics* ptGraphics, const plSwapchainDesc* ptDesc)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
+static uint32_t
+pl_reload_shaders(plGraphics* ptGraphics)
+{
+    PL_METAL_UNSUPPORTED();
+    return 0;
+}
+
+static uint32_t
+pl_request_shader_variant(plGraphics* ptGraphics, plGraphicsState tState)
+{
+    // draw_areas uses its own pipeline
+    PL_METAL_UNSUPPORTED();
+    return 0;
+}
+
+static bool
+pl_is_shader_variant_ready(plGraphics* ptGraphics, uint32_t uVariant)
+{
+    return true;
+}
+
+static void
+pl_cull_areas(plGraphics* ptGraphics, const plCullDesc* ptDesc, uint32_t uAreaCount, plDrawArea* atAreas, const plDraw* atDraws)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
+static uint32_t
+pl_add_graph_texture(plGraphics* ptGraphics, const plRenderGraphTextureDesc* ptDesc)
+{
+    PL_METAL_UNSUPPORTED();
+    return PL_RENDER_GRAPH_NONE;
+}
+
+static uint32_t
+pl_add_graph_pass(plGraphics* ptGraphics, const plRenderGraphPassDesc* ptDesc)
+{
+    PL_METAL_UNSUPPORTED();
+    return PL_RENDER_GRAPH_NONE;
+}
+
+static uint32_t
+pl_get_graph_texture_bindless_index(plGraphics* ptGraphics, uint32_t uTexture)
+{
+    PL_METAL_UNSUPPORTED();
+    return 0;
+}
+
+static uint32_t
+pl_create_render_target(plGraphics* ptGraphics, const plRenderTargetDesc* ptDesc)
+{
+    PL_METAL_UNSUPPORTED();
+    return PL_RENDER_TARGET_NONE;
+}
+
+static void
+pl_destroy_render_target(plGraphics* ptGraphics, uint32_t uRenderTarget)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
+static void
+pl_begin_render_target(plGraphics* ptGraphics, uint32_t uRenderTarget)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
+static void
+pl_end_render_target(plGraphics* ptGraphics)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
+static uint32_t
+pl_get_render_target_bindless_index(plGraphics* ptGraphics, uint32_t uRenderTarget)
+{
+    PL_METAL_UNSUPPORTED();
+    return 0;
+}
+
+static uint32_t
+pl_request_readback(plGraphics* ptGraphics, uint32_t uRenderTarget)
+{
+    PL_METAL_UNSUPPORTED();
+    return PL_RENDER_TARGET_NONE;
+}
+
+static bool
+pl_get_readback(plGraphics* ptGraphics, uint32_t uReadback, plReadback* ptReadbackOut)
+{
+    PL_METAL_UNSUPPORTED();
+    return false;
+}
+
+static void
+pl_release_readback(plGraphics* ptGraphics, uint32_t uReadback)
+{
+    PL_METAL_UNSUPPORTED();
+}
+
 //-----------------------------------------------------------------------------
 // [SECTION] extension loading
 //-----------------------------------------------------------------------------
@@ -737,7 +969,27 @@ pl_load_graphics_api(void)
         .add_3d_bezier_quad     = pl__add_3d_bezier_quad,
         .add_3d_bezier_cubic    = pl__add_3d_bezier_cubic,
         .register_3d_drawlist   = pl__register_3d_drawlist,
-        .submit_3d_drawlist     = pl__submit_3d_drawlist
+        .submit_3d_drawlist     = pl__submit_3d_drawlist,
+
+        // unsupported
+        .set_frames_in_flight             = pl_set_frames_in_flight,
+        .set_low_latency                  = pl_set_low_latency,
+        .set_swapchain                    = pl_set_swapchain,
+        .reload_shaders                   = pl_reload_shaders,
+        .request_shader_variant           = pl_request_shader_variant,
+        .is_shader_variant_ready          = pl_is_shader_variant_ready,
+        .cull_areas                       = pl_cull_areas,
+        .add_graph_texture                = pl_add_graph_texture,
+        .add_graph_pass                   = pl_add_graph_pass,
+        .get_graph_texture_bindless_index = pl_get_graph_texture_bindless_index,
+        .create_render_target             = pl_create_render_target,
+        .destroy_render_target            = pl_destroy_render_target,
+        .begin_render_target              = pl_begin_render_target,
+        .end_render_target                = pl_end_render_target,
+        .get_render_target_bindless_index = pl_get_render_target_bindless_index,
+        .request_readback                 = pl_request_readback,
+        .get_readback                     = pl_get_readback,
+        .release_readback                 = pl_release_readback
     };
     return &tApi;
 }
@@ -746,8 +998,22 @@ static const plDeviceI*
 pl_load_device_api(void)
 {
     static const plDeviceI tApi = {
-        .create_index_buffer = pl_create_index_buffer,
-        .create_vertex_buffer = pl_create_vertex_buffer
+        .create_index_buffer        = pl_create_index_buffer,
+        .create_vertex_buffer       = pl_create_vertex_buffer,
+        .create_storage_buffer      = pl_create_storage_buffer,
+        .update_buffer              = pl_update_buffer,
+
+        // unsupported
+        .destroy_buffer             = pl_destroy_buffer,
+        .is_format_supported        = pl_is_format_supported,
+        .create_texture             = pl_create_texture,
+        .update_texture             = pl_update_texture,
+        .destroy_texture            = pl_destroy_texture,
+        .create_streamed_texture    = pl_create_streamed_texture,
+        .request_texture_resolution = pl_request_texture_resolution,
+        .set_texture_budget         = pl_set_texture_budget,
+        .get_bindless_index         = pl_get_bindless_index,
+        .get_texture_bindless_index = pl_get_texture_bindless_index
     };
     return &tApi;
 }
@@ -24,7 +24,17 @@ Index of this file:
 #include "pl_profile.h"
 #include "pl_log.h"
 #include "pl_string.h"
+#include "pl_stats_ext.h"
 #include "pl_graphics_ext.c"
+#include <stdio.h>  // FILE, remove
+#include <stdlib.h> // system, getenv
+#ifdef _WIN32
+    #include <process.h>  // _getpid
+#else
+    #include <time.h>     // clock_gettime
+    #include <unistd.h>   // getpid
+    #include <sys/wait.h> // WIFEXITED, WEXITSTATUS
+#endif
 
 // vulkan stuff
 #if defined(_WIN32)
@@ -38,10 +48,116 @@ Index of this file:
 #define PL_DEVICE_ALLOCATION_BLOCK_SIZE 268435456
 #define PL_DEVICE_LOCAL_LEVELS 8
 
+#ifndef PL_VULKAN_DYNAMIC_BUFFER_SIZE
+    #define PL_VULKAN_DYNAMIC_BUFFER_SIZE 4194304 // initial per frame size of the dynamic geometry ring
+#endif
+
+#ifndef PL_VULKAN_DYNAMIC_BUFFER_ALIGNMENT
+    #define PL_VULKAN_DYNAMIC_BUFFER_ALIGNMENT 16
+#endif
+
+#ifndef PL_VULKAN_MAX_FRAMES_IN_FLIGHT
+    #define PL_VULKAN_MAX_FRAMES_IN_FLIGHT 4
+#endif
+
+// one extra bucket so the frame being recorded never collides with one still in flight
+#define PL_VULKAN_DELETION_BUCKET_COUNT (PL_VULKAN_MAX_FRAMES_IN_FLIGHT + 1)
+
+// descriptor slots in the global set (clamped to device limits), slot 0 of each
+// array always holds a default descriptor
+#ifndef PL_VULKAN_BINDLESS_TEXTURE_SLOTS
+    #define PL_VULKAN_BINDLESS_TEXTURE_SLOTS 16384
+#endif
+
+#ifndef PL_VULKAN_BINDLESS_BUFFER_SLOTS
+    #define PL_VULKAN_BINDLESS_BUFFER_SLOTS 4096
+#endif
+
+// used instead when descriptor indexing is unavailable
+#ifndef PL_VULKAN_FALLBACK_TEXTURE_SLOTS
+    #define PL_VULKAN_FALLBACK_TEXTURE_SLOTS 128
+#endif
+
+#ifndef PL_VULKAN_FALLBACK_BUFFER_SLOTS
+    #define PL_VULKAN_FALLBACK_BUFFER_SLOTS 16
+#endif
+
+#ifndef PL_VULKAN_RESIZE_DEBOUNCE_TIME
+    #define PL_VULKAN_RESIZE_DEBOUNCE_TIME 0.1 // seconds the window size must settle before the swapchain is rebuilt
+#endif
+
+#ifndef PL_VULKAN_READBACK_RING_SIZE
+    #define PL_VULKAN_READBACK_RING_SIZE 8 // readbacks that can be outstanding at once
+#endif
+
+#ifndef PL_VULKAN_STAGING_BUFFER_SIZE
+    #define PL_VULKAN_STAGING_BUFFER_SIZE 33554432 // initial size of the upload staging ring
+#endif
+
+#ifndef PL_VULKAN_STREAMING_UPLOAD_SIZE
+    #define PL_VULKAN_STREAMING_UPLOAD_SIZE 16777216 // streamed mip bytes uploaded per frame
+#endif
+
+#ifndef PL_VULKAN_STREAMING_MIN_EXTENT
+    #define PL_VULKAN_STREAMING_MIN_EXTENT 64 // streamed mips this size or smaller stay resident
+#endif
+
+#ifndef PL_VULKAN_STREAMING_BUDGET_FRACTION
+    #define PL_VULKAN_STREAMING_BUDGET_FRACTION 0.8 // share of free device memory streaming may grow into
+#endif
+
+#ifndef PL_VULKAN_PIPELINE_CACHE_FILE
+    #define PL_VULKAN_PIPELINE_CACHE_FILE "pl_pipeline_cache.bin"
+#endif
+
+#ifndef PL_VULKAN_MAX_CULL_PASSES
+    #define PL_VULKAN_MAX_CULL_PASSES 8 // cull_areas calls per frame
+#endif
+
+#ifndef PL_VULKAN_CULL_OUTPUT_SIZE
+    #define PL_VULKAN_CULL_OUTPUT_SIZE 1048576 // initial size of the indirect command buffer
+#endif
+
+// must match cull.comp & depth_pyramid*.comp
+#define PL_VULKAN_CULL_GROUP_SIZE    64
+#define PL_VULKAN_PYRAMID_GROUP_SIZE 8
+#define PL_VULKAN_MAX_PYRAMID_LEVELS 16
+#define PL_VULKAN_CULL_FLAG_OCCLUSION 1u // plVulkanCullConstants::uFlags
+
+#ifndef PL_VULKAN_SHADER_DIRECTORY
+    #define PL_VULKAN_SHADER_DIRECTORY "../shaders/glsl/" // default plGraphics::pcShaderDirectory
+#endif
+
+#ifndef PL_VULKAN_SHADER_CACHE_FILE
+    #define PL_VULKAN_SHADER_CACHE_FILE "pl_shader_cache.bin" // SPIR-V compiled at runtime, keyed by source hash
+#endif
+
+#ifndef PL_VULKAN_SHADER_CACHE_MAX_ENTRIES
+    #define PL_VULKAN_SHADER_CACHE_MAX_ENTRIES 256 // oldest entries are dropped when the cache is saved
+#endif
+
+#ifndef PL_VULKAN_SHADER_POLL_INTERVAL
+    #define PL_VULKAN_SHADER_POLL_INTERVAL 0.25 // seconds between source checks while hot reloading
+#endif
+
+// runtime GLSL compilation uses shaderc when built with PL_VULKAN_SHADERC
+// (link shaderc_shared), otherwise glslc is run as a separate process
+#ifndef PL_VULKAN_GLSLC
+    #define PL_VULKAN_GLSLC "glslc"
+#endif
+
+#define PL_VULKAN_SPIRV_MAGIC          0x07230203
+#define PL_VULKAN_SHADER_CACHE_MAGIC   0x43535050 // "PPSC"
+#define PL_VULKAN_SHADER_CACHE_VERSION 1
+
 #include "pl_ui.h"
 #include "pl_ui_vulkan.h"
 #include "vulkan/vulkan.h"
 
+#ifdef PL_VULKAN_SHADERC
+    #include <shaderc/shaderc.h>
+#endif
+
 #ifdef _WIN32
 #pragma comment(lib, "vulkan-1.lib")
 #endif
@@ -55,27 +171,20 @@ Index of this file:
 // [SECTION] global data
 //-----------------------------------------------------------------------------
 
-const plFileApiI* gptFile = NULL;
+const plFileApiI*    gptFile    = NULL;
+const plStatsApiI*   gptStats   = NULL;
+const plThreadsApiI* gptThreads = NULL;
 static uint32_t uLogChannel = UINT32_MAX;
 
 //-----------------------------------------------------------------------------
 // [SECTION] shaders
 //-----------------------------------------------------------------------------
 
-/*
-#version 450 core
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec4 aColor;
-layout(push_constant) uniform uPushConstant { mat4 tMVP; } pc;
-out gl_PerVertex { vec4 gl_Position; };
-layout(location = 0) out struct { vec4 Color; vec2 UV; } Out;
+// the 3D drawlist shaders are embedded so drawlists work without any files
+// next to the executable, loaded from disk instead when present (see
+// pl__create_shader_library)
 
-void main()
-{
-    Out.Color = aColor;
-    gl_Position = pc.tMVP * vec4(aPos, 1.0);
-}
-*/
+// shaders/glsl/draw_3d.vert
 static uint32_t __glsl_shader_vert_3d_spv[] =
 {
 	0x07230203,0x00010000,0x0008000b,0x00000027,0x00000000,0x00020011,0x00000001,0x0006000b,
@@ -115,17 +224,7 @@ static uint32_t __glsl_shader_vert_3d_spv[] =
 	0x00000025,0x000100fd,0x00010038
 };
 
-/*
-#version 450 core
-layout(location = 0) out vec4 fColor;
-layout(set=0, binding=0) uniform sampler2D sTexture;
-layout(location = 0) in struct { vec4 Color; vec2 UV; } In;
-void main()
-{
-    fColor = In.Color * texture(sTexture, In.UV.st);
-}
-*/
-
+// shaders/glsl/draw_3d.frag
 static uint32_t __glsl_shader_frag_3d_spv[] =
 {
 	0x07230203,0x00010000,0x0008000b,0x00000012,0x00000000,0x00020011,0x00000001,0x0006000b,
@@ -145,46 +244,7 @@ static uint32_t __glsl_shader_frag_3d_spv[] =
 	0x00000007,0x00000011,0x00000010,0x0003003e,0x00000009,0x00000011,0x000100fd,0x00010038
 };
 
-/*
-#version 450 core
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec4 aInfo;
-layout(location = 2) in vec3 aPosOther;
-layout(location = 3) in vec4 aColor;
-layout(push_constant) uniform uPushConstant { mat4 tMVP; float fAspect; } pc;
-out gl_PerVertex { vec4 gl_Position; };
-layout(location = 0) out struct { vec4 Color; } Out;
-
-void main()
-{
-    Out.Color = aColor;
-
-    // clip space
-    vec4 tCurrentProj = pc.tMVP * vec4(aPos.xyz, 1.0);
-    vec4 tOtherProj   = pc.tMVP * vec4(aPosOther.xyz, 1.0);
-
-    // NDC space
-    vec2 tCurrentNDC = tCurrentProj.xy / tCurrentProj.w;
-    vec2 tOtherNDC = tOtherProj.xy / tOtherProj.w;
-
-    // correct for aspect
-    tCurrentNDC.x *= pc.fAspect;
-    tOtherNDC.x *= pc.fAspect;
-
-    // normal of line (B - A)
-    vec2 dir = aInfo.z * normalize(tOtherNDC - tCurrentNDC);
-    vec2 normal = vec2(-dir.y, dir.x);
-
-    // extrude from center & correct aspect ratio
-    normal *= aInfo.y / 2.0;
-    normal.x /= pc.fAspect;
-
-    // offset by the direction of this point in the pair (-1 or 1)
-    vec4 offset = vec4(normal* aInfo.x, 0.0, 0.0);
-    gl_Position = tCurrentProj + offset;
-}
-*/
-
+// shaders/glsl/draw_3d_line.vert
 static uint32_t __glsl_shader_vert_3d_line_spv[] =
 {
 	0x07230203,0x00010000,0x0008000b,0x00000080,0x00000000,0x00020011,0x00000001,0x0006000b,
@@ -292,12 +352,66 @@ static uint32_t __glsl_shader_vert_3d_line_spv[] =
 // [SECTION] internal structs
 //-----------------------------------------------------------------------------
 
-typedef struct _pl3DBufferReturn
+typedef int plVulkanResourceType; // -> enum _plVulkanResourceType
+
+enum _plVulkanResourceType
 {
-    VkBuffer       tBuffer;
-    VkDeviceMemory tDeviceMemory;
-    int64_t        slFreedFrame;
-} pl3DBufferReturn;
+    PL_VULKAN_RESOURCE_TYPE_BUFFER,
+    PL_VULKAN_RESOURCE_TYPE_IMAGE,
+    PL_VULKAN_RESOURCE_TYPE_IMAGE_VIEW,
+    PL_VULKAN_RESOURCE_TYPE_FRAMEBUFFER,
+    PL_VULKAN_RESOURCE_TYPE_RENDER_PASS,
+    PL_VULKAN_RESOURCE_TYPE_PIPELINE,
+    PL_VULKAN_RESOURCE_TYPE_SAMPLER,
+    PL_VULKAN_RESOURCE_TYPE_MEMORY,
+    PL_VULKAN_RESOURCE_TYPE_SWAPCHAIN,    // retired swapchain (passed as oldSwapchain)
+    PL_VULKAN_RESOURCE_TYPE_COMMAND_BUFFER, // upload batch, freed back to the device pool
+    PL_VULKAN_RESOURCE_TYPE_TEXTURE_SLOT, // bindless slot, returned to the free list
+    PL_VULKAN_RESOURCE_TYPE_BUFFER_SLOT,  // bindless slot, returned to the free list
+    PL_VULKAN_RESOURCE_TYPE_DESCRIPTOR_SET // compute set, freed back to the device pool
+};
+
+enum _plVulkanShaderId
+{
+    PL_VULKAN_SHADER_PRIMITIVE_VERT,
+    PL_VULKAN_SHADER_PRIMITIVE_FRAG,
+    PL_VULKAN_SHADER_DRAW_3D_VERT,
+    PL_VULKAN_SHADER_DRAW_3D_FRAG,
+    PL_VULKAN_SHADER_DRAW_3D_LINE_VERT,
+    PL_VULKAN_SHADER_CULL_COMP,
+    PL_VULKAN_SHADER_DEPTH_PYRAMID_COMP,
+    PL_VULKAN_SHADER_DEPTH_PYRAMID_MS_COMP,
+    PL_VULKAN_SHADER_MESH_VERT,
+    PL_VULKAN_SHADER_MESH_FRAG,
+    PL_VULKAN_SHADER_COUNT
+};
+
+typedef struct _plVulkanDeletion
+{
+    plVulkanResourceType tType;
+    VkDeviceSize         szByteSize; // memory only, feeds the pending bytes stat
+    union
+    {
+        VkBuffer       tBuffer;
+        VkImage        tImage;
+        VkImageView    tImageView;
+        VkFramebuffer  tFramebuffer;
+        VkRenderPass   tRenderPass;
+        VkPipeline     tPipeline;
+        VkSampler      tSampler;
+        VkDeviceMemory tMemory;
+        VkSwapchainKHR  tSwapchain;
+        VkCommandBuffer tCommandBuffer;
+        VkDescriptorSet tDescriptorSet;
+        uint32_t        uSlot;
+    };
+} plVulkanDeletion;
+
+typedef struct _plVulkanDeletionBucket
+{
+    uint64_t          ulFrame; // frame the deletions were queued during
+    plVulkanDeletion* sbtDeletions;
+} plVulkanDeletionBucket;
 
 typedef struct _pl3DVulkanPipelineEntry
 {    
@@ -306,38 +420,351 @@ typedef struct _pl3DVulkanPipelineEntry
     VkPipeline            tRegularPipeline;
     VkPipeline            tSecondaryPipeline;
     pl3DDrawFlags         tFlags;
+    uint64_t              ulKey;      // key hash, t3DPipelineHashMap maps it to the first entry of its chain
+    uint32_t              uNextEntry; // next entry with the same key hash, UINT32_MAX ends the chain
 } pl3DVulkanPipelineEntry;
 
-typedef struct _pl3DVulkanBufferInfo
+typedef struct _plVulkanPipelineCacheHeader
 {
-    // vertex buffer
-    VkBuffer        tVertexBuffer;
-    VkDeviceMemory  tVertexMemory;
-    unsigned char*  ucVertexBufferMap;
-    uint32_t        uVertexByteSize;
-    uint32_t        uVertexBufferOffset;
-
-    // index buffer
-    VkBuffer       tIndexBuffer;
-    VkDeviceMemory tIndexMemory;
-    unsigned char* ucIndexBufferMap;
-    uint32_t       uIndexByteSize;
-    uint32_t       uIndexBufferOffset;
-} pl3DVulkanBufferInfo;
+    uint32_t uHeaderSize;
+    uint32_t uHeaderVersion; // VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+    uint32_t uVendorID;
+    uint32_t uDeviceID;
+    uint8_t  auPipelineCacheUUID[VK_UUID_SIZE];
+} plVulkanPipelineCacheHeader;
+
+typedef struct _plVulkanDynamicBuffer
+{
+    VkBuffer       tBuffer;
+    VkDeviceMemory tMemory;
+    VkDeviceSize   szMemoryByteSize;
+    unsigned char* pucMapping;      // persistent mapping
+    VkDeviceSize   szFrameByteSize; // size of each frame in flight's region
+    VkDeviceSize   szFrameOffset;   // next free byte in the current frame's region
+    VkDeviceSize   szFrameUsage;    // bytes requested this frame (survives growth)
+    VkDeviceSize   szHighWaterMark; // largest frame usage seen so far
+    bool           bHostCoherent;   // if false, written ranges must be flushed
+} plVulkanDynamicBuffer;
 
 typedef struct _plVulkanBuffer
 {
     VkBuffer       tBuffer;
     VkDeviceMemory tMemory;
+    uint32_t       uBindlessSlot; // storage buffers only, 0 (default slot) otherwise
 } plVulkanBuffer;
 
-typedef struct _plFrameGarbage
+typedef struct _plVulkanTexture
+{
+    VkImage        tImage;
+    VkImageView    tView;
+    VkDeviceMemory tMemory;
+    VkDeviceSize   szMemorySize;
+    VkFormat       tFormat;
+    VkFilter       tMipFilter;    // VK_FILTER_NEAREST if the format can't be filtered linearly
+    bool           bGenerateMips; // uncompressed, mips are blitted from mip 0
+    uint32_t       uBindlessSlot;
+
+    // streaming only, the image holds the uResidentMips smallest mips
+    plTextureStreamFunc tStreamFunc;
+    void*               pStreamUserData;
+    uint32_t            uMinMips;       // tail that is never evicted
+    uint32_t            uResidentMips;
+    uint32_t            uRequestedMips; // highest request since the last update
+    uint32_t            uTargetMips;    // requests applied at the last update
+    uint64_t            ulLastRequest;  // frame of the last request, drives LRU eviction
+} plVulkanTexture;
+
+typedef struct _plVulkanStagingRegion
+{
+    uint64_t     ulFrame;    // frame the batch was submitted ahead of
+    VkDeviceSize szByteSize; // includes alignment & wrap padding
+} plVulkanStagingRegion;
+
+typedef struct _plVulkanStagingRing
+{
+    VkBuffer               tBuffer;
+    VkDeviceMemory         tMemory;
+    VkDeviceSize           szSize;
+    unsigned char*         pucMapping;    // persistent mapping
+    bool                   bHostCoherent; // if false, flushed before each batch is submitted
+    VkDeviceSize           szHead;        // next free byte
+    VkDeviceSize           szUsed;        // bytes the GPU may still read (including the open batch)
+    VkDeviceSize           szBatchSize;   // bytes used by the open batch
+    VkCommandBuffer        tCmdBuf;       // open batch, VK_NULL_HANDLE if nothing is pending
+    plVulkanStagingRegion* sbtRegions;    // submitted batches, oldest first
+} plVulkanStagingRing;
+
+typedef struct _plVulkanBindlessHeap
+{
+    bool                    bDescriptorIndexing; // false -> fixed size arrays, one set per frame in flight
+    uint32_t                uTextureSlotCount;
+    uint32_t                uBufferSlotCount;
+    VkDescriptorSetLayout   tSetLayout;
+    VkDescriptorPool        tPool;
+    VkDescriptorSet         atSets[PL_VULKAN_MAX_FRAMES_IN_FLIGHT]; // only [0] is used with descriptor indexing
+
+    // slot allocation
+    uint32_t                uNextTextureSlot;
+    uint32_t                uNextBufferSlot;
+    uint32_t*               sbuFreeTextureSlots;
+    uint32_t*               sbuFreeBufferSlots;
+
+    // current slot contents, source for fallback set updates
+    VkDescriptorImageInfo*  atTextureInfos;
+    VkDescriptorBufferInfo* atBufferInfos;
+
+    // fallback only, slots written since each set was last updated
+    uint32_t*               asbuDirtyTextureSlots[PL_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    uint32_t*               asbuDirtyBufferSlots[PL_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    uint32_t                uActiveSets; // sets used by frames in flight, only these track dirty slots
+
+    // defaults bound to slot 0 & released slots
+    VkSampler               tSampler; // immutable
+    VkImage                 tDefaultImage;
+    VkImageView             tDefaultImageView;
+    VkDeviceMemory          tDefaultImageMemory;
+    VkBuffer                tDefaultBuffer;
+    VkDeviceMemory          tDefaultBufferMemory;
+} plVulkanBindlessHeap;
+
+typedef struct _plVulkanDrawConstants // push constants, mirrored by bindless shaders
+{
+    plMat4   tViewProjection;
+    uint32_t uMaterialBuffer; // bindless buffer slots
+    uint32_t uInstanceBuffer;
+    uint32_t uMaterialIndex;  // UINT32_MAX for culled areas, material comes from the instance
+    uint32_t uInstanceIndex;  // UINT32_MAX for culled areas, use gl_InstanceIndex (firstInstance)
+} plVulkanDrawConstants;
+
+typedef struct _plVulkanCullConstants // push constants, mirrored by cull.comp
+{
+    uint32_t uViewOffset; // uvec4s into the dynamic buffer
+    uint32_t uDrawOffset; // uvec4s into the dynamic buffer
+    uint32_t uDrawCount;
+    uint32_t uFlags;      // PL_VULKAN_CULL_FLAG_*
+} plVulkanCullConstants;
+
+typedef struct _plVulkanCullView // mirrored by cull.comp
+{
+    plMat4   tViewProjection;
+    plVec4   atPlanes[6];      // left, right, bottom, top, near, far
+    uint32_t auPyramidInfo[4]; // width, height, levels
+    plMat4   tPyramidViewProjection; // view the depth pyramid was rendered with (previous frame)
+} plVulkanCullView;
+
+typedef struct _plVulkanCullDraw // mirrored by cull.comp
+{
+    plVec4   tBoundingSphere;
+    uint32_t uIndexCount;
+    uint32_t uFirstIndex;
+    int32_t  iVertexOffset;
+    uint32_t uFirstInstance;
+    uint32_t uCountOffset;   // uints into the output buffer
+    uint32_t uCommandOffset; // uints into the output buffer
+    uint32_t _auPadding[2];
+} plVulkanCullDraw;
+
+typedef struct _plVulkanPyramidConstants // push constants, mirrored by depth_pyramid*.comp
+{
+    int32_t aiSourceSize[2];
+    int32_t aiDestinationSize[2];
+    int32_t iSampleCount; // multisampled level 0 only
+} plVulkanPyramidConstants;
+
+typedef struct _plVulkanCullRecord
+{
+    VkBuffer     tBuffer;         // output buffer the commands were written to (may grow mid frame)
+    VkDeviceSize szCountOffset;   // bytes
+    VkDeviceSize szCommandOffset; // bytes, VkDrawIndexedIndirectCommand[uMaxDraws]
+    uint32_t     uMaxDraws;
+} plVulkanCullRecord;
+
+typedef struct _plVulkanCulling
+{
+    VkDescriptorSetLayout tSetLayout;
+    VkPipelineLayout      tPipelineLayout;
+    VkPipeline            tPipeline;
+    VkDescriptorSet       aatSets[PL_VULKAN_MAX_FRAMES_IN_FLIGHT][PL_VULKAN_MAX_CULL_PASSES];
+    VkSampler             tSampler; // immutable, nearest
+
+    // indirect commands, device local & rewritten every pass (uint 0 counts survivors)
+    VkBuffer              tOutputBuffer;
+    VkDeviceMemory        tOutputMemory;
+    VkDeviceSize          szOutputSize;
+    VkDeviceSize          szOutputOffset; // next free byte this frame
+    uint32_t              uPassCount;     // this frame
+    plVulkanCullRecord*   sbtRecords;     // this frame, indexed by plDrawArea::_uCullRecord
+
+    // survivor counts copied back for stats, one uint per frame in flight
+    VkBuffer              tStatsBuffer;
+    VkDeviceMemory        tStatsMemory;
+    uint32_t*             puStatsMapping;
+    bool                  bStatsHostCoherent;
+    bool                  abStatsPending[PL_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    uint32_t              auInputDraws[PL_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    uint32_t              uInputDraws;   // last completed frame
+    uint32_t              uVisibleDraws; // last completed frame
+
+    // depth pyramid
+    VkDescriptorSetLayout tPyramidSetLayout;
+    VkPipelineLayout      tPyramidPipelineLayout;
+    VkPipeline            tPyramidPipeline;
+    VkPipeline            tPyramidMSPipeline; // level 0 from multisampled depth
+
+    PFN_vkCmdDrawIndexedIndirectCountKHR vkCmdDrawIndexedIndirectCount; // NULL if VK_KHR_draw_indirect_count is missing
+} plVulkanCulling;
+
+typedef int plVulkanShaderId; // -> enum _plVulkanShaderId
+
+typedef struct _plVulkanShader
+{
+    const char*           pcFile;         // GLSL source, the build writes "<pcFile>.spv" next to the executable
+    VkShaderStageFlagBits tStage;
+    const uint32_t*       puEmbeddedCode; // last resort when neither is found (may be NULL)
+    size_t                szEmbeddedSize;
+    VkShaderModule        tModule;
+    uint64_t              ulSourceTime;   // source modified time when last checked
+    uint64_t              ulSourceHash;   // 0 -> not built from source
+} plVulkanShader;
+
+typedef struct _plVulkanShaderBlob
+{
+    uint64_t  ulSourceHash;
+    uint32_t* puCode;
+    size_t    szSize; // bytes
+} plVulkanShaderBlob;
+
+typedef struct _plVulkanShaderLibrary
+{
+    plVulkanShader      atShaders[PL_VULKAN_SHADER_COUNT];
+    char                acDirectory[PL_MAX_PATH_LENGTH];
+    double              dLastPoll;
+
+    // compiled SPIR-V, saved at shutdown
+    plHashMap           tCacheMap; // source hash -> index into sbtCache
+    plVulkanShaderBlob* sbtCache;
+    bool                bCacheDirty;
+
+#ifdef PL_VULKAN_SHADERC
+    shaderc_compiler_t  tCompiler;
+#endif
+} plVulkanShaderLibrary;
+
+typedef struct _plVulkanShaderVariant
+{
+    plGraphicsState tState;
+    VkPipeline      tPipeline; // VK_NULL_HANDLE while compiling
+    uint32_t        uFallback; // drawn until ready (itself for fallbacks)
+} plVulkanShaderVariant;
+
+typedef struct _plVulkanVariantJob
+{
+    uint32_t              uVariant;
+    plGraphicsState       tState;
+    VkRenderPass          tRenderPass;  // copied when queued, the worker never reads plVulkanGraphics state
+    VkSampleCountFlagBits tSampleCount;
+    VkPipeline            tPipeline;    // set by the worker
+} plVulkanVariantJob;
+
+typedef struct _plVulkanVariantManager
+{
+    plVulkanShaderVariant* sbtVariants; // handles are 1 based, [0] is unused
+    plHashMap              tVariantMap; // state hash (rehashed on collisions) -> handle
+
+    // worker, only touches the job lists (guarded by ptMutex), the jobs' copies
+    // of render state & shader modules (swapped only while it's idle)
+    plThread*              ptThread; // NULL -> variants are compiled on request
+    plMutex*               ptMutex;
+    plConditionVariable*   ptWorkCondition; // jobs queued or quitting
+    plConditionVariable*   ptIdleCondition; // queue drained
+    plVulkanVariantJob*    sbtQueuedJobs;
+    plVulkanVariantJob*    sbtFinishedJobs;
+    bool                   bWorkerBusy;
+    bool                   bQuit;
+} plVulkanVariantManager;
+
+typedef struct _plVulkanGraphTexture
+{
+    VkImage              tImage;
+    VkImageView          tView;
+    VkFormat             tFormat;
+    VkImageAspectFlags   tAspect;
+    VkImageLayout        tLayout;  // tracked across passes (and frames for persistent textures)
+    VkMemoryRequirements tMemReqs;
+    VkDeviceMemory       tMemory;  // only set for persistent textures, transients live in alias slots
+    uint32_t             uBindlessSlot; // 0 if not sampleable (multisampled or depth stencil)
+} plVulkanGraphTexture;
+
+typedef struct _plVulkanGraphPass
+{
+    VkRenderPass          tRenderPass;
+    VkFramebuffer         tFramebuffer;
+    VkExtent2D            tExtent;
+    VkSampleCountFlagBits tSampleCount;
+} plVulkanGraphPass;
+
+typedef struct _plVulkanRenderGraph
+{
+    uint64_t              ulHash; // compiled graph these resources were built for
+    plVulkanGraphTexture* sbtTextures;
+    plVulkanGraphPass*    sbtPasses;
+    VkDeviceMemory*       sbtMemory;      // one per alias slot
+    VkDeviceSize*         sbtMemorySizes; // parallel to sbtMemory
+} plVulkanRenderGraph;
+
+typedef struct _plVulkanAttachment
+{
+    VkImage        tImage;
+    VkImageView    tView;
+    VkDeviceMemory tMemory;
+    VkDeviceSize   szMemorySize;
+} plVulkanAttachment;
+
+typedef struct _plVulkanRenderTarget
+{
+    VkRenderPass          tRenderPass; // VK_NULL_HANDLE once destroyed
+    VkFramebuffer         tFramebuffer;
+    VkExtent2D            tExtent;
+    plFormat              tFormat;
+    VkSampleCountFlagBits tSampleCount;
+    VkClearValue          atClearValues[3];
+    uint32_t              uClearValueCount;
+    bool                  bRendered;     // output layout is only valid after the first pass
+    uint32_t              uBindlessSlot;
+    plVulkanAttachment    tOutput;       // single sampled, sampled & read back (resolve target if multisampled)
+    plVulkanAttachment    tMultisampled; // only if tSampleCount > 1
+    plVulkanAttachment    tDepth;        // only if requested
+
+    // max depth pyramid, only if requested (kept in VK_IMAGE_LAYOUT_GENERAL)
+    VkImage               tPyramidImage;
+    VkDeviceMemory        tPyramidMemory;
+    VkDeviceSize          szPyramidMemorySize;
+    VkImageView           tPyramidView;      // every level, sampled by cull.comp
+    VkImageView           tDepthSampledView; // depth aspect only
+    uint32_t              uPyramidLevels;
+    VkImageView           atPyramidLevelViews[PL_VULKAN_MAX_PYRAMID_LEVELS];
+    VkDescriptorSet       atPyramidSets[PL_VULKAN_MAX_PYRAMID_LEVELS]; // level i is built from level i - 1 (depth for level 0)
+    bool                  bPyramidBuilt;     // only tested against once built
+    plMat4                tPyramidViewProjection; // view the pyramid's depth was rendered with
+    bool                  bPyramidView;           // false -> pyramid wasn't preceded by a cull, frustum only
+    plMat4                tPendingViewProjection; // cull_areas view this frame, applies to the next pyramid
+    bool                  bPendingView;
+} plVulkanRenderTarget;
+
+typedef struct _plVulkanReadback
 {
-    VkImage*        sbtTextures;
-    VkImageView*    sbtTextureViews;
-    VkFramebuffer*  sbtFrameBuffers;
-    VkDeviceMemory* sbtMemory;
-} plFrameGarbage;
+    VkBuffer       tBuffer;
+    VkDeviceMemory tMemory;
+    VkDeviceSize   szSize;
+    void*          pMapping;      // persistent mapping
+    bool           bHostCoherent; // if false, invalidated before the CPU reads
+    bool           bInUse;
+    uint64_t       ulFrame;       // frame the copy was recorded in
+    plFormat       tFormat;
+    uint32_t       uWidth;
+    uint32_t       uHeight;
+    uint32_t       uRowPitch;
+} plVulkanReadback;
 
 typedef struct _plFrameContext
 {
@@ -346,6 +773,7 @@ typedef struct _plFrameContext
     VkFence         tInFlight;
     VkCommandPool   tCmdPool;
     VkCommandBuffer tCmdBuf;
+    uint64_t        ulSubmittedFrame; // last frame submitted with this context (0 if none)
 } plFrameContext;
 
 typedef struct _plVulkanSwapchain
@@ -365,7 +793,7 @@ typedef struct _plVulkanSwapchain
     VkDeviceMemory           tDepthTextureMemory;
     VkImageView              tDepthTextureView;
     uint32_t                 uCurrentImageIndex; // current image to use within the swap chain
-    bool                     bVSync;
+    VkPresentModeKHR         tPresentMode;       // mode actually in use (requested mode may be unsupported)
     VkSampleCountFlagBits    tMsaaSamples;
     VkSurfaceFormatKHR*      sbtSurfaceFormats;
 
@@ -387,9 +815,11 @@ typedef struct _plVulkanDevice
     VkPhysicalDeviceFeatures                  tDeviceFeatures;
     bool                                      bSwapchainExtPresent;
     bool                                      bPortabilitySubsetPresent;
+    bool                                      bMemoryBudgetExtPresent;
+    bool                                      bDrawIndirectCountExtPresent;
     VkCommandPool                             tCmdPool;
+    VkDescriptorPool                          tComputePool; // culling & depth pyramid sets
     uint32_t                                  uUniformBufferBlockSize;
-    uint32_t                                  uCurrentFrame;
 
 	PFN_vkDebugMarkerSetObjectTagEXT  vkDebugMarkerSetObjectTag;
 	PFN_vkDebugMarkerSetObjectNameEXT vkDebugMarkerSetObjectName;
@@ -397,8 +827,28 @@ typedef struct _plVulkanDevice
 	PFN_vkCmdDebugMarkerEndEXT        vkCmdDebugMarkerEnd;
 	PFN_vkCmdDebugMarkerInsertEXT     vkCmdDebugMarkerInsert;
 
-    // [INTERNAL]
-    plFrameGarbage* _sbtFrameGarbage;
+    // deferred destruction
+    uint64_t               ulFrameCount;     // frame being recorded, starts at 1
+    uint64_t               ulCompletedFrame; // newest frame known to be finished by the GPU
+    plVulkanDeletionBucket atDeletionBuckets[PL_VULKAN_DELETION_BUCKET_COUNT];
+    uint32_t               uPendingDeletions;
+    VkDeviceSize           szPendingDeletionBytes;
+    uint32_t*              sbuFreeBufferIndices;
+    uint32_t*              sbuFreeTextureIndices;
+
+    // uploads, submitted ahead of the next frame
+    plVulkanStagingRing    tStaging;
+
+    // texture streaming
+    uint32_t*              sbuStreamedTextures;    // texture indices
+    uint32_t               uStreamingCursor;       // first texture offered upload bandwidth next update
+    VkDeviceSize           szStreamingBudget;      // 0 -> derived from the memory budget
+    VkDeviceSize           szStreamingBudgetInUse; // budget applied at the last update
+    VkDeviceSize           szStreamingResident;
+    VkDeviceSize           szStreamingRequested;
+
+    // global descriptor set
+    plVulkanBindlessHeap   tBindless;
 
 } plVulkanDevice;
 
@@ -409,35 +859,26 @@ typedef struct _plVulkanGraphics
     VkSurfaceKHR             tSurface;
     plFrameContext*          sbFrames;
     VkRenderPass             tRenderPass;
-    uint32_t                 uFramesInFlight;
+    VkRenderPass             tCurrentRenderPass;  // render pass being recorded (main or render graph pass)
+    VkSampleCountFlagBits    tCurrentSampleCount;
+    uint32_t                 uFramesInFlight;     // applied value of plGraphics::uFramesInFlight
     size_t                   szCurrentFrameIndex; // current frame being used
     VkDescriptorPool         tDescriptorPool;
     plVulkanSwapchain        tSwapchain;
+    bool                     bSwapchainDirty;   // desc changed or swapchain out of date, rebuild next frame
+    bool                     bResizePending;    // rebuild once the window size settles
+    double                   dLastResizeTime;
 
 
     VkPipelineLayout                  g_pipelineLayout;
     VkPipeline                        g_pipeline;
     VkVertexInputAttributeDescription g_attributeDescriptions[2];
     VkVertexInputBindingDescription   g_bindingDescriptions[1];
-    VkShaderModule                    g_vertexShaderModule;
-    VkShaderModule                    g_pixelShaderModule;
 
     // drawing
 
-    // committed buffers
-    pl3DBufferReturn*                  sbReturnedBuffers;
-    pl3DBufferReturn*                  sbReturnedBuffersTemp;
-    uint32_t                           uBufferDeletionQueueSize;
-
-    // vertex & index buffer
-    pl3DVulkanBufferInfo*              sbt3DBufferInfo;
-    pl3DVulkanBufferInfo*              sbtLineBufferInfo;
-
-    // staging buffer
-    size_t                            szStageByteSize;
-    VkBuffer                          tStagingBuffer;
-    VkDeviceMemory                    tStagingMemory;
-    void*                             pStageMapping; // persistent mapping for staging buffer
+    // dynamic geometry (3D drawlists), one region per frame in flight
+    plVulkanDynamicBuffer              tDynamicBuffer;
 
     // 3D drawlist pipeline caching
     VkPipelineLayout                  t3DPipelineLayout;
@@ -448,8 +889,41 @@ typedef struct _plVulkanGraphics
     VkPipelineLayout                  t3DLinePipelineLayout;
     VkPipelineShaderStageCreateInfo   t3DLineVtxShdrStgInfo;
 
+    // shader modules & the pipelines built from them
+    plVulkanShaderLibrary             tShaders;
+    plVulkanVariantManager            tVariants;
+
     // pipelines
-    pl3DVulkanPipelineEntry*            sbt3DPipelines;
+    VkPipelineCache                   tPipelineCache;
+    plHashMap                         t3DPipelineHashMap; // pipeline key hash -> first entry of its chain in sbt3DPipelines
+    pl3DVulkanPipelineEntry*          sbt3DPipelines;     // released entries have no pipelines
+    uint32_t*                         sbu3DPipelineFreeEntries; // unlinked chain entries, former heads are on the map's free list
+
+    // render graph
+    plVulkanRenderGraph               tRenderGraph;
+
+    // GPU culling
+    plVulkanCulling                   tCulling;
+
+    // offscreen render targets & readback ring
+    plVulkanRenderTarget*             sbtRenderTargets;
+    uint32_t*                         sbuFreeRenderTargets;
+    uint32_t                          uActiveRenderTarget; // PL_RENDER_TARGET_NONE outside of begin/end_render_target
+    bool                              bInMainPass;
+    plVulkanReadback                  atReadbacks[PL_VULKAN_READBACK_RING_SIZE];
+    uint32_t                          uNextReadback;
+
+    // stats
+    double                            dCpuWaitTime; // ms blocked on fences in begin_frame
+    double*                           pdPendingDeletions;
+    double*                           pdPendingDeletionBytes;
+    double*                           pdCpuWaitTime;
+    double*                           pdStreamingResident;
+    double*                           pdStreamingRequested;
+    double*                           pdStreamingBudget;
+    double*                           pdShaderVariantsPending;
+    double*                           pdCullInputDraws;
+    double*                           pdCullVisibleDraws;
 } plVulkanGraphics;
 
 //-----------------------------------------------------------------------------
@@ -457,12 +931,105 @@ typedef struct _plVulkanGraphics
 //-----------------------------------------------------------------------------
 
 // 3D drawing
-static void                   pl__grow_vulkan_3d_vertex_buffer   (plGraphics* ptGraphics, uint32_t uVtxBufSzNeeded, pl3DVulkanBufferInfo* ptBufferInfo);
-static void                   pl__grow_vulkan_3d_index_buffer    (plGraphics* ptGraphics, uint32_t uIdxBufSzNeeded, pl3DVulkanBufferInfo* ptBufferInfo);
+static void                   pl__create_dynamic_buffer          (plGraphics* ptGraphics, VkDeviceSize szFrameByteSize);
+static VkDeviceSize           pl__allocate_dynamic_data          (plGraphics* ptGraphics, VkDeviceSize szSize);
+static void                   pl__flush_dynamic_data             (plGraphics* ptGraphics, VkDeviceSize szOffset, VkDeviceSize szSize);
 static pl3DVulkanPipelineEntry* pl__get_3d_pipelines            (plGraphics* ptGfx, VkRenderPass tRenderPass, VkSampleCountFlagBits tMSAASampleCount, pl3DDrawFlags tFlags);
 
+// pipeline caching
+static uint64_t        pl__hash_pipeline_key  (VkRenderPass tRenderPass, VkSampleCountFlagBits tMSAASampleCount, pl3DDrawFlags tFlags);
+static VkPipelineCache pl__load_pipeline_cache(plVulkanDevice* ptVulkanDevice, const char* pcFile);
+static void            pl__save_pipeline_cache(plVulkanDevice* ptVulkanDevice, VkPipelineCache tPipelineCache, const char* pcFile);
+
 static void pl__submit_3d_drawlist(plDrawList3D* ptDrawlist, float fWidth, float fHeight, const plMat4* ptMVP, pl3DDrawFlags tFlags);
 
+// render graph
+static VkFormat pl__vulkan_format             (plFormat tFormat);
+static void     pl__build_render_graph        (plGraphics* ptGraphics);
+static void     pl__destroy_render_graph      (plGraphics* ptGraphics);
+static void     pl__execute_render_graph      (plGraphics* ptGraphics);
+static void     pl__invalidate_graph_pipelines(plGraphics* ptGraphics, VkRenderPass tRenderPass); // VK_NULL_HANDLE -> every render pass
+
+// deferred destruction
+static void pl__queue_deletion  (plVulkanDevice* ptVulkanDevice, plVulkanDeletion tDeletion);
+static void pl__retire_deletions(plVulkanDevice* ptVulkanDevice, bool bForce);
+
+// bindless descriptors
+static void     pl__create_bindless_heap     (plGraphics* ptGraphics);
+static void     pl__destroy_bindless_heap    (plVulkanDevice* ptVulkanDevice);
+static uint32_t pl__allocate_bindless_texture(plVulkanDevice* ptVulkanDevice, VkImageView tView, VkImageLayout tLayout);
+static uint32_t pl__allocate_bindless_buffer (plVulkanDevice* ptVulkanDevice, VkBuffer tBuffer, VkDeviceSize szRange);
+static void     pl__release_bindless_slot    (plVulkanDevice* ptVulkanDevice, plVulkanResourceType tType, uint32_t uSlot);
+static void     pl__flush_bindless_writes    (plVulkanDevice* ptVulkanDevice, uint32_t uFrameIndex);
+static void     pl__set_bindless_active_sets (plVulkanDevice* ptVulkanDevice, uint32_t uSetCount); // idle device only
+
+// swapchain
+static void pl__create_main_framebuffers(plGraphics* ptGraphics);
+static bool pl__recreate_swapchain      (plGraphics* ptGraphics);
+
+// offscreen rendering
+static plVulkanAttachment pl__create_attachment        (plGraphics* ptGraphics, VkFormat tFormat, VkExtent2D tExtent, VkSampleCountFlagBits tSamples, VkImageUsageFlags tUsage, VkImageAspectFlags tAspect, const char* pcName);
+static void               pl__queue_attachment_deletion(plVulkanDevice* ptVulkanDevice, plVulkanAttachment* ptAttachment);
+static void               pl__destroy_readback_buffer  (plVulkanDevice* ptVulkanDevice, plVulkanReadback* ptReadback);
+
+// uploads
+static void            pl__create_staging_ring  (plVulkanDevice* ptVulkanDevice, VkDeviceSize szSize);
+static void            pl__destroy_staging_ring (plVulkanDevice* ptVulkanDevice);
+static VkDeviceSize    pl__stage_upload         (plDevice* ptDevice, const void* pData, size_t szSize, VkDeviceSize szAlignment); // NULL pData -> reserve only
+static VkCommandBuffer pl__get_upload_cmd_buffer(plVulkanDevice* ptVulkanDevice);
+static void            pl__flush_uploads        (plVulkanDevice* ptVulkanDevice);
+static uint32_t        pl__get_texture_slot     (plDevice* ptDevice, plVulkanTexture* ptTexture, const plTextureDesc* ptDesc);
+static void            pl__create_texture_image (plDevice* ptDevice, plVulkanTexture* ptTexture, uint32_t uWidth, uint32_t uHeight, uint32_t uMips, VkImageUsageFlags tUsage, const char* pcName);
+static void            pl__record_texture_upload(plDevice* ptDevice, uint32_t uTextureIndex, const void* pData, size_t szSize, VkImageLayout tOldLayout);
+
+// texture streaming
+static VkDeviceSize pl__get_streaming_budget    (plVulkanDevice* ptVulkanDevice);
+static bool         pl__evict_streamed_textures (plDevice* ptDevice, VkDeviceSize szTargetResident, uint64_t ulRequestedBefore, uint32_t uExcludedTexture);
+static void         pl__update_texture_streaming(plDevice* ptDevice);
+static void         pl__set_texture_residency   (plDevice* ptDevice, uint32_t uTextureIndex, uint32_t uResidentMips, const void** apMipData);
+
+// shaders
+static char*          pl__read_file_if_exists     (const char* pcFile, size_t* pszSizeOut); // PL_FREE result
+static VkShaderModule pl__create_shader_module    (plVulkanDevice* ptVulkanDevice, const uint32_t* puCode, size_t szSize);
+static void           pl__load_shader_cache       (plVulkanShaderLibrary* ptLibrary, const char* pcFile);
+static void           pl__save_shader_cache       (plVulkanShaderLibrary* ptLibrary, const char* pcFile);
+static void           pl__create_shader_library   (plGraphics* ptGraphics);
+static void           pl__destroy_shader_library  (plGraphics* ptGraphics);
+static bool           pl__build_shader_from_source(plGraphics* ptGraphics, plVulkanShaderId tShader, VkShaderModule* ptOldModuleOut);
+static bool           pl__compile_glsl            (plVulkanShaderLibrary* ptLibrary, const plVulkanShader* ptShader, const char* pcPath, const char* pcSource, size_t szSourceSize, uint32_t** ppuCodeOut, size_t* pszSizeOut);
+static void           pl__rebuild_shader_pipelines(plGraphics* ptGraphics, uint32_t uChangedShaders);
+static void           pl__create_main_pipeline    (plGraphics* ptGraphics);
+static VkPipeline     pl__create_compute_pipeline (plVulkanGraphics* ptVulkanGfx, plVulkanDevice* ptVulkanDevice, VkPipelineLayout tLayout, VkShaderModule tModule);
+
+// shader variants
+static plGraphicsState pl__normalize_variant_state   (plGraphicsState tState);
+static plGraphicsState pl__get_fallback_variant_state(plGraphicsState tState);
+static VkPipeline      pl__create_variant_pipeline   (plGraphics* ptGraphics, plGraphicsState tState, VkRenderPass tRenderPass, VkSampleCountFlagBits tSampleCount); // thread safe
+static void*           pl__shader_variant_worker     (void* pData);
+static void            pl__create_variant_manager    (plGraphics* ptGraphics);
+static void            pl__destroy_variant_manager   (plGraphics* ptGraphics);
+static void            pl__queue_variant_job         (plGraphics* ptGraphics, uint32_t uVariant);
+static void            pl__update_shader_variants    (plGraphics* ptGraphics);
+static void            pl__invalidate_shader_variants(plGraphics* ptGraphics);
+static uint32_t        pl__find_shader_variant       (plVulkanVariantManager* ptManager, plGraphicsState tState, uint64_t* pulHashOut); // 0 -> not found, free key written
+static VkPipeline      pl__get_variant_pipeline      (plGraphics* ptGraphics, uint32_t uVariant); // falls back until ready
+static void            pl__bind_mesh_buffers         (plGraphics* ptGraphics, VkCommandBuffer tCmdBuf, const plMesh* ptMesh); // positions, packed attributes & indices
+
+// gpu culling
+static void           pl__create_culling              (plGraphics* ptGraphics);
+static void           pl__destroy_culling             (plGraphics* ptGraphics);
+static void           pl__create_cull_output          (plGraphics* ptGraphics, VkDeviceSize szSize);
+static void           pl__read_cull_stats             (plGraphics* ptGraphics);
+static void           pl__create_depth_pyramid        (plGraphics* ptGraphics, plVulkanRenderTarget* ptTarget);
+static void           pl__queue_depth_pyramid_deletion(plVulkanDevice* ptVulkanDevice, plVulkanRenderTarget* ptTarget);
+static void           pl__build_depth_pyramid         (plGraphics* ptGraphics, plVulkanRenderTarget* ptTarget);
+
+// frame pacing
+static double         pl__get_wall_clock         (void);
+static plFrameContext pl__create_frame_context   (plVulkanDevice* ptVulkanDevice);
+static void           pl__destroy_frame_context  (plVulkanDevice* ptVulkanDevice, plFrameContext* ptFrame);
+static void           pl__resize_frame_contexts  (plGraphics* ptGraphics, uint32_t uFramesInFlight);
+
 static plFrameContext*
 pl_get_frame_resources(plGraphics* ptGraphics)
 {
@@ -571,111 +1138,132 @@ format_has_stencil(VkFormat tFormat)
 }
 
 static void
-transition_image_layout(VkCommandBuffer tCommandBuffer, VkImage tImage, VkImageLayout tOldLayout, VkImageLayout tNewLayout, VkImageSubresourceRange tSubresourceRange, VkPipelineStageFlags tSrcStageMask, VkPipelineStageFlags tDstStageMask)
+pl__queue_deletion(plVulkanDevice* ptVulkanDevice, plVulkanDeletion tDeletion)
 {
-    //VkCommandBuffer commandBuffer = mvBeginSingleTimeCommands();
-    VkImageMemoryBarrier tBarrier = {
-        .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .oldLayout           = tOldLayout,
-        .newLayout           = tNewLayout,
-        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .image               = tImage,
-        .subresourceRange    = tSubresourceRange,
-    };
+    plVulkanDeletionBucket* ptBucket = &ptVulkanDevice->atDeletionBuckets[ptVulkanDevice->ulFrameCount % PL_VULKAN_DELETION_BUCKET_COUNT];
+    PL_ASSERT((pl_sb_size(ptBucket->sbtDeletions) == 0 || ptBucket->ulFrame == ptVulkanDevice->ulFrameCount) && "deletion bucket reused before retiring");
+    ptBucket->ulFrame = ptVulkanDevice->ulFrameCount;
+    pl_sb_push(ptBucket->sbtDeletions, tDeletion);
+    ptVulkanDevice->uPendingDeletions++;
+    ptVulkanDevice->szPendingDeletionBytes += tDeletion.szByteSize;
+}
+
+static void
+pl__retire_deletions(plVulkanDevice* ptVulkanDevice, bool bForce)
+{
+    const VkDevice tDevice = ptVulkanDevice->tLogicalDevice;
+    for(uint32_t i = 0; i < PL_VULKAN_DELETION_BUCKET_COUNT; i++)
+    {
+        plVulkanDeletionBucket* ptBucket = &ptVulkanDevice->atDeletionBuckets[i];
+        const uint32_t uDeletionCount = pl_sb_size(ptBucket->sbtDeletions);
+        if(uDeletionCount == 0 || (!bForce && ptBucket->ulFrame > ptVulkanDevice->ulCompletedFrame))
+            continue;
+
+        for(uint32_t j = 0; j < uDeletionCount; j++)
+        {
+            const plVulkanDeletion* ptDeletion = &ptBucket->sbtDeletions[j];
+            switch(ptDeletion->tType)
+            {
+                case PL_VULKAN_RESOURCE_TYPE_BUFFER:      vkDestroyBuffer(tDevice, ptDeletion->tBuffer, NULL); break;
+                case PL_VULKAN_RESOURCE_TYPE_IMAGE:       vkDestroyImage(tDevice, ptDeletion->tImage, NULL); break;
+                case PL_VULKAN_RESOURCE_TYPE_IMAGE_VIEW:  vkDestroyImageView(tDevice, ptDeletion->tImageView, NULL); break;
+                case PL_VULKAN_RESOURCE_TYPE_FRAMEBUFFER: vkDestroyFramebuffer(tDevice, ptDeletion->tFramebuffer, NULL); break;
+                case PL_VULKAN_RESOURCE_TYPE_RENDER_PASS: vkDestroyRenderPass(tDevice, ptDeletion->tRenderPass, NULL); break;
+                case PL_VULKAN_RESOURCE_TYPE_PIPELINE:    vkDestroyPipeline(tDevice, ptDeletion->tPipeline, NULL); break;
+                case PL_VULKAN_RESOURCE_TYPE_SAMPLER:     vkDestroySampler(tDevice, ptDeletion->tSampler, NULL); break;
+                case PL_VULKAN_RESOURCE_TYPE_MEMORY:      vkFreeMemory(tDevice, ptDeletion->tMemory, NULL); break;
+                case PL_VULKAN_RESOURCE_TYPE_SWAPCHAIN:   vkDestroySwapchainKHR(tDevice, ptDeletion->tSwapchain, NULL); break;
+                case PL_VULKAN_RESOURCE_TYPE_COMMAND_BUFFER: vkFreeCommandBuffers(tDevice, ptVulkanDevice->tCmdPool, 1, &ptDeletion->tCommandBuffer); break;
+                case PL_VULKAN_RESOURCE_TYPE_TEXTURE_SLOT:
+                case PL_VULKAN_RESOURCE_TYPE_BUFFER_SLOT: pl__release_bindless_slot(ptVulkanDevice, ptDeletion->tType, ptDeletion->uSlot); break;
+                case PL_VULKAN_RESOURCE_TYPE_DESCRIPTOR_SET: vkFreeDescriptorSets(tDevice, ptVulkanDevice->tComputePool, 1, &ptDeletion->tDescriptorSet); break;
+                default: PL_ASSERT(false && "unknown resource type");
+            }
+            ptVulkanDevice->szPendingDeletionBytes -= ptDeletion->szByteSize;
+        }
+        ptVulkanDevice->uPendingDeletions -= uDeletionCount;
+        pl_sb_reset(ptBucket->sbtDeletions);
+    }
+}
 
-    // Source layouts (old)
-    // Source access mask controls actions that have to be finished on the old layout
-    // before it will be transitioned to the new layout
-    switch (tOldLayout)
+static void
+pl__get_layout_sync(VkImageLayout tLayout, VkPipelineStageFlags* ptStagesOut, VkAccessFlags* ptAccessOut)
+{
+    // stages & accesses that touch an image while it is in a given layout
+    switch (tLayout)
     {
         case VK_IMAGE_LAYOUT_UNDEFINED:
-            // Image layout is undefined (or does not matter)
-            // Only valid as initial layout
-            // No flags required, listed only for completeness
-            tBarrier.srcAccessMask = 0;
+            // contents don't matter, nothing to wait on
+            *ptStagesOut = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            *ptAccessOut = 0;
             break;
 
         case VK_IMAGE_LAYOUT_PREINITIALIZED:
-            // Image is preinitialized
-            // Only valid as initial layout for linear images, preserves memory contents
-            // Make sure host writes have been finished
-            tBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
+            *ptStagesOut = VK_PIPELINE_STAGE_HOST_BIT;
+            *ptAccessOut = VK_ACCESS_HOST_WRITE_BIT;
             break;
 
         case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-            // Image is a color attachment
-            // Make sure any writes to the color buffer have been finished
-            tBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            *ptStagesOut = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            *ptAccessOut = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
             break;
 
         case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-            // Image is a depth/stencil attachment
-            // Make sure any writes to the depth/stencil buffer have been finished
-            tBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            *ptStagesOut = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            *ptAccessOut = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
             break;
 
         case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
-            // Image is a transfer source
-            // Make sure any reads from the image have been finished
-            tBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            *ptStagesOut = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            *ptAccessOut = VK_ACCESS_TRANSFER_READ_BIT;
             break;
 
         case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-            // Image is a transfer destination
-            // Make sure any writes to the image have been finished
-            tBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            *ptStagesOut = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            *ptAccessOut = VK_ACCESS_TRANSFER_WRITE_BIT;
             break;
 
         case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-            // Image is read by a shader
-            // Make sure any shader reads from the image have been finished
-            tBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            break;
-        default:
-            // Other source layouts aren't handled (yet)
-            break;
-        }
-
-        // Target layouts (new)
-        // Destination access mask controls the dependency for the new image layout
-        switch (tNewLayout)
-        {
-        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-            // Image will be used as a transfer destination
-            // Make sure any writes to the image have been finished
-            tBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            break;
-
-        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
-            // Image will be used as a transfer source
-            // Make sure any reads from the image have been finished
-            tBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            *ptStagesOut = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            *ptAccessOut = VK_ACCESS_SHADER_READ_BIT;
             break;
 
-        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-            // Image will be used as a color attachment
-            // Make sure any writes to the color buffer have been finished
-            tBarrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        case VK_IMAGE_LAYOUT_GENERAL:
+            // storage images (depth pyramids)
+            *ptStagesOut = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            *ptAccessOut = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
             break;
 
-        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-            // Image layout will be used as a depth/stencil attachment
-            // Make sure any writes to depth/stencil buffer have been finished
-            tBarrier.dstAccessMask = tBarrier.dstAccessMask | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+            *ptStagesOut = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            *ptAccessOut = 0;
             break;
 
-        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-            // Image will be read in a shader (sampler, input attachment)
-            // Make sure any writes to the image have been finished
-            if (tBarrier.srcAccessMask == 0)
-                tBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
-            tBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            break;
         default:
-            // Other source layouts aren't handled (yet)
+            // not expected, be conservative
+            *ptStagesOut = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            *ptAccessOut = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
             break;
     }
+}
+
+static void
+pl__transition_image_layout(VkCommandBuffer tCommandBuffer, VkImage tImage, VkImageLayout tOldLayout, VkImageLayout tNewLayout, VkImageSubresourceRange tSubresourceRange)
+{
+    VkImageMemoryBarrier tBarrier = {
+        .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .oldLayout           = tOldLayout,
+        .newLayout           = tNewLayout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image               = tImage,
+        .subresourceRange    = tSubresourceRange,
+    };
+
+    VkPipelineStageFlags tSrcStageMask = 0;
+    VkPipelineStageFlags tDstStageMask = 0;
+    pl__get_layout_sync(tOldLayout, &tSrcStageMask, &tBarrier.srcAccessMask);
+    pl__get_layout_sync(tNewLayout, &tDstStageMask, &tBarrier.dstAccessMask);
     vkCmdPipelineBarrier(tCommandBuffer, tSrcStageMask, tDstStageMask, 0, 0, NULL, 0, NULL, 1, &tBarrier);
 }
 
@@ -712,7 +1300,7 @@ create_swapchain(plGraphics* ptGraphics, uint32_t uWidth, uint32_t uHeight, plVu
     plVulkanGraphics* ptVulkanGfx    = ptGraphics->_pInternalData;
     plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
 
-    vkDeviceWaitIdle(ptVulkanDevice->tLogicalDevice);
+    // no device wait, everything replaced here goes through the deletion queue
 
     ptSwapchainOut->tMsaaSamples = get_max_sample_count(&ptGraphics->tDevice);
 
@@ -768,21 +1356,29 @@ create_swapchain(plGraphics* ptGraphics, uint32_t uWidth, uint32_t uHeight, plVu
     }
     PL_ASSERT(bPreferenceFound && "no preferred surface format found");
 
-    // chose swap present mode
+    // chose swap present mode (FIFO is always supported)
+    VkPresentModeKHR tRequestedPresentMode = VK_PRESENT_MODE_FIFO_KHR;
+    switch(ptGraphics->tSwapchainDesc.tPresentMode)
+    {
+        case PL_PRESENT_MODE_FIFO_RELAXED: tRequestedPresentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR; break;
+        case PL_PRESENT_MODE_MAILBOX:      tRequestedPresentMode = VK_PRESENT_MODE_MAILBOX_KHR; break;
+        case PL_PRESENT_MODE_IMMEDIATE:    tRequestedPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR; break;
+        case PL_PRESENT_MODE_FIFO:
+        default:                           tRequestedPresentMode = VK_PRESENT_MODE_FIFO_KHR; break;
+    }
+
     VkPresentModeKHR tPresentMode = VK_PRESENT_MODE_FIFO_KHR;
-    if(!ptSwapchainOut->bVSync)
+    for(uint32_t i = 0 ; i < uPresentModeCount; i++)
     {
-        for(uint32_t i = 0 ; i < uPresentModeCount; i++)
+        if(atPresentModes[i] == tRequestedPresentMode)
         {
-			if (atPresentModes[i] == VK_PRESENT_MODE_MAILBOX_KHR)
-			{
-				tPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
-				break;
-			}
-			if (atPresentModes[i] == VK_PRESENT_MODE_IMMEDIATE_KHR)
-				tPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+            tPresentMode = tRequestedPresentMode;
+            break;
         }
     }
+    if(tPresentMode != tRequestedPresentMode)
+        pl_log_warn_to_f(uLogChannel, "present mode %d not supported, falling back to FIFO", (int)tRequestedPresentMode);
+    ptSwapchainOut->tPresentMode = tPresentMode;
 
     // chose swap extent 
     VkExtent2D tExtent = {0};
@@ -798,6 +1394,8 @@ create_swapchain(plGraphics* ptGraphics, uint32_t uWidth, uint32_t uHeight, plVu
     // decide image count
     const uint32_t uOldImageCount = ptSwapchainOut->uImageCount;
     uint32_t uDesiredMinImageCount = tCapabilities.minImageCount + 1;
+    if(ptGraphics->tSwapchainDesc.uImageCount > 0)
+        uDesiredMinImageCount = pl_maxu(tCapabilities.minImageCount, ptGraphics->tSwapchainDesc.uImageCount);
     if(tCapabilities.maxImageCount > 0 && uDesiredMinImageCount > tCapabilities.maxImageCount) 
         uDesiredMinImageCount = tCapabilities.maxImageCount;
 
@@ -870,18 +1468,16 @@ create_swapchain(plGraphics* ptGraphics, uint32_t uWidth, uint32_t uHeight, plVu
 
     PL_VULKAN(vkCreateSwapchainKHR(ptVulkanDevice->tLogicalDevice, &tCreateSwapchainInfo, NULL, &ptSwapchainOut->tSwapChain));
 
+    // the retired swapchain may still have images being presented or
+    // rendered to by frames in flight
     if(tOldSwapChain)
     {
-        if(pl_sb_size(ptVulkanDevice->_sbtFrameGarbage) == 0)
-        {
-            pl_sb_resize(ptVulkanDevice->_sbtFrameGarbage, ptSwapchainOut->uImageCount);
-        }
         for (uint32_t i = 0u; i < uOldImageCount; i++)
         {
-            pl_sb_push(ptVulkanDevice->_sbtFrameGarbage[ptVulkanDevice->uCurrentFrame].sbtTextureViews, ptSwapchainOut->sbtImageViews[i]);
-            pl_sb_push(ptVulkanDevice->_sbtFrameGarbage[ptVulkanDevice->uCurrentFrame].sbtFrameBuffers, ptSwapchainOut->sbtFrameBuffers[i]);
+            pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE_VIEW,  .tImageView   = ptSwapchainOut->sbtImageViews[i]});
+            pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_FRAMEBUFFER, .tFramebuffer = ptSwapchainOut->sbtFrameBuffers[i]});
         }
-        vkDestroySwapchainKHR(ptVulkanDevice->tLogicalDevice, tOldSwapChain, NULL);
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_SWAPCHAIN, .tSwapchain = tOldSwapChain});
     }
 
     // get swapchain images
@@ -921,12 +1517,22 @@ create_swapchain(plGraphics* ptGraphics, uint32_t uWidth, uint32_t uHeight, plVu
     }  //-V1020
 
     // color & depth
-    if(ptSwapchainOut->tColorTextureView)  pl_sb_push(ptVulkanDevice->_sbtFrameGarbage[ptVulkanDevice->uCurrentFrame].sbtTextureViews, ptSwapchainOut->tColorTextureView);
-    if(ptSwapchainOut->tDepthTextureView)  pl_sb_push(ptVulkanDevice->_sbtFrameGarbage[ptVulkanDevice->uCurrentFrame].sbtTextureViews, ptSwapchainOut->tDepthTextureView);
-    if(ptSwapchainOut->tColorTexture)      pl_sb_push(ptVulkanDevice->_sbtFrameGarbage[ptVulkanDevice->uCurrentFrame].sbtTextures, ptSwapchainOut->tColorTexture);
-    if(ptSwapchainOut->tDepthTexture)      pl_sb_push(ptVulkanDevice->_sbtFrameGarbage[ptVulkanDevice->uCurrentFrame].sbtTextures, ptSwapchainOut->tDepthTexture);
-    if(ptSwapchainOut->tColorTextureMemory)      pl_sb_push(ptVulkanDevice->_sbtFrameGarbage[ptVulkanDevice->uCurrentFrame].sbtMemory, ptSwapchainOut->tColorTextureMemory);
-    if(ptSwapchainOut->tDepthTextureMemory)      pl_sb_push(ptVulkanDevice->_sbtFrameGarbage[ptVulkanDevice->uCurrentFrame].sbtMemory, ptSwapchainOut->tDepthTextureMemory);
+    if(ptSwapchainOut->tColorTexture)
+    {
+        VkMemoryRequirements tOldMemReqs = {0};
+        vkGetImageMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptSwapchainOut->tColorTexture, &tOldMemReqs);
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE_VIEW, .tImageView = ptSwapchainOut->tColorTextureView});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE,      .tImage     = ptSwapchainOut->tColorTexture});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_MEMORY,     .tMemory    = ptSwapchainOut->tColorTextureMemory, .szByteSize = tOldMemReqs.size});
+    }
+    if(ptSwapchainOut->tDepthTexture)
+    {
+        VkMemoryRequirements tOldMemReqs = {0};
+        vkGetImageMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptSwapchainOut->tDepthTexture, &tOldMemReqs);
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE_VIEW, .tImageView = ptSwapchainOut->tDepthTextureView});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE,      .tImage     = ptSwapchainOut->tDepthTexture});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_MEMORY,     .tMemory    = ptSwapchainOut->tDepthTextureMemory, .szByteSize = tOldMemReqs.size});
+    }
 
     ptSwapchainOut->tColorTextureView = VK_NULL_HANDLE;
     ptSwapchainOut->tColorTexture     = VK_NULL_HANDLE;
@@ -988,45 +1594,8 @@ create_swapchain(plGraphics* ptGraphics, uint32_t uWidth, uint32_t uHeight, plVu
     PL_VULKAN(vkBindImageMemory(ptVulkanDevice->tLogicalDevice, ptSwapchainOut->tDepthTexture, ptSwapchainOut->tDepthTextureMemory, 0));
     PL_VULKAN(vkBindImageMemory(ptVulkanDevice->tLogicalDevice, ptSwapchainOut->tColorTexture, ptSwapchainOut->tColorTextureMemory, 0));
 
-    VkCommandBuffer tCommandBuffer = {0};
-    
-    const VkCommandBufferAllocateInfo tAllocInfo = {
-        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandPool        = ptVulkanDevice->tCmdPool,
-        .commandBufferCount = 1u,
-    };
-    vkAllocateCommandBuffers(ptVulkanDevice->tLogicalDevice, &tAllocInfo, &tCommandBuffer);
-
-    const VkCommandBufferBeginInfo tBeginInfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
-    };
-
-    vkBeginCommandBuffer(tCommandBuffer, &tBeginInfo);
-
-    VkImageSubresourceRange tRange = {
-        .baseMipLevel   = 0,
-        .levelCount     = 1,
-        .baseArrayLayer = 0,
-        .layerCount     = 1,
-        .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT
-    };
-
-    transition_image_layout(tCommandBuffer, ptSwapchainOut->tColorTexture, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, tRange, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
-    tRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
-    transition_image_layout(tCommandBuffer, ptSwapchainOut->tDepthTexture, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, tRange, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
-
-    PL_VULKAN(vkEndCommandBuffer(tCommandBuffer));
-    const VkSubmitInfo tSubmitInfo = {
-        .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1u,
-        .pCommandBuffers    = &tCommandBuffer,
-    };
-
-    PL_VULKAN(vkQueueSubmit(ptVulkanDevice->tGraphicsQueue, 1, &tSubmitInfo, VK_NULL_HANDLE));
-    PL_VULKAN(vkDeviceWaitIdle(ptVulkanDevice->tLogicalDevice));
-    vkFreeCommandBuffers(ptVulkanDevice->tLogicalDevice, ptVulkanDevice->tCmdPool, 1, &tCommandBuffer);
+    // no layout transitions needed, the main render pass clears both from
+    // VK_IMAGE_LAYOUT_UNDEFINED
 
     VkImageViewCreateInfo tDepthViewInfo = {
         .sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -1123,99 +1692,122 @@ pl__find_memory_type_(VkPhysicalDeviceMemoryProperties tMemProps, uint32_t uType
 }
 
 static void
-pl__grow_vulkan_3d_vertex_buffer(plGraphics* ptGfx, uint32_t uVtxBufSzNeeded, pl3DVulkanBufferInfo* ptBufferInfo)
+pl__create_dynamic_buffer(plGraphics* ptGfx, VkDeviceSize szFrameByteSize)
 {
     plVulkanGraphics* ptVulkanGfx = ptGfx->_pInternalData;
     plVulkanDevice* ptVulkanDevice = ptGfx->tDevice._pInternalData;
+    plVulkanDynamicBuffer* ptDynamicBuffer = &ptVulkanGfx->tDynamicBuffer;
 
-    // buffer currently exists & mapped, submit for cleanup
-    if(ptBufferInfo->ucVertexBufferMap)
+    // buffer currently exists & mapped, submit for cleanup (commands already
+    // recorded this frame may still reference it)
+    if(ptDynamicBuffer->pucMapping)
     {
-        const pl3DBufferReturn tReturnBuffer = {
-            .tBuffer       = ptBufferInfo->tVertexBuffer,
-            .tDeviceMemory = ptBufferInfo->tVertexMemory,
-            .slFreedFrame  = (int64_t)(pl_get_io()->ulFrameCount + ptVulkanGfx->uFramesInFlight * 2)
-        };
-        pl_sb_push(ptVulkanGfx->sbReturnedBuffers, tReturnBuffer);
-        ptVulkanGfx->uBufferDeletionQueueSize++;
-        vkUnmapMemory(ptVulkanDevice->tLogicalDevice, ptBufferInfo->tVertexMemory);
+        vkUnmapMemory(ptVulkanDevice->tLogicalDevice, ptDynamicBuffer->tMemory);
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_BUFFER, .tBuffer = ptDynamicBuffer->tBuffer});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_MEMORY, .tMemory = ptDynamicBuffer->tMemory, .szByteSize = ptDynamicBuffer->szMemoryByteSize});
+        ptDynamicBuffer->pucMapping = NULL;
     }
 
     // create new buffer
     const VkBufferCreateInfo tBufferCreateInfo = {
         .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .size        = uVtxBufSzNeeded,
-        .usage       = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .size        = szFrameByteSize * ptVulkanGfx->uFramesInFlight,
+        .usage       = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, // storage -> culling input
         .sharingMode = VK_SHARING_MODE_EXCLUSIVE
     };
-    PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &tBufferCreateInfo, NULL, &ptBufferInfo->tVertexBuffer));
+    PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &tBufferCreateInfo, NULL, &ptDynamicBuffer->tBuffer));
 
     // check memory requirements
     VkMemoryRequirements tMemReqs = {0};
-    vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptBufferInfo->tVertexBuffer, &tMemReqs);
+    vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptDynamicBuffer->tBuffer, &tMemReqs);
+
+    // prefer coherent memory so writes never need flushing
+    uint32_t uMemoryType = UINT32_MAX;
+    const VkMemoryPropertyFlags atPreferredProperties[] = {
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+    };
+    for(uint32_t i = 0; i < 2 && uMemoryType == UINT32_MAX; i++)
+    {
+        for(uint32_t j = 0; j < ptVulkanDevice->tMemProps.memoryTypeCount; j++)
+        {
+            if((tMemReqs.memoryTypeBits & (1 << j)) && (ptVulkanDevice->tMemProps.memoryTypes[j].propertyFlags & atPreferredProperties[i]) == atPreferredProperties[i])
+            {
+                uMemoryType = j;
+                break;
+            }
+        }
+    }
+    PL_ASSERT(uMemoryType != UINT32_MAX && "no host visible memory for dynamic buffer");
+    ptDynamicBuffer->bHostCoherent = (ptVulkanDevice->tMemProps.memoryTypes[uMemoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
 
     // allocate memory & bind buffer
     const VkMemoryAllocateInfo tAllocInfo = {
         .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
         .allocationSize  = tMemReqs.size,
-        .memoryTypeIndex = pl__find_memory_type_(ptVulkanDevice->tMemProps, tMemReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+        .memoryTypeIndex = uMemoryType
     };
-    ptBufferInfo->uVertexByteSize = (uint32_t)tMemReqs.size;
-    PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &tAllocInfo, NULL, &ptBufferInfo->tVertexMemory));
-    PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, ptBufferInfo->tVertexBuffer, ptBufferInfo->tVertexMemory, 0));
+    PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &tAllocInfo, NULL, &ptDynamicBuffer->tMemory));
+    PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, ptDynamicBuffer->tBuffer, ptDynamicBuffer->tMemory, 0));
 
     // map memory persistently
-    PL_VULKAN(vkMapMemory(ptVulkanDevice->tLogicalDevice, ptBufferInfo->tVertexMemory, 0, tMemReqs.size, 0, (void**)&ptBufferInfo->ucVertexBufferMap));
+    PL_VULKAN(vkMapMemory(ptVulkanDevice->tLogicalDevice, ptDynamicBuffer->tMemory, 0, VK_WHOLE_SIZE, 0, (void**)&ptDynamicBuffer->pucMapping));
 
-    ptBufferInfo->uVertexBufferOffset = 0;
+    ptDynamicBuffer->szMemoryByteSize = tMemReqs.size;
+    ptDynamicBuffer->szFrameByteSize  = szFrameByteSize;
+    ptDynamicBuffer->szFrameOffset    = 0;
 }
 
-static void
-pl__grow_vulkan_3d_index_buffer(plGraphics* ptGfx, uint32_t uIdxBufSzNeeded, pl3DVulkanBufferInfo* ptBufferInfo)
+static VkDeviceSize
+pl__allocate_dynamic_data(plGraphics* ptGfx, VkDeviceSize szSize)
 {
     plVulkanGraphics* ptVulkanGfx = ptGfx->_pInternalData;
-    plVulkanDevice* ptVulkanDevice = ptGfx->tDevice._pInternalData;
+    plVulkanDynamicBuffer* ptDynamicBuffer = &ptVulkanGfx->tDynamicBuffer;
+
+    szSize = (szSize + PL_VULKAN_DYNAMIC_BUFFER_ALIGNMENT - 1) & ~((VkDeviceSize)PL_VULKAN_DYNAMIC_BUFFER_ALIGNMENT - 1);
 
-    // buffer currently exists & mapped, submit for cleanup
-    if(ptBufferInfo->ucIndexBufferMap)
+    ptDynamicBuffer->szFrameUsage += szSize;
+    if(ptDynamicBuffer->szFrameUsage > ptDynamicBuffer->szHighWaterMark)
+        ptDynamicBuffer->szHighWaterMark = ptDynamicBuffer->szFrameUsage;
+
+    // out of room, grow to at least twice the high water mark so this only
+    // happens during warm up
+    if(ptDynamicBuffer->szFrameOffset + szSize > ptDynamicBuffer->szFrameByteSize)
     {
-        const pl3DBufferReturn tReturnBuffer = {
-            .tBuffer       = ptBufferInfo->tIndexBuffer,
-            .tDeviceMemory = ptBufferInfo->tIndexMemory,
-            .slFreedFrame  = (int64_t)(pl_get_io()->ulFrameCount + ptVulkanGfx->uFramesInFlight * 2)
-        };
-        pl_sb_push(ptVulkanGfx->sbReturnedBuffers, tReturnBuffer);
-        ptVulkanGfx->uBufferDeletionQueueSize++;
-        vkUnmapMemory(ptVulkanDevice->tLogicalDevice, ptBufferInfo->tIndexMemory);
+        VkDeviceSize szNewFrameByteSize = ptDynamicBuffer->szFrameByteSize * 2;
+        while(szNewFrameByteSize < ptDynamicBuffer->szHighWaterMark * 2)
+            szNewFrameByteSize *= 2;
+        pl_log_warn_to_f(uLogChannel, "growing dynamic geometry buffer to %u bytes per frame", (uint32_t)szNewFrameByteSize);
+        pl__create_dynamic_buffer(ptGfx, szNewFrameByteSize);
     }
 
-    // create new buffer
-    const VkBufferCreateInfo tBufferCreateInfo = {
-        .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .size        = uIdxBufSzNeeded,
-        .usage       = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
-    };
-    PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &tBufferCreateInfo, NULL, &ptBufferInfo->tIndexBuffer));
+    const VkDeviceSize szOffset = ptVulkanGfx->szCurrentFrameIndex * ptDynamicBuffer->szFrameByteSize + ptDynamicBuffer->szFrameOffset;
+    ptDynamicBuffer->szFrameOffset += szSize;
+    return szOffset;
+}
 
-    // check memory requirements
-    VkMemoryRequirements tMemReqs = {0};
-    vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptBufferInfo->tIndexBuffer, &tMemReqs);
+static void
+pl__flush_dynamic_data(plGraphics* ptGfx, VkDeviceSize szOffset, VkDeviceSize szSize)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGfx->_pInternalData;
+    plVulkanDevice* ptVulkanDevice = ptGfx->tDevice._pInternalData;
+    plVulkanDynamicBuffer* ptDynamicBuffer = &ptVulkanGfx->tDynamicBuffer;
 
-    // alllocate memory & bind buffer
-    const VkMemoryAllocateInfo tAllocInfo = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = tMemReqs.size,
-        .memoryTypeIndex = pl__find_memory_type_(ptVulkanDevice->tMemProps, tMemReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
-    };
-    ptBufferInfo->uIndexByteSize = (uint32_t)tMemReqs.size;
-    PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &tAllocInfo, NULL, &ptBufferInfo->tIndexMemory));
-    PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, ptBufferInfo->tIndexBuffer, ptBufferInfo->tIndexMemory, 0));
+    if(ptDynamicBuffer->bHostCoherent)
+        return;
 
-    // map memory persistently
-    PL_VULKAN(vkMapMemory(ptVulkanDevice->tLogicalDevice, ptBufferInfo->tIndexMemory, 0, tMemReqs.size, 0, (void**)&ptBufferInfo->ucIndexBufferMap));
+    // flushed ranges must be aligned to nonCoherentAtomSize
+    const VkDeviceSize szAtomSize = ptVulkanDevice->tDeviceProps.limits.nonCoherentAtomSize;
+    const VkDeviceSize szStart = (szOffset / szAtomSize) * szAtomSize;
+    const VkDeviceSize szEnd = ((szOffset + szSize + szAtomSize - 1) / szAtomSize) * szAtomSize;
 
-    ptBufferInfo->uIndexBufferOffset = 0;
+    const VkMappedMemoryRange tRange = {
+        .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+        .memory = ptDynamicBuffer->tMemory,
+        .offset = szStart,
+        .size   = szEnd >= ptDynamicBuffer->szMemoryByteSize ? VK_WHOLE_SIZE : szEnd - szStart
+    };
+    PL_VULKAN(vkFlushMappedMemoryRanges(ptVulkanDevice->tLogicalDevice, 1, &tRange));
 }
 
 static pl3DVulkanPipelineEntry*
@@ -1224,18 +1816,31 @@ pl__get_3d_pipelines(plGraphics* ptGfx, VkRenderPass tRenderPass, VkSampleCountF
     plVulkanGraphics* ptVulkanGfx = ptGfx->_pInternalData;
     plVulkanDevice* ptVulkanDevice = ptGfx->tDevice._pInternalData;
 
-    // return pipeline entry if it exists
-    for(uint32_t i = 0; i < pl_sb_size(ptVulkanGfx->sbt3DPipelines); i++)
+    // return pipeline entry if it exists, entries sharing a key hash are
+    // chained & compared on their key fields
+    const uint64_t ulPipelineHash = pl__hash_pipeline_key(tRenderPass, tMSAASampleCount, tFlags);
+    const uint64_t ulFirstEntry = pl_hm_lookup(&ptVulkanGfx->t3DPipelineHashMap, ulPipelineHash);
+    uint32_t uReleasedEntry = UINT32_MAX; // still linked, reused before a new one
+    for(uint32_t i = (uint32_t)ulFirstEntry; ulFirstEntry != UINT64_MAX && i != UINT32_MAX; i = ptVulkanGfx->sbt3DPipelines[i].uNextEntry)
     {
-        if(ptVulkanGfx->sbt3DPipelines[i].tRenderPass == tRenderPass && tMSAASampleCount == ptVulkanGfx->sbt3DPipelines[i].tMSAASampleCount && ptVulkanGfx->sbt3DPipelines[i].tFlags == tFlags)
-            return &ptVulkanGfx->sbt3DPipelines[i];
+        pl3DVulkanPipelineEntry* ptEntry = &ptVulkanGfx->sbt3DPipelines[i];
+        if(ptEntry->tRegularPipeline == VK_NULL_HANDLE)
+        {
+            if(uReleasedEntry == UINT32_MAX)
+                uReleasedEntry = i;
+            continue;
+        }
+        if(ptEntry->tRenderPass == tRenderPass && ptEntry->tMSAASampleCount == tMSAASampleCount && ptEntry->tFlags == tFlags)
+            return ptEntry;
     }
 
     // create new pipeline entry
     pl3DVulkanPipelineEntry tEntry = {
         .tRenderPass      = tRenderPass,
         .tMSAASampleCount = tMSAASampleCount,
-        .tFlags           = tFlags
+        .tFlags           = tFlags,
+        .ulKey            = ulPipelineHash,
+        .uNextEntry       = UINT32_MAX
     };
 
     const VkPipelineInputAssemblyStateCreateInfo tInputAssembly = {
@@ -1387,7 +1992,7 @@ pl__get_3d_pipelines(plGraphics* ptGfx, VkRenderPass tRenderPass, VkSampleCountF
         .basePipelineHandle  = VK_NULL_HANDLE,
         .pDepthStencilState  = &tDepthStencil
     };
-    PL_VULKAN(vkCreateGraphicsPipelines(ptVulkanDevice->tLogicalDevice, VK_NULL_HANDLE, 1, &pipeInfo, NULL, &tEntry.tRegularPipeline));
+    PL_VULKAN(vkCreateGraphicsPipelines(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tPipelineCache, 1, &pipeInfo, NULL, &tEntry.tRegularPipeline));
 
     // //---------------------------------------------------------------------
     // // Create SDF Pipeline
@@ -1398,12 +2003,133 @@ pl__get_3d_pipelines(plGraphics* ptGfx, VkRenderPass tRenderPass, VkSampleCountF
     pipeInfo.pVertexInputState = &tLineVertexInputInfo;
     pipeInfo.layout = ptVulkanGfx->t3DLinePipelineLayout;
 
-    PL_VULKAN(vkCreateGraphicsPipelines(ptVulkanDevice->tLogicalDevice, VK_NULL_HANDLE, 1, &pipeInfo, NULL, &tEntry.tSecondaryPipeline));
+    PL_VULKAN(vkCreateGraphicsPipelines(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tPipelineCache, 1, &pipeInfo, NULL, &tEntry.tSecondaryPipeline));
+
+    // released entry of this chain keeps its link
+    if(uReleasedEntry != UINT32_MAX)
+    {
+        tEntry.uNextEntry = ptVulkanGfx->sbt3DPipelines[uReleasedEntry].uNextEntry;
+        ptVulkanGfx->sbt3DPipelines[uReleasedEntry] = tEntry;
+        return &ptVulkanGfx->sbt3DPipelines[uReleasedEntry];
+    }
+
+    // otherwise an entry freed by render pass or shader changes, or a new one
+    uint64_t ulNewIndex = pl_hm_get_free_index(&ptVulkanGfx->t3DPipelineHashMap); // former chain heads
+    if(ulNewIndex == UINT64_MAX && pl_sb_size(ptVulkanGfx->sbu3DPipelineFreeEntries) > 0)
+        ulNewIndex = pl_sb_pop(ptVulkanGfx->sbu3DPipelineFreeEntries);
+    else if(ulNewIndex == UINT64_MAX)
+    {
+        ulNewIndex = pl_sb_size(ptVulkanGfx->sbt3DPipelines);
+        pl_sb_add(ptVulkanGfx->sbt3DPipelines);
+    }
+    const uint32_t uNewIndex = (uint32_t)ulNewIndex;
+
+    // the map keeps pointing at the first entry, later ones are linked after it
+    if(ulFirstEntry == UINT64_MAX)
+        pl_hm_insert(&ptVulkanGfx->t3DPipelineHashMap, ulPipelineHash, uNewIndex);
+    else
+    {
+        tEntry.uNextEntry = ptVulkanGfx->sbt3DPipelines[ulFirstEntry].uNextEntry;
+        ptVulkanGfx->sbt3DPipelines[ulFirstEntry].uNextEntry = uNewIndex;
+    }
+    ptVulkanGfx->sbt3DPipelines[uNewIndex] = tEntry;
+    return &ptVulkanGfx->sbt3DPipelines[uNewIndex];
+}
+
+static uint64_t
+pl__hash_pipeline_key(VkRenderPass tRenderPass, VkSampleCountFlagBits tMSAASampleCount, pl3DDrawFlags tFlags)
+{
+    // zeroed first so padding never leaks into the hash
+    struct {
+        uint64_t ulRenderPass;
+        uint32_t uSampleCount;
+        uint32_t uFlags;
+    } tKey;
+    memset(&tKey, 0, sizeof(tKey));
+    tKey.ulRenderPass = (uint64_t)tRenderPass;
+    tKey.uSampleCount = (uint32_t)tMSAASampleCount;
+    tKey.uFlags       = (uint32_t)tFlags;
+    return pl_hm_hash(&tKey, sizeof(tKey), 0);
+}
+
+static VkPipelineCache
+pl__load_pipeline_cache(plVulkanDevice* ptVulkanDevice, const char* pcFile)
+{
+    size_t szDataSize = 0;
+    char*  pcData     = NULL;
+
+    FILE* ptDataFile = fopen(pcFile, "rb");
+    if(ptDataFile)
+    {
+        fseek(ptDataFile, 0, SEEK_END);
+        szDataSize = (size_t)ftell(ptDataFile);
+        fseek(ptDataFile, 0, SEEK_SET);
+        pcData = PL_ALLOC(szDataSize);
+        if(fread(pcData, 1, szDataSize, ptDataFile) != szDataSize)
+            szDataSize = 0;
+        fclose(ptDataFile);
+    }
+
+    // drivers are supposed to reject foreign data but not all of them do,
+    // so only hand over data written by this exact device & driver
+    if(szDataSize > 0)
+    {
+        plVulkanPipelineCacheHeader tHeader = {0};
+        bool bValid = szDataSize >= sizeof(plVulkanPipelineCacheHeader);
+        if(bValid)
+        {
+            memcpy(&tHeader, pcData, sizeof(plVulkanPipelineCacheHeader));
+            bValid = tHeader.uHeaderSize >= sizeof(plVulkanPipelineCacheHeader) &&
+                tHeader.uHeaderVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                tHeader.uVendorID == ptVulkanDevice->tDeviceProps.vendorID &&
+                tHeader.uDeviceID == ptVulkanDevice->tDeviceProps.deviceID &&
+                memcmp(tHeader.auPipelineCacheUUID, ptVulkanDevice->tDeviceProps.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+        }
+
+        if(bValid)
+            pl_log_info_to_f(uLogChannel, "loaded pipeline cache \"%s\" (%u bytes)", pcFile, (uint32_t)szDataSize);
+        else
+        {
+            pl_log_warn_to_f(uLogChannel, "discarding pipeline cache \"%s\" (created by a different device or driver)", pcFile);
+            szDataSize = 0;
+        }
+    }
+
+    const VkPipelineCacheCreateInfo tPipelineCacheInfo = {
+        .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = szDataSize,
+        .pInitialData    = szDataSize > 0 ? pcData : NULL
+    };
+
+    VkPipelineCache tPipelineCache = VK_NULL_HANDLE;
+    PL_VULKAN(vkCreatePipelineCache(ptVulkanDevice->tLogicalDevice, &tPipelineCacheInfo, NULL, &tPipelineCache));
+
+    if(pcData)
+        PL_FREE(pcData);
+    return tPipelineCache;
+}
 
-    // add to entries
-    pl_sb_push(ptVulkanGfx->sbt3DPipelines, tEntry);
+static void
+pl__save_pipeline_cache(plVulkanDevice* ptVulkanDevice, VkPipelineCache tPipelineCache, const char* pcFile)
+{
+    size_t szDataSize = 0;
+    PL_VULKAN(vkGetPipelineCacheData(ptVulkanDevice->tLogicalDevice, tPipelineCache, &szDataSize, NULL));
+    if(szDataSize == 0)
+        return;
 
-    return &pl_sb_back(ptVulkanGfx->sbt3DPipelines); 
+    char* pcData = PL_ALLOC(szDataSize);
+    PL_VULKAN(vkGetPipelineCacheData(ptVulkanDevice->tLogicalDevice, tPipelineCache, &szDataSize, pcData));
+
+    FILE* ptDataFile = fopen(pcFile, "wb");
+    if(ptDataFile)
+    {
+        fwrite(pcData, 1, szDataSize, ptDataFile);
+        fclose(ptDataFile);
+        pl_log_info_to_f(uLogChannel, "saved pipeline cache \"%s\" (%u bytes)", pcFile, (uint32_t)szDataSize);
+    }
+    else
+        pl_log_warn_to_f(uLogChannel, "failed to write pipeline cache \"%s\"", pcFile);
+    PL_FREE(pcData);
 }
 
 static void
@@ -1411,9 +2137,8 @@ pl__submit_3d_drawlist(plDrawList3D* ptDrawlist, float fWidth, float fHeight, co
 {
     plGraphics* ptGfx = ptDrawlist->ptGraphics;
     plVulkanGraphics* ptVulkanGfx = ptGfx->_pInternalData;
-    plVulkanDevice* ptVulkanDevice = ptGfx->tDevice._pInternalData;
 
-    pl3DVulkanPipelineEntry* tPipelineEntry = pl__get_3d_pipelines(ptGfx, ptVulkanGfx->tRenderPass, ptVulkanGfx->tSwapchain.tMsaaSamples, tFlags);
+    pl3DVulkanPipelineEntry* tPipelineEntry = pl__get_3d_pipelines(ptGfx, ptVulkanGfx->tCurrentRenderPass, ptVulkanGfx->tCurrentSampleCount, tFlags);
     const float fAspectRatio = fWidth / fHeight;
 
     plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGfx);
@@ -1421,334 +2146,753 @@ pl__submit_3d_drawlist(plDrawList3D* ptDrawlist, float fWidth, float fHeight, co
     // regular 3D
     if(pl_sb_size(ptDrawlist->sbtSolidVertexBuffer) > 0u)
     {
-        //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~vertex buffer prep~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+        //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~buffer prep~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-        // ensure gpu vertex buffer size is adequate
         const uint32_t uVtxBufSzNeeded = sizeof(plDrawVertex3DSolid) * pl_sb_size(ptDrawlist->sbtSolidVertexBuffer);
-
-        pl3DVulkanBufferInfo* ptBufferInfo = &ptVulkanGfx->sbt3DBufferInfo[ptVulkanGfx->szCurrentFrameIndex];
-
-        // space left in vertex buffer
-        const uint32_t uAvailableVertexBufferSpace = ptBufferInfo->uVertexByteSize - ptBufferInfo->uVertexBufferOffset;
-
-        // grow buffer if not enough room
-        if(uVtxBufSzNeeded >= uAvailableVertexBufferSpace)
-            pl__grow_vulkan_3d_vertex_buffer(ptGfx, uVtxBufSzNeeded * 2, ptBufferInfo);
-
-        // vertex GPU data transfer
-        unsigned char* pucMappedVertexBufferLocation = ptBufferInfo->ucVertexBufferMap;
-        memcpy(&pucMappedVertexBufferLocation[ptBufferInfo->uVertexBufferOffset], ptDrawlist->sbtSolidVertexBuffer, sizeof(plDrawVertex3DSolid) * pl_sb_size(ptDrawlist->sbtSolidVertexBuffer));
-
-        //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~index buffer prep~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-
-        // ensure gpu index buffer size is adequate
         const uint32_t uIdxBufSzNeeded = sizeof(uint32_t) * pl_sb_size(ptDrawlist->sbtSolidIndexBuffer);
 
-        // space left in index buffer
-        const uint32_t uAvailableIndexBufferSpace = ptBufferInfo->uIndexByteSize - ptBufferInfo->uIndexBufferOffset;
-
-        if(uIdxBufSzNeeded >= uAvailableIndexBufferSpace)
-            pl__grow_vulkan_3d_index_buffer(ptGfx, uIdxBufSzNeeded * 2, ptBufferInfo);
-
-        // index GPU data transfer
-        unsigned char* pucMappedIndexBufferLocation = ptBufferInfo->ucIndexBufferMap;
-        memcpy(&pucMappedIndexBufferLocation[ptBufferInfo->uIndexBufferOffset], ptDrawlist->sbtSolidIndexBuffer, sizeof(uint32_t) * pl_sb_size(ptDrawlist->sbtSolidIndexBuffer));
-        
-        const VkMappedMemoryRange aRange[2] = {
-            {
-                .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-                .memory = ptBufferInfo->tVertexMemory,
-                .size = VK_WHOLE_SIZE
-            },
-            {
-                .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-                .memory = ptBufferInfo->tIndexMemory,
-                .size = VK_WHOLE_SIZE
-            }
-        };
-        PL_VULKAN(vkFlushMappedMemoryRanges(ptVulkanDevice->tLogicalDevice, 2, aRange));
+        // vertices & indices share one allocation from the dynamic ring
+        const VkDeviceSize szVertexOffset = pl__allocate_dynamic_data(ptGfx, uVtxBufSzNeeded + uIdxBufSzNeeded);
+        const VkDeviceSize szIndexOffset = szVertexOffset + uVtxBufSzNeeded;
 
-        static const VkDeviceSize tOffsets = { 0u };
-        vkCmdBindIndexBuffer(ptCurrentFrame->tCmdBuf, ptBufferInfo->tIndexBuffer, 0u, VK_INDEX_TYPE_UINT32);
-        vkCmdBindVertexBuffers(ptCurrentFrame->tCmdBuf, 0, 1, &ptBufferInfo->tVertexBuffer, &tOffsets);
+        // GPU data transfer
+        unsigned char* pucMapping = ptVulkanGfx->tDynamicBuffer.pucMapping;
+        memcpy(&pucMapping[szVertexOffset], ptDrawlist->sbtSolidVertexBuffer, uVtxBufSzNeeded);
+        memcpy(&pucMapping[szIndexOffset], ptDrawlist->sbtSolidIndexBuffer, uIdxBufSzNeeded);
+        pl__flush_dynamic_data(ptGfx, szVertexOffset, uVtxBufSzNeeded + uIdxBufSzNeeded);
 
-        const int32_t iVertexOffset = ptBufferInfo->uVertexBufferOffset / sizeof(plDrawVertex3DSolid);
-        const int32_t iIndexOffset = ptBufferInfo->uIndexBufferOffset / sizeof(uint32_t);
+        vkCmdBindIndexBuffer(ptCurrentFrame->tCmdBuf, ptVulkanGfx->tDynamicBuffer.tBuffer, szIndexOffset, VK_INDEX_TYPE_UINT32);
+        vkCmdBindVertexBuffers(ptCurrentFrame->tCmdBuf, 0, 1, &ptVulkanGfx->tDynamicBuffer.tBuffer, &szVertexOffset);
 
         vkCmdBindPipeline(ptCurrentFrame->tCmdBuf, VK_PIPELINE_BIND_POINT_GRAPHICS, tPipelineEntry->tRegularPipeline); 
         vkCmdPushConstants(ptCurrentFrame->tCmdBuf, ptVulkanGfx->t3DPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(float) * 16, ptMVP);
-        vkCmdDrawIndexed(ptCurrentFrame->tCmdBuf, pl_sb_size(ptDrawlist->sbtSolidIndexBuffer), 1, iIndexOffset, iVertexOffset, 0);
-        
-        // bump vertex & index buffer offset
-        ptBufferInfo->uVertexBufferOffset += uVtxBufSzNeeded;
-        ptBufferInfo->uIndexBufferOffset += uIdxBufSzNeeded;
+        vkCmdDrawIndexed(ptCurrentFrame->tCmdBuf, pl_sb_size(ptDrawlist->sbtSolidIndexBuffer), 1, 0, 0, 0);
     }
 
     // 3D lines
     if(pl_sb_size(ptDrawlist->sbtLineVertexBuffer) > 0u)
     {
-        //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~vertex buffer prep~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+        //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~buffer prep~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-        // ensure gpu vertex buffer size is adequate
         const uint32_t uVtxBufSzNeeded = sizeof(plDrawVertex3DLine) * pl_sb_size(ptDrawlist->sbtLineVertexBuffer);
+        const uint32_t uIdxBufSzNeeded = sizeof(uint32_t) * pl_sb_size(ptDrawlist->sbtLineIndexBuffer);
 
-        pl3DVulkanBufferInfo* ptBufferInfo = &ptVulkanGfx->sbtLineBufferInfo[ptVulkanGfx->szCurrentFrameIndex];
-
-        // space left in vertex buffer
-        const uint32_t uAvailableVertexBufferSpace = ptBufferInfo->uVertexByteSize - ptBufferInfo->uVertexBufferOffset;
+        // vertices & indices share one allocation from the dynamic ring
+        const VkDeviceSize szVertexOffset = pl__allocate_dynamic_data(ptGfx, uVtxBufSzNeeded + uIdxBufSzNeeded);
+        const VkDeviceSize szIndexOffset = szVertexOffset + uVtxBufSzNeeded;
 
-        // grow buffer if not enough room
-        if(uVtxBufSzNeeded >= uAvailableVertexBufferSpace)
-            pl__grow_vulkan_3d_vertex_buffer(ptGfx, uVtxBufSzNeeded * 2, ptBufferInfo);
+        // GPU data transfer
+        unsigned char* pucMapping = ptVulkanGfx->tDynamicBuffer.pucMapping;
+        memcpy(&pucMapping[szVertexOffset], ptDrawlist->sbtLineVertexBuffer, uVtxBufSzNeeded);
+        memcpy(&pucMapping[szIndexOffset], ptDrawlist->sbtLineIndexBuffer, uIdxBufSzNeeded);
+        pl__flush_dynamic_data(ptGfx, szVertexOffset, uVtxBufSzNeeded + uIdxBufSzNeeded);
 
-        // vertex GPU data transfer
-        unsigned char* pucMappedVertexBufferLocation = ptBufferInfo->ucVertexBufferMap;
-        memcpy(&pucMappedVertexBufferLocation[ptBufferInfo->uVertexBufferOffset], ptDrawlist->sbtLineVertexBuffer, sizeof(plDrawVertex3DLine) * pl_sb_size(ptDrawlist->sbtLineVertexBuffer));
+        vkCmdBindIndexBuffer(ptCurrentFrame->tCmdBuf, ptVulkanGfx->tDynamicBuffer.tBuffer, szIndexOffset, VK_INDEX_TYPE_UINT32);
+        vkCmdBindVertexBuffers(ptCurrentFrame->tCmdBuf, 0, 1, &ptVulkanGfx->tDynamicBuffer.tBuffer, &szVertexOffset);
 
-        //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~index buffer prep~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+        vkCmdBindPipeline(ptCurrentFrame->tCmdBuf, VK_PIPELINE_BIND_POINT_GRAPHICS, tPipelineEntry->tSecondaryPipeline); 
+        vkCmdPushConstants(ptCurrentFrame->tCmdBuf, ptVulkanGfx->t3DLinePipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(float) * 16, ptMVP);
+        vkCmdPushConstants(ptCurrentFrame->tCmdBuf, ptVulkanGfx->t3DLinePipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, sizeof(float) * 16, sizeof(float), &fAspectRatio);
+        vkCmdDrawIndexed(ptCurrentFrame->tCmdBuf, pl_sb_size(ptDrawlist->sbtLineIndexBuffer), 1, 0, 0, 0);
+    }
+}
 
-        // ensure gpu index buffer size is adequate
-        const uint32_t uIdxBufSzNeeded = sizeof(uint32_t) * pl_sb_size(ptDrawlist->sbtLineIndexBuffer);
+static VkFormat
+pl__vulkan_format(plFormat tFormat)
+{
+    switch(tFormat)
+    {
+        case PL_FORMAT_R32G32B32_FLOAT:   return VK_FORMAT_R32G32B32_SFLOAT;
+        case PL_FORMAT_R8G8B8A8_UNORM:    return VK_FORMAT_R8G8B8A8_UNORM;
+        case PL_FORMAT_R32G32_FLOAT:      return VK_FORMAT_R32G32_SFLOAT;
+        case PL_FORMAT_R8G8B8A8_SRGB:     return VK_FORMAT_R8G8B8A8_SRGB;
+        case PL_FORMAT_B8G8R8A8_SRGB:     return VK_FORMAT_B8G8R8A8_SRGB;
+        case PL_FORMAT_B8G8R8A8_UNORM:    return VK_FORMAT_B8G8R8A8_UNORM;
+        case PL_FORMAT_D32_FLOAT:         return VK_FORMAT_D32_SFLOAT;
+        case PL_FORMAT_D32_FLOAT_S8_UINT: return VK_FORMAT_D32_SFLOAT_S8_UINT;
+        case PL_FORMAT_D24_UNORM_S8_UINT: return VK_FORMAT_D24_UNORM_S8_UINT;
+        case PL_FORMAT_D16_UNORM_S8_UINT: return VK_FORMAT_D16_UNORM_S8_UINT;
+        case PL_FORMAT_BC1_RGBA_UNORM:    return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case PL_FORMAT_BC1_RGBA_SRGB:     return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+        case PL_FORMAT_BC3_UNORM:         return VK_FORMAT_BC3_UNORM_BLOCK;
+        case PL_FORMAT_BC3_SRGB:          return VK_FORMAT_BC3_SRGB_BLOCK;
+        case PL_FORMAT_BC7_UNORM:         return VK_FORMAT_BC7_UNORM_BLOCK;
+        case PL_FORMAT_BC7_SRGB:          return VK_FORMAT_BC7_SRGB_BLOCK;
+        case PL_FORMAT_ASTC_4x4_UNORM:    return VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+        case PL_FORMAT_ASTC_4x4_SRGB:     return VK_FORMAT_ASTC_4x4_SRGB_BLOCK;
+    }
+    PL_ASSERT(false && "unsupported format");
+    return VK_FORMAT_UNDEFINED;
+}
 
-        // space left in index buffer
-        const uint32_t uAvailableIndexBufferSpace = ptBufferInfo->uIndexByteSize - ptBufferInfo->uIndexBufferOffset;
+static void
+pl__invalidate_graph_pipelines(plGraphics* ptGraphics, VkRenderPass tRenderPass)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
 
-        if(uIdxBufSzNeeded >= uAvailableIndexBufferSpace)
-            pl__grow_vulkan_3d_index_buffer(ptGfx, uIdxBufSzNeeded * 2, ptBufferInfo);
+    // render pass handles can be recycled by the driver, so pipelines keyed
+    // on a destroyed render pass must not be found again (shader reloads drop
+    // all of them, they are rebuilt on next use)
+    const uint32_t uEntryCount = pl_sb_size(ptVulkanGfx->sbt3DPipelines);
+    for(uint32_t i = 0; i < uEntryCount; i++)
+    {
+        pl3DVulkanPipelineEntry* ptEntry = &ptVulkanGfx->sbt3DPipelines[i];
+        if(ptEntry->tRegularPipeline == VK_NULL_HANDLE || (tRenderPass != VK_NULL_HANDLE && ptEntry->tRenderPass != tRenderPass))
+            continue;
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_PIPELINE, .tPipeline = ptEntry->tRegularPipeline});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_PIPELINE, .tPipeline = ptEntry->tSecondaryPipeline});
+        ptEntry->tRegularPipeline   = VK_NULL_HANDLE;
+        ptEntry->tSecondaryPipeline = VK_NULL_HANDLE;
+    }
 
-        // index GPU data transfer
-        unsigned char* pucMappedIndexBufferLocation = ptBufferInfo->ucIndexBufferMap;
-        memcpy(&pucMappedIndexBufferLocation[ptBufferInfo->uIndexBufferOffset], ptDrawlist->sbtLineIndexBuffer, sizeof(uint32_t) * pl_sb_size(ptDrawlist->sbtLineIndexBuffer));
-        
-        const VkMappedMemoryRange aRange[2] = {
-            {
-                .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-                .memory = ptBufferInfo->tVertexMemory,
-                .size = VK_WHOLE_SIZE
-            },
-            {
-                .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-                .memory = ptBufferInfo->tIndexMemory,
-                .size = VK_WHOLE_SIZE
-            }
-        };
-        PL_VULKAN(vkFlushMappedMemoryRanges(ptVulkanDevice->tLogicalDevice, 2, aRange));
+    // chains without a live entry leave the map & go to the free list, others
+    // keep their released entries linked for the next pipeline of that chain
+    for(uint32_t i = 0; i < uEntryCount; i++)
+    {
+        const uint64_t ulKey = ptVulkanGfx->sbt3DPipelines[i].ulKey;
+        if(pl_hm_lookup(&ptVulkanGfx->t3DPipelineHashMap, ulKey) != i)
+            continue;
+
+        bool bLive = false;
+        for(uint32_t j = i; j != UINT32_MAX && !bLive; j = ptVulkanGfx->sbt3DPipelines[j].uNextEntry)
+            bLive = ptVulkanGfx->sbt3DPipelines[j].tRegularPipeline != VK_NULL_HANDLE;
+        if(bLive)
+            continue;
+
+        pl_hm_remove(&ptVulkanGfx->t3DPipelineHashMap, ulKey); // frees the head
+        for(uint32_t j = i; j != UINT32_MAX;)
+        {
+            const uint32_t uNext = ptVulkanGfx->sbt3DPipelines[j].uNextEntry;
+            memset(&ptVulkanGfx->sbt3DPipelines[j], 0, sizeof(pl3DVulkanPipelineEntry));
+            if(j != i)
+                pl_sb_push(ptVulkanGfx->sbu3DPipelineFreeEntries, j);
+            j = uNext;
+        }
+    }
+}
 
-        static const VkDeviceSize tOffsets = { 0u };
-        vkCmdBindIndexBuffer(ptCurrentFrame->tCmdBuf, ptBufferInfo->tIndexBuffer, 0u, VK_INDEX_TYPE_UINT32);
-        vkCmdBindVertexBuffers(ptCurrentFrame->tCmdBuf, 0, 1, &ptBufferInfo->tVertexBuffer, &tOffsets);
+static void
+pl__destroy_render_graph(plGraphics* ptGraphics)
+{
+    plVulkanGraphics*    ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*      ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanRenderGraph* ptVulkanGraph = &ptVulkanGfx->tRenderGraph;
 
-        const int32_t iVertexOffset = ptBufferInfo->uVertexBufferOffset / sizeof(plDrawVertex3DLine);
-        const int32_t iIndexOffset = ptBufferInfo->uIndexBufferOffset / sizeof(uint32_t);
+    for(uint32_t i = 0; i < pl_sb_size(ptVulkanGraph->sbtPasses); i++)
+    {
+        plVulkanGraphPass* ptPass = &ptVulkanGraph->sbtPasses[i];
+        if(ptPass->tRenderPass == VK_NULL_HANDLE)
+            continue;
+        pl__invalidate_graph_pipelines(ptGraphics, ptPass->tRenderPass);
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_FRAMEBUFFER, .tFramebuffer = ptPass->tFramebuffer});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_RENDER_PASS, .tRenderPass  = ptPass->tRenderPass});
+    }
 
-        vkCmdBindPipeline(ptCurrentFrame->tCmdBuf, VK_PIPELINE_BIND_POINT_GRAPHICS, tPipelineEntry->tSecondaryPipeline); 
-        vkCmdPushConstants(ptCurrentFrame->tCmdBuf, ptVulkanGfx->t3DLinePipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(float) * 16, ptMVP);
-        vkCmdPushConstants(ptCurrentFrame->tCmdBuf, ptVulkanGfx->t3DLinePipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, sizeof(float) * 16, sizeof(float), &fAspectRatio);
-        vkCmdDrawIndexed(ptCurrentFrame->tCmdBuf, pl_sb_size(ptDrawlist->sbtLineIndexBuffer), 1, iIndexOffset, iVertexOffset, 0);
-        
-        // bump vertex & index buffer offset
-        ptBufferInfo->uVertexBufferOffset += uVtxBufSzNeeded;
-        ptBufferInfo->uIndexBufferOffset += uIdxBufSzNeeded;
+    for(uint32_t i = 0; i < pl_sb_size(ptVulkanGraph->sbtTextures); i++)
+    {
+        plVulkanGraphTexture* ptTexture = &ptVulkanGraph->sbtTextures[i];
+        if(ptTexture->tImage == VK_NULL_HANDLE)
+            continue;
+        if(ptTexture->uBindlessSlot > 0)
+            pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_TEXTURE_SLOT, .uSlot = ptTexture->uBindlessSlot});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE_VIEW, .tImageView = ptTexture->tView});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE,      .tImage     = ptTexture->tImage});
+        if(ptTexture->tMemory)
+            pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_MEMORY, .tMemory = ptTexture->tMemory, .szByteSize = ptTexture->tMemReqs.size});
     }
-}
 
-//-----------------------------------------------------------------------------
-// [SECTION] public api implementation
-//-----------------------------------------------------------------------------
+    for(uint32_t i = 0; i < pl_sb_size(ptVulkanGraph->sbtMemory); i++)
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_MEMORY, .tMemory = ptVulkanGraph->sbtMemory[i], .szByteSize = ptVulkanGraph->sbtMemorySizes[i]});
 
-static uint32_t
-pl_create_index_buffer(plDevice* ptDevice, size_t szSize, const void* pData, const char* pcName)
+    pl_sb_reset(ptVulkanGraph->sbtPasses);
+    pl_sb_reset(ptVulkanGraph->sbtTextures);
+    pl_sb_reset(ptVulkanGraph->sbtMemory);
+    pl_sb_reset(ptVulkanGraph->sbtMemorySizes);
+    ptVulkanGraph->ulHash = 0;
+}
+
+static void
+pl__build_render_graph(plGraphics* ptGraphics)
 {
-    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+    plVulkanGraphics*    ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*      ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plRenderGraph*       ptGraph = &ptGraphics->tRenderGraph;
+    plVulkanRenderGraph* ptVulkanGraph = &ptVulkanGfx->tRenderGraph;
 
-    const uint32_t uBufferIndex = pl_sb_size(ptDevice->sbtBuffers);
+    pl__compile_render_graph(ptGraph, ptVulkanGfx->tSwapchain.tExtent.width, ptVulkanGfx->tSwapchain.tExtent.height);
 
-    plVulkanBuffer* ptBuffer = PL_ALLOC(sizeof(plVulkanBuffer));
-    memset(ptBuffer, 0, sizeof(plVulkanBuffer));
+    // graph structure unchanged since last frame, reuse everything
+    if(ptGraph->_ulHash == ptVulkanGraph->ulHash)
+        return;
 
-    plBuffer tBuffer = {
-        .pBuffer = ptBuffer
-    };
-    pl_sb_push(ptDevice->sbtBuffers, tBuffer);
+    pl_begin_profile_sample(__FUNCTION__);
 
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferDeviceMemory;
+    // old resources may still be referenced by frames in flight, so they go
+    // through the deletion queue
+    pl__destroy_render_graph(ptGraphics);
+    ptVulkanGraph->ulHash = ptGraph->_ulHash;
 
-    { // create staging buffer
+    const uint32_t uTextureCount = pl_sb_size(ptGraph->sbtTextures);
+    const uint32_t uPassCount = pl_sb_size(ptGraph->sbtPasses);
 
-        VkBufferCreateInfo bufferInfo = {0};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = szSize;
-        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~images~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-        PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &bufferInfo, NULL, &stagingBuffer));
+    pl_sb_resize(ptVulkanGraph->sbtTextures, uTextureCount);
+    memset(ptVulkanGraph->sbtTextures, 0, sizeof(plVulkanGraphTexture) * uTextureCount);
+    for(uint32_t i = 0; i < uTextureCount; i++)
+    {
+        const plRenderGraphTexture* ptTexture = &ptGraph->sbtTextures[i];
+        plVulkanGraphTexture* ptVulkanTexture = &ptVulkanGraph->sbtTextures[i];
 
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, stagingBuffer, &memRequirements);
+        // not used by any surviving pass
+        if(ptTexture->_uFirstPass == UINT32_MAX)
+            continue;
 
-        VkMemoryAllocateInfo allocInfo = {0};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = find_memory_type(ptVulkanDevice->tMemProps, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        ptVulkanTexture->tFormat = pl__vulkan_format(ptTexture->tDesc.tFormat);
+        ptVulkanTexture->tLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-        PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &allocInfo, NULL, &stagingBufferDeviceMemory));
-        PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, stagingBuffer, stagingBufferDeviceMemory, 0));
+        const bool bDepth = ptVulkanTexture->tFormat == VK_FORMAT_D32_SFLOAT || format_has_stencil(ptVulkanTexture->tFormat);
+        VkImageUsageFlags tUsage = 0;
+        if(bDepth)
+        {
+            tUsage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+            ptVulkanTexture->tAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+            if(format_has_stencil(ptVulkanTexture->tFormat))
+                ptVulkanTexture->tAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+        else
+        {
+            tUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+            ptVulkanTexture->tAspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        }
+        if(ptTexture->tDesc.uSampleCount == 1)
+            tUsage |= VK_IMAGE_USAGE_SAMPLED_BIT;
 
-        void* mapping;
-        PL_VULKAN(vkMapMemory(ptVulkanDevice->tLogicalDevice, stagingBufferDeviceMemory, 0, bufferInfo.size, 0, &mapping));
-        memcpy(mapping, pData, bufferInfo.size);
-        vkUnmapMemory(ptVulkanDevice->tLogicalDevice, stagingBufferDeviceMemory);
+        const VkImageCreateInfo tImageInfo = {
+            .sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType     = VK_IMAGE_TYPE_2D,
+            .extent        = 
+            {
+                .width  = ptTexture->tDesc.uWidth,
+                .height = ptTexture->tDesc.uHeight,
+                .depth  = 1
+            },
+            .mipLevels     = 1,
+            .arrayLayers   = 1,
+            .format        = ptVulkanTexture->tFormat,
+            .tiling        = VK_IMAGE_TILING_OPTIMAL,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .usage         = tUsage,
+            .sharingMode   = VK_SHARING_MODE_EXCLUSIVE,
+            .samples       = (VkSampleCountFlagBits)ptTexture->tDesc.uSampleCount,
+            .flags         = 0
+        };
+        PL_VULKAN(vkCreateImage(ptVulkanDevice->tLogicalDevice, &tImageInfo, NULL, &ptVulkanTexture->tImage));
+        vkGetImageMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptVulkanTexture->tImage, &ptVulkanTexture->tMemReqs);
+
+        if(ptTexture->tDesc.bPersistent)
+        {
+            ptVulkanTexture->tMemory = allocate_dedicated(&ptGraphics->tDevice, ptVulkanTexture->tMemReqs.memoryTypeBits, ptVulkanTexture->tMemReqs.size, ptVulkanTexture->tMemReqs.alignment, ptTexture->tDesc.pcName);
+            PL_VULKAN(vkBindImageMemory(ptVulkanDevice->tLogicalDevice, ptVulkanTexture->tImage, ptVulkanTexture->tMemory, 0));
+        }
     }
 
-    { // create final buffer
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~alias slots~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-        VkBufferCreateInfo bufferInfo = {0};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = szSize;
-        bufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    // transients with disjoint lifetimes share one allocation
+    pl_sb_resize(ptVulkanGraph->sbtMemory, ptGraph->_uAliasSlotCount);
+    pl_sb_resize(ptVulkanGraph->sbtMemorySizes, ptGraph->_uAliasSlotCount);
+    for(uint32_t uSlot = 0; uSlot < ptGraph->_uAliasSlotCount; uSlot++)
+    {
+        VkDeviceSize szSize = 0;
+        VkDeviceSize szAlignment = 1;
+        uint32_t uTypeBits = UINT32_MAX;
+        for(uint32_t i = 0; i < uTextureCount; i++)
+        {
+            if(ptGraph->sbtTextures[i]._uAliasSlot != uSlot)
+                continue;
+            const VkMemoryRequirements* ptMemReqs = &ptVulkanGraph->sbtTextures[i].tMemReqs;
+            szSize = ptMemReqs->size > szSize ? ptMemReqs->size : szSize;
+            szAlignment = ptMemReqs->alignment > szAlignment ? ptMemReqs->alignment : szAlignment;
+            uTypeBits &= ptMemReqs->memoryTypeBits;
+        }
+        PL_ASSERT(uTypeBits != 0 && "aliased render graph textures have no common memory type");
 
-        PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &bufferInfo, NULL, &ptBuffer->tBuffer));
+        ptVulkanGraph->sbtMemorySizes[uSlot] = szSize;
+        ptVulkanGraph->sbtMemory[uSlot] = allocate_dedicated(&ptGraphics->tDevice, uTypeBits, szSize, szAlignment, "render graph transient");
+        for(uint32_t i = 0; i < uTextureCount; i++)
+        {
+            if(ptGraph->sbtTextures[i]._uAliasSlot == uSlot)
+                PL_VULKAN(vkBindImageMemory(ptVulkanDevice->tLogicalDevice, ptVulkanGraph->sbtTextures[i].tImage, ptVulkanGraph->sbtMemory[uSlot], 0));
+        }
+    }
 
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptBuffer->tBuffer, &memRequirements);
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~views~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-        VkMemoryAllocateInfo allocInfo = {0};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = find_memory_type(ptVulkanDevice->tMemProps, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    for(uint32_t i = 0; i < uTextureCount; i++)
+    {
+        plVulkanGraphTexture* ptVulkanTexture = &ptVulkanGraph->sbtTextures[i];
+        if(ptVulkanTexture->tImage == VK_NULL_HANDLE)
+            continue;
+
+        const VkImageViewCreateInfo tViewInfo = {
+            .sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image                           = ptVulkanTexture->tImage,
+            .viewType                        = VK_IMAGE_VIEW_TYPE_2D,
+            .format                          = ptVulkanTexture->tFormat,
+            .subresourceRange.baseMipLevel   = 0,
+            .subresourceRange.levelCount     = 1,
+            .subresourceRange.baseArrayLayer = 0,
+            .subresourceRange.layerCount     = 1,
+            .subresourceRange.aspectMask     = ptVulkanTexture->tAspect,
+        };
+        PL_VULKAN(vkCreateImageView(ptVulkanDevice->tLogicalDevice, &tViewInfo, NULL, &ptVulkanTexture->tView));
 
-        PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &allocInfo, NULL, &ptBuffer->tMemory));
-        PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, ptBuffer->tBuffer, ptBuffer->tMemory, 0));
+        // depth stencil views can't be sampled with both aspects
+        if(ptGraph->sbtTextures[i].tDesc.uSampleCount == 1 && (ptVulkanTexture->tAspect & VK_IMAGE_ASPECT_STENCIL_BIT) == 0)
+            ptVulkanTexture->uBindlessSlot = pl__allocate_bindless_texture(ptVulkanDevice, ptVulkanTexture->tView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     }
 
-    // copy buffer
-    VkCommandBuffer tCommandBuffer = {0};
-    
-    const VkCommandBufferAllocateInfo tAllocInfo = {
-        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandPool        = ptVulkanDevice->tCmdPool,
-        .commandBufferCount = 1u,
-    };
-    vkAllocateCommandBuffers(ptVulkanDevice->tLogicalDevice, &tAllocInfo, &tCommandBuffer);
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~passes~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-    const VkCommandBufferBeginInfo tBeginInfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
-    };
+    pl_sb_resize(ptVulkanGraph->sbtPasses, uPassCount);
+    memset(ptVulkanGraph->sbtPasses, 0, sizeof(plVulkanGraphPass) * uPassCount);
+    for(uint32_t i = 0; i < uPassCount; i++)
+    {
+        const plRenderGraphPass* ptPass = &ptGraph->sbtPasses[i];
+        plVulkanGraphPass* ptVulkanPass = &ptVulkanGraph->sbtPasses[i];
+        if(ptPass->_bCulled)
+            continue;
+
+        VkAttachmentDescription atAttachments[PL_MAX_RENDER_GRAPH_ATTACHMENTS + 1] = {0};
+        VkAttachmentReference   atColorReferences[PL_MAX_RENDER_GRAPH_ATTACHMENTS] = {0};
+        VkAttachmentReference   tDepthReference = {0};
+        VkImageView             atViews[PL_MAX_RENDER_GRAPH_ATTACHMENTS + 1] = {0};
+        uint32_t                auTextures[PL_MAX_RENDER_GRAPH_ATTACHMENTS + 1] = {0};
+        uint32_t                uAttachmentCount = 0;
+
+        for(uint32_t j = 0; j < ptPass->tDesc.uColorOutputCount; j++)
+        {
+            atColorReferences[j].attachment = uAttachmentCount;
+            atColorReferences[j].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            auTextures[uAttachmentCount++] = ptPass->tDesc.auColorOutputs[j];
+        }
+        if(ptPass->tDesc.uDepthOutput != PL_RENDER_GRAPH_NONE)
+        {
+            tDepthReference.attachment = uAttachmentCount;
+            tDepthReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            auTextures[uAttachmentCount++] = ptPass->tDesc.uDepthOutput;
+        }
 
-    vkBeginCommandBuffer(tCommandBuffer, &tBeginInfo);
+        for(uint32_t j = 0; j < uAttachmentCount; j++)
+        {
+            const plRenderGraphTexture* ptTexture = &ptGraph->sbtTextures[auTextures[j] - 1];
+            const plVulkanGraphTexture* ptVulkanTexture = &ptVulkanGraph->sbtTextures[auTextures[j] - 1];
+            const bool bTransient = !ptTexture->tDesc.bPersistent;
+            const bool bDepth = ptVulkanTexture->tAspect != VK_IMAGE_ASPECT_COLOR_BIT;
+
+            // first writer of a transient has nothing worth loading, last
+            // user has nothing worth storing
+            VkAttachmentLoadOp tLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            if(ptPass->tDesc.bClear)
+                tLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            else if(bTransient && ptTexture->_uFirstPass == i)
+                tLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            const VkAttachmentStoreOp tStoreOp = (bTransient && ptTexture->_uLastPass == i) ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+            const VkImageLayout tLayout = bDepth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            const bool bStencil = (ptVulkanTexture->tAspect & VK_IMAGE_ASPECT_STENCIL_BIT) == VK_IMAGE_ASPECT_STENCIL_BIT;
+
+            atAttachments[j] = (VkAttachmentDescription){
+                .format         = ptVulkanTexture->tFormat,
+                .samples        = (VkSampleCountFlagBits)ptTexture->tDesc.uSampleCount,
+                .loadOp         = tLoadOp,
+                .storeOp        = tStoreOp,
+                .stencilLoadOp  = bStencil ? tLoadOp : VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                .stencilStoreOp = bStencil ? tStoreOp : VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                .initialLayout  = tLayout, // transitions are recorded by the graph
+                .finalLayout    = tLayout
+            };
+            atViews[j] = ptVulkanTexture->tView;
 
-    VkBufferCopy copyRegion = {0};
-    copyRegion.size = szSize;
-    vkCmdCopyBuffer(tCommandBuffer, stagingBuffer, ptBuffer->tBuffer, 1, &copyRegion);
+            if(j == 0)
+            {
+                ptVulkanPass->tExtent.width = ptTexture->tDesc.uWidth;
+                ptVulkanPass->tExtent.height = ptTexture->tDesc.uHeight;
+                ptVulkanPass->tSampleCount = atAttachments[j].samples;
+            }
+            PL_ASSERT(ptVulkanPass->tExtent.width == ptTexture->tDesc.uWidth && ptVulkanPass->tExtent.height == ptTexture->tDesc.uHeight && "render graph pass attachments differ in size");
+            PL_ASSERT(ptVulkanPass->tSampleCount == atAttachments[j].samples && "render graph pass attachments differ in sample count");
+        }
 
-    PL_VULKAN(vkEndCommandBuffer(tCommandBuffer));
-    const VkSubmitInfo tSubmitInfo = {
-        .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1u,
-        .pCommandBuffers    = &tCommandBuffer,
-    };
+        const VkSubpassDescription tSubpass = {
+            .pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .colorAttachmentCount    = ptPass->tDesc.uColorOutputCount,
+            .pColorAttachments       = atColorReferences,
+            .pDepthStencilAttachment = ptPass->tDesc.uDepthOutput != PL_RENDER_GRAPH_NONE ? &tDepthReference : NULL
+        };
 
-    PL_VULKAN(vkQueueSubmit(ptVulkanDevice->tGraphicsQueue, 1, &tSubmitInfo, VK_NULL_HANDLE));
-    PL_VULKAN(vkDeviceWaitIdle(ptVulkanDevice->tLogicalDevice));
-    vkFreeCommandBuffers(ptVulkanDevice->tLogicalDevice, ptVulkanDevice->tCmdPool, 1, &tCommandBuffer);
+        const VkRenderPassCreateInfo tRenderPassInfo = {
+            .sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+            .attachmentCount = uAttachmentCount,
+            .pAttachments    = atAttachments,
+            .subpassCount    = 1,
+            .pSubpasses      = &tSubpass
+        };
+        PL_VULKAN(vkCreateRenderPass(ptVulkanDevice->tLogicalDevice, &tRenderPassInfo, NULL, &ptVulkanPass->tRenderPass));
 
-    vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, stagingBuffer, NULL);
-    vkFreeMemory(ptVulkanDevice->tLogicalDevice, stagingBufferDeviceMemory, NULL);
-    return uBufferIndex;
+        const VkFramebufferCreateInfo tFrameBufferInfo = {
+            .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+            .renderPass      = ptVulkanPass->tRenderPass,
+            .attachmentCount = uAttachmentCount,
+            .pAttachments    = atViews,
+            .width           = ptVulkanPass->tExtent.width,
+            .height          = ptVulkanPass->tExtent.height,
+            .layers          = 1u,
+        };
+        PL_VULKAN(vkCreateFramebuffer(ptVulkanDevice->tLogicalDevice, &tFrameBufferInfo, NULL, &ptVulkanPass->tFramebuffer));
+    }
+
+    pl_log_debug_to_f(uLogChannel, "render graph rebuilt: %u passes, %u textures, %u alias slots", uPassCount, uTextureCount, ptGraph->_uAliasSlotCount);
+    pl_end_profile_sample();
 }
 
-static uint32_t
-pl_create_vertex_buffer(plDevice* ptDevice, size_t szSize, size_t szStride, const void* pData, const char* pcName)
+static void
+pl__add_graph_barrier(plVulkanGraphTexture* ptTexture, bool bTransient, VkImageLayout tNewLayout, VkImageMemoryBarrier* atBarriers, uint32_t* puBarrierCount, VkPipelineStageFlags* ptSrcStages, VkPipelineStageFlags* ptDstStages)
 {
-    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
-
-    const uint32_t uBufferIndex = pl_sb_size(ptDevice->sbtBuffers);
-
-    plVulkanBuffer* ptBuffer = PL_ALLOC(sizeof(plVulkanBuffer));
-    memset(ptBuffer, 0, sizeof(plVulkanBuffer));
+    // read after read needs no synchronization
+    if(ptTexture->tLayout == tNewLayout && tNewLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+        return;
 
-    plBuffer tBuffer = {
-        .pBuffer = ptBuffer
+    VkImageMemoryBarrier tBarrier = {
+        .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .oldLayout           = ptTexture->tLayout,
+        .newLayout           = tNewLayout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image               = ptTexture->tImage,
+        .subresourceRange    = {
+            .aspectMask     = ptTexture->tAspect,
+            .baseMipLevel   = 0,
+            .levelCount     = 1,
+            .baseArrayLayer = 0,
+            .layerCount     = 1
+        }
     };
-    pl_sb_push(ptDevice->sbtBuffers, tBuffer);
 
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferDeviceMemory;
+    VkPipelineStageFlags tSrcStages = 0;
+    VkPipelineStageFlags tDstStages = 0;
+    pl__get_layout_sync(ptTexture->tLayout, &tSrcStages, &tBarrier.srcAccessMask);
+    pl__get_layout_sync(tNewLayout, &tDstStages, &tBarrier.dstAccessMask);
 
-    { // create staging buffer
+    // first use of aliased memory this frame, wait on whatever the previous
+    // tenant (or the previous frame) was doing with it
+    if(bTransient && ptTexture->tLayout == VK_IMAGE_LAYOUT_UNDEFINED)
+    {
+        tSrcStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        tBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    }
 
-        VkBufferCreateInfo bufferInfo = {0};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = szSize;
-        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    atBarriers[(*puBarrierCount)++] = tBarrier;
+    *ptSrcStages |= tSrcStages;
+    *ptDstStages |= tDstStages;
+    ptTexture->tLayout = tNewLayout;
+}
 
-        PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &bufferInfo, NULL, &stagingBuffer));
+static void
+pl__execute_render_graph(plGraphics* ptGraphics)
+{
+    plVulkanGraphics*    ptVulkanGfx = ptGraphics->_pInternalData;
+    plRenderGraph*       ptGraph = &ptGraphics->tRenderGraph;
+    plVulkanRenderGraph* ptVulkanGraph = &ptVulkanGfx->tRenderGraph;
 
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, stagingBuffer, &memRequirements);
+    if(pl_sb_size(ptGraph->sbtPasses) == 0)
+        return;
 
-        VkMemoryAllocateInfo allocInfo = {0};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = find_memory_type(ptVulkanDevice->tMemProps, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    pl_begin_profile_sample(__FUNCTION__);
+    pl__build_render_graph(ptGraphics);
 
-        PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &allocInfo, NULL, &stagingBufferDeviceMemory));
-        PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, stagingBuffer, stagingBufferDeviceMemory, 0));
+    plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGraphics);
 
-        void* mapping;
-        PL_VULKAN(vkMapMemory(ptVulkanDevice->tLogicalDevice, stagingBufferDeviceMemory, 0, bufferInfo.size, 0, &mapping));
-        memcpy(mapping, pData, bufferInfo.size);
-        vkUnmapMemory(ptVulkanDevice->tLogicalDevice, stagingBufferDeviceMemory);
+    // transient contents never survive the frame
+    for(uint32_t i = 0; i < pl_sb_size(ptGraph->sbtTextures); i++)
+    {
+        if(!ptGraph->sbtTextures[i].tDesc.bPersistent)
+            ptVulkanGraph->sbtTextures[i].tLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     }
 
-    { // create final buffer
+    for(uint32_t i = 0; i < pl_sb_size(ptGraph->sbtPasses); i++)
+    {
+        const plRenderGraphPass* ptPass = &ptGraph->sbtPasses[i];
+        const plVulkanGraphPass* ptVulkanPass = &ptVulkanGraph->sbtPasses[i];
+        if(ptPass->_bCulled)
+            continue;
 
-        VkBufferCreateInfo bufferInfo = {0};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = szSize;
-        bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~barriers~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-        PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &bufferInfo, NULL, &ptBuffer->tBuffer));
+        VkImageMemoryBarrier atBarriers[PL_MAX_RENDER_GRAPH_ATTACHMENTS + 1 + PL_MAX_RENDER_GRAPH_INPUTS] = {0};
+        uint32_t uBarrierCount = 0;
+        VkPipelineStageFlags tSrcStages = 0;
+        VkPipelineStageFlags tDstStages = 0;
 
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptBuffer->tBuffer, &memRequirements);
+        for(uint32_t j = 0; j < ptPass->tDesc.uInputCount; j++)
+        {
+            const uint32_t uTexture = ptPass->tDesc.auInputs[j] - 1;
+            pl__add_graph_barrier(&ptVulkanGraph->sbtTextures[uTexture], !ptGraph->sbtTextures[uTexture].tDesc.bPersistent,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, atBarriers, &uBarrierCount, &tSrcStages, &tDstStages);
+        }
+        for(uint32_t j = 0; j < ptPass->tDesc.uColorOutputCount; j++)
+        {
+            const uint32_t uTexture = ptPass->tDesc.auColorOutputs[j] - 1;
+            pl__add_graph_barrier(&ptVulkanGraph->sbtTextures[uTexture], !ptGraph->sbtTextures[uTexture].tDesc.bPersistent,
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, atBarriers, &uBarrierCount, &tSrcStages, &tDstStages);
+        }
+        if(ptPass->tDesc.uDepthOutput != PL_RENDER_GRAPH_NONE)
+        {
+            const uint32_t uTexture = ptPass->tDesc.uDepthOutput - 1;
+            pl__add_graph_barrier(&ptVulkanGraph->sbtTextures[uTexture], !ptGraph->sbtTextures[uTexture].tDesc.bPersistent,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, atBarriers, &uBarrierCount, &tSrcStages, &tDstStages);
+        }
 
-        VkMemoryAllocateInfo allocInfo = {0};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = find_memory_type(ptVulkanDevice->tMemProps, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        // one batched barrier per pass
+        if(uBarrierCount > 0)
+            vkCmdPipelineBarrier(ptCurrentFrame->tCmdBuf, tSrcStages, tDstStages, 0, 0, NULL, 0, NULL, uBarrierCount, atBarriers);
 
-        PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &allocInfo, NULL, &ptBuffer->tMemory));
-        PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, ptBuffer->tBuffer, ptBuffer->tMemory, 0));
+        //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~pass~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+        VkClearValue atClearValues[PL_MAX_RENDER_GRAPH_ATTACHMENTS + 1] = {0};
+        uint32_t uClearValueCount = 0;
+        for(uint32_t j = 0; j < ptPass->tDesc.uColorOutputCount; j++)
+        {
+            for(uint32_t k = 0; k < 4; k++)
+                atClearValues[uClearValueCount].color.float32[k] = ptPass->tDesc.afClearColor[k];
+            uClearValueCount++;
+        }
+        if(ptPass->tDesc.uDepthOutput != PL_RENDER_GRAPH_NONE)
+            atClearValues[uClearValueCount++].depthStencil.depth = ptPass->tDesc.fClearDepth;
+
+        const VkRenderPassBeginInfo tRenderPassInfo = {
+            .sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+            .renderPass        = ptVulkanPass->tRenderPass,
+            .framebuffer       = ptVulkanPass->tFramebuffer,
+            .renderArea.extent = ptVulkanPass->tExtent,
+            .clearValueCount   = uClearValueCount,
+            .pClearValues      = atClearValues
+        };
+
+        const VkRect2D tScissor = {
+            .extent = ptVulkanPass->tExtent
+        };
+
+        const VkViewport tViewport = {
+            .width    = (float)ptVulkanPass->tExtent.width,
+            .height   = (float)ptVulkanPass->tExtent.height,
+            .maxDepth = 1.0f
+        };
+
+        vkCmdBeginRenderPass(ptCurrentFrame->tCmdBuf, &tRenderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdSetViewport(ptCurrentFrame->tCmdBuf, 0, 1, &tViewport);
+        vkCmdSetScissor(ptCurrentFrame->tCmdBuf, 0, 1, &tScissor);
+
+        ptVulkanGfx->tCurrentRenderPass = ptVulkanPass->tRenderPass;
+        ptVulkanGfx->tCurrentSampleCount = ptVulkanPass->tSampleCount;
+        if(ptPass->tDesc.execute)
+            ptPass->tDesc.execute(ptGraphics, ptPass->tDesc.pUserData);
+
+        vkCmdEndRenderPass(ptCurrentFrame->tCmdBuf);
     }
 
-    // copy buffer
+    // leave textures the main pass samples shader readable
+    VkImageMemoryBarrier atBarriers[16] = {0};
+    uint32_t uBarrierCount = 0;
+    VkPipelineStageFlags tSrcStages = 0;
+    VkPipelineStageFlags tDstStages = 0;
+    for(uint32_t i = 0; i < pl_sb_size(ptGraph->sbtTextures); i++)
+    {
+        plVulkanGraphTexture* ptVulkanTexture = &ptVulkanGraph->sbtTextures[i];
+        if(!ptGraph->sbtTextures[i].tDesc.bSampledAfter || ptVulkanTexture->uBindlessSlot == 0)
+            continue;
+        pl__add_graph_barrier(ptVulkanTexture, !ptGraph->sbtTextures[i].tDesc.bPersistent,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, atBarriers, &uBarrierCount, &tSrcStages, &tDstStages);
+        if(uBarrierCount == sizeof(atBarriers) / sizeof(atBarriers[0]))
+        {
+            vkCmdPipelineBarrier(ptCurrentFrame->tCmdBuf, tSrcStages, tDstStages, 0, 0, NULL, 0, NULL, uBarrierCount, atBarriers);
+            uBarrierCount = 0;
+            tSrcStages = 0;
+            tDstStages = 0;
+        }
+    }
+    if(uBarrierCount > 0)
+        vkCmdPipelineBarrier(ptCurrentFrame->tCmdBuf, tSrcStages, tDstStages, 0, 0, NULL, 0, NULL, uBarrierCount, atBarriers);
+
+    // back to the main pass
+    ptVulkanGfx->tCurrentRenderPass = ptVulkanGfx->tRenderPass;
+    ptVulkanGfx->tCurrentSampleCount = ptVulkanGfx->tSwapchain.tMsaaSamples;
+    pl_end_profile_sample();
+}
+
+static void
+pl__create_main_framebuffers(plGraphics* ptGraphics)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+
+    pl_sb_resize(ptVulkanGfx->tSwapchain.sbtFrameBuffers, ptVulkanGfx->tSwapchain.uImageCount);
+    for(uint32_t i = 0; i < ptVulkanGfx->tSwapchain.uImageCount; i++)
+    {
+        ptVulkanGfx->tSwapchain.sbtFrameBuffers[i] = VK_NULL_HANDLE;
+
+        VkImageView atViewAttachments[] = {
+            ptVulkanGfx->tSwapchain.tColorTextureView,
+            ptVulkanGfx->tSwapchain.tDepthTextureView,
+            ptVulkanGfx->tSwapchain.sbtImageViews[i]
+        };
+
+        VkFramebufferCreateInfo tFrameBufferInfo = {
+            .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+            .renderPass      = ptVulkanGfx->tRenderPass,
+            .attachmentCount = 3,
+            .pAttachments    = atViewAttachments,
+            .width           = ptVulkanGfx->tSwapchain.tExtent.width,
+            .height          = ptVulkanGfx->tSwapchain.tExtent.height,
+            .layers          = 1u,
+        };
+        PL_VULKAN(vkCreateFramebuffer(ptVulkanDevice->tLogicalDevice, &tFrameBufferInfo, NULL, &ptVulkanGfx->tSwapchain.sbtFrameBuffers[i]));
+    }
+}
+
+static bool
+pl__recreate_swapchain(plGraphics* ptGraphics)
+{
+    plIO* ptIOCtx = pl_get_io();
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+
+    // minimized, keep the request pending until there is something to draw to
+    if(ptIOCtx->afMainViewportSize[0] < 1.0f || ptIOCtx->afMainViewportSize[1] < 1.0f)
+        return false;
+
+    create_swapchain(ptGraphics, (uint32_t)ptIOCtx->afMainViewportSize[0], (uint32_t)ptIOCtx->afMainViewportSize[1], &ptVulkanGfx->tSwapchain);
+    pl__create_main_framebuffers(ptGraphics);
+    ptVulkanGfx->bSwapchainDirty = false;
+    ptVulkanGfx->bResizePending = false;
+    return true;
+}
+
+static void
+pl__create_bindless_heap(plGraphics* ptGraphics)
+{
+    plVulkanGraphics*     ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*       ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanBindlessHeap* ptHeap = &ptVulkanDevice->tBindless;
+    const VkDevice        tDevice = ptVulkanDevice->tLogicalDevice;
+
+    // slot counts (clamped to what a single stage may access)
+    if(ptHeap->bDescriptorIndexing)
+    {
+        VkPhysicalDeviceDescriptorIndexingProperties tIndexingProps = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES
+        };
+        VkPhysicalDeviceProperties2 tProps2 = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &tIndexingProps
+        };
+        vkGetPhysicalDeviceProperties2(ptVulkanDevice->tPhysicalDevice, &tProps2);
+        ptHeap->uTextureSlotCount = pl_minu(PL_VULKAN_BINDLESS_TEXTURE_SLOTS, tIndexingProps.maxPerStageDescriptorUpdateAfterBindSampledImages);
+        ptHeap->uBufferSlotCount  = pl_minu(PL_VULKAN_BINDLESS_BUFFER_SLOTS, tIndexingProps.maxPerStageDescriptorUpdateAfterBindStorageBuffers);
+    }
+    else
+    {
+        const VkPhysicalDeviceLimits* ptLimits = &ptVulkanDevice->tDeviceProps.limits;
+        ptHeap->uTextureSlotCount = pl_minu(PL_VULKAN_FALLBACK_TEXTURE_SLOTS, ptLimits->maxPerStageDescriptorSampledImages);
+        ptHeap->uBufferSlotCount  = pl_minu(PL_VULKAN_FALLBACK_BUFFER_SLOTS, ptLimits->maxPerStageDescriptorStorageBuffers);
+    }
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~defaults~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    const VkSamplerCreateInfo tSamplerInfo = {
+        .sType        = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .magFilter    = VK_FILTER_LINEAR,
+        .minFilter    = VK_FILTER_LINEAR,
+        .mipmapMode   = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+        .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .maxLod       = VK_LOD_CLAMP_NONE
+    };
+    PL_VULKAN(vkCreateSampler(tDevice, &tSamplerInfo, NULL, &ptHeap->tSampler));
+
+    const VkImageCreateInfo tImageInfo = {
+        .sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType     = VK_IMAGE_TYPE_2D,
+        .format        = VK_FORMAT_R8G8B8A8_UNORM,
+        .extent        = {1, 1, 1},
+        .mipLevels     = 1,
+        .arrayLayers   = 1,
+        .samples       = VK_SAMPLE_COUNT_1_BIT,
+        .tiling        = VK_IMAGE_TILING_OPTIMAL,
+        .usage         = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        .sharingMode   = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    };
+    PL_VULKAN(vkCreateImage(tDevice, &tImageInfo, NULL, &ptHeap->tDefaultImage));
+
+    VkMemoryRequirements tImageMemReqs = {0};
+    vkGetImageMemoryRequirements(tDevice, ptHeap->tDefaultImage, &tImageMemReqs);
+    ptHeap->tDefaultImageMemory = allocate_dedicated(&ptGraphics->tDevice, tImageMemReqs.memoryTypeBits, tImageMemReqs.size, tImageMemReqs.alignment, "bindless default texture");
+    PL_VULKAN(vkBindImageMemory(tDevice, ptHeap->tDefaultImage, ptHeap->tDefaultImageMemory, 0));
+
+    const VkImageViewCreateInfo tViewInfo = {
+        .sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image            = ptHeap->tDefaultImage,
+        .viewType         = VK_IMAGE_VIEW_TYPE_2D,
+        .format           = VK_FORMAT_R8G8B8A8_UNORM,
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .levelCount = 1,
+            .layerCount = 1
+        }
+    };
+    PL_VULKAN(vkCreateImageView(tDevice, &tViewInfo, NULL, &ptHeap->tDefaultImageView));
+
+    const VkBufferCreateInfo tBufferInfo = {
+        .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size        = 256,
+        .usage       = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, // also missing vertex streams of shader variants
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+    };
+    PL_VULKAN(vkCreateBuffer(tDevice, &tBufferInfo, NULL, &ptHeap->tDefaultBuffer));
+
+    VkMemoryRequirements tBufferMemReqs = {0};
+    vkGetBufferMemoryRequirements(tDevice, ptHeap->tDefaultBuffer, &tBufferMemReqs);
+    ptHeap->tDefaultBufferMemory = allocate_dedicated(&ptGraphics->tDevice, tBufferMemReqs.memoryTypeBits, tBufferMemReqs.size, tBufferMemReqs.alignment, "bindless default buffer");
+    PL_VULKAN(vkBindBufferMemory(tDevice, ptHeap->tDefaultBuffer, ptHeap->tDefaultBufferMemory, 0));
+
+    // default texture is opaque white, default buffer is zeroed
     VkCommandBuffer tCommandBuffer = {0};
-    
     const VkCommandBufferAllocateInfo tAllocInfo = {
         .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
         .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
         .commandPool        = ptVulkanDevice->tCmdPool,
         .commandBufferCount = 1u,
     };
-    vkAllocateCommandBuffers(ptVulkanDevice->tLogicalDevice, &tAllocInfo, &tCommandBuffer);
+    vkAllocateCommandBuffers(tDevice, &tAllocInfo, &tCommandBuffer);
 
     const VkCommandBufferBeginInfo tBeginInfo = {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
         .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
     };
-
     vkBeginCommandBuffer(tCommandBuffer, &tBeginInfo);
 
-    VkBufferCopy copyRegion = {0};
-    copyRegion.size = szSize;
-    vkCmdCopyBuffer(tCommandBuffer, stagingBuffer, ptBuffer->tBuffer, 1, &copyRegion);
+    const VkImageSubresourceRange tRange = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .levelCount = 1,
+        .layerCount = 1
+    };
+    const VkClearColorValue tWhite = {.float32 = {1.0f, 1.0f, 1.0f, 1.0f}};
+    pl__transition_image_layout(tCommandBuffer, ptHeap->tDefaultImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, tRange);
+    vkCmdClearColorImage(tCommandBuffer, ptHeap->tDefaultImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &tWhite, 1, &tRange);
+    pl__transition_image_layout(tCommandBuffer, ptHeap->tDefaultImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, tRange);
+    vkCmdFillBuffer(tCommandBuffer, ptHeap->tDefaultBuffer, 0, VK_WHOLE_SIZE, 0);
 
     PL_VULKAN(vkEndCommandBuffer(tCommandBuffer));
     const VkSubmitInfo tSubmitInfo = {
@@ -1756,74 +2900,3745 @@ pl_create_vertex_buffer(plDevice* ptDevice, size_t szSize, size_t szStride, cons
         .commandBufferCount = 1u,
         .pCommandBuffers    = &tCommandBuffer,
     };
-
     PL_VULKAN(vkQueueSubmit(ptVulkanDevice->tGraphicsQueue, 1, &tSubmitInfo, VK_NULL_HANDLE));
-    PL_VULKAN(vkDeviceWaitIdle(ptVulkanDevice->tLogicalDevice));
-    vkFreeCommandBuffers(ptVulkanDevice->tLogicalDevice, ptVulkanDevice->tCmdPool, 1, &tCommandBuffer);
+    PL_VULKAN(vkDeviceWaitIdle(tDevice));
+    vkFreeCommandBuffers(tDevice, ptVulkanDevice->tCmdPool, 1, &tCommandBuffer);
 
-    vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, stagingBuffer, NULL);
-    vkFreeMemory(ptVulkanDevice->tLogicalDevice, stagingBufferDeviceMemory, NULL);
-    return uBufferIndex;
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~layout~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // 0: immutable sampler, 1: sampled images, 2: storage buffers
+    const VkDescriptorSetLayoutBinding atBindings[] = {
+        {
+            .binding            = 0,
+            .descriptorType     = VK_DESCRIPTOR_TYPE_SAMPLER,
+            .descriptorCount    = 1,
+            .stageFlags         = VK_SHADER_STAGE_ALL_GRAPHICS,
+            .pImmutableSamplers = &ptHeap->tSampler
+        },
+        {
+            .binding         = 1,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+            .descriptorCount = ptHeap->uTextureSlotCount,
+            .stageFlags      = VK_SHADER_STAGE_ALL_GRAPHICS
+        },
+        {
+            .binding         = 2,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = ptHeap->uBufferSlotCount,
+            .stageFlags      = VK_SHADER_STAGE_ALL_GRAPHICS
+        }
+    };
+
+    const VkDescriptorBindingFlags tArrayFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    const VkDescriptorBindingFlags atBindingFlags[] = { 0, tArrayFlags, tArrayFlags };
+    const VkDescriptorSetLayoutBindingFlagsCreateInfo tBindingFlagsInfo = {
+        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount  = 3,
+        .pBindingFlags = atBindingFlags
+    };
+
+    const VkDescriptorSetLayoutCreateInfo tLayoutInfo = {
+        .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext        = ptHeap->bDescriptorIndexing ? &tBindingFlagsInfo : NULL,
+        .flags        = ptHeap->bDescriptorIndexing ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT : 0,
+        .bindingCount = 3,
+        .pBindings    = atBindings
+    };
+    PL_VULKAN(vkCreateDescriptorSetLayout(tDevice, &tLayoutInfo, NULL, &ptHeap->tSetLayout));
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~sets~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // without update after bind a set can't change while a frame using it is
+    // in flight, so each frame in flight gets its own copy
+    const uint32_t uSetCount = ptHeap->bDescriptorIndexing ? 1 : PL_VULKAN_MAX_FRAMES_IN_FLIGHT;
+
+    const VkDescriptorPoolSize atPoolSizes[] = {
+        { VK_DESCRIPTOR_TYPE_SAMPLER,        uSetCount },
+        { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,  uSetCount * ptHeap->uTextureSlotCount },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, uSetCount * ptHeap->uBufferSlotCount }
+    };
+    const VkDescriptorPoolCreateInfo tPoolInfo = {
+        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags         = ptHeap->bDescriptorIndexing ? VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT : 0,
+        .maxSets       = uSetCount,
+        .poolSizeCount = 3,
+        .pPoolSizes    = atPoolSizes
+    };
+    PL_VULKAN(vkCreateDescriptorPool(tDevice, &tPoolInfo, NULL, &ptHeap->tPool));
+
+    VkDescriptorSetLayout atSetLayouts[PL_VULKAN_MAX_FRAMES_IN_FLIGHT] = {0};
+    for(uint32_t i = 0; i < uSetCount; i++)
+        atSetLayouts[i] = ptHeap->tSetLayout;
+
+    const VkDescriptorSetAllocateInfo tSetAllocInfo = {
+        .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool     = ptHeap->tPool,
+        .descriptorSetCount = uSetCount,
+        .pSetLayouts        = atSetLayouts
+    };
+    PL_VULKAN(vkAllocateDescriptorSets(tDevice, &tSetAllocInfo, ptHeap->atSets));
+
+    // every slot starts out pointing at the defaults
+    ptHeap->atTextureInfos = PL_ALLOC(sizeof(VkDescriptorImageInfo) * ptHeap->uTextureSlotCount);
+    ptHeap->atBufferInfos  = PL_ALLOC(sizeof(VkDescriptorBufferInfo) * ptHeap->uBufferSlotCount);
+    for(uint32_t i = 0; i < ptHeap->uTextureSlotCount; i++)
+        ptHeap->atTextureInfos[i] = (VkDescriptorImageInfo){.imageView = ptHeap->tDefaultImageView, .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    for(uint32_t i = 0; i < ptHeap->uBufferSlotCount; i++)
+        ptHeap->atBufferInfos[i] = (VkDescriptorBufferInfo){.buffer = ptHeap->tDefaultBuffer, .range = VK_WHOLE_SIZE};
+
+    // partially bound sets only need the default slots written
+    for(uint32_t i = 0; i < uSetCount; i++)
+    {
+        const VkWriteDescriptorSet atWrites[] = {
+            {
+                .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet          = ptHeap->atSets[i],
+                .dstBinding      = 1,
+                .descriptorCount = ptHeap->bDescriptorIndexing ? 1 : ptHeap->uTextureSlotCount,
+                .descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                .pImageInfo      = ptHeap->atTextureInfos
+            },
+            {
+                .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet          = ptHeap->atSets[i],
+                .dstBinding      = 2,
+                .descriptorCount = ptHeap->bDescriptorIndexing ? 1 : ptHeap->uBufferSlotCount,
+                .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .pBufferInfo     = ptHeap->atBufferInfos
+            }
+        };
+        vkUpdateDescriptorSets(tDevice, 2, atWrites, 0, NULL);
+    }
+
+    // reserve the default slots
+    ptHeap->uNextTextureSlot = 1;
+    ptHeap->uNextBufferSlot = 1;
+    ptHeap->uActiveSets = ptVulkanGfx->uFramesInFlight;
+
+    pl_log_info_to_f(uLogChannel, "bindless descriptors: %s (%u textures, %u buffers)",
+        ptHeap->bDescriptorIndexing ? "descriptor indexing" : "fallback", ptHeap->uTextureSlotCount, ptHeap->uBufferSlotCount);
 }
 
 static void
-pl_begin_recording(plGraphics* ptGraphics)
+pl__destroy_bindless_heap(plVulkanDevice* ptVulkanDevice)
+{
+    plVulkanBindlessHeap* ptHeap = &ptVulkanDevice->tBindless;
+    const VkDevice        tDevice = ptVulkanDevice->tLogicalDevice;
+
+    vkDestroyDescriptorPool(tDevice, ptHeap->tPool, NULL);
+    vkDestroyDescriptorSetLayout(tDevice, ptHeap->tSetLayout, NULL);
+    vkDestroySampler(tDevice, ptHeap->tSampler, NULL);
+    vkDestroyImageView(tDevice, ptHeap->tDefaultImageView, NULL);
+    vkDestroyImage(tDevice, ptHeap->tDefaultImage, NULL);
+    vkFreeMemory(tDevice, ptHeap->tDefaultImageMemory, NULL);
+    vkDestroyBuffer(tDevice, ptHeap->tDefaultBuffer, NULL);
+    vkFreeMemory(tDevice, ptHeap->tDefaultBufferMemory, NULL);
+
+    PL_FREE(ptHeap->atTextureInfos);
+    PL_FREE(ptHeap->atBufferInfos);
+    pl_sb_free(ptHeap->sbuFreeTextureSlots);
+    pl_sb_free(ptHeap->sbuFreeBufferSlots);
+    for(uint32_t i = 0; i < PL_VULKAN_MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        pl_sb_free(ptHeap->asbuDirtyTextureSlots[i]);
+        pl_sb_free(ptHeap->asbuDirtyBufferSlots[i]);
+    }
+}
+
+static void
+pl__write_bindless_slot(plVulkanDevice* ptVulkanDevice, plVulkanResourceType tType, uint32_t uSlot)
+{
+    plVulkanBindlessHeap* ptHeap = &ptVulkanDevice->tBindless;
+    const bool bTexture = tType == PL_VULKAN_RESOURCE_TYPE_TEXTURE_SLOT;
+
+    // fallback sets may be in use, so they are updated when their frame comes back around
+    if(!ptHeap->bDescriptorIndexing)
+    {
+        for(uint32_t i = 0; i < ptHeap->uActiveSets; i++)
+        {
+            if(bTexture) pl_sb_push(ptHeap->asbuDirtyTextureSlots[i], uSlot);
+            else         pl_sb_push(ptHeap->asbuDirtyBufferSlots[i], uSlot);
+        }
+        return;
+    }
+
+    // update after bind, no need to wait for in flight frames
+    const VkWriteDescriptorSet tWrite = {
+        .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet          = ptHeap->atSets[0],
+        .dstBinding      = bTexture ? 1 : 2,
+        .dstArrayElement = uSlot,
+        .descriptorCount = 1,
+        .descriptorType  = bTexture ? VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .pImageInfo      = bTexture ? &ptHeap->atTextureInfos[uSlot] : NULL,
+        .pBufferInfo     = bTexture ? NULL : &ptHeap->atBufferInfos[uSlot]
+    };
+    vkUpdateDescriptorSets(ptVulkanDevice->tLogicalDevice, 1, &tWrite, 0, NULL);
+}
+
+static uint32_t
+pl__allocate_bindless_texture(plVulkanDevice* ptVulkanDevice, VkImageView tView, VkImageLayout tLayout)
+{
+    plVulkanBindlessHeap* ptHeap = &ptVulkanDevice->tBindless;
+
+    uint32_t uSlot = 0;
+    if(pl_sb_size(ptHeap->sbuFreeTextureSlots) > 0)
+        uSlot = pl_sb_pop(ptHeap->sbuFreeTextureSlots);
+    else
+    {
+        PL_ASSERT(ptHeap->uNextTextureSlot < ptHeap->uTextureSlotCount && "out of bindless texture slots");
+        uSlot = ptHeap->uNextTextureSlot++;
+    }
+
+    ptHeap->atTextureInfos[uSlot] = (VkDescriptorImageInfo){.imageView = tView, .imageLayout = tLayout};
+    pl__write_bindless_slot(ptVulkanDevice, PL_VULKAN_RESOURCE_TYPE_TEXTURE_SLOT, uSlot);
+    return uSlot;
+}
+
+static uint32_t
+pl__allocate_bindless_buffer(plVulkanDevice* ptVulkanDevice, VkBuffer tBuffer, VkDeviceSize szRange)
+{
+    plVulkanBindlessHeap* ptHeap = &ptVulkanDevice->tBindless;
+
+    uint32_t uSlot = 0;
+    if(pl_sb_size(ptHeap->sbuFreeBufferSlots) > 0)
+        uSlot = pl_sb_pop(ptHeap->sbuFreeBufferSlots);
+    else
+    {
+        PL_ASSERT(ptHeap->uNextBufferSlot < ptHeap->uBufferSlotCount && "out of bindless buffer slots");
+        uSlot = ptHeap->uNextBufferSlot++;
+    }
+
+    ptHeap->atBufferInfos[uSlot] = (VkDescriptorBufferInfo){.buffer = tBuffer, .range = szRange};
+    pl__write_bindless_slot(ptVulkanDevice, PL_VULKAN_RESOURCE_TYPE_BUFFER_SLOT, uSlot);
+    return uSlot;
+}
+
+static void
+pl__release_bindless_slot(plVulkanDevice* ptVulkanDevice, plVulkanResourceType tType, uint32_t uSlot)
+{
+    plVulkanBindlessHeap* ptHeap = &ptVulkanDevice->tBindless;
+    PL_ASSERT(uSlot > 0 && "default slots are never released");
+
+    // point the slot back at the default so nothing dangles until it's reused
+    if(tType == PL_VULKAN_RESOURCE_TYPE_TEXTURE_SLOT)
+    {
+        ptHeap->atTextureInfos[uSlot] = (VkDescriptorImageInfo){.imageView = ptHeap->tDefaultImageView, .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        pl_sb_push(ptHeap->sbuFreeTextureSlots, uSlot);
+    }
+    else
+    {
+        ptHeap->atBufferInfos[uSlot] = (VkDescriptorBufferInfo){.buffer = ptHeap->tDefaultBuffer, .range = VK_WHOLE_SIZE};
+        pl_sb_push(ptHeap->sbuFreeBufferSlots, uSlot);
+    }
+    pl__write_bindless_slot(ptVulkanDevice, tType, uSlot);
+}
+
+static void
+pl__flush_bindless_writes(plVulkanDevice* ptVulkanDevice, uint32_t uFrameIndex)
+{
+    plVulkanBindlessHeap* ptHeap = &ptVulkanDevice->tBindless;
+    if(ptHeap->bDescriptorIndexing)
+        return;
+
+    const uint32_t uTextureWrites = pl_sb_size(ptHeap->asbuDirtyTextureSlots[uFrameIndex]);
+    const uint32_t uBufferWrites = pl_sb_size(ptHeap->asbuDirtyBufferSlots[uFrameIndex]);
+    if(uTextureWrites + uBufferWrites == 0)
+        return;
+
+    VkWriteDescriptorSet* sbtWrites = NULL;
+    pl_sb_reserve(sbtWrites, uTextureWrites + uBufferWrites);
+    for(uint32_t i = 0; i < uTextureWrites; i++)
+    {
+        const uint32_t uSlot = ptHeap->asbuDirtyTextureSlots[uFrameIndex][i];
+        const VkWriteDescriptorSet tWrite = {
+            .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet          = ptHeap->atSets[uFrameIndex],
+            .dstBinding      = 1,
+            .dstArrayElement = uSlot,
+            .descriptorCount = 1,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+            .pImageInfo      = &ptHeap->atTextureInfos[uSlot]
+        };
+        pl_sb_push(sbtWrites, tWrite);
+    }
+    for(uint32_t i = 0; i < uBufferWrites; i++)
+    {
+        const uint32_t uSlot = ptHeap->asbuDirtyBufferSlots[uFrameIndex][i];
+        const VkWriteDescriptorSet tWrite = {
+            .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet          = ptHeap->atSets[uFrameIndex],
+            .dstBinding      = 2,
+            .dstArrayElement = uSlot,
+            .descriptorCount = 1,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo     = &ptHeap->atBufferInfos[uSlot]
+        };
+        pl_sb_push(sbtWrites, tWrite);
+    }
+    vkUpdateDescriptorSets(ptVulkanDevice->tLogicalDevice, pl_sb_size(sbtWrites), sbtWrites, 0, NULL);
+    pl_sb_free(sbtWrites);
+
+    pl_sb_reset(ptHeap->asbuDirtyTextureSlots[uFrameIndex]);
+    pl_sb_reset(ptHeap->asbuDirtyBufferSlots[uFrameIndex]);
+}
+
+static void
+pl__set_bindless_active_sets(plVulkanDevice* ptVulkanDevice, uint32_t uSetCount)
+{
+    plVulkanBindlessHeap* ptHeap = &ptVulkanDevice->tBindless;
+    const uint32_t uOldSetCount = ptHeap->uActiveSets;
+    ptHeap->uActiveSets = uSetCount;
+    if(ptHeap->bDescriptorIndexing)
+        return;
+
+    for(uint32_t i = uSetCount; i < uOldSetCount; i++)
+    {
+        pl_sb_reset(ptHeap->asbuDirtyTextureSlots[i]);
+        pl_sb_reset(ptHeap->asbuDirtyBufferSlots[i]);
+    }
+
+    // sets coming back into use missed every write while idle
+    for(uint32_t i = uOldSetCount; i < uSetCount; i++)
+    {
+        const VkWriteDescriptorSet atWrites[] = {
+            {
+                .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet          = ptHeap->atSets[i],
+                .dstBinding      = 1,
+                .descriptorCount = ptHeap->uTextureSlotCount,
+                .descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                .pImageInfo      = ptHeap->atTextureInfos
+            },
+            {
+                .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet          = ptHeap->atSets[i],
+                .dstBinding      = 2,
+                .descriptorCount = ptHeap->uBufferSlotCount,
+                .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .pBufferInfo     = ptHeap->atBufferInfos
+            }
+        };
+        vkUpdateDescriptorSets(ptVulkanDevice->tLogicalDevice, 2, atWrites, 0, NULL);
+        pl_sb_reset(ptHeap->asbuDirtyTextureSlots[i]);
+        pl_sb_reset(ptHeap->asbuDirtyBufferSlots[i]);
+    }
+}
+
+static double
+pl__get_wall_clock(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER tFrequency = {0};
+    if(tFrequency.QuadPart == 0)
+        QueryPerformanceFrequency(&tFrequency);
+    LARGE_INTEGER tCounter = {0};
+    QueryPerformanceCounter(&tCounter);
+    return (double)tCounter.QuadPart / (double)tFrequency.QuadPart;
+#else
+    struct timespec tTs = {0};
+    clock_gettime(CLOCK_MONOTONIC, &tTs);
+    return (double)tTs.tv_sec + (double)tTs.tv_nsec / 1000000000.0;
+#endif
+}
+
+static plFrameContext
+pl__create_frame_context(plVulkanDevice* ptVulkanDevice)
+{
+    const VkCommandPoolCreateInfo tFrameCommandPoolInfo = {
+        .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex = ptVulkanDevice->iGraphicsQueueFamily,
+        .flags            = 0
+    };
+    
+    const VkSemaphoreCreateInfo tSemaphoreInfo = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
+    };
+
+    const VkFenceCreateInfo tFenceInfo = {
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+        .flags = VK_FENCE_CREATE_SIGNALED_BIT
+    };
+
+    plFrameContext tFrame = {0};
+    PL_VULKAN(vkCreateSemaphore(ptVulkanDevice->tLogicalDevice, &tSemaphoreInfo, NULL, &tFrame.tImageAvailable));
+    PL_VULKAN(vkCreateSemaphore(ptVulkanDevice->tLogicalDevice, &tSemaphoreInfo, NULL, &tFrame.tRenderFinish));
+    PL_VULKAN(vkCreateFence(ptVulkanDevice->tLogicalDevice, &tFenceInfo, NULL, &tFrame.tInFlight));
+    PL_VULKAN(vkCreateCommandPool(ptVulkanDevice->tLogicalDevice, &tFrameCommandPoolInfo, NULL, &tFrame.tCmdPool));
+
+    const VkCommandBufferAllocateInfo tAllocInfo = {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool        = tFrame.tCmdPool,
+        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1
+    };
+
+    PL_VULKAN(vkAllocateCommandBuffers(ptVulkanDevice->tLogicalDevice, &tAllocInfo, &tFrame.tCmdBuf));
+    return tFrame;
+}
+
+static void
+pl__destroy_frame_context(plVulkanDevice* ptVulkanDevice, plFrameContext* ptFrame)
+{
+    vkDestroySemaphore(ptVulkanDevice->tLogicalDevice, ptFrame->tImageAvailable, NULL);
+    vkDestroySemaphore(ptVulkanDevice->tLogicalDevice, ptFrame->tRenderFinish, NULL);
+    vkDestroyFence(ptVulkanDevice->tLogicalDevice, ptFrame->tInFlight, NULL);
+    vkDestroyCommandPool(ptVulkanDevice->tLogicalDevice, ptFrame->tCmdPool, NULL);
+}
+
+static void
+pl__resize_frame_contexts(plGraphics* ptGraphics, uint32_t uFramesInFlight)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+
+    PL_ASSERT(uFramesInFlight > 0 && uFramesInFlight <= PL_VULKAN_MAX_FRAMES_IN_FLIGHT && "frames in flight out of range");
+
+    // rare, so just drain the queue instead of tracking partially retired contexts
+    PL_VULKAN(vkDeviceWaitIdle(ptVulkanDevice->tLogicalDevice));
+    ptVulkanDevice->ulCompletedFrame = ptVulkanDevice->ulFrameCount - 1;
+
+    const uint32_t uCurrentCount = pl_sb_size(ptVulkanGfx->sbFrames);
+    for(uint32_t i = uFramesInFlight; i < uCurrentCount; i++)
+        pl__destroy_frame_context(ptVulkanDevice, &ptVulkanGfx->sbFrames[i]);
+    if(uFramesInFlight < uCurrentCount)
+        pl_sb_resize(ptVulkanGfx->sbFrames, uFramesInFlight);
+    for(uint32_t i = uCurrentCount; i < uFramesInFlight; i++)
+        pl_sb_push(ptVulkanGfx->sbFrames, pl__create_frame_context(ptVulkanDevice));
+
+    ptVulkanGfx->uFramesInFlight = uFramesInFlight;
+    ptVulkanGfx->szCurrentFrameIndex = 0;
+
+    // fallback descriptor sets are per frame in flight too
+    pl__set_bindless_active_sets(ptVulkanDevice, uFramesInFlight);
+
+    // dynamic geometry has one region per frame in flight
+    pl__create_dynamic_buffer(ptGraphics, ptVulkanGfx->tDynamicBuffer.szFrameByteSize);
+
+    pl_log_info_to_f(uLogChannel, "frames in flight: %u", uFramesInFlight);
+}
+
+static plVulkanAttachment
+pl__create_attachment(plGraphics* ptGraphics, VkFormat tFormat, VkExtent2D tExtent, VkSampleCountFlagBits tSamples, VkImageUsageFlags tUsage, VkImageAspectFlags tAspect, const char* pcName)
+{
+    plVulkanDevice* ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+
+    plVulkanAttachment tAttachment = {0};
+
+    const VkImageCreateInfo tImageInfo = {
+        .sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType     = VK_IMAGE_TYPE_2D,
+        .extent        = 
+        {
+            .width  = tExtent.width,
+            .height = tExtent.height,
+            .depth  = 1
+        },
+        .mipLevels     = 1,
+        .arrayLayers   = 1,
+        .format        = tFormat,
+        .tiling        = VK_IMAGE_TILING_OPTIMAL,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .usage         = tUsage,
+        .sharingMode   = VK_SHARING_MODE_EXCLUSIVE,
+        .samples       = tSamples
+    };
+    PL_VULKAN(vkCreateImage(ptVulkanDevice->tLogicalDevice, &tImageInfo, NULL, &tAttachment.tImage));
+
+    VkMemoryRequirements tMemReqs = {0};
+    vkGetImageMemoryRequirements(ptVulkanDevice->tLogicalDevice, tAttachment.tImage, &tMemReqs);
+    tAttachment.tMemory = allocate_dedicated(&ptGraphics->tDevice, tMemReqs.memoryTypeBits, tMemReqs.size, tMemReqs.alignment, pcName);
+    tAttachment.szMemorySize = tMemReqs.size;
+    PL_VULKAN(vkBindImageMemory(ptVulkanDevice->tLogicalDevice, tAttachment.tImage, tAttachment.tMemory, 0));
+
+    const VkImageViewCreateInfo tViewInfo = {
+        .sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image                           = tAttachment.tImage,
+        .viewType                        = VK_IMAGE_VIEW_TYPE_2D,
+        .format                          = tFormat,
+        .subresourceRange.baseMipLevel   = 0,
+        .subresourceRange.levelCount     = 1,
+        .subresourceRange.baseArrayLayer = 0,
+        .subresourceRange.layerCount     = 1,
+        .subresourceRange.aspectMask     = tAspect,
+    };
+    PL_VULKAN(vkCreateImageView(ptVulkanDevice->tLogicalDevice, &tViewInfo, NULL, &tAttachment.tView));
+    return tAttachment;
+}
+
+static void
+pl__queue_attachment_deletion(plVulkanDevice* ptVulkanDevice, plVulkanAttachment* ptAttachment)
+{
+    if(ptAttachment->tImage == VK_NULL_HANDLE)
+        return;
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE_VIEW, .tImageView = ptAttachment->tView});
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE,      .tImage     = ptAttachment->tImage});
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_MEMORY,     .tMemory    = ptAttachment->tMemory, .szByteSize = ptAttachment->szMemorySize});
+    memset(ptAttachment, 0, sizeof(plVulkanAttachment));
+}
+
+static void
+pl__destroy_readback_buffer(plVulkanDevice* ptVulkanDevice, plVulkanReadback* ptReadback)
+{
+    if(ptReadback->tBuffer == VK_NULL_HANDLE)
+        return;
+
+    // copies recorded into it may still be in flight
+    vkUnmapMemory(ptVulkanDevice->tLogicalDevice, ptReadback->tMemory);
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_BUFFER, .tBuffer = ptReadback->tBuffer});
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_MEMORY, .tMemory = ptReadback->tMemory, .szByteSize = ptReadback->szSize});
+    ptReadback->tBuffer  = VK_NULL_HANDLE;
+    ptReadback->tMemory  = VK_NULL_HANDLE;
+    ptReadback->pMapping = NULL;
+    ptReadback->szSize   = 0;
+}
+
+static void
+pl__create_staging_ring(plVulkanDevice* ptVulkanDevice, VkDeviceSize szSize)
+{
+    plVulkanStagingRing* ptRing = &ptVulkanDevice->tStaging;
+
+    const VkBufferCreateInfo tBufferCreateInfo = {
+        .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size        = szSize,
+        .usage       = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+    };
+    PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &tBufferCreateInfo, NULL, &ptRing->tBuffer));
+
+    VkMemoryRequirements tMemReqs = {0};
+    vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptRing->tBuffer, &tMemReqs);
+
+    // the CPU only writes, prefer coherent (write combined) memory
+    uint32_t uMemoryType = UINT32_MAX;
+    const VkMemoryPropertyFlags atPreferredProperties[] = {
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+    };
+    for(uint32_t i = 0; i < 2 && uMemoryType == UINT32_MAX; i++)
+    {
+        for(uint32_t j = 0; j < ptVulkanDevice->tMemProps.memoryTypeCount; j++)
+        {
+            if((tMemReqs.memoryTypeBits & (1 << j)) && (ptVulkanDevice->tMemProps.memoryTypes[j].propertyFlags & atPreferredProperties[i]) == atPreferredProperties[i])
+            {
+                uMemoryType = j;
+                break;
+            }
+        }
+    }
+    PL_ASSERT(uMemoryType != UINT32_MAX && "no host visible memory for staging");
+    ptRing->bHostCoherent = (ptVulkanDevice->tMemProps.memoryTypes[uMemoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+    const VkMemoryAllocateInfo tAllocInfo = {
+        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize  = tMemReqs.size,
+        .memoryTypeIndex = uMemoryType
+    };
+    PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &tAllocInfo, NULL, &ptRing->tMemory));
+    PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, ptRing->tBuffer, ptRing->tMemory, 0));
+    PL_VULKAN(vkMapMemory(ptVulkanDevice->tLogicalDevice, ptRing->tMemory, 0, VK_WHOLE_SIZE, 0, (void**)&ptRing->pucMapping));
+    ptRing->szSize = szSize;
+    ptRing->szHead = 0;
+    ptRing->szUsed = 0;
+}
+
+static void
+pl__destroy_staging_ring(plVulkanDevice* ptVulkanDevice)
+{
+    plVulkanStagingRing* ptRing = &ptVulkanDevice->tStaging;
+
+    // only called once the queue is idle
+    if(ptRing->tCmdBuf)
+        vkFreeCommandBuffers(ptVulkanDevice->tLogicalDevice, ptVulkanDevice->tCmdPool, 1, &ptRing->tCmdBuf);
+    if(ptRing->tBuffer)
+    {
+        vkUnmapMemory(ptVulkanDevice->tLogicalDevice, ptRing->tMemory);
+        vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, ptRing->tBuffer, NULL);
+        vkFreeMemory(ptVulkanDevice->tLogicalDevice, ptRing->tMemory, NULL);
+    }
+    pl_sb_free(ptRing->sbtRegions);
+    memset(ptRing, 0, sizeof(plVulkanStagingRing));
+}
+
+static VkDeviceSize
+pl__stage_upload(plDevice* ptDevice, const void* pData, size_t szSize, VkDeviceSize szAlignment)
+{
+    plVulkanDevice*      ptVulkanDevice = ptDevice->_pInternalData;
+    plVulkanStagingRing* ptRing = &ptVulkanDevice->tStaging;
+
+    if(ptRing->tBuffer == VK_NULL_HANDLE)
+        pl__create_staging_ring(ptVulkanDevice, szSize > PL_VULKAN_STAGING_BUFFER_SIZE ? szSize : PL_VULKAN_STAGING_BUFFER_SIZE);
+
+    // batches retire in submission order
+    uint32_t uRetired = 0;
+    const uint32_t uRegionCount = pl_sb_size(ptRing->sbtRegions);
+    while(uRetired < uRegionCount && ptRing->sbtRegions[uRetired].ulFrame <= ptVulkanDevice->ulCompletedFrame)
+        ptRing->szUsed -= ptRing->sbtRegions[uRetired++].szByteSize;
+    if(uRetired > 0)
+    {
+        memmove(ptRing->sbtRegions, &ptRing->sbtRegions[uRetired], (uRegionCount - uRetired) * sizeof(plVulkanStagingRegion));
+        pl_sb_resize(ptRing->sbtRegions, uRegionCount - uRetired);
+    }
+
+    // offsets must be a multiple of the texel block size, so allocations
+    // never straddle the end of the ring
+    VkDeviceSize szOffset = (ptRing->szHead + szAlignment - 1) / szAlignment * szAlignment;
+    VkDeviceSize szPadding = szOffset - ptRing->szHead;
+    if(szOffset + szSize > ptRing->szSize)
+    {
+        szPadding = ptRing->szSize - ptRing->szHead;
+        szOffset = 0;
+    }
+
+    if(ptRing->szUsed + szPadding + szSize > ptRing->szSize)
+    {
+        // out of space, everything staged so far has to land first
+        pl__flush_uploads(ptVulkanDevice);
+        PL_VULKAN(vkQueueWaitIdle(ptVulkanDevice->tGraphicsQueue));
+        pl_sb_reset(ptRing->sbtRegions);
+        ptRing->szHead = 0;
+        ptRing->szUsed = 0;
+        szOffset = 0;
+        szPadding = 0;
+
+        if(szSize > ptRing->szSize)
+        {
+            VkDeviceSize szNewSize = ptRing->szSize * 2;
+            while(szNewSize < szSize)
+                szNewSize *= 2;
+            pl_log_warn_to_f(uLogChannel, "growing staging ring to %u bytes", (uint32_t)szNewSize);
+            pl__destroy_staging_ring(ptVulkanDevice);
+            pl__create_staging_ring(ptVulkanDevice, szNewSize);
+        }
+    }
+
+    if(pData)
+        memcpy(&ptRing->pucMapping[szOffset], pData, szSize);
+    ptRing->szHead = szOffset + szSize;
+    ptRing->szUsed += szPadding + szSize;
+    ptRing->szBatchSize += szPadding + szSize;
+    return szOffset;
+}
+
+static VkCommandBuffer
+pl__get_upload_cmd_buffer(plVulkanDevice* ptVulkanDevice)
+{
+    plVulkanStagingRing* ptRing = &ptVulkanDevice->tStaging;
+    if(ptRing->tCmdBuf)
+        return ptRing->tCmdBuf;
+
+    const VkCommandBufferAllocateInfo tAllocInfo = {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandPool        = ptVulkanDevice->tCmdPool,
+        .commandBufferCount = 1u,
+    };
+    PL_VULKAN(vkAllocateCommandBuffers(ptVulkanDevice->tLogicalDevice, &tAllocInfo, &ptRing->tCmdBuf));
+
+    const VkCommandBufferBeginInfo tBeginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+    PL_VULKAN(vkBeginCommandBuffer(ptRing->tCmdBuf, &tBeginInfo));
+    return ptRing->tCmdBuf;
+}
+
+static void
+pl__create_texture_image(plDevice* ptDevice, plVulkanTexture* ptTexture, uint32_t uWidth, uint32_t uHeight, uint32_t uMips, VkImageUsageFlags tUsage, const char* pcName)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+
+    const VkImageCreateInfo tImageInfo = {
+        .sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType     = VK_IMAGE_TYPE_2D,
+        .extent        = 
+        {
+            .width  = uWidth,
+            .height = uHeight,
+            .depth  = 1
+        },
+        .mipLevels     = uMips,
+        .arrayLayers   = 1,
+        .format        = ptTexture->tFormat,
+        .tiling        = VK_IMAGE_TILING_OPTIMAL,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .usage         = tUsage,
+        .sharingMode   = VK_SHARING_MODE_EXCLUSIVE,
+        .samples       = VK_SAMPLE_COUNT_1_BIT
+    };
+    PL_VULKAN(vkCreateImage(ptVulkanDevice->tLogicalDevice, &tImageInfo, NULL, &ptTexture->tImage));
+
+    VkMemoryRequirements tMemReqs = {0};
+    vkGetImageMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptTexture->tImage, &tMemReqs);
+    ptTexture->tMemory = allocate_dedicated(ptDevice, tMemReqs.memoryTypeBits, tMemReqs.size, tMemReqs.alignment, pcName);
+    ptTexture->szMemorySize = tMemReqs.size;
+    PL_VULKAN(vkBindImageMemory(ptVulkanDevice->tLogicalDevice, ptTexture->tImage, ptTexture->tMemory, 0));
+
+    const VkImageViewCreateInfo tViewInfo = {
+        .sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image                           = ptTexture->tImage,
+        .viewType                        = VK_IMAGE_VIEW_TYPE_2D,
+        .format                          = ptTexture->tFormat,
+        .subresourceRange.baseMipLevel   = 0,
+        .subresourceRange.levelCount     = uMips,
+        .subresourceRange.baseArrayLayer = 0,
+        .subresourceRange.layerCount     = 1,
+        .subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+    };
+    PL_VULKAN(vkCreateImageView(ptVulkanDevice->tLogicalDevice, &tViewInfo, NULL, &ptTexture->tView));
+}
+
+static void
+pl__flush_uploads(plVulkanDevice* ptVulkanDevice)
+{
+    plVulkanStagingRing* ptRing = &ptVulkanDevice->tStaging;
+    if(ptRing->tCmdBuf == VK_NULL_HANDLE)
+        return;
+
+    if(!ptRing->bHostCoherent)
+    {
+        const VkMappedMemoryRange tRange = {
+            .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+            .memory = ptRing->tMemory,
+            .offset = 0,
+            .size   = VK_WHOLE_SIZE
+        };
+        PL_VULKAN(vkFlushMappedMemoryRanges(ptVulkanDevice->tLogicalDevice, 1, &tRange));
+    }
+
+    // no fence, the fence of the next frame submitted to this queue also
+    // covers earlier submissions, so the batch retires with that frame
+    PL_VULKAN(vkEndCommandBuffer(ptRing->tCmdBuf));
+    const VkSubmitInfo tSubmitInfo = {
+        .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1u,
+        .pCommandBuffers    = &ptRing->tCmdBuf,
+    };
+    PL_VULKAN(vkQueueSubmit(ptVulkanDevice->tGraphicsQueue, 1, &tSubmitInfo, VK_NULL_HANDLE));
+
+    const plVulkanStagingRegion tRegion = {
+        .ulFrame    = ptVulkanDevice->ulFrameCount,
+        .szByteSize = ptRing->szBatchSize
+    };
+    pl_sb_push(ptRing->sbtRegions, tRegion);
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_COMMAND_BUFFER, .tCommandBuffer = ptRing->tCmdBuf});
+    ptRing->tCmdBuf = VK_NULL_HANDLE;
+    ptRing->szBatchSize = 0;
+}
+
+static uint32_t
+pl__get_texture_slot(plDevice* ptDevice, plVulkanTexture* ptTexture, const plTextureDesc* ptDesc)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+
+    const plTexture tTexture = {
+        .tDesc    = *ptDesc,
+        .pTexture = ptTexture
+    };
+
+    // reuse indices of destroyed textures
+    if(pl_sb_size(ptVulkanDevice->sbuFreeTextureIndices) > 0)
+    {
+        const uint32_t uTextureIndex = pl_sb_pop(ptVulkanDevice->sbuFreeTextureIndices);
+        ptDevice->sbtTextures[uTextureIndex] = tTexture;
+        return uTextureIndex;
+    }
+
+    pl_sb_push(ptDevice->sbtTextures, tTexture);
+    return pl_sb_size(ptDevice->sbtTextures) - 1;
+}
+
+static void
+pl__record_texture_upload(plDevice* ptDevice, uint32_t uTextureIndex, const void* pData, size_t szSize, VkImageLayout tOldLayout)
+{
+    plVulkanDevice*      ptVulkanDevice = ptDevice->_pInternalData;
+    const plTextureDesc* ptDesc = &ptDevice->sbtTextures[uTextureIndex].tDesc;
+    plVulkanTexture*     ptTexture = ptDevice->sbtTextures[uTextureIndex].pTexture;
+
+    const VkImageSubresourceRange tAllMips = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .levelCount = ptDesc->uMips,
+        .layerCount = 1
+    };
+
+    if(pData == NULL)
+    {
+        // contents are undefined until the first update
+        pl__transition_image_layout(pl__get_upload_cmd_buffer(ptVulkanDevice), ptTexture->tImage, tOldLayout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, tAllMips);
+        return;
+    }
+
+    // one copy per supplied mip, tightly packed
+    uint32_t uBlockWidth = 0;
+    uint32_t uBlockHeight = 0;
+    const uint32_t uBlockSize = pl__format_block_size(ptDesc->tFormat, &uBlockWidth, &uBlockHeight);
+    const uint32_t uSuppliedMips = ptTexture->bGenerateMips ? 1 : ptDesc->uMips;
+
+    VkBufferImageCopy atRegions[32] = {0};
+    VkDeviceSize szExpectedSize = 0;
+    for(uint32_t i = 0; i < uSuppliedMips; i++)
+    {
+        atRegions[i].bufferOffset = szExpectedSize;
+        atRegions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        atRegions[i].imageSubresource.mipLevel = i;
+        atRegions[i].imageSubresource.layerCount = 1;
+        atRegions[i].imageExtent = (VkExtent3D){pl_maxu(ptDesc->uWidth >> i, 1), pl_maxu(ptDesc->uHeight >> i, 1), 1};
+        szExpectedSize += pl__format_mip_size(ptDesc->tFormat, ptDesc->uWidth, ptDesc->uHeight, i);
+    }
+    PL_ASSERT(szSize == szExpectedSize && "texture data doesn't match the format's mip layout");
+
+    // staging may submit the open batch, so the command buffer is fetched after
+    const VkDeviceSize szStagingOffset = pl__stage_upload(ptDevice, pData, szSize, uBlockSize * 4);
+    for(uint32_t i = 0; i < uSuppliedMips; i++)
+        atRegions[i].bufferOffset += szStagingOffset;
+
+    VkCommandBuffer tCmdBuf = pl__get_upload_cmd_buffer(ptVulkanDevice);
+    pl__transition_image_layout(tCmdBuf, ptTexture->tImage, tOldLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, tAllMips);
+    vkCmdCopyBufferToImage(tCmdBuf, ptVulkanDevice->tStaging.tBuffer, ptTexture->tImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, uSuppliedMips, atRegions);
+
+    if(!ptTexture->bGenerateMips)
+    {
+        pl__transition_image_layout(tCmdBuf, ptTexture->tImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, tAllMips);
+        return;
+    }
+
+    // each mip is blitted from the previous one, which is then left as a
+    // transfer source
+    for(uint32_t i = 1; i < ptDesc->uMips; i++)
+    {
+        const VkImageSubresourceRange tSrcMip = {
+            .aspectMask   = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = i - 1,
+            .levelCount   = 1,
+            .layerCount   = 1
+        };
+        pl__transition_image_layout(tCmdBuf, ptTexture->tImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, tSrcMip);
+
+        const VkImageBlit tBlit = {
+            .srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, i - 1, 0, 1},
+            .srcOffsets     = {{0, 0, 0}, {(int32_t)pl_maxu(ptDesc->uWidth >> (i - 1), 1), (int32_t)pl_maxu(ptDesc->uHeight >> (i - 1), 1), 1}},
+            .dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1},
+            .dstOffsets     = {{0, 0, 0}, {(int32_t)pl_maxu(ptDesc->uWidth >> i, 1), (int32_t)pl_maxu(ptDesc->uHeight >> i, 1), 1}}
+        };
+        vkCmdBlitImage(tCmdBuf, ptTexture->tImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, ptTexture->tImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &tBlit, ptTexture->tMipFilter);
+    }
+
+    const VkImageSubresourceRange tSourceMips = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .levelCount = ptDesc->uMips - 1,
+        .layerCount = 1
+    };
+    const VkImageSubresourceRange tLastMip = {
+        .aspectMask   = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = ptDesc->uMips - 1,
+        .levelCount   = 1,
+        .layerCount   = 1
+    };
+    pl__transition_image_layout(tCmdBuf, ptTexture->tImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, tSourceMips);
+    pl__transition_image_layout(tCmdBuf, ptTexture->tImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, tLastMip);
+}
+
+static VkDeviceSize
+pl__get_streaming_budget(plVulkanDevice* ptVulkanDevice)
+{
+    if(ptVulkanDevice->szStreamingBudget > 0)
+        return ptVulkanDevice->szStreamingBudget;
+
+    const VkPhysicalDeviceMemoryProperties* ptMemProps = &ptVulkanDevice->tMemProps;
+
+    // without the budget extension we only know heap sizes, so stay conservative
+    if(!ptVulkanDevice->bMemoryBudgetExtPresent)
+    {
+        VkDeviceSize szLargestHeap = 0;
+        for(uint32_t i = 0; i < ptMemProps->memoryHeapCount; i++)
+        {
+            if(ptMemProps->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT && ptMemProps->memoryHeaps[i].size > szLargestHeap)
+                szLargestHeap = ptMemProps->memoryHeaps[i].size;
+        }
+        return szLargestHeap / 2;
+    }
+
+    // budget & usage cover every process, streaming may grow into part of what
+    // is free (or has to give back what is over)
+    vkGetPhysicalDeviceMemoryProperties2(ptVulkanDevice->tPhysicalDevice, &ptVulkanDevice->tMemProps2);
+    VkDeviceSize szHeapBudget = 0;
+    VkDeviceSize szHeapUsage = 0;
+    for(uint32_t i = 0; i < ptMemProps->memoryHeapCount; i++)
+    {
+        if(ptMemProps->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT && ptVulkanDevice->tMemBudgetInfo.heapBudget[i] > szHeapBudget)
+        {
+            szHeapBudget = ptVulkanDevice->tMemBudgetInfo.heapBudget[i];
+            szHeapUsage = ptVulkanDevice->tMemBudgetInfo.heapUsage[i];
+        }
+    }
+
+    if(szHeapUsage > szHeapBudget)
+    {
+        const VkDeviceSize szOver = szHeapUsage - szHeapBudget;
+        return ptVulkanDevice->szStreamingResident > szOver ? ptVulkanDevice->szStreamingResident - szOver : 0;
+    }
+    return ptVulkanDevice->szStreamingResident + (VkDeviceSize)((double)(szHeapBudget - szHeapUsage) * PL_VULKAN_STREAMING_BUDGET_FRACTION);
+}
+
+static bool
+pl__evict_streamed_textures(plDevice* ptDevice, VkDeviceSize szTargetResident, uint64_t ulRequestedBefore, uint32_t uExcludedTexture)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+
+    // least recently requested first, textures only shrink down to their target
+    while(ptVulkanDevice->szStreamingResident > szTargetResident)
+    {
+        uint32_t uVictim = UINT32_MAX;
+        uint64_t ulOldestRequest = ulRequestedBefore;
+        for(uint32_t i = 0; i < pl_sb_size(ptVulkanDevice->sbuStreamedTextures); i++)
+        {
+            const uint32_t uTextureIndex = ptVulkanDevice->sbuStreamedTextures[i];
+            const plVulkanTexture* ptTexture = ptDevice->sbtTextures[uTextureIndex].pTexture;
+            if(uTextureIndex != uExcludedTexture && ptTexture->uResidentMips > ptTexture->uTargetMips && ptTexture->ulLastRequest < ulOldestRequest)
+            {
+                uVictim = uTextureIndex;
+                ulOldestRequest = ptTexture->ulLastRequest;
+            }
+        }
+        if(uVictim == UINT32_MAX)
+            return false;
+
+        const plVulkanTexture* ptVictim = ptDevice->sbtTextures[uVictim].pTexture;
+        pl__set_texture_residency(ptDevice, uVictim, ptVictim->uTargetMips, NULL);
+    }
+    return true;
+}
+
+static void
+pl__update_texture_streaming(plDevice* ptDevice)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+
+    const uint32_t uStreamedCount = pl_sb_size(ptVulkanDevice->sbuStreamedTextures);
+    const VkDeviceSize szBudget = pl__get_streaming_budget(ptVulkanDevice);
+    ptVulkanDevice->szStreamingBudgetInUse = szBudget;
+
+    // requests made since the last update become this update's targets
+    VkDeviceSize szRequested = 0;
+    for(uint32_t i = 0; i < uStreamedCount; i++)
+    {
+        const uint32_t uTextureIndex = ptVulkanDevice->sbuStreamedTextures[i];
+        const plTextureDesc* ptDesc = &ptDevice->sbtTextures[uTextureIndex].tDesc;
+        plVulkanTexture* ptTexture = ptDevice->sbtTextures[uTextureIndex].pTexture;
+
+        ptTexture->uTargetMips = pl_maxu(ptTexture->uRequestedMips, ptTexture->uMinMips);
+        ptTexture->uRequestedMips = 0;
+        for(uint32_t j = 0; j < ptTexture->uTargetMips; j++)
+            szRequested += pl__format_mip_size(ptDesc->tFormat, ptDesc->uWidth, ptDesc->uHeight, ptDesc->uMips - j - 1);
+    }
+    ptVulkanDevice->szStreamingRequested = szRequested;
+
+    // the budget may have shrunk (other processes, set_texture_budget)
+    pl__evict_streamed_textures(ptDevice, szBudget, UINT64_MAX, UINT32_MAX);
+
+    // grow towards targets a few mips at a time, smallest mips first so
+    // textures sharpen progressively; the cursor rotates so every texture
+    // eventually gets upload bandwidth
+    VkDeviceSize szUploaded = 0;
+    uint32_t uVisited = 0;
+    for(; uVisited < uStreamedCount && szUploaded < PL_VULKAN_STREAMING_UPLOAD_SIZE; uVisited++)
+    {
+        const uint32_t uTextureIndex = ptVulkanDevice->sbuStreamedTextures[(ptVulkanDevice->uStreamingCursor + uVisited) % uStreamedCount];
+        const plTextureDesc* ptDesc = &ptDevice->sbtTextures[uTextureIndex].tDesc;
+        plVulkanTexture* ptTexture = ptDevice->sbtTextures[uTextureIndex].pTexture;
+        if(ptTexture->uResidentMips >= ptTexture->uTargetMips)
+            continue;
+
+        const void* apMipData[32] = {0};
+        VkDeviceSize szGrowth = 0;
+        uint32_t uNewMips = ptTexture->uResidentMips;
+        while(uNewMips < ptTexture->uTargetMips)
+        {
+            const uint32_t uMip = ptDesc->uMips - uNewMips - 1;
+            const size_t szMipSize = pl__format_mip_size(ptDesc->tFormat, ptDesc->uWidth, ptDesc->uHeight, uMip);
+
+            // one mip is always allowed so large mips still make progress
+            if(uNewMips > ptTexture->uResidentMips && szUploaded + szGrowth + szMipSize > PL_VULKAN_STREAMING_UPLOAD_SIZE)
+                break;
+
+            // make room from textures requested less recently than this one
+            const VkDeviceSize szNeeded = szGrowth + szMipSize;
+            if(ptVulkanDevice->szStreamingResident + szNeeded > szBudget)
+            {
+                if(szNeeded > szBudget || !pl__evict_streamed_textures(ptDevice, szBudget - szNeeded, ptTexture->ulLastRequest, uTextureIndex))
+                    break;
+            }
+
+            size_t szDataSize = 0;
+            const void* pData = ptTexture->tStreamFunc(ptTexture->pStreamUserData, uTextureIndex, uMip, &szDataSize);
+            if(pData == NULL) // still loading
+                break;
+            PL_ASSERT(szDataSize == szMipSize && "streamed mip doesn't match the format's mip layout");
+
+            apMipData[uMip] = pData;
+            szGrowth += szMipSize;
+            uNewMips++;
+        }
+
+        if(uNewMips > ptTexture->uResidentMips)
+        {
+            pl__set_texture_residency(ptDevice, uTextureIndex, uNewMips, apMipData);
+            szUploaded += szGrowth;
+        }
+    }
+    if(uStreamedCount > 0)
+        ptVulkanDevice->uStreamingCursor = (ptVulkanDevice->uStreamingCursor + uVisited) % uStreamedCount;
+}
+
+static void
+pl__set_texture_residency(plDevice* ptDevice, uint32_t uTextureIndex, uint32_t uResidentMips, const void** apMipData)
+{
+    plVulkanDevice*      ptVulkanDevice = ptDevice->_pInternalData;
+    const plTextureDesc* ptDesc = &ptDevice->sbtTextures[uTextureIndex].tDesc;
+    plVulkanTexture*     ptTexture = ptDevice->sbtTextures[uTextureIndex].pTexture;
+
+    // images only hold resident mips, so residency changes reallocate and
+    // copy the mips both images share
+    const plVulkanTexture tOldTexture = *ptTexture;
+    const uint32_t uOldMips = tOldTexture.uResidentMips;
+    const uint32_t uTopMip = ptDesc->uMips - uResidentMips;
+    const uint32_t uOldTopMip = ptDesc->uMips - uOldMips;
+
+    uint32_t uBlockWidth = 0;
+    uint32_t uBlockHeight = 0;
+    const VkDeviceSize szAlignment = pl__format_block_size(ptDesc->tFormat, &uBlockWidth, &uBlockHeight) * 4;
+
+    // new mips are staged as one allocation so a ring flush can't split them
+    const uint32_t uLoadedMips = uResidentMips > uOldMips ? uResidentMips - uOldMips : 0;
+    VkBufferImageCopy atRegions[32] = {0};
+    VkDeviceSize szStagingSize = 0;
+    for(uint32_t i = 0; i < uLoadedMips; i++)
+    {
+        const uint32_t uMip = uTopMip + i;
+        atRegions[i].bufferOffset = szStagingSize;
+        atRegions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        atRegions[i].imageSubresource.mipLevel = i;
+        atRegions[i].imageSubresource.layerCount = 1;
+        atRegions[i].imageExtent = (VkExtent3D){pl_maxu(ptDesc->uWidth >> uMip, 1), pl_maxu(ptDesc->uHeight >> uMip, 1), 1};
+        szStagingSize += (pl__format_mip_size(ptDesc->tFormat, ptDesc->uWidth, ptDesc->uHeight, uMip) + szAlignment - 1) / szAlignment * szAlignment;
+    }
+    if(uLoadedMips > 0)
+    {
+        const VkDeviceSize szStagingOffset = pl__stage_upload(ptDevice, NULL, szStagingSize, szAlignment);
+        for(uint32_t i = 0; i < uLoadedMips; i++)
+        {
+            memcpy(&ptVulkanDevice->tStaging.pucMapping[szStagingOffset + atRegions[i].bufferOffset], apMipData[uTopMip + i], pl__format_mip_size(ptDesc->tFormat, ptDesc->uWidth, ptDesc->uHeight, uTopMip + i));
+            atRegions[i].bufferOffset += szStagingOffset;
+        }
+    }
+
+    const VkImageUsageFlags tUsage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    pl__create_texture_image(ptDevice, ptTexture, pl_maxu(ptDesc->uWidth >> uTopMip, 1), pl_maxu(ptDesc->uHeight >> uTopMip, 1), uResidentMips, tUsage, ptDesc->pcName);
+
+    const VkImageSubresourceRange tNewMips = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .levelCount = uResidentMips,
+        .layerCount = 1
+    };
+    VkCommandBuffer tCmdBuf = pl__get_upload_cmd_buffer(ptVulkanDevice);
+    pl__transition_image_layout(tCmdBuf, ptTexture->tImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, tNewMips);
+    if(uLoadedMips > 0)
+        vkCmdCopyBufferToImage(tCmdBuf, ptVulkanDevice->tStaging.tBuffer, ptTexture->tImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, uLoadedMips, atRegions);
+
+    if(tOldTexture.tImage)
+    {
+        const uint32_t uSharedMips = pl_minu(uOldMips, uResidentMips);
+        VkImageCopy atCopies[32] = {0};
+        for(uint32_t i = 0; i < uSharedMips; i++)
+        {
+            const uint32_t uMip = ptDesc->uMips - uSharedMips + i;
+            atCopies[i].srcSubresource = (VkImageSubresourceLayers){VK_IMAGE_ASPECT_COLOR_BIT, uMip - uOldTopMip, 0, 1};
+            atCopies[i].dstSubresource = (VkImageSubresourceLayers){VK_IMAGE_ASPECT_COLOR_BIT, uMip - uTopMip, 0, 1};
+            atCopies[i].extent = (VkExtent3D){pl_maxu(ptDesc->uWidth >> uMip, 1), pl_maxu(ptDesc->uHeight >> uMip, 1), 1};
+        }
+
+        // the old image goes back to being sampleable, work recorded this
+        // frame may still use its slot
+        const VkImageSubresourceRange tOldMips = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .levelCount = uOldMips,
+            .layerCount = 1
+        };
+        pl__transition_image_layout(tCmdBuf, tOldTexture.tImage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, tOldMips);
+        vkCmdCopyImage(tCmdBuf, tOldTexture.tImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, ptTexture->tImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, uSharedMips, atCopies);
+        pl__transition_image_layout(tCmdBuf, tOldTexture.tImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, tOldMips);
+
+        // slots can't be rewritten while in flight frames use them, so the
+        // texture moves to a new one
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE_VIEW,   .tImageView = tOldTexture.tView});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE,        .tImage     = tOldTexture.tImage});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_MEMORY,       .tMemory    = tOldTexture.tMemory, .szByteSize = tOldTexture.szMemorySize});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_TEXTURE_SLOT, .uSlot      = tOldTexture.uBindlessSlot});
+        ptVulkanDevice->szStreamingResident -= tOldTexture.szMemorySize;
+    }
+
+    pl__transition_image_layout(tCmdBuf, ptTexture->tImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, tNewMips);
+    ptTexture->uBindlessSlot = pl__allocate_bindless_texture(ptVulkanDevice, ptTexture->tView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    ptTexture->uResidentMips = uResidentMips;
+    ptVulkanDevice->szStreamingResident += ptTexture->szMemorySize;
+}
+
+static char*
+pl__read_file_if_exists(const char* pcFile, size_t* pszSizeOut)
+{
+    // unlike read_file, a missing file is expected here
+    FILE* ptFile = fopen(pcFile, "rb");
+    if(ptFile == NULL)
+        return NULL;
+
+    fseek(ptFile, 0, SEEK_END);
+    const size_t szSize = (size_t)ftell(ptFile);
+    fseek(ptFile, 0, SEEK_SET);
+
+    char* pcData = PL_ALLOC(szSize + 1);
+    const bool bRead = fread(pcData, 1, szSize, ptFile) == szSize;
+    fclose(ptFile);
+    if(!bRead)
+    {
+        PL_FREE(pcData);
+        return NULL;
+    }
+    pcData[szSize] = 0; // sources double as strings
+    *pszSizeOut = szSize;
+    return pcData;
+}
+
+static VkShaderModule
+pl__create_shader_module(plVulkanDevice* ptVulkanDevice, const uint32_t* puCode, size_t szSize)
+{
+    const VkShaderModuleCreateInfo tModuleInfo = {
+        .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .codeSize = szSize,
+        .pCode    = puCode
+    };
+    VkShaderModule tModule = VK_NULL_HANDLE;
+    PL_VULKAN(vkCreateShaderModule(ptVulkanDevice->tLogicalDevice, &tModuleInfo, NULL, &tModule));
+    return tModule;
+}
+
+static void
+pl__load_shader_cache(plVulkanShaderLibrary* ptLibrary, const char* pcFile)
+{
+    size_t szDataSize = 0;
+    char*  pcData = pl__read_file_if_exists(pcFile, &szDataSize);
+    if(pcData == NULL)
+        return;
+
+    // header: magic, version & entry count
+    // entries: source hash, byte size & SPIR-V
+    uint32_t auHeader[3] = {0};
+    bool bValid = szDataSize >= sizeof(auHeader);
+    if(bValid)
+    {
+        memcpy(auHeader, pcData, sizeof(auHeader));
+        bValid = auHeader[0] == PL_VULKAN_SHADER_CACHE_MAGIC && auHeader[1] == PL_VULKAN_SHADER_CACHE_VERSION;
+    }
+
+    size_t szOffset = sizeof(auHeader);
+    for(uint32_t i = 0; bValid && i < auHeader[2]; i++)
+    {
+        uint64_t aulEntry[2] = {0};
+        if(szOffset + sizeof(aulEntry) > szDataSize)
+        {
+            bValid = false;
+            break;
+        }
+        memcpy(aulEntry, &pcData[szOffset], sizeof(aulEntry));
+        szOffset += sizeof(aulEntry);
+        if(szOffset + aulEntry[1] > szDataSize)
+        {
+            bValid = false;
+            break;
+        }
+
+        plVulkanShaderBlob tBlob = {
+            .ulSourceHash = aulEntry[0],
+            .szSize       = (size_t)aulEntry[1],
+            .puCode       = PL_ALLOC((size_t)aulEntry[1])
+        };
+        memcpy(tBlob.puCode, &pcData[szOffset], tBlob.szSize);
+        szOffset += tBlob.szSize;
+
+        pl_hm_insert(&ptLibrary->tCacheMap, tBlob.ulSourceHash, pl_sb_size(ptLibrary->sbtCache));
+        pl_sb_push(ptLibrary->sbtCache, tBlob);
+    }
+
+    if(bValid)
+        pl_log_info_to_f(uLogChannel, "loaded shader cache \"%s\" (%u shaders)", pcFile, pl_sb_size(ptLibrary->sbtCache));
+    else
+        pl_log_warn_to_f(uLogChannel, "ignoring invalid shader cache \"%s\"", pcFile);
+    PL_FREE(pcData);
+}
+
+static void
+pl__save_shader_cache(plVulkanShaderLibrary* ptLibrary, const char* pcFile)
+{
+    if(!ptLibrary->bCacheDirty)
+        return;
+
+    FILE* ptDataFile = fopen(pcFile, "wb");
+    if(ptDataFile == NULL)
+    {
+        pl_log_warn_to_f(uLogChannel, "failed to write shader cache \"%s\"", pcFile);
+        return;
+    }
+
+    // newest entries are kept when over the limit
+    const uint32_t uCount = pl_sb_size(ptLibrary->sbtCache);
+    const uint32_t uFirst = uCount > PL_VULKAN_SHADER_CACHE_MAX_ENTRIES ? uCount - PL_VULKAN_SHADER_CACHE_MAX_ENTRIES : 0;
+    const uint32_t auHeader[3] = { PL_VULKAN_SHADER_CACHE_MAGIC, PL_VULKAN_SHADER_CACHE_VERSION, uCount - uFirst };
+    fwrite(auHeader, sizeof(auHeader), 1, ptDataFile);
+    for(uint32_t i = uFirst; i < uCount; i++)
+    {
+        const plVulkanShaderBlob* ptBlob = &ptLibrary->sbtCache[i];
+        const uint64_t aulEntry[2] = { ptBlob->ulSourceHash, (uint64_t)ptBlob->szSize };
+        fwrite(aulEntry, sizeof(aulEntry), 1, ptDataFile);
+        fwrite(ptBlob->puCode, 1, ptBlob->szSize, ptDataFile);
+    }
+    fclose(ptDataFile);
+    ptLibrary->bCacheDirty = false;
+}
+
+static void
+pl__create_shader_library(plGraphics* ptGraphics)
+{
+    plVulkanGraphics*      ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*        ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanShaderLibrary* ptLibrary = &ptVulkanGfx->tShaders;
+
+    const plVulkanShader atShaders[PL_VULKAN_SHADER_COUNT] = {
+        [PL_VULKAN_SHADER_PRIMITIVE_VERT]        = { "primitive.vert",        VK_SHADER_STAGE_VERTEX_BIT },
+        [PL_VULKAN_SHADER_PRIMITIVE_FRAG]        = { "primitive.frag",        VK_SHADER_STAGE_FRAGMENT_BIT },
+        [PL_VULKAN_SHADER_DRAW_3D_VERT]          = { "draw_3d.vert",          VK_SHADER_STAGE_VERTEX_BIT,   __glsl_shader_vert_3d_spv,      sizeof(__glsl_shader_vert_3d_spv) },
+        [PL_VULKAN_SHADER_DRAW_3D_FRAG]          = { "draw_3d.frag",          VK_SHADER_STAGE_FRAGMENT_BIT, __glsl_shader_frag_3d_spv,      sizeof(__glsl_shader_frag_3d_spv) },
+        [PL_VULKAN_SHADER_DRAW_3D_LINE_VERT]     = { "draw_3d_line.vert",     VK_SHADER_STAGE_VERTEX_BIT,   __glsl_shader_vert_3d_line_spv, sizeof(__glsl_shader_vert_3d_line_spv) },
+        [PL_VULKAN_SHADER_CULL_COMP]             = { "cull.comp",             VK_SHADER_STAGE_COMPUTE_BIT },
+        [PL_VULKAN_SHADER_DEPTH_PYRAMID_COMP]    = { "depth_pyramid.comp",    VK_SHADER_STAGE_COMPUTE_BIT },
+        [PL_VULKAN_SHADER_DEPTH_PYRAMID_MS_COMP] = { "depth_pyramid_ms.comp", VK_SHADER_STAGE_COMPUTE_BIT },
+        [PL_VULKAN_SHADER_MESH_VERT]             = { "mesh.vert",             VK_SHADER_STAGE_VERTEX_BIT },
+        [PL_VULKAN_SHADER_MESH_FRAG]             = { "mesh.frag",             VK_SHADER_STAGE_FRAGMENT_BIT }
+    };
+    memcpy(ptLibrary->atShaders, atShaders, sizeof(atShaders));
+
+    // room is left for the file names
+    const char* pcDirectory = ptGraphics->pcShaderDirectory ? ptGraphics->pcShaderDirectory : PL_VULKAN_SHADER_DIRECTORY;
+    PL_ASSERT(strlen(pcDirectory) < PL_MAX_PATH_LENGTH - 64 && "shader directory path too long");
+    strncpy(ptLibrary->acDirectory, pcDirectory, PL_MAX_PATH_LENGTH - 64);
+
+    #ifdef PL_VULKAN_SHADERC
+        ptLibrary->tCompiler = shaderc_compiler_initialize();
+    #endif
+
+    pl__load_shader_cache(ptLibrary, PL_VULKAN_SHADER_CACHE_FILE);
+
+    for(uint32_t i = 0; i < PL_VULKAN_SHADER_COUNT; i++)
+    {
+        plVulkanShader* ptShader = &ptLibrary->atShaders[i];
+
+        // later changes are measured against this
+        char acPath[PL_MAX_PATH_LENGTH] = {0};
+        pl_sprintf(acPath, "%s%s", ptLibrary->acDirectory, ptShader->pcFile);
+        ptShader->ulSourceTime = gptFile->get_modified_time(acPath);
+
+        // while hot reloading, sources win over the build's SPIR-V (a cache hit
+        // unless they changed while the app was closed)
+        if(ptGraphics->bShaderHotReload && pl__build_shader_from_source(ptGraphics, i, NULL))
+            continue;
+
+        char acSpirvFile[PL_MAX_PATH_LENGTH] = {0};
+        pl_sprintf(acSpirvFile, "%s.spv", ptShader->pcFile);
+        size_t szSize = 0;
+        char*  pcCode = pl__read_file_if_exists(acSpirvFile, &szSize);
+        if(pcCode)
+        {
+            ptShader->tModule = pl__create_shader_module(ptVulkanDevice, (const uint32_t*)pcCode, szSize);
+            PL_FREE(pcCode);
+        }
+        else if(ptShader->puEmbeddedCode)
+            ptShader->tModule = pl__create_shader_module(ptVulkanDevice, ptShader->puEmbeddedCode, ptShader->szEmbeddedSize);
+        else
+        {
+            pl_log_error_to_f(uLogChannel, "shader \"%s\" not found", acSpirvFile);
+            PL_ASSERT(false && "shader not found");
+        }
+    }
+    ptLibrary->dLastPoll = pl__get_wall_clock();
+}
+
+static void
+pl__destroy_shader_library(plGraphics* ptGraphics)
+{
+    plVulkanGraphics*      ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*        ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanShaderLibrary* ptLibrary = &ptVulkanGfx->tShaders;
+
+    pl__save_shader_cache(ptLibrary, PL_VULKAN_SHADER_CACHE_FILE);
+
+    for(uint32_t i = 0; i < PL_VULKAN_SHADER_COUNT; i++)
+        vkDestroyShaderModule(ptVulkanDevice->tLogicalDevice, ptLibrary->atShaders[i].tModule, NULL);
+
+    for(uint32_t i = 0; i < pl_sb_size(ptLibrary->sbtCache); i++)
+        PL_FREE(ptLibrary->sbtCache[i].puCode);
+    pl_sb_free(ptLibrary->sbtCache);
+    pl_hm_free(&ptLibrary->tCacheMap);
+
+    #ifdef PL_VULKAN_SHADERC
+        shaderc_compiler_release(ptLibrary->tCompiler);
+    #endif
+}
+
+static bool
+pl__build_shader_from_source(plGraphics* ptGraphics, plVulkanShaderId tShader, VkShaderModule* ptOldModuleOut)
+{
+    plVulkanGraphics*      ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*        ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanShaderLibrary* ptLibrary = &ptVulkanGfx->tShaders;
+    plVulkanShader*        ptShader = &ptLibrary->atShaders[tShader];
+
+    char acPath[PL_MAX_PATH_LENGTH] = {0};
+    pl_sprintf(acPath, "%s%s", ptLibrary->acDirectory, ptShader->pcFile);
+
+    size_t szSourceSize = 0;
+    char*  pcSource = pl__read_file_if_exists(acPath, &szSourceSize);
+    if(pcSource == NULL)
+        return false;
+
+    // saved without changes, nothing to rebuild
+    const uint64_t ulSourceHash = pl_hm_hash(pcSource, szSourceSize, (uint64_t)ptShader->tStage);
+    if(ulSourceHash == ptShader->ulSourceHash)
+    {
+        PL_FREE(pcSource);
+        return false;
+    }
+
+    uint64_t ulBlobIndex = pl_hm_lookup(&ptLibrary->tCacheMap, ulSourceHash);
+    if(ulBlobIndex == UINT64_MAX)
+    {
+        plVulkanShaderBlob tBlob = { .ulSourceHash = ulSourceHash };
+        const double dStart = pl__get_wall_clock();
+        if(!pl__compile_glsl(ptLibrary, ptShader, acPath, pcSource, szSourceSize, &tBlob.puCode, &tBlob.szSize))
+        {
+            PL_FREE(pcSource);
+            return false;
+        }
+        pl_log_info_to_f(uLogChannel, "compiled \"%s\" in %0.1f ms", acPath, (pl__get_wall_clock() - dStart) * 1000.0);
+
+        ulBlobIndex = pl_sb_size(ptLibrary->sbtCache);
+        pl_hm_insert(&ptLibrary->tCacheMap, ulSourceHash, ulBlobIndex);
+        pl_sb_push(ptLibrary->sbtCache, tBlob);
+        ptLibrary->bCacheDirty = true;
+    }
+    PL_FREE(pcSource);
+
+    const plVulkanShaderBlob* ptBlob = &ptLibrary->sbtCache[ulBlobIndex];
+    if(ptOldModuleOut)
+        *ptOldModuleOut = ptShader->tModule;
+    ptShader->tModule = pl__create_shader_module(ptVulkanDevice, ptBlob->puCode, ptBlob->szSize);
+    ptShader->ulSourceHash = ulSourceHash;
+    return true;
+}
+
+static bool
+pl__compile_glsl(plVulkanShaderLibrary* ptLibrary, const plVulkanShader* ptShader, const char* pcPath, const char* pcSource, size_t szSourceSize, uint32_t** ppuCodeOut, size_t* pszSizeOut)
+{
+#ifdef PL_VULKAN_SHADERC
+    shaderc_shader_kind tKind = shaderc_glsl_vertex_shader;
+    if(ptShader->tStage == VK_SHADER_STAGE_FRAGMENT_BIT)
+        tKind = shaderc_glsl_fragment_shader;
+    else if(ptShader->tStage == VK_SHADER_STAGE_COMPUTE_BIT)
+        tKind = shaderc_glsl_compute_shader;
+
+    shaderc_compilation_result_t tResult = shaderc_compile_into_spv(ptLibrary->tCompiler, pcSource, szSourceSize, tKind, pcPath, "main", NULL);
+    const bool bSuccess = shaderc_result_get_compilation_status(tResult) == shaderc_compilation_status_success;
+    if(bSuccess)
+    {
+        *pszSizeOut = shaderc_result_get_length(tResult);
+        *ppuCodeOut = PL_ALLOC(*pszSizeOut);
+        memcpy(*ppuCodeOut, shaderc_result_get_bytes(tResult), *pszSizeOut);
+    }
+    else
+        pl_log_error_to_f(uLogChannel, "%s", shaderc_result_get_error_message(tResult));
+    shaderc_result_release(tResult);
+    return bSuccess;
+#else
+    (void)ptLibrary; (void)ptShader; (void)pcSource; (void)szSourceSize;
+
+    // paths are passed quoted, quotes inside them can't be escaped portably
+    if(strchr(pcPath, '"'))
+    {
+        pl_log_error_to_f(uLogChannel, "can't compile \"%s\", path contains a quote", pcPath);
+        return false;
+    }
+
+    // output goes to the temp directory, unique per process & compile so
+    // concurrent instances & stale files never mix
+    static uint32_t uCompileCount = 0;
+#ifdef _WIN32
+    const char* pcTempDirectory = getenv("TEMP");
+    const int iProcess = _getpid();
+#else
+    const char* pcTempDirectory = getenv("TMPDIR");
+    if(pcTempDirectory == NULL)
+        pcTempDirectory = "/tmp";
+    const int iProcess = (int)getpid();
+#endif
+    if(pcTempDirectory == NULL || strlen(pcTempDirectory) + 64 > PL_MAX_PATH_LENGTH)
+        pcTempDirectory = ".";
+    char acOutputFile[PL_MAX_PATH_LENGTH] = {0};
+    pl_sprintf(acOutputFile, "%s/pl_shader_%d_%u.spv", pcTempDirectory, iProcess, uCompileCount++);
+
+    // glslc picks the stage from the extension & prints its own errors
+    char acCommand[PL_MAX_PATH_LENGTH * 2 + 128] = {0};
+    pl_sprintf(acCommand, "\"%s\" \"%s\" -o \"%s\"", PL_VULKAN_GLSLC, pcPath, acOutputFile);
+#ifdef _WIN32
+    // cmd.exe strips the outer quotes of the whole line
+    char acShellCommand[sizeof(acCommand) + 2] = {0};
+    pl_sprintf(acShellCommand, "\"%s\"", acCommand);
+    const int iStatus = system(acShellCommand);
+    const int iExitCode = iStatus;
+#else
+    const int iStatus = system(acCommand);
+    const int iExitCode = iStatus != -1 && WIFEXITED(iStatus) ? WEXITSTATUS(iStatus) : -1;
+#endif
+    if(iStatus == -1 || iExitCode != 0)
+    {
+        if(iStatus == -1 || iExitCode == 127)
+            pl_log_error_to_f(uLogChannel, "failed to run %s for \"%s\"", PL_VULKAN_GLSLC, pcPath);
+        else
+            pl_log_error_to_f(uLogChannel, "failed to compile \"%s\" (%s exited with %d)", pcPath, PL_VULKAN_GLSLC, iExitCode);
+        remove(acOutputFile);
+        return false;
+    }
+
+    size_t szSize = 0;
+    char*  pcCode = pl__read_file_if_exists(acOutputFile, &szSize);
+    remove(acOutputFile);
+
+    // a successful exit without usable SPIR-V keeps the old shader too
+    if(pcCode == NULL || szSize < sizeof(uint32_t) || szSize % sizeof(uint32_t) != 0 || *(const uint32_t*)pcCode != PL_VULKAN_SPIRV_MAGIC)
+    {
+        pl_log_error_to_f(uLogChannel, "%s produced no valid SPIR-V for \"%s\"", PL_VULKAN_GLSLC, pcPath);
+        if(pcCode)
+            PL_FREE(pcCode);
+        return false;
+    }
+    *ppuCodeOut = (uint32_t*)pcCode;
+    *pszSizeOut = szSize;
+    return true;
+#endif
+}
+
+static void
+pl__rebuild_shader_pipelines(plGraphics* ptGraphics, uint32_t uChangedShaders)
+{
+    plVulkanGraphics*     ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*       ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanCulling*      ptCulling = &ptVulkanGfx->tCulling;
+    const plVulkanShader* atShaders = ptVulkanGfx->tShaders.atShaders;
+
+    // replaced pipelines may still be used by frames in flight
+
+    if(uChangedShaders & ((1u << PL_VULKAN_SHADER_PRIMITIVE_VERT) | (1u << PL_VULKAN_SHADER_PRIMITIVE_FRAG)))
+    {
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_PIPELINE, .tPipeline = ptVulkanGfx->g_pipeline});
+        pl__create_main_pipeline(ptGraphics);
+    }
+
+    // 3D drawlist pipelines are created on first use for each render pass
+    if(uChangedShaders & ((1u << PL_VULKAN_SHADER_DRAW_3D_VERT) | (1u << PL_VULKAN_SHADER_DRAW_3D_FRAG) | (1u << PL_VULKAN_SHADER_DRAW_3D_LINE_VERT)))
+    {
+        ptVulkanGfx->t3DVtxShdrStgInfo.module     = atShaders[PL_VULKAN_SHADER_DRAW_3D_VERT].tModule;
+        ptVulkanGfx->t3DPxlShdrStgInfo.module     = atShaders[PL_VULKAN_SHADER_DRAW_3D_FRAG].tModule;
+        ptVulkanGfx->t3DLineVtxShdrStgInfo.module = atShaders[PL_VULKAN_SHADER_DRAW_3D_LINE_VERT].tModule;
+        pl__invalidate_graph_pipelines(ptGraphics, VK_NULL_HANDLE);
+    }
+
+    if(uChangedShaders & ((1u << PL_VULKAN_SHADER_MESH_VERT) | (1u << PL_VULKAN_SHADER_MESH_FRAG)))
+        pl__invalidate_shader_variants(ptGraphics);
+
+    if(uChangedShaders & (1u << PL_VULKAN_SHADER_CULL_COMP))
+    {
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_PIPELINE, .tPipeline = ptCulling->tPipeline});
+        ptCulling->tPipeline = pl__create_compute_pipeline(ptVulkanGfx, ptVulkanDevice, ptCulling->tPipelineLayout, atShaders[PL_VULKAN_SHADER_CULL_COMP].tModule);
+    }
+
+    if(uChangedShaders & (1u << PL_VULKAN_SHADER_DEPTH_PYRAMID_COMP))
+    {
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_PIPELINE, .tPipeline = ptCulling->tPyramidPipeline});
+        ptCulling->tPyramidPipeline = pl__create_compute_pipeline(ptVulkanGfx, ptVulkanDevice, ptCulling->tPyramidPipelineLayout, atShaders[PL_VULKAN_SHADER_DEPTH_PYRAMID_COMP].tModule);
+    }
+
+    if(uChangedShaders & (1u << PL_VULKAN_SHADER_DEPTH_PYRAMID_MS_COMP))
+    {
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_PIPELINE, .tPipeline = ptCulling->tPyramidMSPipeline});
+        ptCulling->tPyramidMSPipeline = pl__create_compute_pipeline(ptVulkanGfx, ptVulkanDevice, ptCulling->tPyramidPipelineLayout, atShaders[PL_VULKAN_SHADER_DEPTH_PYRAMID_MS_COMP].tModule);
+    }
+}
+
+static void
+pl__create_main_pipeline(plGraphics* ptGraphics)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plIO*             ptIOCtx = pl_get_io();
+
+    //---------------------------------------------------------------------
+    // input assembler stage
+    //---------------------------------------------------------------------
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {0};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {0};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = 1u;
+    vertexInputInfo.vertexAttributeDescriptionCount = 2u;
+    vertexInputInfo.pVertexBindingDescriptions = ptVulkanGfx->g_bindingDescriptions;
+    vertexInputInfo.pVertexAttributeDescriptions = ptVulkanGfx->g_attributeDescriptions;
+
+    //---------------------------------------------------------------------
+    // vertex shader stage
+    //---------------------------------------------------------------------
+    VkPipelineShaderStageCreateInfo vertShaderStageInfo = {0};
+    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vertShaderStageInfo.module = ptVulkanGfx->tShaders.atShaders[PL_VULKAN_SHADER_PRIMITIVE_VERT].tModule;
+    vertShaderStageInfo.pName = "main";
+
+    //---------------------------------------------------------------------
+    // tesselation stage
+    //---------------------------------------------------------------------
+
+    //---------------------------------------------------------------------
+    // geometry shader stage
+    //---------------------------------------------------------------------
+
+    //---------------------------------------------------------------------
+    // rasterization stage
+    //---------------------------------------------------------------------
+
+    VkViewport viewport = {0};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = (float)ptIOCtx->afMainViewportSize[0];
+    viewport.height = (float)ptIOCtx->afMainViewportSize[1];
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+
+    VkRect2D scissor = {0};
+    scissor.extent.width = (unsigned)viewport.width;
+    scissor.extent.height = (unsigned)viewport.y;
+
+    VkPipelineViewportStateCreateInfo viewportState = {0};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.pViewports = &viewport;
+    viewportState.scissorCount = 1;
+    viewportState.pScissors = &scissor;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer = {0};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.depthBiasEnable = VK_FALSE;
+
+    //---------------------------------------------------------------------
+    // fragment shader stage
+    //---------------------------------------------------------------------
+    VkPipelineShaderStageCreateInfo fragShaderStageInfo = {0};
+    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    fragShaderStageInfo.module = ptVulkanGfx->tShaders.atShaders[PL_VULKAN_SHADER_PRIMITIVE_FRAG].tModule;
+    fragShaderStageInfo.pName = "main";
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil = {0};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_TRUE;
+    depthStencil.depthWriteEnable = VK_TRUE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.minDepthBounds = 0.0f; // Optional
+    depthStencil.maxDepthBounds = 1.0f; // Optional
+    depthStencil.stencilTestEnable = VK_FALSE;
+
+    //---------------------------------------------------------------------
+    // color blending stage
+    //---------------------------------------------------------------------
+    VkPipelineColorBlendAttachmentState colorBlendAttachment = {0};
+    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = VK_TRUE;
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending = {0};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.logicOpEnable = VK_FALSE;
+    colorBlending.logicOp = VK_LOGIC_OP_COPY;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+    colorBlending.blendConstants[0] = 0.0f;
+    colorBlending.blendConstants[1] = 0.0f;
+    colorBlending.blendConstants[2] = 0.0f;
+    colorBlending.blendConstants[3] = 0.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisampling2 = {0};
+    multisampling2.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling2.sampleShadingEnable = VK_FALSE;
+    multisampling2.rasterizationSamples = ptVulkanGfx->tSwapchain.tMsaaSamples;
+
+    //---------------------------------------------------------------------
+    // Create Pipeline
+    //---------------------------------------------------------------------
+    VkPipelineShaderStageCreateInfo shaderStages[] = {
+        vertShaderStageInfo,
+        fragShaderStageInfo
+    };
+
+
+    VkDynamicState dynamicStateEnables[3] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR, VK_DYNAMIC_STATE_DEPTH_BIAS };
+    VkPipelineDynamicStateCreateInfo dynamicState = {0};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 3;
+    dynamicState.pDynamicStates = dynamicStateEnables;
+    
+    VkGraphicsPipelineCreateInfo pipelineInfo = {0};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2u;
+    pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling2;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = ptVulkanGfx->g_pipelineLayout;
+    pipelineInfo.renderPass = ptVulkanGfx->tRenderPass;
+    pipelineInfo.subpass = 0;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+
+    PL_VULKAN(vkCreateGraphicsPipelines(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tPipelineCache, 1, &pipelineInfo, NULL, &ptVulkanGfx->g_pipeline));
+
+}
+
+static VkPipeline
+pl__create_compute_pipeline(plVulkanGraphics* ptVulkanGfx, plVulkanDevice* ptVulkanDevice, VkPipelineLayout tLayout, VkShaderModule tModule)
+{
+    const VkComputePipelineCreateInfo tPipelineInfo = {
+        .sType  = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .layout = tLayout,
+        .stage  = {
+            .sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage  = VK_SHADER_STAGE_COMPUTE_BIT,
+            .module = tModule,
+            .pName  = "main"
+        }
+    };
+    VkPipeline tPipeline = VK_NULL_HANDLE;
+    PL_VULKAN(vkCreateComputePipelines(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tPipelineCache, 1, &tPipelineInfo, NULL, &tPipeline));
+    return tPipeline;
+}
+
+static plGraphicsState
+pl__normalize_variant_state(plGraphicsState tState)
+{
+    // every format has positions, unused bits must not split variants
+    tState.ulVertexStreamMask |= PL_MESH_FORMAT_FLAG_HAS_POSITION;
+    tState._ulUnused = 0;
+    return tState;
+}
+
+static plGraphicsState
+pl__get_fallback_variant_state(plGraphicsState tState)
+{
+    // matches the position & color pipeline, only the vertex format is kept
+    plGraphicsState tFallbackState = {0};
+    tFallbackState.ulVertexStreamMask   = tState.ulVertexStreamMask;
+    tFallbackState.ulDepthMode          = PL_DEPTH_MODE_LESS_OR_EQUAL;
+    tFallbackState.ulDepthWriteEnabled  = 1;
+    tFallbackState.ulCullMode           = PL_CULL_MODE_NONE;
+    tFallbackState.ulBlendMode          = PL_BLEND_MODE_ALPHA;
+    tFallbackState.ulShaderTextureFlags = 0;
+    tFallbackState.ulStencilMode        = PL_STENCIL_MODE_ALWAYS;
+    tFallbackState.ulStencilOpFail      = PL_STENCIL_OP_KEEP;
+    tFallbackState.ulStencilOpDepthFail = PL_STENCIL_OP_KEEP;
+    tFallbackState.ulStencilOpPass      = PL_STENCIL_OP_KEEP;
+    return tFallbackState;
+}
+
+static VkPipeline
+pl__create_variant_pipeline(plGraphics* ptGraphics, plGraphicsState tState, VkRenderPass tRenderPass, VkSampleCountFlagBits tSampleCount)
+{
+    // called from the variant worker, render state comes from the job & shader
+    // modules are swapped only while the worker is idle
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~vertex input~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // positions come from binding 0, every other stream is packed into binding 1
+    // (see [SECTION] vertex layout of pl_graphics.inl) & locations follow the
+    // flag bits, streams the shader reads but the format lacks come from
+    // binding 2 (the zeroed default buffer with a stride of 0)
+    const bool bWideJoints = (tState.ulVertexStreamMask & PL_MESH_FORMAT_FLAG_JOINTS_16) != 0;
+    const VkFormat atStreamFormats[PL_MESH_FORMAT_STREAM_COUNT] = {
+        VK_FORMAT_R32G32B32_SFLOAT, // position
+        VK_FORMAT_R16G16_SNORM,     // normal (octahedral)
+        VK_FORMAT_R16G16_SNORM,     // tangent (octahedral)
+        VK_FORMAT_R16G16_SFLOAT,    // texcoord 0
+        VK_FORMAT_R16G16_SFLOAT,    // texcoord 1
+        VK_FORMAT_R8G8B8A8_UNORM,   // color 0
+        VK_FORMAT_R8G8B8A8_UNORM,   // color 1
+        bWideJoints ? VK_FORMAT_R16G16B16A16_UINT : VK_FORMAT_R8G8B8A8_UINT, // joints 0
+        bWideJoints ? VK_FORMAT_R16G16B16A16_UINT : VK_FORMAT_R8G8B8A8_UINT, // joints 1
+        VK_FORMAT_R8G8B8A8_UNORM,   // weights 0
+        VK_FORMAT_R8G8B8A8_UNORM    // weights 1
+    };
+    const uint64_t ulShaderStreams = PL_MESH_FORMAT_FLAG_HAS_POSITION | PL_MESH_FORMAT_FLAG_HAS_NORMAL | PL_MESH_FORMAT_FLAG_HAS_TEXCOORD_0 | PL_MESH_FORMAT_FLAG_HAS_COLOR_0;
+
+    VkVertexInputAttributeDescription atAttributes[PL_MESH_FORMAT_STREAM_COUNT] = {0};
+    uint32_t uAttributeCount = 0;
+    for(uint32_t i = 0; i < PL_MESH_FORMAT_STREAM_COUNT; i++)
+    {
+        const uint64_t ulStream = 1ull << i;
+        if((ulShaderStreams & ulStream) == 0)
+            continue;
+        const bool bPresent = (tState.ulVertexStreamMask & ulStream) != 0;
+        atAttributes[uAttributeCount++] = (VkVertexInputAttributeDescription){
+            .location = i,
+            .binding  = i == 0 ? 0 : (bPresent ? 1 : 2),
+            .format   = atStreamFormats[i],
+            .offset   = bPresent ? pl_get_vertex_attribute_offset(tState.ulVertexStreamMask, (plMeshFormatFlags)ulStream) : 0
+        };
+    }
+
+    const VkVertexInputBindingDescription atBindings[3] = {
+        { .binding = 0, .stride = sizeof(float) * 3, .inputRate = VK_VERTEX_INPUT_RATE_VERTEX },
+        { .binding = 1, .stride = pl_get_vertex_attribute_stride(tState.ulVertexStreamMask), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX },
+        { .binding = 2, .stride = 0, .inputRate = VK_VERTEX_INPUT_RATE_VERTEX }
+    };
+
+    const VkPipelineVertexInputStateCreateInfo tVertexInputInfo = {
+        .sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+        .vertexBindingDescriptionCount   = 3,
+        .pVertexBindingDescriptions      = atBindings,
+        .vertexAttributeDescriptionCount = uAttributeCount,
+        .pVertexAttributeDescriptions    = atAttributes
+    };
+
+    const VkPipelineInputAssemblyStateCreateInfo tInputAssembly = {
+        .sType    = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+        .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST
+    };
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~shaders~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // constant ids match mesh.vert & mesh.frag
+    const uint32_t auSpecializationData[4] = {
+        (uint32_t)tState.ulVertexStreamMask,
+        (uint32_t)tState.ulShaderTextureFlags,
+        ptVulkanDevice->tBindless.uTextureSlotCount,
+        ptVulkanDevice->tBindless.uBufferSlotCount
+    };
+    const VkSpecializationMapEntry atSpecializationEntries[4] = {
+        { .constantID = 0, .offset = 0,  .size = sizeof(uint32_t) },
+        { .constantID = 1, .offset = 4,  .size = sizeof(uint32_t) },
+        { .constantID = 2, .offset = 8,  .size = sizeof(uint32_t) },
+        { .constantID = 3, .offset = 12, .size = sizeof(uint32_t) }
+    };
+    const VkSpecializationInfo tSpecializationInfo = {
+        .mapEntryCount = 4,
+        .pMapEntries   = atSpecializationEntries,
+        .dataSize      = sizeof(auSpecializationData),
+        .pData         = auSpecializationData
+    };
+
+    const VkPipelineShaderStageCreateInfo atStages[2] = {
+        {
+            .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage               = VK_SHADER_STAGE_VERTEX_BIT,
+            .module              = ptVulkanGfx->tShaders.atShaders[PL_VULKAN_SHADER_MESH_VERT].tModule,
+            .pName               = "main",
+            .pSpecializationInfo = &tSpecializationInfo
+        },
+        {
+            .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage               = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .module              = ptVulkanGfx->tShaders.atShaders[PL_VULKAN_SHADER_MESH_FRAG].tModule,
+            .pName               = "main",
+            .pSpecializationInfo = &tSpecializationInfo
+        }
+    };
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~fixed function~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // viewport & scissor are dynamic
+    const VkPipelineViewportStateCreateInfo tViewportState = {
+        .sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .viewportCount = 1,
+        .scissorCount  = 1
+    };
+
+    // PL_CULL_MODE_* bits match VkCullModeFlagBits
+    const VkPipelineRasterizationStateCreateInfo tRasterizer = {
+        .sType       = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+        .polygonMode = VK_POLYGON_MODE_FILL,
+        .lineWidth   = 1.0f,
+        .cullMode    = (VkCullModeFlags)tState.ulCullMode,
+        .frontFace   = VK_FRONT_FACE_COUNTER_CLOCKWISE
+    };
+
+    const VkPipelineMultisampleStateCreateInfo tMultisampling = {
+        .sType                = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+        .rasterizationSamples = tSampleCount
+    };
+
+    // PL_DEPTH_MODE_*, PL_STENCIL_MODE_* & PL_STENCIL_OP_* follow VkCompareOp & VkStencilOp
+    const VkStencilOpState tStencilOps = {
+        .failOp      = (VkStencilOp)tState.ulStencilOpFail,
+        .passOp      = (VkStencilOp)tState.ulStencilOpPass,
+        .depthFailOp = (VkStencilOp)tState.ulStencilOpDepthFail,
+        .compareOp   = (VkCompareOp)tState.ulStencilMode,
+        .compareMask = (uint32_t)tState.ulStencilMask,
+        .writeMask   = (uint32_t)tState.ulStencilMask,
+        .reference   = (uint32_t)tState.ulStencilRef
+    };
+    const bool bStencil = tState.ulStencilMode != PL_STENCIL_MODE_ALWAYS || tState.ulStencilOpPass != PL_STENCIL_OP_KEEP || tState.ulStencilOpDepthFail != PL_STENCIL_OP_KEEP;
+    const VkPipelineDepthStencilStateCreateInfo tDepthStencil = {
+        .sType             = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+        .depthTestEnable   = VK_TRUE,
+        .depthWriteEnable  = tState.ulDepthWriteEnabled ? VK_TRUE : VK_FALSE,
+        .depthCompareOp    = (VkCompareOp)tState.ulDepthMode,
+        .stencilTestEnable = bStencil ? VK_TRUE : VK_FALSE,
+        .front             = tStencilOps,
+        .back              = tStencilOps,
+        .maxDepthBounds    = 1.0f
+    };
+
+    VkPipelineColorBlendAttachmentState tBlendAttachment = {
+        .colorWriteMask      = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
+        .blendEnable         = tState.ulBlendMode != PL_BLEND_MODE_NONE,
+        .colorBlendOp        = VK_BLEND_OP_ADD,
+        .alphaBlendOp        = VK_BLEND_OP_ADD,
+        .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+        .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO
+    };
+    switch(tState.ulBlendMode)
+    {
+        case PL_BLEND_MODE_ALPHA:
+            tBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+            tBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            break;
+        case PL_BLEND_MODE_ADDITIVE:
+            tBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+            tBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+            break;
+        case PL_BLEND_MODE_PREMULTIPLY:
+            tBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+            tBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            break;
+        case PL_BLEND_MODE_MULTIPLY:
+            tBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_DST_COLOR;
+            tBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+            break;
+        case PL_BLEND_MODE_CLIP_MASK: // color is untouched, alpha only where none was written
+            tBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+            tBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+            tBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA;
+            break;
+        default:
+            break;
+    }
+
+    const VkPipelineColorBlendStateCreateInfo tColorBlending = {
+        .sType           = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+        .logicOp         = VK_LOGIC_OP_COPY,
+        .attachmentCount = 1,
+        .pAttachments    = &tBlendAttachment
+    };
+
+    const VkDynamicState atDynamicStates[3] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR, VK_DYNAMIC_STATE_DEPTH_BIAS };
+    const VkPipelineDynamicStateCreateInfo tDynamicState = {
+        .sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .dynamicStateCount = 3,
+        .pDynamicStates    = atDynamicStates
+    };
+
+    const VkGraphicsPipelineCreateInfo tPipelineInfo = {
+        .sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .stageCount          = 2,
+        .pStages             = atStages,
+        .pVertexInputState   = &tVertexInputInfo,
+        .pInputAssemblyState = &tInputAssembly,
+        .pViewportState      = &tViewportState,
+        .pRasterizationState = &tRasterizer,
+        .pMultisampleState   = &tMultisampling,
+        .pDepthStencilState  = &tDepthStencil,
+        .pColorBlendState    = &tColorBlending,
+        .pDynamicState       = &tDynamicState,
+        .layout              = ptVulkanGfx->g_pipelineLayout,
+        .renderPass          = tRenderPass,
+        .subpass             = 0
+    };
+
+    // the pipeline cache is internally synchronized
+    VkPipeline tPipeline = VK_NULL_HANDLE;
+    if(vkCreateGraphicsPipelines(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tPipelineCache, 1, &tPipelineInfo, NULL, &tPipeline) != VK_SUCCESS)
+        return VK_NULL_HANDLE;
+    return tPipeline;
+}
+
+static void*
+pl__shader_variant_worker(void* pData)
+{
+    plGraphics*             ptGraphics = pData;
+    plVulkanGraphics*       ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanVariantManager* ptManager = &ptVulkanGfx->tVariants;
+
+    // no allocations or logging here, neither is thread safe (finished jobs
+    // have room reserved when queued)
+    gptThreads->lock_mutex(ptManager->ptMutex);
+    while(true)
+    {
+        while(!ptManager->bQuit && pl_sb_size(ptManager->sbtQueuedJobs) == 0)
+            gptThreads->wait_condition_variable(ptManager->ptWorkCondition, ptManager->ptMutex);
+        if(ptManager->bQuit)
+            break;
+
+        // newest first, most likely to be on screen
+        plVulkanVariantJob tJob = pl_sb_pop(ptManager->sbtQueuedJobs);
+        ptManager->bWorkerBusy = true;
+        gptThreads->unlock_mutex(ptManager->ptMutex);
+
+        tJob.tPipeline = pl__create_variant_pipeline(ptGraphics, tJob.tState, tJob.tRenderPass, tJob.tSampleCount);
+
+        gptThreads->lock_mutex(ptManager->ptMutex);
+        pl_sb_push(ptManager->sbtFinishedJobs, tJob);
+        ptManager->bWorkerBusy = false;
+        if(pl_sb_size(ptManager->sbtQueuedJobs) == 0)
+            gptThreads->wake_all_condition_variable(ptManager->ptIdleCondition);
+    }
+    gptThreads->unlock_mutex(ptManager->ptMutex);
+    return NULL;
+}
+
+static void
+pl__create_variant_manager(plGraphics* ptGraphics)
+{
+    plVulkanGraphics*       ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanVariantManager* ptManager = &ptVulkanGfx->tVariants;
+
+    pl_sb_push(ptManager->sbtVariants, (plVulkanShaderVariant){0}); // handle 0 -> position & color pipeline
+
+    if(gptThreads)
+    {
+        ptManager->ptMutex         = gptThreads->create_mutex();
+        ptManager->ptWorkCondition = gptThreads->create_condition_variable();
+        ptManager->ptIdleCondition = gptThreads->create_condition_variable();
+        ptManager->ptThread        = gptThreads->create_thread(pl__shader_variant_worker, ptGraphics);
+    }
+    if(ptManager->ptThread == NULL)
+        pl_log_warn_to_f(uLogChannel, "no shader variant worker, variants are compiled on request");
+}
+
+static void
+pl__destroy_variant_manager(plGraphics* ptGraphics)
+{
+    plVulkanGraphics*       ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*         ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanVariantManager* ptManager = &ptVulkanGfx->tVariants;
+
+    // queued jobs are dropped, the one in progress finishes first
+    if(ptManager->ptThread)
+    {
+        gptThreads->lock_mutex(ptManager->ptMutex);
+        ptManager->bQuit = true;
+        gptThreads->wake_all_condition_variable(ptManager->ptWorkCondition);
+        gptThreads->unlock_mutex(ptManager->ptMutex);
+        gptThreads->join_thread(ptManager->ptThread);
+    }
+    if(ptManager->ptMutex)
+    {
+        gptThreads->destroy_condition_variable(ptManager->ptWorkCondition);
+        gptThreads->destroy_condition_variable(ptManager->ptIdleCondition);
+        gptThreads->destroy_mutex(ptManager->ptMutex);
+    }
+
+    for(uint32_t i = 0; i < pl_sb_size(ptManager->sbtFinishedJobs); i++)
+        vkDestroyPipeline(ptVulkanDevice->tLogicalDevice, ptManager->sbtFinishedJobs[i].tPipeline, NULL);
+    for(uint32_t i = 1; i < pl_sb_size(ptManager->sbtVariants); i++)
+        vkDestroyPipeline(ptVulkanDevice->tLogicalDevice, ptManager->sbtVariants[i].tPipeline, NULL);
+
+    pl_sb_free(ptManager->sbtQueuedJobs);
+    pl_sb_free(ptManager->sbtFinishedJobs);
+    pl_sb_free(ptManager->sbtVariants);
+    pl_hm_free(&ptManager->tVariantMap);
+}
+
+static void
+pl__queue_variant_job(plGraphics* ptGraphics, uint32_t uVariant)
+{
+    plVulkanGraphics*       ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanVariantManager* ptManager = &ptVulkanGfx->tVariants;
+    plVulkanShaderVariant*  ptVariant = &ptManager->sbtVariants[uVariant];
+
+    // fallbacks are needed right away
+    if(ptManager->ptThread == NULL || ptVariant->uFallback == uVariant)
+    {
+        ptVariant->tPipeline = pl__create_variant_pipeline(ptGraphics, ptVariant->tState, ptVulkanGfx->tRenderPass, ptVulkanGfx->tSwapchain.tMsaaSamples);
+        if(ptVariant->tPipeline == VK_NULL_HANDLE)
+            pl_log_error_to_f(uLogChannel, "failed to create shader variant %u", uVariant);
+        return;
+    }
+
+    // the swapchain may be recreated while the job waits
+    const plVulkanVariantJob tJob = {
+        .uVariant     = uVariant,
+        .tState       = ptVariant->tState,
+        .tRenderPass  = ptVulkanGfx->tRenderPass,
+        .tSampleCount = ptVulkanGfx->tSwapchain.tMsaaSamples
+    };
+    gptThreads->lock_mutex(ptManager->ptMutex);
+    pl_sb_push(ptManager->sbtQueuedJobs, tJob);
+    pl_sb_reserve(ptManager->sbtFinishedJobs, pl_sb_size(ptManager->sbtFinishedJobs) + pl_sb_size(ptManager->sbtQueuedJobs) + 1);
+    gptThreads->wake_condition_variable(ptManager->ptWorkCondition);
+    gptThreads->unlock_mutex(ptManager->ptMutex);
+}
+
+static void
+pl__update_shader_variants(plGraphics* ptGraphics)
+{
+    plVulkanGraphics*       ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanVariantManager* ptManager = &ptVulkanGfx->tVariants;
+
+    if(ptManager->ptThread == NULL)
+        return;
+
+    // finished pipelines are only published between frames
+    gptThreads->lock_mutex(ptManager->ptMutex);
+    for(uint32_t i = 0; i < pl_sb_size(ptManager->sbtFinishedJobs); i++)
+    {
+        const plVulkanVariantJob* ptJob = &ptManager->sbtFinishedJobs[i];
+        ptManager->sbtVariants[ptJob->uVariant].tPipeline = ptJob->tPipeline;
+        if(ptJob->tPipeline == VK_NULL_HANDLE)
+            pl_log_error_to_f(uLogChannel, "failed to create shader variant %u, using its fallback", ptJob->uVariant);
+    }
+    pl_sb_reset(ptManager->sbtFinishedJobs);
+    const uint32_t uPendingCount = pl_sb_size(ptManager->sbtQueuedJobs) + (ptManager->bWorkerBusy ? 1 : 0);
+    gptThreads->unlock_mutex(ptManager->ptMutex);
+
+    if(ptVulkanGfx->pdShaderVariantsPending)
+        *ptVulkanGfx->pdShaderVariantsPending = (double)uPendingCount;
+}
+
+static void
+pl__invalidate_shader_variants(plGraphics* ptGraphics)
+{
+    plVulkanGraphics*       ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*         ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanVariantManager* ptManager = &ptVulkanGfx->tVariants;
+
+    // the worker may still be using the old modules
+    if(ptManager->ptThread)
+    {
+        gptThreads->lock_mutex(ptManager->ptMutex);
+        while(pl_sb_size(ptManager->sbtQueuedJobs) > 0 || ptManager->bWorkerBusy)
+            gptThreads->wait_condition_variable(ptManager->ptIdleCondition, ptManager->ptMutex);
+        gptThreads->unlock_mutex(ptManager->ptMutex);
+        pl__update_shader_variants(ptGraphics);
+    }
+
+    const uint32_t uVariantCount = pl_sb_size(ptManager->sbtVariants);
+    for(uint32_t i = 1; i < uVariantCount; i++)
+    {
+        plVulkanShaderVariant* ptVariant = &ptManager->sbtVariants[i];
+        if(ptVariant->tPipeline)
+            pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_PIPELINE, .tPipeline = ptVariant->tPipeline});
+        ptVariant->tPipeline = VK_NULL_HANDLE;
+    }
+
+    // fallbacks are rebuilt right away, everything else draws with them until recompiled
+    for(uint32_t i = 1; i < uVariantCount; i++)
+    {
+        if(ptManager->sbtVariants[i].uFallback == i)
+            pl__queue_variant_job(ptGraphics, i);
+    }
+    for(uint32_t i = 1; i < uVariantCount; i++)
+    {
+        if(ptManager->sbtVariants[i].uFallback != i)
+            pl__queue_variant_job(ptGraphics, i);
+    }
+}
+
+static uint32_t
+pl__find_shader_variant(plVulkanVariantManager* ptManager, plGraphicsState tState, uint64_t* pulHashOut)
+{
+    // colliding states are rehashed until the state or a free key turns up,
+    // variants are never removed so every probe sequence stays intact
+    uint64_t ulHash = pl_hm_hash(&tState.ulValue, sizeof(uint64_t), 0);
+    while(true)
+    {
+        const uint64_t ulVariant = pl_hm_lookup(&ptManager->tVariantMap, ulHash);
+        if(ulVariant == UINT64_MAX)
+            break;
+        if(ptManager->sbtVariants[ulVariant].tState.ulValue == tState.ulValue)
+            return (uint32_t)ulVariant;
+        ulHash = pl_hm_hash(&ulHash, sizeof(uint64_t), ulHash);
+    }
+    *pulHashOut = ulHash;
+    return 0;
+}
+
+static VkPipeline
+pl__get_variant_pipeline(plGraphics* ptGraphics, uint32_t uVariant)
+{
+    plVulkanGraphics*       ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanVariantManager* ptManager = &ptVulkanGfx->tVariants;
+
+    if(uVariant == 0 || uVariant >= pl_sb_size(ptManager->sbtVariants))
+        return ptVulkanGfx->g_pipeline;
+
+    const plVulkanShaderVariant* ptVariant = &ptManager->sbtVariants[uVariant];
+    if(ptVariant->tPipeline)
+        return ptVariant->tPipeline;
+    if(ptManager->sbtVariants[ptVariant->uFallback].tPipeline)
+        return ptManager->sbtVariants[ptVariant->uFallback].tPipeline;
+    return ptVulkanGfx->g_pipeline; // fallback failed to compile
+}
+
+static void
+pl__create_culling(plGraphics* ptGraphics)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanCulling*  ptCulling = &ptVulkanGfx->tCulling;
+    const VkDevice    tDevice = ptVulkanDevice->tLogicalDevice;
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~pool~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // cull sets are rewritten every frame, pyramid sets live as long as their
+    // render target (one per level)
+    const uint32_t uCullSetCount = PL_VULKAN_MAX_FRAMES_IN_FLIGHT * PL_VULKAN_MAX_CULL_PASSES;
+    const uint32_t uPyramidSetCount = 64 * PL_VULKAN_MAX_PYRAMID_LEVELS;
+    const VkDescriptorPoolSize atPoolSizes[] = {
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         uCullSetCount * 2 },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, uCullSetCount + uPyramidSetCount },
+        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          uPyramidSetCount }
+    };
+    const VkDescriptorPoolCreateInfo tPoolInfo = {
+        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
+        .maxSets       = uCullSetCount + uPyramidSetCount,
+        .poolSizeCount = 3,
+        .pPoolSizes    = atPoolSizes
+    };
+    PL_VULKAN(vkCreateDescriptorPool(tDevice, &tPoolInfo, NULL, &ptVulkanDevice->tComputePool));
+
+    // depth & pyramid levels are read with texelFetch
+    const VkSamplerCreateInfo tSamplerInfo = {
+        .sType        = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .magFilter    = VK_FILTER_NEAREST,
+        .minFilter    = VK_FILTER_NEAREST,
+        .mipmapMode   = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+        .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        .maxLod       = VK_LOD_CLAMP_NONE
+    };
+    PL_VULKAN(vkCreateSampler(tDevice, &tSamplerInfo, NULL, &ptCulling->tSampler));
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~culling~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    const VkDescriptorSetLayoutBinding atCullBindings[] = {
+        { .binding = 0, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         .descriptorCount = 1, .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT },
+        { .binding = 1, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         .descriptorCount = 1, .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT },
+        { .binding = 2, .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = 1, .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .pImmutableSamplers = &ptCulling->tSampler }
+    };
+    const VkDescriptorSetLayoutCreateInfo tCullSetLayoutInfo = {
+        .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount = 3,
+        .pBindings    = atCullBindings
+    };
+    PL_VULKAN(vkCreateDescriptorSetLayout(tDevice, &tCullSetLayoutInfo, NULL, &ptCulling->tSetLayout));
+
+    const VkPushConstantRange tCullConstantRange = {
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .size       = sizeof(plVulkanCullConstants)
+    };
+    const VkPipelineLayoutCreateInfo tCullLayoutInfo = {
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount         = 1,
+        .pSetLayouts            = &ptCulling->tSetLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges    = &tCullConstantRange
+    };
+    PL_VULKAN(vkCreatePipelineLayout(tDevice, &tCullLayoutInfo, NULL, &ptCulling->tPipelineLayout));
+    ptCulling->tPipeline = pl__create_compute_pipeline(ptVulkanGfx, ptVulkanDevice, ptCulling->tPipelineLayout, ptVulkanGfx->tShaders.atShaders[PL_VULKAN_SHADER_CULL_COMP].tModule);
+
+    VkDescriptorSetLayout atCullSetLayouts[PL_VULKAN_MAX_FRAMES_IN_FLIGHT * PL_VULKAN_MAX_CULL_PASSES];
+    for(uint32_t i = 0; i < uCullSetCount; i++)
+        atCullSetLayouts[i] = ptCulling->tSetLayout;
+    const VkDescriptorSetAllocateInfo tCullSetInfo = {
+        .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool     = ptVulkanDevice->tComputePool,
+        .descriptorSetCount = uCullSetCount,
+        .pSetLayouts        = atCullSetLayouts
+    };
+    PL_VULKAN(vkAllocateDescriptorSets(tDevice, &tCullSetInfo, &ptCulling->aatSets[0][0]));
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~depth pyramid~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    const VkDescriptorSetLayoutBinding atPyramidBindings[] = {
+        { .binding = 0, .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = 1, .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .pImmutableSamplers = &ptCulling->tSampler },
+        { .binding = 1, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          .descriptorCount = 1, .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT }
+    };
+    const VkDescriptorSetLayoutCreateInfo tPyramidSetLayoutInfo = {
+        .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount = 2,
+        .pBindings    = atPyramidBindings
+    };
+    PL_VULKAN(vkCreateDescriptorSetLayout(tDevice, &tPyramidSetLayoutInfo, NULL, &ptCulling->tPyramidSetLayout));
+
+    const VkPushConstantRange tPyramidConstantRange = {
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .size       = sizeof(plVulkanPyramidConstants)
+    };
+    const VkPipelineLayoutCreateInfo tPyramidLayoutInfo = {
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount         = 1,
+        .pSetLayouts            = &ptCulling->tPyramidSetLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges    = &tPyramidConstantRange
+    };
+    PL_VULKAN(vkCreatePipelineLayout(tDevice, &tPyramidLayoutInfo, NULL, &ptCulling->tPyramidPipelineLayout));
+    ptCulling->tPyramidPipeline   = pl__create_compute_pipeline(ptVulkanGfx, ptVulkanDevice, ptCulling->tPyramidPipelineLayout, ptVulkanGfx->tShaders.atShaders[PL_VULKAN_SHADER_DEPTH_PYRAMID_COMP].tModule);
+    ptCulling->tPyramidMSPipeline = pl__create_compute_pipeline(ptVulkanGfx, ptVulkanDevice, ptCulling->tPyramidPipelineLayout, ptVulkanGfx->tShaders.atShaders[PL_VULKAN_SHADER_DEPTH_PYRAMID_MS_COMP].tModule);
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~buffers~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    pl__create_cull_output(ptGraphics, PL_VULKAN_CULL_OUTPUT_SIZE);
+    ptCulling->szOutputOffset = 16; // header, uint 0 counts every survivor
+
+    const VkBufferCreateInfo tStatsBufferInfo = {
+        .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size        = sizeof(uint32_t) * PL_VULKAN_MAX_FRAMES_IN_FLIGHT,
+        .usage       = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+    };
+    PL_VULKAN(vkCreateBuffer(tDevice, &tStatsBufferInfo, NULL, &ptCulling->tStatsBuffer));
+
+    VkMemoryRequirements tMemReqs = {0};
+    vkGetBufferMemoryRequirements(tDevice, ptCulling->tStatsBuffer, &tMemReqs);
+    const uint32_t uMemoryType = pl__find_memory_type_(ptVulkanDevice->tMemProps, tMemReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+    ptCulling->bStatsHostCoherent = (ptVulkanDevice->tMemProps.memoryTypes[uMemoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+    const VkMemoryAllocateInfo tAllocInfo = {
+        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize  = tMemReqs.size,
+        .memoryTypeIndex = uMemoryType
+    };
+    PL_VULKAN(vkAllocateMemory(tDevice, &tAllocInfo, NULL, &ptCulling->tStatsMemory));
+    PL_VULKAN(vkBindBufferMemory(tDevice, ptCulling->tStatsBuffer, ptCulling->tStatsMemory, 0));
+    PL_VULKAN(vkMapMemory(tDevice, ptCulling->tStatsMemory, 0, VK_WHOLE_SIZE, 0, (void**)&ptCulling->puStatsMapping));
+
+    // survivor counts are only known on the GPU, without this every slot is drawn
+    if(ptVulkanDevice->bDrawIndirectCountExtPresent)
+        ptCulling->vkCmdDrawIndexedIndirectCount = (PFN_vkCmdDrawIndexedIndirectCountKHR)vkGetDeviceProcAddr(tDevice, "vkCmdDrawIndexedIndirectCountKHR");
+    if(!ptVulkanDevice->tDeviceFeatures.drawIndirectFirstInstance)
+        pl_log_warn_to_f(uLogChannel, "drawIndirectFirstInstance not supported, cull_areas disabled");
+}
+
+static void
+pl__destroy_culling(plGraphics* ptGraphics)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanCulling*  ptCulling = &ptVulkanGfx->tCulling;
+    const VkDevice    tDevice = ptVulkanDevice->tLogicalDevice;
+
+    vkUnmapMemory(tDevice, ptCulling->tStatsMemory);
+    vkDestroyBuffer(tDevice, ptCulling->tStatsBuffer, NULL);
+    vkFreeMemory(tDevice, ptCulling->tStatsMemory, NULL);
+    vkDestroyBuffer(tDevice, ptCulling->tOutputBuffer, NULL);
+    vkFreeMemory(tDevice, ptCulling->tOutputMemory, NULL);
+
+    vkDestroyPipeline(tDevice, ptCulling->tPipeline, NULL);
+    vkDestroyPipeline(tDevice, ptCulling->tPyramidPipeline, NULL);
+    vkDestroyPipeline(tDevice, ptCulling->tPyramidMSPipeline, NULL);
+    vkDestroyPipelineLayout(tDevice, ptCulling->tPipelineLayout, NULL);
+    vkDestroyPipelineLayout(tDevice, ptCulling->tPyramidPipelineLayout, NULL);
+    vkDestroyDescriptorSetLayout(tDevice, ptCulling->tSetLayout, NULL);
+    vkDestroyDescriptorSetLayout(tDevice, ptCulling->tPyramidSetLayout, NULL);
+    vkDestroySampler(tDevice, ptCulling->tSampler, NULL);
+    vkDestroyDescriptorPool(tDevice, ptVulkanDevice->tComputePool, NULL);
+    pl_sb_free(ptCulling->sbtRecords);
+}
+
+static void
+pl__create_cull_output(plGraphics* ptGraphics, VkDeviceSize szSize)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanCulling*  ptCulling = &ptVulkanGfx->tCulling;
+
+    // passes already recorded this frame keep drawing from the old buffer
+    if(ptCulling->tOutputBuffer)
+    {
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_BUFFER, .tBuffer = ptCulling->tOutputBuffer});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_MEMORY, .tMemory = ptCulling->tOutputMemory, .szByteSize = ptCulling->szOutputSize});
+    }
+
+    const VkBufferCreateInfo tBufferInfo = {
+        .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size        = szSize,
+        .usage       = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+    };
+    PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &tBufferInfo, NULL, &ptCulling->tOutputBuffer));
+
+    VkMemoryRequirements tMemReqs = {0};
+    vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptCulling->tOutputBuffer, &tMemReqs);
+    ptCulling->tOutputMemory = allocate_dedicated(&ptGraphics->tDevice, tMemReqs.memoryTypeBits, tMemReqs.size, tMemReqs.alignment, "cull output");
+    PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, ptCulling->tOutputBuffer, ptCulling->tOutputMemory, 0));
+    ptCulling->szOutputSize = tMemReqs.size;
+}
+
+static void
+pl__read_cull_stats(plGraphics* ptGraphics)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanCulling*  ptCulling = &ptVulkanGfx->tCulling;
+    const size_t      szFrameIndex = ptVulkanGfx->szCurrentFrameIndex;
+
+    // this context's fence was just waited on, so its copy has landed
+    if(ptCulling->abStatsPending[szFrameIndex])
+    {
+        if(!ptCulling->bStatsHostCoherent)
+        {
+            const VkMappedMemoryRange tRange = {
+                .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+                .memory = ptCulling->tStatsMemory,
+                .size   = VK_WHOLE_SIZE
+            };
+            PL_VULKAN(vkInvalidateMappedMemoryRanges(ptVulkanDevice->tLogicalDevice, 1, &tRange));
+        }
+        ptCulling->uVisibleDraws = ptCulling->puStatsMapping[szFrameIndex];
+    }
+    else
+        ptCulling->uVisibleDraws = 0;
+    ptCulling->uInputDraws = ptCulling->auInputDraws[szFrameIndex];
+
+    // per frame state, culled areas from the previous use of this context no
+    // longer match the frame count
+    ptCulling->abStatsPending[szFrameIndex] = false;
+    ptCulling->auInputDraws[szFrameIndex] = 0;
+    ptCulling->uPassCount = 0;
+    ptCulling->szOutputOffset = 16; // header, uint 0 counts every survivor
+    pl_sb_reset(ptCulling->sbtRecords);
+}
+
+static void
+pl__create_depth_pyramid(plGraphics* ptGraphics, plVulkanRenderTarget* ptTarget)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanCulling*  ptCulling = &ptVulkanGfx->tCulling;
+    const VkDevice    tDevice = ptVulkanDevice->tLogicalDevice;
+
+    // full size level 0 keeps multisampled depth resolves in one pass
+    uint32_t uLevels = 1;
+    while((pl_maxu(ptTarget->tExtent.width, ptTarget->tExtent.height) >> uLevels) > 0)
+        uLevels++;
+    ptTarget->uPyramidLevels = pl_minu(uLevels, PL_VULKAN_MAX_PYRAMID_LEVELS);
+
+    const VkImageCreateInfo tImageInfo = {
+        .sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType     = VK_IMAGE_TYPE_2D,
+        .extent        = {
+            .width  = ptTarget->tExtent.width,
+            .height = ptTarget->tExtent.height,
+            .depth  = 1
+        },
+        .mipLevels     = ptTarget->uPyramidLevels,
+        .arrayLayers   = 1,
+        .format        = VK_FORMAT_R32_SFLOAT,
+        .tiling        = VK_IMAGE_TILING_OPTIMAL,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .usage         = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        .sharingMode   = VK_SHARING_MODE_EXCLUSIVE,
+        .samples       = VK_SAMPLE_COUNT_1_BIT
+    };
+    PL_VULKAN(vkCreateImage(tDevice, &tImageInfo, NULL, &ptTarget->tPyramidImage));
+
+    VkMemoryRequirements tMemReqs = {0};
+    vkGetImageMemoryRequirements(tDevice, ptTarget->tPyramidImage, &tMemReqs);
+    ptTarget->tPyramidMemory = allocate_dedicated(&ptGraphics->tDevice, tMemReqs.memoryTypeBits, tMemReqs.size, tMemReqs.alignment, "depth pyramid");
+    ptTarget->szPyramidMemorySize = tMemReqs.size;
+    PL_VULKAN(vkBindImageMemory(tDevice, ptTarget->tPyramidImage, ptTarget->tPyramidMemory, 0));
+
+    VkImageViewCreateInfo tViewInfo = {
+        .sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image                           = ptTarget->tPyramidImage,
+        .viewType                        = VK_IMAGE_VIEW_TYPE_2D,
+        .format                          = VK_FORMAT_R32_SFLOAT,
+        .subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+        .subresourceRange.baseMipLevel   = 0,
+        .subresourceRange.levelCount     = ptTarget->uPyramidLevels,
+        .subresourceRange.baseArrayLayer = 0,
+        .subresourceRange.layerCount     = 1
+    };
+    PL_VULKAN(vkCreateImageView(tDevice, &tViewInfo, NULL, &ptTarget->tPyramidView));
+
+    tViewInfo.subresourceRange.levelCount = 1;
+    for(uint32_t i = 0; i < ptTarget->uPyramidLevels; i++)
+    {
+        tViewInfo.subresourceRange.baseMipLevel = i;
+        PL_VULKAN(vkCreateImageView(tDevice, &tViewInfo, NULL, &ptTarget->atPyramidLevelViews[i]));
+    }
+
+    // stencil can't be sampled alongside depth
+    const VkImageViewCreateInfo tDepthViewInfo = {
+        .sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image                           = ptTarget->tDepth.tImage,
+        .viewType                        = VK_IMAGE_VIEW_TYPE_2D,
+        .format                          = ptVulkanGfx->tSwapchain.tDepthFormat,
+        .subresourceRange.aspectMask     = VK_IMAGE_ASPECT_DEPTH_BIT,
+        .subresourceRange.baseMipLevel   = 0,
+        .subresourceRange.levelCount     = 1,
+        .subresourceRange.baseArrayLayer = 0,
+        .subresourceRange.layerCount     = 1
+    };
+    PL_VULKAN(vkCreateImageView(tDevice, &tDepthViewInfo, NULL, &ptTarget->tDepthSampledView));
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~descriptor sets~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    VkDescriptorSetLayout atSetLayouts[PL_VULKAN_MAX_PYRAMID_LEVELS];
+    for(uint32_t i = 0; i < ptTarget->uPyramidLevels; i++)
+        atSetLayouts[i] = ptCulling->tPyramidSetLayout;
+    const VkDescriptorSetAllocateInfo tSetInfo = {
+        .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool     = ptVulkanDevice->tComputePool,
+        .descriptorSetCount = ptTarget->uPyramidLevels,
+        .pSetLayouts        = atSetLayouts
+    };
+    PL_VULKAN(vkAllocateDescriptorSets(tDevice, &tSetInfo, ptTarget->atPyramidSets));
+
+    VkDescriptorImageInfo atImageInfos[PL_VULKAN_MAX_PYRAMID_LEVELS * 2];
+    VkWriteDescriptorSet  atWrites[PL_VULKAN_MAX_PYRAMID_LEVELS * 2];
+    for(uint32_t i = 0; i < ptTarget->uPyramidLevels; i++)
+    {
+        atImageInfos[i * 2] = i == 0 ?
+            (VkDescriptorImageInfo){.imageView = ptTarget->tDepthSampledView,          .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL} :
+            (VkDescriptorImageInfo){.imageView = ptTarget->atPyramidLevelViews[i - 1], .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+        atImageInfos[i * 2 + 1] = (VkDescriptorImageInfo){.imageView = ptTarget->atPyramidLevelViews[i], .imageLayout = VK_IMAGE_LAYOUT_GENERAL};
+
+        for(uint32_t j = 0; j < 2; j++)
+        {
+            atWrites[i * 2 + j] = (VkWriteDescriptorSet){
+                .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet          = ptTarget->atPyramidSets[i],
+                .dstBinding      = j,
+                .descriptorCount = 1,
+                .descriptorType  = j == 0 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                .pImageInfo      = &atImageInfos[i * 2 + j]
+            };
+        }
+    }
+    vkUpdateDescriptorSets(tDevice, ptTarget->uPyramidLevels * 2, atWrites, 0, NULL);
+}
+
+static void
+pl__queue_depth_pyramid_deletion(plVulkanDevice* ptVulkanDevice, plVulkanRenderTarget* ptTarget)
+{
+    if(ptTarget->tPyramidImage == VK_NULL_HANDLE)
+        return;
+    for(uint32_t i = 0; i < ptTarget->uPyramidLevels; i++)
+    {
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_DESCRIPTOR_SET, .tDescriptorSet = ptTarget->atPyramidSets[i]});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE_VIEW,     .tImageView     = ptTarget->atPyramidLevelViews[i]});
+    }
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE_VIEW, .tImageView = ptTarget->tPyramidView});
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE_VIEW, .tImageView = ptTarget->tDepthSampledView});
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE,      .tImage     = ptTarget->tPyramidImage});
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_MEMORY,     .tMemory    = ptTarget->tPyramidMemory, .szByteSize = ptTarget->szPyramidMemorySize});
+    ptTarget->tPyramidImage = VK_NULL_HANDLE;
+}
+
+static void
+pl__build_depth_pyramid(plGraphics* ptGraphics, plVulkanRenderTarget* ptTarget)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    const plVulkanCulling* ptCulling = &ptVulkanGfx->tCulling;
+    const VkCommandBuffer tCmdBuf = pl_get_frame_resources(ptGraphics)->tCmdBuf;
+
+    // depth writes are made visible by the render pass's external dependency
+    if(ptTarget->bPyramidBuilt)
+    {
+        // culling reads of the previous pyramid finish before it's overwritten
+        vkCmdPipelineBarrier(tCmdBuf, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, NULL, 0, NULL, 0, NULL);
+    }
+    else
+    {
+        const VkImageSubresourceRange tRange = {
+            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel   = 0,
+            .levelCount     = ptTarget->uPyramidLevels,
+            .baseArrayLayer = 0,
+            .layerCount     = 1
+        };
+        pl__transition_image_layout(tCmdBuf, ptTarget->tPyramidImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, tRange);
+    }
+
+    const VkMemoryBarrier tLevelBarrier = {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT
+    };
+
+    plVulkanPyramidConstants tConstants = {
+        .aiSourceSize = {(int32_t)ptTarget->tExtent.width, (int32_t)ptTarget->tExtent.height},
+        .iSampleCount = (int32_t)ptTarget->tSampleCount
+    };
+    for(uint32_t i = 0; i < ptTarget->uPyramidLevels; i++)
+    {
+        if(i < 2)
+            vkCmdBindPipeline(tCmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, i == 0 && ptTarget->tSampleCount > VK_SAMPLE_COUNT_1_BIT ? ptCulling->tPyramidMSPipeline : ptCulling->tPyramidPipeline);
+
+        tConstants.aiDestinationSize[0] = (int32_t)pl_maxu(ptTarget->tExtent.width >> i, 1);
+        tConstants.aiDestinationSize[1] = (int32_t)pl_maxu(ptTarget->tExtent.height >> i, 1);
+
+        vkCmdBindDescriptorSets(tCmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, ptCulling->tPyramidPipelineLayout, 0, 1, &ptTarget->atPyramidSets[i], 0, NULL);
+        vkCmdPushConstants(tCmdBuf, ptCulling->tPyramidPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(plVulkanPyramidConstants), &tConstants);
+        vkCmdDispatch(tCmdBuf,
+            ((uint32_t)tConstants.aiDestinationSize[0] + PL_VULKAN_PYRAMID_GROUP_SIZE - 1) / PL_VULKAN_PYRAMID_GROUP_SIZE,
+            ((uint32_t)tConstants.aiDestinationSize[1] + PL_VULKAN_PYRAMID_GROUP_SIZE - 1) / PL_VULKAN_PYRAMID_GROUP_SIZE, 1);
+
+        // next level (or next frame's culling) reads this one
+        vkCmdPipelineBarrier(tCmdBuf, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &tLevelBarrier, 0, NULL, 0, NULL);
+
+        tConstants.aiSourceSize[0] = tConstants.aiDestinationSize[0];
+        tConstants.aiSourceSize[1] = tConstants.aiDestinationSize[1];
+    }
+    ptTarget->bPyramidBuilt = true;
+
+    // depth was rendered with the view culled this frame, next frame's culls
+    // reproject into it
+    ptTarget->tPyramidViewProjection = ptTarget->tPendingViewProjection;
+    ptTarget->bPyramidView = ptTarget->bPendingView;
+    ptTarget->bPendingView = false;
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] public api implementation
+//-----------------------------------------------------------------------------
+
+static uint32_t
+pl__get_buffer_slot(plDevice* ptDevice, plVulkanBuffer* ptBuffer)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+
+    const plBuffer tBuffer = {
+        .pBuffer = ptBuffer
+    };
+
+    // reuse indices of destroyed buffers
+    if(pl_sb_size(ptVulkanDevice->sbuFreeBufferIndices) > 0)
+    {
+        const uint32_t uBufferIndex = pl_sb_pop(ptVulkanDevice->sbuFreeBufferIndices);
+        ptDevice->sbtBuffers[uBufferIndex] = tBuffer;
+        return uBufferIndex;
+    }
+
+    pl_sb_push(ptDevice->sbtBuffers, tBuffer);
+    return pl_sb_size(ptDevice->sbtBuffers) - 1;
+}
+
+static void
+pl_destroy_buffer(plDevice* ptDevice, uint32_t uBufferIndex)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+    plVulkanBuffer* ptBuffer = ptDevice->sbtBuffers[uBufferIndex].pBuffer;
+    PL_ASSERT(ptBuffer && "buffer already destroyed");
+
+    // in flight frames may still read the buffer
+    VkMemoryRequirements tMemReqs = {0};
+    vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptBuffer->tBuffer, &tMemReqs);
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_BUFFER, .tBuffer = ptBuffer->tBuffer});
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_MEMORY, .tMemory = ptBuffer->tMemory, .szByteSize = tMemReqs.size});
+    if(ptBuffer->uBindlessSlot > 0)
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_BUFFER_SLOT, .uSlot = ptBuffer->uBindlessSlot});
+
+    PL_FREE(ptBuffer);
+    ptDevice->sbtBuffers[uBufferIndex].pBuffer = NULL;
+    pl_sb_push(ptVulkanDevice->sbuFreeBufferIndices, uBufferIndex);
+}
+
+static uint32_t
+pl_create_index_buffer(plDevice* ptDevice, size_t szSize, const void* pData, const char* pcName)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+
+    plVulkanBuffer* ptBuffer = PL_ALLOC(sizeof(plVulkanBuffer));
+    memset(ptBuffer, 0, sizeof(plVulkanBuffer));
+    const uint32_t uBufferIndex = pl__get_buffer_slot(ptDevice, ptBuffer);
+
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingBufferDeviceMemory;
+
+    { // create staging buffer
+
+        VkBufferCreateInfo bufferInfo = {0};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = szSize;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &bufferInfo, NULL, &stagingBuffer));
+
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, stagingBuffer, &memRequirements);
+
+        VkMemoryAllocateInfo allocInfo = {0};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memRequirements.size;
+        allocInfo.memoryTypeIndex = find_memory_type(ptVulkanDevice->tMemProps, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &allocInfo, NULL, &stagingBufferDeviceMemory));
+        PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, stagingBuffer, stagingBufferDeviceMemory, 0));
+
+        void* mapping;
+        PL_VULKAN(vkMapMemory(ptVulkanDevice->tLogicalDevice, stagingBufferDeviceMemory, 0, bufferInfo.size, 0, &mapping));
+        memcpy(mapping, pData, bufferInfo.size);
+        vkUnmapMemory(ptVulkanDevice->tLogicalDevice, stagingBufferDeviceMemory);
+    }
+
+    { // create final buffer
+
+        VkBufferCreateInfo bufferInfo = {0};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = szSize;
+        bufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &bufferInfo, NULL, &ptBuffer->tBuffer));
+
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptBuffer->tBuffer, &memRequirements);
+
+        VkMemoryAllocateInfo allocInfo = {0};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memRequirements.size;
+        allocInfo.memoryTypeIndex = find_memory_type(ptVulkanDevice->tMemProps, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &allocInfo, NULL, &ptBuffer->tMemory));
+        PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, ptBuffer->tBuffer, ptBuffer->tMemory, 0));
+    }
+
+    // copy buffer
+    VkCommandBuffer tCommandBuffer = {0};
+    
+    const VkCommandBufferAllocateInfo tAllocInfo = {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandPool        = ptVulkanDevice->tCmdPool,
+        .commandBufferCount = 1u,
+    };
+    vkAllocateCommandBuffers(ptVulkanDevice->tLogicalDevice, &tAllocInfo, &tCommandBuffer);
+
+    const VkCommandBufferBeginInfo tBeginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+
+    vkBeginCommandBuffer(tCommandBuffer, &tBeginInfo);
+
+    VkBufferCopy copyRegion = {0};
+    copyRegion.size = szSize;
+    vkCmdCopyBuffer(tCommandBuffer, stagingBuffer, ptBuffer->tBuffer, 1, &copyRegion);
+
+    PL_VULKAN(vkEndCommandBuffer(tCommandBuffer));
+    const VkSubmitInfo tSubmitInfo = {
+        .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1u,
+        .pCommandBuffers    = &tCommandBuffer,
+    };
+
+    PL_VULKAN(vkQueueSubmit(ptVulkanDevice->tGraphicsQueue, 1, &tSubmitInfo, VK_NULL_HANDLE));
+    PL_VULKAN(vkDeviceWaitIdle(ptVulkanDevice->tLogicalDevice));
+    vkFreeCommandBuffers(ptVulkanDevice->tLogicalDevice, ptVulkanDevice->tCmdPool, 1, &tCommandBuffer);
+
+    vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, stagingBuffer, NULL);
+    vkFreeMemory(ptVulkanDevice->tLogicalDevice, stagingBufferDeviceMemory, NULL);
+    return uBufferIndex;
+}
+
+static uint32_t
+pl_create_vertex_buffer(plDevice* ptDevice, size_t szSize, size_t szStride, const void* pData, const char* pcName)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+
+    plVulkanBuffer* ptBuffer = PL_ALLOC(sizeof(plVulkanBuffer));
+    memset(ptBuffer, 0, sizeof(plVulkanBuffer));
+    const uint32_t uBufferIndex = pl__get_buffer_slot(ptDevice, ptBuffer);
+
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingBufferDeviceMemory;
+
+    { // create staging buffer
+
+        VkBufferCreateInfo bufferInfo = {0};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = szSize;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &bufferInfo, NULL, &stagingBuffer));
+
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, stagingBuffer, &memRequirements);
+
+        VkMemoryAllocateInfo allocInfo = {0};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memRequirements.size;
+        allocInfo.memoryTypeIndex = find_memory_type(ptVulkanDevice->tMemProps, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &allocInfo, NULL, &stagingBufferDeviceMemory));
+        PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, stagingBuffer, stagingBufferDeviceMemory, 0));
+
+        void* mapping;
+        PL_VULKAN(vkMapMemory(ptVulkanDevice->tLogicalDevice, stagingBufferDeviceMemory, 0, bufferInfo.size, 0, &mapping));
+        memcpy(mapping, pData, bufferInfo.size);
+        vkUnmapMemory(ptVulkanDevice->tLogicalDevice, stagingBufferDeviceMemory);
+    }
+
+    { // create final buffer
+
+        VkBufferCreateInfo bufferInfo = {0};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = szSize;
+        bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &bufferInfo, NULL, &ptBuffer->tBuffer));
+
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptBuffer->tBuffer, &memRequirements);
+
+        VkMemoryAllocateInfo allocInfo = {0};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memRequirements.size;
+        allocInfo.memoryTypeIndex = find_memory_type(ptVulkanDevice->tMemProps, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &allocInfo, NULL, &ptBuffer->tMemory));
+        PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, ptBuffer->tBuffer, ptBuffer->tMemory, 0));
+    }
+
+    // copy buffer
+    VkCommandBuffer tCommandBuffer = {0};
+    
+    const VkCommandBufferAllocateInfo tAllocInfo = {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandPool        = ptVulkanDevice->tCmdPool,
+        .commandBufferCount = 1u,
+    };
+    vkAllocateCommandBuffers(ptVulkanDevice->tLogicalDevice, &tAllocInfo, &tCommandBuffer);
+
+    const VkCommandBufferBeginInfo tBeginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+
+    vkBeginCommandBuffer(tCommandBuffer, &tBeginInfo);
+
+    VkBufferCopy copyRegion = {0};
+    copyRegion.size = szSize;
+    vkCmdCopyBuffer(tCommandBuffer, stagingBuffer, ptBuffer->tBuffer, 1, &copyRegion);
+
+    PL_VULKAN(vkEndCommandBuffer(tCommandBuffer));
+    const VkSubmitInfo tSubmitInfo = {
+        .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1u,
+        .pCommandBuffers    = &tCommandBuffer,
+    };
+
+    PL_VULKAN(vkQueueSubmit(ptVulkanDevice->tGraphicsQueue, 1, &tSubmitInfo, VK_NULL_HANDLE));
+    PL_VULKAN(vkDeviceWaitIdle(ptVulkanDevice->tLogicalDevice));
+    vkFreeCommandBuffers(ptVulkanDevice->tLogicalDevice, ptVulkanDevice->tCmdPool, 1, &tCommandBuffer);
+
+    vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, stagingBuffer, NULL);
+    vkFreeMemory(ptVulkanDevice->tLogicalDevice, stagingBufferDeviceMemory, NULL);
+    return uBufferIndex;
+}
+
+static uint32_t
+pl_create_storage_buffer(plDevice* ptDevice, size_t szSize, const void* pData, const char* pcName)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+
+    plVulkanBuffer* ptBuffer = PL_ALLOC(sizeof(plVulkanBuffer));
+    memset(ptBuffer, 0, sizeof(plVulkanBuffer));
+    const uint32_t uBufferIndex = pl__get_buffer_slot(ptDevice, ptBuffer);
+
+    const VkBufferCreateInfo tBufferInfo = {
+        .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size        = szSize,
+        .usage       = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+    };
+    PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &tBufferInfo, NULL, &ptBuffer->tBuffer));
+
+    VkMemoryRequirements tMemReqs = {0};
+    vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptBuffer->tBuffer, &tMemReqs);
+
+    const VkMemoryAllocateInfo tAllocInfo = {
+        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize  = tMemReqs.size,
+        .memoryTypeIndex = find_memory_type(ptVulkanDevice->tMemProps, tMemReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+    };
+    PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &tAllocInfo, NULL, &ptBuffer->tMemory));
+    PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, ptBuffer->tBuffer, ptBuffer->tMemory, 0));
+
+    if(pData)
+    {
+        void* pMapping = NULL;
+        PL_VULKAN(vkMapMemory(ptVulkanDevice->tLogicalDevice, ptBuffer->tMemory, 0, szSize, 0, &pMapping));
+        memcpy(pMapping, pData, szSize);
+        vkUnmapMemory(ptVulkanDevice->tLogicalDevice, ptBuffer->tMemory);
+    }
+
+    ptBuffer->uBindlessSlot = pl__allocate_bindless_buffer(ptVulkanDevice, ptBuffer->tBuffer, szSize);
+    return uBufferIndex;
+}
+
+static void
+pl_update_buffer(plDevice* ptDevice, uint32_t uBufferIndex, const void* pMirror, const plBufferRange* atRanges, uint32_t uRangeCount)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+    const plVulkanBuffer* ptBuffer = ptDevice->sbtBuffers[uBufferIndex].pBuffer;
+    PL_ASSERT(ptBuffer && "buffer was destroyed");
+    PL_ASSERT(pMirror);
+    if(uRangeCount == 0)
+        return;
+
+    // ranges are packed back to back into one staging allocation
+    VkDeviceSize szStagingSize = 0;
+    for(uint32_t i = 0; i < uRangeCount; i++)
+    {
+        PL_ASSERT(atRanges[i].szOffset % 4 == 0 && atRanges[i].szSize % 4 == 0 && "buffer ranges must be 4 byte aligned");
+        szStagingSize += atRanges[i].szSize;
+    }
+    const VkDeviceSize szStagingOffset = pl__stage_upload(ptDevice, NULL, szStagingSize, 4);
+    const unsigned char* pucMirror = pMirror;
+    VkDeviceSize szPacked = 0;
+    for(uint32_t i = 0; i < uRangeCount; i++)
+    {
+        memcpy(&ptVulkanDevice->tStaging.pucMapping[szStagingOffset + szPacked], &pucMirror[atRanges[i].szOffset], atRanges[i].szSize);
+        szPacked += atRanges[i].szSize;
+    }
+
+    // in flight frames reading the old contents are ordered before the copy
+    VkCommandBuffer tCmdBuf = pl__get_upload_cmd_buffer(ptVulkanDevice);
+    const VkBufferMemoryBarrier tWriteBarrier = {
+        .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask       = VK_ACCESS_SHADER_READ_BIT,
+        .dstAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer              = ptBuffer->tBuffer,
+        .offset              = 0,
+        .size                = VK_WHOLE_SIZE
+    };
+    vkCmdPipelineBarrier(tCmdBuf, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 1, &tWriteBarrier, 0, NULL);
+
+    VkBufferCopy atCopies[64];
+    szPacked = 0;
+    for(uint32_t i = 0; i < uRangeCount; i += 64)
+    {
+        const uint32_t uCopyCount = pl_minu(uRangeCount - i, 64);
+        for(uint32_t j = 0; j < uCopyCount; j++)
+        {
+            atCopies[j] = (VkBufferCopy){
+                .srcOffset = szStagingOffset + szPacked,
+                .dstOffset = atRanges[i + j].szOffset,
+                .size      = atRanges[i + j].szSize
+            };
+            szPacked += atRanges[i + j].szSize;
+        }
+        vkCmdCopyBuffer(tCmdBuf, ptVulkanDevice->tStaging.tBuffer, ptBuffer->tBuffer, uCopyCount, atCopies);
+    }
+
+    const VkBufferMemoryBarrier tReadBarrier = {
+        .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask       = VK_ACCESS_SHADER_READ_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer              = ptBuffer->tBuffer,
+        .offset              = 0,
+        .size                = VK_WHOLE_SIZE
+    };
+    vkCmdPipelineBarrier(tCmdBuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, NULL, 1, &tReadBarrier, 0, NULL);
+}
+
+static uint32_t
+pl_get_bindless_index(plDevice* ptDevice, uint32_t uBufferIndex)
+{
+    const plVulkanBuffer* ptBuffer = ptDevice->sbtBuffers[uBufferIndex].pBuffer;
+    PL_ASSERT(ptBuffer && "buffer was destroyed");
+    return ptBuffer->uBindlessSlot;
+}
+
+static bool
+pl_is_format_supported(plDevice* ptDevice, plFormat tFormat)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+
+    // block compressed formats report no features unless the device enabled
+    // textureCompressionBC/textureCompressionASTC_LDR
+    VkFormatProperties tFormatProps = {0};
+    vkGetPhysicalDeviceFormatProperties(ptVulkanDevice->tPhysicalDevice, pl__vulkan_format(tFormat), &tFormatProps);
+    return (tFormatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+}
+
+static uint32_t
+pl_create_texture(plDevice* ptDevice, const plTextureDesc* ptDesc, const void* pData, size_t szSize)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+
+    PL_ASSERT(ptDesc->uWidth > 0 && ptDesc->uHeight > 0);
+    PL_ASSERT(pl_is_format_supported(ptDevice, ptDesc->tFormat) && "format not supported, check is_format_supported first");
+
+    plVulkanTexture* ptTexture = PL_ALLOC(sizeof(plVulkanTexture));
+    memset(ptTexture, 0, sizeof(plVulkanTexture));
+    ptTexture->tFormat = pl__vulkan_format(ptDesc->tFormat);
+
+    uint32_t uBlockWidth = 0;
+    uint32_t uBlockHeight = 0;
+    pl__format_block_size(ptDesc->tFormat, &uBlockWidth, &uBlockHeight);
+
+    uint32_t uFullChain = 1;
+    for(uint32_t uExtent = pl_maxu(ptDesc->uWidth, ptDesc->uHeight); uExtent > 1; uExtent >>= 1)
+        uFullChain++;
+
+    plTextureDesc tDesc = *ptDesc;
+    tDesc.uMips = tDesc.uMips == 0 ? uFullChain : pl_minu(tDesc.uMips, uFullChain);
+
+    // compressed mips can't be blitted, so they come from the app
+    if(uBlockWidth == 1 && tDesc.uMips > 1)
+    {
+        VkFormatProperties tFormatProps = {0};
+        vkGetPhysicalDeviceFormatProperties(ptVulkanDevice->tPhysicalDevice, ptTexture->tFormat, &tFormatProps);
+        const VkFormatFeatureFlags tBlitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+        if((tFormatProps.optimalTilingFeatures & tBlitFeatures) == tBlitFeatures)
+        {
+            ptTexture->bGenerateMips = true;
+            ptTexture->tMipFilter = (tFormatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+        }
+        else
+        {
+            pl_log_warn_to_f(uLogChannel, "format %d can't be blitted, texture \"%s\" has no mips", (int)tDesc.tFormat, tDesc.pcName ? tDesc.pcName : "");
+            tDesc.uMips = 1;
+        }
+    }
+
+    const VkImageUsageFlags tUsage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | (ptTexture->bGenerateMips ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+    pl__create_texture_image(ptDevice, ptTexture, tDesc.uWidth, tDesc.uHeight, tDesc.uMips, tUsage, tDesc.pcName);
+
+    const uint32_t uTextureIndex = pl__get_texture_slot(ptDevice, ptTexture, &tDesc);
+    pl__record_texture_upload(ptDevice, uTextureIndex, pData, szSize, VK_IMAGE_LAYOUT_UNDEFINED);
+    ptTexture->uBindlessSlot = pl__allocate_bindless_texture(ptVulkanDevice, ptTexture->tView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    return uTextureIndex;
+}
+
+static void
+pl_update_texture(plDevice* ptDevice, uint32_t uTextureIndex, const void* pData, size_t szSize)
+{
+    const plVulkanTexture* ptTexture = ptDevice->sbtTextures[uTextureIndex].pTexture;
+    PL_ASSERT(ptTexture && "texture was destroyed");
+    PL_ASSERT(ptTexture->tStreamFunc == NULL && "streamed textures are updated through their stream function");
+    PL_ASSERT(pData);
+
+    // in flight frames sampling the old contents are ordered before the upload
+    pl__record_texture_upload(ptDevice, uTextureIndex, pData, szSize, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+static void
+pl_destroy_texture(plDevice* ptDevice, uint32_t uTextureIndex)
+{
+    plVulkanDevice*  ptVulkanDevice = ptDevice->_pInternalData;
+    plVulkanTexture* ptTexture = ptDevice->sbtTextures[uTextureIndex].pTexture;
+    PL_ASSERT(ptTexture && "texture already destroyed");
+
+    if(ptTexture->tStreamFunc)
+    {
+        for(uint32_t i = 0; i < pl_sb_size(ptVulkanDevice->sbuStreamedTextures); i++)
+        {
+            if(ptVulkanDevice->sbuStreamedTextures[i] == uTextureIndex)
+            {
+                pl_sb_del_swap(ptVulkanDevice->sbuStreamedTextures, i);
+                break;
+            }
+        }
+        ptVulkanDevice->szStreamingResident -= ptTexture->szMemorySize;
+    }
+
+    // in flight frames (and a pending upload) may still use the image,
+    // streamed textures have none until their tail is resident
+    if(ptTexture->tImage)
+    {
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE_VIEW,   .tImageView = ptTexture->tView});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_IMAGE,        .tImage     = ptTexture->tImage});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_MEMORY,       .tMemory    = ptTexture->tMemory, .szByteSize = ptTexture->szMemorySize});
+        pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_TEXTURE_SLOT, .uSlot      = ptTexture->uBindlessSlot});
+    }
+
+    PL_FREE(ptTexture);
+    ptDevice->sbtTextures[uTextureIndex].pTexture = NULL;
+    pl_sb_push(ptVulkanDevice->sbuFreeTextureIndices, uTextureIndex);
+}
+
+static uint32_t
+pl_get_texture_bindless_index(plDevice* ptDevice, uint32_t uTextureIndex)
+{
+    const plVulkanTexture* ptTexture = ptDevice->sbtTextures[uTextureIndex].pTexture;
+    PL_ASSERT(ptTexture && "texture was destroyed");
+    return ptTexture->uBindlessSlot;
+}
+
+static uint32_t
+pl_create_streamed_texture(plDevice* ptDevice, const plTextureDesc* ptDesc, plTextureStreamFunc tStreamFunc, void* pUserData)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+
+    PL_ASSERT(ptDesc->uWidth > 0 && ptDesc->uHeight > 0);
+    PL_ASSERT(tStreamFunc);
+    PL_ASSERT(pl_is_format_supported(ptDevice, ptDesc->tFormat) && "format not supported, check is_format_supported first");
+
+    plVulkanTexture* ptTexture = PL_ALLOC(sizeof(plVulkanTexture));
+    memset(ptTexture, 0, sizeof(plVulkanTexture));
+    ptTexture->tFormat = pl__vulkan_format(ptDesc->tFormat);
+    ptTexture->tStreamFunc = tStreamFunc;
+    ptTexture->pStreamUserData = pUserData;
+
+    const uint32_t uMaxExtent = pl_maxu(ptDesc->uWidth, ptDesc->uHeight);
+    uint32_t uFullChain = 1;
+    for(uint32_t uExtent = uMaxExtent; uExtent > 1; uExtent >>= 1)
+        uFullChain++;
+
+    plTextureDesc tDesc = *ptDesc;
+    tDesc.uMips = tDesc.uMips == 0 ? uFullChain : pl_minu(tDesc.uMips, uFullChain);
+
+    // small tail mips never leave memory so there is always something to sample
+    ptTexture->uMinMips = 1;
+    while(ptTexture->uMinMips < tDesc.uMips && (uMaxExtent >> (tDesc.uMips - ptTexture->uMinMips - 1)) <= PL_VULKAN_STREAMING_MIN_EXTENT)
+        ptTexture->uMinMips++;
+
+    // nothing is resident (bindless slot 0) until the tail is loaded
+    ptTexture->uRequestedMips = ptTexture->uMinMips;
+    ptTexture->ulLastRequest = ptVulkanDevice->ulFrameCount;
+
+    const uint32_t uTextureIndex = pl__get_texture_slot(ptDevice, ptTexture, &tDesc);
+    pl_sb_push(ptVulkanDevice->sbuStreamedTextures, uTextureIndex);
+    return uTextureIndex;
+}
+
+static void
+pl_request_texture_resolution(plDevice* ptDevice, uint32_t uTextureIndex, uint32_t uPixels)
+{
+    plVulkanDevice*      ptVulkanDevice = ptDevice->_pInternalData;
+    const plTextureDesc* ptDesc = &ptDevice->sbtTextures[uTextureIndex].tDesc;
+    plVulkanTexture*     ptTexture = ptDevice->sbtTextures[uTextureIndex].pTexture;
+    PL_ASSERT(ptTexture && "texture was destroyed");
+    PL_ASSERT(ptTexture->tStreamFunc && "not a streamed texture");
+
+    // most detailed mip still at least as large as the on screen extent
+    const uint32_t uMaxExtent = pl_maxu(ptDesc->uWidth, ptDesc->uHeight);
+    uint32_t uMip = 0;
+    while(uMip + 1 < ptDesc->uMips && (uMaxExtent >> (uMip + 1)) >= uPixels)
+        uMip++;
+
+    ptTexture->uRequestedMips = pl_maxu(ptTexture->uRequestedMips, ptDesc->uMips - uMip);
+    ptTexture->ulLastRequest = ptVulkanDevice->ulFrameCount;
+}
+
+static void
+pl_set_texture_budget(plDevice* ptDevice, size_t szBytes)
+{
+    plVulkanDevice* ptVulkanDevice = ptDevice->_pInternalData;
+    ptVulkanDevice->szStreamingBudget = szBytes;
+}
+
+static void
+pl_begin_recording(plGraphics* ptGraphics)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+
+    plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGraphics);
+
+    PL_ASSERT(ptVulkanGfx->uActiveRenderTarget == PL_RENDER_TARGET_NONE && "end_render_target not called");
+
+    // offscreen passes declared this frame run before the main pass
+    pl__execute_render_graph(ptGraphics);
+
+    // survivor total is read back once this frame's fence is waited on
+    plVulkanCulling* ptCulling = &ptVulkanGfx->tCulling;
+    if(ptCulling->uPassCount > 0)
+    {
+        const VkBufferCopy tStatsCopy = {
+            .srcOffset = 0,
+            .dstOffset = ptVulkanGfx->szCurrentFrameIndex * sizeof(uint32_t),
+            .size      = sizeof(uint32_t)
+        };
+        vkCmdCopyBuffer(ptCurrentFrame->tCmdBuf, ptCulling->tOutputBuffer, ptCulling->tStatsBuffer, 1, &tStatsCopy);
+
+        const VkMemoryBarrier tHostBarrier = {
+            .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_HOST_READ_BIT
+        };
+        vkCmdPipelineBarrier(ptCurrentFrame->tCmdBuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &tHostBarrier, 0, NULL, 0, NULL);
+        ptCulling->abStatsPending[ptVulkanGfx->szCurrentFrameIndex] = true;
+    }
+
+    VkRenderPassBeginInfo renderPassInfo = {0};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = ptVulkanGfx->tRenderPass;
+    renderPassInfo.framebuffer = ptVulkanGfx->tSwapchain.sbtFrameBuffers[ptVulkanGfx->tSwapchain.uCurrentImageIndex];
+    renderPassInfo.renderArea.extent = ptVulkanGfx->tSwapchain.tExtent;
+
+    VkClearValue clearValues[2];
+    clearValues[0].color.float32[0] = 0.0f;
+    clearValues[0].color.float32[1] = 0.0f;
+    clearValues[0].color.float32[2] = 0.0f;
+    clearValues[0].color.float32[3] = 1.0f;
+    clearValues[1].depthStencil.depth = 0.0f;
+    renderPassInfo.clearValueCount = 2;
+    renderPassInfo.pClearValues = clearValues;
+
+    VkRect2D scissor = {0};
+    scissor.extent = ptVulkanGfx->tSwapchain.tExtent;
+
+    VkViewport tViewport = {0};
+    tViewport.x = 0.0f;
+    tViewport.y = 0.0f;
+    tViewport.width = (float)ptVulkanGfx->tSwapchain.tExtent.width;
+    tViewport.height = (float)ptVulkanGfx->tSwapchain.tExtent.height;
+
+    vkCmdSetViewport(ptCurrentFrame->tCmdBuf, 0, 1, &tViewport);
+    vkCmdSetScissor(ptCurrentFrame->tCmdBuf, 0, 1, &scissor);  
+
+    vkCmdBeginRenderPass(ptCurrentFrame->tCmdBuf, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    ptVulkanGfx->bInMainPass = true;
+
+    pl_new_draw_frame_vulkan();
+
+}
+
+static void
+pl_end_recording(plGraphics* ptGraphics)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+
+    plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGraphics);
+
+    vkCmdEndRenderPass(ptCurrentFrame->tCmdBuf);
+    ptVulkanGfx->bInMainPass = false;
+
+    PL_VULKAN(vkEndCommandBuffer(ptCurrentFrame->tCmdBuf));
+}
+
+static void
+pl_set_frames_in_flight(plGraphics* ptGraphics, uint32_t uFramesInFlight)
+{
+    PL_ASSERT(uFramesInFlight > 0 && uFramesInFlight <= PL_VULKAN_MAX_FRAMES_IN_FLIGHT && "frames in flight out of range");
+    ptGraphics->uFramesInFlight = pl_maxu(1, pl_minu(uFramesInFlight, PL_VULKAN_MAX_FRAMES_IN_FLIGHT));
+}
+
+static void
+pl_set_low_latency(plGraphics* ptGraphics, bool bLowLatency)
+{
+    ptGraphics->bLowLatency = bLowLatency;
+}
+
+static void
+pl_set_swapchain(plGraphics* ptGraphics, const plSwapchainDesc* ptDesc)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    ptGraphics->tSwapchainDesc = *ptDesc;
+    ptVulkanGfx->bSwapchainDirty = true;
+}
+
+static uint32_t
+pl_reload_shaders(plGraphics* ptGraphics)
+{
+    plVulkanGraphics*      ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*        ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanShaderLibrary* ptLibrary = &ptVulkanGfx->tShaders;
+
+    uint32_t       uChangedShaders = 0;
+    uint32_t       uRebuiltCount = 0;
+    VkShaderModule atOldModules[PL_VULKAN_SHADER_COUNT] = {0};
+    for(uint32_t i = 0; i < PL_VULKAN_SHADER_COUNT; i++)
+    {
+        plVulkanShader* ptShader = &ptLibrary->atShaders[i];
+
+        // the timestamp only gates the read, the source hash decides the rebuild
+        char acPath[PL_MAX_PATH_LENGTH] = {0};
+        pl_sprintf(acPath, "%s%s", ptLibrary->acDirectory, ptShader->pcFile);
+        const uint64_t ulSourceTime = gptFile->get_modified_time(acPath);
+        if(ulSourceTime == 0 || ulSourceTime == ptShader->ulSourceTime)
+            continue;
+        ptShader->ulSourceTime = ulSourceTime;
+
+        // on failure the previous module stays in use
+        if(pl__build_shader_from_source(ptGraphics, i, &atOldModules[i]))
+        {
+            pl_log_info_to_f(uLogChannel, "reloaded shader \"%s\"", acPath);
+            uChangedShaders |= 1u << i;
+            uRebuiltCount++;
+        }
+    }
+
+    if(uChangedShaders)
+    {
+        pl__rebuild_shader_pipelines(ptGraphics, uChangedShaders);
+
+        // modules are only needed while creating pipelines
+        for(uint32_t i = 0; i < PL_VULKAN_SHADER_COUNT; i++)
+        {
+            if(atOldModules[i])
+                vkDestroyShaderModule(ptVulkanDevice->tLogicalDevice, atOldModules[i], NULL);
+        }
+    }
+    ptLibrary->dLastPoll = pl__get_wall_clock();
+    return uRebuiltCount;
+}
+
+static uint32_t
+pl_request_shader_variant(plGraphics* ptGraphics, plGraphicsState tState)
+{
+    plVulkanGraphics*       ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanVariantManager* ptManager = &ptVulkanGfx->tVariants;
+
+    tState = pl__normalize_variant_state(tState);
+    uint64_t ulHash = 0;
+    const uint32_t uExistingVariant = pl__find_shader_variant(ptManager, tState, &ulHash);
+    if(uExistingVariant != 0)
+        return uExistingVariant;
+
+    // one fallback per vertex format, shared by every state using it (may
+    // take the free key found above)
+    uint32_t uFallback = 0;
+    const plGraphicsState tFallbackState = pl__get_fallback_variant_state(tState);
+    if(tFallbackState.ulValue != tState.ulValue)
+    {
+        uFallback = pl_request_shader_variant(ptGraphics, tFallbackState);
+        pl__find_shader_variant(ptManager, tState, &ulHash);
+    }
+
+    const uint32_t uVariant = pl_sb_size(ptManager->sbtVariants);
+    const plVulkanShaderVariant tVariant = {
+        .tState    = tState,
+        .uFallback = uFallback ? uFallback : uVariant
+    };
+    pl_sb_push(ptManager->sbtVariants, tVariant);
+    pl_hm_insert(&ptManager->tVariantMap, ulHash, uVariant);
+    pl__queue_variant_job(ptGraphics, uVariant);
+    return uVariant;
+}
+
+static bool
+pl_is_shader_variant_ready(plGraphics* ptGraphics, uint32_t uVariant)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    if(uVariant == 0)
+        return true;
+    return uVariant < pl_sb_size(ptVulkanGfx->tVariants.sbtVariants) && ptVulkanGfx->tVariants.sbtVariants[uVariant].tPipeline != VK_NULL_HANDLE;
+}
+
+static uint32_t
+pl_create_render_target(plGraphics* ptGraphics, const plRenderTargetDesc* ptDesc)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+
+    const VkSampleCountFlagBits tSampleCount = (VkSampleCountFlagBits)(ptDesc->uSampleCount == 0 ? 1 : ptDesc->uSampleCount);
+    PL_ASSERT(tSampleCount <= get_max_sample_count(&ptGraphics->tDevice) && "render target sample count not supported");
+
+    plVulkanRenderTarget tTarget = {
+        .tExtent       = {ptDesc->uWidth, ptDesc->uHeight},
+        .tFormat       = ptDesc->tFormat,
+        .tSampleCount  = tSampleCount
+    };
+    const VkFormat tFormat = pl__vulkan_format(ptDesc->tFormat);
+    const VkFormat tDepthFormat = ptVulkanGfx->tSwapchain.tDepthFormat;
+    const bool     bMultisampled = tSampleCount != VK_SAMPLE_COUNT_1_BIT;
+    const bool     bDepthPyramid = ptDesc->bDepth && ptDesc->bDepthPyramid;
+    PL_ASSERT((!ptDesc->bDepthPyramid || ptDesc->bDepth) && "depth pyramids require bDepth");
+
+    if(bDepthPyramid)
+    {
+        VkFormatProperties tFormatProps = {0};
+        vkGetPhysicalDeviceFormatProperties(ptVulkanDevice->tPhysicalDevice, tDepthFormat, &tFormatProps);
+        PL_ASSERT((tFormatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) && "depth format can't be sampled for a depth pyramid");
+    }
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~attachments~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    tTarget.tOutput = pl__create_attachment(ptGraphics, tFormat, tTarget.tExtent, VK_SAMPLE_COUNT_1_BIT,
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_IMAGE_ASPECT_COLOR_BIT, ptDesc->pcName);
+    if(bMultisampled)
+        tTarget.tMultisampled = pl__create_attachment(ptGraphics, tFormat, tTarget.tExtent, tSampleCount,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT, ptDesc->pcName);
+    if(ptDesc->bDepth)
+        tTarget.tDepth = pl__create_attachment(ptGraphics, tDepthFormat, tTarget.tExtent, tSampleCount,
+            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | (bDepthPyramid ? VK_IMAGE_USAGE_SAMPLED_BIT : VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT),
+            format_has_stencil(tDepthFormat) ? VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT : VK_IMAGE_ASPECT_DEPTH_BIT, ptDesc->pcName);
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~render pass~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // contents never survive between passes, so everything starts undefined &
+    // only the single sampled output (and depth feeding a pyramid) is stored
+    VkAttachmentDescription atAttachments[3] = {0};
+    VkImageView             atViews[3] = {0};
+    uint32_t                uAttachmentCount = 0;
+
+    const VkAttachmentReference tColorReference = {
+        .attachment = uAttachmentCount,
+        .layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+    };
+    atAttachments[uAttachmentCount] = (VkAttachmentDescription){
+        .format         = tFormat,
+        .samples        = tSampleCount,
+        .loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp        = bMultisampled ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE,
+        .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+        .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
+        .finalLayout    = bMultisampled ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    };
+    for(uint32_t i = 0; i < 4; i++)
+        tTarget.atClearValues[uAttachmentCount].color.float32[i] = ptDesc->afClearColor[i];
+    atViews[uAttachmentCount++] = bMultisampled ? tTarget.tMultisampled.tView : tTarget.tOutput.tView;
+
+    const VkAttachmentReference tDepthReference = {
+        .attachment = uAttachmentCount,
+        .layout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+    };
+    if(ptDesc->bDepth)
+    {
+        atAttachments[uAttachmentCount] = (VkAttachmentDescription){
+            .format         = tDepthFormat,
+            .samples        = tSampleCount,
+            .loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp        = bDepthPyramid ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
+            .finalLayout    = bDepthPyramid ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+        };
+        tTarget.atClearValues[uAttachmentCount].depthStencil.depth = ptDesc->fClearDepth;
+        atViews[uAttachmentCount++] = tTarget.tDepth.tView;
+    }
+
+    const VkAttachmentReference tResolveReference = {
+        .attachment = uAttachmentCount,
+        .layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+    };
+    if(bMultisampled)
+    {
+        atAttachments[uAttachmentCount] = (VkAttachmentDescription){
+            .format         = tFormat,
+            .samples        = VK_SAMPLE_COUNT_1_BIT,
+            .loadOp         = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .storeOp        = VK_ATTACHMENT_STORE_OP_STORE,
+            .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
+            .finalLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        };
+        atViews[uAttachmentCount++] = tTarget.tOutput.tView;
+    }
+    tTarget.uClearValueCount = uAttachmentCount;
+
+    const VkSubpassDescription tSubpass = {
+        .pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS,
+        .colorAttachmentCount    = 1,
+        .pColorAttachments       = &tColorReference,
+        .pDepthStencilAttachment = ptDesc->bDepth ? &tDepthReference : NULL,
+        .pResolveAttachments     = bMultisampled ? &tResolveReference : NULL
+    };
+
+    // depth pyramids are built by compute right after the pass
+    const VkPipelineStageFlags tPyramidStages = bDepthPyramid ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : 0;
+    const VkSubpassDependency atDependencies[] = {
+        {
+            // previous frame's sampling, copies & attachment writes finish
+            // before the output is overwritten
+            .srcSubpass    = VK_SUBPASS_EXTERNAL,
+            .dstSubpass    = 0,
+            .srcStageMask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | tPyramidStages,
+            .dstStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+            .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+        },
+        {
+            // output is sampled or copied after the pass
+            .srcSubpass    = 0,
+            .dstSubpass    = VK_SUBPASS_EXTERNAL,
+            .srcStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | (bDepthPyramid ? VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT : 0),
+            .dstStageMask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT | tPyramidStages,
+            .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | (bDepthPyramid ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : 0),
+            .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT
+        }
+    };
+
+    const VkRenderPassCreateInfo tRenderPassInfo = {
+        .sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+        .attachmentCount = uAttachmentCount,
+        .pAttachments    = atAttachments,
+        .subpassCount    = 1,
+        .pSubpasses      = &tSubpass,
+        .dependencyCount = 2,
+        .pDependencies   = atDependencies
+    };
+    PL_VULKAN(vkCreateRenderPass(ptVulkanDevice->tLogicalDevice, &tRenderPassInfo, NULL, &tTarget.tRenderPass));
+
+    const VkFramebufferCreateInfo tFrameBufferInfo = {
+        .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+        .renderPass      = tTarget.tRenderPass,
+        .attachmentCount = uAttachmentCount,
+        .pAttachments    = atViews,
+        .width           = tTarget.tExtent.width,
+        .height          = tTarget.tExtent.height,
+        .layers          = 1u,
+    };
+    PL_VULKAN(vkCreateFramebuffer(ptVulkanDevice->tLogicalDevice, &tFrameBufferInfo, NULL, &tTarget.tFramebuffer));
+
+    // sampled through the global set like any other texture
+    tTarget.uBindlessSlot = pl__allocate_bindless_texture(ptVulkanDevice, tTarget.tOutput.tView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    if(bDepthPyramid)
+        pl__create_depth_pyramid(ptGraphics, &tTarget);
+
+    uint32_t uIndex = 0;
+    if(pl_sb_size(ptVulkanGfx->sbuFreeRenderTargets) > 0)
+    {
+        uIndex = pl_sb_pop(ptVulkanGfx->sbuFreeRenderTargets);
+        ptVulkanGfx->sbtRenderTargets[uIndex] = tTarget;
+    }
+    else
+    {
+        uIndex = pl_sb_size(ptVulkanGfx->sbtRenderTargets);
+        pl_sb_push(ptVulkanGfx->sbtRenderTargets, tTarget);
+    }
+    return uIndex + 1;
+}
+
+static void
+pl_destroy_render_target(plGraphics* ptGraphics, uint32_t uRenderTarget)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+
+    plVulkanRenderTarget* ptTarget = &ptVulkanGfx->sbtRenderTargets[uRenderTarget - 1];
+    PL_ASSERT(ptTarget->tRenderPass && "render target already destroyed");
+    PL_ASSERT(ptVulkanGfx->uActiveRenderTarget != uRenderTarget && "render target is being recorded");
+
+    pl__invalidate_graph_pipelines(ptGraphics, ptTarget->tRenderPass);
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_FRAMEBUFFER,  .tFramebuffer = ptTarget->tFramebuffer});
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_RENDER_PASS,  .tRenderPass  = ptTarget->tRenderPass});
+    pl__queue_deletion(ptVulkanDevice, (plVulkanDeletion){.tType = PL_VULKAN_RESOURCE_TYPE_TEXTURE_SLOT, .uSlot        = ptTarget->uBindlessSlot});
+    pl__queue_attachment_deletion(ptVulkanDevice, &ptTarget->tOutput);
+    pl__queue_attachment_deletion(ptVulkanDevice, &ptTarget->tMultisampled);
+    pl__queue_attachment_deletion(ptVulkanDevice, &ptTarget->tDepth);
+    pl__queue_depth_pyramid_deletion(ptVulkanDevice, ptTarget);
+
+    memset(ptTarget, 0, sizeof(plVulkanRenderTarget));
+    pl_sb_push(ptVulkanGfx->sbuFreeRenderTargets, uRenderTarget - 1);
+}
+
+static void
+pl_begin_render_target(plGraphics* ptGraphics, uint32_t uRenderTarget)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+
+    PL_ASSERT(ptVulkanGfx->uActiveRenderTarget == PL_RENDER_TARGET_NONE && "render targets can't be nested");
+    PL_ASSERT(!ptVulkanGfx->bInMainPass && "render targets must be recorded before begin_recording");
+
+    plVulkanRenderTarget* ptTarget = &ptVulkanGfx->sbtRenderTargets[uRenderTarget - 1];
+    PL_ASSERT(ptTarget->tRenderPass && "render target was destroyed");
+
+    plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGraphics);
+
+    const VkRenderPassBeginInfo tRenderPassInfo = {
+        .sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+        .renderPass        = ptTarget->tRenderPass,
+        .framebuffer       = ptTarget->tFramebuffer,
+        .renderArea.extent = ptTarget->tExtent,
+        .clearValueCount   = ptTarget->uClearValueCount,
+        .pClearValues      = ptTarget->atClearValues
+    };
+
+    const VkRect2D tScissor = {
+        .extent = ptTarget->tExtent
+    };
+
+    const VkViewport tViewport = {
+        .width    = (float)ptTarget->tExtent.width,
+        .height   = (float)ptTarget->tExtent.height,
+        .maxDepth = 1.0f
+    };
+
+    vkCmdBeginRenderPass(ptCurrentFrame->tCmdBuf, &tRenderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdSetViewport(ptCurrentFrame->tCmdBuf, 0, 1, &tViewport);
+    vkCmdSetScissor(ptCurrentFrame->tCmdBuf, 0, 1, &tScissor);
+
+    ptVulkanGfx->tCurrentRenderPass = ptTarget->tRenderPass;
+    ptVulkanGfx->tCurrentSampleCount = ptTarget->tSampleCount;
+    ptVulkanGfx->uActiveRenderTarget = uRenderTarget;
+}
+
+static void
+pl_end_render_target(plGraphics* ptGraphics)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    PL_ASSERT(ptVulkanGfx->uActiveRenderTarget != PL_RENDER_TARGET_NONE && "begin_render_target not called");
+
+    plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGraphics);
+    vkCmdEndRenderPass(ptCurrentFrame->tCmdBuf);
+
+    plVulkanRenderTarget* ptTarget = &ptVulkanGfx->sbtRenderTargets[ptVulkanGfx->uActiveRenderTarget - 1];
+    ptTarget->bRendered = true;
+    ptVulkanGfx->uActiveRenderTarget = PL_RENDER_TARGET_NONE;
+
+    // tested against by culling next frame
+    if(ptTarget->tPyramidImage)
+        pl__build_depth_pyramid(ptGraphics, ptTarget);
+
+    // back to the main pass
+    ptVulkanGfx->tCurrentRenderPass = ptVulkanGfx->tRenderPass;
+    ptVulkanGfx->tCurrentSampleCount = ptVulkanGfx->tSwapchain.tMsaaSamples;
+}
+
+static uint32_t
+pl_get_render_target_bindless_index(plGraphics* ptGraphics, uint32_t uRenderTarget)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    const plVulkanRenderTarget* ptTarget = &ptVulkanGfx->sbtRenderTargets[uRenderTarget - 1];
+    PL_ASSERT(ptTarget->tRenderPass && "render target was destroyed");
+    return ptTarget->uBindlessSlot;
+}
+
+static uint32_t
+pl_get_graph_texture_bindless_index(plGraphics* ptGraphics, uint32_t uTexture)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    PL_ASSERT(uTexture != PL_RENDER_GRAPH_NONE && uTexture <= pl_sb_size(ptGraphics->tRenderGraph.sbtTextures) && "invalid render graph texture");
+
+    // builds this frame's graph early (begin_recording reuses it), slots move
+    // whenever the graph structure changes
+    pl__build_render_graph(ptGraphics);
+    const uint32_t uSlot = ptVulkanGfx->tRenderGraph.sbtTextures[uTexture - 1].uBindlessSlot;
+    PL_ASSERT(uSlot > 0 && "render graph texture is culled, multisampled or depth stencil");
+    PL_ASSERT(ptGraphics->tRenderGraph.sbtTextures[uTexture - 1].tDesc.bSampledAfter && "only textures marked bSampledAfter are left shader readable");
+    return uSlot;
+}
+
+static uint32_t
+pl_request_readback(plGraphics* ptGraphics, uint32_t uRenderTarget)
 {
     plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
     plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
 
-    plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGraphics);
+    PL_ASSERT(ptVulkanGfx->uActiveRenderTarget == PL_RENDER_TARGET_NONE && !ptVulkanGfx->bInMainPass && "readbacks can't be recorded inside a render pass");
 
-    const VkCommandBufferBeginInfo tBeginInfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO
-    };
-    PL_VULKAN(vkResetCommandPool(ptVulkanDevice->tLogicalDevice, ptCurrentFrame->tCmdPool, VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT));
-    PL_VULKAN(vkBeginCommandBuffer(ptCurrentFrame->tCmdBuf, &tBeginInfo));  
+    plVulkanRenderTarget* ptTarget = &ptVulkanGfx->sbtRenderTargets[uRenderTarget - 1];
+    PL_ASSERT(ptTarget->tRenderPass && "render target was destroyed");
+    PL_ASSERT(ptTarget->bRendered && "render target has no contents to read back");
 
-    VkRenderPassBeginInfo renderPassInfo = {0};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = ptVulkanGfx->tRenderPass;
-    renderPassInfo.framebuffer = ptVulkanGfx->tSwapchain.sbtFrameBuffers[ptVulkanGfx->tSwapchain.uCurrentImageIndex];
-    renderPassInfo.renderArea.extent = ptVulkanGfx->tSwapchain.tExtent;
+    // oldest slots are reused first so results stay around as long as possible
+    uint32_t uSlot = UINT32_MAX;
+    for(uint32_t i = 0; i < PL_VULKAN_READBACK_RING_SIZE; i++)
+    {
+        const uint32_t uCandidate = (ptVulkanGfx->uNextReadback + i) % PL_VULKAN_READBACK_RING_SIZE;
+        if(!ptVulkanGfx->atReadbacks[uCandidate].bInUse)
+        {
+            uSlot = uCandidate;
+            break;
+        }
+    }
+    if(uSlot == UINT32_MAX)
+    {
+        pl_log_warn_to_f(uLogChannel, "readback ring full, release readbacks once they are consumed");
+        return PL_RENDER_TARGET_NONE;
+    }
+    ptVulkanGfx->uNextReadback = (uSlot + 1) % PL_VULKAN_READBACK_RING_SIZE;
 
-    VkClearValue clearValues[2];
-    clearValues[0].color.float32[0] = 0.0f;
-    clearValues[0].color.float32[1] = 0.0f;
-    clearValues[0].color.float32[2] = 0.0f;
-    clearValues[0].color.float32[3] = 1.0f;
-    clearValues[1].depthStencil.depth = 0.0f;
-    renderPassInfo.clearValueCount = 2;
-    renderPassInfo.pClearValues = clearValues;
+    plVulkanReadback* ptReadback = &ptVulkanGfx->atReadbacks[uSlot];
+    const uint32_t uRowPitch = ptTarget->tExtent.width * pl__format_stride(ptTarget->tFormat);
+    const VkDeviceSize szSize = (VkDeviceSize)uRowPitch * ptTarget->tExtent.height;
 
-    VkRect2D scissor = {0};
-    scissor.extent = ptVulkanGfx->tSwapchain.tExtent;
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~buffer~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-    VkViewport tViewport = {0};
-    tViewport.x = 0.0f;
-    tViewport.y = 0.0f;
-    tViewport.width = (float)ptVulkanGfx->tSwapchain.tExtent.width;
-    tViewport.height = (float)ptVulkanGfx->tSwapchain.tExtent.height;
+    // slots keep their buffers, so steady state readbacks never allocate
+    if(ptReadback->szSize < szSize)
+    {
+        pl__destroy_readback_buffer(ptVulkanDevice, ptReadback);
 
-    vkCmdSetViewport(ptCurrentFrame->tCmdBuf, 0, 1, &tViewport);
-    vkCmdSetScissor(ptCurrentFrame->tCmdBuf, 0, 1, &scissor);  
+        const VkBufferCreateInfo tBufferCreateInfo = {
+            .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size        = szSize,
+            .usage       = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+        };
+        PL_VULKAN(vkCreateBuffer(ptVulkanDevice->tLogicalDevice, &tBufferCreateInfo, NULL, &ptReadback->tBuffer));
 
-    vkCmdBeginRenderPass(ptCurrentFrame->tCmdBuf, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        VkMemoryRequirements tMemReqs = {0};
+        vkGetBufferMemoryRequirements(ptVulkanDevice->tLogicalDevice, ptReadback->tBuffer, &tMemReqs);
 
-    pl_new_draw_frame_vulkan();
+        // prefer cached memory, the CPU reads every byte
+        uint32_t uMemoryType = UINT32_MAX;
+        const VkMemoryPropertyFlags atPreferredProperties[] = {
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+        };
+        for(uint32_t i = 0; i < 3 && uMemoryType == UINT32_MAX; i++)
+        {
+            for(uint32_t j = 0; j < ptVulkanDevice->tMemProps.memoryTypeCount; j++)
+            {
+                if((tMemReqs.memoryTypeBits & (1 << j)) && (ptVulkanDevice->tMemProps.memoryTypes[j].propertyFlags & atPreferredProperties[i]) == atPreferredProperties[i])
+                {
+                    uMemoryType = j;
+                    break;
+                }
+            }
+        }
+        PL_ASSERT(uMemoryType != UINT32_MAX && "no host visible memory for readback");
+        ptReadback->bHostCoherent = (ptVulkanDevice->tMemProps.memoryTypes[uMemoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+        const VkMemoryAllocateInfo tAllocInfo = {
+            .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .allocationSize  = tMemReqs.size,
+            .memoryTypeIndex = uMemoryType
+        };
+        PL_VULKAN(vkAllocateMemory(ptVulkanDevice->tLogicalDevice, &tAllocInfo, NULL, &ptReadback->tMemory));
+        PL_VULKAN(vkBindBufferMemory(ptVulkanDevice->tLogicalDevice, ptReadback->tBuffer, ptReadback->tMemory, 0));
+        PL_VULKAN(vkMapMemory(ptVulkanDevice->tLogicalDevice, ptReadback->tMemory, 0, VK_WHOLE_SIZE, 0, &ptReadback->pMapping));
+        ptReadback->szSize = szSize;
+    }
 
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~copy~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGraphics);
+
+    const VkImageSubresourceRange tRange = {
+        .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel   = 0,
+        .levelCount     = 1,
+        .baseArrayLayer = 0,
+        .layerCount     = 1
+    };
+    pl__transition_image_layout(ptCurrentFrame->tCmdBuf, ptTarget->tOutput.tImage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, tRange);
+
+    const VkBufferImageCopy tCopyRegion = {
+        .bufferOffset      = 0,
+        .bufferRowLength   = 0, // tightly packed
+        .bufferImageHeight = 0,
+        .imageSubresource  = {
+            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel       = 0,
+            .baseArrayLayer = 0,
+            .layerCount     = 1
+        },
+        .imageExtent       = {ptTarget->tExtent.width, ptTarget->tExtent.height, 1}
+    };
+    vkCmdCopyImageToBuffer(ptCurrentFrame->tCmdBuf, ptTarget->tOutput.tImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, ptReadback->tBuffer, 1, &tCopyRegion);
+
+    pl__transition_image_layout(ptCurrentFrame->tCmdBuf, ptTarget->tOutput.tImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, tRange);
+
+    // make the copy visible to the host once the frame's fence signals
+    const VkBufferMemoryBarrier tHostBarrier = {
+        .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask       = VK_ACCESS_HOST_READ_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer              = ptReadback->tBuffer,
+        .offset              = 0,
+        .size                = szSize
+    };
+    vkCmdPipelineBarrier(ptCurrentFrame->tCmdBuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, NULL, 1, &tHostBarrier, 0, NULL);
+
+    ptReadback->bInUse    = true;
+    ptReadback->ulFrame   = ptVulkanDevice->ulFrameCount;
+    ptReadback->tFormat   = ptTarget->tFormat;
+    ptReadback->uWidth    = ptTarget->tExtent.width;
+    ptReadback->uHeight   = ptTarget->tExtent.height;
+    ptReadback->uRowPitch = uRowPitch;
+    return uSlot + 1;
 }
 
-static void
-pl_end_recording(plGraphics* ptGraphics)
+static bool
+pl_get_readback(plGraphics* ptGraphics, uint32_t uReadback, plReadback* ptReadbackOut)
 {
     plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
     plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
 
-    plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGraphics);
+    plVulkanReadback* ptReadback = &ptVulkanGfx->atReadbacks[uReadback - 1];
+    PL_ASSERT(ptReadback->bInUse && "readback was released");
 
-    vkCmdEndRenderPass(ptCurrentFrame->tCmdBuf);
+    // never blocks, completion is only learned through the fence waits in begin_frame
+    if(ptReadback->ulFrame > ptVulkanDevice->ulCompletedFrame)
+        return false;
 
-    PL_VULKAN(vkEndCommandBuffer(ptCurrentFrame->tCmdBuf));
+    if(!ptReadback->bHostCoherent)
+    {
+        const VkMappedMemoryRange tRange = {
+            .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+            .memory = ptReadback->tMemory,
+            .offset = 0,
+            .size   = VK_WHOLE_SIZE
+        };
+        PL_VULKAN(vkInvalidateMappedMemoryRanges(ptVulkanDevice->tLogicalDevice, 1, &tRange));
+    }
+
+    *ptReadbackOut = (plReadback){
+        .pData     = ptReadback->pMapping,
+        .tFormat   = ptReadback->tFormat,
+        .uWidth    = ptReadback->uWidth,
+        .uHeight   = ptReadback->uHeight,
+        .uRowPitch = ptReadback->uRowPitch,
+        .ulFrame   = ptReadback->ulFrame
+    };
+    return true;
+}
+
+static void
+pl_release_readback(plGraphics* ptGraphics, uint32_t uReadback)
+{
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    PL_ASSERT(ptVulkanGfx->atReadbacks[uReadback - 1].bInUse && "readback already released");
+    ptVulkanGfx->atReadbacks[uReadback - 1].bInUse = false;
 }
 
 static void
@@ -1856,7 +6671,24 @@ pl_initialize_graphics(plGraphics* ptGraphics)
     plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
     plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
     
-    ptVulkanGfx->uFramesInFlight = 2;
+    if(ptGraphics->uFramesInFlight == 0)
+        ptGraphics->uFramesInFlight = 2;
+    PL_ASSERT(ptGraphics->uFramesInFlight <= PL_VULKAN_MAX_FRAMES_IN_FLIGHT && "too many frames in flight");
+    ptVulkanGfx->uFramesInFlight = ptGraphics->uFramesInFlight;
+    ptVulkanDevice->ulFrameCount = 1;
+
+    if(gptStats)
+    {
+        ptVulkanGfx->pdPendingDeletions      = gptStats->get_counter("vulkan pending deletions");
+        ptVulkanGfx->pdPendingDeletionBytes  = gptStats->get_counter("vulkan pending deletion bytes");
+        ptVulkanGfx->pdCpuWaitTime           = gptStats->get_counter("vulkan cpu wait on gpu (ms)");
+        ptVulkanGfx->pdStreamingResident     = gptStats->get_counter("texture streaming resident bytes");
+        ptVulkanGfx->pdStreamingRequested    = gptStats->get_counter("texture streaming requested bytes");
+        ptVulkanGfx->pdStreamingBudget       = gptStats->get_counter("texture streaming budget bytes");
+        ptVulkanGfx->pdCullInputDraws        = gptStats->get_counter("culling input draws");
+        ptVulkanGfx->pdCullVisibleDraws      = gptStats->get_counter("culling visible draws");
+        ptVulkanGfx->pdShaderVariantsPending = gptStats->get_counter("shader variants compiling");
+    }
 
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~create instance~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
@@ -2114,6 +6946,8 @@ pl_initialize_graphics(plGraphics* ptGraphics)
     {
         if(pl_str_equal(ptExtensions[i].extensionName, VK_KHR_SWAPCHAIN_EXTENSION_NAME)) ptVulkanDevice->bSwapchainExtPresent = true; //-V522
         if(pl_str_equal(ptExtensions[i].extensionName, "VK_KHR_portability_subset"))     ptVulkanDevice->bPortabilitySubsetPresent = true; //-V522
+        if(pl_str_equal(ptExtensions[i].extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) ptVulkanDevice->bMemoryBudgetExtPresent = true; //-V522
+        if(pl_str_equal(ptExtensions[i].extensionName, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME)) ptVulkanDevice->bDrawIndirectCountExtPresent = true; //-V522
     }
 
     PL_FREE(ptExtensions);
@@ -2146,6 +6980,37 @@ pl_initialize_graphics(plGraphics* ptGraphics)
 
     vkGetPhysicalDeviceFeatures(ptVulkanDevice->tPhysicalDevice, &ptVulkanDevice->tDeviceFeatures);
 
+    // descriptor indexing (core in 1.2) enables the bindless path, otherwise
+    // we fall back to fixed size descriptor arrays
+    VkPhysicalDeviceDescriptorIndexingFeatures tIndexingFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES
+    };
+    if(ptVulkanDevice->tDeviceProps.apiVersion >= VK_API_VERSION_1_2)
+    {
+        VkPhysicalDeviceFeatures2 tFeatures2 = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &tIndexingFeatures
+        };
+        vkGetPhysicalDeviceFeatures2(ptVulkanDevice->tPhysicalDevice, &tFeatures2);
+    }
+    ptVulkanDevice->tBindless.bDescriptorIndexing =
+        tIndexingFeatures.runtimeDescriptorArray &&
+        tIndexingFeatures.descriptorBindingPartiallyBound &&
+        tIndexingFeatures.shaderSampledImageArrayNonUniformIndexing &&
+        tIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+        tIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind &&
+        tIndexingFeatures.descriptorBindingUpdateUnusedWhilePending;
+
+    const VkPhysicalDeviceDescriptorIndexingFeatures tEnabledIndexingFeatures = {
+        .sType                                         = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+        .runtimeDescriptorArray                        = VK_TRUE,
+        .descriptorBindingPartiallyBound               = VK_TRUE,
+        .shaderSampledImageArrayNonUniformIndexing     = VK_TRUE,
+        .descriptorBindingSampledImageUpdateAfterBind  = VK_TRUE,
+        .descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE,
+        .descriptorBindingUpdateUnusedWhilePending     = VK_TRUE
+    };
+
     const float fQueuePriority = 1.0f;
     VkDeviceQueueCreateInfo atQueueCreateInfos[] = {
         {
@@ -2167,9 +7032,12 @@ pl_initialize_graphics(plGraphics* ptGraphics)
     const char** sbpcDeviceExts = NULL;
     if(ptVulkanDevice->bSwapchainExtPresent)      pl_sb_push(sbpcDeviceExts, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
     if(ptVulkanDevice->bPortabilitySubsetPresent) pl_sb_push(sbpcDeviceExts, "VK_KHR_portability_subset");
+    if(ptVulkanDevice->bMemoryBudgetExtPresent)   pl_sb_push(sbpcDeviceExts, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if(ptVulkanDevice->bDrawIndirectCountExtPresent) pl_sb_push(sbpcDeviceExts, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
     pl_sb_push(sbpcDeviceExts, VK_EXT_DEBUG_MARKER_EXTENSION_NAME);
     VkDeviceCreateInfo tCreateDeviceInfo = {
         .sType                    = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .pNext                    = ptVulkanDevice->tBindless.bDescriptorIndexing ? &tEnabledIndexingFeatures : NULL,
         .queueCreateInfoCount     = atQueueCreateInfos[0].queueFamilyIndex == atQueueCreateInfos[1].queueFamilyIndex ? 1 : 2,
         .pQueueCreateInfos        = atQueueCreateInfos,
         .pEnabledFeatures         = &ptVulkanDevice->tDeviceFeatures,
@@ -2204,9 +7072,12 @@ pl_initialize_graphics(plGraphics* ptGraphics)
     };
     PL_VULKAN(vkCreateCommandPool(ptVulkanDevice->tLogicalDevice, &tCommandPoolInfo, NULL, &ptVulkanDevice->tCmdPool));
 
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~pipeline cache~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    ptVulkanGfx->tPipelineCache = pl__load_pipeline_cache(ptVulkanDevice, PL_VULKAN_PIPELINE_CACHE_FILE);
+
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~swapchain~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-    ptVulkanGfx->tSwapchain.bVSync = true;
     create_swapchain(ptGraphics, (uint32_t)ptIOCtx->afMainViewportSize[0], (uint32_t)ptIOCtx->afMainViewportSize[1], &ptVulkanGfx->tSwapchain);
 
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~main renderpass~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -2221,7 +7092,7 @@ pl_initialize_graphics(plGraphics* ptGraphics)
             .storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE,
             .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
             .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-            .initialLayout  = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
             .finalLayout    = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
         },
 
@@ -2233,7 +7104,7 @@ pl_initialize_graphics(plGraphics* ptGraphics)
             .storeOp        = VK_ATTACHMENT_STORE_OP_STORE,
             .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_CLEAR,
             .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-            .initialLayout  = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
             .finalLayout    = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
         },
 
@@ -2311,65 +7182,14 @@ pl_initialize_graphics(plGraphics* ptGraphics)
 
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~frame buffer~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
     
-    pl_sb_resize(ptVulkanGfx->tSwapchain.sbtFrameBuffers, ptVulkanGfx->tSwapchain.uImageCount);
-    for(uint32_t i = 0; i < ptVulkanGfx->tSwapchain.uImageCount; i++)
-    {
-        ptVulkanGfx->tSwapchain.sbtFrameBuffers[i] = VK_NULL_HANDLE;
-
-        VkImageView atViewAttachments[] = {
-            ptVulkanGfx->tSwapchain.tColorTextureView,
-            ptVulkanGfx->tSwapchain.tDepthTextureView,
-            ptVulkanGfx->tSwapchain.sbtImageViews[i]
-        };
-
-        VkFramebufferCreateInfo tFrameBufferInfo = {
-            .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-            .renderPass      = ptVulkanGfx->tRenderPass,
-            .attachmentCount = 3,
-            .pAttachments    = atViewAttachments,
-            .width           = ptVulkanGfx->tSwapchain.tExtent.width,
-            .height          = ptVulkanGfx->tSwapchain.tExtent.height,
-            .layers          = 1u,
-        };
-        PL_VULKAN(vkCreateFramebuffer(ptVulkanDevice->tLogicalDevice, &tFrameBufferInfo, NULL, &ptVulkanGfx->tSwapchain.sbtFrameBuffers[i]));
-    }
+    pl__create_main_framebuffers(ptGraphics);
+    ptVulkanGfx->tCurrentRenderPass = ptVulkanGfx->tRenderPass;
+    ptVulkanGfx->tCurrentSampleCount = ptVulkanGfx->tSwapchain.tMsaaSamples;
 
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~frame resources~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-    const VkCommandPoolCreateInfo tFrameCommandPoolInfo = {
-        .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-        .queueFamilyIndex = ptVulkanDevice->iGraphicsQueueFamily,
-        .flags            = 0
-    };
-    
-    const VkSemaphoreCreateInfo tSemaphoreInfo = {
-        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
-    };
-
-    const VkFenceCreateInfo tFenceInfo = {
-        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-        .flags = VK_FENCE_CREATE_SIGNALED_BIT
-    };
-
-    pl_sb_resize(ptVulkanGfx->sbFrames, ptVulkanGfx->uFramesInFlight);
     for(uint32_t i = 0; i < ptVulkanGfx->uFramesInFlight; i++)
-    {
-        plFrameContext tFrame = {0};
-        PL_VULKAN(vkCreateSemaphore(ptVulkanDevice->tLogicalDevice, &tSemaphoreInfo, NULL, &tFrame.tImageAvailable));
-        PL_VULKAN(vkCreateSemaphore(ptVulkanDevice->tLogicalDevice, &tSemaphoreInfo, NULL, &tFrame.tRenderFinish));
-        PL_VULKAN(vkCreateFence(ptVulkanDevice->tLogicalDevice, &tFenceInfo, NULL, &tFrame.tInFlight));
-        PL_VULKAN(vkCreateCommandPool(ptVulkanDevice->tLogicalDevice, &tFrameCommandPoolInfo, NULL, &tFrame.tCmdPool));
-
-        const VkCommandBufferAllocateInfo tAllocInfo = {
-            .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-            .commandPool        = tFrame.tCmdPool,
-            .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-            .commandBufferCount = 1
-        };
-
-        PL_VULKAN(vkAllocateCommandBuffers(ptVulkanDevice->tLogicalDevice, &tAllocInfo, &tFrame.tCmdBuf));  
-        ptVulkanGfx->sbFrames[i] = tFrame;
-    }
+        pl_sb_push(ptVulkanGfx->sbFrames, pl__create_frame_context(ptVulkanDevice));
 
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~main descriptor pool~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
@@ -2395,6 +7215,9 @@ pl_initialize_graphics(plGraphics* ptGraphics)
         .pPoolSizes    = atPoolSizes,
     };
     PL_VULKAN(vkCreateDescriptorPool(ptVulkanDevice->tLogicalDevice, &tDescriptorPoolInfo, NULL, &ptVulkanGfx->tDescriptorPool));
+
+    // global set, bound once per draw_areas call
+    pl__create_bindless_heap(ptGraphics);
     
 
     // setup drawing api
@@ -2404,7 +7227,7 @@ pl_initialize_graphics(plGraphics* ptGraphics)
         .uImageCount      = ptVulkanGfx->tSwapchain.uImageCount,
         .tRenderPass      = ptVulkanGfx->tRenderPass,
         .tMSAASampleCount = ptVulkanGfx->tSwapchain.tMsaaSamples,
-        .uFramesInFlight  = ptVulkanGfx->uFramesInFlight
+        .uFramesInFlight  = PL_VULKAN_MAX_FRAMES_IN_FLIGHT // frames in flight may grow at runtime
     };
     pl_initialize_vulkan(&tVulkanInit);
 
@@ -2412,202 +7235,42 @@ pl_initialize_graphics(plGraphics* ptGraphics)
 
     ptVulkanGfx->g_bindingDescriptions[0].binding = 0;
     ptVulkanGfx->g_bindingDescriptions[0].stride = sizeof(float)*7;
-    ptVulkanGfx->g_bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-    ptVulkanGfx->g_attributeDescriptions[0].binding = 0;
-    ptVulkanGfx->g_attributeDescriptions[0].location = 0;
-    ptVulkanGfx->g_attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-    ptVulkanGfx->g_attributeDescriptions[0].offset = 0u;
-
-    ptVulkanGfx->g_attributeDescriptions[1].binding = 0;
-    ptVulkanGfx->g_attributeDescriptions[1].location = 1;
-    ptVulkanGfx->g_attributeDescriptions[1].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-    ptVulkanGfx->g_attributeDescriptions[1].offset = sizeof(float)*3;
-
-    VkPipelineMultisampleStateCreateInfo multisampling = {0};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {0};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 0;
-
-    PL_VULKAN(vkCreatePipelineLayout(ptVulkanDevice->tLogicalDevice, &pipelineLayoutInfo, NULL, &ptVulkanGfx->g_pipelineLayout));
-
-    unsigned vertexFileSize = 0u;
-    unsigned pixelFileSize = 0u;
-    char* vertexShaderCode = read_file("primitive.vert.spv", &vertexFileSize, "rb");
-    char* pixelShaderCode = read_file("primitive.frag.spv", &pixelFileSize, "rb");
-
-    {
-        VkShaderModuleCreateInfo createInfo = {0};
-        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = vertexFileSize;
-        createInfo.pCode = (const uint32_t*)(vertexShaderCode);
-        assert(vkCreateShaderModule(ptVulkanDevice->tLogicalDevice, &createInfo, NULL, &ptVulkanGfx->g_vertexShaderModule) == VK_SUCCESS);
-    }
-
-    {
-        VkShaderModuleCreateInfo createInfo = {0};
-        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = pixelFileSize;
-        createInfo.pCode = (const uint32_t*)(pixelShaderCode);
-        assert(vkCreateShaderModule(ptVulkanDevice->tLogicalDevice, &createInfo, NULL, &ptVulkanGfx->g_pixelShaderModule) == VK_SUCCESS);
-    }
-
-    //---------------------------------------------------------------------
-    // input assembler stage
-    //---------------------------------------------------------------------
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {0};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {0};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1u;
-    vertexInputInfo.vertexAttributeDescriptionCount = 2u;
-    vertexInputInfo.pVertexBindingDescriptions = ptVulkanGfx->g_bindingDescriptions;
-    vertexInputInfo.pVertexAttributeDescriptions = ptVulkanGfx->g_attributeDescriptions;
-
-    //---------------------------------------------------------------------
-    // vertex shader stage
-    //---------------------------------------------------------------------
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo = {0};
-    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = ptVulkanGfx->g_vertexShaderModule;
-    vertShaderStageInfo.pName = "main";
-
-    //---------------------------------------------------------------------
-    // tesselation stage
-    //---------------------------------------------------------------------
-
-    //---------------------------------------------------------------------
-    // geometry shader stage
-    //---------------------------------------------------------------------
-
-    //---------------------------------------------------------------------
-    // rasterization stage
-    //---------------------------------------------------------------------
-
-    VkViewport viewport = {0};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float)ptIOCtx->afMainViewportSize[0];
-    viewport.height = (float)ptIOCtx->afMainViewportSize[1];
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor = {0};
-    scissor.extent.width = (unsigned)viewport.width;
-    scissor.extent.height = (unsigned)viewport.y;
-
-    VkPipelineViewportStateCreateInfo viewportState = {0};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
-    viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
-
-    VkPipelineRasterizationStateCreateInfo rasterizer = {0};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.depthClampEnable = VK_FALSE;
-    rasterizer.rasterizerDiscardEnable = VK_FALSE;
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_NONE;
-    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-    rasterizer.depthBiasEnable = VK_FALSE;
-
-    //---------------------------------------------------------------------
-    // fragment shader stage
-    //---------------------------------------------------------------------
-    VkPipelineShaderStageCreateInfo fragShaderStageInfo = {0};
-    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = ptVulkanGfx->g_pixelShaderModule;
-    fragShaderStageInfo.pName = "main";
-
-    VkPipelineDepthStencilStateCreateInfo depthStencil = {0};
-    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencil.depthTestEnable = VK_TRUE;
-    depthStencil.depthWriteEnable = VK_TRUE;
-    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
-    depthStencil.depthBoundsTestEnable = VK_FALSE;
-    depthStencil.minDepthBounds = 0.0f; // Optional
-    depthStencil.maxDepthBounds = 1.0f; // Optional
-    depthStencil.stencilTestEnable = VK_FALSE;
-
-    //---------------------------------------------------------------------
-    // color blending stage
-    //---------------------------------------------------------------------
-    VkPipelineColorBlendAttachmentState colorBlendAttachment = {0};
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_TRUE;
-    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    ptVulkanGfx->g_bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 
-    VkPipelineColorBlendStateCreateInfo colorBlending = {0};
-    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.logicOp = VK_LOGIC_OP_COPY;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
-    colorBlending.blendConstants[0] = 0.0f;
-    colorBlending.blendConstants[1] = 0.0f;
-    colorBlending.blendConstants[2] = 0.0f;
-    colorBlending.blendConstants[3] = 0.0f;
+    ptVulkanGfx->g_attributeDescriptions[0].binding = 0;
+    ptVulkanGfx->g_attributeDescriptions[0].location = 0;
+    ptVulkanGfx->g_attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    ptVulkanGfx->g_attributeDescriptions[0].offset = 0u;
 
-    VkPipelineMultisampleStateCreateInfo multisampling2 = {0};
-    multisampling2.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling2.sampleShadingEnable = VK_FALSE;
-    multisampling2.rasterizationSamples = ptVulkanGfx->tSwapchain.tMsaaSamples;
+    ptVulkanGfx->g_attributeDescriptions[1].binding = 0;
+    ptVulkanGfx->g_attributeDescriptions[1].location = 1;
+    ptVulkanGfx->g_attributeDescriptions[1].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    ptVulkanGfx->g_attributeDescriptions[1].offset = sizeof(float)*3;
 
-    //---------------------------------------------------------------------
-    // Create Pipeline
-    //---------------------------------------------------------------------
-    VkPipelineShaderStageCreateInfo shaderStages[] = {
-        vertShaderStageInfo,
-        fragShaderStageInfo
-    };
+    VkPipelineMultisampleStateCreateInfo multisampling = {0};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.sampleShadingEnable = VK_FALSE;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
+    const VkPushConstantRange tDrawConstantRange = {
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        .offset     = 0,
+        .size       = sizeof(plVulkanDrawConstants)
+    };
 
-    VkDynamicState dynamicStateEnables[3] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR, VK_DYNAMIC_STATE_DEPTH_BIAS };
-    VkPipelineDynamicStateCreateInfo dynamicState = {0};
-    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicState.dynamicStateCount = 3;
-    dynamicState.pDynamicStates = dynamicStateEnables;
-    
-    VkGraphicsPipelineCreateInfo pipelineInfo = {0};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2u;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling2;
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pDynamicState = &dynamicState;
-    pipelineInfo.layout = ptVulkanGfx->g_pipelineLayout;
-    pipelineInfo.renderPass = ptVulkanGfx->tRenderPass;
-    pipelineInfo.subpass = 0;
-    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-    pipelineInfo.pDepthStencilState = &depthStencil;
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {0};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &ptVulkanDevice->tBindless.tSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &tDrawConstantRange;
 
-    PL_VULKAN(vkCreateGraphicsPipelines(ptVulkanDevice->tLogicalDevice, VK_NULL_HANDLE, 1, &pipelineInfo, NULL, &ptVulkanGfx->g_pipeline));
+    PL_VULKAN(vkCreatePipelineLayout(ptVulkanDevice->tLogicalDevice, &pipelineLayoutInfo, NULL, &ptVulkanGfx->g_pipelineLayout));
 
-    // no longer need these
-    vkDestroyShaderModule(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->g_vertexShaderModule, NULL);
-    vkDestroyShaderModule(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->g_pixelShaderModule, NULL);
-    ptVulkanGfx->g_vertexShaderModule = VK_NULL_HANDLE;
-    ptVulkanGfx->g_pixelShaderModule = VK_NULL_HANDLE;
+    // every shader is loaded up front, pipelines pick modules from the library
+    pl__create_shader_library(ptGraphics);
+    pl__create_main_pipeline(ptGraphics);
+    pl__create_variant_manager(ptGraphics);
 
     ///////////////////////////////
 
@@ -2636,24 +7299,14 @@ pl_initialize_graphics(plGraphics* ptGraphics)
     ptVulkanGfx->t3DVtxShdrStgInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
     ptVulkanGfx->t3DVtxShdrStgInfo.pName = "main";
 
-    const VkShaderModuleCreateInfo t3DVtxShdrInfo = {
-        .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .codeSize = sizeof(__glsl_shader_vert_3d_spv),
-        .pCode    = __glsl_shader_vert_3d_spv
-    };
-    PL_ASSERT(vkCreateShaderModule(ptVulkanDevice->tLogicalDevice, &t3DVtxShdrInfo, NULL, &ptVulkanGfx->t3DVtxShdrStgInfo.module) == VK_SUCCESS);
+    ptVulkanGfx->t3DVtxShdrStgInfo.module = ptVulkanGfx->tShaders.atShaders[PL_VULKAN_SHADER_DRAW_3D_VERT].tModule;
 
     // fragment shader stage
     ptVulkanGfx->t3DPxlShdrStgInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     ptVulkanGfx->t3DPxlShdrStgInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
     ptVulkanGfx->t3DPxlShdrStgInfo.pName = "main";
 
-    const VkShaderModuleCreateInfo t3DPxlShdrInfo = {
-        .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .codeSize = sizeof(__glsl_shader_frag_3d_spv),
-        .pCode    = __glsl_shader_frag_3d_spv
-    };
-    PL_ASSERT(vkCreateShaderModule(ptVulkanDevice->tLogicalDevice, &t3DPxlShdrInfo, NULL, &ptVulkanGfx->t3DPxlShdrStgInfo.module) == VK_SUCCESS);
+    ptVulkanGfx->t3DPxlShdrStgInfo.module = ptVulkanGfx->tShaders.atShaders[PL_VULKAN_SHADER_DRAW_3D_FRAG].tModule;
 
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~3d line setup~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
@@ -2681,82 +7334,90 @@ pl_initialize_graphics(plGraphics* ptGraphics)
     ptVulkanGfx->t3DLineVtxShdrStgInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
     ptVulkanGfx->t3DLineVtxShdrStgInfo.pName = "main";
 
-    const VkShaderModuleCreateInfo t3DLineVtxShdrInfo = {
-        .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .codeSize = sizeof(__glsl_shader_vert_3d_line_spv),
-        .pCode    = __glsl_shader_vert_3d_line_spv
-    };
-    PL_ASSERT(vkCreateShaderModule(ptVulkanDevice->tLogicalDevice, &t3DLineVtxShdrInfo, NULL, &ptVulkanGfx->t3DLineVtxShdrStgInfo.module) == VK_SUCCESS);
+    ptVulkanGfx->t3DLineVtxShdrStgInfo.module = ptVulkanGfx->tShaders.atShaders[PL_VULKAN_SHADER_DRAW_3D_LINE_VERT].tModule;
 
-    pl_sb_resize(ptVulkanGfx->sbt3DBufferInfo, ptVulkanGfx->uFramesInFlight);
-    pl_sb_resize(ptVulkanGfx->sbtLineBufferInfo, ptVulkanGfx->uFramesInFlight);
+    pl__create_dynamic_buffer(ptGraphics, PL_VULKAN_DYNAMIC_BUFFER_SIZE);
+
+    // gpu culling & depth pyramids
+    pl__create_culling(ptGraphics);
 }
 
 static bool
 pl_begin_frame(plGraphics* ptGraphics)
 {
     pl_begin_profile_sample(__FUNCTION__);
-    plIO* ptIOCtx = pl_get_io();
 
     plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
     plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
 
-    plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGraphics);
+    // frames in flight changes are applied between frames
+    if(ptGraphics->uFramesInFlight != ptVulkanGfx->uFramesInFlight)
+        pl__resize_frame_contexts(ptGraphics, ptGraphics->uFramesInFlight);
 
-    // cleanup queue
-    plFrameGarbage* ptGarbage = &ptVulkanDevice->_sbtFrameGarbage[ptVulkanDevice->uCurrentFrame];
+    plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGraphics);
 
-    if(ptGarbage)
+    // the only wait on the GPU this frame, nothing below touches this
+    // context's resources before it
+    const double dWaitStart = pl__get_wall_clock();
+    if(ptGraphics->bLowLatency)
+    {
+        // drain every frame so input is sampled right before recording and
+        // at most one frame is ever queued
+        VkFence atFences[PL_VULKAN_MAX_FRAMES_IN_FLIGHT] = {0};
+        for(uint32_t i = 0; i < ptVulkanGfx->uFramesInFlight; i++)
+            atFences[i] = ptVulkanGfx->sbFrames[i].tInFlight;
+        PL_VULKAN(vkWaitForFences(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->uFramesInFlight, atFences, VK_TRUE, UINT64_MAX));
+        ptVulkanDevice->ulCompletedFrame = ptVulkanDevice->ulFrameCount - 1;
+    }
+    else
     {
-        for(uint32_t i = 0; i < pl_sb_size(ptGarbage->sbtTextures); i++)
-            vkDestroyImage(ptVulkanDevice->tLogicalDevice, ptGarbage->sbtTextures[i], NULL);
+        PL_VULKAN(vkWaitForFences(ptVulkanDevice->tLogicalDevice, 1, &ptCurrentFrame->tInFlight, VK_TRUE, UINT64_MAX));
+
+        // fences signal in submission order, so everything up to the frame last
+        // submitted with this context is finished
+        if(ptCurrentFrame->ulSubmittedFrame > ptVulkanDevice->ulCompletedFrame)
+            ptVulkanDevice->ulCompletedFrame = ptCurrentFrame->ulSubmittedFrame;
+    }
+    ptVulkanGfx->dCpuWaitTime = (pl__get_wall_clock() - dWaitStart) * 1000.0;
 
-        for(uint32_t i = 0; i < pl_sb_size(ptGarbage->sbtTextureViews); i++)
-            vkDestroyImageView(ptVulkanDevice->tLogicalDevice, ptGarbage->sbtTextureViews[i], NULL);
+    pl__retire_deletions(ptVulkanDevice, false);
 
-        for(uint32_t i = 0; i < pl_sb_size(ptGarbage->sbtFrameBuffers); i++)
-            vkDestroyFramebuffer(ptVulkanDevice->tLogicalDevice, ptGarbage->sbtFrameBuffers[i], NULL);
+    // changed shaders are rebuilt before anything is recorded with them
+    if(ptGraphics->bShaderHotReload && pl__get_wall_clock() - ptVulkanGfx->tShaders.dLastPoll > PL_VULKAN_SHADER_POLL_INTERVAL)
+        pl_reload_shaders(ptGraphics);
 
-        for(uint32_t i = 0; i < pl_sb_size(ptGarbage->sbtMemory); i++)
-            vkFreeMemory(ptVulkanDevice->tLogicalDevice, ptGarbage->sbtMemory[i], NULL);
+    // variants compiled since the last frame replace their fallbacks
+    pl__update_shader_variants(ptGraphics);
 
-        pl_sb_reset(ptGarbage->sbtTextures);
-        pl_sb_reset(ptGarbage->sbtTextureViews);
-        pl_sb_reset(ptGarbage->sbtFrameBuffers);
-        pl_sb_reset(ptGarbage->sbtMemory);
+    // survivor counts from this context's last frame & reset of per frame culling state
+    pl__read_cull_stats(ptGraphics);
+
+    // residency changes move textures to new bindless slots, so this runs
+    // before the frame's descriptors are flushed & recording starts
+    pl__update_texture_streaming(&ptGraphics->tDevice);
+
+    // this frame's fallback descriptor set is no longer in use
+    pl__flush_bindless_writes(ptVulkanDevice, (uint32_t)ptVulkanGfx->szCurrentFrameIndex);
+
+    // swapchain changes are applied between frames, resizes only once the
+    // window size has settled
+    const bool bResizeSettled = ptVulkanGfx->bResizePending && pl__get_wall_clock() - ptVulkanGfx->dLastResizeTime >= PL_VULKAN_RESIZE_DEBOUNCE_TIME;
+    if(ptVulkanGfx->bSwapchainDirty || bResizeSettled)
+    {
+        if(!pl__recreate_swapchain(ptGraphics))
+        {
+            pl_end_profile_sample();
+            return false;
+        }
     }
 
-    PL_VULKAN(vkWaitForFences(ptVulkanDevice->tLogicalDevice, 1, &ptCurrentFrame->tInFlight, VK_TRUE, UINT64_MAX));
     VkResult err = vkAcquireNextImageKHR(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tSwapchain.tSwapChain, UINT64_MAX, ptCurrentFrame->tImageAvailable, VK_NULL_HANDLE, &ptVulkanGfx->tSwapchain.uCurrentImageIndex);
     if(err == VK_SUBOPTIMAL_KHR || err == VK_ERROR_OUT_OF_DATE_KHR)
     {
+        // can't present to an out of date swapchain, so this one can't wait
         if(err == VK_ERROR_OUT_OF_DATE_KHR)
         {
-            create_swapchain(ptGraphics, (uint32_t)ptIOCtx->afMainViewportSize[0], (uint32_t)ptIOCtx->afMainViewportSize[1], &ptVulkanGfx->tSwapchain);
-
-            // recreate frame buffers
-            pl_sb_resize(ptVulkanGfx->tSwapchain.sbtFrameBuffers, ptVulkanGfx->tSwapchain.uImageCount);
-            for(uint32_t i = 0; i < ptVulkanGfx->tSwapchain.uImageCount; i++)
-            {
-                ptVulkanGfx->tSwapchain.sbtFrameBuffers[i] = VK_NULL_HANDLE;
-
-                VkImageView atViewAttachments[] = {
-                    ptVulkanGfx->tSwapchain.tColorTextureView,
-                    ptVulkanGfx->tSwapchain.tDepthTextureView,
-                    ptVulkanGfx->tSwapchain.sbtImageViews[i]
-                };
-
-                VkFramebufferCreateInfo tFrameBufferInfo = {
-                    .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-                    .renderPass      = ptVulkanGfx->tRenderPass,
-                    .attachmentCount = 3,
-                    .pAttachments    = atViewAttachments,
-                    .width           = ptVulkanGfx->tSwapchain.tExtent.width,
-                    .height          = ptVulkanGfx->tSwapchain.tExtent.height,
-                    .layers          = 1u,
-                };
-                PL_VULKAN(vkCreateFramebuffer(ptVulkanDevice->tLogicalDevice, &tFrameBufferInfo, NULL, &ptVulkanGfx->tSwapchain.sbtFrameBuffers[i]));
-            }
+            pl__recreate_swapchain(ptGraphics);
 
             pl_end_profile_sample();
             return false;
@@ -2767,47 +7428,20 @@ pl_begin_frame(plGraphics* ptGraphics)
         PL_VULKAN(err);
     }
 
-    if (ptCurrentFrame->tInFlight != VK_NULL_HANDLE)
-        PL_VULKAN(vkWaitForFences(ptVulkanDevice->tLogicalDevice, 1, &ptCurrentFrame->tInFlight, VK_TRUE, UINT64_MAX));
-
-    //-----------------------------------------------------------------------------
-    // buffer deletion queue
-    //-----------------------------------------------------------------------------
-
-    pl_sb_reset(ptVulkanGfx->sbReturnedBuffersTemp);
-    if(ptVulkanGfx->uBufferDeletionQueueSize > 0u)
-    {
-        for(uint32_t i = 0; i < pl_sb_size(ptVulkanGfx->sbReturnedBuffers); i++)
-        {
-            if(ptVulkanGfx->sbReturnedBuffers[i].slFreedFrame < (int64_t)ptVulkanGfx->szCurrentFrameIndex)
-            {
-                ptVulkanGfx->uBufferDeletionQueueSize--;
-                vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbReturnedBuffers[i].tBuffer, NULL);
-                vkFreeMemory(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbReturnedBuffers[i].tDeviceMemory, NULL);
-            }
-            else
-            {
-                pl_sb_push(ptVulkanGfx->sbReturnedBuffersTemp, ptVulkanGfx->sbReturnedBuffers[i]);
-            }
-        }     
-    }
-
-    pl_sb_reset(ptVulkanGfx->sbReturnedBuffers);
-    for(uint32_t i = 0; i < pl_sb_size(ptVulkanGfx->sbReturnedBuffersTemp); i++)
-        pl_sb_push(ptVulkanGfx->sbReturnedBuffers, ptVulkanGfx->sbReturnedBuffersTemp[i]);
+    // reset dynamic buffer region for this frame
+    ptVulkanGfx->tDynamicBuffer.szFrameOffset = 0;
+    ptVulkanGfx->tDynamicBuffer.szFrameUsage = 0;
 
-    // reset buffer offsets
-    for(uint32_t i = 0; i < pl_sb_size(ptVulkanGfx->sbt3DBufferInfo); i++)
-    {
-        ptVulkanGfx->sbt3DBufferInfo[i].uVertexBufferOffset = 0;
-        ptVulkanGfx->sbt3DBufferInfo[i].uIndexBufferOffset = 0;
-    }
+    // render graph is redeclared every frame
+    pl__reset_render_graph(&ptGraphics->tRenderGraph);
 
-    for(uint32_t i = 0; i < pl_sb_size(ptVulkanGfx->sbtLineBufferInfo); i++)
-    {
-        ptVulkanGfx->sbtLineBufferInfo[i].uVertexBufferOffset = 0;
-        ptVulkanGfx->sbtLineBufferInfo[i].uIndexBufferOffset = 0;
-    }
+    // recording starts here so render targets & readbacks can be recorded
+    // before the main pass
+    const VkCommandBufferBeginInfo tBeginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO
+    };
+    PL_VULKAN(vkResetCommandPool(ptVulkanDevice->tLogicalDevice, ptCurrentFrame->tCmdPool, VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT));
+    PL_VULKAN(vkBeginCommandBuffer(ptCurrentFrame->tCmdBuf, &tBeginInfo));
 
     // reset 3d drawlists
     for(uint32_t i = 0u; i < pl_sb_size(ptGraphics->sbt3DDrawlists); i++)
@@ -2828,13 +7462,15 @@ static void
 pl_end_gfx_frame(plGraphics* ptGraphics)
 {
     pl_begin_profile_sample(__FUNCTION__);
-    plIO* ptIOCtx = pl_get_io();
 
     plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
     plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
 
     plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGraphics);
 
+    // uploads recorded this frame land before the frame that samples them
+    pl__flush_uploads(ptVulkanDevice);
+
     // submit
     const VkPipelineStageFlags atWaitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
     const VkSubmitInfo tSubmitInfo = {
@@ -2849,6 +7485,7 @@ pl_end_gfx_frame(plGraphics* ptGraphics)
     };
     PL_VULKAN(vkResetFences(ptVulkanDevice->tLogicalDevice, 1, &ptCurrentFrame->tInFlight));
     PL_VULKAN(vkQueueSubmit(ptVulkanDevice->tGraphicsQueue, 1, &tSubmitInfo, ptCurrentFrame->tInFlight));          
+    ptCurrentFrame->ulSubmittedFrame = ptVulkanDevice->ulFrameCount++;
     
     // present                        
     const VkPresentInfoKHR tPresentInfo = {
@@ -2860,32 +7497,17 @@ pl_end_gfx_frame(plGraphics* ptGraphics)
         .pImageIndices      = &ptVulkanGfx->tSwapchain.uCurrentImageIndex,
     };
     const VkResult tResult = vkQueuePresentKHR(ptVulkanDevice->tPresentQueue, &tPresentInfo);
-    if(tResult == VK_SUBOPTIMAL_KHR || tResult == VK_ERROR_OUT_OF_DATE_KHR)
+    if(tResult == VK_ERROR_OUT_OF_DATE_KHR)
     {
-        create_swapchain(ptGraphics, (uint32_t)ptIOCtx->afMainViewportSize[0], (uint32_t)ptIOCtx->afMainViewportSize[1], &ptVulkanGfx->tSwapchain);
-
-        // recreate frame buffers
-        pl_sb_resize(ptVulkanGfx->tSwapchain.sbtFrameBuffers, ptVulkanGfx->tSwapchain.uImageCount);
-        for(uint32_t i = 0; i < ptVulkanGfx->tSwapchain.uImageCount; i++)
+        ptVulkanGfx->bSwapchainDirty = true;
+    }
+    else if(tResult == VK_SUBOPTIMAL_KHR)
+    {
+        // still presentable, treat like a resize
+        if(!ptVulkanGfx->bResizePending)
         {
-            ptVulkanGfx->tSwapchain.sbtFrameBuffers[i] = VK_NULL_HANDLE;
-
-            VkImageView atViewAttachments[] = {
-                ptVulkanGfx->tSwapchain.tColorTextureView,
-                ptVulkanGfx->tSwapchain.tDepthTextureView,
-                ptVulkanGfx->tSwapchain.sbtImageViews[i]
-            };
-
-            VkFramebufferCreateInfo tFrameBufferInfo = {
-                .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-                .renderPass      = ptVulkanGfx->tRenderPass,
-                .attachmentCount = 3,
-                .pAttachments    = atViewAttachments,
-                .width           = ptVulkanGfx->tSwapchain.tExtent.width,
-                .height          = ptVulkanGfx->tSwapchain.tExtent.height,
-                .layers          = 1u,
-            };
-            PL_VULKAN(vkCreateFramebuffer(ptVulkanDevice->tLogicalDevice, &tFrameBufferInfo, NULL, &ptVulkanGfx->tSwapchain.sbtFrameBuffers[i]));
+            ptVulkanGfx->bResizePending = true;
+            ptVulkanGfx->dLastResizeTime = pl__get_wall_clock();
         }
     }
     else
@@ -2893,6 +7515,19 @@ pl_end_gfx_frame(plGraphics* ptGraphics)
         PL_VULKAN(tResult);
     }
 
+    // published here since apps start a new stats frame after begin_frame
+    if(ptVulkanGfx->pdPendingDeletions)
+    {
+        *ptVulkanGfx->pdPendingDeletions = (double)ptVulkanDevice->uPendingDeletions;
+        *ptVulkanGfx->pdPendingDeletionBytes = (double)ptVulkanDevice->szPendingDeletionBytes;
+        *ptVulkanGfx->pdCpuWaitTime = ptVulkanGfx->dCpuWaitTime;
+        *ptVulkanGfx->pdStreamingResident = (double)ptVulkanDevice->szStreamingResident;
+        *ptVulkanGfx->pdStreamingRequested = (double)ptVulkanDevice->szStreamingRequested;
+        *ptVulkanGfx->pdStreamingBudget = (double)ptVulkanDevice->szStreamingBudgetInUse;
+        *ptVulkanGfx->pdCullInputDraws = (double)ptVulkanGfx->tCulling.uInputDraws; // last completed frame
+        *ptVulkanGfx->pdCullVisibleDraws = (double)ptVulkanGfx->tCulling.uVisibleDraws;
+    }
+
     ptVulkanGfx->szCurrentFrameIndex = (ptVulkanGfx->szCurrentFrameIndex + 1) % ptVulkanGfx->uFramesInFlight;
 
     pl_end_profile_sample();
@@ -2902,40 +7537,12 @@ static void
 pl_resize(plGraphics* ptGraphics)
 {
     pl_begin_profile_sample(__FUNCTION__);
-    plIO* ptIOCtx = pl_get_io();
 
     plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
-    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
-
-    plFrameContext* ptCurrentFrame = pl_get_frame_resources(ptGraphics);
-
-    create_swapchain(ptGraphics, (uint32_t)ptIOCtx->afMainViewportSize[0], (uint32_t)ptIOCtx->afMainViewportSize[1], &ptVulkanGfx->tSwapchain);
-
-    // recreate frame buffers
-    pl_sb_resize(ptVulkanGfx->tSwapchain.sbtFrameBuffers, ptVulkanGfx->tSwapchain.uImageCount);
-    for(uint32_t i = 0; i < ptVulkanGfx->tSwapchain.uImageCount; i++)
-    {
-        ptVulkanGfx->tSwapchain.sbtFrameBuffers[i] = VK_NULL_HANDLE;
-
-        VkImageView atViewAttachments[] = {
-            ptVulkanGfx->tSwapchain.tColorTextureView,
-            ptVulkanGfx->tSwapchain.tDepthTextureView,
-            ptVulkanGfx->tSwapchain.sbtImageViews[i]
-        };
-
-        VkFramebufferCreateInfo tFrameBufferInfo = {
-            .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-            .renderPass      = ptVulkanGfx->tRenderPass,
-            .attachmentCount = 3,
-            .pAttachments    = atViewAttachments,
-            .width           = ptVulkanGfx->tSwapchain.tExtent.width,
-            .height          = ptVulkanGfx->tSwapchain.tExtent.height,
-            .layers          = 1u,
-        };
-        PL_VULKAN(vkCreateFramebuffer(ptVulkanDevice->tLogicalDevice, &tFrameBufferInfo, NULL, &ptVulkanGfx->tSwapchain.sbtFrameBuffers[i]));
-    }
 
-    ptVulkanGfx->szCurrentFrameIndex = 0;
+    // window drags send many resizes, rebuild once they stop (see begin_frame)
+    ptVulkanGfx->bResizePending = true;
+    ptVulkanGfx->dLastResizeTime = pl__get_wall_clock();
 
     pl_end_profile_sample();
 }
@@ -2950,23 +7557,31 @@ pl_shutdown(plGraphics* ptGraphics)
 
     pl_cleanup_vulkan();
 
-    // cleanup 3d
+    // cleanup render graph
+    pl__destroy_render_graph(ptGraphics);
+    pl_sb_free(ptVulkanGfx->tRenderGraph.sbtTextures);
+    pl_sb_free(ptVulkanGfx->tRenderGraph.sbtPasses);
+    pl_sb_free(ptVulkanGfx->tRenderGraph.sbtMemory);
+    pl_sb_free(ptVulkanGfx->tRenderGraph.sbtMemorySizes);
+    pl_sb_free(ptGraphics->tRenderGraph.sbtTextures);
+    pl_sb_free(ptGraphics->tRenderGraph.sbtPasses);
+
+    // cleanup render targets & readback ring
+    for(uint32_t i = 0; i < pl_sb_size(ptVulkanGfx->sbtRenderTargets); i++)
     {
-        for(uint32_t i = 0; i < pl_sb_size(ptVulkanGfx->sbt3DBufferInfo); i++)
-        {
-            vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbt3DBufferInfo[i].tVertexBuffer, NULL);
-            vkFreeMemory(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbt3DBufferInfo[i].tVertexMemory, NULL);
-            vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbt3DBufferInfo[i].tIndexBuffer, NULL);
-            vkFreeMemory(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbt3DBufferInfo[i].tIndexMemory, NULL);
-        }
+        if(ptVulkanGfx->sbtRenderTargets[i].tRenderPass)
+            pl_destroy_render_target(ptGraphics, i + 1);
+    }
+    for(uint32_t i = 0; i < PL_VULKAN_READBACK_RING_SIZE; i++)
+        pl__destroy_readback_buffer(ptVulkanDevice, &ptVulkanGfx->atReadbacks[i]);
+    pl_sb_free(ptVulkanGfx->sbtRenderTargets);
+    pl_sb_free(ptVulkanGfx->sbuFreeRenderTargets);
 
-        for(uint32_t i = 0; i < pl_sb_size(ptVulkanGfx->sbtLineBufferInfo); i++)
-        {
-            vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbtLineBufferInfo[i].tVertexBuffer, NULL);
-            vkFreeMemory(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbtLineBufferInfo[i].tVertexMemory, NULL);
-            vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbtLineBufferInfo[i].tIndexBuffer, NULL);
-            vkFreeMemory(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbtLineBufferInfo[i].tIndexMemory, NULL);
-        }
+    // cleanup 3d
+    {
+        vkUnmapMemory(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tDynamicBuffer.tMemory);
+        vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tDynamicBuffer.tBuffer, NULL);
+        vkFreeMemory(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tDynamicBuffer.tMemory, NULL);
 
         for(uint32_t i = 0u; i < pl_sb_size(ptVulkanGfx->sbt3DPipelines); i++)
         {
@@ -2974,28 +7589,17 @@ pl_shutdown(plGraphics* ptGraphics)
             vkDestroyPipeline(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbt3DPipelines[i].tSecondaryPipeline, NULL);
         }
 
-        if(ptVulkanGfx->uBufferDeletionQueueSize > 0u)
-        {
-            for(uint32_t i = 0; i < pl_sb_size(ptVulkanGfx->sbReturnedBuffers); i++)
-            {
-                vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbReturnedBuffers[i].tBuffer, NULL);
-                vkFreeMemory(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->sbReturnedBuffers[i].tDeviceMemory, NULL);
-            }     
-        }
+        pl__destroy_variant_manager(ptGraphics);
+        pl__save_pipeline_cache(ptVulkanDevice, ptVulkanGfx->tPipelineCache, PL_VULKAN_PIPELINE_CACHE_FILE);
+        vkDestroyPipelineCache(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tPipelineCache, NULL);
 
-        vkDestroyShaderModule(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->t3DPxlShdrStgInfo.module, NULL);
-        vkDestroyShaderModule(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->t3DVtxShdrStgInfo.module, NULL);
-        vkDestroyShaderModule(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->t3DLineVtxShdrStgInfo.module, NULL);
-        vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tStagingBuffer, NULL);
-        vkFreeMemory(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tStagingMemory, NULL);
+        pl__destroy_shader_library(ptGraphics);
         vkDestroyPipelineLayout(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->t3DPipelineLayout, NULL);
         vkDestroyPipelineLayout(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->t3DLinePipelineLayout, NULL);
 
-        pl_sb_free(ptVulkanGfx->sbReturnedBuffers);
-        pl_sb_free(ptVulkanGfx->sbReturnedBuffersTemp);
-        pl_sb_free(ptVulkanGfx->sbt3DBufferInfo);
-        pl_sb_free(ptVulkanGfx->sbtLineBufferInfo);
         pl_sb_free(ptVulkanGfx->sbt3DPipelines);
+        pl_sb_free(ptVulkanGfx->sbu3DPipelineFreeEntries);
+        pl_hm_free(&ptVulkanGfx->t3DPipelineHashMap);
         
         for(uint32_t i = 0u; i < pl_sb_size(ptGraphics->sbt3DDrawlists); i++)
         {
@@ -3012,20 +7616,29 @@ pl_shutdown(plGraphics* ptGraphics)
     for(uint32_t i = 0; i < pl_sb_size(ptGraphics->tDevice.sbtBuffers); i++)
     {
         plVulkanBuffer* ptBuffer = ptGraphics->tDevice.sbtBuffers[i].pBuffer;
+        if(ptBuffer == NULL) // already destroyed
+            continue;
         vkDestroyBuffer(ptVulkanDevice->tLogicalDevice, ptBuffer->tBuffer, NULL);
         vkFreeMemory(ptVulkanDevice->tLogicalDevice, ptBuffer->tMemory, NULL);
         PL_FREE(ptGraphics->tDevice.sbtBuffers[i].pBuffer);
     }
 
-    // cleanup per frame resources
-    for(uint32_t i = 0; i < pl_sb_size(ptVulkanGfx->sbFrames); i++)
+    // cleanup textures & staging ring
+    for(uint32_t i = 0; i < pl_sb_size(ptGraphics->tDevice.sbtTextures); i++)
     {
-        plFrameContext* ptFrame = &ptVulkanGfx->sbFrames[i];
-        vkDestroySemaphore(ptVulkanDevice->tLogicalDevice, ptFrame->tImageAvailable, NULL);
-        vkDestroySemaphore(ptVulkanDevice->tLogicalDevice, ptFrame->tRenderFinish, NULL);
-        vkDestroyFence(ptVulkanDevice->tLogicalDevice, ptFrame->tInFlight, NULL);
-        vkDestroyCommandPool(ptVulkanDevice->tLogicalDevice, ptFrame->tCmdPool, NULL);
+        plVulkanTexture* ptTexture = ptGraphics->tDevice.sbtTextures[i].pTexture;
+        if(ptTexture == NULL) // already destroyed
+            continue;
+        vkDestroyImageView(ptVulkanDevice->tLogicalDevice, ptTexture->tView, NULL);
+        vkDestroyImage(ptVulkanDevice->tLogicalDevice, ptTexture->tImage, NULL);
+        vkFreeMemory(ptVulkanDevice->tLogicalDevice, ptTexture->tMemory, NULL);
+        PL_FREE(ptTexture);
     }
+    pl__destroy_staging_ring(ptVulkanDevice);
+
+    // cleanup per frame resources
+    for(uint32_t i = 0; i < pl_sb_size(ptVulkanGfx->sbFrames); i++)
+        pl__destroy_frame_context(ptVulkanDevice, &ptVulkanGfx->sbFrames[i]);
 
     // swapchain stuff
     vkDestroyImageView(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tSwapchain.tColorTextureView, NULL);
@@ -3049,6 +7662,13 @@ pl_shutdown(plGraphics* ptGraphics)
 
     vkDestroyDescriptorPool(ptVulkanDevice->tLogicalDevice, ptVulkanGfx->tDescriptorPool, NULL);
 
+    // everything is idle, flush pending deletions
+    pl__retire_deletions(ptVulkanDevice, true);
+    pl__destroy_culling(ptGraphics); // pyramid sets were freed back to its pool above
+    pl__destroy_bindless_heap(ptVulkanDevice);
+    for(uint32_t i = 0; i < PL_VULKAN_DELETION_BUCKET_COUNT; i++)
+        pl_sb_free(ptVulkanDevice->atDeletionBuckets[i].sbtDeletions);
+
     // destroy command pool
     vkDestroyCommandPool(ptVulkanDevice->tLogicalDevice, ptVulkanDevice->tCmdPool, NULL);
 
@@ -3068,25 +7688,246 @@ pl_shutdown(plGraphics* ptGraphics)
     // destroy tInstance
     vkDestroyInstance(ptVulkanGfx->tInstance, NULL);
 
-    for(uint32_t i = 0; i < pl_sb_size(ptVulkanDevice->_sbtFrameGarbage); i++)
-    {
-        pl_sb_free(ptVulkanDevice->_sbtFrameGarbage[i].sbtFrameBuffers);
-        pl_sb_free(ptVulkanDevice->_sbtFrameGarbage[i].sbtMemory);
-        pl_sb_free(ptVulkanDevice->_sbtFrameGarbage[i].sbtTextures);
-        pl_sb_free(ptVulkanDevice->_sbtFrameGarbage[i].sbtTextureViews);
-    }
-
-    pl_sb_free(ptVulkanDevice->_sbtFrameGarbage);
+    pl_sb_free(ptVulkanDevice->sbuFreeBufferIndices);
+    pl_sb_free(ptVulkanDevice->sbuFreeTextureIndices);
+    pl_sb_free(ptVulkanDevice->sbuStreamedTextures);
     pl_sb_free(ptVulkanGfx->sbFrames);
     pl_sb_free(ptVulkanGfx->tSwapchain.sbtSurfaceFormats);
     pl_sb_free(ptVulkanGfx->tSwapchain.sbtImages);
     pl_sb_free(ptVulkanGfx->tSwapchain.sbtFrameBuffers);
     pl_sb_free(ptVulkanGfx->tSwapchain.sbtImageViews);
     pl_sb_free(ptGraphics->tDevice.sbtBuffers);
+    pl_sb_free(ptGraphics->tDevice.sbtTextures);
     PL_FREE(ptGraphics->_pInternalData);
     PL_FREE(ptGraphics->tDevice._pInternalData);
 }
 
+static plVec4
+pl__normalize_plane(float fA, float fB, float fC, float fD)
+{
+    const float fLength = sqrtf(fA * fA + fB * fB + fC * fC);
+    const float fInvLength = fLength > 0.0f ? 1.0f / fLength : 0.0f;
+    plVec4 tPlane;
+    tPlane.x = fA * fInvLength;
+    tPlane.y = fB * fInvLength;
+    tPlane.z = fC * fInvLength;
+    tPlane.w = fD * fInvLength;
+    return tPlane;
+}
+
+static void
+pl_cull_areas(plGraphics* ptGraphics, const plCullDesc* ptDesc, uint32_t uAreaCount, plDrawArea* atAreas, const plDraw* atDraws)
+{
+    pl_begin_profile_sample(__FUNCTION__);
+
+    plVulkanGraphics* ptVulkanGfx = ptGraphics->_pInternalData;
+    plVulkanDevice*   ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+    plVulkanCulling*  ptCulling = &ptVulkanGfx->tCulling;
+
+    PL_ASSERT(ptVulkanGfx->uActiveRenderTarget == PL_RENDER_TARGET_NONE && !ptVulkanGfx->bInMainPass && "cull_areas must be recorded outside of render passes");
+    PL_ASSERT(ptCulling->uPassCount < PL_VULKAN_MAX_CULL_PASSES && "too many cull_areas calls this frame");
+
+    uint32_t uDrawCount = 0;
+    VkDeviceSize szOutputSize = 0;
+    for(uint32_t i = 0; i < uAreaCount; i++)
+    {
+        // survivor count followed by room for every draw
+        uDrawCount += atAreas[i].uDrawCount;
+        szOutputSize += sizeof(uint32_t) + atAreas[i].uDrawCount * sizeof(VkDrawIndexedIndirectCommand);
+    }
+
+    // firstInstance carries the instance index, without it areas are drawn unculled
+    if(uDrawCount == 0 || ptCulling->uPassCount >= PL_VULKAN_MAX_CULL_PASSES || !ptVulkanDevice->tDeviceFeatures.drawIndirectFirstInstance)
+    {
+        pl_end_profile_sample();
+        return;
+    }
+
+    const VkCommandBuffer tCmdBuf = pl_get_frame_resources(ptGraphics)->tCmdBuf;
+    const bool bFirstPass = ptCulling->uPassCount == 0;
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~output~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // out of room, grow to at least twice this frame's usage so this only
+    // happens during warm up
+    VkBuffer tOldOutputBuffer = VK_NULL_HANDLE;
+    if(ptCulling->szOutputOffset + szOutputSize > ptCulling->szOutputSize)
+    {
+        VkDeviceSize szNewSize = ptCulling->szOutputSize * 2;
+        while(szNewSize < (ptCulling->szOutputOffset + szOutputSize) * 2)
+            szNewSize *= 2;
+        pl_log_warn_to_f(uLogChannel, "growing cull output buffer to %u bytes", (uint32_t)szNewSize);
+        tOldOutputBuffer = ptCulling->tOutputBuffer;
+        pl__create_cull_output(ptGraphics, szNewSize);
+    }
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~input~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // one allocation, the dynamic buffer doesn't keep contents when it grows
+    const VkDeviceSize szInputSize = sizeof(plVulkanCullView) + uDrawCount * sizeof(plVulkanCullDraw);
+    const VkDeviceSize szInputOffset = pl__allocate_dynamic_data(ptGraphics, szInputSize);
+    plVulkanCullView* ptView = (plVulkanCullView*)&ptVulkanGfx->tDynamicBuffer.pucMapping[szInputOffset];
+    plVulkanCullDraw* atInputDraws = (plVulkanCullDraw*)&ptView[1];
+
+    // frustum planes (Gribb & Hartmann), clip space depth is [0, 1]
+    const plMat4* ptM = &ptDesc->tViewProjection;
+    ptView->tViewProjection = *ptM;
+    ptView->atPlanes[0] = pl__normalize_plane(ptM->col[0].w + ptM->col[0].x, ptM->col[1].w + ptM->col[1].x, ptM->col[2].w + ptM->col[2].x, ptM->col[3].w + ptM->col[3].x); // left
+    ptView->atPlanes[1] = pl__normalize_plane(ptM->col[0].w - ptM->col[0].x, ptM->col[1].w - ptM->col[1].x, ptM->col[2].w - ptM->col[2].x, ptM->col[3].w - ptM->col[3].x); // right
+    ptView->atPlanes[2] = pl__normalize_plane(ptM->col[0].w + ptM->col[0].y, ptM->col[1].w + ptM->col[1].y, ptM->col[2].w + ptM->col[2].y, ptM->col[3].w + ptM->col[3].y); // bottom
+    ptView->atPlanes[3] = pl__normalize_plane(ptM->col[0].w - ptM->col[0].y, ptM->col[1].w - ptM->col[1].y, ptM->col[2].w - ptM->col[2].y, ptM->col[3].w - ptM->col[3].y); // top
+    ptView->atPlanes[4] = pl__normalize_plane(ptM->col[0].z, ptM->col[1].z, ptM->col[2].z, ptM->col[3].z);                                                                 // near
+    ptView->atPlanes[5] = pl__normalize_plane(ptM->col[0].w - ptM->col[0].z, ptM->col[1].w - ptM->col[1].z, ptM->col[2].w - ptM->col[2].z, ptM->col[3].w - ptM->col[3].z); // far
+
+    // occlusion uses the pyramid built from the target's last pass, spheres
+    // are projected with the view that pass was rendered with
+    plVulkanRenderTarget* ptOccluder = NULL;
+    if(ptDesc->uOcclusionTarget != PL_RENDER_TARGET_NONE)
+    {
+        plVulkanRenderTarget* ptTarget = &ptVulkanGfx->sbtRenderTargets[ptDesc->uOcclusionTarget - 1];
+        PL_ASSERT(ptTarget->tPyramidImage && "occlusion target wasn't created with bDepthPyramid");
+        if(ptTarget->bPyramidBuilt && ptTarget->bPyramidView)
+            ptOccluder = ptTarget;
+        ptTarget->tPendingViewProjection = ptDesc->tViewProjection;
+        ptTarget->bPendingView = true;
+    }
+    ptView->auPyramidInfo[0] = ptOccluder ? ptOccluder->tExtent.width : 0;
+    ptView->auPyramidInfo[1] = ptOccluder ? ptOccluder->tExtent.height : 0;
+    ptView->auPyramidInfo[2] = ptOccluder ? ptOccluder->uPyramidLevels : 0;
+    ptView->auPyramidInfo[3] = 0;
+    ptView->tPyramidViewProjection = ptOccluder ? ptOccluder->tPyramidViewProjection : *ptM;
+
+    VkDeviceSize szOutputOffset = ptCulling->szOutputOffset;
+    uint32_t uInputDraw = 0;
+    for(uint32_t i = 0; i < uAreaCount; i++)
+    {
+        plDrawArea* ptArea = &atAreas[i];
+
+        const plVulkanCullRecord tRecord = {
+            .tBuffer         = ptCulling->tOutputBuffer,
+            .szCountOffset   = szOutputOffset,
+            .szCommandOffset = szOutputOffset + sizeof(uint32_t),
+            .uMaxDraws       = ptArea->uDrawCount
+        };
+        ptArea->_ulCullFrame = ptVulkanDevice->ulFrameCount;
+        ptArea->_uCullRecord = pl_sb_size(ptCulling->sbtRecords);
+        pl_sb_push(ptCulling->sbtRecords, tRecord);
+
+        for(uint32_t j = 0; j < ptArea->uDrawCount; j++)
+        {
+            const plDraw* ptDraw = &atDraws[ptArea->uDrawOffset + j];
+            const plMesh* ptMesh = ptDraw->ptMesh;
+            PL_ASSERT(ptMesh->uVertexBuffer == atDraws[ptArea->uDrawOffset].ptMesh->uVertexBuffer && "draws of a culled area must share a vertex buffer");
+            PL_ASSERT(ptMesh->uIndexBuffer == atDraws[ptArea->uDrawOffset].ptMesh->uIndexBuffer && "draws of a culled area must share an index buffer");
+
+            atInputDraws[uInputDraw++] = (plVulkanCullDraw){
+                .tBoundingSphere = ptDraw->tBoundingSphere,
+                .uIndexCount     = ptMesh->uIndexCount,
+                .uFirstIndex     = ptMesh->uIndexOffset,
+                .iVertexOffset   = (int32_t)ptMesh->uVertexOffset,
+                .uFirstInstance  = ptDraw->uInstanceIndex,
+                .uCountOffset    = (uint32_t)(tRecord.szCountOffset / sizeof(uint32_t)),
+                .uCommandOffset  = (uint32_t)(tRecord.szCommandOffset / sizeof(uint32_t))
+            };
+        }
+        szOutputOffset += sizeof(uint32_t) + ptArea->uDrawCount * sizeof(VkDrawIndexedIndirectCommand);
+    }
+    pl__flush_dynamic_data(ptGraphics, szInputOffset, szInputSize);
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~set~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // this context's sets are no longer in use once its fence was waited on
+    const VkDescriptorSet tSet = ptCulling->aatSets[ptVulkanGfx->szCurrentFrameIndex][ptCulling->uPassCount];
+    const VkDescriptorBufferInfo atBufferInfos[] = {
+        { .buffer = ptVulkanGfx->tDynamicBuffer.tBuffer, .offset = 0, .range = VK_WHOLE_SIZE },
+        { .buffer = ptCulling->tOutputBuffer,            .offset = 0, .range = VK_WHOLE_SIZE }
+    };
+    const VkDescriptorImageInfo tPyramidInfo = {
+        .imageView   = ptOccluder ? ptOccluder->tPyramidView : ptVulkanDevice->tBindless.tDefaultImageView,
+        .imageLayout = ptOccluder ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    };
+    const VkWriteDescriptorSet atWrites[] = {
+        { .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, .dstSet = tSet, .dstBinding = 0, .descriptorCount = 1, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         .pBufferInfo = &atBufferInfos[0] },
+        { .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, .dstSet = tSet, .dstBinding = 1, .descriptorCount = 1, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         .pBufferInfo = &atBufferInfos[1] },
+        { .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, .dstSet = tSet, .dstBinding = 2, .descriptorCount = 1, .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .pImageInfo  = &tPyramidInfo }
+    };
+    vkUpdateDescriptorSets(ptVulkanDevice->tLogicalDevice, 3, atWrites, 0, NULL);
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~record~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    // previous indirect reads & survivor writes of these ranges finish first
+    const VkMemoryBarrier tClearBarrier = {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT
+    };
+    vkCmdPipelineBarrier(tCmdBuf, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 1, &tClearBarrier, 0, NULL, 0, NULL);
+
+    // frame total lives in the header, carried over if the buffer grew mid frame
+    if(tOldOutputBuffer && !bFirstPass)
+    {
+        const VkBufferCopy tHeaderCopy = { .size = sizeof(uint32_t) };
+        vkCmdCopyBuffer(tCmdBuf, tOldOutputBuffer, ptCulling->tOutputBuffer, 1, &tHeaderCopy);
+    }
+    else if(bFirstPass)
+        vkCmdFillBuffer(tCmdBuf, ptCulling->tOutputBuffer, 0, 16, 0);
+
+    // cleared slots past the survivors are empty draws
+    vkCmdFillBuffer(tCmdBuf, ptCulling->tOutputBuffer, ptCulling->szOutputOffset, szOutputSize, 0);
+
+    const VkMemoryBarrier tDispatchBarrier = {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+    };
+    vkCmdPipelineBarrier(tCmdBuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &tDispatchBarrier, 0, NULL, 0, NULL);
+
+    const plVulkanCullConstants tConstants = {
+        .uViewOffset = (uint32_t)(szInputOffset / 16),
+        .uDrawOffset = (uint32_t)((szInputOffset + sizeof(plVulkanCullView)) / 16),
+        .uDrawCount  = uDrawCount,
+        .uFlags      = ptOccluder ? PL_VULKAN_CULL_FLAG_OCCLUSION : 0
+    };
+    vkCmdBindPipeline(tCmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, ptCulling->tPipeline);
+    vkCmdBindDescriptorSets(tCmdBuf, VK_PIPELINE_BIND_POINT_COMPUTE, ptCulling->tPipelineLayout, 0, 1, &tSet, 0, NULL);
+    vkCmdPushConstants(tCmdBuf, ptCulling->tPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(plVulkanCullConstants), &tConstants);
+    vkCmdDispatch(tCmdBuf, (uDrawCount + PL_VULKAN_CULL_GROUP_SIZE - 1) / PL_VULKAN_CULL_GROUP_SIZE, 1, 1);
+
+    // commands & counts are consumed by draw_areas & the stats copy
+    const VkMemoryBarrier tIndirectBarrier = {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT
+    };
+    vkCmdPipelineBarrier(tCmdBuf, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &tIndirectBarrier, 0, NULL, 0, NULL);
+
+    ptCulling->szOutputOffset = szOutputOffset;
+    ptCulling->auInputDraws[ptVulkanGfx->szCurrentFrameIndex] += uDrawCount;
+    ptCulling->uPassCount++;
+
+    pl_end_profile_sample();
+}
+
+static void
+pl__bind_mesh_buffers(plGraphics* ptGraphics, VkCommandBuffer tCmdBuf, const plMesh* ptMesh)
+{
+    plVulkanDevice* ptVulkanDevice = ptGraphics->tDevice._pInternalData;
+
+    plVulkanBuffer* ptVertexBuffer = ptGraphics->tDevice.sbtBuffers[ptMesh->uVertexBuffer].pBuffer;
+    plVulkanBuffer* ptIndexBuffer = ptGraphics->tDevice.sbtBuffers[ptMesh->uIndexBuffer].pBuffer;
+
+    // position only meshes never read binding 1, it just can't be left unbound
+    const bool bHasAttributes = pl_get_vertex_attribute_stride(ptMesh->ulVertexStreamMask) > 0;
+    const VkBuffer atVertexBuffers[2] = {
+        ptVertexBuffer->tBuffer,
+        bHasAttributes ? ((plVulkanBuffer*)ptGraphics->tDevice.sbtBuffers[ptMesh->uAttributeBuffer].pBuffer)->tBuffer : ptVulkanDevice->tBindless.tDefaultBuffer
+    };
+    const VkDeviceSize atOffsets[2] = {0};
+    vkCmdBindIndexBuffer(tCmdBuf, ptIndexBuffer->tBuffer, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdBindVertexBuffers(tCmdBuf, 0, 2, atVertexBuffers, atOffsets);
+}
+
 static void
 pl_draw_areas(plGraphics* ptGraphics, uint32_t uAreaCount, plDrawArea* atAreas, plDraw* atDraws)
 {
@@ -3098,19 +7939,84 @@ pl_draw_areas(plGraphics* ptGraphics, uint32_t uAreaCount, plDrawArea* atAreas,
     static VkDeviceSize offsets = { 0 };
     vkCmdSetDepthBias(ptCurrentFrame->tCmdBuf, 0.0f, 0.0f, 0.0f);
     vkCmdBindPipeline(ptCurrentFrame->tCmdBuf, VK_PIPELINE_BIND_POINT_GRAPHICS, ptVulkanGfx->g_pipeline);
+    VkPipeline tBoundPipeline = ptVulkanGfx->g_pipeline;
+
+    // every texture & storage buffer is reachable through the global set, so
+    // draws only push indices
+    const plVulkanBindlessHeap* ptHeap = &ptVulkanDevice->tBindless;
+    const VkDescriptorSet tGlobalSet = ptHeap->atSets[ptHeap->bDescriptorIndexing ? 0 : ptVulkanGfx->szCurrentFrameIndex];
+    vkCmdBindDescriptorSets(ptCurrentFrame->tCmdBuf, VK_PIPELINE_BIND_POINT_GRAPHICS, ptVulkanGfx->g_pipelineLayout, 0, 1, &tGlobalSet, 0, NULL);
+
+    // streams a variant reads but a mesh doesn't provide come from the zeroed default buffer
+    vkCmdBindVertexBuffers(ptCurrentFrame->tCmdBuf, 2, 1, &ptHeap->tDefaultBuffer, &offsets);
 
     for(uint32_t i = 0; i < uAreaCount; i++)
     {
         plDrawArea* ptArea = &atAreas[i];
 
+        const uint32_t uBufferCount = pl_sb_size(ptGraphics->tDevice.sbtBuffers);
+        const plVulkanBuffer* ptMaterialBuffer = ptArea->uMaterialBuffer < uBufferCount ? ptGraphics->tDevice.sbtBuffers[ptArea->uMaterialBuffer].pBuffer : NULL;
+        const plVulkanBuffer* ptInstanceBuffer = ptArea->uInstanceBuffer < uBufferCount ? ptGraphics->tDevice.sbtBuffers[ptArea->uInstanceBuffer].pBuffer : NULL;
+        plVulkanDrawConstants tConstants = {
+            .tViewProjection = ptArea->ptViewProjection ? *ptArea->ptViewProjection : pl_identity_mat4(),
+            .uMaterialBuffer = ptMaterialBuffer ? ptMaterialBuffer->uBindlessSlot : 0,
+            .uInstanceBuffer = ptInstanceBuffer ? ptInstanceBuffer->uBindlessSlot : 0
+        };
+
+        // culled this frame, survivors were compacted by cull_areas
+        if(ptArea->_ulCullFrame == ptVulkanDevice->ulFrameCount && ptArea->uDrawCount > 0)
+        {
+            const plVulkanCulling*    ptCulling = &ptVulkanGfx->tCulling;
+            const plVulkanCullRecord* ptRecord = &ptCulling->sbtRecords[ptArea->_uCullRecord];
+            const plMesh*             ptMesh = atDraws[ptArea->uDrawOffset].ptMesh;
+
+            const VkPipeline tPipeline = pl__get_variant_pipeline(ptGraphics, atDraws[ptArea->uDrawOffset].uShaderVariant);
+            if(tPipeline != tBoundPipeline)
+            {
+                vkCmdBindPipeline(ptCurrentFrame->tCmdBuf, VK_PIPELINE_BIND_POINT_GRAPHICS, tPipeline);
+                tBoundPipeline = tPipeline;
+            }
+
+            tConstants.uMaterialIndex = UINT32_MAX;
+            tConstants.uInstanceIndex = UINT32_MAX;
+            vkCmdPushConstants(ptCurrentFrame->tCmdBuf, ptVulkanGfx->g_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(plVulkanDrawConstants), &tConstants);
+
+            pl__bind_mesh_buffers(ptGraphics, ptCurrentFrame->tCmdBuf, ptMesh);
+
+            const uint32_t uMaxDrawCount = ptVulkanDevice->tDeviceFeatures.multiDrawIndirect ? ptVulkanDevice->tDeviceProps.limits.maxDrawIndirectCount : 1;
+            if(ptCulling->vkCmdDrawIndexedIndirectCount && ptRecord->uMaxDraws <= uMaxDrawCount)
+            {
+                ptCulling->vkCmdDrawIndexedIndirectCount(ptCurrentFrame->tCmdBuf, ptRecord->tBuffer, ptRecord->szCommandOffset,
+                    ptRecord->tBuffer, ptRecord->szCountOffset, ptRecord->uMaxDraws, sizeof(VkDrawIndexedIndirectCommand));
+            }
+            else
+            {
+                // every slot is drawn, slots past the survivors are empty draws
+                for(uint32_t uFirstDraw = 0; uFirstDraw < ptRecord->uMaxDraws; uFirstDraw += uMaxDrawCount)
+                {
+                    vkCmdDrawIndexedIndirect(ptCurrentFrame->tCmdBuf, ptRecord->tBuffer, ptRecord->szCommandOffset + uFirstDraw * sizeof(VkDrawIndexedIndirectCommand),
+                        pl_minu(uMaxDrawCount, ptRecord->uMaxDraws - uFirstDraw), sizeof(VkDrawIndexedIndirectCommand));
+                }
+            }
+            continue;
+        }
+
         for(uint32_t j = 0; j < ptArea->uDrawCount; j++)
         {
-            plDraw* ptDraw = &atDraws[ptArea->uDrawOffset];
+            plDraw* ptDraw = &atDraws[ptArea->uDrawOffset + j];
+
+            const VkPipeline tPipeline = pl__get_variant_pipeline(ptGraphics, ptDraw->uShaderVariant);
+            if(tPipeline != tBoundPipeline)
+            {
+                vkCmdBindPipeline(ptCurrentFrame->tCmdBuf, VK_PIPELINE_BIND_POINT_GRAPHICS, tPipeline);
+                tBoundPipeline = tPipeline;
+            }
+
+            tConstants.uMaterialIndex = ptDraw->uMaterialIndex;
+            tConstants.uInstanceIndex = ptDraw->uInstanceIndex;
+            vkCmdPushConstants(ptCurrentFrame->tCmdBuf, ptVulkanGfx->g_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(plVulkanDrawConstants), &tConstants);
 
-            plVulkanBuffer* ptVertexBuffer = ptGraphics->tDevice.sbtBuffers[ptDraw->ptMesh->uVertexBuffer].pBuffer;
-            plVulkanBuffer* ptIndexBuffer = ptGraphics->tDevice.sbtBuffers[ptDraw->ptMesh->uIndexBuffer].pBuffer;
-            vkCmdBindIndexBuffer(ptCurrentFrame->tCmdBuf, ptIndexBuffer->tBuffer, 0, VK_INDEX_TYPE_UINT32);
-            vkCmdBindVertexBuffers(ptCurrentFrame->tCmdBuf, 0, 1, &ptVertexBuffer->tBuffer, &offsets);
+            pl__bind_mesh_buffers(ptGraphics, ptCurrentFrame->tCmdBuf, ptDraw->ptMesh);
             vkCmdDrawIndexed(ptCurrentFrame->tCmdBuf, ptDraw->ptMesh->uIndexCount, 1, 0, 0, 0);
         }
         
@@ -3125,27 +8031,45 @@ static const plGraphicsI*
 pl_load_graphics_api(void)
 {
     static const plGraphicsI tApi = {
-        .initialize               = pl_initialize_graphics,
-        .resize                   = pl_resize,
-        .begin_frame              = pl_begin_frame,
-        .end_frame                = pl_end_gfx_frame,
-        .begin_recording          = pl_begin_recording,
-        .end_recording            = pl_end_recording,
-        .draw_areas               = pl_draw_areas,
-        .draw_lists               = pl_draw_list,
-        .cleanup                  = pl_shutdown,
-        .create_font_atlas        = pl_create_vulkan_font_texture,
-        .destroy_font_atlas       = pl_cleanup_vulkan_font_texture,
-        .add_3d_triangle_filled   = pl__add_3d_triangle_filled,
-        .add_3d_line              = pl__add_3d_line,
-        .add_3d_point             = pl__add_3d_point,
-        .add_3d_transform         = pl__add_3d_transform,
-        .add_3d_frustum           = pl__add_3d_frustum,
-        .add_3d_centered_box      = pl__add_3d_centered_box,
-        .add_3d_bezier_quad       = pl__add_3d_bezier_quad,
-        .add_3d_bezier_cubic      = pl__add_3d_bezier_cubic,
-        .register_3d_drawlist     = pl__register_3d_drawlist,
-        .submit_3d_drawlist       = pl__submit_3d_drawlist
+        .initialize                       = pl_initialize_graphics,
+        .resize                           = pl_resize,
+        .begin_frame                      = pl_begin_frame,
+        .end_frame                        = pl_end_gfx_frame,
+        .begin_recording                  = pl_begin_recording,
+        .end_recording                    = pl_end_recording,
+        .set_frames_in_flight             = pl_set_frames_in_flight,
+        .set_low_latency                  = pl_set_low_latency,
+        .set_swapchain                    = pl_set_swapchain,
+        .reload_shaders                   = pl_reload_shaders,
+        .request_shader_variant           = pl_request_shader_variant,
+        .is_shader_variant_ready          = pl_is_shader_variant_ready,
+        .draw_areas                       = pl_draw_areas,
+        .cull_areas                       = pl_cull_areas,
+        .draw_lists                       = pl_draw_list,
+        .cleanup                          = pl_shutdown,
+        .create_font_atlas                = pl_create_vulkan_font_texture,
+        .destroy_font_atlas               = pl_cleanup_vulkan_font_texture,
+        .add_3d_triangle_filled           = pl__add_3d_triangle_filled,
+        .add_3d_line                      = pl__add_3d_line,
+        .add_3d_point                     = pl__add_3d_point,
+        .add_3d_transform                 = pl__add_3d_transform,
+        .add_3d_frustum                   = pl__add_3d_frustum,
+        .add_3d_centered_box              = pl__add_3d_centered_box,
+        .add_3d_bezier_quad               = pl__add_3d_bezier_quad,
+        .add_3d_bezier_cubic              = pl__add_3d_bezier_cubic,
+        .register_3d_drawlist             = pl__register_3d_drawlist,
+        .submit_3d_drawlist               = pl__submit_3d_drawlist,
+        .add_graph_texture                = pl__add_graph_texture,
+        .add_graph_pass                   = pl__add_graph_pass,
+        .get_graph_texture_bindless_index = pl_get_graph_texture_bindless_index,
+        .create_render_target             = pl_create_render_target,
+        .destroy_render_target            = pl_destroy_render_target,
+        .begin_render_target              = pl_begin_render_target,
+        .end_render_target                = pl_end_render_target,
+        .request_readback                 = pl_request_readback,
+        .get_readback                     = pl_get_readback,
+        .release_readback                 = pl_release_readback,
+        .get_render_target_bindless_index = pl_get_render_target_bindless_index
     };
     return &tApi;
 }
@@ -3154,8 +8078,20 @@ static const plDeviceI*
 pl_load_device_api(void)
 {
     static const plDeviceI tApi = {
-        .create_index_buffer  = pl_create_index_buffer,
-        .create_vertex_buffer = pl_create_vertex_buffer
+        .create_index_buffer        = pl_create_index_buffer,
+        .create_vertex_buffer       = pl_create_vertex_buffer,
+        .create_storage_buffer      = pl_create_storage_buffer,
+        .update_buffer              = pl_update_buffer,
+        .destroy_buffer             = pl_destroy_buffer,
+        .is_format_supported        = pl_is_format_supported,
+        .create_texture             = pl_create_texture,
+        .update_texture             = pl_update_texture,
+        .destroy_texture            = pl_destroy_texture,
+        .create_streamed_texture    = pl_create_streamed_texture,
+        .request_texture_resolution = pl_request_texture_resolution,
+        .set_texture_budget         = pl_set_texture_budget,
+        .get_bindless_index         = pl_get_bindless_index,
+        .get_texture_bindless_index = pl_get_texture_bindless_index
     };
     return &tApi;
 }
@@ -3169,6 +8105,8 @@ pl_load_ext(plApiRegistryApiI* ptApiRegistry, bool bReload)
     pl_set_log_context(ptDataRegistry->get_data("log"));
     pl_set_context(ptDataRegistry->get_data("ui"));
     gptFile = ptApiRegistry->first(PL_API_FILE);
+    gptStats = ptApiRegistry->first(PL_API_STATS);
+    gptThreads = ptApiRegistry->first(PL_API_THREADS);
     if(bReload)
     {
         ptApiRegistry->replace(ptApiRegistry->first(PL_API_GRAPHICS), pl_load_graphics_api());
@@ -119,10 +119,12 @@ with pl.project("pilotlight"):
     add_plugin_to_vulkan_app("pl_image_ext", False)
     add_plugin_to_vulkan_app("pl_vulkan_ext", False, "pl_graphics_ext")
     add_plugin_to_vulkan_app("pl_stats_ext", False)
+    add_plugin_to_vulkan_app("pl_ecs_ext", False)
 
     add_plugin_to_metal_app("pl_debug_ext", False)
     add_plugin_to_metal_app("pl_image_ext", False)
     add_plugin_to_metal_app("pl_stats_ext", False)
+    add_plugin_to_metal_app("pl_ecs_ext", False)
     add_plugin_to_metal_app("pl_metal_ext", False, True, "pl_graphics_ext")
 
     pl.pop_target_links()
@@ -140,7 +142,7 @@ with pl.project("pilotlight"):
         
         with pl.configuration("debug"):
             pl.push_profile(pl.Profile.VULKAN)
-            pl.push_vulkan_glsl_files("../shaders/glsl/", "primitive.frag", "primitive.vert")
+            pl.push_vulkan_glsl_files("../shaders/glsl/", "primitive.frag", "primitive.vert", "draw_3d.vert", "draw_3d.frag", "draw_3d_line.vert", "cull.comp", "depth_pyramid.comp", "depth_pyramid_ms.comp", "mesh.vert", "mesh.frag")
             with pl.platform(pl.PlatformType.WIN32):
                 with pl.compiler("msvc", pl.CompilerType.MSVC):
                     pl.add_definition("PL_VULKAN_BACKEND")
@@ -155,7 +157,7 @@ with pl.project("pilotlight"):
         
         
         pl.push_profile(pl.Profile.VULKAN)
-        pl.push_vulkan_glsl_files("../shaders/glsl/", "primitive.frag", "primitive.vert")
+        pl.push_vulkan_glsl_files("../shaders/glsl/", "primitive.frag", "primitive.vert", "draw_3d.vert", "draw_3d.frag", "draw_3d_line.vert", "cull.comp", "depth_pyramid.comp", "depth_pyramid_ms.comp", "mesh.vert", "mesh.frag")
         with pl.configuration("vulkan"):
             with pl.platform(pl.PlatformType.MACOS):
                 with pl.compiler("clang", pl.CompilerType.CLANG):
@@ -167,6 +169,36 @@ with pl.project("pilotlight"):
         pl.pop_output_binary()
         pl.pop_target_links()
 
+    ###############################################################################
+    #                                  benchmark                                  #
+    ###############################################################################
+    with pl.target("benchmark", pl.TargetType.DYNAMIC_LIBRARY, True):
+
+        pl.push_output_binary("benchmark")
+        pl.push_target_links("pilotlight_lib")
+
+        pl.push_source_files("../apps/benchmark.c")
+        
+        with pl.configuration("debug"):
+            with pl.platform(pl.PlatformType.WIN32):
+                with pl.compiler("msvc", pl.CompilerType.MSVC):
+                    pl.add_definition("PL_VULKAN_BACKEND")
+            with pl.platform(pl.PlatformType.LINUX):
+                with pl.compiler("gcc", pl.CompilerType.GCC):
+                    pl.add_definition("PL_VULKAN_BACKEND")
+            with pl.platform(pl.PlatformType.MACOS):
+                with pl.compiler("clang", pl.CompilerType.CLANG):
+                    pl.add_definition("PL_METAL_BACKEND")
+
+        with pl.configuration("vulkan"):
+            with pl.platform(pl.PlatformType.MACOS):
+                with pl.compiler("clang", pl.CompilerType.CLANG):
+                    pl.add_definition("PL_VULKAN_BACKEND")
+
+        pl.pop_source_files()
+        pl.pop_output_binary()
+        pl.pop_target_links()
+
     ###############################################################################
     #                                 pilot_light                                 #
     ###############################################################################
@@ -0,0 +1,58 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// specialized per shader variant (see request_shader_variant in pl_vulkan_ext.c)
+layout(constant_id = 0) const uint PL_VERTEX_STREAM_MASK = 1; // PL_MESH_FORMAT_FLAG_*
+layout(constant_id = 1) const uint PL_TEXTURE_FLAGS      = 0; // PL_SHADER_TEXTURE_FLAG_*
+layout(constant_id = 2) const uint PL_TEXTURE_SLOTS      = 1; // bindless array sizes
+layout(constant_id = 3) const uint PL_BUFFER_SLOTS       = 1;
+
+const uint PL_MESH_FORMAT_FLAG_HAS_NORMAL     = 1 << 1;
+const uint PL_MESH_FORMAT_FLAG_HAS_TEXCOORD_0 = 1 << 3;
+
+// global bindless set
+layout(set = 0, binding = 0) uniform sampler tSampler;
+layout(set = 0, binding = 1) uniform texture2D atTextures[PL_TEXTURE_SLOTS];
+layout(set = 0, binding = 2) readonly buffer plStorage { uvec4 atData[]; } atBuffers[PL_BUFFER_SLOTS];
+
+layout(push_constant) uniform plDrawConstants
+{
+    mat4 tViewProjection;
+    uint uMaterialBuffer;
+    uint uInstanceBuffer;
+    uint uMaterialIndex;
+    uint uInstanceIndex;
+} tConstants;
+
+layout(location = 0) in vec3 inNormal;
+layout(location = 1) in vec2 inTexCoord0;
+layout(location = 2) in vec4 inColor;
+layout(location = 3) flat in uint inMaterial;
+
+layout(location = 0) out vec4 outColor;
+
+void main() 
+{
+    // plMaterialData, 2 uvec4s: color & bindless texture slots
+    uvec4 tColorBits = atBuffers[tConstants.uMaterialBuffer].atData[inMaterial * 2];
+    uvec4 tTextures  = atBuffers[tConstants.uMaterialBuffer].atData[inMaterial * 2 + 1];
+    vec4 tColor = inColor * uintBitsToFloat(tColorBits);
+
+    // every bound texture modulates the color (default slot 0 is white)
+    if((PL_VERTEX_STREAM_MASK & PL_MESH_FORMAT_FLAG_HAS_TEXCOORD_0) != 0)
+    {
+        for(uint i = 0; i < 4; i++)
+        {
+            if((PL_TEXTURE_FLAGS & (1 << i)) != 0)
+                tColor *= texture(sampler2D(atTextures[tTextures[i]], tSampler), inTexCoord0);
+        }
+    }
+
+    // fixed directional light, only for formats with normals
+    if((PL_VERTEX_STREAM_MASK & PL_MESH_FORMAT_FLAG_HAS_NORMAL) != 0)
+    {
+        float fLight = max(dot(normalize(inNormal), normalize(vec3(0.3, 1.0, 0.5))), 0.0);
+        tColor.rgb *= 0.35 + 0.65 * fLight;
+    }
+    outColor = tColor;
+}
@@ -0,0 +1,63 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// specialized per shader variant (see request_shader_variant in pl_vulkan_ext.c),
+// streams missing from the variant are never read
+layout(constant_id = 0) const uint PL_VERTEX_STREAM_MASK = 1; // PL_MESH_FORMAT_FLAG_*
+layout(constant_id = 1) const uint PL_TEXTURE_FLAGS      = 0; // PL_SHADER_TEXTURE_FLAG_*
+layout(constant_id = 3) const uint PL_BUFFER_SLOTS       = 1; // bindless array size
+
+const uint PL_MESH_FORMAT_FLAG_HAS_NORMAL     = 1 << 1;
+const uint PL_MESH_FORMAT_FLAG_HAS_TEXCOORD_0 = 1 << 3;
+const uint PL_MESH_FORMAT_FLAG_HAS_COLOR_0    = 1 << 5;
+
+// locations follow the PL_MESH_FORMAT_FLAG_* bits, attributes are quantized
+// (see [SECTION] vertex layout of pl_graphics.inl)
+layout(location = 0) in vec3 inPos;
+layout(location = 1) in vec2 inNormal; // octahedral
+layout(location = 3) in vec2 inTexCoord0;
+layout(location = 5) in vec4 inColor0;
+
+layout(location = 0) out vec3 outNormal;
+layout(location = 1) out vec2 outTexCoord0;
+layout(location = 2) out vec4 outColor;
+layout(location = 3) flat out uint outMaterial;
+
+// global bindless set
+layout(set = 0, binding = 2) readonly buffer plStorage { uvec4 atData[]; } atBuffers[PL_BUFFER_SLOTS];
+
+layout(push_constant) uniform plDrawConstants
+{
+    mat4 tViewProjection; // identity unless the area has one
+    uint uMaterialBuffer;
+    uint uInstanceBuffer; // 0 -> no instances, identity model
+    uint uMaterialIndex; // culled draws read it from their instance
+    uint uInstanceIndex; // culled draws use firstInstance
+} tConstants;
+
+vec3 pl_decode_octahedral(vec2 tEncoded)
+{
+    vec3 tN = vec3(tEncoded, 1.0 - abs(tEncoded.x) - abs(tEncoded.y));
+    float fT = max(-tN.z, 0.0);
+    tN.x += tN.x >= 0.0 ? -fT : fT;
+    tN.y += tN.y >= 0.0 ? -fT : fT;
+    return normalize(tN);
+}
+
+void main() 
+{
+    // plInstanceData, 5 uvec4s: model matrix (columns) & material
+    uint uInstance = tConstants.uInstanceIndex == 0xFFFFFFFF ? gl_InstanceIndex : tConstants.uInstanceIndex;
+    mat4 tModel = mat4(1.0);
+    if(tConstants.uInstanceBuffer != 0)
+    {
+        for(uint i = 0; i < 4; i++)
+            tModel[i] = uintBitsToFloat(atBuffers[tConstants.uInstanceBuffer].atData[uInstance * 5 + i]);
+    }
+
+    gl_Position  = tConstants.tViewProjection * tModel * vec4(inPos, 1.0);
+    outNormal    = (PL_VERTEX_STREAM_MASK & PL_MESH_FORMAT_FLAG_HAS_NORMAL) != 0 ? normalize(mat3(tModel) * pl_decode_octahedral(inNormal)) : vec3(0.0);
+    outTexCoord0 = (PL_VERTEX_STREAM_MASK & PL_MESH_FORMAT_FLAG_HAS_TEXCOORD_0) != 0 ? inTexCoord0 : vec2(0.0);
+    outColor     = (PL_VERTEX_STREAM_MASK & PL_MESH_FORMAT_FLAG_HAS_COLOR_0) != 0 ? inColor0 : vec4(1.0);
+    outMaterial  = tConstants.uMaterialIndex == 0xFFFFFFFF ? atBuffers[tConstants.uInstanceBuffer].atData[uInstance * 5 + 4].x : tConstants.uMaterialIndex;
+}
@@ -10,6 +10,7 @@ Index of this file:
 // [SECTION] forward declarations & basic types
 // [SECTION] structs
 // [SECTION] enums
+// [SECTION] vertex layout
 */
 
 //-----------------------------------------------------------------------------
@@ -25,6 +26,7 @@ Index of this file:
 
 #define PL_DEVICE_ALLOCATION_BLOCK_SIZE 268435456
 #define PL_DEVICE_LOCAL_LEVELS 8
+#define PL_MESH_FORMAT_STREAM_COUNT 11 // PL_MESH_FORMAT_FLAG_HAS_*
 
 //-----------------------------------------------------------------------------
 // [SECTION] includes
@@ -116,7 +118,7 @@ typedef struct _plGraphicsState
     {
         struct
         {
-            uint64_t ulVertexStreamMask   : 11; // PL_MESH_FORMAT_FLAG_*
+            uint64_t ulVertexStreamMask   : 12; // PL_MESH_FORMAT_FLAG_*
             uint64_t ulDepthMode          :  3; // PL_DEPTH_MODE_
             uint64_t ulDepthWriteEnabled  :  1; // bool
             uint64_t ulCullMode           :  2; // PL_CULL_MODE_*
@@ -128,7 +130,7 @@ typedef struct _plGraphicsState
             uint64_t ulStencilOpFail      :  3; // PL_STENCIL_OP_*
             uint64_t ulStencilOpDepthFail :  3; // PL_STENCIL_OP_*
             uint64_t ulStencilOpPass      :  3; // PL_STENCIL_OP_*
-            uint64_t _ulUnused            : 12;
+            uint64_t _ulUnused            : 11;
         };
         uint64_t ulValue;
     };
@@ -202,7 +204,17 @@ enum _plFormat
     PL_FORMAT_D32_FLOAT,
     PL_FORMAT_D32_FLOAT_S8_UINT,
     PL_FORMAT_D24_UNORM_S8_UINT,
-    PL_FORMAT_D16_UNORM_S8_UINT
+    PL_FORMAT_D16_UNORM_S8_UINT,
+
+    // block compressed (4x4 blocks), sampled only
+    PL_FORMAT_BC1_RGBA_UNORM,
+    PL_FORMAT_BC1_RGBA_SRGB,
+    PL_FORMAT_BC3_UNORM,
+    PL_FORMAT_BC3_SRGB,
+    PL_FORMAT_BC7_UNORM,
+    PL_FORMAT_BC7_SRGB,
+    PL_FORMAT_ASTC_4x4_UNORM,
+    PL_FORMAT_ASTC_4x4_SRGB
 };
 
 enum _plCompareMode
@@ -324,7 +336,8 @@ enum _plMeshFormatFlags
     PL_MESH_FORMAT_FLAG_HAS_JOINTS_0   = 1 << 7,
     PL_MESH_FORMAT_FLAG_HAS_JOINTS_1   = 1 << 8,
     PL_MESH_FORMAT_FLAG_HAS_WEIGHTS_0  = 1 << 9,
-    PL_MESH_FORMAT_FLAG_HAS_WEIGHTS_1  = 1 << 10
+    PL_MESH_FORMAT_FLAG_HAS_WEIGHTS_1  = 1 << 10,
+    PL_MESH_FORMAT_FLAG_JOINTS_16      = 1 << 11  // joints are stored as u16 instead of u8
 };
 
 enum _plShaderTextureFlags
@@ -354,4 +367,46 @@ enum _plDeviceAllocationStatus
     PL_DEVICE_ALLOCATION_STATUS_WASTE
 };
 
+//-----------------------------------------------------------------------------
+// [SECTION] vertex layout
+//-----------------------------------------------------------------------------
+
+/*
+    Positions are a separate float3 stream. Every other stream in the mask is
+    quantized & interleaved (in flag order) into a single attribute stream:
+
+        normal    -> octahedral, 2 x snorm16
+        tangent   -> octahedral, 2 x snorm16 (handedness as the sign of y, with
+                     y remapped to [0.5, 1] so it is never 0)
+        texcoords -> 2 x half
+        colors    -> 4 x unorm8
+        joints    -> 4 x u8 (4 x u16 with PL_MESH_FORMAT_FLAG_JOINTS_16)
+        weights   -> 4 x unorm8
+*/
+
+static inline uint32_t
+pl_get_vertex_attribute_size(uint64_t ulVertexStreamMask, plMeshFormatFlags tStream)
+{
+    if(tStream == PL_MESH_FORMAT_FLAG_HAS_POSITION || (ulVertexStreamMask & tStream) == 0)
+        return 0;
+    if(tStream == PL_MESH_FORMAT_FLAG_HAS_JOINTS_0 || tStream == PL_MESH_FORMAT_FLAG_HAS_JOINTS_1)
+        return (ulVertexStreamMask & PL_MESH_FORMAT_FLAG_JOINTS_16) ? 8 : 4;
+    return 4;
+}
+
+static inline uint32_t
+pl_get_vertex_attribute_offset(uint64_t ulVertexStreamMask, plMeshFormatFlags tStream)
+{
+    uint32_t uOffset = 0;
+    for(uint32_t i = 0; i < PL_MESH_FORMAT_STREAM_COUNT && (1 << i) < tStream; i++)
+        uOffset += pl_get_vertex_attribute_size(ulVertexStreamMask, 1 << i);
+    return uOffset;
+}
+
+static inline uint32_t
+pl_get_vertex_attribute_stride(uint64_t ulVertexStreamMask)
+{
+    return pl_get_vertex_attribute_offset(ulVertexStreamMask, 1 << PL_MESH_FORMAT_STREAM_COUNT);
+}
+
 #endif // PL_GRAPHICS_H
\ No newline at end of file
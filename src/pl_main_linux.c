@@ -22,7 +22,7 @@ Index of this file:
 #include "pl_os.h"      // os services
 
 #include <time.h>     // clock_gettime, clock_getres
-#include <string.h>   // strlen
+#include <string.h>   // strlen, strcmp
 #include <stdlib.h>   // free
 #include <assert.h>
 #include <xcb/xcb.h>
@@ -41,6 +41,8 @@ Index of this file:
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <errno.h>
+#include <pthread.h>      // threads, mutexes, condition variables
+#include <unistd.h>       // sysconf
 
 //-----------------------------------------------------------------------------
 // [SECTION] forward declarations
@@ -54,6 +56,7 @@ plKey pl__xcb_key_to_pl_key(uint32_t x_keycode);
 // os services
 void  pl__read_file            (const char* pcFile, unsigned* puSize, char* pcBuffer, const char* pcMode);
 void  pl__copy_file            (const char* pcSource, const char* pcDestination, unsigned* puSize, char* pcBuffer);
+uint64_t pl__get_file_modified_time(const char* pcFile);
 void  pl__create_udp_socket    (plSocket* ptSocketOut, bool bNonBlocking);
 void  pl__bind_udp_socket      (plSocket* ptSocket, int iPort);
 bool  pl__send_udp_data        (plSocket* ptFromSocket, const char* pcDestIP, int iDestPort, void* pData, size_t szSize);
@@ -63,6 +66,21 @@ bool  pl__load_library         (plSharedLibrary* ptLibrary, const char* pcName,
 void  pl__reload_library       (plSharedLibrary* ptLibrary);
 void* pl__load_library_function(plSharedLibrary* ptLibrary, const char* pcName);
 int   pl__sleep                (uint32_t millisec);
+void  pl__request_exit         (void);
+
+// threads
+uint32_t             pl__get_hardware_thread_count  (void);
+plThread*            pl__create_thread              (plThreadProcedure ptProcedure, void* pData);
+void                 pl__join_thread                (plThread* ptThread);
+plMutex*             pl__create_mutex               (void);
+void                 pl__destroy_mutex              (plMutex* ptMutex);
+void                 pl__lock_mutex                 (plMutex* ptMutex);
+void                 pl__unlock_mutex               (plMutex* ptMutex);
+plConditionVariable* pl__create_condition_variable  (void);
+void                 pl__destroy_condition_variable (plConditionVariable* ptConditionVariable);
+void                 pl__wait_condition_variable    (plConditionVariable* ptConditionVariable, plMutex* ptMutex);
+void                 pl__wake_condition_variable    (plConditionVariable* ptConditionVariable);
+void                 pl__wake_all_condition_variable(plConditionVariable* ptConditionVariable);
 
 static inline time_t
 pl__get_last_write_time(const char* filename)
@@ -78,6 +96,21 @@ typedef struct _plLinuxSharedLibrary
     time_t lastWriteTime;
 } plLinuxSharedLibrary;
 
+typedef struct _plThread
+{
+    pthread_t tHandle;
+} plThread;
+
+typedef struct _plMutex
+{
+    pthread_mutex_t tHandle;
+} plMutex;
+
+typedef struct _plConditionVariable
+{
+    pthread_cond_t tHandle;
+} plConditionVariable;
+
 //-----------------------------------------------------------------------------
 // [SECTION] globals
 //-----------------------------------------------------------------------------
@@ -132,8 +165,15 @@ pl__get_linux_absolute_time(void)
 // [SECTION] entry point
 //-----------------------------------------------------------------------------
 
-int main()
+int main(int argc, char *argv[])
 {
+    // app to load, "-a <name>" loads ./<name>.so
+    const char* pcAppName = "app";
+    for(int i = 1; i < argc - 1; i++)
+    {
+        if(strcmp(argv[i], "-a") == 0)
+            pcAppName = argv[++i];
+    }
 
     gptUiCtx = pl_create_context();
     gptIOCtx = pl_get_io();
@@ -148,8 +188,9 @@ int main()
     };
 
     static const plFileApiI tFileApi = {
-        .copy = pl__copy_file,
-        .read = pl__read_file
+        .copy              = pl__copy_file,
+        .read              = pl__read_file,
+        .get_modified_time = pl__get_file_modified_time
     };
     
     static const plUdpApiI tUdpApi = {
@@ -160,7 +201,23 @@ int main()
     };
 
     static const plOsServicesApiI tOsApi = {
-        .sleep = pl__sleep
+        .sleep        = pl__sleep,
+        .request_exit = pl__request_exit
+    };
+
+    static const plThreadsApiI tThreadsApi = {
+        .get_hardware_thread_count   = pl__get_hardware_thread_count,
+        .create_thread               = pl__create_thread,
+        .join_thread                 = pl__join_thread,
+        .create_mutex                = pl__create_mutex,
+        .destroy_mutex               = pl__destroy_mutex,
+        .lock_mutex                  = pl__lock_mutex,
+        .unlock_mutex                = pl__unlock_mutex,
+        .create_condition_variable   = pl__create_condition_variable,
+        .destroy_condition_variable  = pl__destroy_condition_variable,
+        .wait_condition_variable     = pl__wait_condition_variable,
+        .wake_condition_variable     = pl__wake_condition_variable,
+        .wake_all_condition_variable = pl__wake_all_condition_variable
     };
 
     // load CORE apis
@@ -173,6 +230,7 @@ int main()
     gptApiRegistry->add(PL_API_FILE, &tFileApi);
     gptApiRegistry->add(PL_API_UDP, &tUdpApi);
     gptApiRegistry->add(PL_API_OS_SERVICES, &tOsApi);
+    gptApiRegistry->add(PL_API_THREADS, &tThreadsApi);
 
     // add contexts to data registry
     gptDataRegistry->set_data("ui", gptUiCtx);
@@ -320,7 +378,11 @@ int main()
 
     // load library
     const plLibraryApiI* ptLibraryApi = gptApiRegistry->first(PL_API_LIBRARY);
-    if(ptLibraryApi->load(&gtAppLibrary, "./app.so", "./app_", "./lock.tmp"))
+    char acAppLibrary[256] = {0};
+    char acAppTransitional[256] = {0};
+    snprintf(acAppLibrary, 256, "./%s.so", pcAppName);
+    snprintf(acAppTransitional, 256, "./%s_", pcAppName);
+    if(ptLibraryApi->load(&gtAppLibrary, acAppLibrary, acAppTransitional, "./lock.tmp"))
     {
         pl_app_load     = (void* (__attribute__(()) *)(const plApiRegistryApiI*, void*)) ptLibraryApi->load_function(&gtAppLibrary, "pl_app_load");
         pl_app_shutdown = (void  (__attribute__(()) *)(void*)) ptLibraryApi->load_function(&gtAppLibrary, "pl_app_shutdown");
@@ -580,6 +642,16 @@ pl__read_file(const char* file, unsigned* sizeIn, char* buffer, const char* mode
     fclose(dataFile);
 }
 
+uint64_t
+pl__get_file_modified_time(const char* pcFile)
+{
+    // nanoseconds so saves within the same second are still seen
+    struct stat tAttr;
+    if(stat(pcFile, &tAttr) == -1)
+        return 0;
+    return (uint64_t)tAttr.st_mtim.tv_sec * 1000000000ull + (uint64_t)tAttr.st_mtim.tv_nsec;
+}
+
 void
 pl__copy_file(const char* source, const char* destination, unsigned* size, char* buffer)
 {
@@ -776,6 +848,98 @@ pl__sleep(uint32_t millisec)
     return res;
 }
 
+void
+pl__request_exit(void)
+{
+    gRunning = false;
+}
+
+uint32_t
+pl__get_hardware_thread_count(void)
+{
+    const long lCount = sysconf(_SC_NPROCESSORS_ONLN);
+    return lCount > 0 ? (uint32_t)lCount : 1;
+}
+
+plThread*
+pl__create_thread(plThreadProcedure ptProcedure, void* pData)
+{
+    plThread* ptThread = malloc(sizeof(plThread));
+    if(pthread_create(&ptThread->tHandle, NULL, ptProcedure, pData) != 0)
+    {
+        free(ptThread);
+        return NULL;
+    }
+    return ptThread;
+}
+
+void
+pl__join_thread(plThread* ptThread)
+{
+    pthread_join(ptThread->tHandle, NULL);
+    free(ptThread);
+}
+
+plMutex*
+pl__create_mutex(void)
+{
+    plMutex* ptMutex = malloc(sizeof(plMutex));
+    pthread_mutex_init(&ptMutex->tHandle, NULL);
+    return ptMutex;
+}
+
+void
+pl__destroy_mutex(plMutex* ptMutex)
+{
+    pthread_mutex_destroy(&ptMutex->tHandle);
+    free(ptMutex);
+}
+
+void
+pl__lock_mutex(plMutex* ptMutex)
+{
+    pthread_mutex_lock(&ptMutex->tHandle);
+}
+
+void
+pl__unlock_mutex(plMutex* ptMutex)
+{
+    pthread_mutex_unlock(&ptMutex->tHandle);
+}
+
+plConditionVariable*
+pl__create_condition_variable(void)
+{
+    plConditionVariable* ptConditionVariable = malloc(sizeof(plConditionVariable));
+    pthread_cond_init(&ptConditionVariable->tHandle, NULL);
+    return ptConditionVariable;
+}
+
+void
+pl__destroy_condition_variable(plConditionVariable* ptConditionVariable)
+{
+    pthread_cond_destroy(&ptConditionVariable->tHandle);
+    free(ptConditionVariable);
+}
+
+void
+pl__wait_condition_variable(plConditionVariable* ptConditionVariable, plMutex* ptMutex)
+{
+    pthread_cond_wait(&ptConditionVariable->tHandle, &ptMutex->tHandle);
+}
+
+void
+pl__wake_condition_variable(plConditionVariable* ptConditionVariable)
+{
+    pthread_cond_signal(&ptConditionVariable->tHandle);
+}
+
+void
+pl__wake_all_condition_variable(plConditionVariable* ptConditionVariable)
+{
+    pthread_cond_broadcast(&ptConditionVariable->tHandle);
+}
+
 
 plKey
 pl__xcb_key_to_pl_key(uint32_t x_keycode)
@@ -39,6 +39,8 @@ Index of this file:
 #include <netinet/in.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>  // threads, mutexes, condition variables
+#include <unistd.h>   // sysconf
 
 //-----------------------------------------------------------------------------
 // [SECTION] forward declarations
@@ -78,6 +80,21 @@ typedef struct _plAppleSharedLibrary
     struct timespec lastWriteTime;
 } plAppleSharedLibrary;
 
+typedef struct _plThread
+{
+    pthread_t tHandle;
+} plThread;
+
+typedef struct _plMutex
+{
+    pthread_mutex_t tHandle;
+} plMutex;
+
+typedef struct _plConditionVariable
+{
+    pthread_cond_t tHandle;
+} plConditionVariable;
+
 //-----------------------------------------------------------------------------
 // [SECTION] internal api
 //-----------------------------------------------------------------------------
@@ -112,6 +129,7 @@ static bool  pl__handle_osx_event(NSEvent* event, NSView* view);
 
 void  pl__read_file            (const char* pcFile, unsigned* puSize, char* pcBuffer, const char* pcMode);
 void  pl__copy_file            (const char* pcSource, const char* pcDestination, unsigned* puSize, char* pcBuffer);
+uint64_t pl__get_file_modified_time(const char* pcFile);
 void  pl__create_udp_socket    (plSocket* ptSocketOut, bool bNonBlocking);
 void  pl__bind_udp_socket      (plSocket* ptSocket, int iPort);
 bool  pl__send_udp_data        (plSocket* ptFromSocket, const char* pcDestIP, int iDestPort, void* pData, size_t szSize);
@@ -121,6 +139,21 @@ bool  pl__load_library         (plSharedLibrary* ptLibrary, const char* pcName,
 void  pl__reload_library       (plSharedLibrary* ptLibrary);
 void* pl__load_library_function(plSharedLibrary* ptLibrary, const char* pcName);
 int   pl__sleep                (uint32_t millisec);
+void  pl__request_exit         (void);
+
+// threads
+uint32_t             pl__get_hardware_thread_count  (void);
+plThread*            pl__create_thread              (plThreadProcedure ptProcedure, void* pData);
+void                 pl__join_thread                (plThread* ptThread);
+plMutex*             pl__create_mutex               (void);
+void                 pl__destroy_mutex              (plMutex* ptMutex);
+void                 pl__lock_mutex                 (plMutex* ptMutex);
+void                 pl__unlock_mutex               (plMutex* ptMutex);
+plConditionVariable* pl__create_condition_variable  (void);
+void                 pl__destroy_condition_variable (plConditionVariable* ptConditionVariable);
+void                 pl__wait_condition_variable    (plConditionVariable* ptConditionVariable, plMutex* ptMutex);
+void                 pl__wake_condition_variable    (plConditionVariable* ptConditionVariable);
+void                 pl__wake_all_condition_variable(plConditionVariable* ptConditionVariable);
 
 //-----------------------------------------------------------------------------
 // [SECTION] globals
@@ -137,6 +170,7 @@ static const plLibraryApiI* gptLibraryApi = NULL;
 static NSWindow*            gWindow = NULL;
 static NSViewController*    gViewController = NULL;
 static plSharedLibrary      gtAppLibrary = {0};
+static const char*          gpcAppName = "app"; // "-a <name>" loads <name>.dylib
 static void*                gUserData = NULL;
 static bool                 gRunning = true;
 static plKeyEventResponder* gKeyEventResponder = NULL;
@@ -163,8 +197,14 @@ static void  (*pl_app_update)  (void* ptAppData);
 // [SECTION] entry point
 //-----------------------------------------------------------------------------
 
-int main()
+int main(int argc, char *argv[])
 {
+    // app to load
+    for(int i = 1; i < argc - 1; i++)
+    {
+        if(strcmp(argv[i], "-a") == 0)
+            gpcAppName = argv[++i];
+    }
 
     gptUiCtx = pl_create_context();
     gptIOCtx = pl_get_io();
@@ -181,8 +221,9 @@ int main()
     };
 
     static const plFileApiI tApi4 = {
-        .copy = pl__copy_file,
-        .read = pl__read_file
+        .copy              = pl__copy_file,
+        .read              = pl__read_file,
+        .get_modified_time = pl__get_file_modified_time
     };
     
     static const plUdpApiI tApi5 = {
@@ -193,13 +234,30 @@ int main()
     };
 
     static const plOsServicesApiI tApi6 = {
-        .sleep     = pl__sleep
+        .sleep        = pl__sleep,
+        .request_exit = pl__request_exit
+    };
+
+    static const plThreadsApiI tApi7 = {
+        .get_hardware_thread_count   = pl__get_hardware_thread_count,
+        .create_thread               = pl__create_thread,
+        .join_thread                 = pl__join_thread,
+        .create_mutex                = pl__create_mutex,
+        .destroy_mutex               = pl__destroy_mutex,
+        .lock_mutex                  = pl__lock_mutex,
+        .unlock_mutex                = pl__unlock_mutex,
+        .create_condition_variable   = pl__create_condition_variable,
+        .destroy_condition_variable  = pl__destroy_condition_variable,
+        .wait_condition_variable     = pl__wait_condition_variable,
+        .wake_condition_variable     = pl__wake_condition_variable,
+        .wake_all_condition_variable = pl__wake_all_condition_variable
     };
 
     gptApiRegistry->add(PL_API_LIBRARY, &tApi3);
     gptApiRegistry->add(PL_API_FILE, &tApi4);
     gptApiRegistry->add(PL_API_UDP, &tApi5);
     gptApiRegistry->add(PL_API_OS_SERVICES, &tApi6);
+    gptApiRegistry->add(PL_API_THREADS, &tApi7);
 
     gptDataRegistry      = gptApiRegistry->first(PL_API_DATA_REGISTRY);
     gptExtensionRegistry = gptApiRegistry->first(PL_API_EXTENSION_REGISTRY);
@@ -488,7 +546,11 @@ DispatchRenderLoop(CVDisplayLinkRef displayLink, const CVTimeStamp* now, const C
     gptIOCtx->afMainViewportSize[1] = 500;
 
     // load library
-    if(gptLibraryApi->load(&gtAppLibrary, "app.dylib", "app_", "lock.tmp"))
+    char acAppLibrary[256] = {0};
+    char acAppTransitional[256] = {0};
+    snprintf(acAppLibrary, 256, "%s.dylib", gpcAppName);
+    snprintf(acAppTransitional, 256, "%s_", gpcAppName);
+    if(gptLibraryApi->load(&gtAppLibrary, acAppLibrary, acAppTransitional, "lock.tmp"))
     {
         pl_app_load     = (void* (__attribute__(()) *)(const plApiRegistryApiI*, void*)) gptLibraryApi->load_function(&gtAppLibrary, "pl_app_load");
         pl_app_shutdown = (void  (__attribute__(()) *)(void*))                     gptLibraryApi->load_function(&gtAppLibrary, "pl_app_shutdown");
@@ -874,6 +936,16 @@ pl__read_file(const char* file, unsigned* sizeIn, char* buffer, const char* mode
     fclose(dataFile);
 }
 
+uint64_t
+pl__get_file_modified_time(const char* pcFile)
+{
+    // nanoseconds so saves within the same second are still seen
+    struct stat tAttr;
+    if(stat(pcFile, &tAttr) == -1)
+        return 0;
+    return (uint64_t)tAttr.st_mtimespec.tv_sec * 1000000000ull + (uint64_t)tAttr.st_mtimespec.tv_nsec;
+}
+
 void
 pl__copy_file(const char* source, const char* destination, unsigned* size, char* buffer)
 {
@@ -1057,6 +1129,99 @@ pl__sleep(uint32_t millisec)
     return res;
 }
 
+void
+pl__request_exit(void)
+{
+    dispatch_async(dispatch_get_main_queue(), ^{ [NSApp terminate:nil]; });
+}
+
+uint32_t
+pl__get_hardware_thread_count(void)
+{
+    const long lCount = sysconf(_SC_NPROCESSORS_ONLN);
+    return lCount > 0 ? (uint32_t)lCount : 1;
+}
+
+plThread*
+pl__create_thread(plThreadProcedure ptProcedure, void* pData)
+{
+    plThread* ptThread = malloc(sizeof(plThread));
+    if(pthread_create(&ptThread->tHandle, NULL, ptProcedure, pData) != 0)
+    {
+        free(ptThread);
+        return NULL;
+    }
+    return ptThread;
+}
+
+void
+pl__join_thread(plThread* ptThread)
+{
+    pthread_join(ptThread->tHandle, NULL);
+    free(ptThread);
+}
+
+plMutex*
+pl__create_mutex(void)
+{
+    plMutex* ptMutex = malloc(sizeof(plMutex));
+    pthread_mutex_init(&ptMutex->tHandle, NULL);
+    return ptMutex;
+}
+
+void
+pl__destroy_mutex(plMutex* ptMutex)
+{
+    pthread_mutex_destroy(&ptMutex->tHandle);
+    free(ptMutex);
+}
+
+void
+pl__lock_mutex(plMutex* ptMutex)
+{
+    pthread_mutex_lock(&ptMutex->tHandle);
+}
+
+void
+pl__unlock_mutex(plMutex* ptMutex)
+{
+    pthread_mutex_unlock(&ptMutex->tHandle);
+}
+
+plConditionVariable*
+pl__create_condition_variable(void)
+{
+    plConditionVariable* ptConditionVariable = malloc(sizeof(plConditionVariable));
+    pthread_cond_init(&ptConditionVariable->tHandle, NULL);
+    return ptConditionVariable;
+}
+
+void
+pl__destroy_condition_variable(plConditionVariable* ptConditionVariable)
+{
+    pthread_cond_destroy(&ptConditionVariable->tHandle);
+    free(ptConditionVariable);
+}
+
+void
+pl__wait_condition_variable(plConditionVariable* ptConditionVariable, plMutex* ptMutex)
+{
+    pthread_cond_wait(&ptConditionVariable->tHandle, &ptMutex->tHandle);
+}
+
+void
+pl__wake_condition_variable(plConditionVariable* ptConditionVariable)
+{
+    pthread_cond_signal(&ptConditionVariable->tHandle);
+}
+
+void
+pl__wake_all_condition_variable(plConditionVariable* ptConditionVariable)
+{
+    pthread_cond_broadcast(&ptConditionVariable->tHandle);
+}
+
+
 const char*
 pl__get_clipboard_text(void* user_data_ctx)
 {
@@ -73,6 +73,7 @@ static void        pl__set_clipboard_text(void* pUnused, const char* text);
 // file api
 void pl__read_file(const char* pcFile, unsigned* puSize, char* pcBuffer, const char* pcMode);
 void pl__copy_file(const char* pcSource, const char* pcDestination, unsigned* puSize, char* pcBuffer);
+uint64_t pl__get_file_modified_time(const char* pcFile);
 
 // udp api
 void pl__create_udp_socket (plSocket* ptSocketOut, bool bNonBlocking);
@@ -87,7 +88,22 @@ void  pl__reload_library       (plSharedLibrary* ptLibrary);
 void* pl__load_library_function(plSharedLibrary* ptLibrary, const char* pcName);
 
 // os services api
-int pl__sleep(uint32_t millisec);
+int  pl__sleep       (uint32_t millisec);
+void pl__request_exit(void);
+
+// threads api
+uint32_t             pl__get_hardware_thread_count  (void);
+plThread*            pl__create_thread              (plThreadProcedure ptProcedure, void* pData);
+void                 pl__join_thread                (plThread* ptThread);
+plMutex*             pl__create_mutex               (void);
+void                 pl__destroy_mutex              (plMutex* ptMutex);
+void                 pl__lock_mutex                 (plMutex* ptMutex);
+void                 pl__unlock_mutex               (plMutex* ptMutex);
+plConditionVariable* pl__create_condition_variable  (void);
+void                 pl__destroy_condition_variable (plConditionVariable* ptConditionVariable);
+void                 pl__wait_condition_variable    (plConditionVariable* ptConditionVariable, plMutex* ptMutex);
+void                 pl__wake_condition_variable    (plConditionVariable* ptConditionVariable);
+void                 pl__wake_all_condition_variable(plConditionVariable* ptConditionVariable);
 
 //-----------------------------------------------------------------------------
 // [SECTION] structs
@@ -99,6 +115,23 @@ typedef struct _plWin32SharedLibrary
     FILETIME  tLastWriteTime;
 } plWin32SharedLibrary;
 
+typedef struct _plThread
+{
+    HANDLE            tHandle;
+    plThreadProcedure ptProcedure; // win32 procedures have a different signature
+    void*             pData;
+} plThread;
+
+typedef struct _plMutex
+{
+    SRWLOCK tHandle;
+} plMutex;
+
+typedef struct _plConditionVariable
+{
+    CONDITION_VARIABLE tHandle;
+} plConditionVariable;
+
 //-----------------------------------------------------------------------------
 // [SECTION] globals
 //-----------------------------------------------------------------------------
@@ -144,10 +177,14 @@ int main(int argc, char *argv[])
 
     // check for disabling of escape characters.
     // this is necessary for some vkconfig's "console"
+    // "-a <name>" loads ./<name>.dll instead of the default app
+    const char* pcAppName = "app";
     for(int i = 1; i < argc; i++)
     { 
         if(strcmp(argv[i], "--disable_vt") == 0)
             gbEnableVirtualTerminalProcessing = false;
+        else if(strcmp(argv[i], "-a") == 0 && i + 1 < argc)
+            pcAppName = argv[++i];
     }
 
     // initialize winsock
@@ -168,8 +205,9 @@ int main(int argc, char *argv[])
     };
 
     static const plFileApiI tFileApi = {
-        .copy = pl__copy_file,
-        .read = pl__read_file
+        .copy              = pl__copy_file,
+        .read              = pl__read_file,
+        .get_modified_time = pl__get_file_modified_time
     };
     
     static const plUdpApiI tUdpApi = {
@@ -180,7 +218,23 @@ int main(int argc, char *argv[])
     };
 
     static const plOsServicesApiI tOsApi = {
-        .sleep = pl__sleep
+        .sleep        = pl__sleep,
+        .request_exit = pl__request_exit
+    };
+
+    static const plThreadsApiI tThreadsApi = {
+        .get_hardware_thread_count   = pl__get_hardware_thread_count,
+        .create_thread               = pl__create_thread,
+        .join_thread                 = pl__join_thread,
+        .create_mutex                = pl__create_mutex,
+        .destroy_mutex               = pl__destroy_mutex,
+        .lock_mutex                  = pl__lock_mutex,
+        .unlock_mutex                = pl__unlock_mutex,
+        .create_condition_variable   = pl__create_condition_variable,
+        .destroy_condition_variable  = pl__destroy_condition_variable,
+        .wait_condition_variable     = pl__wait_condition_variable,
+        .wake_condition_variable     = pl__wake_condition_variable,
+        .wake_all_condition_variable = pl__wake_all_condition_variable
     };
 
     // load core apis
@@ -193,6 +247,7 @@ int main(int argc, char *argv[])
     gptApiRegistry->add(PL_API_FILE, &tFileApi);
     gptApiRegistry->add(PL_API_UDP, &tUdpApi);
     gptApiRegistry->add(PL_API_OS_SERVICES, &tOsApi);
+    gptApiRegistry->add(PL_API_THREADS, &tThreadsApi);
 
     // set clipboard functions (may need to move this to OS api)
     gptIOCtx->set_clipboard_text_fn = pl__set_clipboard_text;
@@ -271,7 +326,11 @@ int main(int argc, char *argv[])
 
     // load library
     const plLibraryApiI* ptLibraryApi = gptApiRegistry->first(PL_API_LIBRARY);
-    if(ptLibraryApi->load(&gtAppLibrary, "./app.dll", "./app_", "./lock.tmp"))
+    char acAppLibrary[256] = {0};
+    char acAppTransitional[256] = {0};
+    snprintf(acAppLibrary, 256, "./%s.dll", pcAppName);
+    snprintf(acAppTransitional, 256, "./%s_", pcAppName);
+    if(ptLibraryApi->load(&gtAppLibrary, acAppLibrary, acAppTransitional, "./lock.tmp"))
     {
         pl_app_load     = (void* (__cdecl  *)(const plApiRegistryApiI*, void*)) ptLibraryApi->load_function(&gtAppLibrary, "pl_app_load");
         pl_app_shutdown = (void  (__cdecl  *)(void*)) ptLibraryApi->load_function(&gtAppLibrary, "pl_app_shutdown");
@@ -819,6 +878,15 @@ pl__read_file(const char* pcFile, unsigned* puSizeIn, char* pcBuffer, const char
     fclose(ptDataFile);
 }
 
+uint64_t
+pl__get_file_modified_time(const char* pcFile)
+{
+    WIN32_FILE_ATTRIBUTE_DATA tData = {0};
+    if(!GetFileAttributesExA(pcFile, GetFileExInfoStandard, &tData))
+        return 0;
+    return ((uint64_t)tData.ftLastWriteTime.dwHighDateTime << 32) | (uint64_t)tData.ftLastWriteTime.dwLowDateTime;
+}
+
 void
 pl__copy_file(const char* pcSource, const char* pcDestination, unsigned* puSize, char* pcBuffer)
 {
@@ -1007,6 +1075,109 @@ pl__sleep(uint32_t uMillisec)
     return 0;
 }
 
+void
+pl__request_exit(void)
+{
+    gbRunning = false;
+}
+
+static DWORD WINAPI
+pl__thread_procedure(LPVOID pData)
+{
+    plThread* ptThread = pData;
+    ptThread->ptProcedure(ptThread->pData);
+    return 0;
+}
+
+uint32_t
+pl__get_hardware_thread_count(void)
+{
+    SYSTEM_INFO tInfo = {0};
+    GetSystemInfo(&tInfo);
+    return tInfo.dwNumberOfProcessors > 0 ? (uint32_t)tInfo.dwNumberOfProcessors : 1;
+}
+
+plThread*
+pl__create_thread(plThreadProcedure ptProcedure, void* pData)
+{
+    plThread* ptThread = malloc(sizeof(plThread));
+    ptThread->ptProcedure = ptProcedure;
+    ptThread->pData = pData;
+    ptThread->tHandle = CreateThread(NULL, 0, pl__thread_procedure, ptThread, 0, NULL);
+    if(ptThread->tHandle == NULL)
+    {
+        free(ptThread);
+        return NULL;
+    }
+    return ptThread;
+}
+
+void
+pl__join_thread(plThread* ptThread)
+{
+    WaitForSingleObject(ptThread->tHandle, INFINITE);
+    CloseHandle(ptThread->tHandle);
+    free(ptThread);
+}
+
+plMutex*
+pl__create_mutex(void)
+{
+    plMutex* ptMutex = malloc(sizeof(plMutex));
+    InitializeSRWLock(&ptMutex->tHandle);
+    return ptMutex;
+}
+
+void
+pl__destroy_mutex(plMutex* ptMutex)
+{
+    free(ptMutex); // SRW locks don't need to be destroyed
+}
+
+void
+pl__lock_mutex(plMutex* ptMutex)
+{
+    AcquireSRWLockExclusive(&ptMutex->tHandle);
+}
+
+void
+pl__unlock_mutex(plMutex* ptMutex)
+{
+    ReleaseSRWLockExclusive(&ptMutex->tHandle);
+}
+
+plConditionVariable*
+pl__create_condition_variable(void)
+{
+    plConditionVariable* ptConditionVariable = malloc(sizeof(plConditionVariable));
+    InitializeConditionVariable(&ptConditionVariable->tHandle);
+    return ptConditionVariable;
+}
+
+void
+pl__destroy_condition_variable(plConditionVariable* ptConditionVariable)
+{
+    free(ptConditionVariable);
+}
+
+void
+pl__wait_condition_variable(plConditionVariable* ptConditionVariable, plMutex* ptMutex)
+{
+    SleepConditionVariableSRW(&ptConditionVariable->tHandle, &ptMutex->tHandle, INFINITE, 0);
+}
+
+void
+pl__wake_condition_variable(plConditionVariable* ptConditionVariable)
+{
+    WakeConditionVariable(&ptConditionVariable->tHandle);
+}
+
+void
+pl__wake_all_condition_variable(plConditionVariable* ptConditionVariable)
+{
+    WakeAllConditionVariable(&ptConditionVariable->tHandle);
+}
+
 const char*
 pl__get_clipboard_text(void* user_data_ctx)
 {
@@ -44,6 +44,9 @@ typedef struct _plUdpApiI plUdpApiI;
 #define PL_API_OS_SERVICES "OS SERVICES API"
 typedef struct _plOsServicesApiI plOsServicesApiI;
 
+#define PL_API_THREADS "THREADS API"
+typedef struct _plThreadsApiI plThreadsApiI;
+
 //-----------------------------------------------------------------------------
 // [SECTION] includes
 //-----------------------------------------------------------------------------
@@ -59,6 +62,12 @@ typedef struct _plOsServicesApiI plOsServicesApiI;
 typedef struct _plSharedLibrary plSharedLibrary;
 typedef struct _plSocket plSocket;
 
+// threads (opaque, platform specific)
+typedef struct _plThread            plThread;
+typedef struct _plMutex             plMutex;
+typedef struct _plConditionVariable plConditionVariable;
+typedef void* (*plThreadProcedure)(void* pData);
+
 // external
 typedef struct _plApiRegistryApiI plApiRegistryApiI;
 
@@ -78,6 +87,7 @@ typedef struct _plFileApiI
 {
   void (*read)(const char* pcFile, unsigned* puSize, char* pcBuffer, const char* pcMode);
   void (*copy)(const char* pcSource, const char* pcDestination, unsigned* puSize, char* pcBuffer);
+  uint64_t (*get_modified_time)(const char* pcFile); // 0 if the file doesn't exist, only compare for equality
 } plFileApiI;
 
 typedef struct _plUdpApiI
@@ -90,9 +100,29 @@ typedef struct _plUdpApiI
 
 typedef struct _plOsServicesApiI
 {
-  int (*sleep) (uint32_t millisec);
+  int  (*sleep)       (uint32_t millisec);
+  void (*request_exit)(void); // main loop stops after the current frame
 } plOsServicesApiI;
 
+typedef struct _plThreadsApiI
+{
+  uint32_t (*get_hardware_thread_count)(void);
+
+  plThread* (*create_thread)(plThreadProcedure ptProcedure, void* pData);
+  void      (*join_thread)  (plThread* ptThread); // waits for the procedure to return & frees the thread
+
+  plMutex* (*create_mutex) (void);
+  void     (*destroy_mutex)(plMutex* ptMutex);
+  void     (*lock_mutex)   (plMutex* ptMutex);
+  void     (*unlock_mutex) (plMutex* ptMutex);
+
+  plConditionVariable* (*create_condition_variable)  (void);
+  void                 (*destroy_condition_variable) (plConditionVariable* ptConditionVariable);
+  void                 (*wait_condition_variable)    (plConditionVariable* ptConditionVariable, plMutex* ptMutex); // ptMutex must be locked, may wake spuriously
+  void                 (*wake_condition_variable)    (plConditionVariable* ptConditionVariable);
+  void                 (*wake_all_condition_variable)(plConditionVariable* ptConditionVariable);
+} plThreadsApiI;
+
 //-----------------------------------------------------------------------------
 // [SECTION] structs
 //-----------------------------------------------------------------------------
@@ -1,3 +1,4 @@
+#include "pl_ecs_tests.h" // first, pilotlight.h sets the pl_ds.h allocators
 #include "pl_ds_tests.h"
 #include "pl_json_tests.h"
 
@@ -11,6 +12,18 @@ int main()
     // json tests
     pl_test_register_test(json_test_0, NULL);
 
+    // ecs tests
+    pl_test_register_test(ecs_test_queries_0, NULL);
+    pl_test_register_test(ecs_test_components_0, NULL);
+    pl_test_register_test(ecs_test_instances_0, NULL);
+    pl_test_register_test(ecs_test_entities_0, NULL);
+    pl_test_register_test(ecs_test_sparse_sets_0, NULL);
+    pl_test_register_test(ecs_test_hierarchy_0, NULL);
+    pl_test_register_test(ecs_test_kernels_0, NULL);
+    pl_test_register_test(ecs_test_soa_0, NULL);
+    pl_test_register_test(ecs_test_names_0, NULL);
+    pl_test_register_test(ecs_test_mesh_frames_0, NULL);
+
     if(!pl_test_run())
     {
         exit(1);
@@ -23,4 +36,16 @@ int main()
 #include "pl_test.h"
 
 #define PL_JSON_IMPLEMENTATION
-#include "pl_json.h"
\ No newline at end of file
+#include "pl_json.h"
+
+#define PL_LOG_IMPLEMENTATION
+#include "pl_log.h"
+
+#define PL_PROFILE_IMPLEMENTATION
+#include "pl_profile.h"
+
+void*
+pl_realloc(void* pBuffer, size_t szSize, const char* pcFile, int iLine)
+{
+    return realloc(pBuffer, szSize);
+}
@@ -0,0 +1,1212 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pl_test.h"
+
+// unity build, so tests can reach internal helpers & globals
+#include "pl_ecs_ext.c"
+
+//-----------------------------------------------------------------------------
+// [SECTION] test threads
+//-----------------------------------------------------------------------------
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+typedef struct _plThread
+{
+    HANDLE            tHandle;
+    plThreadProcedure ptProcedure;
+    void*             pData;
+} plThread;
+
+typedef struct _plMutex
+{
+    SRWLOCK tHandle;
+} plMutex;
+
+typedef struct _plConditionVariable
+{
+    CONDITION_VARIABLE tHandle;
+} plConditionVariable;
+
+static DWORD WINAPI
+pl__ecs_test_thread_procedure(LPVOID pData)
+{
+    plThread* ptThread = pData;
+    ptThread->ptProcedure(ptThread->pData);
+    return 0;
+}
+
+static uint32_t
+pl__ecs_test_get_hardware_thread_count(void)
+{
+    // at least 4, so single core machines still run the pool paths
+    SYSTEM_INFO tInfo = {0};
+    GetSystemInfo(&tInfo);
+    return tInfo.dwNumberOfProcessors > 4 ? (uint32_t)tInfo.dwNumberOfProcessors : 4;
+}
+
+static plThread*
+pl__ecs_test_create_thread(plThreadProcedure ptProcedure, void* pData)
+{
+    plThread* ptThread = malloc(sizeof(plThread));
+    ptThread->ptProcedure = ptProcedure;
+    ptThread->pData = pData;
+    ptThread->tHandle = CreateThread(NULL, 0, pl__ecs_test_thread_procedure, ptThread, 0, NULL);
+    if(ptThread->tHandle == NULL)
+    {
+        free(ptThread);
+        return NULL;
+    }
+    return ptThread;
+}
+
+static void
+pl__ecs_test_join_thread(plThread* ptThread)
+{
+    WaitForSingleObject(ptThread->tHandle, INFINITE);
+    CloseHandle(ptThread->tHandle);
+    free(ptThread);
+}
+
+static plMutex*
+pl__ecs_test_create_mutex(void)
+{
+    plMutex* ptMutex = malloc(sizeof(plMutex));
+    InitializeSRWLock(&ptMutex->tHandle);
+    return ptMutex;
+}
+
+static void pl__ecs_test_destroy_mutex(plMutex* ptMutex) { free(ptMutex); }
+static void pl__ecs_test_lock_mutex   (plMutex* ptMutex) { AcquireSRWLockExclusive(&ptMutex->tHandle); }
+static void pl__ecs_test_unlock_mutex (plMutex* ptMutex) { ReleaseSRWLockExclusive(&ptMutex->tHandle); }
+
+static plConditionVariable*
+pl__ecs_test_create_condition_variable(void)
+{
+    plConditionVariable* ptConditionVariable = malloc(sizeof(plConditionVariable));
+    InitializeConditionVariable(&ptConditionVariable->tHandle);
+    return ptConditionVariable;
+}
+
+static void
+pl__ecs_test_wait_condition_variable(plConditionVariable* ptConditionVariable, plMutex* ptMutex)
+{
+    SleepConditionVariableSRW(&ptConditionVariable->tHandle, &ptMutex->tHandle, INFINITE, 0);
+}
+
+static void pl__ecs_test_destroy_condition_variable (plConditionVariable* ptConditionVariable) { free(ptConditionVariable); }
+static void pl__ecs_test_wake_condition_variable    (plConditionVariable* ptConditionVariable) { WakeConditionVariable(&ptConditionVariable->tHandle); }
+static void pl__ecs_test_wake_all_condition_variable(plConditionVariable* ptConditionVariable) { WakeAllConditionVariable(&ptConditionVariable->tHandle); }
+
+#else // posix
+
+#include <pthread.h>
+#include <unistd.h>
+
+typedef struct _plThread
+{
+    pthread_t tHandle;
+} plThread;
+
+typedef struct _plMutex
+{
+    pthread_mutex_t tHandle;
+} plMutex;
+
+typedef struct _plConditionVariable
+{
+    pthread_cond_t tHandle;
+} plConditionVariable;
+
+static uint32_t
+pl__ecs_test_get_hardware_thread_count(void)
+{
+    // at least 4, so single core machines still run the pool paths
+    const long lCount = sysconf(_SC_NPROCESSORS_ONLN);
+    return lCount > 4 ? (uint32_t)lCount : 4;
+}
+
+static plThread*
+pl__ecs_test_create_thread(plThreadProcedure ptProcedure, void* pData)
+{
+    plThread* ptThread = malloc(sizeof(plThread));
+    if(pthread_create(&ptThread->tHandle, NULL, ptProcedure, pData) != 0)
+    {
+        free(ptThread);
+        return NULL;
+    }
+    return ptThread;
+}
+
+static void
+pl__ecs_test_join_thread(plThread* ptThread)
+{
+    pthread_join(ptThread->tHandle, NULL);
+    free(ptThread);
+}
+
+static plMutex*
+pl__ecs_test_create_mutex(void)
+{
+    plMutex* ptMutex = malloc(sizeof(plMutex));
+    pthread_mutex_init(&ptMutex->tHandle, NULL);
+    return ptMutex;
+}
+
+static void
+pl__ecs_test_destroy_mutex(plMutex* ptMutex)
+{
+    pthread_mutex_destroy(&ptMutex->tHandle);
+    free(ptMutex);
+}
+
+static void pl__ecs_test_lock_mutex  (plMutex* ptMutex) { pthread_mutex_lock(&ptMutex->tHandle); }
+static void pl__ecs_test_unlock_mutex(plMutex* ptMutex) { pthread_mutex_unlock(&ptMutex->tHandle); }
+
+static plConditionVariable*
+pl__ecs_test_create_condition_variable(void)
+{
+    plConditionVariable* ptConditionVariable = malloc(sizeof(plConditionVariable));
+    pthread_cond_init(&ptConditionVariable->tHandle, NULL);
+    return ptConditionVariable;
+}
+
+static void
+pl__ecs_test_destroy_condition_variable(plConditionVariable* ptConditionVariable)
+{
+    pthread_cond_destroy(&ptConditionVariable->tHandle);
+    free(ptConditionVariable);
+}
+
+static void
+pl__ecs_test_wait_condition_variable(plConditionVariable* ptConditionVariable, plMutex* ptMutex)
+{
+    pthread_cond_wait(&ptConditionVariable->tHandle, &ptMutex->tHandle);
+}
+
+static void pl__ecs_test_wake_condition_variable    (plConditionVariable* ptConditionVariable) { pthread_cond_signal(&ptConditionVariable->tHandle); }
+static void pl__ecs_test_wake_all_condition_variable(plConditionVariable* ptConditionVariable) { pthread_cond_broadcast(&ptConditionVariable->tHandle); }
+
+#endif
+
+static const plThreadsApiI gtEcsTestThreads = {
+    .get_hardware_thread_count   = pl__ecs_test_get_hardware_thread_count,
+    .create_thread               = pl__ecs_test_create_thread,
+    .join_thread                 = pl__ecs_test_join_thread,
+    .create_mutex                = pl__ecs_test_create_mutex,
+    .destroy_mutex               = pl__ecs_test_destroy_mutex,
+    .lock_mutex                  = pl__ecs_test_lock_mutex,
+    .unlock_mutex                = pl__ecs_test_unlock_mutex,
+    .create_condition_variable   = pl__ecs_test_create_condition_variable,
+    .destroy_condition_variable  = pl__ecs_test_destroy_condition_variable,
+    .wait_condition_variable     = pl__ecs_test_wait_condition_variable,
+    .wake_condition_variable     = pl__ecs_test_wake_condition_variable,
+    .wake_all_condition_variable = pl__ecs_test_wake_all_condition_variable
+};
+
+//-----------------------------------------------------------------------------
+// [SECTION] helpers
+//-----------------------------------------------------------------------------
+
+static const plEcsI*
+pl__ecs_test_begin(plComponentLibrary* ptLibrary, bool bWorkers)
+{
+    // what pl_load_ecs_ext would set up, minus the registry
+    static bool bContextsCreated = false;
+    if(!bContextsCreated)
+    {
+        pl_create_profile_context();
+        pl_create_log_context();
+        uLogChannel = pl_add_log_channel("ECS", PL_CHANNEL_TYPE_CYCLIC_BUFFER);
+        pl__set_transform_backend(PL_TRANSFORM_BACKEND_AUTO);
+        bContextsCreated = true;
+    }
+    if(bWorkers)
+    {
+        gptThreads = &gtEcsTestThreads;
+        pl__create_task_pool();
+    }
+
+    const plEcsI* ptEcs = pl_load_ecs_api();
+    ptEcs->init_component_library(NULL, ptLibrary);
+    return ptEcs;
+}
+
+static void
+pl__ecs_test_end(const plEcsI* ptEcs, plComponentLibrary* ptLibrary)
+{
+    ptEcs->cleanup_systems(NULL, ptLibrary);
+    pl__destroy_task_pool();
+    gptThreads = NULL;
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] queries & tasks
+//-----------------------------------------------------------------------------
+
+typedef struct _plEcsTestQueryData
+{
+    plEcsQuery* ptInner;                           // run from every outer chunk
+    uint32_t    auMatches[PL_ECS_MAX_WORKERS];     // per worker, no atomics needed
+    uint32_t    auLightSums[PL_ECS_MAX_WORKERS];
+} plEcsTestQueryData;
+
+static void
+pl__ecs_test_count_chunk(const plEcsQueryChunk* ptChunk, void* pUserData, uint32_t uWorker)
+{
+    plEcsTestQueryData* ptData = pUserData;
+    const plLightComponent* atLights = ptChunk->apComponents[1];
+    for(uint32_t i = 0; i < ptChunk->uCount; i++)
+        ptData->auLightSums[uWorker] += (uint32_t)atLights[ptChunk->apuIndices[1][i]].tColor.x;
+    ptData->auMatches[uWorker] += ptChunk->uCount;
+}
+
+static void
+pl__ecs_test_nested_chunk(const plEcsQueryChunk* ptChunk, void* pUserData, uint32_t uWorker)
+{
+    // a parallel query from inside a task, must run inline instead of
+    // waiting on the pool it's running on
+    plEcsTestQueryData* ptData = pUserData;
+    plEcsTestQueryData tInner = {0};
+    pl_ecs_run_query(ptData->ptInner, pl__ecs_test_count_chunk, &tInner, true);
+    for(uint32_t i = 0; i < PL_ECS_MAX_WORKERS; i++)
+        ptData->auMatches[uWorker] += tInner.auMatches[i];
+}
+
+static uint32_t
+pl__ecs_test_total(const uint32_t* auValues)
+{
+    uint32_t uTotal = 0;
+    for(uint32_t i = 0; i < PL_ECS_MAX_WORKERS; i++)
+        uTotal += auValues[i];
+    return uTotal;
+}
+
+static void
+ecs_test_queries_0(void* pData)
+{
+    plComponentLibrary tLibrary = {0};
+    const plEcsI* ptEcs = pl__ecs_test_begin(&tLibrary, true);
+
+    // transforms everywhere, lights on evens, hierarchies on every third
+    const uint32_t uEntityCount = 20000;
+    uint32_t uExpectedMatches = 0;
+    uint32_t uExpectedSum = 0;
+    for(uint32_t i = 0; i < uEntityCount; i++)
+    {
+        const plEntity tEntity = ptEcs->create_entity(&tLibrary);
+        ptEcs->create_component(&tLibrary.tTransformComponentManager, tEntity);
+        if(i % 2 == 0)
+        {
+            plLightComponent* ptLight = ptEcs->create_component(&tLibrary.tLightComponentManager, tEntity);
+            ptLight->tColor.x = (float)(i % 7);
+        }
+        if(i % 3 == 0)
+            ptEcs->create_component(&tLibrary.tHierarchyComponentManager, tEntity);
+        if(i % 2 == 0 && i % 3 != 0)
+        {
+            uExpectedMatches++;
+            uExpectedSum += i % 7;
+        }
+    }
+
+    const plEcsQueryDesc tDesc = {
+        .aptInclude = {&tLibrary.tTransformComponentManager, &tLibrary.tLightComponentManager},
+        .aptExclude = {&tLibrary.tHierarchyComponentManager}
+    };
+    plEcsQuery* ptQuery = ptEcs->create_query(&tDesc);
+
+    // serial & parallel agree
+    {
+        plEcsTestQueryData tSerial = {0};
+        ptEcs->run_query(ptQuery, pl__ecs_test_count_chunk, &tSerial, false);
+        pl_test_expect_int_equal((int)pl__ecs_test_total(tSerial.auMatches), (int)uExpectedMatches, NULL);
+        pl_test_expect_int_equal((int)pl__ecs_test_total(tSerial.auLightSums), (int)uExpectedSum, NULL);
+
+        plEcsTestQueryData tParallel = {0};
+        ptEcs->run_query(ptQuery, pl__ecs_test_count_chunk, &tParallel, true);
+        pl_test_expect_int_equal((int)pl__ecs_test_total(tParallel.auMatches), (int)uExpectedMatches, NULL);
+        pl_test_expect_int_equal((int)pl__ecs_test_total(tParallel.auLightSums), (int)uExpectedSum, NULL);
+    }
+
+    // chunks cover every match once, in order
+    {
+        const uint32_t uChunkCount = ptEcs->update_query(ptQuery);
+        uint32_t uCovered = 0;
+        for(uint32_t i = 0; i < uChunkCount; i++)
+        {
+            plEcsQueryChunk tChunk = {0};
+            ptEcs->get_query_chunk(ptQuery, i, &tChunk);
+            pl_test_expect_int_equal((int)tChunk.uFirst, (int)uCovered, NULL);
+            pl_test_expect_true(tChunk.uCount <= PL_ECS_QUERY_CHUNK_SIZE, NULL);
+            uCovered += tChunk.uCount;
+        }
+        pl_test_expect_int_equal((int)uCovered, (int)uExpectedMatches, NULL);
+    }
+
+    // nested parallel dispatch from every outer chunk (used to deadlock)
+    {
+        const plEcsQueryDesc tOuterDesc = {.aptInclude = {&tLibrary.tTransformComponentManager}};
+        plEcsQuery* ptOuter = ptEcs->create_query(&tOuterDesc);
+        const uint32_t uOuterChunks = ptEcs->update_query(ptOuter);
+
+        plEcsTestQueryData tNested = {.ptInner = ptQuery};
+        for(uint32_t i = 0; i < 64; i++)
+        {
+            memset(tNested.auMatches, 0, sizeof(tNested.auMatches));
+            ptEcs->run_query(ptOuter, pl__ecs_test_nested_chunk, &tNested, true);
+            pl_test_expect_int_equal((int)pl__ecs_test_total(tNested.auMatches), (int)(uOuterChunks * uExpectedMatches), NULL);
+        }
+        ptEcs->destroy_query(ptOuter);
+    }
+
+    ptEcs->destroy_query(ptQuery);
+    pl__ecs_test_end(ptEcs, &tLibrary);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] components
+//-----------------------------------------------------------------------------
+
+typedef struct _plEcsTestBody
+{
+    float afMass[3];
+    int*  piOwned; // freed by the destructor
+} plEcsTestBody;
+
+static int giEcsTestLiveBodies = 0;
+
+static void
+pl__ecs_test_construct_body(void* pComponent)
+{
+    plEcsTestBody* ptBody = pComponent;
+    ptBody->afMass[0] = 1.0f;
+    ptBody->afMass[1] = 2.0f;
+    ptBody->afMass[2] = 3.0f;
+    ptBody->piOwned = malloc(sizeof(int));
+    giEcsTestLiveBodies++;
+}
+
+static void
+pl__ecs_test_destruct_body(void* pComponent)
+{
+    plEcsTestBody* ptBody = pComponent;
+    free(ptBody->piOwned);
+    giEcsTestLiveBodies--;
+}
+
+static void
+ecs_test_components_0(void* pData)
+{
+    plComponentLibrary tLibrary = {0};
+    const plEcsI* ptEcs = pl__ecs_test_begin(&tLibrary, false);
+
+    // built in defaults
+    {
+        const plEntity tEntity = ptEcs->create_entity(&tLibrary);
+        const plLightComponent* ptLight = ptEcs->create_component(&tLibrary.tLightComponentManager, tEntity);
+        pl_test_expect_true(ptLight->tColor.x == 1.0f && ptLight->tColor.y == 1.0f && ptLight->tColor.z == 1.0f, NULL);
+
+        const plTransformComponent* ptTransform = ptEcs->create_component(&tLibrary.tTransformComponentManager, tEntity);
+        pl_test_expect_true(ptTransform->tScale.x == 1.0f && ptTransform->tRotation.w == 1.0f, NULL);
+
+        pl_test_expect_true(ptEcs->get_manager(&tLibrary, PL_COMPONENT_TYPE_MESH) == &tLibrary.tMeshComponentManager, NULL);
+        pl_test_expect_int_equal((int)tLibrary.tHierarchyComponentManager.szStride, (int)sizeof(plHierarchyComponent), NULL);
+    }
+
+    // registered types get their own type ids, aligned strides & callbacks
+    const plComponentType tBodyType = ptEcs->register_component(&tLibrary, &(plComponentDesc){
+        .pcName      = "body",
+        .szSize      = sizeof(plEcsTestBody),
+        .szAlignment = 64,
+        .pfConstruct = pl__ecs_test_construct_body,
+        .pfDestruct  = pl__ecs_test_destruct_body
+    });
+    const plComponentType tTinyType = ptEcs->register_component(&tLibrary, &(plComponentDesc){.pcName = "tiny", .szSize = sizeof(char)});
+    pl_test_expect_int_equal(tBodyType, PL_COMPONENT_TYPE_COUNT, NULL);
+    pl_test_expect_int_equal(tTinyType, PL_COMPONENT_TYPE_COUNT + 1, NULL);
+
+    plComponentManager* ptBodies = ptEcs->get_manager(&tLibrary, tBodyType);
+    plComponentManager* ptTinies = ptEcs->get_manager(&tLibrary, tTinyType);
+    pl_test_expect_int_equal((int)ptBodies->szStride, 64, NULL);
+    pl_test_expect_int_equal((int)ptTinies->szStride, 1, NULL);
+
+    // components survive growth & swap removal
+    plEntity atEntities[3000] = {0};
+    for(uint32_t i = 0; i < 3000; i++)
+    {
+        atEntities[i] = ptEcs->create_entity(&tLibrary);
+        plEcsTestBody* ptBody = ptEcs->create_component(ptBodies, atEntities[i]);
+        pl_test_expect_true(((uintptr_t)ptBody & 63) == 0, NULL);
+        pl_test_expect_true(ptBody->afMass[2] == 3.0f, NULL);
+        ptBody->afMass[0] = (float)i;
+        if(i % 2)
+        {
+            char* pcTiny = ptEcs->create_component(ptTinies, atEntities[i]);
+            pl_test_expect_int_equal(*pcTiny, 0, NULL);
+            *pcTiny = (char)(i & 127);
+        }
+    }
+    pl_test_expect_int_equal(giEcsTestLiveBodies, 3000, NULL);
+
+    for(uint32_t i = 0; i < 3000; i += 3)
+    {
+        ptEcs->destroy_entity(&tLibrary, atEntities[i]);
+        atEntities[i] = 0;
+    }
+    pl_test_expect_int_equal(giEcsTestLiveBodies, (int)PL_ECS_COMPONENT_COUNT(ptBodies), NULL);
+    for(uint32_t i = 0; i < 3000; i++)
+    {
+        if(atEntities[i] == 0)
+            continue;
+        pl_test_expect_true(PL_ECS_GET_COMPONENT(ptEcs, ptBodies, atEntities[i], plEcsTestBody)->afMass[0] == (float)i, NULL);
+        if(i % 2)
+            pl_test_expect_int_equal(*PL_ECS_GET_COMPONENT(ptEcs, ptTinies, atEntities[i], char), (int)(i & 127), NULL);
+    }
+
+    // cleanup runs the destructors
+    pl__ecs_test_end(ptEcs, &tLibrary);
+    pl_test_expect_int_equal(giEcsTestLiveBodies, 0, NULL);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] change tracking
+//-----------------------------------------------------------------------------
+
+// records what upload_object_instances sends, no gpu involved
+typedef struct _plEcsTestDevice
+{
+    uint32_t      uCreateCount;
+    uint32_t      uUpdateCount;
+    plBufferRange atRanges[64]; // last update
+    uint32_t      uRangeCount;
+} plEcsTestDevice;
+
+static plEcsTestDevice gtEcsTestDevice = {0};
+
+static uint32_t
+pl__ecs_test_create_storage_buffer(plDevice* ptDevice, size_t szSize, const void* pData, const char* pcName)
+{
+    gtEcsTestDevice.uCreateCount++;
+    return gtEcsTestDevice.uCreateCount;
+}
+
+static void
+pl__ecs_test_update_buffer(plDevice* ptDevice, uint32_t uBufferIndex, const void* pMirror, const plBufferRange* atRanges, uint32_t uRangeCount)
+{
+    gtEcsTestDevice.uUpdateCount++;
+    gtEcsTestDevice.uRangeCount = uRangeCount < 64 ? uRangeCount : 64;
+    memcpy(gtEcsTestDevice.atRanges, atRanges, gtEcsTestDevice.uRangeCount * sizeof(plBufferRange));
+}
+
+static void
+pl__ecs_test_destroy_buffer(plDevice* ptDevice, uint32_t uBufferIndex)
+{
+}
+
+static void
+ecs_test_instances_0(void* pData)
+{
+    static const plDeviceI tDevice = {
+        .create_storage_buffer = pl__ecs_test_create_storage_buffer,
+        .update_buffer         = pl__ecs_test_update_buffer,
+        .destroy_buffer        = pl__ecs_test_destroy_buffer
+    };
+    gptDevice = &tDevice;
+    memset(&gtEcsTestDevice, 0, sizeof(plEcsTestDevice));
+
+    plComponentLibrary tLibrary = {0};
+    const plEcsI* ptEcs = pl__ecs_test_begin(&tLibrary, false);
+    plObjectSystemData* ptData = tLibrary.tObjectComponentManager.pSystemData;
+
+    // root objects sharing one mesh
+    const plEntity tMesh = ptEcs->create_mesh(&tLibrary, "mesh");
+    plEntity atObjects[300] = {0};
+    for(uint32_t i = 0; i < 300; i++)
+    {
+        atObjects[i] = ptEcs->create_entity(&tLibrary);
+        plTransformComponent* ptTransform = ptEcs->create_component(&tLibrary.tTransformComponentManager, atObjects[i]);
+        ptTransform->tFinalTransform = pl_mat4_translate_vec3((plVec3){(float)i, 0.0f, 0.0f});
+        plObjectComponent* ptObject = ptEcs->create_component(&tLibrary.tObjectComponentManager, atObjects[i]);
+        ptObject->tMesh = tMesh;
+        ptObject->tTransform = atObjects[i];
+    }
+
+    // first upload creates the buffer with every instance
+    ptEcs->run_object_update_system(&tLibrary);
+    ptEcs->upload_object_instances(&tLibrary, NULL);
+    pl_test_expect_int_equal((int)gtEcsTestDevice.uCreateCount, 1, NULL);
+    pl_test_expect_int_equal((int)gtEcsTestDevice.uUpdateCount, 1, NULL);
+    pl_test_expect_int_equal((int)gtEcsTestDevice.uRangeCount, 1, NULL);
+    pl_test_expect_int_equal((int)gtEcsTestDevice.atRanges[0].szOffset, 0, NULL);
+    pl_test_expect_int_equal((int)gtEcsTestDevice.atRanges[0].szSize, (int)(300 * sizeof(plObjectInfo)), NULL);
+    pl_test_expect_true(ptData->sbtInstances[7].tModel.col[3].x == 7.0f, NULL);
+
+    // static scene uploads nothing
+    for(uint32_t i = 0; i < 3; i++)
+    {
+        ptEcs->run_object_update_system(&tLibrary);
+        ptEcs->upload_object_instances(&tLibrary, NULL);
+    }
+    pl_test_expect_int_equal((int)gtEcsTestDevice.uUpdateCount, 1, NULL);
+    pl_test_expect_false(ptData->bDirty, NULL);
+
+    // a moved object uploads only its own instance
+    const uint32_t uMoved = (uint32_t)ptEcs->get_index(&tLibrary.tObjectComponentManager, atObjects[150]);
+    plTransformComponent* ptMovedTransform = ptEcs->get_component(&tLibrary.tTransformComponentManager, atObjects[150]);
+    ptMovedTransform->tFinalTransform.col[3].y = 5.0f;
+    ptMovedTransform->bDirty = true;
+    ptEcs->run_object_update_system(&tLibrary);
+    ptEcs->upload_object_instances(&tLibrary, NULL);
+    pl_test_expect_int_equal((int)gtEcsTestDevice.uUpdateCount, 2, NULL);
+    pl_test_expect_int_equal((int)gtEcsTestDevice.uRangeCount, 1, NULL);
+    pl_test_expect_int_equal((int)gtEcsTestDevice.atRanges[0].szOffset, (int)(uMoved * sizeof(plObjectInfo)), NULL);
+    pl_test_expect_int_equal((int)gtEcsTestDevice.atRanges[0].szSize, (int)sizeof(plObjectInfo), NULL);
+    pl_test_expect_true(ptData->sbtInstances[uMoved].tModel.col[3].y == 5.0f, NULL);
+    pl_test_expect_int_equal((int)gtEcsTestDevice.uCreateCount, 1, NULL);
+
+    pl__ecs_test_end(ptEcs, &tLibrary);
+    gptDevice = NULL;
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] entities
+//-----------------------------------------------------------------------------
+
+static void
+ecs_test_entities_0(void* pData)
+{
+    plComponentLibrary tLibrary = {0};
+    const plEcsI* ptEcs = pl__ecs_test_begin(&tLibrary, false);
+    plComponentManager* ptLightManager = &tLibrary.tLightComponentManager;
+
+    // destroyed handles go stale, the index comes back with a new generation
+    const plEntity tOld = ptEcs->create_entity(&tLibrary);
+    ptEcs->create_component(ptLightManager, tOld);
+    pl_test_expect_true(ptEcs->is_entity_valid(&tLibrary, tOld), NULL);
+    pl_test_expect_true(ptEcs->has_entity(ptLightManager, tOld), NULL);
+    ptEcs->destroy_entity(&tLibrary, tOld);
+    pl_test_expect_false(ptEcs->is_entity_valid(&tLibrary, tOld), NULL);
+    pl_test_expect_false(ptEcs->has_entity(ptLightManager, tOld), NULL);
+
+    const plEntity tNew = ptEcs->create_entity(&tLibrary);
+    pl_test_expect_int_equal((int)PL_ENTITY_INDEX(tNew), (int)PL_ENTITY_INDEX(tOld), NULL);
+    pl_test_expect_int_equal((int)PL_ENTITY_GENERATION(tNew), (int)PL_ENTITY_GENERATION(tOld) + 1, NULL);
+    pl_test_expect_true(ptEcs->is_entity_valid(&tLibrary, tNew), NULL);
+    pl_test_expect_false(ptEcs->has_entity(ptLightManager, tNew), NULL);
+
+    // same index, so only the generation keeps the old handle out
+    ptEcs->create_component(ptLightManager, tNew);
+    pl_test_expect_true(ptEcs->has_entity(ptLightManager, tNew), NULL);
+    pl_test_expect_false(ptEcs->has_entity(ptLightManager, tOld), NULL);
+    pl_test_expect_false(ptEcs->is_entity_valid(&tLibrary, PL_INVALID_ENTITY_HANDLE), NULL);
+
+    // sbtMeshes follows the mesh manager's layout
+    plComponentManager* ptMeshManager = &tLibrary.tMeshComponentManager;
+    plObjectSystemData* ptData = tLibrary.tObjectComponentManager.pSystemData;
+    const plEntity tFirstMesh = ptEcs->create_mesh(&tLibrary, "first");
+    const plEntity tMesh = ptEcs->create_mesh(&tLibrary, "second");
+    const plEntity tObject = ptEcs->create_entity(&tLibrary);
+    ptEcs->create_component(&tLibrary.tTransformComponentManager, tObject);
+    plObjectComponent* ptObject = ptEcs->create_component(&tLibrary.tObjectComponentManager, tObject);
+    ptObject->tMesh = tMesh;
+    ptObject->tTransform = tObject;
+    ptEcs->run_object_update_system(&tLibrary);
+    pl_test_expect_int_equal((int)pl_sb_size(ptData->sbtMeshes), 1, NULL);
+    pl_test_expect_true(ptData->sbtMeshes[0] == ptEcs->get_component(ptMeshManager, tMesh), NULL);
+
+    // removing the first mesh swaps the second into its slot
+    const uint32_t uLayoutVersion = ptMeshManager->uLayoutVersion;
+    ptEcs->destroy_entity(&tLibrary, tFirstMesh);
+    pl_test_expect_true(ptMeshManager->uLayoutVersion != uLayoutVersion, NULL);
+    pl_test_expect_int_equal((int)ptEcs->get_index(ptMeshManager, tMesh), 0, NULL);
+    ptEcs->run_object_update_system(&tLibrary);
+    pl_test_expect_int_equal((int)pl_sb_size(ptData->sbtMeshes), 1, NULL);
+    pl_test_expect_true(ptData->sbtMeshes[0] == ptEcs->get_component(ptMeshManager, tMesh), NULL);
+
+    // enough new meshes to reallocate the storage
+    for(uint32_t i = 0; i < 1000; i++)
+        ptEcs->create_mesh(&tLibrary, NULL);
+    ptEcs->run_object_update_system(&tLibrary);
+    pl_test_expect_true(ptData->sbtMeshes[0] == ptEcs->get_component(ptMeshManager, tMesh), NULL);
+
+    pl__ecs_test_end(ptEcs, &tLibrary);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] sparse sets
+//-----------------------------------------------------------------------------
+
+static void
+ecs_test_sparse_sets_0(void* pData)
+{
+    plComponentLibrary tLibrary = {0};
+    const plEcsI* ptEcs = pl__ecs_test_begin(&tLibrary, false);
+    plComponentManager* ptManager = &tLibrary.tLightComponentManager;
+
+    // indices spanning several sparse pages, every other one owns a light
+    const uint32_t uEntityCount = PL_ECS_SPARSE_PAGE_SIZE * 3;
+    plEntity* sbtEntities = NULL;
+    for(uint32_t i = 0; i < uEntityCount; i++)
+        pl_sb_push(sbtEntities, ptEcs->create_entity(&tLibrary));
+    for(uint32_t i = 0; i < uEntityCount; i += 2)
+    {
+        plLightComponent* ptLight = ptEcs->create_component(ptManager, sbtEntities[i]);
+        ptLight->tColor.x = (float)i;
+    }
+    pl_test_expect_int_equal((int)pl_sb_size(ptManager->sbtEntities), (int)uEntityCount / 2, NULL);
+    pl_test_expect_false(ptEcs->has_entity(ptManager, sbtEntities[1]), NULL);
+    pl_test_expect_false(ptEcs->has_entity(ptManager, sbtEntities[uEntityCount - 1]), NULL);
+    pl_test_expect_int_equal((int)ptEcs->get_index(ptManager, sbtEntities[10]), 5, NULL);
+
+    // swap removal moves the last component into the hole
+    const plEntity tLast = pl_sb_back(ptManager->sbtEntities);
+    ptEcs->remove_component(ptManager, sbtEntities[10]);
+    pl_test_expect_false(ptEcs->has_entity(ptManager, sbtEntities[10]), NULL);
+    pl_test_expect_true(ptEcs->has_entity(ptManager, tLast), NULL);
+    pl_test_expect_int_equal((int)ptEcs->get_index(ptManager, tLast), 5, NULL);
+    pl_test_expect_true(ptManager->sbtEntities[5] == tLast, NULL);
+    pl_test_expect_true(((plLightComponent*)ptEcs->get_component(ptManager, tLast))->tColor.x == (float)(uEntityCount - 2), NULL);
+
+    // every survivor still maps to its own component
+    bool bAllMatch = true;
+    for(uint32_t i = 0; i < uEntityCount; i += 2)
+    {
+        if(i == 10)
+            continue;
+        const plLightComponent* ptLight = ptEcs->get_component(ptManager, sbtEntities[i]);
+        bAllMatch = bAllMatch && ptLight->tColor.x == (float)i && ptManager->sbtEntities[ptEcs->get_index(ptManager, sbtEntities[i])] == sbtEntities[i];
+    }
+    pl_test_expect_true(bAllMatch, NULL);
+
+    // removing the last component leaves nothing to swap
+    const plEntity tTail = pl_sb_back(ptManager->sbtEntities);
+    ptEcs->remove_component(ptManager, tTail);
+    pl_test_expect_false(ptEcs->has_entity(ptManager, tTail), NULL);
+    pl_test_expect_int_equal((int)pl_sb_size(ptManager->sbtEntities), (int)uEntityCount / 2 - 2, NULL);
+
+    // re-adding reuses the cleared slot
+    ptEcs->create_component(ptManager, sbtEntities[10]);
+    pl_test_expect_int_equal((int)ptEcs->get_index(ptManager, sbtEntities[10]), (int)uEntityCount / 2 - 2, NULL);
+
+    pl_sb_free(sbtEntities);
+    pl__ecs_test_end(ptEcs, &tLibrary);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] hierarchy
+//-----------------------------------------------------------------------------
+
+static plVec3
+pl__ecs_test_world_translation(const plEcsI* ptEcs, plComponentLibrary* ptLibrary, plEntity tEntity)
+{
+    const plTransformComponent* ptTransform = ptEcs->get_component(&ptLibrary->tTransformComponentManager, tEntity);
+    return ptTransform->tFinalTransform.col[3].xyz;
+}
+
+static void
+ecs_test_hierarchy_0(void* pData)
+{
+    plComponentLibrary tLibrary = {0};
+    const plEcsI* ptEcs = pl__ecs_test_begin(&tLibrary, false);
+    plComponentManager* ptTransformManager = &tLibrary.tTransformComponentManager;
+
+    // root <- a <- b <- c, each one unit further along x
+    plEntity atChain[4] = {0};
+    for(uint32_t i = 0; i < 4; i++)
+    {
+        atChain[i] = ptEcs->create_transform(&tLibrary, NULL);
+        plTransformComponent* ptTransform = ptEcs->get_component(ptTransformManager, atChain[i]);
+        ptTransform->tWorld = pl_mat4_translate_vec3((plVec3){1.0f, 0.0f, 0.0f});
+        ptTransform->tFinalTransform = ptTransform->tWorld;
+        if(i > 0)
+            ptEcs->attach_component(&tLibrary, atChain[i], atChain[i - 1]);
+    }
+    ptEcs->run_hierarchy_update_system(&tLibrary);
+    pl_test_expect_true(pl__ecs_test_world_translation(ptEcs, &tLibrary, atChain[1]).x == 2.0f, NULL);
+    pl_test_expect_true(pl__ecs_test_world_translation(ptEcs, &tLibrary, atChain[3]).x == 4.0f, NULL);
+
+    // a moved parent carries its subtree along
+    plTransformComponent* ptMoved = ptEcs->get_component(ptTransformManager, atChain[1]);
+    ptMoved->tWorld = pl_mat4_translate_vec3((plVec3){1.0f, 3.0f, 0.0f});
+    ptMoved->bDirty = true;
+    ptEcs->run_hierarchy_update_system(&tLibrary);
+    pl_test_expect_true(pl__ecs_test_world_translation(ptEcs, &tLibrary, atChain[1]).y == 3.0f, NULL);
+    pl_test_expect_true(pl__ecs_test_world_translation(ptEcs, &tLibrary, atChain[3]).y == 3.0f, NULL);
+    pl_test_expect_true(pl__ecs_test_world_translation(ptEcs, &tLibrary, atChain[3]).x == 4.0f, NULL);
+    pl_test_expect_false(ptMoved->bDirty, NULL);
+
+    // a cycle (a <- b <- c <- a) is cut at one link instead of looping forever
+    ptEcs->attach_component(&tLibrary, atChain[1], atChain[3]);
+    ptEcs->run_hierarchy_update_system(&tLibrary);
+    uint32_t uDetached = 0;
+    for(uint32_t i = 1; i < 4; i++)
+    {
+        const plHierarchyComponent* ptHierarchy = ptEcs->get_component(&tLibrary.tHierarchyComponentManager, atChain[i]);
+        if(ptHierarchy->tParent == PL_INVALID_ENTITY_HANDLE)
+            uDetached++;
+    }
+    pl_test_expect_int_equal((int)uDetached, 1, NULL);
+    ptEcs->run_hierarchy_update_system(&tLibrary);
+
+    // a destroyed parent leaves its child acting as a root
+    plEntity tParent = ptEcs->create_transform(&tLibrary, NULL);
+    plEntity tChild = ptEcs->create_transform(&tLibrary, NULL);
+    ((plTransformComponent*)ptEcs->get_component(ptTransformManager, tParent))->tFinalTransform = pl_mat4_translate_vec3((plVec3){10.0f, 0.0f, 0.0f});
+    ((plTransformComponent*)ptEcs->get_component(ptTransformManager, tChild))->tWorld = pl_mat4_translate_vec3((plVec3){1.0f, 0.0f, 0.0f});
+    ptEcs->attach_component(&tLibrary, tChild, tParent);
+    ptEcs->run_hierarchy_update_system(&tLibrary);
+    pl_test_expect_true(pl__ecs_test_world_translation(ptEcs, &tLibrary, tChild).x == 11.0f, NULL);
+    ptEcs->destroy_entity(&tLibrary, tParent);
+    ptEcs->run_hierarchy_update_system(&tLibrary);
+    pl_test_expect_true(pl__ecs_test_world_translation(ptEcs, &tLibrary, tChild).x == 1.0f, NULL);
+
+    pl__ecs_test_end(ptEcs, &tLibrary);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] transform kernels
+//-----------------------------------------------------------------------------
+
+#define PL_ECS_TEST_KERNEL_COUNT 517 // odd, so every backend runs its tail
+
+static float
+pl__ecs_test_max_error(const plMat4* atA, const plMat4* atB, uint32_t uCount)
+{
+    float fMaxError = 0.0f;
+    for(uint32_t i = 0; i < uCount; i++)
+    {
+        for(uint32_t j = 0; j < 16; j++)
+            fMaxError = pl_maxf(fMaxError, fabsf(atA[i].d[j] - atB[i].d[j]) / (1.0f + fabsf(atB[i].d[j])));
+    }
+    return fMaxError;
+}
+
+static void
+ecs_test_kernels_0(void* pData)
+{
+    static plMat4 atA[PL_ECS_TEST_KERNEL_COUNT];
+    static plMat4 atB[PL_ECS_TEST_KERNEL_COUNT];
+    static plVec3 atScales[PL_ECS_TEST_KERNEL_COUNT];
+    static plVec4 atRotations[PL_ECS_TEST_KERNEL_COUNT];
+    static plVec3 atTranslations[PL_ECS_TEST_KERNEL_COUNT];
+    static plMat4 atScalar[3][PL_ECS_TEST_KERNEL_COUNT];
+    static plMat4 atOut[PL_ECS_TEST_KERNEL_COUNT];
+    static plMat4 atAliased[PL_ECS_TEST_KERNEL_COUNT];
+
+    // well conditioned inputs (diagonal bias keeps atA invertible)
+    srand(7);
+    for(uint32_t i = 0; i < PL_ECS_TEST_KERNEL_COUNT; i++)
+    {
+        for(uint32_t j = 0; j < 16; j++)
+        {
+            atA[i].d[j] = (float)rand() / (float)RAND_MAX - 0.5f;
+            atB[i].d[j] = (float)rand() / (float)RAND_MAX - 0.5f;
+        }
+        for(uint32_t j = 0; j < 4; j++)
+            atA[i].d[j * 5] += 3.0f;
+        atScales[i] = (plVec3){1.0f + (float)(i % 7), 2.0f, 0.5f};
+        atRotations[i] = pl_norm_vec4((plVec4){(float)(i % 5), 1.0f, (float)(i % 3), 2.0f});
+        atTranslations[i] = (plVec3){(float)i, -(float)i, 0.25f};
+    }
+
+    // scalar results are the reference, the scalar inverse is checked on its own
+    pl_test_expect_true(pl__set_transform_backend(PL_TRANSFORM_BACKEND_SCALAR), NULL);
+    gtTransformKernels.mul_mat4(atA, atB, atScalar[0], PL_ECS_TEST_KERNEL_COUNT);
+    gtTransformKernels.compose_trs(atScales, atRotations, atTranslations, atScalar[1], PL_ECS_TEST_KERNEL_COUNT);
+    gtTransformKernels.invert_mat4(atA, atScalar[2], PL_ECS_TEST_KERNEL_COUNT);
+    for(uint32_t i = 0; i < PL_ECS_TEST_KERNEL_COUNT; i++)
+        atOut[i] = pl_identity_mat4();
+    gtTransformKernels.mul_mat4(atA, atScalar[2], atAliased, PL_ECS_TEST_KERNEL_COUNT);
+    pl_test_expect_true(pl__ecs_test_max_error(atAliased, atOut, PL_ECS_TEST_KERNEL_COUNT) < 1e-4f, NULL);
+    pl_test_expect_true(atScalar[1][9].col[3].x == 9.0f && atScalar[1][9].col[3].w == 1.0f, NULL);
+
+    for(int iBackend = PL_TRANSFORM_BACKEND_SCALAR + 1; iBackend < PL_TRANSFORM_BACKEND_COUNT; iBackend++)
+    {
+        if(!pl__set_transform_backend((plTransformBackend)iBackend))
+            continue; // not built or not supported by this cpu
+
+        // short counts only hit the tails
+        for(uint32_t uCount = 1; uCount <= 9; uCount++)
+        {
+            gtTransformKernels.mul_mat4(atA, atB, atOut, uCount);
+            pl_test_expect_true(pl__ecs_test_max_error(atOut, atScalar[0], uCount) < 1e-5f, pl__get_transform_backend_name(iBackend));
+        }
+
+        gtTransformKernels.mul_mat4(atA, atB, atOut, PL_ECS_TEST_KERNEL_COUNT);
+        pl_test_expect_true(pl__ecs_test_max_error(atOut, atScalar[0], PL_ECS_TEST_KERNEL_COUNT) < 1e-5f, pl__get_transform_backend_name(iBackend));
+        gtTransformKernels.compose_trs(atScales, atRotations, atTranslations, atOut, PL_ECS_TEST_KERNEL_COUNT);
+        pl_test_expect_true(pl__ecs_test_max_error(atOut, atScalar[1], PL_ECS_TEST_KERNEL_COUNT) < 1e-5f, pl__get_transform_backend_name(iBackend));
+        gtTransformKernels.invert_mat4(atA, atOut, PL_ECS_TEST_KERNEL_COUNT);
+        pl_test_expect_true(pl__ecs_test_max_error(atOut, atScalar[2], PL_ECS_TEST_KERNEL_COUNT) < 1e-4f, pl__get_transform_backend_name(iBackend));
+
+        // output may alias an input (the hierarchy batches do)
+        memcpy(atAliased, atA, sizeof(atA));
+        gtTransformKernels.mul_mat4(atAliased, atB, atAliased, PL_ECS_TEST_KERNEL_COUNT);
+        pl_test_expect_true(pl__ecs_test_max_error(atAliased, atScalar[0], PL_ECS_TEST_KERNEL_COUNT) < 1e-5f, pl__get_transform_backend_name(iBackend));
+        memcpy(atAliased, atA, sizeof(atA));
+        gtTransformKernels.invert_mat4(atAliased, atAliased, PL_ECS_TEST_KERNEL_COUNT);
+        pl_test_expect_true(pl__ecs_test_max_error(atAliased, atScalar[2], PL_ECS_TEST_KERNEL_COUNT) < 1e-4f, pl__get_transform_backend_name(iBackend));
+    }
+
+    pl__set_transform_backend(PL_TRANSFORM_BACKEND_AUTO);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] soa transforms
+//-----------------------------------------------------------------------------
+
+#define PL_ECS_TEST_SOA_COUNT 2000
+
+static plMat4*
+pl__ecs_test_local(const plEcsI* ptEcs, plComponentLibrary* ptLibrary, plEntity tEntity)
+{
+    plComponentManager* ptManager = &ptLibrary->tTransformComponentManager;
+    plTransformColumns tColumns = {0};
+    if(ptEcs->get_transform_columns(ptLibrary, &tColumns))
+        return &tColumns.atLocals[ptEcs->get_index(ptManager, tEntity)];
+    return &((plTransformComponent*)ptEcs->get_component(ptManager, tEntity))->tWorld;
+}
+
+static plMat4*
+pl__ecs_test_world(const plEcsI* ptEcs, plComponentLibrary* ptLibrary, plEntity tEntity)
+{
+    plComponentManager* ptManager = &ptLibrary->tTransformComponentManager;
+    plTransformColumns tColumns = {0};
+    if(ptEcs->get_transform_columns(ptLibrary, &tColumns))
+        return &tColumns.atWorlds[ptEcs->get_index(ptManager, tEntity)];
+    return &((plTransformComponent*)ptEcs->get_component(ptManager, tEntity))->tFinalTransform;
+}
+
+static void
+pl__ecs_test_set_dirty(const plEcsI* ptEcs, plComponentLibrary* ptLibrary, plEntity tEntity)
+{
+    plComponentManager* ptManager = &ptLibrary->tTransformComponentManager;
+    plTransformColumns tColumns = {0};
+    if(ptEcs->get_transform_columns(ptLibrary, &tColumns))
+        PL_TRANSFORM_SET_DIRTY(&tColumns, (uint32_t)ptEcs->get_index(ptManager, tEntity));
+    else
+        ((plTransformComponent*)ptEcs->get_component(ptManager, tEntity))->bDirty = true;
+}
+
+static void
+ecs_test_soa_0(void* pData)
+{
+    // same scene in both layouts, soa worlds must match aos bit for bit
+    static plEntity atEntities[2][PL_ECS_TEST_SOA_COUNT];
+    plComponentLibrary atLibraries[2] = {0};
+    const plEcsI* ptEcs = NULL;
+    for(uint32_t uLayout = 0; uLayout < 2; uLayout++)
+    {
+        plComponentLibrary* ptLibrary = &atLibraries[uLayout];
+        ptEcs = pl__ecs_test_begin(ptLibrary, false);
+        ptEcs->set_transform_layout(ptLibrary, uLayout ? PL_TRANSFORM_LAYOUT_SOA : PL_TRANSFORM_LAYOUT_AOS);
+        plTransformColumns tColumns = {0};
+        pl_test_expect_true(ptEcs->get_transform_columns(ptLibrary, &tColumns) == (uLayout == 1), NULL);
+
+        srand(11);
+        for(uint32_t i = 0; i < PL_ECS_TEST_SOA_COUNT; i++)
+        {
+            atEntities[uLayout][i] = ptEcs->create_transform(ptLibrary, NULL);
+            *pl__ecs_test_local(ptEcs, ptLibrary, atEntities[uLayout][i]) = pl_mat4_translate_vec3((plVec3){0.01f * (float)(rand() % 100), 0.5f, 0.0f});
+            if(i > 0)
+                ptEcs->attach_component(ptLibrary, atEntities[uLayout][i], atEntities[uLayout][rand() % i]);
+        }
+
+        // destroying swaps dense indices around
+        for(uint32_t i = 1; i < PL_ECS_TEST_SOA_COUNT; i += 97)
+        {
+            ptEcs->destroy_entity(ptLibrary, atEntities[uLayout][i]);
+            atEntities[uLayout][i] = PL_INVALID_ENTITY_HANDLE;
+        }
+        ptEcs->run_hierarchy_update_system(ptLibrary);
+    }
+
+    bool bMatch = true;
+    for(uint32_t i = 0; i < PL_ECS_TEST_SOA_COUNT; i++)
+    {
+        if(atEntities[0][i] != PL_INVALID_ENTITY_HANDLE)
+            bMatch = bMatch && memcmp(pl__ecs_test_world(ptEcs, &atLibraries[0], atEntities[0][i]), pl__ecs_test_world(ptEcs, &atLibraries[1], atEntities[1][i]), sizeof(plMat4)) == 0;
+    }
+    pl_test_expect_true(bMatch, NULL);
+
+    // incremental update from a few dirty locals
+    for(uint32_t i = 1; i < PL_ECS_TEST_SOA_COUNT; i += 113)
+    {
+        if(atEntities[0][i] == PL_INVALID_ENTITY_HANDLE)
+            continue;
+        for(uint32_t uLayout = 0; uLayout < 2; uLayout++)
+        {
+            *pl__ecs_test_local(ptEcs, &atLibraries[uLayout], atEntities[uLayout][i]) = pl_mat4_translate_vec3((plVec3){1.0f, 2.0f, 3.0f});
+            pl__ecs_test_set_dirty(ptEcs, &atLibraries[uLayout], atEntities[uLayout][i]);
+        }
+    }
+    for(uint32_t uLayout = 0; uLayout < 2; uLayout++)
+        ptEcs->run_hierarchy_update_system(&atLibraries[uLayout]);
+    bMatch = true;
+    for(uint32_t i = 0; i < PL_ECS_TEST_SOA_COUNT; i++)
+    {
+        if(atEntities[0][i] != PL_INVALID_ENTITY_HANDLE)
+            bMatch = bMatch && memcmp(pl__ecs_test_world(ptEcs, &atLibraries[0], atEntities[0][i]), pl__ecs_test_world(ptEcs, &atLibraries[1], atEntities[1][i]), sizeof(plMat4)) == 0;
+    }
+    pl_test_expect_true(bMatch, NULL);
+
+    // the hierarchy system clears every dirty bit
+    plTransformColumns tColumns = {0};
+    ptEcs->get_transform_columns(&atLibraries[1], &tColumns);
+    bool bAnyDirty = false;
+    for(uint32_t i = 0; i < (tColumns.uCount + 63) / 64; i++)
+        bAnyDirty = bAnyDirty || tColumns.auDirtyBits[i] != 0;
+    pl_test_expect_false(bAnyDirty, NULL);
+
+    // composing rebuilds every local & marks only live transforms dirty
+    ptEcs->compose_transform_columns(&tColumns);
+    bool bComposed = true;
+    for(uint32_t i = 0; i < tColumns.uCount; i++)
+        bComposed = bComposed && PL_TRANSFORM_IS_DIRTY(&tColumns, i) && tColumns.atLocals[i].col[3].w == 1.0f && tColumns.atLocals[i].col[0].x == 1.0f;
+    pl_test_expect_true(bComposed, NULL);
+    if(tColumns.uCount % 64)
+        pl_test_expect_true((tColumns.auDirtyBits[tColumns.uCount / 64] >> (tColumns.uCount % 64)) == 0, NULL);
+
+    for(uint32_t uLayout = 0; uLayout < 2; uLayout++)
+        pl__ecs_test_end(ptEcs, &atLibraries[uLayout]);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] names
+//-----------------------------------------------------------------------------
+
+#define PL_ECS_TEST_NAME_COUNT 3000
+
+static void
+ecs_test_names_0(void* pData)
+{
+    plComponentLibrary tLibrary = {0};
+    const plEcsI* ptEcs = pl__ecs_test_begin(&tLibrary, false);
+    pl_test_expect_int_equal((int)sizeof(plTagComponent), 4, NULL);
+
+    // every tenth entity shares a name
+    static plEntity atEntities[PL_ECS_TEST_NAME_COUNT];
+    char acName[64] = {0};
+    for(uint32_t i = 0; i < PL_ECS_TEST_NAME_COUNT; i++)
+    {
+        snprintf(acName, 64, "entity_%u", i);
+        atEntities[i] = ptEcs->create_transform(&tLibrary, i % 10 == 0 ? "shared" : acName);
+    }
+    bool bAllFound = true;
+    for(uint32_t i = 0; i < PL_ECS_TEST_NAME_COUNT; i++)
+    {
+        if(i % 10 == 0)
+            continue;
+        snprintf(acName, 64, "entity_%u", i);
+        bAllFound = bAllFound && ptEcs->get_entity(&tLibrary, acName) == atEntities[i] && strcmp(ptEcs->get_name(&tLibrary, atEntities[i]), acName) == 0;
+    }
+    pl_test_expect_true(bAllFound, NULL);
+    pl_test_expect_true(ptEcs->get_entity(&tLibrary, "shared") == atEntities[0], NULL);
+    pl_test_expect_true(ptEcs->get_entity(&tLibrary, "missing") == PL_INVALID_ENTITY_HANDLE, NULL);
+
+    // interned ids
+    pl_test_expect_int_equal((int)ptEcs->intern_string(&tLibrary, "shared"), (int)ptEcs->intern_string(&tLibrary, "shared"), NULL);
+    pl_test_expect_int_equal((int)ptEcs->intern_string(&tLibrary, ""), 0, NULL);
+    pl_test_expect_string_equal(ptEcs->get_string(&tLibrary, 0), "", NULL);
+
+    // a shared name falls to another holder, then to nobody
+    ptEcs->destroy_entity(&tLibrary, atEntities[0]);
+    const plEntity tShared = ptEcs->get_entity(&tLibrary, "shared");
+    pl_test_expect_true(tShared != PL_INVALID_ENTITY_HANDLE && tShared != atEntities[0], NULL);
+    pl_test_expect_string_equal(ptEcs->get_name(&tLibrary, tShared), "shared", NULL);
+    for(uint32_t i = 10; i < PL_ECS_TEST_NAME_COUNT; i += 10)
+        ptEcs->destroy_entity(&tLibrary, atEntities[i]);
+    pl_test_expect_true(ptEcs->get_entity(&tLibrary, "shared") == PL_INVALID_ENTITY_HANDLE, NULL);
+
+    // renaming releases the old name
+    ptEcs->set_name(&tLibrary, atEntities[5], "renamed");
+    pl_test_expect_true(ptEcs->get_entity(&tLibrary, "entity_5") == PL_INVALID_ENTITY_HANDLE, NULL);
+    pl_test_expect_true(ptEcs->get_entity(&tLibrary, "renamed") == atEntities[5], NULL);
+
+    // colliding set_name keeps the first holder until it lets go
+    const plEntity tBare = ptEcs->create_entity(&tLibrary);
+    pl_test_expect_true(ptEcs->get_name(&tLibrary, tBare) == NULL, NULL);
+    ptEcs->set_name(&tLibrary, tBare, "renamed");
+    pl_test_expect_true(ptEcs->get_entity(&tLibrary, "renamed") == atEntities[5], NULL);
+    ptEcs->remove_component(&tLibrary.tTagComponentManager, atEntities[5]);
+    pl_test_expect_true(ptEcs->get_entity(&tLibrary, "renamed") == tBare, NULL);
+
+    // unnamed & strings longer than a block
+    const plEntity tUnnamed = ptEcs->create_mesh(&tLibrary, NULL);
+    pl_test_expect_string_equal(ptEcs->get_name(&tLibrary, tUnnamed), "unnamed", NULL);
+    char* pcLong = malloc(PL_ECS_STRING_BLOCK_SIZE * 2);
+    memset(pcLong, 'a', PL_ECS_STRING_BLOCK_SIZE * 2 - 1);
+    pcLong[PL_ECS_STRING_BLOCK_SIZE * 2 - 1] = 0;
+    ptEcs->set_name(&tLibrary, tUnnamed, pcLong);
+    pl_test_expect_true(ptEcs->get_entity(&tLibrary, pcLong) == tUnnamed, NULL);
+    free(pcLong);
+
+    pl__ecs_test_end(ptEcs, &tLibrary);
+}
+
+//-----------------------------------------------------------------------------
+// [SECTION] mesh frames
+//-----------------------------------------------------------------------------
+
+// (n + 1)^2 vertices in the xy plane or wrapped around the unit sphere
+static void
+pl__ecs_test_grid(plMeshComponent* ptMesh, uint32_t uSize, bool bMirrorU, bool bSphere)
+{
+    memset(ptMesh, 0, sizeof(plMeshComponent));
+    for(uint32_t j = 0; j <= uSize; j++)
+    {
+        for(uint32_t i = 0; i <= uSize; i++)
+        {
+            const float fU = (float)i / (float)uSize;
+            const float fV = (float)j / (float)uSize;
+            plVec3 tPosition = {fU, fV, 0.0f};
+            if(bSphere)
+            {
+                const float fTheta = fU * 6.2831853f;
+                const float fPhi = 0.05f + fV * 3.0415f;
+                tPosition = (plVec3){sinf(fPhi) * cosf(fTheta), sinf(fPhi) * sinf(fTheta), cosf(fPhi)};
+            }
+            pl_sb_push(ptMesh->sbtVertexPositions, tPosition);
+            pl_sb_push(ptMesh->sbtVertexTextureCoordinates0, ((plVec2){bMirrorU ? -fU : fU, fV}));
+        }
+    }
+    for(uint32_t j = 0; j < uSize; j++)
+    {
+        for(uint32_t i = 0; i < uSize; i++)
+        {
+            const uint32_t uA = j * (uSize + 1) + i;
+            const uint32_t uC = uA + uSize + 1;
+            pl_sb_push(ptMesh->sbuIndices, uA);
+            pl_sb_push(ptMesh->sbuIndices, uA + 1);
+            pl_sb_push(ptMesh->sbuIndices, uC + 1);
+            pl_sb_push(ptMesh->sbuIndices, uA);
+            pl_sb_push(ptMesh->sbuIndices, uC + 1);
+            pl_sb_push(ptMesh->sbuIndices, uC);
+        }
+    }
+}
+
+static void
+pl__ecs_test_free_grid(plMeshComponent* ptMesh)
+{
+    pl_sb_free(ptMesh->sbtVertexPositions);
+    pl_sb_free(ptMesh->sbtVertexTextureCoordinates0);
+    pl_sb_free(ptMesh->sbtVertexNormals);
+    pl_sb_free(ptMesh->sbtVertexTangents);
+    pl_sb_free(ptMesh->sbuIndices);
+}
+
+static void
+ecs_test_mesh_frames_0(void* pData)
+{
+    plComponentLibrary tLibrary = {0};
+    const plEcsI* ptEcs = pl__ecs_test_begin(&tLibrary, false);
+    plMeshComponent tMesh = {0};
+
+    // flat plane, +z normals & +x tangents
+    pl__ecs_test_grid(&tMesh, 40, false, false);
+    ptEcs->calculate_tangents(&tMesh, 1);
+    pl_test_expect_int_equal((int)pl_sb_size(tMesh.sbtVertexNormals), (int)pl_sb_size(tMesh.sbtVertexPositions), NULL);
+    bool bFlat = true;
+    for(uint32_t i = 0; i < pl_sb_size(tMesh.sbtVertexPositions); i++)
+        bFlat = bFlat && fabsf(tMesh.sbtVertexNormals[i].z - 1.0f) < 1e-5f && fabsf(tMesh.sbtVertexTangents[i].x - 1.0f) < 1e-5f && tMesh.sbtVertexTangents[i].w == 1.0f;
+    pl_test_expect_true(bFlat, NULL);
+    pl__ecs_test_free_grid(&tMesh);
+
+    // mirrored uvs flip the handedness
+    pl__ecs_test_grid(&tMesh, 41, true, false);
+    ptEcs->calculate_tangents(&tMesh, 1);
+    bool bMirrored = true;
+    for(uint32_t i = 0; i < pl_sb_size(tMesh.sbtVertexPositions); i++)
+        bMirrored = bMirrored && fabsf(tMesh.sbtVertexTangents[i].x + 1.0f) < 1e-5f && tMesh.sbtVertexTangents[i].w == -1.0f;
+    pl_test_expect_true(bMirrored, NULL);
+
+    // degenerate uvs still give unit tangents in the surface
+    for(uint32_t i = 0; i < pl_sb_size(tMesh.sbtVertexTextureCoordinates0); i++)
+        tMesh.sbtVertexTextureCoordinates0[i] = (plVec2){0.5f, 0.5f};
+    pl_sb_reset(tMesh.sbtVertexNormals);
+    pl_sb_reset(tMesh.sbtVertexTangents);
+    ptEcs->calculate_tangents(&tMesh, 1);
+    bool bUnit = true;
+    for(uint32_t i = 0; i < pl_sb_size(tMesh.sbtVertexPositions); i++)
+    {
+        const plVec4 tTangent = tMesh.sbtVertexTangents[i];
+        bUnit = bUnit && fabsf(pl_dot_vec3(tTangent.xyz, tTangent.xyz) - 1.0f) < 1e-4f && fabsf(tTangent.z) < 1e-5f;
+    }
+    pl_test_expect_true(bUnit, NULL);
+    pl__ecs_test_free_grid(&tMesh);
+
+    // area weighted: big xy triangle & small xz triangle share vertex 0
+    plMeshComponent tFan = {0};
+    const plVec3 atFanPositions[] = {{0.0f, 0.0f, 0.0f}, {10.0f, 0.0f, 0.0f}, {0.0f, 10.0f, 0.0f}, {0.0f, 0.0f, -1.0f}};
+    const uint32_t auFanIndices[] = {0, 1, 2, 0, 3, 1};
+    for(uint32_t i = 0; i < 4; i++)
+        pl_sb_push(tFan.sbtVertexPositions, atFanPositions[i]);
+    for(uint32_t i = 0; i < 6; i++)
+        pl_sb_push(tFan.sbuIndices, auFanIndices[i]);
+    ptEcs->calculate_normals(&tFan, 1);
+    const plVec3 tExpected = pl_norm_vec3((plVec3){0.0f, -10.0f, 100.0f});
+    pl_test_expect_true(fabsf(pl_dot_vec3(tFan.sbtVertexNormals[0], tExpected) - 1.0f) < 1e-5f, NULL);
+    pl__ecs_test_free_grid(&tFan);
+
+    // sphere, scalar & serial is the reference for every backend & worker count
+    pl__ecs_test_grid(&tMesh, 120, false, true);
+    const uint32_t uVertexCount = pl_sb_size(tMesh.sbtVertexPositions);
+    plVec3* atNormals = malloc(uVertexCount * sizeof(plVec3));
+    plVec4* atTangents = malloc(uVertexCount * sizeof(plVec4));
+    pl__set_transform_backend(PL_TRANSFORM_BACKEND_SCALAR);
+    ptEcs->calculate_tangents(&tMesh, 1);
+    memcpy(atNormals, tMesh.sbtVertexNormals, uVertexCount * sizeof(plVec3));
+    memcpy(atTangents, tMesh.sbtVertexTangents, uVertexCount * sizeof(plVec4));
+    float fMaxDeviation = 0.0f;
+    for(uint32_t i = 0; i < uVertexCount; i++)
+    {
+        if(fabsf(tMesh.sbtVertexPositions[i].z) < 0.99f) // poles are fans of slivers
+            fMaxDeviation = pl_maxf(fMaxDeviation, 1.0f - fabsf(pl_dot_vec3(atNormals[i], tMesh.sbtVertexPositions[i])));
+    }
+    pl_test_expect_true(fMaxDeviation < 1e-3f, NULL);
+
+    for(uint32_t uPass = 0; uPass < 2; uPass++)
+    {
+        if(uPass == 1)
+        {
+            gptThreads = &gtEcsTestThreads;
+            pl__create_task_pool();
+        }
+        for(int iBackend = PL_TRANSFORM_BACKEND_SCALAR; iBackend < PL_TRANSFORM_BACKEND_COUNT; iBackend++)
+        {
+            if(!pl__set_transform_backend((plTransformBackend)iBackend))
+                continue;
+            pl_sb_reset(tMesh.sbtVertexNormals);
+            pl_sb_reset(tMesh.sbtVertexTangents);
+            ptEcs->calculate_tangents(&tMesh, 1);
+            float fMaxError = 0.0f;
+            bool bSameSign = true;
+            for(uint32_t i = 0; i < uVertexCount; i++)
+            {
+                fMaxError = pl_maxf(fMaxError, pl_length_vec3(pl_sub_vec3(tMesh.sbtVertexNormals[i], atNormals[i])));
+                fMaxError = pl_maxf(fMaxError, pl_length_vec3(pl_sub_vec3(tMesh.sbtVertexTangents[i].xyz, atTangents[i].xyz)));
+                bSameSign = bSameSign && tMesh.sbtVertexTangents[i].w == atTangents[i].w;
+            }
+            pl_test_expect_true(fMaxError < 1e-4f && bSameSign, pl__get_transform_backend_name(iBackend));
+        }
+    }
+    pl__set_transform_backend(PL_TRANSFORM_BACKEND_AUTO);
+
+    // several meshes at once, an empty one is skipped
+    plMeshComponent atMeshes[2] = {0};
+    atMeshes[0] = tMesh;
+    pl_sb_reset(atMeshes[0].sbtVertexNormals);
+    ptEcs->calculate_normals(atMeshes, 2);
+    pl_test_expect_int_equal((int)pl_sb_size(atMeshes[0].sbtVertexNormals), (int)uVertexCount, NULL);
+    pl_test_expect_int_equal((int)pl_sb_size(atMeshes[1].sbtVertexNormals), 0, NULL);
+    pl__ecs_test_free_grid(&atMeshes[0]);
+
+    free(atNormals);
+    free(atTangents);
+    pl__ecs_test_end(ptEcs, &tLibrary);
+}